@@ -0,0 +1,40 @@
+//
+//  BenchmarkStats.bench.cpp
+//  Reactotron
+//
+//  A million eight-step reports alternating between two benchmarks, each one
+//  tested for regressions as it's recorded, and the sketch sizes that leaves.
+//
+
+#include "IRBenchmarkStats/BenchmarkStats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace reactotron;
+
+int main() {
+  constexpr size_t kReports = 1000000;
+  std::mt19937_64 rng(1);
+  std::normal_distribution<double> noise(0, 0.5);
+  std::lognormal_distribution<double> skewed(1.0, 1.5);
+
+  BenchmarkStats stats;
+  std::vector<std::string> steps = {"start", "a", "b", "c", "d", "e", "f", "g", "h"};
+  std::vector<double> durations(steps.size());
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kReports; i++) {
+    for (size_t k = 1; k < durations.size(); k++) durations[k] = k + noise(rng) * 0.1;
+    stats.Record(i % 2 ? "screen A" : "screen B", steps, durations);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%zu reports (8 steps) in %.3f s, %.0f ns/report\n", kReports, seconds, seconds * 1e9 / kReports);
+
+  QuantileSketch sketch;
+  for (size_t i = 0; i < kReports; i++) sketch.Add(1 + noise(rng) * 0.1);
+  std::printf("sketch of N(1, 0.05): %zu buckets\n", sketch.BucketCount());
+  for (size_t i = 0; i < kReports; i++) sketch.Add(skewed(rng));
+  std::printf("plus lognormal(1, 1.5): %zu buckets\n", sketch.BucketCount());
+  return 0;
+}
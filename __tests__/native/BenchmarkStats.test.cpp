@@ -0,0 +1,141 @@
+//
+//  BenchmarkStats.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRBenchmarkStats/BenchmarkStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+bool Near(double a, double b, double tolerance) { return std::fabs(a - b) <= tolerance; }
+
+const std::vector<std::string> kSteps = {"start", "fetch", "parse", "fetch"};
+
+} // namespace
+
+TEST(StudentTPValuesMatchTables) {
+  CHECK(Near(StudentTTwoSidedPValue(2.228, 10), 0.05, 1e-3));
+  CHECK(Near(StudentTTwoSidedPValue(-2.228, 10), 0.05, 1e-3));
+  CHECK(Near(StudentTTwoSidedPValue(1.96, 1e6), 0.05, 1e-3));
+  CHECK(Near(StudentTTwoSidedPValue(12.706, 1), 0.05, 1e-3));
+  CHECK(Near(StudentTTwoSidedPValue(0, 5), 1, 1e-9));
+}
+
+TEST(RunningStatsUseSampleVariance) {
+  RunningStats stats;
+  for (double value : {2., 4., 4., 4., 5., 5., 7., 9.}) stats.Add(value);
+  CHECK(Near(stats.mean, 5, 1e-12));
+  CHECK(Near(stats.Variance(), 32.0 / 7, 1e-12));
+  CHECK_EQ(stats.min, 2);
+  CHECK_EQ(stats.max, 9);
+}
+
+TEST(SketchQuantilesAreWithinOnePercent) {
+  std::mt19937_64 rng(1);
+  std::lognormal_distribution<double> duration(1.0, 1.5);
+  std::vector<double> values;
+  QuantileSketch sketch;
+  for (int i = 0; i < 200000; i++) {
+    double value = duration(rng);
+    values.push_back(value);
+    sketch.Add(value);
+  }
+  std::sort(values.begin(), values.end());
+  for (double quantile : {0.01, 0.5, 0.9, 0.99, 0.999}) {
+    double exact = values[static_cast<size_t>(quantile * (values.size() - 1))];
+    CHECK(std::fabs(sketch.ValueAtQuantile(quantile) - exact) / exact <= 0.0101);
+  }
+}
+
+TEST(SketchStaysWithinItsBucketCap) {
+  QuantileSketch rising;
+  for (int exponent = -300; exponent <= 300; exponent++) rising.Add(std::pow(10.0, exponent));
+  rising.Add(0);
+  rising.Add(-1);
+  CHECK(rising.BucketCount() <= QuantileSketch::kMaxBuckets);
+  CHECK_EQ(rising.Count(), 603u);
+  CHECK_EQ(rising.ValueAtQuantile(0), 0);
+  CHECK(Near(rising.ValueAtQuantile(1), 1e300, 1e300 * 0.011));
+
+  QuantileSketch falling;
+  for (int exponent = 300; exponent >= -300; exponent--) falling.Add(std::pow(10.0, exponent));
+  CHECK(falling.BucketCount() <= QuantileSketch::kMaxBuckets);
+  CHECK(Near(falling.ValueAtQuantile(1), 1e300, 1e300 * 0.011));
+}
+
+TEST(FlagsRegressionsAgainstTheSession) {
+  std::mt19937_64 rng(1);
+  std::normal_distribution<double> noise(0, 0.5);
+  BenchmarkStats stats;
+  for (int i = 0; i < 20; i++) {
+    auto verdict = stats.Record("load", kSteps, {0, 10 + noise(rng), 5 + noise(rng), 10 + noise(rng)});
+    if (i < 3) CHECK(verdict.change == BenchmarkChange::NoBaseline);
+    CHECK_EQ(verdict.run, static_cast<uint64_t>(i + 1));
+    CHECK_EQ(verdict.steps.size(), 4u);
+  }
+
+  auto verdict = stats.Record("load", kSteps, {0, 10, 5, 10});
+  CHECK(verdict.change == BenchmarkChange::Unchanged);
+  CHECK_EQ(verdict.steps[2].step, "fetch #2"); // Repeated step titles are numbered
+  CHECK_EQ(verdict.steps[3].step, BenchmarkStats::kTotalStep);
+  CHECK_EQ(verdict.steps[3].duration, 25);
+
+  verdict = stats.Record("load", kSteps, {0, 10, 9, 10});
+  CHECK(verdict.steps[0].change == BenchmarkChange::Unchanged);
+  CHECK(verdict.steps[1].change == BenchmarkChange::Regressed);
+  CHECK(verdict.change == BenchmarkChange::Regressed);
+
+  verdict = stats.Record("load", kSteps, {0, 10, 2, 10});
+  CHECK(verdict.steps[1].change == BenchmarkChange::Improved);
+  CHECK(verdict.change == BenchmarkChange::Improved);
+}
+
+TEST(ComparesAgainstBaselines) {
+  std::mt19937_64 rng(2);
+  std::normal_distribution<double> noise(0, 0.5);
+  BenchmarkStats stats;
+  for (int i = 0; i < 20; i++) stats.Record("load", kSteps, {0, 10 + noise(rng), 5 + noise(rng), 10 + noise(rng)});
+
+  CHECK_EQ(stats.CaptureBaseline("load").size(), 4u);
+  stats.Clear();
+  auto summary = stats.Summary("load");
+  CHECK_EQ(summary.size(), 4u);
+  CHECK_EQ(summary[0].stats.count, 0u);
+  CHECK(summary[0].hasBaseline);
+
+  auto verdict = stats.Record("load", kSteps, {0, 10, 5, 10});
+  CHECK_EQ(verdict.run, 1u);
+  CHECK(verdict.change == BenchmarkChange::Unchanged);
+  verdict = stats.Record("load", kSteps, {0, 14, 5, 10});
+  CHECK(verdict.steps[0].change == BenchmarkChange::Regressed);
+
+  stats.ClearBaseline("load");
+  verdict = stats.Record("load", kSteps, {0, 14, 5, 10});
+  CHECK(verdict.change == BenchmarkChange::NoBaseline);
+}
+
+TEST(ZeroVarianceBaselinesStillNeedAMinimumEffect) {
+  BenchmarkStats stats;
+  stats.SetBaseline("other", "a", {5, 100, 0});
+  auto verdict = stats.Record("other", {"s", "a"}, {0, 100});
+  CHECK(verdict.steps[0].change == BenchmarkChange::Unchanged);
+  verdict = stats.Record("other", {"s", "a"}, {0, 110});
+  CHECK(verdict.steps[0].change == BenchmarkChange::Regressed);
+  CHECK_EQ(verdict.steps[0].pValue, 0);
+  verdict = stats.Record("other", {"s", "a"}, {0, 102});
+  CHECK(verdict.steps[0].change == BenchmarkChange::Unchanged);
+}
+
+TEST(HandlesDegenerateReports) {
+  BenchmarkStats stats(3);
+  CHECK(stats.Record("x", {"s"}, {0}).steps.empty());
+  stats.Record("t", {"s", "a", "b", "c", "d"}, {0, 1, 1, 1, 1});
+  CHECK_EQ(stats.SeriesCount(), 3u);
+}
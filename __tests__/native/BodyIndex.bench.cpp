@@ -0,0 +1,61 @@
+//
+//  BodyIndex.bench.cpp
+//  Reactotron
+//
+//  Indexes an API-like JSON body (100 MB, or the size in MB given as an
+//  argument), then pages, searches and folds it.
+//
+
+#include "IRBodyViewer/BodyIndex.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t target = (argc > 1 ? std::stoull(argv[1]) : 100) << 20;
+  std::string json = "{\"data\":[";
+  for (int i = 0; json.size() < target; ++i) {
+    if (i) json += ',';
+    json += "{\"id\":" + std::to_string(i) + ",\"name\":\"User " + std::to_string(i) + "\",\"email\":\"user" +
+            std::to_string(i) + "@example.com\",\"active\":true,\"tags\":[\"a\",\"b\"],\"address\":{\"street\":\"" +
+            std::to_string(i * 7) + " Main St\",\"city\":\"Springfield\",\"zip\":\"12345\"}}";
+  }
+  json += "],\"total\":1}";
+  size_t bytes = json.size();
+  size_t capacity = json.capacity();
+
+  auto start = Clock::now();
+  BodyIndex body(std::move(json));
+  double indexMs = MsSince(start);
+  start = Clock::now();
+  body.Rows(0, 60);
+  double firstPageMs = MsSince(start);
+  start = Clock::now();
+  body.Rows(body.RowCount() / 2, 60);
+  double middlePageMs = MsSince(start);
+  start = Clock::now();
+  int64_t last = body.Find("\"total\"", 0, false);
+  double findMs = MsSince(start);
+  start = Clock::now();
+  body.ToggleFold(1);
+  double foldMs = MsSince(start);
+
+  std::printf("%.1f MB, %zu lines: index %.0f ms, first page %.3f ms, middle page %.3f ms\n", bytes / 1048576.0,
+              body.LineCount(), indexMs, firstPageMs, middlePageMs);
+  std::printf("search to line %lld %.0f ms, fold %.3f ms, %zu rows after\n", static_cast<long long>(last), findMs, foldMs,
+              body.RowCount());
+  std::printf("index overhead %.1f bytes/line\n", double(body.ByteSize() - capacity) / body.LineCount());
+  return 0;
+}
@@ -0,0 +1,104 @@
+//
+//  BodyIndex.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRBodyViewer/BodyIndex.h"
+
+using namespace reactotron;
+
+namespace {
+
+std::string All(const BodyIndex &body) {
+  std::string out;
+  for (const auto &line : body.Rows(0, body.RowCount())) out += line.text + '\n';
+  if (!out.empty()) out.pop_back();
+  return out;
+}
+
+} // namespace
+
+TEST(PrettyPrintsJsonWithTwoSpaceIndent) {
+  BodyIndex body(R"( {"a":{"b":[1,2.5e3,{"c":"x\"y\n"}],"d":true},"e":[],"f":{},"g":null} )");
+  CHECK(body.IsJson());
+  CHECK_EQ(All(body), R"({
+  "a": {
+    "b": [
+      1,
+      2.5e3,
+      {
+        "c": "x\"y\n"
+      }
+    ],
+    "d": true
+  },
+  "e": [],
+  "f": {},
+  "g": null
+})");
+  CHECK_EQ(body.LineCount(), size_t(15));
+
+  BodyIndex scalar(" 42 ");
+  CHECK(scalar.IsJson());
+  CHECK_EQ(All(scalar), "42");
+  BodyIndex nested("[[[]],[{}]]");
+  CHECK_EQ(All(nested), "[\n  [\n    []\n  ],\n  [\n    {}\n  ]\n]");
+}
+
+TEST(FoldsAndRevealsRegions) {
+  BodyIndex body(R"({"a":{"b":[1,2,{"c":3}],"d":4},"e":[5,6],"f":{}})");
+  size_t lines = body.LineCount();
+  CHECK(body.ToggleFold(2)); // "b": [
+  CHECK_EQ(body.RowCount(), lines - 6);
+  auto rows = body.Rows(0, 4);
+  CHECK(rows[2].folded);
+  CHECK_EQ(rows[2].hiddenLines, uint32_t(6));
+  CHECK_EQ(rows[2].text, "    \"b\": […],");
+  CHECK_EQ(rows[3].line, uint32_t(9));
+  CHECK_EQ(rows[3].text, "    \"d\": 4");
+
+  // Folding "a" hides the fold inside it
+  CHECK(body.ToggleFold(1));
+  CHECK_EQ(body.RowCount(), lines - 9);
+  CHECK_EQ(body.Rows(1, 1)[0].text, "  \"a\": {…},");
+  CHECK(!body.ToggleFold(3)); // Not the start of a region
+
+  CHECK_EQ(body.Find("C", 0, false), int64_t(6));
+  CHECK_EQ(body.Reveal(6), size_t(6)); // Unfolds "a", then "b"
+  CHECK_EQ(body.RowCount(), lines);
+  CHECK_EQ(body.Rows(6, 1)[0].text, "        \"c\": 3");
+  CHECK_EQ(body.Find("\"e\"", 13, true), int64_t(11));
+  CHECK_EQ(body.Find("\"a\"", 5, true), int64_t(1));
+  CHECK_EQ(body.Find("zzz", 0, false), int64_t(-1));
+
+  CHECK(body.ToggleFold(0));
+  CHECK_EQ(body.RowCount(), size_t(1));
+  CHECK(body.ToggleFold(0));
+  CHECK_EQ(body.RowCount(), lines);
+}
+
+TEST(ShowsAnythingElseAsText) {
+  BodyIndex text("line one\r\n{not json\nthird");
+  CHECK(!text.IsJson());
+  CHECK_EQ(text.LineCount(), size_t(3));
+  CHECK_EQ(All(text), "line one\n{not json\nthird");
+
+  BodyIndex empty("");
+  CHECK_EQ(empty.LineCount(), size_t(1));
+  CHECK_EQ(empty.Rows(0, 5).size(), size_t(1));
+  for (const char *bad : {"{\"a\":1", "{\"a\":tru}", "[1,]", "{\"a\" 1}", "1 2", "\"open"}) {
+    CHECK(!BodyIndex(bad).IsJson());
+  }
+  std::string deep = std::string(BodyIndex::kMaxDepth + 1, '[') + "1";
+  deep += std::string(BodyIndex::kMaxDepth + 1, ']');
+  CHECK(!BodyIndex(deep).IsJson());
+}
+
+TEST(CutsOffLongLines) {
+  BodyIndex body("[\"" + std::string(10000, 'x') + "\"]");
+  auto line = body.Rows(1, 1)[0];
+  CHECK(line.truncated);
+  CHECK_EQ(line.text.size(), BodyIndex::kMaxLineBytes);
+  CHECK(!body.Rows(0, 1)[0].truncated);
+}
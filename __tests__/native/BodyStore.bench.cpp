@@ -0,0 +1,114 @@
+//
+//  BodyStore.bench.cpp
+//  Reactotron
+//
+//  10000 api.response commands with 32-64 KB bodies, as JSON values, JSON
+//  strings and base64, through the ingest pipeline: what JS gets instead of
+//  the bodies, then what a body costs when it's first viewed and after.
+//
+
+#include "IRBodyStore/BodyStore.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string Body(size_t size, std::mt19937 &rng) {
+  std::string body = "{\"items\":[";
+  for (int i = 0; body.size() < size; ++i) {
+    body += std::string(i ? "," : "") + "{\"id\":" + std::to_string(i) + ",\"name\":\"Item number " +
+            std::to_string(rng() % 100000) + "\",\"price\":" + std::to_string(rng() % 10000 / 100.0) +
+            ",\"tags\":[\"a\",\"b\",\"c\"],\"active\":" + (rng() % 2 ? "true" : "false") + "}";
+  }
+  return body + "]}";
+}
+
+std::string Base64(std::string_view data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t n = uint32_t(uint8_t(data[i])) << 16;
+    if (i + 1 < data.size()) n |= uint32_t(uint8_t(data[i + 1])) << 8;
+    if (i + 2 < data.size()) n |= uint8_t(data[i + 2]);
+    out += kAlphabet[(n >> 18) & 63];
+    out += kAlphabet[(n >> 12) & 63];
+    out += i + 1 < data.size() ? kAlphabet[(n >> 6) & 63] : '=';
+    out += i + 2 < data.size() ? kAlphabet[n & 63] : '=';
+  }
+  return out;
+}
+
+std::string Quote(std::string_view text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') quoted += '\\';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+} // namespace
+
+int main() {
+  const int count = 10000;
+  std::mt19937 rng(46);
+  std::vector<std::string> messages;
+  size_t inBytes = 0;
+  for (int i = 0; i < count; ++i) {
+    std::string body = Body(32 * 1024 + rng() % (32 * 1024), rng);
+    std::string data = i % 3 == 0 ? body : i % 3 == 1 ? Quote(body) : Quote(Base64(body));
+    messages.push_back("{\"type\":\"command\",\"cmd\":{\"type\":\"api.response\",\"clientId\":\"c\",\"messageId\":" +
+                       std::to_string(i) +
+                       ",\"payload\":{\"request\":{\"url\":\"https://x.test/items\",\"method\":\"GET\"},"
+                       "\"response\":{\"status\":200,\"headers\":{\"content-type\":\"application/json\"},\"data\":" +
+                       data + "},\"duration\":12}}}");
+    inBytes += messages.back().size();
+  }
+
+  std::vector<std::string> out;
+  auto start = Clock::now();
+  {
+    IngestPipeline pipeline(1, [&](std::vector<std::string> &committed, std::vector<IngestedItem> &, uint64_t) {
+      for (auto &message : committed) out.push_back(std::move(message));
+    });
+    for (const auto &message : messages) pipeline.Submit(message);
+    pipeline.Drain();
+  }
+  double ingestMs = MsSince(start);
+  size_t outBytes = 0;
+  for (const auto &message : out) outBytes += message.size();
+  BodyStoreStats stats = BodyStore::Shared().Stats();
+  std::printf("ingest: %.1f MB in %.0f ms (%.1f us/msg); JS gets %.2f MB, the store holds %zu bodies (%.1f MB)\n",
+              inBytes / 1e6, ingestMs, ingestMs * 1000 / count, outBytes / 1e6, stats.bodies, stats.rawBytes / 1e6);
+
+  const char *formats[3] = {"JSON value", "JSON string", "base64"};
+  double took[3] = {};
+  int decoded[3] = {};
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < 300; ++i) {
+    size_t at = out[i].find("\"$body\":");
+    if (at == std::string::npos) continue;
+    ids.push_back(static_cast<uint32_t>(std::stoul(out[i].substr(at + 8))));
+    start = Clock::now();
+    BodyStore::Shared().Decode(ids.back());
+    took[i % 3] += MsSince(start);
+    decoded[i % 3]++;
+  }
+  for (int k = 0; k < 3; ++k) {
+    if (decoded[k]) std::printf("first view (%s): %.3f ms\n", formats[k], took[k] / decoded[k]);
+  }
+  start = Clock::now();
+  for (uint32_t id : ids) BodyStore::Shared().Decode(id);
+  std::printf("viewed again, cached: %.4f ms\n", MsSince(start) / ids.size());
+  return 0;
+}
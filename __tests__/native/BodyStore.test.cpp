@@ -0,0 +1,396 @@
+//
+//  BodyStore.test.cpp
+//  Reactotron
+//
+//  The compressed fixtures are base64 of Body(60) below, made with zlib
+//  (default and fixed Huffman coding) and brotli.
+//
+
+#include "NativeTest.h"
+#include "IRBodyStore/BodyStore.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <random>
+
+#if __has_include(<zlib.h>)
+#define IR_TEST_ZLIB 1
+#include <zlib.h>
+#endif
+
+using namespace reactotron;
+
+namespace {
+
+const char kGzip[] =
+    "H4sIAAAAAAAAA33WO24UQRSF4a2gjq2ruq96eAdeA3IwgIUmMELgzPLeGUTQt444k3b3H/WnqvN+XN9eXn8fj5/fj+u347E9HD8u"
+    "ry/H4/F0e/6pHQ/Hz1/Xr7cHTdrt5dvl+9+Pj8vtxZfj+ePhX6Z7Ns5MpSnNbM80zs6kGe1870zPzqU57QK6eXYhLWiXe+d5dikt"
+    "adf3LuzsurROuwHdOrshbdBu7l32s5vSJu3W3nU/uyVt8d8OXEbxok30DhgUU8moKDejgGYWNGqiXI0Cm1XYqItyNwpwVoGjIcrl"
+    "KNDRVuxoinI8CnpUCx/totyPDkyLIB2inJCCIbWCSKcoV6TASL040iXKIVnDk6BIsibGJZliWiiZit05fvD8yXoAmRi3ZGBJe8Fk"
+    "LsYxWWBaNFmIcU2GmkbRZCnGNRlqmkWTdTGuyVDTLJpsiHFNhppW0WRTjGsy0GStaLIlxjV5w/uhaPImzjW5Ylo0uYpzTQ6azIom"
+    "N/E79xleaF5vNBfnmhzvNC+aPMS5JgdNFkWTpzjX5KDJsmjyLs41+cC0aPIhzjU5aLJeNPkU55ocNY2iyZc41xSoaRZN0SS4pkBN"
+    "s2gKleCaAjWtoilMgmsK0OStaAqXuDOQAtM6kUKCawocSVo0RUpwTQGa3Iqm6BJcUwxMi6YYElxTgCb3oimmBNcUoMmjaIolwTUl"
+    "aPLcNnZyTKlYbjM7uaUES963oZ2cUiKlsU3t5JISJY1tbOedsY2Q5ja3kztKdLS2wZ2cUSKjtU3u5IoSFEXbRndyRAmIQrfZnf8x"
+    "9PzxBzHI48uwDQAA";
+const char kZlib[] =
+    "eJx91jtuFEEUheGtoI6tq7qvengHXgNyMICFJjBC4Mzy3hlE0LeOOJN29x/1p6rzflzfXl5/H4+f34/rt+OxPRw/Lq8vx+PxdHv+"
+    "qR0Px89f16+3B03a7eXb5fvfj4/L7cWX4/nj4V+mezbOTKUpzWzPNM7OpBntfO9Mz86lOe0Cunl2IS1ol3vneXYpLWnX9y7s7Lq0"
+    "TrsB3Tq7IW3Qbu5d9rOb0ibt1t51P7slbfHfDlxG8aJN9A4YFFPJqCg3o4BmFjRqolyNAptV2KiLcjcKcFaBoyHK5SjQ0VbsaIpy"
+    "PAp6VAsf7aLcjw5MiyAdopyQgiG1gkinKFekwEi9ONIlyiFZw5OgSLImxiWZYloomYrdOX7w/Ml6AJkYt2RgSXvBZC7GMVlgWjRZ"
+    "iHFNhppG0WQpxjUZappFk3UxrslQ0yyabIhxTYaaVtFkU4xrMtBkrWiyJcY1ecP7oWjyJs41uWJaNLmKc00OmsyKJjfxO/cZXmhe"
+    "bzQX55oc7zQvmjzEuSYHTRZFk6c41+SgybJo8i7ONfnAtGjyIc41OWiyXjT5FOeaHDWNosmXONcUqGkWTdEkuKZATbNoCpXgmgI1"
+    "raIpTIJrCtDkrWgKl7gzkALTOpFCgmsKHElaNEVKcE0BmtyKpugSXFMMTIumGBJcU4Am96IppgTXFKDJo2iKJcE1JWjy3DZ2ckyp"
+    "WG4zO7mlBEvet6GdnFIipbFN7eSSEiWNbWznnbGNkOY2t5M7SnS0tsGdnFEio7VN7uSKEhRF20Z3ckQJiEK32Z3/MfT88QcIDLdv";
+const char kRawDeflate[] =
+    "fdY7bhRBFIXhraCOrau6r3p4B14DcjCAhSYwQuDM8t4ZRNC3jjiTdvcf9aeq835c315efx+Pn9+P67fjsT0cPy6vL8fj8XR7/qkd"
+    "D8fPX9evtwdN2u3l2+X734+Py+3Fl+P54+Ffpns2zkylKc1szzTOzqQZ7XzvTM/OpTntArp5diEtaJd753l2KS1p1/cu7Oy6tE67"
+    "Ad06uyFt0G7uXfazm9Im7dbedT+7JW3x3w5cRvGiTfQOGBRTyagoN6OAZhY0aqJcjQKbVdioi3I3CnBWgaMhyuUo0NFW7GiKcjwK"
+    "elQLH+2i3I8OTIsgHaKckIIhtYJIpyhXpMBIvTjSJcohWcOToEiyJsYlmWJaKJmK3Tl+8PzJegCZGLdkYEl7wWQuxjFZYFo0WYhx"
+    "TYaaRtFkKcY1GWqaRZN1Ma7JUNMsmmyIcU2GmlbRZFOMazLQZK1osiXGNXnD+6Fo8ibONbliWjS5inNNDprMiiY38Tv3GV5oXm80"
+    "F+eaHO80L5o8xLkmB00WRZOnONfkoMmyaPIuzjX5wLRo8iHONTlosl40+RTnmhw1jaLJlzjXFKhpFk3RJLimQE2zaAqV4JoCNa2i"
+    "KUyCawrQ5K1oCpe4M5AC0zqRQoJrChxJWjRFSnBNAZrciqboElxTDEyLphgSXFOAJveiKaYE1xSgyaNoiiXBNSVo8tw2dnJMqVhu"
+    "Mzu5pQRL3rehnZxSIqWxTe3kkhIljW1s552xjZDmNreTO0p0tLbBnZxRIqO1Te7kihIURdtGd3JECYhCt9md/zH0/PEH";
+const char kFixedHuffman[] =
+    "q1bKLEnNLVayiq5WykxRsjLQUcpLzE1VslLyBIorGCjpKBUUZSYDBQz0DICSJYnpIMVKiUCJJKXYWh2INkNUbeYIbYZ6BoY4tRmh"
+    "ajM0Qegz0jMwwqnPGFWfkSFCn7GegTFOfSZo+iwQ+kz0DExw6jNF1WdsitBnqmdgilOfGao+EyOEPjM9AzOc+szR9Fki9JnrGZjj"
+    "1GeBqs/UDKHPQs/AAqc+S1R9ZsYIfZZ6Bpa4ox0tuZgjpRdDAz1DPAkGPcUgJxlDPUPcacYQLdFYICUaQyM9Q9ypxhAt2VgiJRtD"
+    "Yz1D3OnGEC3hWCIlHEMTPUPcKccQLekYGiClHUNTPUPciccQLfUYGiIlH0MzPUPc6cfQHF0rUgoyNNczxJ2EDNHSkKERUiIytNAz"
+    "xJ2KDNGSkaExUjoytNQzxJ2QjAzQSwKklGRkoGeEOyUZGaJrRUpKRoZ6RniKH/TyxxS5ADLSM8KdlozQ0pKhGVJiMjLWM8KdmIxM"
+    "0LUipSYjEz0j3KnJCD01mSOlJiNTPSPcqckIPTVZIKUmIzM9I9ypyQg9NVkgpSYjcz0j3KnJCD01WSKlJiMLPSPcqckILTUZGSCl"
+    "JiNLPSPcqcnYAL1+QEpNxgZ6xrhTk7Ehulak1GRsqGeMOzUZo6UmIyOk1GRspGeMpz5Dr9CMkWs0Yz1j3KnJGL1OM0ZKTcYmesa4"
+    "U5MxWmoyMkFKTcamesa4U5MxWmoyMkVKTcZmesa4U5OxObpWpNRkbK5njDs1GaOlJiMzpNRkbKFnjDs1GaOnJnOk1GRsqWeMOzWZ"
+    "oKcmC6TUZGKgZ4I7NZmgpyYLpNRkYqhngjs1maCnJkuk1GRipGeCOzWZoKUmYwOk1GRirGeCp4Fkgq4VuYlkomeCOzWZoDeSDJFS"
+    "k4mpngnu1GSClpqMjZBSk4mZngnu1GRijq4VKTWZmOuZ4E5NJmipydgYKTWZWOiZ4E5NJmipydgEKTWZWOqZ4E5NpmipydgUpY1t"
+    "ijsxmRqi60RpZpviTkumaGnJ2AyloW2KOymZoiclc5SmtinulGSKnpLMURrbpnga2+gJyQKluW2KOx2ZoqcjS5QGtynuZGSKnows"
+    "UZrcprhTkSlaKjIxQGl0m+JORKZoicjEEKXZbYolDcXWAgA=";
+const char kBrotli[] =
+    "G68NAMTUFYZoZbyyMo+dZAErwP9z6FhVqLfJz46W709WrJQVGoPyqPKDIKcagiDhZJXEOEB0MyWtQRiCYOLyr7/xC6P/ivPqNz6e"
+    "4xxH/Hv4eYkzLv+//FyMOOKuN3GOHOOIJ/k7zqt4iCMe4+bvOCoYE2QQXuBgRlERKJN5LJxZqlRUVtJl0lnbHJuZTVlVzcqW7Gqx"
+    "s73CyHye3cVI9LR3bSLRCs11E0y0QnPfhBKt0Nw34UQrdMXoJirRCl2BbqITfYl5fG5mOG01mxUu2y2xPzhMxiscDGn8Cc8FQhi7"
+    "DEOauoFCqefCoZ9O1JwwpHIuGFI5FwypnBuGNDYHDGlqAoUyHZxBoUxNolCmplAo08EZFMrUNAplahYKZTo4g0KZmo1CqeZEodRz"
+    "4dDquXBo9dw4tLk1cGjzwRkc2twCDm1uEYc2H5zBoc0t4dDmlnFoq1ZtjiytWrWJLK1avckstebcVJZaD/O7WR/cT/dcm5Wl1tyb"
+    "naXW3JszS6v22FxZWrXx287y5eYP";
+
+std::string Body(int items) {
+  std::string body = "{\"items\":[";
+  for (int i = 0; i < items; ++i) {
+    char item[96];
+    std::snprintf(item, sizeof(item), "%s{\"id\":%d,\"name\":\"Item %d\",\"price\":%d.%02d,\"tags\":[\"a\",\"b\"]}",
+                  i ? "," : "", i, i * 7 % 1000, i % 50, i % 100);
+    body += item;
+  }
+  return body + "]}";
+}
+
+std::string Quote(std::string_view text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') quoted += '\\';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::string Base64(std::string_view data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t n = uint32_t(uint8_t(data[i])) << 16;
+    if (i + 1 < data.size()) n |= uint32_t(uint8_t(data[i + 1])) << 8;
+    if (i + 2 < data.size()) n |= uint8_t(data[i + 2]);
+    out += kAlphabet[(n >> 18) & 63];
+    out += kAlphabet[(n >> 12) & 63];
+    out += i + 1 < data.size() ? kAlphabet[(n >> 6) & 63] : '=';
+    out += i + 2 < data.size() ? kAlphabet[n & 63] : '=';
+  }
+  return out;
+}
+
+std::string Bytes(const char *base64) {
+  std::string out;
+  DecodeBase64(base64, out);
+  return out;
+}
+
+std::string ApiResponse(int messageId, const std::string &data, const char *contentEncoding) {
+  std::string headers = "{\"Content-Type\":\"application/json\"";
+  if (contentEncoding) headers += std::string(",\"content-encoding\":\"") + contentEncoding + "\"";
+  headers += "}";
+  return "{\"type\":\"command\",\"cmd\":{\"type\":\"api.response\",\"clientId\":\"c\",\"messageId\":" +
+         std::to_string(messageId) +
+         ",\"payload\":{\"request\":{\"url\":\"https://x.test/items\",\"method\":\"GET\",\"data\":null,\"headers\":{}},"
+         "\"response\":{\"status\":200,\"headers\":" +
+         headers + ",\"data\":" + data + ",\"__proto__\":{\"x\":1}},\"duration\":12}}}";
+}
+
+uint32_t BodyId(const std::string &message) {
+  size_t at = message.find("\"$body\":");
+  return at == std::string::npos ? 0 : static_cast<uint32_t>(std::stoul(message.substr(at + 8)));
+}
+
+#if defined(IR_TEST_ZLIB)
+/** `windowBits` picks the wrapper as zlib's deflateInit2 does: -15 raw, 15 zlib, 31 gzip. */
+std::string Deflate(const std::string &data, int level, int strategy, int windowBits) {
+  z_stream stream{};
+  deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, strategy);
+  std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(out.data());
+  stream.avail_out = static_cast<uInt>(out.size());
+  deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+/** What zlib makes of `data`, or false if it rejects it. */
+bool ZlibInflate(const std::string &data, int windowBits, std::string &out) {
+  z_stream stream{};
+  inflateInit2(&stream, windowBits);
+  out.assign(1 << 20, '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(out.data());
+  stream.avail_out = static_cast<uInt>(out.size());
+  int result = inflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END;
+}
+
+/** Text, runs and noise in random proportions, so every block type and code shape turns up. */
+std::string MixedData(std::mt19937 &rng) {
+  std::string json = Body(200);
+  std::string data;
+  size_t size = rng() % 40000;
+  while (data.size() < size) {
+    size_t length = 1 + rng() % 2000;
+    switch (rng() % 3) {
+    case 0: data += json.substr(rng() % json.size(), length); break;
+    case 1: data.append(length, static_cast<char>(rng())); break;
+    default:
+      for (size_t i = 0; i < length; ++i) data += static_cast<char>(rng() % (1 + rng() % 256));
+    }
+  }
+  return data;
+}
+#endif
+
+} // namespace
+
+TEST(InflatesEveryWrapper) {
+  std::string expected = Body(60);
+  std::string out;
+  // Without the preset dictionary, so both have Inflate()'s signature
+  auto builtIn = [](std::string_view data, DeflateWrapper wrapper, std::string &out, size_t maxSize) {
+    return InflateBuiltIn(data, wrapper, out, maxSize);
+  };
+  for (auto inflate : {&Inflate, +builtIn}) {
+    CHECK(inflate(Bytes(kGzip), DeflateWrapper::Gzip, out, kMaxDecodedBodySize));
+    CHECK(out == expected);
+    CHECK(inflate(Bytes(kZlib), DeflateWrapper::Zlib, out, kMaxDecodedBodySize));
+    CHECK(out == expected);
+    CHECK(inflate(Bytes(kRawDeflate), DeflateWrapper::Raw, out, kMaxDecodedBodySize));
+    CHECK(out == expected);
+    CHECK(inflate(Bytes(kFixedHuffman), DeflateWrapper::Raw, out, kMaxDecodedBodySize));
+    CHECK(out == expected);
+    CHECK(inflate(Bytes("H4sIAAAAAAAEAwEPAPD/eyJzdG9yZWQiOnRydWV9Ti5lJA8AAAA="), DeflateWrapper::Gzip, out,
+                  kMaxDecodedBodySize));
+    CHECK_EQ(out, "{\"stored\":true}");
+
+    // Past the size limit, and the wrong wrapper
+    CHECK(!inflate(Bytes(kGzip), DeflateWrapper::Gzip, out, 1000));
+    CHECK(!inflate(Bytes(kGzip), DeflateWrapper::Zlib, out, kMaxDecodedBodySize));
+  }
+}
+
+TEST(SurvivesDamagedStreams) {
+  std::mt19937 rng(46);
+  std::string out;
+  std::pair<const char *, DeflateWrapper> fixtures[] = {
+    {kGzip, DeflateWrapper::Gzip}, {kZlib, DeflateWrapper::Zlib}, {kFixedHuffman, DeflateWrapper::Raw}};
+  for (const auto &[fixture, wrapper] : fixtures) {
+    std::string data = Bytes(fixture);
+    for (int i = 0; i < 500; ++i) {
+      std::string damaged = data;
+      damaged[rng() % damaged.size()] ^= static_cast<char>(1 << (rng() % 8));
+      Inflate(damaged, wrapper, out);
+      InflateBuiltIn(damaged, wrapper, out);
+      // Cut short before the end of the compressed data; trailers aren't needed
+      std::string cut = data.substr(0, rng() % (data.size() - 8));
+      CHECK(!Inflate(cut, wrapper, out));
+      CHECK(!InflateBuiltIn(cut, wrapper, out));
+    }
+  }
+}
+
+#if defined(IR_TEST_ZLIB)
+TEST(InflatesLikeZlib) {
+  std::mt19937 rng(1951);
+  const int strategies[] = {Z_DEFAULT_STRATEGY, Z_FILTERED, Z_HUFFMAN_ONLY, Z_RLE, Z_FIXED};
+  const std::pair<DeflateWrapper, int> wrappers[] = {
+    {DeflateWrapper::Raw, -15}, {DeflateWrapper::Zlib, 15}, {DeflateWrapper::Gzip, 31}};
+  std::string out, expected;
+  for (int i = 0; i < 300; ++i) {
+    std::string data = MixedData(rng);
+    auto [wrapper, windowBits] = wrappers[i % 3];
+    std::string compressed = Deflate(data, static_cast<int>(rng() % 10), strategies[rng() % 5], windowBits);
+    CHECK(InflateBuiltIn(compressed, wrapper, out));
+    CHECK(out == data);
+
+    // Damaged streams: whatever zlib rejects is rejected, and whatever it accepts comes out the same.
+    // The built-in decoder doesn't check trailers, so only the DEFLATE data is damaged.
+    size_t header = wrapper == DeflateWrapper::Gzip ? 10 : wrapper == DeflateWrapper::Zlib ? 2 : 0;
+    size_t trailer = wrapper == DeflateWrapper::Gzip ? 8 : wrapper == DeflateWrapper::Zlib ? 4 : 0;
+    for (int j = 0; j < 20; ++j) {
+      std::string damaged = compressed;
+      damaged[header + rng() % (damaged.size() - header - trailer)] ^= static_cast<char>(1 << (rng() % 8));
+      bool accepted = ZlibInflate(damaged.substr(header), -15, expected);
+      bool ok = InflateBuiltIn(damaged, wrapper, out);
+      CHECK_EQ(ok, accepted);
+      if (ok && accepted) CHECK(out == expected);
+    }
+  }
+}
+#endif
+
+TEST(DecodesBrotliWhereThereIsADecoder) {
+  std::string out;
+  if (DecodeBrotli(Bytes(kBrotli), out)) CHECK(out == Body(60));
+  CHECK(!DecodeBrotli(std::string(40, 'A'), out));
+}
+
+TEST(DecodesBodiesAsTheyArrive) {
+  std::string json = Body(60);
+  auto decoded = DecodeBody(json, "application/json", "");
+  CHECK(decoded.json && decoded.text == json && decoded.steps.empty());
+  decoded = DecodeBody(Quote(json), "application/json", "");
+  CHECK(decoded.json && decoded.text == json);
+  decoded = DecodeBody(Quote(kGzip), "application/json", "gzip");
+  CHECK(decoded.json && decoded.text == json);
+  CHECK((decoded.steps == std::vector<std::string>{"base64", "gzip", "json"}));
+  decoded = DecodeBody(Quote(kGzip), "", ""); // Sniffed from the magic bytes
+  CHECK(decoded.json && decoded.text == json);
+  decoded = DecodeBody(Quote(kZlib), "application/json", "deflate");
+  CHECK(decoded.json && decoded.text == json);
+  decoded = DecodeBody(Quote(kRawDeflate), "application/json", "deflate");
+  CHECK(decoded.json && decoded.text == json);
+  // fetch inflated it already
+  decoded = DecodeBody(Quote(json), "application/json", "gzip");
+  CHECK(decoded.json && decoded.text == json && decoded.error.empty());
+  decoded = DecodeBody(Quote(Base64(json)), "application/json", "");
+  CHECK(decoded.json && decoded.text == json);
+}
+
+TEST(ConvertsCharsetsAndDumpsBinary) {
+  std::string latin = "caf\xe9 \x80 na\xefve";
+  auto decoded = DecodeBody(Quote(Base64(latin + latin + latin)), "text/plain; charset=ISO-8859-1", "");
+  CHECK(decoded.text.rfind("caf\xc3\xa9", 0) == 0);
+  CHECK(decoded.text.find("\xe2\x82\xac") != std::string::npos); // 0x80 is the euro sign in windows-1252
+
+  std::string utf16 = "\xff\xfe";
+  for (char c : std::string("{\"hello\":\"world, this is utf16\"}")) utf16 += {c, '\0'};
+  decoded = DecodeBody(Quote(Base64(utf16)), "application/json", "");
+  CHECK(decoded.json);
+  CHECK_EQ(decoded.text, "{\"hello\":\"world, this is utf16\"}");
+
+  std::mt19937 rng(1);
+  std::string png = "\x89PNG\r\n\x1a\n";
+  for (int i = 0; i < 3000; ++i) png += static_cast<char>(rng());
+  decoded = DecodeBody(Quote(Base64(png)), "image/png", "");
+  CHECK(decoded.binary);
+  CHECK_EQ(decoded.bytes, uint64_t(png.size()));
+  CHECK(decoded.text.rfind("00000000  89 50 4e 47", 0) == 0);
+
+  decoded = DecodeBody("\"Just some words that are long enough\"", "text/plain", "");
+  CHECK(!decoded.json && !decoded.binary);
+  CHECK_EQ(decoded.text, "Just some words that are long enough");
+  // Text that happens to look like base64 stays text
+  CHECK_EQ(DecodeBody("\"SGVsbG9Xb3JsZDEyMzQ1Njc4\"", "text/plain", "").text, "SGVsbG9Xb3JsZDEyMzQ1Njc4");
+  CHECK_EQ(DecodeBody("\"\\u00e9\\ud83d\\ude00\\n\"", "text/plain", "").text, "\xc3\xa9\xf0\x9f\x98\x80\n");
+  CHECK(!DecodeBody(Quote(std::string(52, 'A')), "application/json", "br").error.empty());
+}
+
+TEST(RecognizesJson) {
+  CHECK(IsJson("{\"a\":[1,2,{\"b\":null}],\"c\":-1.5e3}"));
+  CHECK(IsJson(" [] "));
+  CHECK(IsJson("\"x\""));
+  for (const char *bad : {"{\"a\":}", "[1,]", "{} x", "{\"a\" 1}", "[1 2]", ""}) CHECK(!IsJson(bad));
+  CHECK(SniffBody("{\"a\":1}") == BodyFormat::Json);
+  CHECK(SniffBody(Quote(kGzip)) == BodyFormat::Base64);
+  CHECK(SniffBody(Quote(Body(3))) == BodyFormat::Text);
+  CHECK_EQ(std::string(BodyFormatName(BodyFormat::Base64)), "base64");
+}
+
+TEST(CachesDecodedBodiesWithinItsBudget) {
+  BodyStore store;
+  store.SetCacheBudget(32 * 1024);
+  std::vector<uint32_t> ids;
+  for (int i = 0; i < 20; ++i) ids.push_back(store.Store(Quote(kGzip), "application/json", "gzip"));
+  for (uint32_t id : ids) {
+    auto decoded = store.Decode(id);
+    CHECK(decoded && decoded->json);
+  }
+  BodyStoreStats stats = store.Stats();
+  CHECK_EQ(stats.bodies, size_t(20));
+  CHECK_EQ(stats.decodes, uint64_t(20));
+  CHECK(stats.cachedBytes <= stats.cacheBudget);
+  CHECK(stats.cached >= 2 && stats.cached < 20);
+
+  store.Decode(ids.back());
+  CHECK_EQ(store.Stats().cacheHits, uint64_t(1));
+  store.Decode(ids.front()); // Evicted, so decoded again
+  CHECK_EQ(store.Stats().decodes, uint64_t(21));
+
+  std::string raw;
+  CHECK(store.Raw(ids[0], raw));
+  CHECK_EQ(raw, Quote(kGzip));
+  CHECK_EQ(store.RawSize(ids[0]), uint64_t(raw.size()));
+  store.Release(ids.back());
+  CHECK(!store.Decode(ids.back()));
+  CHECK(!store.Raw(ids.back(), raw));
+  CHECK_EQ(store.Stats().bodies, size_t(19));
+
+  store.SetCacheBudget(0);
+  CHECK_EQ(store.Stats().cached, size_t(0));
+  store.Clear();
+  CHECK_EQ(store.Stats().rawBytes, uint64_t(0));
+  CHECK(store.Store("{}", "", "") > ids.back()); // Ids aren't reused
+}
+
+TEST(IngestLiftsLargeBodiesIntoTheStore) {
+  std::vector<std::string> out;
+  uint64_t lifted = 0;
+  std::string large = Body(400);
+  CHECK(large.size() >= IngestPipeline::kMinLiftedBody);
+  std::string compressed = Quote(Base64(large));
+  {
+    IngestPipeline pipeline(1, [&](std::vector<std::string> &messages, std::vector<IngestedItem> &, uint64_t) {
+      for (auto &message : messages) out.push_back(std::move(message));
+    });
+    pipeline.Submit(ApiResponse(1, large, nullptr));
+    pipeline.Submit(ApiResponse(2, compressed, nullptr));
+    pipeline.Submit(ApiResponse(3, "{\"small\":true}", nullptr));
+    // Only api.response bodies are lifted
+    pipeline.Submit("{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{\"response\":{\"data\":" + large + "}}}}");
+    pipeline.Drain();
+    for (const auto &client : pipeline.Stats().clients) lifted += client.bodies;
+  }
+  CHECK_EQ(out.size(), size_t(4));
+  CHECK_EQ(lifted, uint64_t(2));
+  if (out.size() != 4) return;
+
+  CHECK(out[0].find("\"data\":{\"$body\":") != std::string::npos);
+  CHECK(out[0].find("__proto__") == std::string::npos);
+  CHECK(out[0].size() < 500);
+  CHECK(out[1].find("\"format\":\"base64\"") != std::string::npos);
+  CHECK(out[2].find("{\"small\":true}") != std::string::npos);
+  CHECK(out[3].size() > large.size());
+
+  std::string raw;
+  CHECK(BodyStore::Shared().Raw(BodyId(out[0]), raw));
+  CHECK(raw == large);
+  auto decoded = BodyStore::Shared().Decode(BodyId(out[1]));
+  CHECK(decoded && decoded->json && decoded->text == large);
+  BodyStore::Shared().Clear();
+}
@@ -0,0 +1,171 @@
+//
+//  BulkChannel.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRBulkChannel/BulkChannel.h"
+#include "IRMemoryGovernor/MemoryGovernor.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace reactotron;
+
+namespace {
+
+const RecordLayout &Layout() {
+  static const RecordLayout layout = RecordLayout::Make("id: u32, text: string");
+  return layout;
+}
+
+std::shared_ptr<RecordBatch> Batch(int records) {
+  RecordBatchWriter writer(Layout());
+  for (int i = 0; i < records; ++i) {
+    auto record = writer.Append();
+    record.Set(0, i);
+    record.Set(1, "x");
+  }
+  return writer.Finish();
+}
+
+BulkChannelStats StatsOf(const BulkChannels &channels, const std::string &name) {
+  for (const auto &stats : channels.Stats()) {
+    if (stats.name == name) return stats;
+  }
+  return BulkChannelStats();
+}
+
+} // namespace
+
+TEST(HandsBatchesOverInOrder) {
+  BulkChannels channels;
+  auto first = Batch(2);
+  auto second = Batch(3);
+  channels.Push("logs", first);
+  channels.Push("logs", second);
+  channels.Push("logs", Batch(0)); // Ignored
+  channels.Push("logs", nullptr);
+  CHECK(channels.Take("other") == nullptr);
+  CHECK(channels.Take("logs") == first);
+  CHECK(channels.Take("logs") == second);
+  CHECK(channels.Take("logs") == nullptr);
+
+  auto stats = StatsOf(channels, "logs");
+  CHECK_EQ(stats.pushed, uint64_t(2));
+  CHECK_EQ(stats.records, uint64_t(5));
+  CHECK_EQ(stats.taken, uint64_t(2));
+  CHECK_EQ(stats.queued, size_t(0));
+  CHECK_EQ(stats.queuedBytes, uint64_t(0));
+  CHECK_EQ(stats.byteLimit, BulkChannels::kDefaultByteLimit);
+  CHECK_EQ(channels.Stats().size(), size_t(1));
+}
+
+TEST(AnnouncesAChannelOnceUntilItsEmptied) {
+  BulkChannels channels;
+  std::vector<std::string> announced;
+  channels.Push("early", Batch(1));
+  channels.SetPendingCallback([&](const std::string &name) { announced.push_back(name); });
+  CHECK(announced == std::vector<std::string>({"early"}));
+
+  channels.Push("a", Batch(1));
+  channels.Push("a", Batch(1));
+  CHECK_EQ(announced.size(), size_t(2));
+  CHECK(channels.Take("a"));
+  channels.Push("a", Batch(1)); // Not emptied yet
+  CHECK_EQ(announced.size(), size_t(2));
+  CHECK(channels.Take("a"));
+  CHECK(channels.Take("a"));
+  CHECK(!channels.Take("a")); // Now JS knows it's empty
+  channels.Push("a", Batch(1));
+  CHECK(announced == std::vector<std::string>({"early", "a", "a"}));
+
+  channels.SetPendingCallback(nullptr);
+  channels.Push("b", Batch(1));
+  CHECK_EQ(announced.size(), size_t(3));
+}
+
+TEST(DropsTheOldestPastTheByteLimit) {
+  BulkChannels channels;
+  auto batch = Batch(4);
+  channels.Push("a", batch);
+  channels.SetByteLimit("a", batch->Size() * 2);
+  for (int i = 0; i < 5; ++i) channels.Push("a", Batch(4));
+  auto stats = StatsOf(channels, "a");
+  CHECK_EQ(stats.queued, size_t(2));
+  CHECK_EQ(stats.queuedBytes, uint64_t(batch->Size() * 2));
+  CHECK_EQ(stats.dropped, uint64_t(4));
+  CHECK_EQ(stats.droppedRecords, uint64_t(16));
+  CHECK(channels.Take("a") != batch);
+
+  // The newest batch stays even when it's over the limit on its own
+  channels.SetByteLimit("a", 1);
+  CHECK_EQ(StatsOf(channels, "a").queued, size_t(1));
+  channels.Push("a", Batch(4));
+  CHECK_EQ(StatsOf(channels, "a").queued, size_t(1));
+
+  channels.Push("b", Batch(1));
+  channels.Clear();
+  for (const auto &cleared : channels.Stats()) {
+    CHECK_EQ(cleared.queued, size_t(0));
+    CHECK_EQ(cleared.queuedBytes, uint64_t(0));
+  }
+  CHECK_EQ(StatsOf(channels, "b").dropped, uint64_t(1));
+}
+
+TEST(FreesMemoryWhenTheGovernorAsks) {
+  BulkChannels channels;
+  auto batch = Batch(100);
+  for (int i = 0; i < 10; ++i) {
+    channels.Push("a", Batch(100));
+    channels.Push("b", Batch(100));
+  }
+  auto &governor = MemoryGovernor::Shared();
+  uint64_t budget = batch->Size() * 10;
+  governor.SetBudget("bulkChannels", budget);
+  governor.Enforce();
+  governor.SetBudget("bulkChannels", 0);
+
+  auto a = StatsOf(channels, "a");
+  auto b = StatsOf(channels, "b");
+  CHECK(a.queuedBytes + b.queuedBytes <= budget);
+  CHECK(a.dropped > 0);
+  CHECK(b.dropped > 0); // A batch from each in turn
+  CHECK(a.dropped + b.dropped >= 10);
+  for (const auto &usage : governor.Usage()) {
+    if (usage.name == "bulkChannels") CHECK_EQ(usage.bytes, a.queuedBytes + b.queuedBytes);
+  }
+}
+
+TEST(TakesWhileOthersPush) {
+  BulkChannels channels;
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> taken{0};
+  std::thread consumer([&] {
+    for (;;) {
+      bool finished = done;
+      if (auto batch = channels.Take("t")) {
+        taken += batch->Count();
+      } else if (finished) {
+        break;
+      }
+    }
+  });
+  std::vector<std::thread> producers;
+  for (int p = 0; p < 4; ++p) {
+    producers.emplace_back([&] {
+      RecordBatchWriter writer(Layout(), 100);
+      for (int b = 0; b < 200; ++b) {
+        for (int i = 0; i < 100; ++i) writer.Append().Set(0, i);
+        channels.Push("t", writer.Finish());
+      }
+    });
+  }
+  for (auto &producer : producers) producer.join();
+  done = true;
+  consumer.join();
+  CHECK_EQ(taken.load(), uint64_t(4 * 200 * 100));
+  CHECK_EQ(StatsOf(channels, "t").dropped, uint64_t(0));
+}
@@ -0,0 +1,86 @@
+//
+//  FontCatalog.bench.cpp
+//  Reactotron
+//
+//  Enumerating the system's fonts against loading them from the cache, and
+//  searching a catalog of 5000 families.
+//
+
+#include "IRFontList/FontCatalog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void Load(FontCatalog &catalog, const fs::path &cache) {
+  std::promise<void> ready;
+  catalog.Start(cache.string());
+  catalog.WhenReady([&] { ready.set_value(); });
+  ready.get_future().wait();
+}
+
+} // namespace
+
+int main() {
+  fs::path directory = fs::temp_directory_path() / "reactotron-font-catalog-bench";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+
+  auto start = Clock::now();
+  uint64_t signature = FontCatalog::FontDirectorySignature();
+  std::printf("directory signature: %.2f ms\n", MsSince(start));
+  for (int round = 0; round < 2; ++round) {
+    FontCatalog catalog;
+    Load(catalog, directory / "FontCatalog.bin");
+    FontCatalogStats stats = catalog.Stats();
+    std::printf("%s: %zu families in %.2f ms\n", stats.fromCache ? "from the cache" : "enumerated", stats.families,
+                stats.loadMs);
+  }
+
+  // A cache of 5000 made-up families, to search
+  std::string data("IRFC", 4);
+  auto write = [&](const void *in, size_t size) { data.append(static_cast<const char *>(in), size); };
+  uint32_t version = FontCatalog::kCacheVersion;
+  uint32_t count = 5000;
+  write(&version, sizeof(version));
+  write(&signature, sizeof(signature));
+  write(&count, sizeof(count));
+  for (uint32_t i = 0; i < count; ++i) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "Family %c%c Sans-%u %s", 'A' + i % 26, 'a' + (i / 26) % 26, i,
+                  i % 7 == 0 ? "Mono" : "Serif");
+    auto length = static_cast<uint16_t>(std::strlen(name));
+    uint8_t monospace = i % 7 == 0;
+    uint16_t weights = 0x1ff;
+    write(&length, sizeof(length));
+    write(&monospace, sizeof(monospace));
+    write(&weights, sizeof(weights));
+    data += name;
+  }
+  fs::path synthetic = directory / "synthetic.bin";
+  std::ofstream(synthetic, std::ios::binary) << data;
+  FontCatalog catalog;
+  Load(catalog, synthetic);
+  for (const char *query : {"family b", "sans-12", "fbm", "mono"}) {
+    size_t found = 0;
+    start = Clock::now();
+    for (int i = 0; i < 200; ++i) found += catalog.Search(query, 20, false).size();
+    std::printf("search \"%s\" in 5000 families: %.1f us (%zu found)\n", query, MsSince(start) * 1000 / 200,
+                found / 200);
+  }
+  fs::remove_all(directory);
+  return 0;
+}
@@ -0,0 +1,135 @@
+//
+//  FontCatalog.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRFontList/FontCatalog.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+using namespace reactotron;
+namespace fs = std::filesystem;
+
+namespace {
+
+/** A fresh directory for this test's caches. */
+fs::path CacheDirectory() {
+  fs::path directory = fs::temp_directory_path() / "reactotron-font-catalog-test";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  return directory;
+}
+
+/** Writes a cache in FontCatalog's format, so searches run on known families. */
+void WriteCache(const fs::path &path, uint64_t signature, const std::vector<FontFamily> &families) {
+  std::string data("IRFC", 4);
+  auto write = [&](const void *in, size_t size) { data.append(static_cast<const char *>(in), size); };
+  uint32_t version = FontCatalog::kCacheVersion;
+  auto count = static_cast<uint32_t>(families.size());
+  write(&version, sizeof(version));
+  write(&signature, sizeof(signature));
+  write(&count, sizeof(count));
+  for (const FontFamily &family : families) {
+    auto length = static_cast<uint16_t>(family.name.size());
+    uint8_t monospace = family.monospace;
+    write(&length, sizeof(length));
+    write(&monospace, sizeof(monospace));
+    write(&family.weights, sizeof(family.weights));
+    data += family.name;
+  }
+  std::ofstream(path, std::ios::binary) << data;
+}
+
+void Load(FontCatalog &catalog, const fs::path &cache) {
+  std::promise<void> ready;
+  catalog.Start(cache.string());
+  catalog.WhenReady([&] { ready.set_value(); });
+  ready.get_future().wait();
+}
+
+std::vector<std::string> Names(const std::vector<FontFamily> &families) {
+  std::vector<std::string> names;
+  for (const auto &family : families) names.push_back(family.name);
+  return names;
+}
+
+const std::vector<FontFamily> kFamilies = {
+  {"Andale Mono", true, 0x008},  {"DejaVu Sans", false, 0x0a8}, {"DejaVu Sans Mono", true, 0x088},
+  {"Fira Code", true, 0x0fc},    {"JetBrains Mono", true, 0x1ff}, {"menlo", true, 0x088},
+  {"Monaco", true, 0x008},       {"Noto Sans", false, 0x1ff},   {"Source Code Pro", true, 0x1ff},
+};
+
+} // namespace
+
+TEST(SearchesByPrefixThenWordThenFuzzy) {
+  fs::path cache = CacheDirectory() / "FontCatalog.bin";
+  WriteCache(cache, FontCatalog::FontDirectorySignature(), kFamilies);
+  FontCatalog catalog;
+  Load(catalog, cache);
+  CHECK(catalog.Ready());
+  FontCatalogStats stats = catalog.Stats();
+  CHECK(stats.fromCache);
+  CHECK_EQ(stats.families, kFamilies.size());
+  CHECK(Names(catalog.Families()) == Names(kFamilies));
+  CHECK_EQ(catalog.Families()[4].weights, uint16_t(0x1ff));
+
+  CHECK((Names(catalog.Search("MON", 10, false)) ==
+         std::vector<std::string>{"Monaco", "Andale Mono", "DejaVu Sans Mono", "JetBrains Mono"}));
+  CHECK((Names(catalog.Search("sans", 10, false)) ==
+         std::vector<std::string>{"DejaVu Sans", "DejaVu Sans Mono", "Noto Sans"}));
+  CHECK((Names(catalog.Search("scp", 10, false)) == std::vector<std::string>{"Source Code Pro"}));
+  CHECK((Names(catalog.Search("sans", 10, true)) == std::vector<std::string>{"DejaVu Sans Mono"}));
+  CHECK_EQ(catalog.Search("mono", 2, false).size(), size_t(2));
+  CHECK_EQ(catalog.Search("", 100, false).size(), kFamilies.size());
+  CHECK_EQ(catalog.Search("", 100, true).size(), size_t(7));
+  CHECK(catalog.Search("zzzq", 10, false).empty());
+
+  // Already loaded, so it runs right away
+  bool ran = false;
+  catalog.WhenReady([&] { ran = true; });
+  CHECK(ran);
+}
+
+TEST(EnumeratesAndCachesWhenThereIsNoCache) {
+  fs::path cache = CacheDirectory() / "nested" / "FontCatalog.bin";
+  std::vector<FontFamily> enumerated = FontCatalog::Enumerate();
+  {
+    FontCatalog catalog;
+    Load(catalog, cache);
+    CHECK(!catalog.Stats().fromCache);
+    CHECK(Names(catalog.Families()) == Names(enumerated));
+  }
+  CHECK(fs::exists(cache));
+  FontCatalog catalog;
+  Load(catalog, cache);
+  CHECK(catalog.Stats().fromCache);
+  CHECK(Names(catalog.Families()) == Names(enumerated));
+}
+
+TEST(IgnoresStaleAndDamagedCaches) {
+  fs::path directory = CacheDirectory();
+  uint64_t signature = FontCatalog::FontDirectorySignature();
+  size_t enumerated = FontCatalog::Enumerate().size();
+
+  fs::path stale = directory / "stale.bin";
+  WriteCache(stale, signature + 1, kFamilies);
+  fs::path truncated = directory / "truncated.bin";
+  WriteCache(truncated, signature, kFamilies);
+  fs::resize_file(truncated, fs::file_size(truncated) - 3);
+  fs::path garbage = directory / "garbage.bin";
+  std::ofstream(garbage, std::ios::binary) << "not a font cache";
+
+  for (const fs::path &cache : {stale, truncated, garbage}) {
+    FontCatalog catalog;
+    Load(catalog, cache);
+    CHECK(!catalog.Stats().fromCache);
+    CHECK_EQ(catalog.Families().size(), enumerated);
+  }
+  // Each was rewritten, so it's used next time
+  FontCatalog catalog;
+  Load(catalog, stale);
+  CHECK(catalog.Stats().fromCache);
+}
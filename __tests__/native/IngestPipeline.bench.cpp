@@ -0,0 +1,57 @@
+//
+//  IngestPipeline.bench.cpp
+//  Reactotron
+//
+//  100000 log commands from 1, 4 and 32 clients, half of them from one busy
+//  client, through pipelines of 1 to 8 workers.
+//
+
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+int main() {
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  const int count = 100000;
+  for (int clients : {1, 4, 32}) {
+    std::vector<std::string> messages;
+    std::mt19937 rng(clients);
+    size_t bytes = 0;
+    for (int i = 0; i < count; ++i) {
+      int client = rng() % 10 < 5 ? 0 : static_cast<int>(rng() % clients);
+      messages.push_back("{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{\"level\":\"debug\",\"message\":\"" +
+                         std::string(200 + rng() % 1800, 'x') + "\"},\"clientId\":\"client-" + std::to_string(client) +
+                         "\",\"messageId\":" + std::to_string(i) + "}}");
+      bytes += messages.back().size();
+    }
+
+    auto start = Clock::now();
+    size_t keys = 0;
+    for (const auto &message : messages) keys += IngestPipeline::ShardKey(message).size();
+    std::printf("clients %2d: shard key %.0f ns/msg (%.0f bytes a message)\n", clients,
+                std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count, double(bytes) / count);
+
+    for (size_t workers : {1, 2, 4, 8}) {
+      auto copy = messages;
+      size_t committed = 0;
+      start = Clock::now();
+      IngestPipeline pipeline(workers, [&](std::vector<std::string> &out, std::vector<IngestedItem> &, uint64_t) {
+        committed += out.size();
+      });
+      for (auto &message : copy) pipeline.Submit(std::move(message));
+      pipeline.Drain();
+      double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+      std::printf("clients %2d workers %zu: %7.1f ms, %5.0f ns/msg, %6.0f MB/s, steals %llu\n", clients, workers, ms,
+                  ms * 1e6 / count, bytes / ms / 1e3, static_cast<unsigned long long>(pipeline.Stats().steals));
+      if (committed != messages.size()) return 1;
+    }
+    if (keys == 0) return 1;
+  }
+  return 0;
+}
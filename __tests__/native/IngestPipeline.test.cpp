@@ -0,0 +1,126 @@
+//
+//  IngestPipeline.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+std::string Log(int client, int messageId, size_t padding) {
+  return "{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{\"level\":\"debug\",\"message\":\"" +
+         std::string(padding, 'x') +
+         "\",\"nested\":{\"clientId\":\"decoy\",\"a\":[1,2.5,-3e2,true,null]}},\"important\":false,"
+         "\"date\":\"2024-01-01T00:00:00.000Z\",\"clientId\":\"client-" +
+         std::to_string(client) + "\",\"messageId\":" + std::to_string(messageId) + "}}";
+}
+
+/** Runs `messages` through a pipeline and returns what it committed. */
+std::vector<std::string> RunThrough(const std::vector<std::string> &messages, size_t workers,
+                                    IngestStats *stats = nullptr) {
+  std::vector<std::string> out;
+  IngestPipeline pipeline(workers, [&](std::vector<std::string> &committed, std::vector<IngestedItem> &items, uint64_t) {
+    CHECK_EQ(items.size(), committed.size());
+    for (auto &message : committed) out.push_back(std::move(message));
+  });
+  for (const auto &message : messages) pipeline.Submit(message);
+  pipeline.Drain();
+  if (stats) *stats = pipeline.Stats();
+  return out;
+}
+
+std::string Sanitized(const std::string &message) {
+  auto out = RunThrough({message}, 2);
+  return out.empty() ? "<dropped>" : out[0];
+}
+
+} // namespace
+
+TEST(ShardsByTheCommandsClient) {
+  CHECK_EQ(IngestPipeline::ShardKey(Log(3, 1, 10)), "client-3");
+  CHECK_EQ(IngestPipeline::ShardKey("{\"type\":\"connectionEstablished\",\"conn\":{\"clientId\":\"abc\"}}"), "abc");
+  CHECK_EQ(IngestPipeline::ShardKey("{\"type\":\"connectedClients\",\"clients\":[{\"clientId\":\"abc\"}]}"), "");
+  CHECK_EQ(IngestPipeline::ShardKey("{\"type\":\"command\",\"cmd\":{\"payload\":{\"clientId\":\"no\"},"
+                                    "\"v\":\"\\\"clientId\\\":\\\"x\",\"clientId\":\"yes\"}}"),
+           "yes");
+  CHECK_EQ(IngestPipeline::ShardKey("{\"type\":\"reactotron.connected\"}"), "");
+  CHECK_EQ(IngestPipeline::ShardKey("not json"), "");
+}
+
+TEST(StripsProtoKeys) {
+  CHECK_EQ(Sanitized("{\"a\":1}"), "{\"a\":1}");
+  CHECK_EQ(Sanitized("{\"__proto__\":1}"), "{}");
+  CHECK_EQ(Sanitized("{\"__proto__\":1,\"a\":2}"), "{\"a\":2}");
+  CHECK_EQ(Sanitized("{\"a\":1,\"__proto__\":2}"), "{\"a\":1}");
+  CHECK_EQ(Sanitized("{\"a\":1,\"__proto__\":{\"x\":1},\"__proto__\":3}"), "{\"a\":1}");
+  CHECK_EQ(Sanitized("{\"__proto__\":1,\"__proto__\":2}"), "{}");
+  CHECK_EQ(Sanitized("{\"__proto__\":1,\"a\":2,\"__proto__\":3,\"b\":4}"), "{\"a\":2,\"b\":4}");
+  CHECK_EQ(Sanitized("{\"a\":{\"__proto__\":{\"__proto__\":1}},\"b\":[{\"\\u005f_proto__\":1,\"c\":2}]}"),
+           "{\"a\":{},\"b\":[{\"c\":2}]}");
+  CHECK_EQ(Sanitized("{ \"a\" : 1 , \"__proto__\" : 2 }"), "{ \"a\" : 1 }");
+  CHECK_EQ(Sanitized("{\"constructor\":1}"), "{\"constructor\":1}");
+  CHECK_EQ(Sanitized("{\"__proto_\":1}"), "{\"__proto_\":1}");
+}
+
+TEST(DropsMalformedMessages) {
+  for (const char *bad : {"", "{", "{\"a\":}", "{\"a\":1,}", "[1,]", "{\"a\":01}", "{\"a\":\"\\x\"}", "{\"a\":\"\x01\"}",
+                          "{} x", "tru", "\"abc", "{\"a\":1.}", "{\"a\":\"\\u12\"}"}) {
+    CHECK_EQ(Sanitized(bad), "<dropped>");
+  }
+  for (const char *good : {"1", "\"s\"", "[]", "{}", "-0.5e+3", "{\"a\":\"\\u00e9\\n\\\\\"}", " [ null , true ] "}) {
+    CHECK_EQ(Sanitized(good), good);
+  }
+  CHECK_EQ(Sanitized(std::string(300, '[') + std::string(300, ']')), "<dropped>");
+}
+
+TEST(CommitsInSubmissionOrderWithAnyNumberOfWorkers) {
+  for (size_t workers : {1, 2, 4, 8}) {
+    std::vector<std::string> messages;
+    std::mt19937 rng(static_cast<unsigned>(workers));
+    for (int i = 0; i < 20000; ++i) messages.push_back(Log(rng() % 13, i, rng() % 300));
+    messages.push_back("garbage");
+    IngestStats stats;
+    auto out = RunThrough(messages, workers, &stats);
+    CHECK_EQ(out.size(), messages.size() - 1);
+    bool ordered = out.size() == messages.size() - 1;
+    for (size_t i = 0; ordered && i < out.size(); ++i) ordered = out[i] == messages[i];
+    CHECK(ordered);
+
+    uint64_t total = 0;
+    uint64_t malformed = 0;
+    for (const auto &client : stats.clients) {
+      total += client.messages;
+      malformed += client.malformed;
+    }
+    CHECK_EQ(stats.workers, workers);
+    CHECK_EQ(total, uint64_t(messages.size()));
+    CHECK_EQ(malformed, uint64_t(1));
+    CHECK_EQ(stats.submitted, uint64_t(messages.size()));
+    CHECK_EQ(stats.committed, uint64_t(messages.size()));
+  }
+}
+
+TEST(CountsEachClientSeparately) {
+  std::vector<std::string> messages = {Log(1, 1, 10), Log(2, 2, 10), Log(1, 3, 10),
+                                       "{\"type\":\"command\",\"cmd\":{\"clientId\":\"client-2\",\"__proto__\":1}}"};
+  IngestStats stats;
+  RunThrough(messages, 2, &stats);
+  for (const auto &client : stats.clients) {
+    if (client.clientId == "client-1") {
+      CHECK_EQ(client.messages, uint64_t(2));
+      CHECK_EQ(client.commands, uint64_t(2));
+      CHECK_EQ(client.largestMessage, uint64_t(messages[0].size()));
+    } else if (client.clientId == "client-2") {
+      CHECK_EQ(client.messages, uint64_t(2));
+      CHECK_EQ(client.unsafeKeys, uint64_t(1));
+    } else {
+      CHECK(false);
+    }
+  }
+  CHECK_EQ(stats.clients.size(), size_t(2));
+}
@@ -0,0 +1,72 @@
+//
+//  ItemHandles.bench.cpp
+//  Reactotron
+//
+//  A million items from four clients, arriving in runs: interning them and
+//  looking them up, against string keys like `${clientId}-${messageId}`.
+//
+
+#include "IRIds/ItemHandles.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double NsPer(Clock::time_point start, size_t count) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(count);
+}
+
+} // namespace
+
+int main() {
+  const size_t count = 1'000'000;
+  std::vector<std::string> clients = {"3f1c2a9e-5b7d-4e21-9c0a-aa11bb22cc33", "7a8b9c0d-1e2f-4a3b-8c4d-5e6f7a8b9c0d",
+                                      "00112233-4455-4677-8899-aabbccddeeff", "deadbeef-0000-4000-8000-feedfacecafe"};
+  std::vector<std::pair<size_t, uint64_t>> keys;
+  uint64_t next[4] = {1, 1, 1, 1};
+  std::mt19937 rng(1);
+  while (keys.size() < count) {
+    size_t client = rng() % 4;
+    for (int run = 1 + rng() % 50; run > 0 && keys.size() < count; --run) keys.push_back({client, next[client]++});
+  }
+  std::vector<size_t> order(count);
+  for (auto &index : order) index = rng() % count;
+
+  ItemHandleTable table;
+  auto start = Clock::now();
+  for (const auto &[client, message] : keys) table.Intern(clients[client], message);
+  std::printf("intern: %.1f ns/item, %.1f bytes/item\n", NsPer(start, count), double(table.ByteSize()) / count);
+
+  uint64_t sum = 0;
+  start = Clock::now();
+  for (size_t i : order) sum += table.Find(clients[keys[i].first], keys[i].second);
+  std::printf("find (random order): %.1f ns\n", NsPer(start, count));
+
+  std::string clientId;
+  uint64_t messageId;
+  start = Clock::now();
+  for (size_t i : order) {
+    table.Key(i + 1, clientId, messageId);
+    sum += messageId;
+  }
+  std::printf("key by handle: %.1f ns\n", NsPer(start, count));
+
+  std::unordered_map<std::string, size_t> byString;
+  start = Clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    byString.emplace(clients[keys[i].first] + "-" + std::to_string(keys[i].second), i);
+  }
+  std::printf("string keys: build %.1f ns/item", NsPer(start, count));
+  start = Clock::now();
+  for (size_t i : order) sum += byString.find(clients[keys[i].first] + "-" + std::to_string(keys[i].second))->second;
+  std::printf(", find %.1f ns\n", NsPer(start, count));
+  return sum == 0;
+}
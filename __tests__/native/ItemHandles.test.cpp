@@ -0,0 +1,105 @@
+//
+//  ItemHandles.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRIds/ItemHandles.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <mutex>
+
+using namespace reactotron;
+
+namespace {
+
+std::string Command(const char *type, const char *clientId, int messageId) {
+  return std::string("{\"type\":\"command\",\"cmd\":{\"type\":\"") + type +
+         "\",\"payload\":{\"level\":\"debug\",\"message\":\"m" + std::to_string(messageId) + "\"},\"clientId\":\"" +
+         clientId + "\",\"messageId\":" + std::to_string(messageId) + "}}";
+}
+
+} // namespace
+
+TEST(InternsItemsIntoDenseHandles) {
+  ItemHandleTable table;
+  CHECK_EQ(table.Find("a", 1), uint64_t(0));
+  CHECK_EQ(table.Intern("client-a", 1), uint64_t(1));
+  CHECK_EQ(table.Intern("client-b", 1), uint64_t(2));
+  CHECK_EQ(table.Intern("client-a", 2), uint64_t(3));
+  CHECK_EQ(table.Intern("client-a", 1), uint64_t(1));
+  CHECK_EQ(table.Find("client-b", 1), uint64_t(2));
+  CHECK_EQ(table.Find("client-b", 2), uint64_t(0));
+  CHECK_EQ(table.Find("x", 1), uint64_t(0));
+
+  std::string clientId;
+  uint64_t messageId;
+  CHECK(table.Key(3, clientId, messageId));
+  CHECK_EQ(clientId, "client-a");
+  CHECK_EQ(messageId, uint64_t(2));
+  CHECK(!table.Key(0, clientId, messageId));
+  CHECK(!table.Key(4, clientId, messageId));
+
+  // Handles aren't reused after a clear
+  table.Clear();
+  CHECK_EQ(table.Size(), size_t(0));
+  CHECK_EQ(table.Find("client-a", 1), uint64_t(0));
+  CHECK(!table.Key(3, clientId, messageId));
+  CHECK_EQ(table.Intern("client-z", 5), uint64_t(4));
+  CHECK(table.Key(4, clientId, messageId));
+  CHECK_EQ(clientId, "client-z");
+  CHECK_EQ(messageId, uint64_t(5));
+
+  // Past a few rehashes
+  for (uint64_t i = 0; i < 100000; ++i) table.Intern(i % 2 ? "client-a" : "client-b", i);
+  CHECK_EQ(table.Size(), size_t(100001));
+  CHECK_EQ(table.Find("client-a", 99999), uint64_t(100004));
+  CHECK_EQ(table.Find("client-b", 99999), uint64_t(0));
+}
+
+TEST(IngestNumbersItemsInArrivalOrderAndClearsAtClear) {
+  std::vector<uint64_t> ids;
+  std::mutex mutex;
+  {
+    IngestPipeline pipeline(4, [&](std::vector<std::string> &messages, std::vector<IngestedItem> &items, uint64_t) {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < messages.size(); ++i) ids.push_back(items[i].itemId);
+    });
+    for (int i = 0; i < 3000; ++i) {
+      pipeline.Submit(Command(i == 1500 ? "clear" : i % 3 ? "log" : "display", i % 2 ? "a" : "b", i));
+    }
+    pipeline.Drain();
+  }
+  CHECK_EQ(ids.size(), size_t(3000));
+  uint64_t previous = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i == 1500) {
+      CHECK_EQ(ids[i], uint64_t(0));
+      continue;
+    }
+    CHECK_EQ(ids[i], previous + 1);
+    previous = ids[i];
+  }
+
+  auto &handles = SharedItemHandles::Get();
+  std::lock_guard<std::mutex> lock(handles.mutex);
+  CHECK_EQ(handles.table.Size(), size_t(1499));
+  std::string clientId;
+  uint64_t messageId;
+  CHECK(!handles.table.Key(ids[10], clientId, messageId));
+  CHECK(handles.table.Key(ids[2000], clientId, messageId));
+  CHECK_EQ(messageId, uint64_t(2000));
+  CHECK_EQ(clientId, "b");
+}
+
+TEST(ImportedMessagesShareTheirItemsHandle) {
+  std::vector<std::string> messages = {Command("log", "x", 7), "{\"type\":\"other\"}", Command("log", "x", 7)};
+  std::vector<IngestedItem> items;
+  IngestPipeline::Ingest(messages, items);
+  CHECK_EQ(items.size(), size_t(3));
+  if (items.size() == 3) {
+    CHECK(items[0].itemId != 0);
+    CHECK_EQ(items[2].itemId, items[0].itemId);
+    CHECK_EQ(items[1].itemId, uint64_t(0));
+  }
+}
@@ -0,0 +1,43 @@
+//
+//  LogStats.bench.cpp
+//  Reactotron
+//
+//  Two million logs from 5000 Zipf-distributed sources, then a storm of one
+//  repeated React warning.
+//
+
+#include "IRLogStats/LogStats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace reactotron;
+
+int main() {
+  constexpr size_t kLogs = 2000000;
+  std::vector<std::string> messages;
+  std::vector<double> weights;
+  for (int i = 0; i < 5000; i++) {
+    messages.push_back("source-" + std::to_string(i) + " render loop");
+    weights.push_back(1.0 / (i + 1));
+  }
+  std::mt19937_64 rng(7);
+  std::discrete_distribution<int> source(weights.begin(), weights.end());
+  std::vector<int> sequence(kLogs);
+  for (auto &index : sequence) index = source(rng);
+
+  LogStats zipf(20);
+  auto start = std::chrono::steady_clock::now();
+  for (int index : sequence) zipf.Record("debug", messages[index], "App.tsx:42");
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("zipf: %zu logs, %.0f ns/log\n", kLogs, seconds * 1e9 / kLogs);
+
+  LogStats storm;
+  std::string warning = "Warning: Each child in a list should have a unique \"key\" prop. Check the render method of `Row`.";
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kLogs; i++) storm.Record("warn", warning, "Row (Row.tsx:12:3)");
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("storm: %.0f ns/log, counted %u\n", seconds * 1e9 / kLogs, storm.HeavyHitters()[0].count);
+  return 0;
+}
@@ -0,0 +1,149 @@
+//
+//  LogStats.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRLogStats/LogStats.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+std::string Template(std::string_view message, size_t maxLength = 200) {
+  std::string out;
+  AppendLogTemplate(message, maxLength, out);
+  return out;
+}
+
+std::string LogMessage(const std::string &level, const std::string &message, const std::string &stack = "") {
+  return "{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"clientId\":\"c\",\"messageId\":1,\"payload\":{\"level\":\"" +
+         level + "\",\"message\":" + message + (stack.empty() ? "" : ",\"stack\":" + stack) + "}}}";
+}
+
+/** The log key the ingest workers give a message, or 0 if it isn't a log. */
+uint64_t LogKey(const std::string &text) {
+  std::vector<std::string> messages{text};
+  std::vector<IngestedItem> items;
+  IngestPipeline::Ingest(messages, items);
+  return items.size() == 1 ? items[0].logKey : ~0ull;
+}
+
+} // namespace
+
+TEST(TemplatesReplaceNumbersAndIds) {
+  CHECK_EQ(Template("retry 3 of 10"), "retry # of #");
+  CHECK_EQ(Template("user42 logged in"), "user# logged in");
+  CHECK_EQ(Template("ptr 0x7ffe12ab done"), "ptr # done");
+  CHECK_EQ(Template("id deadbeef12 x"), "id # x");
+  CHECK_EQ(Template("deadbeef"), "deadbeef"); // No digit, so it's a word
+  CHECK_EQ(Template(""), "");
+}
+
+TEST(TemplatesTruncateOnCharacterBoundaries) {
+  CHECK_EQ(Template("h\xc3\xa9llo", 2), "h");
+  CHECK_EQ(Template("h\xc3\xa9llo", 3), "h\xc3\xa9");
+}
+
+TEST(HashesDependOnLengthAndSeed) {
+  CHECK(HashBytes("abc") == HashBytes("abc"));
+  CHECK(HashBytes("abc") != HashBytes("abd"));
+  CHECK(HashBytes("") != HashBytes("", 1));
+  CHECK(HashBytes(std::string(9, 'a')) != HashBytes(std::string(10, 'a')));
+}
+
+TEST(CountMinSketchNeverUndercounts) {
+  CountMinSketch sketch(1000, 4);
+  CHECK_EQ(sketch.ByteSize(), 1024u * 4 * 4); // Width rounds up to a power of two
+  for (int i = 0; i < 100; i++) sketch.Add(42);
+  CHECK_EQ(sketch.Estimate(42), 100u);
+  CHECK_EQ(sketch.Estimate(43), 0u);
+}
+
+TEST(FingerprintsAreExactAndSourcesAreTemplates) {
+  LogStats stats(5);
+  uint64_t first = stats.Record("debug", "retry 1", "f a.js:1");
+  uint64_t second = stats.Record("debug", "retry 2", "f a.js:1");
+  CHECK(first != second);
+  CHECK_EQ(stats.Record("debug", "retry 1", "f a.js:1"), first);
+  CHECK(stats.Record("warn", "retry 1", "f a.js:1") != first);
+  CHECK(stats.Record("debug", "retry 1", "g") != first);
+
+  auto top = stats.HeavyHitters();
+  CHECK_EQ(top[0].label, "retry #");
+  CHECK_EQ(top[0].count, 3u);
+  CHECK_EQ(top[0].level, "debug");
+  CHECK_EQ(top[0].stackTop, "f a.js:1");
+  CHECK_EQ(stats.Total(), 5u);
+
+  stats.Clear();
+  CHECK_EQ(stats.Total(), 0u);
+  CHECK(stats.HeavyHitters().empty());
+}
+
+TEST(FindsTheTopSourcesOfAZipfStorm) {
+  std::vector<std::string> messages;
+  std::vector<double> weights;
+  for (int i = 0; i < 5000; i++) {
+    messages.push_back("source-" + std::string(1, 'a' + i % 26) + std::string(1, 'a' + (i / 26) % 26) +
+                       std::string(1, 'a' + (i / 676) % 26) + " render loop");
+    weights.push_back(1.0 / (i + 1));
+  }
+  std::mt19937_64 rng(7);
+  std::discrete_distribution<int> source(weights.begin(), weights.end());
+  LogStats stats(20);
+  std::map<int, uint64_t> truth;
+  for (int i = 0; i < 200000; i++) {
+    int index = source(rng);
+    truth[index]++;
+    stats.Record("debug", messages[index], "App.tsx:42");
+  }
+
+  std::vector<std::pair<uint64_t, int>> byCount;
+  for (const auto &[index, count] : truth) byCount.push_back({count, index});
+  std::sort(byCount.rbegin(), byCount.rend());
+  auto top = stats.HeavyHitters();
+  int found = 0;
+  for (int i = 0; i < 20; i++) {
+    for (const auto &entry : top) {
+      if (entry.label != messages[byCount[i].second]) continue;
+      found++;
+      CHECK(entry.count >= byCount[i].first);
+    }
+  }
+  CHECK(found >= 19);
+}
+
+TEST(IngestKeysLogsByContent) {
+  uint64_t hello = LogKey(LogMessage("debug", "\"hello\""));
+  CHECK(hello != 0);
+  CHECK_EQ(LogKey(LogMessage("debug", "\"hello\"")), hello);
+  CHECK_EQ(LogKey(LogMessage("debug", "\"h\\u0065llo\"")), hello); // Escapes are decoded first
+  CHECK(LogKey(LogMessage("warn", "\"hello\"")) != hello);
+  CHECK_EQ(LogKey(LogMessage("debug", "{\"a\":1}")), LogKey(LogMessage("debug", "{\"a\":1,\"__proto__\":2}")));
+}
+
+TEST(IngestKeysErrorsByStackTop) {
+  // Stack tops only count for errors
+  CHECK_EQ(LogKey(LogMessage("debug", "\"x\"", "\"at a\\nat b\"")), LogKey(LogMessage("debug", "\"x\"", "\"at c\"")));
+  CHECK_EQ(LogKey(LogMessage("error", "\"x\"", "\"  \\n at a \\nat b\"")),
+           LogKey(LogMessage("error", "\"x\"", "\"at a\\nat c\"")));
+  CHECK(LogKey(LogMessage("error", "\"x\"", "\"at a\"")) != LogKey(LogMessage("error", "\"x\"", "\"at c\"")));
+
+  std::string twoFrames = "[{\"functionName\":\"f\",\"fileName\":\"a.js\",\"lineNumber\":3},{\"functionName\":\"g\"}]";
+  std::string sameTop = "[{\"functionName\":\"f\",\"fileName\":\"a.js\",\"lineNumber\":3}]";
+  std::string otherLine = "[{\"functionName\":\"f\",\"fileName\":\"a.js\",\"lineNumber\":4}]";
+  CHECK_EQ(LogKey(LogMessage("error", "\"x\"", twoFrames)), LogKey(LogMessage("error", "\"x\"", sameTop)));
+  CHECK(LogKey(LogMessage("error", "\"x\"", twoFrames)) != LogKey(LogMessage("error", "\"x\"", otherLine)));
+  CHECK_EQ(LogKey(LogMessage("error", "\"x\"", "[]")), LogKey(LogMessage("error", "\"x\"")));
+}
+
+TEST(IngestSkipsNonLogs) {
+  CHECK_EQ(LogKey("{\"type\":\"command\",\"cmd\":{\"type\":\"display\",\"payload\":{\"level\":\"x\"}}}"), 0u);
+  CHECK_EQ(LogKey("{\"type\":\"connectedClients\",\"clients\":[]}"), 0u);
+}
@@ -0,0 +1,262 @@
+//
+//  MemoryGovernor.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRMemoryGovernor/MemoryGovernor.h"
+#include "IRStateSnapshots/StateSnapshots.h"
+#include "IRTimelineQuery/TimelineQuery.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace reactotron;
+using namespace std::chrono_literals;
+
+namespace {
+
+/** A native store holding `bytes`, that frees what it's asked to and reports it. */
+struct FakeStore {
+  MemoryGovernor &governor;
+  uint64_t bytes;
+  int64_t oldest;
+  uint32_t id = 0;
+
+  FakeStore(MemoryGovernor &governor, const char *name, uint64_t bytes, int64_t oldest)
+      : governor(governor), bytes(bytes), oldest(oldest) {
+    id = governor.Register(name, [this](uint64_t asked) {
+      uint64_t freed = std::min(asked, this->bytes);
+      this->bytes -= freed;
+      this->governor.Report(id, this->bytes, this->oldest);
+      return freed;
+    });
+    governor.Report(id, bytes, oldest);
+  }
+};
+
+uint64_t Bytes(const MemoryGovernor &governor, const char *name) {
+  for (const auto &usage : governor.Usage()) {
+    if (usage.name == name) return usage.bytes;
+  }
+  return UINT64_MAX;
+}
+
+uint64_t Total(const MemoryGovernor &governor) {
+  uint64_t total = 0;
+  for (const auto &usage : governor.Usage()) total += usage.bytes;
+  return total;
+}
+
+} // namespace
+
+TEST(KeepsEachStoreWithinItsBudget) {
+  MemoryGovernor governor;
+  FakeStore store(governor, "taskScrollback", 10000, 5);
+  FakeStore other(governor, "stateSnapshots", 10000, 1);
+  governor.SetBudget("taskScrollback", 5000);
+  auto evictions = governor.Enforce();
+  CHECK_EQ(evictions.size(), size_t(1));
+  if (evictions.size() == 1) {
+    CHECK_EQ(evictions[0].store, "taskScrollback");
+    CHECK(evictions[0].native);
+    CHECK_EQ(evictions[0].bytes, uint64_t(5500));
+    CHECK_EQ(evictions[0].freed, uint64_t(5500));
+  }
+  CHECK_EQ(Bytes(governor, "taskScrollback"), uint64_t(4500));
+  CHECK_EQ(Bytes(governor, "stateSnapshots"), uint64_t(10000));
+  CHECK(governor.Enforce().empty());
+
+  for (const auto &usage : governor.Usage()) {
+    if (usage.name != "taskScrollback") continue;
+    CHECK_EQ(usage.budget, uint64_t(5000));
+    CHECK_EQ(usage.evictedBytes, uint64_t(5500));
+    CHECK_EQ(usage.evictions, uint64_t(1));
+  }
+}
+
+TEST(TakesTheLeastRecentlyUsedDataFirstForTheGlobalBudget) {
+  MemoryGovernor governor;
+  governor.Report("timeline", 5000, 1, true); // JS, oldest of all
+  FakeStore snapshots(governor, "stateSnapshots", 3000, 100);
+  FakeStore scrollback(governor, "taskScrollback", 3000, 200);
+  FakeStore unknownAge(governor, "bodies", 1000, 0);
+  uint32_t index = governor.Register("searchIndex", nullptr);
+  governor.Report(index, 1000, 50);
+
+  governor.SetGlobalBudget(6000);
+  CHECK_EQ(governor.GlobalBudget(), uint64_t(6000));
+  auto evictions = governor.Enforce();
+  // 13000 down to 5400: the timeline, then most of the snapshots
+  CHECK_EQ(evictions.size(), size_t(2));
+  if (evictions.size() == 2) {
+    CHECK_EQ(evictions[0].store, "timeline");
+    CHECK(!evictions[0].native);
+    CHECK_EQ(evictions[0].bytes, uint64_t(5000));
+    CHECK_EQ(evictions[0].freed, uint64_t(0));
+    CHECK_EQ(evictions[1].store, "stateSnapshots");
+    CHECK_EQ(evictions[1].bytes, uint64_t(2600));
+  }
+  // Until the JS store reports, it's assumed to have freed what it was asked
+  CHECK_EQ(Bytes(governor, "timeline"), uint64_t(0));
+  CHECK_EQ(Bytes(governor, "searchIndex"), uint64_t(1000));
+  CHECK_EQ(Bytes(governor, "bodies"), uint64_t(1000));
+  CHECK_EQ(Total(governor), uint64_t(5400));
+
+  // Stores that can't say how old their data is go last
+  governor.SetGlobalBudget(2000);
+  evictions = governor.Enforce();
+  CHECK_EQ(evictions.size(), size_t(3));
+  CHECK(!evictions.empty() && evictions.back().store == "bodies");
+  CHECK_EQ(Total(governor), uint64_t(1800));
+}
+
+TEST(AppliesBudgetsSetBeforeTheStoreRegisters) {
+  MemoryGovernor governor;
+  governor.SetBudget("later", 10);
+  uint32_t id = governor.Register("later", [](uint64_t bytes) { return bytes; });
+  governor.Report(id, 100, 1);
+  auto evictions = governor.Enforce();
+  CHECK_EQ(evictions.size(), size_t(1));
+  if (!evictions.empty()) CHECK_EQ(evictions[0].bytes, uint64_t(91));
+  governor.Unregister(id);
+  CHECK(governor.Usage().empty());
+
+  governor.SetBudget("timeline", 100);
+  governor.Report("timeline", 1000, 1, true);
+  CHECK_EQ(governor.Usage()[0].budget, uint64_t(100));
+  governor.SetBudget("timeline", 0);
+  CHECK(governor.Enforce().empty());
+}
+
+TEST(EvictsRealSnapshotsOldestFirst) {
+  MemoryGovernor governor;
+  SnapshotStore snapshots(1ull << 40);
+  uint32_t id = 0;
+  auto report = [&] {
+    auto stats = snapshots.Stats();
+    governor.Report(id, stats.storedBytes, stats.oldestTime);
+  };
+  id = governor.Register("stateSnapshots", [&](uint64_t bytes) {
+    uint64_t freed = snapshots.Shrink(bytes);
+    report();
+    return freed;
+  });
+  for (int i = 0; i < 200; ++i) {
+    std::string json = "{\"i\":" + std::to_string(i) + ",\"blob\":\"";
+    for (int k = 0; k < 2000; ++k) json += static_cast<char>('a' + (i * 7 + k * 13) % 26);
+    json += "\"}";
+    snapshots.Add("c", "s", 1000 + i, json);
+  }
+  report();
+  uint64_t before = Bytes(governor, "stateSnapshots");
+  governor.SetBudget("stateSnapshots", before / 2);
+  governor.Enforce();
+  CHECK(Bytes(governor, "stateSnapshots") <= before / 2);
+  auto left = snapshots.Snapshots("");
+  CHECK(!left.empty() && left.size() < 200);
+  if (!left.empty()) CHECK_EQ(left.back().time, int64_t(1199));
+}
+
+TEST(EvictsRealSearchRowsOldestFirst) {
+  MemoryGovernor governor;
+  TimelineColumns columns;
+  uint32_t id = 0;
+  auto report = [&] { governor.Report(id, columns.ByteSize(), columns.OldestTime()); };
+  id = governor.Register("searchIndex", [&](uint64_t bytes) {
+    uint64_t freed = columns.Shrink(bytes);
+    report();
+    return freed;
+  });
+  for (int i = 0; i < 20000; ++i) {
+    std::string url = "https://api.example.com/items/" + std::to_string(i);
+    TimelineRow row;
+    row.strings[0] = "api.response";
+    row.strings[2] = url;
+    row.numbers[0] = 200;
+    row.numbers[1] = i % 700;
+    row.numbers[2] = 1000 + i;
+    columns.Append(row);
+  }
+  report();
+  uint64_t before = Bytes(governor, "searchIndex");
+  governor.SetBudget("searchIndex", before / 2);
+  governor.Enforce();
+  CHECK(Bytes(governor, "searchIndex") <= before / 2);
+  CHECK(columns.FirstRow() > 0);
+  CHECK_EQ(columns.EndRow(), uint32_t(20000));
+  CHECK_EQ(columns.OldestTime(), int64_t(1000 + columns.FirstRow()));
+}
+
+TEST(AStoreMayUnregisterFromItsOwnCallback) {
+  MemoryGovernor governor;
+  uint32_t id = 0;
+  int calls = 0;
+  id = governor.Register("closing", [&](uint64_t bytes) {
+    calls++;
+    governor.Unregister(id);
+    return bytes;
+  });
+  governor.Report(id, 1000, 1);
+  FakeStore next(governor, "next", 1000, 2);
+  governor.SetGlobalBudget(100);
+  governor.Enforce();
+  CHECK_EQ(calls, 1);
+  CHECK_EQ(Bytes(governor, "closing"), UINT64_MAX);
+  CHECK(next.bytes < 1000);
+  governor.Enforce();
+  CHECK_EQ(calls, 1);
+}
+
+TEST(UnregisterWaitsForARunningCallback) {
+  MemoryGovernor governor;
+  std::atomic<bool> running{false};
+  std::atomic<bool> finished{false};
+  uint32_t id = governor.Register("slow", [&](uint64_t bytes) {
+    running = true;
+    std::this_thread::sleep_for(50ms);
+    finished = true;
+    return bytes;
+  });
+  governor.Report(id, 1000, 1);
+  governor.SetBudget("slow", 10);
+  std::thread enforcer([&] { governor.Enforce(); });
+  while (!running) std::this_thread::yield();
+  governor.Unregister(id);
+  CHECK(finished.load());
+  enforcer.join();
+}
+
+TEST(StoresReportWhileAnotherThreadEnforces) {
+  MemoryGovernor governor;
+  std::mutex mutex;
+  uint64_t bytes = 0;
+  uint32_t id = 0;
+  id = governor.Register("growing", [&](uint64_t asked) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t freed = std::min(asked, bytes);
+    bytes -= freed;
+    governor.Report(id, bytes, 1);
+    return freed;
+  });
+  governor.SetBudget("growing", 1 << 16);
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    for (int i = 0; i < 20000; ++i) {
+      std::lock_guard<std::mutex> lock(mutex);
+      bytes += 100;
+      governor.Report(id, bytes, 1);
+    }
+    stop = true;
+  });
+  while (!stop) {
+    governor.Enforce();
+    governor.Usage();
+  }
+  writer.join();
+  governor.Enforce();
+  CHECK(Bytes(governor, "growing") <= (1 << 16));
+  CHECK_EQ(Bytes(governor, "growing"), bytes);
+}
@@ -0,0 +1,65 @@
+//
+//  MetricsHistory.bench.cpp
+//  Reactotron
+//
+//  Add and query cost over sessions of 1 to 72 hours at 10 samples a second,
+//  against keeping every sample and downsampling the whole window.
+//
+
+#include "IRSystemInfo/MetricsHistory.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double UsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+  const int64_t start = 1'760'000'000'000;
+  for (int hours : {1, 6, 24, 72}) {
+    MetricsHistory history(3);
+    int64_t samples = int64_t(hours) * 3600 * 10;
+    auto added = Clock::now();
+    for (int64_t i = 0; i < samples; ++i) {
+      double values[3] = {200 + 50 * std::sin(i / 3000.0), 4000, double(i % 977) / 10};
+      history.Add(start + i * 100, values);
+    }
+    double addUs = UsSince(added) / double(samples);
+    int64_t now = start + (samples - 1) * 100;
+    std::printf("session %2dh (%7lld samples, add %.3f us):", hours, static_cast<long long>(samples), addUs);
+    for (int64_t range : {int64_t(60'000), int64_t(600'000), int64_t(3'600'000), int64_t(hours) * 3'600'000}) {
+      const int reps = 200;
+      size_t points = 0;
+      auto queried = Clock::now();
+      for (int r = 0; r < reps; ++r) points += history.Query(2, now - range, now, 800).size();
+      std::printf("  %5llds: %6.1f us (%zu pts)", static_cast<long long>(range / 1000), UsSince(queried) / reps,
+                  points / reps);
+    }
+    std::printf("\n");
+  }
+
+  for (int hours : {1, 6, 24, 72}) {
+    int64_t samples = int64_t(hours) * 3600 * 10;
+    std::vector<MetricPoint> all;
+    for (int64_t i = 0; i < samples; ++i) {
+      double value = double(i % 977) / 10;
+      all.push_back({start + i * 100, value, value, value});
+    }
+    auto downsampled = Clock::now();
+    DownsampleLttb(all, 800);
+    std::printf("every sample %2dh: %.1f MB, downsampling the session %.1f us\n", hours,
+                all.size() * sizeof(MetricPoint) / 1e6, UsSince(downsampled));
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+//
+//  MetricsHistory.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRSystemInfo/MetricsHistory.h"
+
+#include <cmath>
+
+using namespace reactotron;
+
+namespace {
+
+constexpr int64_t kStart = 1'760'000'000'000;
+
+} // namespace
+
+TEST(RollsSamplesUpIntoCoarserBuckets) {
+  MetricsHistory history(3);
+  for (int i = 0; i < 100; ++i) {
+    double values[3] = {double(i), -double(i), 1};
+    history.Add(kStart + i * 100, values);
+  }
+  auto raw = history.Query(0, kStart, kStart + 9999, 1000);
+  CHECK_EQ(raw.size(), size_t(100));
+  if (raw.size() == 100) {
+    CHECK_EQ(raw[5].value, 5.0);
+    CHECK_EQ(raw[99].time, kStart + 9900);
+  }
+
+  // 100 raw samples are too many for 10 points, so it reads the 1 s level
+  auto seconds = history.Query(0, kStart, kStart + 9999, 10);
+  CHECK_EQ(seconds.size(), size_t(10));
+  for (size_t s = 0; s < seconds.size(); ++s) {
+    CHECK_EQ(seconds[s].time, kStart + int64_t(s) * 1000);
+    CHECK_EQ(seconds[s].min, double(s * 10));
+    CHECK_EQ(seconds[s].max, double(s * 10 + 9));
+    CHECK(std::fabs(seconds[s].value - (s * 10 + 4.5)) < 1e-9);
+  }
+  auto negative = history.Query(1, kStart, kStart + 9999, 10);
+  CHECK(negative.size() == 10 && negative[3].min == -39 && negative[3].max == -30);
+
+  auto part = history.Query(0, kStart + 2050, kStart + 2900, 100);
+  CHECK_EQ(part.size(), size_t(10));
+  if (!part.empty()) {
+    CHECK_EQ(part.front().time, kStart + 2000);
+    CHECK_EQ(part.back().time, kStart + 2900);
+  }
+  CHECK(history.Query(3, kStart, kStart + 1, 10).empty()); // No such metric
+  CHECK(history.Query(0, kStart + 5, kStart, 10).empty());
+  CHECK(MetricsHistory(1).Query(0, kStart, kStart + 1000, 10).empty());
+}
+
+TEST(DownsamplingKeepsSpikesEndpointsAndEnvelopes) {
+  std::vector<MetricPoint> series;
+  for (int i = 0; i < 1000; ++i) series.push_back({kStart + i * 100, 1, 1, 1});
+  series[537] = {kStart + 53700, 100, 100, 100};
+  series[811].max = 7;
+
+  auto points = DownsampleLttb(series, 50);
+  CHECK_EQ(points.size(), size_t(50));
+  CHECK_EQ(points.front().time, series.front().time);
+  CHECK_EQ(points.back().time, series.back().time);
+  bool spike = false;
+  bool envelope = false;
+  for (const auto &point : points) {
+    spike |= point.value == 100 && point.time == kStart + 53700;
+    envelope |= point.max == 7;
+  }
+  CHECK(spike);
+  CHECK(envelope);
+  for (size_t i = 1; i < points.size(); ++i) CHECK(points[i].time > points[i - 1].time);
+  CHECK_EQ(DownsampleLttb(series, 2).size(), size_t(2));
+  CHECK_EQ(DownsampleLttb(series, 2000).size(), size_t(1000));
+}
+
+TEST(LongSessionsFallBackToCoarserLevels) {
+  MetricsHistory history(1);
+  int64_t samples = 2 * 3600 * 10;
+  for (int64_t i = 0; i < samples; ++i) {
+    double value = double(i % 600);
+    history.Add(kStart + i * 100, &value);
+  }
+  int64_t now = kStart + (samples - 1) * 100;
+  auto minute = history.Query(0, now - 60'000, now, 2000);
+  CHECK(!minute.empty() && minute.back().time == now);
+  auto hour = history.Query(0, now - 3'600'000, now, 400);
+  CHECK(hour.size() >= 360 && hour.size() <= 400);
+  if (!hour.empty()) CHECK(hour.front().time <= now - 3'600'000 + 10'000);
+  // The raw ring has wrapped, but the 10 s one still covers the session
+  auto all = history.Query(0, kStart, now, 400);
+  CHECK(!all.empty() && all.front().time == kStart);
+  CHECK_EQ(history.ByteSize(), MetricsHistory(1).ByteSize());
+  CHECK(MetricsHistory(3).ByteSize() > history.ByteSize());
+}
@@ -0,0 +1,52 @@
+//
+//  NativeTest.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+
+#include <vector>
+
+namespace reactotron::test {
+
+namespace {
+
+struct Case {
+  const char *name;
+  TestFunction function;
+};
+
+std::vector<Case> &Cases() {
+  static std::vector<Case> cases;
+  return cases;
+}
+
+int s_failures = 0;
+
+} // namespace
+
+bool Register(const char *name, TestFunction function) {
+  Cases().push_back({name, function});
+  return true;
+}
+
+void Fail(const char *file, int line, const std::string &message) {
+  ++s_failures;
+  std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, message.c_str());
+}
+
+} // namespace reactotron::test
+
+int main() {
+  using namespace reactotron::test;
+  int failedCases = 0;
+  for (const auto &testCase : Cases()) {
+    int before = s_failures;
+    testCase.function();
+    bool passed = s_failures == before;
+    if (!passed) ++failedCases;
+    std::printf("%s %s\n", passed ? "ok  " : "FAIL", testCase.name);
+  }
+  std::printf("%zu cases, %d failed\n", Cases().size(), failedCases);
+  return failedCases == 0 ? 0 : 1;
+}
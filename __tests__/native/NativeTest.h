@@ -0,0 +1,61 @@
+#pragma once
+
+//
+//  NativeTest.h
+//  Reactotron
+//
+//  A minimal harness for the native core tests. TEST cases register themselves
+//  and the main() in NativeTest.cpp runs them in order. A failed CHECK reports
+//  the file and line and carries on with the rest of the case.
+//
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace reactotron::test {
+
+using TestFunction = void (*)();
+
+/** Adds a case to the list main() runs. Used by TEST. */
+bool Register(const char *name, TestFunction function);
+
+/** Records a failed check in the running case. */
+void Fail(const char *file, int line, const std::string &message);
+
+/** Prints small integer types as numbers rather than characters. */
+template <typename T>
+decltype(auto) Printable(const T &value) {
+  if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+    return static_cast<int>(value);
+  } else {
+    return (value);
+  }
+}
+
+template <typename A, typename B>
+void CheckEqual(const A &actual, const B &expected, const char *expression, const char *file, int line) {
+  if (actual == expected) return;
+  std::ostringstream message;
+  message << expression;
+  if constexpr (requires(std::ostream &stream) { stream << actual << expected; }) {
+    message << "\n    actual:   " << Printable(actual) << "\n    expected: " << Printable(expected);
+  }
+  Fail(file, line, message.str());
+}
+
+} // namespace reactotron::test
+
+#define TEST(name)                                                                        \
+  static void name();                                                                     \
+  static const bool name##Registered = ::reactotron::test::Register(#name, name);         \
+  static void name()
+
+#define CHECK(expression)                                                                 \
+  do {                                                                                    \
+    if (!(expression)) ::reactotron::test::Fail(__FILE__, __LINE__, #expression);         \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                                        \
+  ::reactotron::test::CheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
@@ -0,0 +1,56 @@
+//
+//  NetworkStats.bench.cpp
+//  Reactotron
+//
+//  Two million responses across a realistic mix of routes, then the five-minute
+//  snapshot the network panel polls.
+//
+
+#include "IRNetworkStats/NetworkStats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace reactotron;
+
+int main() {
+  const char *routes[] = {
+    "https://api.example.com/users/%d",
+    "https://api.example.com/users/%d/posts?page=%d",
+    "https://cdn.example.com/img/%d.png",
+    "https://api.example.com/orders/550e8400-e29b-41d4-a716-44665544%04d",
+    "https://api.example.com/search?q=%d",
+  };
+  std::mt19937_64 rng(3);
+  std::lognormal_distribution<double> latency(10, 1.5);
+  std::vector<std::string> urls;
+  char buffer[256];
+  for (int i = 0; i < 100000; ++i) {
+    std::snprintf(buffer, sizeof(buffer), routes[i % 5], static_cast<int>(rng() % 10000), i % 7);
+    urls.push_back(buffer);
+  }
+
+  constexpr int kResponses = 2'000'000;
+  int64_t start = 1'000'000;
+  NetworkStats stats;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < kResponses; ++i) {
+    stats.Record(i % 3 ? "GET" : "POST", urls[i % urls.size()], 200 + (i % 5 == 0) * 300, latency(rng) / 1000.0, 100,
+                 2000, start + i / 50);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  std::printf("record: %.2f M responses/s (%.0f ns each), %zu endpoints\n", kResponses / seconds / 1e6,
+              seconds / kResponses * 1e9, stats.EndpointCount());
+
+  std::vector<EndpointSnapshot> out;
+  t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < 100; ++k) {
+    out.clear();
+    stats.Snapshot(NetworkStatsWindow::FiveMinutes, start + kResponses / 50, out);
+  }
+  std::printf("snapshot 5m: %.1f us\n", std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / 100);
+  return 0;
+}
@@ -0,0 +1,104 @@
+//
+//  NetworkStats.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRNetworkStats/NetworkStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace reactotron;
+
+TEST(NormalizesRoutes) {
+  CHECK_EQ(NormalizeRoute("https://API.Example.com/users/42/posts?page=2#x"), "api.example.com/users/:id/posts");
+  CHECK_EQ(NormalizeRoute("/users/550e8400-e29b-41d4-a716-446655440000/"), "/users/:uuid");
+  CHECK_EQ(NormalizeRoute("http://u:p@host:8080/a/5f2b6c1e9d3a4b7c8e0f1a2b"), "host:8080/a/:hash");
+  CHECK_EQ(NormalizeRoute("http://host"), "host");
+  CHECK_EQ(NormalizeRoute("http://host/"), "host/");
+  CHECK_EQ(NormalizeRoute(""), "/");
+  CHECK_EQ(NormalizeRoute("/v1/items/abc"), "/v1/items/abc");
+  CHECK_EQ(NormalizeRoute("/img/123.png"), "/img/:id.png");
+  CHECK_EQ(NormalizeRoute("/img/v1.2"), "/img/v1.2");
+}
+
+TEST(BucketsContainTheirValues) {
+  for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456ull, 1ull << 34}) {
+    size_t index = LatencyHistogram::BucketIndex(value);
+    uint64_t lower = LatencyHistogram::BucketLowerBound(index);
+    CHECK(lower <= value);
+    CHECK(value < lower + LatencyHistogram::BucketWidth(index));
+  }
+}
+
+TEST(PercentilesAreWithinBucketPrecision) {
+  std::mt19937_64 rng(3);
+  std::lognormal_distribution<double> latency(10, 1.5);
+  LatencyHistogram histogram;
+  std::vector<uint64_t> values;
+  for (int i = 0; i < 100000; ++i) {
+    auto value = static_cast<uint64_t>(latency(rng));
+    histogram.Record(value);
+    values.push_back(value);
+  }
+  std::sort(values.begin(), values.end());
+  for (double percentile : {50.0, 90.0, 99.0, 99.9, 100.0}) {
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * values.size())) - 1;
+    double exact = static_cast<double>(values[std::min(values.size() - 1, rank)]);
+    double error = std::abs(static_cast<double>(histogram.ValueAtPercentile(percentile)) - exact) / exact;
+    CHECK(error <= 0.0625);
+  }
+}
+
+TEST(MergeMatchesRecordingTogether) {
+  std::mt19937_64 rng(5);
+  LatencyHistogram odd, even, all;
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t value = rng() % 100000;
+    (i % 2 ? odd : even).Record(value);
+    all.Record(value);
+  }
+  odd.Merge(even);
+  CHECK_EQ(odd.Count(), all.Count());
+  CHECK_EQ(odd.ValueAtPercentile(99), all.ValueAtPercentile(99));
+}
+
+TEST(SnapshotsRollingWindows) {
+  NetworkStats stats(4);
+  int64_t start = 1'000'000;
+  stats.Record("get", "http://h/a/1", 200, 10, 0, 100, start);
+  stats.Record("GET", "http://h/a/2", 500, 20, 0, 100, start + 30'000);
+  stats.Record("POST", "http://h/a/2", 201, 20, 10, 100, start + 5 * 60'000);
+
+  std::vector<EndpointSnapshot> out;
+  stats.Snapshot(NetworkStatsWindow::Session, start + 5 * 60'000, out);
+  CHECK_EQ(out.size(), 2u);
+  CHECK_EQ(out[0].method, "GET");
+  CHECK_EQ(out[0].route, "h/a/:id");
+  CHECK_EQ(out[0].stats.count, 2u);
+  CHECK_EQ(out[0].stats.errors, 1u);
+
+  out.clear();
+  stats.Snapshot(NetworkStatsWindow::Minute, start + 5 * 60'000, out);
+  CHECK_EQ(out.size(), 1u);
+  if (!out.empty()) CHECK_EQ(out[0].method, "POST");
+
+  out.clear();
+  stats.Snapshot(NetworkStatsWindow::FiveMinutes, start + 5 * 60'000, out);
+  CHECK_EQ(out.size(), 2u);
+  out.clear();
+  stats.Snapshot(NetworkStatsWindow::FiveMinutes, start + 4 * 60'000, out);
+  CHECK_EQ(out.size(), 1u);
+}
+
+TEST(CapsTheNumberOfEndpoints) {
+  NetworkStats stats(4);
+  for (int i = 0; i < 10; ++i) stats.Record("GET", "http://h/r" + std::to_string(i) + "x", 200, 1, 0, 0, 0);
+  CHECK_EQ(stats.EndpointCount(), 5u); // The cap, plus the overflow route
+
+  std::vector<EndpointSnapshot> out;
+  stats.Snapshot(NetworkStatsWindow::Session, 0, out);
+  CHECK(std::any_of(out.begin(), out.end(), [](const auto &endpoint) { return endpoint.route == NetworkStats::kOverflowRoute; }));
+}
@@ -0,0 +1,31 @@
+//
+//  PassthroughRegions.bench.cpp
+//  Reactotron
+//
+//  16 mounted instances all re-reporting their rect every frame, with one of
+//  them changing height every third frame.
+//
+
+#include "IRPassthroughView/PassthroughRegions.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace reactotron;
+
+int main() {
+  constexpr int kFrames = 100000;
+  PassthroughRegionTracker tracker;
+  std::vector<PassthroughRect> out;
+  int pushes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < kFrames; frame++) {
+    for (int i = 0; i < 16; i++) tracker.Update(i, {i * 40, 0, 40, 32 + (i == 0 && frame % 3 == 0)});
+    if (tracker.Flush(out)) pushes++;
+  }
+  auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+  std::printf("%d frames, %d pushes, %.2f us/frame\n", kFrames, pushes, elapsed.count() / kFrames);
+  return 0;
+}
@@ -0,0 +1,70 @@
+//
+//  PassthroughRegions.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRPassthroughView/PassthroughRegions.h"
+
+using namespace reactotron;
+
+TEST(MergesRectsWhoseUnionIsARectangle) {
+  PassthroughRect merged;
+  CHECK(TryMergeRects({0, 0, 10, 10}, {10, 0, 5, 10}, merged));
+  CHECK_EQ(merged, PassthroughRect({0, 0, 15, 10}));
+  CHECK(TryMergeRects({0, 0, 10, 10}, {0, 5, 10, 10}, merged));
+  CHECK_EQ(merged, PassthroughRect({0, 0, 10, 15}));
+  CHECK(TryMergeRects({0, 0, 10, 10}, {2, 2, 3, 3}, merged));
+  CHECK_EQ(merged, PassthroughRect({0, 0, 10, 10}));
+}
+
+TEST(DoesNotMergeAcrossGapsOrOffsets) {
+  PassthroughRect merged;
+  CHECK(!TryMergeRects({0, 0, 10, 10}, {11, 0, 5, 10}, merged));
+  CHECK(!TryMergeRects({0, 0, 10, 10}, {5, 5, 10, 10}, merged));
+}
+
+TEST(CoalescesToCanonicalOrder) {
+  auto rects = CoalesceRects({{20, 0, 5, 5}, {0, 0, 10, 10}, {10, 0, 10, 10}, {0, 0, 0, 5}, {3, 3, 1, 1}});
+  CHECK_EQ(rects.size(), 2u);
+  CHECK_EQ(rects[0], PassthroughRect({0, 0, 20, 10}));
+  CHECK_EQ(rects[1], PassthroughRect({20, 0, 5, 5}));
+}
+
+TEST(TrackerOnlyFlushesChanges) {
+  PassthroughRegionTracker tracker;
+  std::vector<PassthroughRect> out;
+
+  CHECK(tracker.Update(1, {0, 0, 10, 10}));
+  CHECK(!tracker.Update(2, {10, 0, 10, 10})); // Already pending
+  CHECK(tracker.Flush(out));
+  CHECK_EQ(out.size(), 1u);
+
+  CHECK(!tracker.Update(1, {0, 0, 10, 10})); // Unchanged
+  CHECK(tracker.Update(2, {10, 0, 10, 11}));
+  CHECK(tracker.Flush(out));
+  CHECK_EQ(out.size(), 2u);
+
+  // Covered by an existing rect, so the merged set is the same
+  CHECK(tracker.Update(3, {1, 1, 2, 2}));
+  CHECK(!tracker.Flush(out));
+  CHECK(tracker.Remove(3));
+  CHECK(!tracker.Flush(out));
+}
+
+TEST(ForgetLastPushedForcesTheNextFlush) {
+  PassthroughRegionTracker tracker;
+  std::vector<PassthroughRect> out;
+  tracker.Update(1, {0, 0, 10, 10});
+  CHECK(tracker.Flush(out));
+
+  tracker.ForgetLastPushed();
+  CHECK(tracker.Invalidate());
+  CHECK(tracker.Flush(out));
+  CHECK_EQ(out.size(), 1u);
+
+  CHECK(tracker.Remove(1));
+  CHECK(tracker.Flush(out));
+  CHECK(out.empty());
+  CHECK_EQ(tracker.InstanceCount(), 0u);
+}
@@ -0,0 +1,74 @@
+//
+//  PayloadArena.bench.cpp
+//  Reactotron
+//
+//  Stores, materializes and searches 200k generated log, API and state action
+//  payloads, the mix a busy app sends.
+//
+
+#include "IRPayloadArena/PayloadArena.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double UsPer(Clock::time_point start, size_t count) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / count;
+}
+
+} // namespace
+
+int main() {
+  const char *words[] = {"fetch", "user", "cart", "render", "retry", "timeout", "loaded", "screen"};
+  std::mt19937 rng(36);
+  auto word = [&] { return std::string(words[rng() % 8]); };
+  auto number = [&](unsigned below) { return std::to_string(rng() % below); };
+
+  std::vector<std::string> payloads;
+  size_t jsonBytes = 0;
+  for (int i = 0; i < 200000; i++) {
+    switch (i % 3) {
+      case 0:
+        payloads.push_back("{\"level\":\"debug\",\"message\":\"" + word() + " " + word() + " " + number(100) + "\"}");
+        break;
+      case 1:
+        payloads.push_back("{\"duration\":" + number(900) + ",\"request\":{\"url\":\"https://api.example.com/" + word() +
+                           "/" + number(10000) + "\",\"method\":\"GET\",\"headers\":{\"Accept\":\"application/json\"}},"
+                           "\"response\":{\"status\":200,\"headers\":{\"content-type\":\"application/json\"},\"body\":{\"id\":" +
+                           number(100000) + ",\"name\":\"" + word() + "\"}}}");
+        break;
+      default:
+        payloads.push_back("{\"name\":\"" + word() + "/" + word() + "\",\"action\":{\"type\":\"" + word() +
+                           "\",\"payload\":{\"id\":" + number(1000) + "}},\"ms\":" + number(30) + "}");
+        break;
+    }
+    jsonBytes += payloads.back().size();
+  }
+
+  PayloadArena arena;
+  std::vector<uint32_t> handles;
+  auto start = Clock::now();
+  for (const auto &payload : payloads) handles.push_back(arena.Store(payload));
+  double storeUs = UsPer(start, payloads.size());
+  auto stats = arena.Stats();
+  std::printf("%zu payloads, %.1f MB JSON -> %.1f MB encoded, %.1f MB allocated (%zu strings, %zu shapes); store %.2f us\n",
+              stats.payloads, jsonBytes / 1e6, stats.payloadBytes / 1e6, stats.allocatedBytes / 1e6, stats.strings,
+              stats.shapes, storeUs);
+
+  std::string out;
+  start = Clock::now();
+  for (auto handle : handles) arena.Materialize(handle, out);
+  std::printf("materialize %.2f us\n", UsPer(start, handles.size()));
+
+  size_t hits = 0;
+  start = Clock::now();
+  for (auto handle : handles) hits += arena.Contains(handle, "cart 12");
+  std::printf("contains %.2f us (%zu hits)\n", UsPer(start, handles.size()), hits);
+  return 0;
+}
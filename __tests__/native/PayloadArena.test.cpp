@@ -0,0 +1,121 @@
+//
+//  PayloadArena.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRPayloadArena/PayloadArena.h"
+#include "IRRelaySocket/IngestPipeline.h"
+
+using namespace reactotron;
+
+namespace {
+
+std::string RoundTrip(PayloadArena &arena, std::string_view json) {
+  std::string out;
+  uint32_t handle = arena.Store(json);
+  if (!handle || !arena.Materialize(handle, out)) return "<rejected>";
+  return out;
+}
+
+/** The shared arena's JSON for `handle`, as the timeline would read it. */
+std::string SharedPayload(uint32_t handle) {
+  auto &shared = SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  std::string out;
+  return shared.arena.Materialize(handle, out) ? out : "<none>";
+}
+
+std::string Command(const std::string &type, const std::string &payload) {
+  return "{\"type\":\"command\",\"cmd\":{\"type\":\"" + type + "\",\"payload\":" + payload + ",\"clientId\":\"c\"}}";
+}
+
+} // namespace
+
+TEST(CompactJsonRoundTripsExactly) {
+  PayloadArena arena;
+  for (const char *json : {"{}", "[]", "0", "-0", "-12", "1.5e3", "\"a\\\"b\"", "[1,[2,[3]],{\"x\":{}}]", "null",
+                           "{\"a\":1,\"a\":2}", "123456789012345", "1234567890123456", "-9"}) {
+    CHECK_EQ(RoundTrip(arena, json), json);
+  }
+}
+
+TEST(RejectsMalformedOrTooDeepJson) {
+  PayloadArena arena;
+  for (const char *json : {"", "{", "[1,]x", "{\"a\"}", "tru", "\"abc", "{\"a\":1}}"}) CHECK_EQ(arena.Store(json), 0u);
+  std::string deep = std::string(PayloadArena::kMaxDepth + 44, '[') + std::string(PayloadArena::kMaxDepth + 44, ']');
+  CHECK_EQ(arena.Store(deep), 0u);
+}
+
+TEST(ContainsSearchesValuesIgnoringCase) {
+  PayloadArena arena;
+  uint32_t handle = arena.Store("{\"Level\":\"ERROR\",\"n\":[404,true],\"k\":\"Mixed Case\"}");
+  CHECK(arena.Contains(handle, "error"));
+  CHECK(arena.Contains(handle, "404"));
+  CHECK(arena.Contains(handle, "rue"));
+  CHECK(arena.Contains(handle, "d ca"));
+  CHECK(!arena.Contains(handle, "level")); // Keys aren't searched
+  CHECK(!arena.Contains(handle, "zz"));
+  CHECK(!arena.Contains(99999, "e"));
+}
+
+TEST(HandlesAreNeverReused) {
+  PayloadArena arena;
+  std::string out;
+  uint32_t first = arena.Store("{\"a\":1}");
+  arena.Release(first);
+  CHECK(!arena.Materialize(first, out));
+  uint32_t second = arena.Store("{\"a\":1}");
+  CHECK(second != first);
+
+  arena.Clear();
+  CHECK(!arena.Materialize(second, out));
+  CHECK(arena.Store("{}") > second);
+}
+
+TEST(InternsKeysShapesAndReleasesEverything) {
+  PayloadArena arena;
+  std::vector<uint32_t> handles;
+  for (int i = 0; i < 1000; i++) {
+    handles.push_back(arena.Store("{\"level\":\"debug\",\"message\":\"item " + std::to_string(i) + "\",\"n\":" +
+                                  std::to_string(i) + "}"));
+  }
+  auto stats = arena.Stats();
+  CHECK_EQ(stats.payloads, 1000u);
+  CHECK_EQ(stats.shapes, 1u);
+  CHECK(stats.strings < 10u); // Keys and "debug"; the messages are unique
+
+  for (auto handle : handles) arena.Release(handle);
+  stats = arena.Stats();
+  CHECK_EQ(stats.payloads, 0u);
+  CHECK_EQ(stats.payloadBytes, 0u);
+}
+
+TEST(IngestStoresPayloadsInTheSharedArena) {
+  std::string body(20000, 'x');
+  std::vector<std::string> messages = {
+    Command("log", R"({"level":"debug","message":"hi","__proto__":{"a":1}})"),
+    Command("state.values.change", R"({"changes":[]})"),
+    R"({"type":"connectionEstablished","conn":{"clientId":"c"}})",
+    Command("api.response", "{\"request\":{\"url\":\"u\",\"data\":\"" + body + "\"},\"response\":{\"status\":200}}"),
+    R"({"type":"command","cmd":{"type":"display","clientId":"c"}})",
+    R"({"type":"command","cmd":{"type":"benchmark.report","payload" : { "title" : "t" , "steps":[1, 2]},"clientId":"c"}})",
+  };
+  std::vector<IngestedItem> items;
+  IngestPipeline::Ingest(messages, items);
+  CHECK_EQ(items.size(), 6u);
+  if (items.size() != 6) return;
+
+  // Prototype keys are dropped, as JSON.parse into an object would
+  CHECK_EQ(SharedPayload(items[0].payloadHandle), R"({"level":"debug","message":"hi"})");
+  // State and connection messages, and commands without a payload, stay in JS
+  CHECK_EQ(items[1].payloadHandle, 0u);
+  CHECK_EQ(items[2].payloadHandle, 0u);
+  CHECK_EQ(items[4].payloadHandle, 0u);
+  // Large bodies go to the body store and leave a reference behind
+  std::string api = SharedPayload(items[3].payloadHandle);
+  CHECK(api.find("$body") != std::string::npos);
+  CHECK(api.find("xxxx") == std::string::npos);
+  // Whitespace is compacted
+  CHECK_EQ(SharedPayload(items[5].payloadHandle), R"({"title":"t","steps":[1,2]})");
+}
@@ -0,0 +1,98 @@
+//
+//  RecordBatch.bench.cpp
+//  Reactotron
+//
+//  10000 log records as a batch, against what the module did before: a
+//  dictionary per record, or a JSON string for JS to parse.
+//
+
+#include "IRBulkChannel/RecordBatch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+using Dictionary = std::unordered_map<std::string, std::variant<double, std::string>>;
+
+} // namespace
+
+int main() {
+  const int count = 10000;
+  const int rounds = 50;
+  std::vector<std::string> messages, tasks;
+  for (int i = 0; i < count; ++i) {
+    messages.push_back("GET /api/items/" + std::to_string(i) + "?page=2 completed in " + std::to_string(i % 97) +
+                       " ms");
+    tasks.push_back("task-" + std::to_string(i % 16));
+  }
+
+  RecordLayout layout = RecordLayout::Make("time: f64, id: u32, level: u8, task: string, message: string");
+  RecordBatchWriter writer(layout, count);
+  std::shared_ptr<RecordBatch> batch;
+  double best = 1e9;
+  for (int round = 0; round < rounds; ++round) {
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+      auto record = writer.Append();
+      record.Set(0, 1.7e12 + i);
+      record.Set(1, i);
+      record.Set(2, i % 4);
+      record.Set(3, tasks[i]);
+      record.Set(4, messages[i]);
+    }
+    batch = writer.Finish();
+    best = std::min(best, MsSince(start));
+  }
+  std::printf("batch:        %.3f ms (%zu bytes)\n", best, batch->Size());
+
+  best = 1e9;
+  size_t made = 0;
+  for (int round = 0; round < rounds; ++round) {
+    auto start = Clock::now();
+    std::vector<Dictionary> dictionaries;
+    dictionaries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      Dictionary record;
+      record["time"] = 1.7e12 + i;
+      record["id"] = static_cast<double>(i);
+      record["level"] = static_cast<double>(i % 4);
+      record["task"] = tasks[i];
+      record["message"] = messages[i];
+      dictionaries.push_back(std::move(record));
+    }
+    made += dictionaries.size();
+    best = std::min(best, MsSince(start));
+  }
+  std::printf("dictionaries: %.3f ms\n", best);
+
+  best = 1e9;
+  std::string json;
+  for (int round = 0; round < rounds; ++round) {
+    auto start = Clock::now();
+    json.clear();
+    json += '[';
+    for (int i = 0; i < count; ++i) {
+      char numbers[96];
+      std::snprintf(numbers, sizeof(numbers), "%s{\"time\":%.17g,\"id\":%d,\"level\":%d,", i ? "," : "", 1.7e12 + i,
+                    i, i % 4);
+      json += numbers;
+      json += "\"task\":\"" + tasks[i] + "\",\"message\":\"" + messages[i] + "\"}";
+    }
+    json += ']';
+    best = std::min(best, MsSince(start));
+  }
+  std::printf("JSON:         %.3f ms (%zu bytes)\n", best, json.size());
+  return made == 0;
+}
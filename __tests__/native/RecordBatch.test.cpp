@@ -0,0 +1,180 @@
+//
+//  RecordBatch.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRBulkChannel/RecordBatch.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+using namespace reactotron;
+
+namespace {
+
+template <typename T>
+T Read(const RecordBatch &batch, size_t offset) {
+  T value;
+  std::memcpy(&value, batch.Data() + offset, sizeof(value));
+  return value;
+}
+
+/** The string in field `offset` of the record at `record`. */
+std::string ReadString(const RecordBatch &batch, size_t record, size_t offset) {
+  uint32_t heap = Read<uint32_t>(batch, 24);
+  uint32_t at = Read<uint32_t>(batch, record + offset);
+  uint32_t length = Read<uint32_t>(batch, record + offset + 4);
+  return std::string(reinterpret_cast<const char *>(batch.Data()) + heap + at, length);
+}
+
+} // namespace
+
+TEST(LaysOutFieldsAlignedInOrder) {
+  RecordLayout layout;
+  std::string error;
+  CHECK(RecordLayout::Parse(" id: u32, time:f64; level: u8, ok: bool\n message : string, delta: i16,", layout, error));
+  CHECK_EQ(layout.Fields().size(), size_t(6));
+  uint32_t offsets[] = {0, 8, 16, 17, 20, 28};
+  for (size_t i = 0; i < 6 && i < layout.Fields().size(); ++i) CHECK_EQ(layout.Fields()[i].offset, offsets[i]);
+  CHECK_EQ(layout.RecordSize(), uint32_t(32));
+  CHECK_EQ(layout.Schema(), std::string("id: u32, time: f64, level: u8, ok: bool, message: string, delta: i16"));
+  CHECK_EQ(layout.FieldIndex("message"), size_t(4));
+  CHECK_EQ(layout.FieldIndex("missing"), RecordLayout::kNoField);
+
+  RecordLayout small;
+  CHECK(RecordLayout::Parse("a: u8, b: u16, c: u8", small, error));
+  CHECK_EQ(small.RecordSize(), uint32_t(6));
+  RecordLayout strings;
+  CHECK(RecordLayout::Parse("s: string, b: bool", strings, error));
+  CHECK_EQ(strings.RecordSize(), uint32_t(12));
+
+  // The hash follows the normalized schema
+  CHECK_EQ(RecordLayout::Make("a:u8,b:u16").Hash(), RecordLayout::Make("a: u8; b: u16").Hash());
+  CHECK(RecordLayout::Make("a: u8, b: u16").Hash() != RecordLayout::Make("b: u16, a: u8").Hash());
+  CHECK(RecordLayout::Make("a: u8").Hash() != RecordLayout::Make("a: i8").Hash());
+}
+
+TEST(RejectsMalformedSchemas) {
+  for (const char *schema : {"", "  ,, ", "id u32", "1id: u32", "id: u64", "id: u32, id: f64", "i-d: u8"}) {
+    RecordLayout layout;
+    std::string error;
+    CHECK(!RecordLayout::Parse(schema, layout, error));
+    CHECK(!error.empty());
+  }
+  RecordLayout made = RecordLayout::Make("nope");
+  CHECK(made.Fields().empty());
+  CHECK_EQ(made.RecordSize(), uint32_t(0));
+}
+
+TEST(NamesEveryFieldType) {
+  for (RecordFieldType type : {RecordFieldType::Bool, RecordFieldType::U8, RecordFieldType::I8, RecordFieldType::U16,
+                               RecordFieldType::I16, RecordFieldType::U32, RecordFieldType::I32, RecordFieldType::F32,
+                               RecordFieldType::F64, RecordFieldType::String}) {
+    RecordFieldType parsed = RecordFieldType::Bool;
+    CHECK(ParseRecordFieldType(RecordFieldTypeName(type), parsed));
+    CHECK(parsed == type);
+    CHECK(RecordFieldSize(type) > 0);
+  }
+  RecordFieldType parsed;
+  CHECK(!ParseRecordFieldType("u64", parsed));
+}
+
+TEST(WritesRecordsAndTheHeader) {
+  RecordLayout layout = RecordLayout::Make("id: u32, time: f64, level: u8, ok: bool, message: string, delta: i16");
+  RecordBatchWriter writer(layout, 4);
+  for (int i = 0; i < 3; ++i) {
+    auto record = writer.Append();
+    record.Set(0, i + 1);
+    record.Set(1, 1000.5 * i);
+    record.Set(2, 300 + i);
+    record.Set(3, i == 1);
+    record.Set(4, i == 2 ? std::string("h\xC3\xA9llo \xE2\x9C\x93") : "msg" + std::to_string(i));
+    record.Set(5, -2 - i);
+  }
+  CHECK_EQ(writer.Count(), size_t(3));
+  auto batch = writer.Finish();
+  CHECK_EQ(writer.Count(), size_t(0));
+  CHECK_EQ(writer.ByteSize(), size_t(kRecordBatchHeaderSize));
+
+  CHECK_EQ(Read<uint32_t>(*batch, 0), kRecordBatchMagic);
+  CHECK_EQ(Read<uint16_t>(*batch, 4), kRecordBatchVersion);
+  CHECK_EQ(Read<uint16_t>(*batch, 6), uint16_t(kRecordBatchHeaderSize));
+  CHECK_EQ(batch->LayoutHash(), layout.Hash());
+  CHECK_EQ(Read<uint32_t>(*batch, 12), uint32_t(32));
+  CHECK_EQ(batch->Count(), uint32_t(3));
+  CHECK_EQ(Read<uint32_t>(*batch, 20), kRecordBatchHeaderSize);
+  CHECK_EQ(Read<uint32_t>(*batch, 24), kRecordBatchHeaderSize + 3 * 32);
+  CHECK_EQ(batch->Size(), size_t(Read<uint32_t>(*batch, 24) + Read<uint32_t>(*batch, 28)));
+
+  size_t records = kRecordBatchHeaderSize;
+  CHECK_EQ(Read<uint32_t>(*batch, records), uint32_t(1));
+  CHECK_EQ(Read<double>(*batch, records + 32 + 8), 1000.5);
+  CHECK_EQ(Read<uint8_t>(*batch, records + 16), uint8_t(44)); // 300 wraps
+  CHECK_EQ(Read<uint8_t>(*batch, records + 17), uint8_t(0));
+  CHECK_EQ(Read<uint8_t>(*batch, records + 32 + 17), uint8_t(1));
+  CHECK_EQ(Read<int16_t>(*batch, records + 28), int16_t(-2));
+  CHECK_EQ(ReadString(*batch, records, 20), std::string("msg0"));
+  CHECK_EQ(ReadString(*batch, records + 64, 20), std::string("h\xC3\xA9llo \xE2\x9C\x93"));
+}
+
+TEST(ConvertsNumbersLikeTypedArrays) {
+  RecordLayout layout = RecordLayout::Make("f: f32, u: u32, i: i32, s: i16, b: bool, c: u8, text: string");
+  RecordBatchWriter writer(layout);
+  auto record = writer.Append();
+  record.Set(0, 0.1);
+  record.Set(1, -1);
+  record.Set(2, 4294967297.0);
+  record.Set(3, 1e30);
+  record.Set(4, std::nan(""));
+  record.Set(5, -1.9);
+  auto batch = writer.Finish();
+  size_t at = kRecordBatchHeaderSize;
+  CHECK_EQ(Read<float>(*batch, at), 0.1f);
+  CHECK_EQ(Read<uint32_t>(*batch, at + 4), 0xFFFFFFFFu);
+  CHECK_EQ(Read<int32_t>(*batch, at + 8), 1);
+  CHECK_EQ(Read<int16_t>(*batch, at + 12), int16_t(0)); // 1e30 is a multiple of 2^16
+  CHECK_EQ(Read<uint8_t>(*batch, at + 14), uint8_t(0));
+  CHECK_EQ(Read<uint8_t>(*batch, at + 15), uint8_t(255));
+}
+
+TEST(IgnoresSetsThatDontFit) {
+  RecordLayout layout = RecordLayout::Make("id: u32, text: string");
+  RecordBatchWriter writer(layout);
+  auto record = writer.Append();
+  record.Set(0, "not a number");
+  record.Set(1, 5);
+  record.Set(99, 5);
+  record.Set(99, "nowhere");
+  record.Set(1, static_cast<const char *>(nullptr));
+  auto batch = writer.Finish();
+  CHECK_EQ(batch->Count(), uint32_t(1));
+  CHECK_EQ(Read<uint32_t>(*batch, kRecordBatchHeaderSize), uint32_t(0));
+  CHECK_EQ(ReadString(*batch, kRecordBatchHeaderSize, 4), std::string());
+  CHECK_EQ(Read<uint32_t>(*batch, 28), uint32_t(0));
+
+  // Too short for a header
+  RecordBatch bare(std::vector<uint8_t>(8));
+  CHECK_EQ(bare.Count(), uint32_t(0));
+  CHECK_EQ(bare.LayoutHash(), uint32_t(0));
+}
+
+TEST(StartsOverAfterFinishing) {
+  RecordLayout layout = RecordLayout::Make("id: u32, text: string");
+  RecordBatchWriter writer(layout);
+  writer.Append().Set(1, "first");
+  auto first = writer.Finish();
+  writer.Append().Set(1, "second");
+  writer.Append().Set(0, 7);
+  auto second = writer.Finish();
+  CHECK_EQ(first->Count(), uint32_t(1));
+  CHECK_EQ(second->Count(), uint32_t(2));
+  CHECK_EQ(ReadString(*second, kRecordBatchHeaderSize, 4), std::string("second"));
+  CHECK_EQ(Read<uint32_t>(*second, kRecordBatchHeaderSize + 12), uint32_t(7));
+  CHECK_EQ(Read<uint32_t>(*second, 28), uint32_t(6));
+
+  auto empty = writer.Finish();
+  CHECK_EQ(empty->Count(), uint32_t(0));
+  CHECK_EQ(empty->Size(), size_t(kRecordBatchHeaderSize));
+}
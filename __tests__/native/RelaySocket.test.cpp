@@ -0,0 +1,318 @@
+//
+//  RelaySocket.test.cpp
+//  Reactotron
+//
+//  Runs the socket against a one-connection WebSocket server on the loopback
+//  interface, driven by the test.
+//
+
+#include "NativeTest.h"
+#include "IRRelaySocket/RelaySocket.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace reactotron;
+using namespace std::chrono_literals;
+
+namespace {
+
+/** Takes batches until `done` says so or two seconds pass, merging them. */
+template <typename Done>
+RelayBatch TakeUntil(RelaySocket &socket, Done done) {
+  RelayBatch merged;
+  auto deadline = std::chrono::steady_clock::now() + 2s;
+  while (!done(merged) && std::chrono::steady_clock::now() < deadline) {
+    RelayBatch batch = socket.TakeBatch();
+    merged.opened |= batch.opened;
+    merged.closed |= batch.closed;
+    if (!batch.error.empty()) merged.error = batch.error;
+    for (auto &message : batch.messages) merged.messages.push_back(std::move(message));
+    std::this_thread::sleep_for(5ms);
+  }
+  return merged;
+}
+
+} // namespace
+
+TEST(UnusableUrlsFailLikeARefusedConnection) {
+  for (const char *url : {"http://localhost", "ws://", "ws://localhost:99999", "ws://localhost:0"}) {
+    RelaySocket socket(nullptr);
+    socket.Connect(url);
+    RelayBatch batch = TakeUntil(socket, [](const RelayBatch &b) { return b.closed; });
+    CHECK(batch.closed);
+    CHECK(!batch.opened);
+    CHECK(!batch.error.empty());
+  }
+}
+
+#if !defined(_WIN32)
+
+namespace {
+
+uint32_t Rotate(uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+
+std::string Sha1(const std::string &data) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string message = data + '\x80';
+  while (message.size() % 64 != 56) message += '\0';
+  uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+  for (int i = 7; i >= 0; --i) message += static_cast<char>(bits >> (i * 8));
+  for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      const auto *p = reinterpret_cast<const uint8_t *>(message.data() + chunk + i * 4);
+      w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+    for (int i = 16; i < 80; ++i) w[i] = Rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f = i < 20 ? (b & c) | (~b & d) : i < 40 ? b ^ c ^ d : i < 60 ? (b & c) | (b & d) | (c & d) : b ^ c ^ d;
+      uint32_t k = i < 20 ? 0x5A827999 : i < 40 ? 0x6ED9EBA1 : i < 60 ? 0x8F1BBCDC : 0xCA62C1D6;
+      uint32_t t = Rotate(a, 5) + f + e + k + w[i];
+      e = d, d = c, c = Rotate(b, 30), b = a, a = t;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e;
+  }
+  std::string digest;
+  for (uint32_t word : h) {
+    for (int i = 3; i >= 0; --i) digest += static_cast<char>(word >> (i * 8));
+  }
+  return digest;
+}
+
+std::string Base64(const std::string &data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t n = uint32_t(uint8_t(data[i])) << 16;
+    if (i + 1 < data.size()) n |= uint32_t(uint8_t(data[i + 1])) << 8;
+    if (i + 2 < data.size()) n |= uint8_t(data[i + 2]);
+    out += kAlphabet[(n >> 18) & 63];
+    out += kAlphabet[(n >> 12) & 63];
+    out += i + 1 < data.size() ? kAlphabet[(n >> 6) & 63] : '=';
+    out += i + 2 < data.size() ? kAlphabet[n & 63] : '=';
+  }
+  return out;
+}
+
+/** Accepts one connection, answers the handshake, and sends and reads frames. */
+class TestServer {
+ public:
+  TestServer() {
+    m_listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(m_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    listen(m_listener, 1);
+    socklen_t length = sizeof(address);
+    getsockname(m_listener, reinterpret_cast<sockaddr *>(&address), &length);
+    m_port = ntohs(address.sin_port);
+  }
+  ~TestServer() {
+    if (m_client >= 0) close(m_client);
+    close(m_listener);
+  }
+
+  std::string Url() const { return "ws://127.0.0.1:" + std::to_string(m_port) + "/"; }
+
+  /** Accepts the connection and answers with `acceptKey`, or the right key if empty. */
+  bool Accept(const std::string &acceptKey = "") {
+    m_client = accept(m_listener, nullptr, nullptr);
+    if (m_client < 0) return false;
+    size_t end;
+    while ((end = m_buffer.find("\r\n\r\n")) == std::string::npos) {
+      if (!Receive()) return false;
+    }
+    std::string head = m_buffer.substr(0, end);
+    m_buffer.erase(0, end + 4);
+    size_t key = head.find("Sec-WebSocket-Key: ");
+    if (key == std::string::npos) return false;
+    key += std::strlen("Sec-WebSocket-Key: ");
+    std::string nonce = head.substr(key, head.find("\r\n", key) - key);
+    std::string accept =
+        acceptKey.empty() ? Base64(Sha1(nonce + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11")) : acceptKey;
+    return Write("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                 "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+  }
+
+  bool SendFrame(uint8_t opcode, const std::string &payload, bool fin = true) {
+    std::string frame(1, static_cast<char>((fin ? 0x80 : 0) | opcode));
+    if (payload.size() < 126) {
+      frame += static_cast<char>(payload.size());
+    } else if (payload.size() < 65536) {
+      frame += static_cast<char>(126);
+      frame += static_cast<char>(payload.size() >> 8);
+      frame += static_cast<char>(payload.size());
+    } else {
+      frame += static_cast<char>(127);
+      for (int i = 7; i >= 0; --i) frame += static_cast<char>(uint64_t(payload.size()) >> (i * 8));
+    }
+    return Write(frame + payload);
+  }
+
+  /** Reads one client frame, which must be masked. */
+  bool ReadFrame(uint8_t &opcode, std::string &payload) {
+    while (m_buffer.size() < 2) {
+      if (!Receive()) return false;
+    }
+    auto byte = [&](size_t i) { return static_cast<uint8_t>(m_buffer[i]); };
+    opcode = byte(0) & 0x0F;
+    if (!(byte(1) & 0x80)) return false;
+    uint64_t length = byte(1) & 0x7F;
+    size_t header = 2;
+    size_t extra = length == 126 ? 2 : length == 127 ? 8 : 0;
+    while (m_buffer.size() < header + extra + 4) {
+      if (!Receive()) return false;
+    }
+    if (extra) {
+      length = 0;
+      for (size_t i = 0; i < extra; ++i) length = (length << 8) | byte(2 + i);
+      header += extra;
+    }
+    while (m_buffer.size() < header + 4 + length) {
+      if (!Receive()) return false;
+    }
+    payload = m_buffer.substr(header + 4, length);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] ^= m_buffer[header + (i & 3)];
+    m_buffer.erase(0, header + 4 + length);
+    return true;
+  }
+
+  void Disconnect() {
+    close(m_client);
+    m_client = -1;
+  }
+
+ private:
+  bool Receive() {
+    char chunk[65536];
+    ssize_t read = recv(m_client, chunk, sizeof(chunk), 0);
+    if (read <= 0) return false;
+    m_buffer.append(chunk, static_cast<size_t>(read));
+    return true;
+  }
+
+  bool Write(const std::string &data) {
+    return send(m_client, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+  }
+
+  int m_listener = -1;
+  int m_client = -1;
+  uint16_t m_port = 0;
+  std::string m_buffer;
+};
+
+} // namespace
+
+TEST(RefusedConnectionsCloseWithTheReason) {
+  uint16_t port;
+  {
+    TestServer server;
+    port = static_cast<uint16_t>(std::stoi(server.Url().substr(15)));
+  }
+  RelaySocket socket(nullptr);
+  socket.Connect("ws://127.0.0.1:" + std::to_string(port));
+  RelayBatch batch = TakeUntil(socket, [](const RelayBatch &b) { return b.closed; });
+  CHECK(batch.closed && !batch.opened && !batch.error.empty());
+}
+
+TEST(RejectsAWrongHandshakeAnswer) {
+  TestServer server;
+  RelaySocket socket(nullptr);
+  socket.Connect(server.Url());
+  CHECK(server.Accept("bm90IHRoZSByaWdodCBrZXk="));
+  RelayBatch batch = TakeUntil(socket, [](const RelayBatch &b) { return b.closed; });
+  CHECK(batch.closed && !batch.opened);
+  CHECK_EQ(batch.error, "Server answered the handshake incorrectly");
+}
+
+TEST(ReceivesMessagesInOrderAndSendsMaskedFrames) {
+  TestServer server;
+  std::atomic<int> pending{0};
+  RelaySocket socket([&] { pending++; });
+  socket.Connect(server.Url());
+  CHECK(server.Accept());
+  RelayBatch batch = TakeUntil(socket, [](const RelayBatch &b) { return b.opened; });
+  CHECK(batch.opened);
+
+  // A large message, one in three fragments with a ping between, then a run of small ones
+  std::string large = "{\"type\":\"log\",\"payload\":{\"message\":\"" + std::string(100000, 'x') + "\"}}";
+  CHECK(server.SendFrame(1, large));
+  CHECK(server.SendFrame(1, "{\"a\"", false));
+  CHECK(server.SendFrame(9, "ping"));
+  CHECK(server.SendFrame(0, ":", false));
+  CHECK(server.SendFrame(0, "1}"));
+  for (int i = 0; i < 500; ++i) CHECK(server.SendFrame(1, "{\"n\":" + std::to_string(i) + "}"));
+  // Not JSON, so dropped
+  CHECK(server.SendFrame(1, "not json"));
+  CHECK(server.SendFrame(1, "{\"type\":\"done\"}"));
+
+  uint8_t opcode;
+  std::string payload;
+  CHECK(server.ReadFrame(opcode, payload));
+  CHECK_EQ(int(opcode), 10);
+  CHECK_EQ(payload, "ping");
+
+  batch = TakeUntil(socket, [](const RelayBatch &b) {
+    return !b.messages.empty() && b.messages.back() == "{\"type\":\"done\"}";
+  });
+  CHECK_EQ(batch.messages.size(), size_t(503));
+  if (batch.messages.size() == 503) {
+    CHECK_EQ(batch.messages[0].size(), large.size());
+    CHECK_EQ(batch.messages[1], "{\"a\":1}");
+    for (int i = 0; i < 500; ++i) CHECK_EQ(batch.messages[2 + i], "{\"n\":" + std::to_string(i) + "}");
+  }
+  CHECK(pending.load() >= 1);
+  CHECK_EQ(socket.Stats().messages, uint64_t(503));
+
+  std::string text = "{\"type\":\"state.values.subscribe\",\"payload\":\"" + std::string(70000, 's') + "\"}";
+  CHECK(socket.Send(text));
+  CHECK(server.ReadFrame(opcode, payload));
+  CHECK_EQ(int(opcode), 1);
+  CHECK(payload == text);
+
+  // A clean close from the server
+  CHECK(server.SendFrame(8, std::string("\x03\xE8", 2)));
+  batch = TakeUntil(socket, [](const RelayBatch &b) { return b.closed; });
+  CHECK(batch.closed);
+  CHECK_EQ(batch.error, "");
+  CHECK(!socket.Send("{}"));
+}
+
+TEST(DroppedConnectionsReportAnError) {
+  TestServer server;
+  RelaySocket socket(nullptr);
+  socket.Connect(server.Url());
+  CHECK(server.Accept());
+  CHECK(TakeUntil(socket, [](const RelayBatch &b) { return b.opened; }).opened);
+  server.Disconnect();
+  RelayBatch batch = TakeUntil(socket, [](const RelayBatch &b) { return b.closed; });
+  CHECK(batch.closed);
+  CHECK(!batch.error.empty());
+}
+
+TEST(ClosingFromThisEndEndsWithAClosedBatch) {
+  TestServer server;
+  RelaySocket socket(nullptr);
+  socket.Connect(server.Url());
+  CHECK(server.Accept());
+  CHECK(TakeUntil(socket, [](const RelayBatch &b) { return b.opened; }).opened);
+  socket.Close();
+  RelayBatch batch = socket.TakeBatch();
+  CHECK(batch.closed);
+  CHECK_EQ(batch.error, "");
+  socket.Close();
+}
+
+#endif
@@ -0,0 +1,93 @@
+//
+//  SessionArchive.bench.cpp
+//  Reactotron
+//
+//  Exports a session of log, API and state action messages, then opens it and
+//  decodes every chunk. Takes the record count as an optional argument.
+//
+
+#include "IRSessionArchive/SessionArchive.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+
+using namespace reactotron;
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  std::string path = (std::filesystem::temp_directory_path() / "reactotron-bench.rtsess").string();
+  const char *words[] = {"fetch", "user", "cart", "render", "retry", "timeout", "loaded", "screen",
+                         "token", "sync", "payment", "profile", "image", "cache", "miss", "hit"};
+  std::mt19937 rng(7);
+  auto word = [&] { return words[rng() % 16]; };
+  auto number = [&](unsigned below) { return static_cast<unsigned>(rng() % below); };
+  char buffer[768];
+
+  using Clock = std::chrono::steady_clock;
+  auto ms = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+  SessionWriter writer;
+  writer.Open(path);
+  int64_t time = 1760000000000LL;
+  uint64_t jsonBytes = 0;
+  auto t0 = Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    time += rng() % 40;
+    const char *type;
+    int length;
+    switch (number(3)) {
+      case 0:
+        type = "log";
+        length = std::snprintf(buffer, sizeof(buffer),
+                               "{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{\"level\":\"debug\",\"message\":\"%s %s %s %u\"},"
+                               "\"important\":false,\"date\":\"2026-10-18T12:00:00.000Z\",\"deltaTime\":%u,\"clientId\":\"a1b2c3d4-0001\","
+                               "\"connectionId\":1,\"messageId\":%zu}}",
+                               word(), word(), word(), number(100000), number(40), i);
+        break;
+      case 1:
+        type = "api.response";
+        length = std::snprintf(buffer, sizeof(buffer),
+                               "{\"type\":\"command\",\"cmd\":{\"type\":\"api.response\",\"payload\":{\"duration\":%u,\"request\":{\"url\":"
+                               "\"https://api.example.com/v2/%s/%u\",\"method\":\"GET\",\"headers\":{\"Accept\":\"application/json\"}},"
+                               "\"response\":{\"status\":200,\"headers\":{\"content-type\":\"application/json; charset=utf-8\"},"
+                               "\"body\":{\"id\":%u,\"name\":\"%s %s\"}}},\"important\":false,\"date\":\"2026-10-18T12:00:00.000Z\","
+                               "\"deltaTime\":3,\"clientId\":\"a1b2c3d4-0001\",\"connectionId\":1,\"messageId\":%zu}}",
+                               number(900), word(), number(100000), number(1000000), word(), word(), i);
+        break;
+      default:
+        type = "state.action.complete";
+        length = std::snprintf(buffer, sizeof(buffer),
+                               "{\"type\":\"command\",\"cmd\":{\"type\":\"state.action.complete\",\"payload\":{\"name\":\"%s/%s\","
+                               "\"action\":{\"type\":\"%s/%s\",\"payload\":{\"id\":%u}},\"ms\":%u},\"important\":false,"
+                               "\"date\":\"2026-10-18T12:00:00.000Z\",\"deltaTime\":1,\"clientId\":\"a1b2c3d4-0001\",\"connectionId\":1,"
+                               "\"messageId\":%zu}}",
+                               word(), word(), word(), word(), number(100000), number(30), i);
+        break;
+    }
+    jsonBytes += length + 1;
+    writer.Append(time, type, std::string_view(buffer, length));
+  }
+  writer.Close();
+  auto t1 = Clock::now();
+  std::printf("write: %zu records, %.1f MB as a JSON array, %.2f MB archived (%.1fx), %.0f ms\n", count, jsonBytes / 1e6,
+              writer.Bytes() / 1e6, static_cast<double>(jsonBytes) / writer.Bytes(), ms(t0, t1));
+
+  SessionReader reader;
+  reader.Open(path);
+  auto t2 = Clock::now();
+  SessionChunk chunk;
+  uint64_t records = 0;
+  for (size_t i = 0; i < reader.Chunks().size(); i++) {
+    reader.ReadChunk(i, chunk);
+    records += chunk.texts.size();
+  }
+  auto t3 = Clock::now();
+  std::printf("open: %.3f ms; decode %zu chunks, %llu records: %.0f ms\n", ms(t1, t2), reader.Chunks().size(),
+              static_cast<unsigned long long>(records), ms(t2, t3));
+  reader.Close();
+  std::filesystem::remove(path);
+  return 0;
+}
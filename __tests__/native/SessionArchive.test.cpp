@@ -0,0 +1,238 @@
+//
+//  SessionArchive.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRBodyStore/BodyDecoding.h"
+#include "IRSessionArchive/SessionArchive.h"
+#include "IRSessionArchive/SessionCodec.h"
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+using namespace reactotron;
+
+namespace {
+
+std::string TempPath(const char *name) {
+  return (std::filesystem::temp_directory_path() / (std::string("reactotron-") + name + ".rtsess")).string();
+}
+
+bool RoundTrips(const std::string &data, std::string_view dictionary) {
+  std::string block = CompressBlock(data, dictionary);
+  std::string out;
+  return DecompressBlock(block, dictionary, data.size(), out) && out == data;
+}
+
+std::string LogRecord(int index) {
+  return "{\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{\"level\":\"debug\",\"message\":\"fetched " +
+         std::to_string(index % 97) + " items\"},\"date\":\"2026-10-18T12:00:00.000Z\",\"messageId\":" +
+         std::to_string(index) + "}}";
+}
+
+} // namespace
+
+TEST(CodecRoundTrips) {
+  auto dictionary = SessionDictionary();
+  CHECK(RoundTrips("", dictionary));
+  CHECK(RoundTrips("a", dictionary));
+  CHECK(RoundTrips(std::string(45, 'a'), dictionary));
+  CHECK(RoundTrips("abc", ""));
+
+  std::mt19937 rng(1);
+  for (int i = 0; i < 200; i++) {
+    std::string data(rng() % 5000, 'x');
+    for (auto &c : data) c = "abcd{}\"':,"[rng() % (i % 10 + 1)];
+    CHECK(RoundTrips(data, dictionary));
+    CHECK(RoundTrips(data, ""));
+  }
+  std::string noise(300000, 0);
+  for (auto &c : noise) c = static_cast<char>(rng());
+  CHECK(RoundTrips(noise, dictionary));
+  // Stored rather than grown
+  CHECK_EQ(CompressBlock(noise, dictionary).size(), noise.size() + 1);
+}
+
+TEST(BuiltInInflaterReadsBlocks) {
+  // What Windows reads deflated blocks with, after the method byte
+  std::string data;
+  for (int i = 0; i < 500; i++) data += LogRecord(i);
+  for (std::string_view dictionary : {SessionDictionary(), std::string_view()}) {
+    std::string block = CompressBlock(data, dictionary);
+    CHECK_EQ(block[0], '\x01');
+    std::string out;
+    CHECK(InflateBuiltIn(std::string_view(block).substr(1), DeflateWrapper::Raw, out, data.size(), dictionary));
+    CHECK(out == data);
+  }
+}
+
+TEST(CodecSurvivesCorruptBlocks) {
+  std::string data;
+  for (int i = 0; i < 500; i++) data += LogRecord(i);
+  auto dictionary = SessionDictionary();
+  std::string block = CompressBlock(data, dictionary);
+  CHECK(block.size() < data.size() / 4);
+
+  std::mt19937 rng(2);
+  std::string out;
+  for (int i = 0; i < 2000; i++) {
+    std::string corrupt = block;
+    corrupt[rng() % corrupt.size()] ^= static_cast<char>(1 << (rng() % 8));
+    if (DecompressBlock(corrupt, dictionary, data.size(), out)) CHECK_EQ(out.size(), data.size());
+  }
+  for (size_t length = 0; length < block.size(); length += block.size() / 50) {
+    CHECK(!DecompressBlock(std::string_view(block).substr(0, length), dictionary, data.size(), out));
+  }
+}
+
+TEST(WritesAndReadsBackChunks) {
+  std::string path = TempPath("roundtrip");
+  constexpr int kRecords = 40000; // More than one chunk
+  SessionWriter writer;
+  CHECK(writer.Open(path));
+  for (int i = 0; i < kRecords; i++) writer.Append(1000 + i, i % 5 ? "log" : "api.response", LogRecord(i));
+  CHECK_EQ(writer.Records(), static_cast<uint64_t>(kRecords));
+  CHECK(writer.Close());
+
+  SessionReader reader;
+  CHECK(reader.Open(path));
+  CHECK(!reader.Recovered());
+  CHECK(reader.Chunks().size() > 1);
+  CHECK_EQ(reader.Records(), static_cast<uint64_t>(kRecords));
+  CHECK((reader.Types() == std::vector<std::string>{"api.response", "log"}));
+
+  SessionChunk chunk;
+  int next = 0;
+  for (size_t i = 0; i < reader.Chunks().size(); i++) {
+    CHECK(reader.ReadChunk(i, chunk));
+    for (size_t j = 0; j < chunk.texts.size(); j++, next++) {
+      CHECK_EQ(chunk.times[j], 1000 + next);
+      CHECK_EQ(reader.Types()[chunk.types[j]], next % 5 ? "log" : "api.response");
+      CHECK_EQ(chunk.texts[j], LogRecord(next));
+    }
+  }
+  CHECK_EQ(next, kRecords);
+  CHECK(!reader.ReadChunk(reader.Chunks().size(), chunk));
+
+  // Only the last chunk has the last second in it
+  auto found = reader.FindChunks({}, 1000 + kRecords - 1000, 1000 + kRecords);
+  CHECK_EQ(found.size(), 1u);
+  CHECK(reader.FindChunks({}, 0, 999).empty());
+  reader.Close();
+  std::filesystem::remove(path);
+}
+
+TEST(ExportsBatchesInOrder) {
+  std::string path = TempPath("export");
+  TaskExecutor executor(2);
+  {
+    SessionExport session(executor);
+    CHECK(session.Open(path));
+    for (int i = 0; i < 50; i++) {
+      std::vector<SessionRecord> batch;
+      for (int j = 0; j < 100; j++) batch.push_back({i * 100 + j, "log", LogRecord(i * 100 + j)});
+      CHECK(session.Append(std::move(batch)));
+    }
+    CHECK(session.Finish());
+    CHECK_EQ(session.Writer().Records(), 5000u);
+    CHECK_EQ(session.Dropped(), 0u);
+    CHECK(!session.Append({{0, "log", "late"}}));
+  }
+
+  SessionReader reader;
+  CHECK(reader.Open(path));
+  SessionChunk chunk;
+  CHECK(reader.ReadChunk(0, chunk));
+  CHECK_EQ(chunk.texts.size(), 5000u);
+  for (size_t i = 0; i < chunk.texts.size(); i++) CHECK_EQ(chunk.texts[i], LogRecord(static_cast<int>(i)));
+  reader.Close();
+  std::filesystem::remove(path);
+}
+
+TEST(ExportDropsBatchesPastItsBudget) {
+  std::string path = TempPath("backlog");
+  TaskExecutor executor(2);
+  // Hold both workers, so nothing queued is written yet
+  std::atomic<bool> release{false};
+  std::atomic<int> blocking{0};
+  for (int i = 0; i < 2; i++) {
+    executor.Post(TaskPriority::Critical, [&] {
+      ++blocking;
+      while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+  }
+  while (blocking < 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  SessionExport session(executor);
+  CHECK(session.Open(path));
+  std::string third(SessionExport::kMaxQueuedBytes / 3, 'x');
+  CHECK(session.Append({{1, "log", third}}));
+  CHECK(session.Append({{2, "log", third}}));
+  CHECK(!session.Append({{3, "log", third}, {4, "log", "small"}}));
+  CHECK_EQ(session.Dropped(), 2u);
+
+  release = true;
+  CHECK(session.Finish());
+  CHECK_EQ(session.Writer().Records(), 2u);
+  std::filesystem::remove(path);
+}
+
+TEST(RecoversAnUnfinishedExport) {
+  std::string path = TempPath("recover");
+  {
+    SessionWriter writer;
+    CHECK(writer.Open(path));
+    for (int i = 0; i < 40000; i++) writer.Append(i, "log", LogRecord(i));
+    CHECK(writer.Close());
+  }
+  uint64_t cut;
+  {
+    SessionReader reader;
+    CHECK(reader.Open(path));
+    cut = reader.Chunks()[1].offset + 100; // Partway into the second chunk
+  }
+  std::filesystem::resize_file(path, cut);
+
+  SessionReader reader;
+  CHECK(reader.Open(path));
+  CHECK(reader.Recovered());
+  CHECK_EQ(reader.Chunks().size(), 1u);
+  SessionChunk chunk;
+  CHECK(reader.ReadChunk(0, chunk));
+  CHECK_EQ(chunk.texts[0], LogRecord(0));
+  reader.Close();
+  std::filesystem::remove(path);
+}
+
+TEST(RejectsFilesThatArentArchives) {
+  std::string path = TempPath("garbage");
+  {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a session archive at all", file);
+    std::fclose(file);
+  }
+  SessionReader reader;
+  CHECK(!reader.Open(path));
+  CHECK(!reader.Open(TempPath("missing")));
+
+  // An archive from another format version
+  {
+    SessionWriter writer;
+    CHECK(writer.Open(path));
+    CHECK(writer.Append(1, "log", LogRecord(0)));
+    CHECK(writer.Close());
+  }
+  CHECK(reader.Open(path));
+  reader.Close();
+  {
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    std::fseek(file, 8, SEEK_SET);
+    std::fputc(2, file);
+    std::fclose(file);
+  }
+  CHECK(!reader.Open(path));
+  std::filesystem::remove(path);
+}
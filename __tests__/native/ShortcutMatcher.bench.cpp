@@ -0,0 +1,38 @@
+//
+//  ShortcutMatcher.bench.cpp
+//  Reactotron
+//
+//  Plain typing with 50 modifier shortcuts registered, the case every key
+//  press in the app goes through.
+//
+
+#include "IRKeyboard/ShortcutMatcher.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace reactotron;
+
+int main() {
+  ShortcutMatcher matcher(1000);
+  for (int i = 0; i < 50; i++) {
+    matcher.Register("s" + std::to_string(i), "cmd+shift+" + std::string(1, 'a' + i % 26) + (i >= 26 ? " x" : ""));
+  }
+
+  const std::string text = "the quick brown fox jumps over the lazy dog ";
+  std::vector<std::string> out;
+  size_t keys = 0, consumed = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 200000; round++) {
+    for (char c : text) {
+      if (matcher.HandleKeyDown({0, std::string(1, c)}, static_cast<int64_t>(keys), out)) consumed++;
+      keys++;
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+  std::printf("%zu keys, %zu consumed, %.1f ns/key\n", keys, consumed, elapsed.count() / keys);
+  return 0;
+}
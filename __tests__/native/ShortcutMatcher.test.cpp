@@ -0,0 +1,100 @@
+//
+//  ShortcutMatcher.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRKeyboard/ShortcutMatcher.h"
+
+using namespace reactotron;
+using Matches = std::vector<std::string>;
+
+TEST(ParsesShortcuts) {
+  std::vector<KeyChord> chords;
+  CHECK(ParseShortcut("cmd+shift+K", chords));
+  CHECK_EQ(chords.size(), 1u);
+  CHECK_EQ(chords[0].key, "k");
+  CHECK_EQ(chords[0].modifiers, kShortcutModifierCmd | kShortcutModifierShift);
+
+  CHECK(ParseShortcut("g g", chords));
+  CHECK_EQ(chords.size(), 2u);
+
+  CHECK(ParseShortcut("cmd++", chords));
+  CHECK_EQ(chords[0].key, "+");
+  // "+" is typed as shift+=
+  CHECK_EQ(chords[0].modifiers, kShortcutModifierCmd | kShortcutModifierShift);
+}
+
+TEST(RejectsMalformedShortcuts) {
+  std::vector<KeyChord> chords;
+  CHECK(!ParseShortcut("hyper+k", chords));
+  CHECK(!ParseShortcut("  ", chords));
+  CHECK(!ParseShortcut("cmd+", chords));
+}
+
+TEST(FormatsModifiersInCanonicalOrder) {
+  CHECK_EQ(FormatShortcut({{kShortcutModifierShift | kShortcutModifierCmd, "k"}}), "cmd+shift+k");
+}
+
+TEST(MatchesChordsAndSequences) {
+  ShortcutMatcher matcher(1000);
+  Matches out;
+  matcher.Register("clear", "cmd+k");
+  matcher.Register("gg", "g g");
+  matcher.Register("g", "g");
+  matcher.Register("esc", "esc");
+
+  CHECK(matcher.HandleKeyDown({kShortcutModifierCmd, "k"}, 0, out));
+  CHECK(out == Matches{"clear"});
+  out.clear();
+
+  CHECK(!matcher.HandleKeyDown({0, "k"}, 10, out));
+  CHECK(out.empty());
+
+  // "g" is held back while "g g" could still match
+  CHECK(matcher.HandleKeyDown({0, "g"}, 20, out));
+  CHECK(out.empty());
+  CHECK_EQ(matcher.PendingDeadline(), 1020);
+  CHECK(matcher.HandleKeyDown({0, "g"}, 30, out));
+  CHECK(out == Matches{"gg"});
+  out.clear();
+}
+
+TEST(ExpiresHeldBackPrefixes) {
+  ShortcutMatcher matcher(1000);
+  Matches out;
+  matcher.Register("gg", "g g");
+  matcher.Register("g", "g");
+  matcher.Register("esc", "esc");
+
+  CHECK(matcher.HandleKeyDown({0, "g"}, 40, out));
+  CHECK(!matcher.Expire(500, out));
+  CHECK(matcher.Expire(1040, out));
+  CHECK(out == Matches{"g"});
+  out.clear();
+
+  // A key that ends the sequence settles the held-back prefix first
+  matcher.HandleKeyDown({0, "g"}, 2000, out);
+  CHECK(matcher.HandleKeyDown({0, "escape"}, 2010, out));
+  CHECK((out == Matches{"g", "esc"}));
+  out.clear();
+
+  // The second "g" comes after the timeout, so it starts a new sequence
+  matcher.HandleKeyDown({0, "g"}, 3000, out);
+  matcher.HandleKeyDown({0, "g"}, 4500, out);
+  CHECK(out == Matches{"g"});
+}
+
+TEST(UnregisterDropsPendingState) {
+  ShortcutMatcher matcher(1000);
+  Matches out;
+  matcher.Register("gg", "g g");
+  matcher.Register("g", "g");
+  matcher.HandleKeyDown({0, "g"}, 0, out);
+  matcher.Unregister("g");
+  matcher.Unregister("gg");
+  CHECK_EQ(matcher.PendingDeadline(), -1);
+  CHECK(matcher.Empty());
+  matcher.HandleKeyDown({0, "g"}, 10, out);
+  CHECK(out.empty());
+}
@@ -0,0 +1,50 @@
+//
+//  ShutdownCommands.bench.cpp
+//  Reactotron
+//
+//  Quit time for ten slow cleanup commands run one after another with popen
+//  and run together by ShutdownCommands. POSIX only.
+//
+
+#include "IRRunShellCommand/ShutdownCommands.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+long MsSince(Clock::time_point start) {
+  return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+int main() {
+#if !defined(_WIN32)
+  auto start = Clock::now();
+  for (int i = 0; i < 10; ++i) {
+    FILE *pipe = popen("sleep 0.2", "r");
+    char buffer[64];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+    }
+    pclose(pipe);
+  }
+  std::printf("popen, one at a time, 10 x sleep 0.2: %ld ms\n", MsSince(start));
+
+  ShutdownCommands commands;
+  for (int i = 0; i < 10; ++i) commands.Add("sleep 0.2");
+  start = Clock::now();
+  commands.Run();
+  std::printf("ShutdownCommands,     10 x sleep 0.2: %ld ms\n", MsSince(start));
+
+  for (int i = 0; i < 10; ++i) commands.Add("trap '' TERM; while :; do sleep 0.05; done", false, 1000);
+  start = Clock::now();
+  commands.Run();
+  std::printf("10 ignoring SIGTERM, deadline 1 s:     %ld ms (grace %u ms)\n", MsSince(start),
+              ShutdownCommands::kKillGraceMs);
+#endif
+  return 0;
+}
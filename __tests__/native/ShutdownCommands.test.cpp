@@ -0,0 +1,169 @@
+//
+//  ShutdownCommands.test.cpp
+//  Reactotron
+//
+//  The commands are POSIX shell, so these only run there.
+//
+
+#include "NativeTest.h"
+#include "IRRunShellCommand/ShutdownCommands.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+#if !defined(_WIN32)
+
+namespace {
+
+long MsSince(Clock::time_point start) {
+  return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+TEST(ReportsExitCodesAndCapturedOutput) {
+  ShutdownCommands commands;
+  commands.Add("echo hi; echo err >&2; exit 3", true);
+  commands.Add("echo quiet");
+  commands.Add("kill -9 $$");
+  CHECK_EQ(commands.Count(), size_t(3));
+  auto results = commands.Run();
+  CHECK_EQ(commands.Count(), size_t(0));
+  CHECK_EQ(results.size(), size_t(3));
+  if (results.size() == 3) {
+    CHECK(results[0].started);
+    CHECK_EQ(results[0].command, "echo hi; echo err >&2; exit 3");
+    CHECK_EQ(results[0].exitCode, 3);
+    CHECK_EQ(results[0].output, "hi\nerr\n");
+    CHECK(!results[0].timedOut);
+    CHECK_EQ(results[1].exitCode, 0);
+    CHECK_EQ(results[1].output, "");
+    CHECK_EQ(results[2].exitCode, 128 + 9);
+  }
+  CHECK(commands.Run().empty());
+}
+
+TEST(DescribesEachResultOnOneLine) {
+  ShutdownCommands commands;
+  commands.Add("exit 3");
+  commands.Add("trap '' TERM; while :; do sleep 0.05; done", false, 100);
+  commands.Add("sleep 30", false, 100);
+  auto results = commands.Run();
+  CHECK_EQ(results.size(), size_t(3));
+  if (results.size() != 3) return;
+  std::string exited = ShutdownCommands::Describe(results[0]);
+  CHECK_EQ(exited.rfind("exited 3 in ", 0), size_t(0));
+  CHECK(exited.ends_with(" ms: exit 3"));
+  CHECK(ShutdownCommands::Describe(results[1]).find("exited 137 in ") == 0);
+  CHECK(ShutdownCommands::Describe(results[1]).find(" ms (killed): trap") != std::string::npos);
+  CHECK(ShutdownCommands::Describe(results[2]).find(" ms (timed out): sleep 30") != std::string::npos);
+
+  ShutdownCommandResult unstarted;
+  unstarted.command = "missing";
+  CHECK_EQ(ShutdownCommands::Describe(unstarted), std::string("failed to start: missing"));
+  for (const auto &result : results) CHECK(ShutdownCommands::Describe(result).find('\n') == std::string::npos);
+}
+
+TEST(CapsCapturedOutput) {
+  ShutdownCommands commands;
+  commands.Add("head -c 1000000 /dev/zero", true);
+  auto results = commands.Run();
+  CHECK(results.size() == 1 && results[0].exitCode == 0);
+  if (!results.empty()) CHECK_EQ(results[0].output.size(), ShutdownCommands::kMaxOutputBytes);
+}
+
+TEST(RunsCommandsConcurrently) {
+  ShutdownCommands commands;
+  for (int i = 0; i < 10; ++i) commands.Add("sleep 0.5", false, 5000);
+  auto start = Clock::now();
+  auto results = commands.Run();
+  CHECK(MsSince(start) < 2500);
+  for (const auto &result : results) {
+    CHECK_EQ(result.exitCode, 0);
+    CHECK(!result.timedOut);
+    CHECK(result.elapsedMs >= 490);
+  }
+}
+
+TEST(StopsCommandsAtTheirDeadline) {
+  ShutdownCommands commands;
+  for (int i = 0; i < 5; ++i) commands.Add("sleep 60; echo never", true, 300);
+  auto start = Clock::now();
+  auto results = commands.Run();
+  CHECK(MsSince(start) < 300 + long(ShutdownCommands::kKillGraceMs));
+  for (const auto &result : results) {
+    CHECK(result.timedOut);
+    CHECK(!result.killed);
+    CHECK_EQ(result.exitCode, 128 + 15);
+    CHECK_EQ(result.output, "");
+  }
+}
+
+TEST(KillsCommandsThatIgnoreTheRequestToStop) {
+  ShutdownCommands commands;
+  for (int i = 0; i < 5; ++i) commands.Add("trap '' TERM; while :; do sleep 0.05; done", false, 300);
+  auto start = Clock::now();
+  auto results = commands.Run();
+  CHECK(MsSince(start) < 300 + long(ShutdownCommands::kKillGraceMs) + 1000);
+  for (const auto &result : results) {
+    CHECK(result.timedOut);
+    CHECK(result.killed);
+    CHECK_EQ(result.exitCode, 128 + 9);
+  }
+}
+
+TEST(QuitFinishesWithinTheDeadline) {
+  ShutdownCommands commands;
+  // Neither stops when asked to
+  commands.Add("trap '' TERM; while :; do sleep 0.05; done");
+  commands.Add("trap '' TERM; while :; do sleep 0.05; done", false, 60000); // Can't outlast Run()'s
+  commands.Add("sleep 0.1; exit 2");
+  auto start = Clock::now();
+  auto results = commands.Run(400);
+  CHECK(MsSince(start) < 400 + 2 * long(ShutdownCommands::kKillGraceMs) + 200);
+  CHECK_EQ(results.size(), size_t(3));
+  if (results.size() == 3) {
+    for (size_t i = 0; i < 2; ++i) {
+      CHECK(results[i].timedOut);
+      CHECK(results[i].killed);
+      CHECK_EQ(results[i].exitCode, 128 + 9);
+    }
+    CHECK(!results[2].timedOut);
+    CHECK_EQ(results[2].exitCode, 2);
+  }
+}
+
+TEST(DeadlinesArePerCommand) {
+  ShutdownCommands commands;
+  commands.Add("sleep 0.8; exit 4");
+  commands.Add("sleep 30", false, 200);
+  commands.Add("true", false, 200);
+  auto start = Clock::now();
+  auto results = commands.Run();
+  CHECK(MsSince(start) >= 800);
+  CHECK_EQ(results.size(), size_t(3));
+  if (results.size() == 3) {
+    CHECK_EQ(results[0].exitCode, 4);
+    CHECK(!results[0].timedOut);
+    CHECK(results[1].timedOut);
+    CHECK(results[1].elapsedMs < 200 + ShutdownCommands::kKillGraceMs);
+    CHECK_EQ(results[2].exitCode, 0);
+    CHECK(!results[2].timedOut);
+  }
+}
+
+TEST(CommandsMayBeAddedWhileRunning) {
+  ShutdownCommands commands;
+  std::thread adder([&] {
+    for (int i = 0; i < 50; ++i) commands.Add("true");
+  });
+  size_t ran = 0;
+  while (ran < 50) ran += commands.Run().size();
+  adder.join();
+  CHECK_EQ(ran, size_t(50));
+}
+
+#endif
@@ -0,0 +1,116 @@
+//
+//  SourceMapIndex.bench.cpp
+//  Reactotron
+//
+//  A dev-bundle-sized map (320k generated lines, 3000 sources with their
+//  content): decoding it, saving and reopening its table, and looking frames
+//  up in it.
+//
+
+#include "IRSymbolicator/SourceMapIndex.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void Vlq(std::string &out, int value) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  unsigned bits = value < 0 ? (static_cast<unsigned>(-value) << 1) | 1 : static_cast<unsigned>(value) << 1;
+  do {
+    unsigned digit = bits & 31;
+    bits >>= 5;
+    if (bits) digit |= 32;
+    out += kAlphabet[digit];
+  } while (bits);
+}
+
+std::string MakeMap(std::mt19937 &rng, int lines, int sources) {
+  std::string json = "{\"version\":3,\"sources\":[";
+  for (int i = 0; i < sources; ++i) {
+    json += (i ? ",\"src/module" : "\"src/module") + std::to_string(i / 50) + "/file" + std::to_string(i) + ".tsx\"";
+  }
+  json += "],\"sourcesContent\":[";
+  for (int i = 0; i < sources; ++i) {
+    json += i ? ",\"" : "\"";
+    for (int j = 0; j < 180; ++j) {
+      json += "const value" + std::to_string(j) + " = computeSomething(" + std::to_string(j) + ")\\n";
+    }
+    json += '"';
+  }
+  json += "],\"names\":[\"a\",\"b\"],\"mappings\":\"";
+  int source = 0, line = 0, column = 0;
+  for (int l = 0; l < lines; ++l) {
+    if (l) json += ';';
+    int generated = 0;
+    for (int n = 3 + rng() % 7, k = 0; k < n; ++k) {
+      if (k) json += ',';
+      int step = 1 + rng() % 30;
+      Vlq(json, step);
+      generated += step;
+      int nextSource = rng() % 50 ? source : static_cast<int>(rng() % sources);
+      int nextLine = std::max(0, line + static_cast<int>(rng() % 6) - 2);
+      int nextColumn = rng() % 81;
+      Vlq(json, nextSource - source);
+      Vlq(json, nextLine - line);
+      Vlq(json, nextColumn - column);
+      source = nextSource, line = nextLine, column = nextColumn;
+    }
+  }
+  return json + "\"}";
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(50);
+  const int lines = 320000;
+  std::string json = MakeMap(rng, lines, 3000);
+
+  auto start = Clock::now();
+  uint64_t key = SourceMapKey(json);
+  double hashMs = MsSince(start);
+  std::string error;
+  start = Clock::now();
+  auto parsed = SourceMapIndex::Parse(json, key, error);
+  double parseMs = MsSince(start);
+  if (!parsed) {
+    std::printf("parse failed: %s\n", error.c_str());
+    return 1;
+  }
+  std::printf("map: %.1f MB, %u mappings; key %.1f ms, parse %.1f ms, table %.1f MB\n", json.size() / 1e6,
+              parsed->Mappings(), hashMs, parseMs, parsed->ByteSize() / 1e6);
+
+  std::string path = (std::filesystem::temp_directory_path() / "reactotron-bench.irsm").string();
+  start = Clock::now();
+  parsed->Save(path);
+  double saveMs = MsSince(start);
+  start = Clock::now();
+  auto opened = SourceMapIndex::Open(path, key);
+  double openMs = MsSince(start);
+  std::printf("save %.1f ms, open cached %.3f ms\n", saveMs, openMs);
+  if (!opened) return 1;
+
+  const int frames = 1000000;
+  std::vector<std::pair<uint32_t, uint32_t>> positions;
+  for (int i = 0; i < frames; ++i) positions.emplace_back(1 + rng() % lines, rng() % 200);
+  for (const auto &index : {parsed, opened}) {
+    size_t found = 0;
+    start = Clock::now();
+    SourcePosition position;
+    for (const auto &[line, column] : positions) found += index->Lookup(line, column, position);
+    std::printf("lookup (%s): %.0f ns/frame, %zu resolved\n", index->IsMapped() ? "mapped" : "parsed",
+                MsSince(start) * 1e6 / frames, found);
+  }
+  std::filesystem::remove(path);
+  return 0;
+}
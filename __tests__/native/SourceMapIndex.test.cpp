@@ -0,0 +1,264 @@
+//
+//  SourceMapIndex.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRSymbolicator/SourceMapIndex.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace reactotron;
+namespace fs = std::filesystem;
+
+namespace {
+
+/** A mapping as a test writes it: generated column, then -1 or source, line, column. */
+struct Segment {
+  int column;
+  int source = -1;
+  int line = 0;
+  int originalColumn = 0;
+};
+
+void Vlq(std::string &out, int value) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  unsigned bits = value < 0 ? (static_cast<unsigned>(-value) << 1) | 1 : static_cast<unsigned>(value) << 1;
+  do {
+    unsigned digit = bits & 31;
+    bits >>= 5;
+    if (bits) digit |= 32;
+    out += kAlphabet[digit];
+  } while (bits);
+}
+
+/** Encodes `lines` of segments, each line's in the order given, as "mappings". */
+std::string Mappings(const std::vector<std::vector<Segment>> &lines) {
+  std::string mappings;
+  int source = 0, line = 0, column = 0;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    if (i) mappings += ';';
+    int generated = 0;
+    for (size_t j = 0; j < lines[i].size(); ++j) {
+      const Segment &segment = lines[i][j];
+      if (j) mappings += ',';
+      Vlq(mappings, segment.column - generated);
+      generated = segment.column;
+      if (segment.source < 0) continue;
+      Vlq(mappings, segment.source - source);
+      Vlq(mappings, segment.line - line);
+      Vlq(mappings, segment.originalColumn - column);
+      source = segment.source;
+      line = segment.line;
+      column = segment.originalColumn;
+    }
+  }
+  return mappings;
+}
+
+std::string Map(const std::string &mappings, const std::string &sources = "[\"a.js\",\"b.js\"]",
+                const std::string &extra = "") {
+  return "{\"version\":3,\"sources\":" + sources + ",\"names\":[]," + extra + "\"mappings\":\"" + mappings + "\"}";
+}
+
+std::shared_ptr<SourceMapIndex> Parse(const std::string &json) {
+  std::string error;
+  auto index = SourceMapIndex::Parse(json, SourceMapKey(json), error);
+  if (!index) ::reactotron::test::Fail(__FILE__, __LINE__, "Parse failed: " + error);
+  return index;
+}
+
+/** "source:line:column", or "" if the lookup fails. */
+std::string Find(const SourceMapIndex &index, uint32_t line, uint32_t column) {
+  SourcePosition position;
+  if (!index.Lookup(line, column, position)) return "";
+  return std::string(position.source) + ":" + std::to_string(position.line) + ":" + std::to_string(position.column);
+}
+
+fs::path Directory() {
+  fs::path directory = fs::temp_directory_path() / "reactotron-source-map-test";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  return directory;
+}
+
+} // namespace
+
+TEST(FindsTheMappingAtOrBeforeAColumn) {
+  auto index = Parse(Map(Mappings({
+      {{0, 0, 0, 0}, {10, 0, 0, 8}, {20, 1, 4, 2}},
+      {},
+      {{5, 1, 9, 0}, {12}, {30, 0, 2, 6}},
+  })));
+  if (!index) return;
+  CHECK_EQ(index->Lines(), uint32_t(3));
+  CHECK_EQ(index->Mappings(), uint32_t(6));
+  CHECK_EQ(index->Sources(), uint32_t(2));
+  CHECK_EQ(Find(*index, 1, 0), std::string("a.js:1:0"));
+  CHECK_EQ(Find(*index, 1, 9), std::string("a.js:1:0"));
+  CHECK_EQ(Find(*index, 1, 10), std::string("a.js:1:8"));
+  CHECK_EQ(Find(*index, 1, 500), std::string("b.js:5:2"));
+  CHECK_EQ(Find(*index, 2, 0), std::string()); // No mappings on the line
+  CHECK_EQ(Find(*index, 3, 4), std::string()); // Before the first
+  CHECK_EQ(Find(*index, 3, 11), std::string("b.js:10:0"));
+  CHECK_EQ(Find(*index, 3, 12), std::string()); // An unmapped segment ends the one before it
+  CHECK_EQ(Find(*index, 3, 31), std::string("a.js:3:6"));
+  CHECK_EQ(Find(*index, 0, 0), std::string());
+  CHECK_EQ(Find(*index, 4, 0), std::string());
+}
+
+TEST(MatchesALinearScanOverARandomMap) {
+  std::mt19937 rng(50);
+  const int sources = 40;
+  std::string names = "[";
+  for (int i = 0; i < sources; ++i) names += (i ? ",\"src/file" : "\"src/file") + std::to_string(i) + ".tsx\"";
+  names += "]";
+  std::vector<std::vector<Segment>> lines(300);
+  for (auto &line : lines) {
+    int column = 0;
+    for (int n = rng() % 12; n > 0; --n) {
+      column += 1 + rng() % 40;
+      if (rng() % 10 == 0) {
+        line.push_back({column});
+      } else {
+        line.push_back({column, static_cast<int>(rng() % sources), static_cast<int>(rng() % 2000),
+                        static_cast<int>(rng() % 120)});
+      }
+    }
+  }
+  auto index = Parse(Map(Mappings(lines), names));
+  if (!index) return;
+
+  for (uint32_t line = 1; line <= lines.size(); ++line) {
+    for (uint32_t column = 0; column < 500; column += 7) {
+      const Segment *last = nullptr;
+      for (const Segment &segment : lines[line - 1]) {
+        if (segment.column <= static_cast<int>(column)) last = &segment;
+      }
+      std::string expected;
+      if (last && last->source >= 0) {
+        expected = "src/file" + std::to_string(last->source) + ".tsx:" + std::to_string(last->line + 1) + ":" +
+                   std::to_string(last->originalColumn);
+      }
+      CHECK_EQ(Find(*index, line, column), expected);
+    }
+  }
+}
+
+TEST(SortsSegmentsWithinALine) {
+  std::string mappings;
+  // Written out of order: column 20 first, then back to 4
+  Vlq(mappings, 20), Vlq(mappings, 0), Vlq(mappings, 0), Vlq(mappings, 0);
+  mappings += ',';
+  Vlq(mappings, -16), Vlq(mappings, 1), Vlq(mappings, 3), Vlq(mappings, 1);
+  auto index = Parse(Map(mappings));
+  if (!index) return;
+  CHECK_EQ(Find(*index, 1, 3), std::string());
+  CHECK_EQ(Find(*index, 1, 10), std::string("b.js:4:1"));
+  CHECK_EQ(Find(*index, 1, 25), std::string("a.js:1:0"));
+}
+
+TEST(ResolvesSourcesAgainstTheRoot) {
+  auto index = Parse(Map(Mappings({{{0, 0, 0, 0}, {5, 1, 0, 0}, {10, 2, 0, 0}, {15, 3, 0, 0}}}),
+                         "[\"app/a.js\",\"/abs/b.js\",null,\"webpack://c.js\"]", "\"sourceRoot\":\"/root\","));
+  if (!index) return;
+  CHECK_EQ(index->Source(0), std::string_view("/root/app/a.js"));
+  CHECK_EQ(index->Source(1), std::string_view("/abs/b.js"));
+  CHECK_EQ(index->Source(2), std::string_view());
+  CHECK_EQ(index->Source(3), std::string_view("webpack://c.js"));
+  CHECK_EQ(index->Source(4), std::string_view());
+  CHECK_EQ(Find(*index, 1, 11), std::string()); // A null source
+  CHECK_EQ(Find(*index, 1, 0), std::string("/root/app/a.js:1:0"));
+}
+
+TEST(ReadsEscapedMappingsAndSkipsOtherFields) {
+  std::string json = "{\"file\":\"index.bundle\","
+                     "\"x_facebook_sources\":[[{\"names\":[\"<global>\"],\"mappings\":\"AAA\"}]],"
+                     "\"version\":3,\"sourcesContent\":[\"let a = \\\"\\u00e9\\\";\"],\"sources\":[\"a.js\"],"
+                     "\"mappings\":\"\\u0041AAA,IAAC\"}";
+  auto index = Parse(json);
+  if (!index) return;
+  CHECK_EQ(Find(*index, 1, 2), std::string("a.js:1:0"));
+  CHECK_EQ(Find(*index, 1, 4), std::string("a.js:1:1"));
+}
+
+TEST(RejectsMapsItCantRead) {
+  const char *maps[] = {
+      "",
+      "[]",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"AAAA\"",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"AAAA\"} extra",
+      "{\"version\":2,\"sources\":[],\"mappings\":\"AAAA\"}",
+      "{\"version\":3,\"sources\":[]}",
+      "{\"version\":3,\"sections\":[]}",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"AA\"}",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"AAAAAA\"}",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"AAA!\"}",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"g\"}",
+      "{\"version\":3,\"sources\":[],\"mappings\":\"gggggggggA\"}",
+  };
+  for (const char *json : maps) {
+    std::string error;
+    CHECK(!SourceMapIndex::Parse(json, 1, error));
+    CHECK(!error.empty());
+  }
+}
+
+TEST(SavesAndOpensTables) {
+  fs::path directory = Directory();
+  std::string json = Map(Mappings({{{0, 0, 0, 0}, {8, 1, 2, 3}}, {{4, 1, 7, 1}}}));
+  uint64_t key = SourceMapKey(json);
+  auto parsed = Parse(json);
+  if (!parsed) return;
+  CHECK(!parsed->IsMapped());
+  std::string path = (directory / "table.irsm").string();
+  CHECK(parsed->Save(path));
+  CHECK(!fs::exists(path + ".tmp"));
+  CHECK_EQ(fs::file_size(path), uintmax_t(parsed->ByteSize()));
+
+  auto opened = SourceMapIndex::Open(path, key);
+  CHECK(opened != nullptr);
+  if (!opened) return;
+  CHECK(opened->IsMapped());
+  CHECK_EQ(opened->Key(), key);
+  CHECK_EQ(opened->Lines(), parsed->Lines());
+  CHECK_EQ(opened->Mappings(), parsed->Mappings());
+  CHECK_EQ(Find(*opened, 1, 9), std::string("b.js:3:3"));
+  CHECK_EQ(Find(*opened, 2, 4), std::string("b.js:8:1"));
+
+  CHECK(!SourceMapIndex::Open(path, key + 1));
+  CHECK(!SourceMapIndex::Open((directory / "missing.irsm").string(), key));
+
+  std::string bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  auto damaged = [&](const std::string &content) {
+    std::string other = (directory / "damaged.irsm").string();
+    std::ofstream(other, std::ios::binary | std::ios::trunc) << content;
+    return SourceMapIndex::Open(other, key) == nullptr;
+  };
+  CHECK(damaged(bytes.substr(0, bytes.size() - 1)));
+  CHECK(damaged(bytes + "x"));
+  CHECK(damaged(bytes.substr(0, 16)));
+  CHECK(damaged(""));
+  std::string version = bytes;
+  version[4] = 9;
+  CHECK(damaged(version));
+  std::string lineStarts = bytes;
+  lineStarts[32 + 4] = 100; // The second line starts past the entries
+  CHECK(damaged(lineStarts));
+  fs::remove_all(directory);
+}
+
+TEST(KeysMapsByTheirContent) {
+  CHECK_EQ(SourceMapKey(""), uint64_t(0xEF46DB3751D8E999ULL));
+  CHECK_EQ(SourceMapKey("abc"), uint64_t(0x44BC2CF5AD770999ULL));
+  std::string big(1000, 'x');
+  uint64_t key = SourceMapKey(big);
+  big[999] = 'y';
+  CHECK(SourceMapKey(big) != key);
+}
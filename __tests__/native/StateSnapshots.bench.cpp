@@ -0,0 +1,84 @@
+//
+//  StateSnapshots.bench.cpp
+//  Reactotron
+//
+//  Ten thousand actions against a small and a large normalized store, each one
+//  snapshotted, then materialized, diffed against its neighbour and removed.
+//
+
+#include "IRStateSnapshots/StateSnapshots.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string Json(const std::vector<int> &counts, const std::vector<bool> &done, int page) {
+  std::string json = "{\"user\":{\"name\":\"alice\",\"page\":" + std::to_string(page) + "},\"entities\":{\"todos\":{";
+  for (size_t i = 0; i < counts.size(); ++i) {
+    if (i) json += ",";
+    json += "\"t" + std::to_string(i) + "\":{\"id\":" + std::to_string(i) + ",\"title\":\"todo item number " +
+            std::to_string(i * 7919 % 100000) + "\",\"count\":" + std::to_string(counts[i]) +
+            ",\"done\":" + (done[i] ? "true" : "false") + "}";
+  }
+  return json + "}}}";
+}
+
+void Run(size_t entities, size_t actions) {
+  std::mt19937_64 rng(42);
+  std::vector<int> counts(entities);
+  std::vector<bool> done(entities);
+  int page = 0;
+  SnapshotStore store(8ull << 30);
+  std::vector<uint64_t> ids;
+  double addMs = 0, maxAddMs = 0;
+
+  for (size_t action = 0; action < actions; ++action) {
+    size_t k = rng() % entities;
+    switch (rng() % 3) {
+      case 0: counts[k]++; break;
+      case 1: done[k] = !done[k]; break;
+      default: page++; break;
+    }
+    std::string json = Json(counts, done, page);
+    auto start = Clock::now();
+    ids.push_back(store.Add("c1", "ACTION", static_cast<int64_t>(action), json));
+    double ms = MsSince(start);
+    addMs += ms;
+    maxAddMs = std::max(maxAddMs, ms);
+  }
+  auto stats = store.Stats();
+  std::printf("%zu entities, %zu actions: logical %.1f MB, stored %.2f MB (%.0fx), add avg %.3f ms max %.3f ms\n",
+              entities, actions, stats.logicalBytes / 1e6, stats.storedBytes / 1e6,
+              static_cast<double>(stats.logicalBytes) / stats.storedBytes, addMs / actions, maxAddMs);
+
+  std::string out;
+  auto start = Clock::now();
+  for (size_t i = 0; i < ids.size(); i += 100) store.Materialize(ids[i], out);
+  std::printf("  materialize %.3f ms", MsSince(start) / ((ids.size() + 99) / 100));
+
+  std::vector<SnapshotChange> changes;
+  start = Clock::now();
+  for (size_t i = 1; i < ids.size(); i += 100) store.Diff(ids[i - 1], ids[i], changes);
+  std::printf(", diff neighbours %.3f ms", MsSince(start) / ((ids.size() + 98) / 100));
+
+  start = Clock::now();
+  for (auto id : ids) store.Remove(id);
+  std::printf(", remove all %.1f ms\n", MsSince(start));
+}
+
+} // namespace
+
+int main() {
+  Run(63, 10000);
+  Run(6000, 10000);
+  return 0;
+}
@@ -0,0 +1,167 @@
+//
+//  StateSnapshots.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRStateSnapshots/StateSnapshots.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+/** A normalized todo store, like the states apps send after each action. */
+struct TodoState {
+  std::vector<std::string> titles;
+  std::vector<int> counts;
+  std::vector<bool> done;
+  int page = 0;
+
+  explicit TodoState(size_t entities, std::mt19937_64 &rng) {
+    for (size_t i = 0; i < entities; ++i) {
+      titles.push_back("todo item number " + std::to_string(rng() % 100000));
+      counts.push_back(static_cast<int>(rng() % 1000));
+      done.push_back(rng() & 1);
+    }
+  }
+
+  /** Changes one value, as an action would. */
+  void Act(std::mt19937_64 &rng) {
+    size_t k = rng() % titles.size();
+    switch (rng() % 3) {
+      case 0: counts[k]++; break;
+      case 1: done[k] = !done[k]; break;
+      default: page++; break;
+    }
+  }
+
+  std::string Json() const {
+    std::string json = "{\"user\":{\"name\":\"alice\",\"page\":" + std::to_string(page) + "},\"entities\":{\"todos\":{";
+    for (size_t i = 0; i < titles.size(); ++i) {
+      if (i) json += ",";
+      json += "\"t" + std::to_string(i) + "\":{\"id\":" + std::to_string(i) + ",\"title\":\"" + titles[i] +
+              "\",\"count\":" + std::to_string(counts[i]) + ",\"done\":" + (done[i] ? "true" : "false") + "}";
+    }
+    json += "}},\"list\":[";
+    for (size_t i = 0; i < titles.size() && i < 50; ++i) json += (i ? "," : "") + std::to_string(i);
+    return json + "]}";
+  }
+};
+
+const SnapshotChange *FindChange(const std::vector<SnapshotChange> &changes, const std::string &path) {
+  auto it = std::find_if(changes.begin(), changes.end(), [&](const auto &change) { return change.path == path; });
+  return it == changes.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST(MaterializesWhatWasAdded) {
+  SnapshotStore store;
+  const char *json = R"({"a":1,"b":[1,2,{"c":"x"}],"d":{"e":null}})";
+  uint64_t id = store.Add("c", "A", 0, json);
+  CHECK(id != 0);
+  std::string out;
+  CHECK(store.Materialize(id, out));
+  CHECK_EQ(out, json);
+  CHECK(!store.Materialize(id + 1, out));
+}
+
+TEST(RejectsMalformedJson) {
+  SnapshotStore store;
+  CHECK_EQ(store.Add("c", "", 0, "{\"a\":"), 0u);
+  CHECK_EQ(store.Add("c", "", 0, "[1,2]x"), 0u);
+  CHECK_EQ(store.Stats().snapshots, 0u);
+}
+
+TEST(DiffsReportPathsAndKinds) {
+  SnapshotStore store;
+  uint64_t from = store.Add("c", "A", 0, R"({"a":1,"b":[1,2,{"c":"x"}],"d":{"e":null}})");
+  uint64_t to = store.Add("c", "B", 0, R"({"a":2,"b":[1,2,{"c":"y"},4],"f":true})");
+  std::vector<SnapshotChange> changes;
+  CHECK(store.Diff(from, to, changes));
+  CHECK_EQ(changes.size(), 4u);
+
+  auto a = FindChange(changes, "a");
+  CHECK(a && a->kind == SnapshotChangeKind::Changed && a->value == "2");
+  // An array that changed length is reported whole
+  auto b = FindChange(changes, "b");
+  CHECK(b && b->kind == SnapshotChangeKind::Changed && b->value == R"([1,2,{"c":"y"},4])");
+  auto removed = FindChange(changes, "d");
+  CHECK(removed && removed->kind == SnapshotChangeKind::Removed && removed->value.empty());
+  auto f = FindChange(changes, "f");
+  CHECK(f && f->kind == SnapshotChangeKind::Added && f->value == "true");
+
+  CHECK(!store.Diff(from, to + 1, changes));
+}
+
+TEST(SharesUnchangedSubtrees) {
+  for (size_t entities : {63, 1000}) {
+    std::mt19937_64 rng(42);
+    TodoState state(entities, rng);
+    SnapshotStore store;
+    std::vector<uint64_t> ids;
+    std::vector<std::string> jsons;
+    for (int action = 0; action < 300; ++action) {
+      state.Act(rng);
+      jsons.push_back(state.Json());
+      ids.push_back(store.Add("c1", "ACTION", action, jsons.back()));
+      CHECK(ids.back() != 0);
+    }
+
+    auto stats = store.Stats();
+    CHECK_EQ(stats.snapshots, 300u);
+    CHECK(stats.storedBytes * 4 < stats.logicalBytes);
+
+    std::string out;
+    for (size_t i = 0; i < ids.size(); i += 37) {
+      CHECK(store.Materialize(ids[i], out));
+      CHECK(out == jsons[i]);
+    }
+
+    // Each action changed exactly one value
+    std::vector<SnapshotChange> changes;
+    for (size_t i = 1; i < ids.size(); i += 13) {
+      CHECK(store.Diff(ids[i - 1], ids[i], changes));
+      CHECK_EQ(changes.size(), 1u);
+    }
+
+    for (auto id : ids) CHECK(store.Remove(id));
+    stats = store.Stats();
+    CHECK_EQ(stats.nodes, 0u);
+    CHECK_EQ(stats.pieces, 0u);
+    CHECK_EQ(stats.storedBytes, 0u);
+  }
+}
+
+TEST(EvictsTheOldestPastTheBudget) {
+  SnapshotStore store(20000, 64);
+  for (int i = 0; i < 200; ++i) {
+    store.Add("c", "", i, "{\"v\":\"" + std::string(200, static_cast<char>('a' + i % 26)) + std::to_string(i) + "\"}");
+  }
+  auto stats = store.Stats();
+  CHECK(stats.storedBytes <= 20000);
+  CHECK(stats.snapshots < 200u);
+  CHECK(stats.oldestTime > 0);
+  auto snapshots = store.Snapshots("c");
+  CHECK_EQ(snapshots.back().time, 199);
+}
+
+TEST(ShrinkKeepsTheNewest) {
+  SnapshotStore store;
+  store.Add("a", "", 1, R"({"x":1})");
+  store.Add("b", "", 2, R"({"x":2})");
+  uint64_t newest = store.Add("a", "", 3, R"({"x":3})");
+  CHECK_EQ(store.Snapshots("a").size(), 2u);
+  CHECK_EQ(store.Snapshots("").size(), 3u);
+
+  CHECK(store.Shrink(UINT64_MAX) > 0);
+  auto left = store.Snapshots("");
+  CHECK_EQ(left.size(), 1u);
+  CHECK_EQ(left[0].id, newest);
+
+  store.Clear();
+  CHECK_EQ(store.Stats().snapshots, 0u);
+}
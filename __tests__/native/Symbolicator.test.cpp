@@ -0,0 +1,296 @@
+//
+//  Symbolicator.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRSymbolicator/Symbolicator.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+using namespace reactotron;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path Directory(const char *name) {
+  fs::path directory = fs::temp_directory_path() / "reactotron-symbolicator-test" / name;
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  return directory;
+}
+
+std::string PathString(const fs::path &path) {
+  std::u8string utf8 = path.u8string();
+  return std::string(utf8.begin(), utf8.end());
+}
+
+/**
+ * A map with one mapping per generated line: line n, column 0 maps to
+ * `source` line n, or n + 10 if `shifted`, column 0 ("AACA" moves on a line).
+ */
+void WriteMap(const fs::path &path, const std::string &source, int lines, bool shifted = false) {
+  std::string mappings = shifted ? "AAUA" : "AAAA";
+  for (int i = 1; i < lines; ++i) mappings += ";AACA";
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      << "{\"version\":3,\"sources\":[\"" << source << "\"],\"names\":[],\"mappings\":\"" << mappings << "\"}";
+}
+
+std::string Describe(const SymbolicatedFrame &frame) {
+  if (!frame.resolved) return frame.error.empty() ? "-" : "error";
+  return frame.file + ":" + std::to_string(frame.line) + ":" + std::to_string(frame.column);
+}
+
+size_t CacheFiles(const fs::path &directory) {
+  size_t count = 0;
+  for (const auto &entry : fs::directory_iterator(directory)) count += entry.path().extension() == ".irsm";
+  return count;
+}
+
+} // namespace
+
+TEST(FindsMetrosMapUrl) {
+  CHECK_EQ(Symbolicator::MapUrlForBundle("http://localhost:8081/index.bundle?platform=ios&dev=true"),
+           std::string("http://localhost:8081/index.map?platform=ios&dev=true"));
+  CHECK_EQ(Symbolicator::MapUrlForBundle("https://example.test/a/main.bundle"),
+           std::string("https://example.test/a/main.map"));
+  CHECK_EQ(Symbolicator::MapUrlForBundle("http://localhost:8081/index.js"), std::string());
+  CHECK_EQ(Symbolicator::MapUrlForBundle("http://localhost:8081/index.bundle.js"), std::string());
+  CHECK_EQ(Symbolicator::MapUrlForBundle("/data/app/index.bundle"), std::string());
+}
+
+TEST(ReadsTheMapBesideALocalBundle) {
+  fs::path directory = Directory("local");
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 50);
+  std::string bundle = PathString(directory / "main.jsbundle");
+
+  Symbolicator symbolicator;
+  auto frames = symbolicator.Symbolicate({
+      {bundle, 3, 7},
+      {"file://" + bundle, 50, 0},
+      {bundle + "?platform=android", 1, 0},
+      {bundle, 51, 0}, // Past the map's lines
+      {bundle, 0, 0},  // No line: not a bundle frame
+      {"", 4, 0},
+      {PathString(directory / "other.jsbundle"), 1, 0},
+  });
+  CHECK_EQ(frames.size(), size_t(7));
+  CHECK_EQ(Describe(frames[0]), std::string("src/App.tsx:3:0"));
+  CHECK_EQ(Describe(frames[1]), std::string("src/App.tsx:50:0"));
+  CHECK_EQ(Describe(frames[2]), std::string("src/App.tsx:1:0"));
+  CHECK_EQ(Describe(frames[3]), std::string("-"));
+  CHECK_EQ(Describe(frames[4]), std::string("-"));
+  CHECK_EQ(Describe(frames[5]), std::string("-"));
+  CHECK_EQ(Describe(frames[6]), std::string("error"));
+  CHECK(frames[6].error.find("other.jsbundle.map") != std::string::npos);
+
+  auto stats = symbolicator.Stats();
+  CHECK_EQ(stats.batches, uint64_t(1));
+  CHECK_EQ(stats.frames, uint64_t(7));
+  CHECK_EQ(stats.resolved, uint64_t(3));
+  CHECK_EQ(stats.maps, size_t(3)); // The bundle under three names
+  CHECK_EQ(stats.parses, uint64_t(3));
+  CHECK_EQ(stats.loadFailures, uint64_t(1));
+  CHECK(stats.tableBytes > 0);
+
+  // Loaded maps are kept until invalidated
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 50, true);
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 3, 0}})[0]), std::string("src/App.tsx:3:0"));
+  symbolicator.Invalidate();
+  CHECK_EQ(symbolicator.Stats().maps, size_t(0));
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 3, 0}})[0]), std::string("src/App.tsx:13:0"));
+  fs::remove_all(directory);
+}
+
+TEST(UsesRegisteredMapsForUrls) {
+  fs::path directory = Directory("registered");
+  WriteMap(directory / "index.map", "index.ts", 10);
+  Symbolicator symbolicator;
+  symbolicator.RegisterMap("http://localhost:8081/index.bundle?platform=ios", PathString(directory / "index.map"));
+  auto frames = symbolicator.Symbolicate({
+      {"http://localhost:8081/index.bundle?platform=ios", 2, 0},
+      {"http://localhost:8081/index.bundle//&platform=ios", 4, 0}, // Newer React Native's query
+      {"http://10.0.2.2:8081/index.bundle?platform=android", 6, 0}, // Matched by name
+      {"http://localhost:8081/other.bundle", 1, 0},
+  });
+  CHECK_EQ(Describe(frames[0]), std::string("index.ts:2:0"));
+  CHECK_EQ(Describe(frames[1]), std::string("index.ts:4:0"));
+  CHECK_EQ(Describe(frames[2]), std::string("index.ts:6:0"));
+  CHECK_EQ(frames[3].error, std::string("Source maps can't be downloaded here"));
+
+  // Registering again replaces the loaded map
+  WriteMap(directory / "index2.map", "index2.ts", 10);
+  symbolicator.RegisterMap("http://localhost:8081/index.bundle?platform=ios", PathString(directory / "index2.map"));
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{"http://localhost:8081/index.bundle?platform=ios", 2, 0}})[0]),
+           std::string("index2.ts:2:0"));
+  fs::remove_all(directory);
+}
+
+TEST(DownloadsMapsThroughTheFetcher) {
+  fs::path directory = Directory("fetch");
+  fs::path served = directory / "served.map";
+  WriteMap(served, "fetched.ts", 10);
+  Symbolicator symbolicator;
+  symbolicator.SetCacheDirectory(PathString(directory / "cache"));
+  std::vector<std::string> urls;
+  symbolicator.SetMapFetcher([&](const std::string &url, const std::string &path, Symbolicator::MapDownload &download) {
+    urls.push_back(url);
+    if (url.find("missing") != std::string::npos) {
+      download.error = "404 Not Found";
+      return false;
+    }
+    if (url.find("silent") != std::string::npos) return false;
+    fs::copy_file(served, fs::path(std::u8string(path.begin(), path.end())));
+    return true;
+  });
+
+  auto frames = symbolicator.Symbolicate({
+      {"http://localhost:8081/index.bundle?platform=ios", 5, 0},
+      {"http://localhost:8081/index.bundle?platform=ios", 6, 0},
+      {"http://localhost:8081/missing.bundle", 1, 0},
+      {"http://localhost:8081/silent.bundle", 1, 0},
+      {"http://localhost:8081/index.js", 1, 0},
+  });
+  CHECK_EQ(Describe(frames[0]), std::string("fetched.ts:5:0"));
+  CHECK_EQ(Describe(frames[1]), std::string("fetched.ts:6:0"));
+  CHECK_EQ(frames[2].error, std::string("404 Not Found"));
+  CHECK_EQ(frames[3].error, std::string("Couldn't download http://localhost:8081/silent.map"));
+  CHECK(frames[4].error.find("No source map") != std::string::npos);
+  CHECK(urls == std::vector<std::string>({"http://localhost:8081/index.map?platform=ios",
+                                          "http://localhost:8081/missing.map", "http://localhost:8081/silent.map"}));
+  // Only the table is kept
+  for (const auto &entry : fs::directory_iterator(directory / "cache")) {
+    CHECK_EQ(entry.path().extension().string(), std::string(".irsm"));
+  }
+  CHECK_EQ(CacheFiles(directory / "cache"), size_t(1));
+  fs::remove_all(directory);
+}
+
+TEST(RetriesFailedLoadsAfterAWhile) {
+  fs::path directory = Directory("retry");
+  std::string bundle = PathString(directory / "main.jsbundle");
+  Symbolicator symbolicator;
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 3, 0}})[0]), std::string("error"));
+
+  // Remembered for a while, so a storm doesn't look for it on every batch
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 5);
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 3, 0}})[0]), std::string("error"));
+  CHECK_EQ(symbolicator.Stats().loadFailures, uint64_t(1));
+
+  symbolicator.SetRetryIntervals(0, Symbolicator::kRevalidateMs);
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 3, 0}})[0]), std::string("src/App.tsx:3:0"));
+  CHECK_EQ(symbolicator.Stats().maps, size_t(1));
+  fs::remove_all(directory);
+}
+
+TEST(RevalidatesDownloadedMaps) {
+  fs::path directory = Directory("revalidate");
+  fs::path served = directory / "served.map";
+  WriteMap(served, "src/App.tsx", 20);
+  const std::string bundle = "http://localhost:8081/index.bundle?platform=ios";
+  Symbolicator symbolicator;
+  symbolicator.SetCacheDirectory(PathString(directory / "cache"));
+  symbolicator.SetRetryIntervals(Symbolicator::kFailureRetryMs, 0); // Checked on every batch
+
+  std::string etag = "\"1\"";
+  bool reachable = true;
+  std::vector<std::string> sentEtags;
+  symbolicator.SetMapFetcher([&](const std::string &, const std::string &path, Symbolicator::MapDownload &download) {
+    sentEtags.push_back(download.etag);
+    if (!reachable) return false;
+    if (!etag.empty() && download.etag == etag) {
+      download.notModified = true;
+      return true;
+    }
+    fs::copy_file(served, fs::path(std::u8string(path.begin(), path.end())));
+    download.etag = etag;
+    return true;
+  });
+
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:9:0"));
+  // Unchanged by ETag: nothing downloaded or parsed
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:9:0"));
+  CHECK(sentEtags == std::vector<std::string>({"", etag}));
+  CHECK_EQ(symbolicator.Stats().parses, uint64_t(1));
+
+  // Fast Refresh, from a server without ETags: the new content is parsed
+  etag.clear();
+  WriteMap(served, "src/App.tsx", 20, true);
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:19:0"));
+  CHECK_EQ(symbolicator.Stats().parses, uint64_t(2));
+  // The same content again keeps the table, by its hash
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:19:0"));
+  CHECK_EQ(symbolicator.Stats().parses, uint64_t(2));
+  CHECK_EQ(symbolicator.Stats().cacheHits, uint64_t(0));
+  CHECK_EQ(symbolicator.Stats().maps, size_t(1));
+
+  // Metro going away keeps the map that was working
+  reachable = false;
+  CHECK_EQ(Describe(symbolicator.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:19:0"));
+  CHECK_EQ(sentEtags.size(), size_t(5));
+  fs::remove_all(directory);
+}
+
+TEST(OpensCachedTablesInsteadOfParsing) {
+  fs::path directory = Directory("cache");
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 20);
+  std::string bundle = PathString(directory / "main.jsbundle");
+  std::string cache = PathString(directory / "tables");
+  {
+    Symbolicator first;
+    first.SetCacheDirectory(cache);
+    CHECK_EQ(Describe(first.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:9:0"));
+    CHECK_EQ(first.Stats().parses, uint64_t(1));
+    CHECK_EQ(first.Stats().cacheHits, uint64_t(0));
+  }
+  Symbolicator second;
+  second.SetCacheDirectory(cache);
+  CHECK_EQ(Describe(second.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:9:0"));
+  CHECK_EQ(second.Stats().parses, uint64_t(0));
+  CHECK_EQ(second.Stats().cacheHits, uint64_t(1));
+
+  // A changed map has another key, so it's parsed
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 20, true);
+  second.Invalidate();
+  CHECK_EQ(Describe(second.Symbolicate({{bundle, 9, 0}})[0]), std::string("src/App.tsx:19:0"));
+  CHECK_EQ(second.Stats().parses, uint64_t(1));
+  CHECK_EQ(CacheFiles(cache), size_t(2));
+  fs::remove_all(directory);
+}
+
+TEST(KeepsOnlyTheNewestCacheFiles) {
+  fs::path directory = Directory("trim");
+  std::string cache = PathString(directory / "tables");
+  Symbolicator symbolicator;
+  symbolicator.SetCacheDirectory(cache);
+  for (size_t i = 0; i < Symbolicator::kMaxCacheFiles + 3; ++i) {
+    std::string name = "bundle" + std::to_string(i);
+    WriteMap(directory / (name + ".map"), name + ".ts", 3);
+    CHECK(symbolicator.Symbolicate({{PathString(directory / name), 1, 0}})[0].resolved);
+  }
+  CHECK_EQ(CacheFiles(cache), Symbolicator::kMaxCacheFiles);
+  fs::remove_all(directory);
+}
+
+TEST(SymbolicatesOnTheExecutor) {
+  fs::path directory = Directory("async");
+  WriteMap(directory / "main.jsbundle.map", "src/App.tsx", 5);
+  std::string bundle = PathString(directory / "main.jsbundle");
+  Symbolicator symbolicator;
+  std::promise<std::vector<SymbolicatedFrame>> done;
+  symbolicator.SymbolicateAsync({{bundle, 2, 0}, {bundle, 9, 0}, {bundle, 4, 3}},
+                                [&](std::vector<SymbolicatedFrame> frames) { done.set_value(std::move(frames)); });
+  auto future = done.get_future();
+  CHECK(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+  auto frames = future.get();
+  CHECK_EQ(frames.size(), size_t(3));
+  if (frames.size() == 3) {
+    CHECK_EQ(Describe(frames[0]), std::string("src/App.tsx:2:0"));
+    CHECK_EQ(Describe(frames[1]), std::string("-"));
+    CHECK_EQ(Describe(frames[2]), std::string("src/App.tsx:4:0"));
+  }
+  fs::remove_all(directory);
+}
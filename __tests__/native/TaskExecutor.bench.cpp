@@ -0,0 +1,145 @@
+//
+//  TaskExecutor.bench.cpp
+//  Reactotron
+//
+//  How long Interactive work waits while a flood of slow Background work
+//  (2 ms each, like waiting on a process) is queued, against a plain FIFO
+//  pool of the same size; then dispatch latency and throughput when idle.
+//
+
+#include "TaskExecutor/TaskExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace reactotron;
+using namespace std::chrono_literals;
+
+namespace {
+
+uint64_t NowMicros() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/** One queue, first come first served: what the modules had before. */
+class FifoPool {
+ public:
+  explicit FifoPool(size_t threads) {
+    for (size_t i = 0; i < threads; ++i) {
+      m_threads.emplace_back([this] {
+        for (;;) {
+          std::function<void()> work;
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+            work = std::move(m_queue.front());
+            m_queue.pop_front();
+          }
+          work();
+        }
+      });
+    }
+  }
+
+  ~FifoPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.clear();
+      m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_threads) thread.join();
+  }
+
+  void Post(std::function<void()> work) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push_back(std::move(work));
+    }
+    m_wake.notify_one();
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::deque<std::function<void()>> m_queue;
+  bool m_stopping = false;
+  std::vector<std::thread> m_threads;
+};
+
+void Print(const char *name, std::vector<double> &latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+  std::printf("%-12s n=%-4zu mean %8.0f us  p50 %8.0f us  p99 %8.0f us  max %8.0f us\n", name, latencies.size(), mean,
+              latencies[latencies.size() / 2], latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)],
+              latencies.back());
+}
+
+/** Interactive latency behind queued Background work, `samples` times; `flood` queues more before each. */
+template <typename Flood, typename PostInteractive>
+std::vector<double> UnderFlood(Flood flood, PostInteractive post, size_t samples) {
+  std::vector<double> latencies;
+  for (size_t i = 0; i < samples; ++i) {
+    flood();
+    std::promise<uint64_t> started;
+    uint64_t start = NowMicros();
+    post([&started] { started.set_value(NowMicros()); });
+    latencies.push_back(static_cast<double>(started.get_future().get() - start));
+    std::this_thread::sleep_for(2ms);
+  }
+  return latencies;
+}
+
+} // namespace
+
+int main() {
+  const size_t threads = 8;
+  const int flood = 4000;
+  auto slow = [] { std::this_thread::sleep_for(2ms); };
+  {
+    TaskExecutor executor(threads);
+    for (int i = 0; i < flood; ++i) executor.Post(TaskPriority::Background, slow);
+    // 4000 tasks on half the workers outlast the samples, so once is enough
+    auto latencies = UnderFlood([] {}, [&](std::function<void()> work) { executor.Post(TaskPriority::Interactive, work); },
+                                200);
+    Print("TaskExecutor", latencies);
+  }
+  if (!std::getenv("NO_FIFO")) {
+    FifoPool pool(threads);
+    // Each sample waits out the whole flood, so a few will do
+    auto latencies = UnderFlood([&] { for (int i = 0; i < flood; ++i) pool.Post(slow); },
+                                [&](std::function<void()> work) { pool.Post(work); }, 3);
+    Print("FIFO pool", latencies);
+  }
+
+  TaskExecutor executor(threads);
+  std::vector<double> latencies;
+  for (int i = 0; i < 2000; ++i) {
+    std::promise<uint64_t> started;
+    uint64_t start = NowMicros();
+    executor.Post(TaskPriority::Interactive, [&started] { started.set_value(NowMicros()); });
+    latencies.push_back(static_cast<double>(started.get_future().get() - start));
+  }
+  Print("idle", latencies);
+
+  const int tiny = 200000;
+  std::atomic<int> done{0};
+  uint64_t start = NowMicros();
+  for (int i = 0; i < tiny; ++i) executor.Post(TaskPriority::Background, [&done] { ++done; });
+  while (done < tiny) std::this_thread::yield();
+  std::printf("throughput: %.2f M tiny tasks/s\n", tiny / static_cast<double>(NowMicros() - start));
+  return 0;
+}
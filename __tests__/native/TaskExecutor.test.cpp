@@ -0,0 +1,313 @@
+//
+//  TaskExecutor.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "TaskExecutor/TaskExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace reactotron;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr size_t kCritical = static_cast<size_t>(TaskPriority::Critical);
+constexpr size_t kInteractive = static_cast<size_t>(TaskPriority::Interactive);
+constexpr size_t kBackground = static_cast<size_t>(TaskPriority::Background);
+
+/** Polls `done` until it holds or a few seconds have passed. */
+bool WaitFor(const std::function<bool()> &done) {
+  auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+/** Records the highest value `running` reached. */
+void Raise(std::atomic<int> &running, std::atomic<int> &highest) {
+  int now = ++running;
+  int seen = highest.load();
+  while (now > seen && !highest.compare_exchange_weak(seen, now)) {
+  }
+}
+
+template <typename Result>
+TaskOutcome<Result> Run(TaskExecutor &executor, TaskPriority priority, CancellationToken token,
+                        std::function<Result(const CancellationToken &)> work) {
+  std::promise<TaskOutcome<Result>> outcome;
+  executor.Submit(priority, token, std::move(work), [&](TaskOutcome<Result> o) { outcome.set_value(std::move(o)); });
+  return outcome.get_future().get();
+}
+
+/**
+ * Holds both workers of a two-thread executor on Critical tasks. Letting one
+ * go leaves a single worker to take what was queued meanwhile, one task at a
+ * time, so the order it runs them in is the order NextLane picked.
+ */
+class HeldWorkers {
+public:
+  explicit HeldWorkers(TaskExecutor &executor) {
+    for (auto *release : {&m_releaseFirst, &m_releaseSecond}) {
+      executor.Post(TaskPriority::Critical, [this, release] {
+        ++m_blocking;
+        while (!*release) std::this_thread::sleep_for(1ms);
+      });
+    }
+    CHECK(WaitFor([&] { return m_blocking == 2; }));
+  }
+  ~HeldWorkers() { ReleaseAll(); }
+
+  void ReleaseOne() { m_releaseFirst = true; }
+  void ReleaseAll() { m_releaseFirst = m_releaseSecond = true; }
+
+  /** A task that records `value` in order(). */
+  std::function<void()> Record(int value) {
+    return [this, value] {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_order.push_back(value);
+    };
+  }
+
+  /** Waits for `count` recorded values and returns them in the order they ran. */
+  std::vector<int> Order(size_t count) {
+    CHECK(WaitFor([&] {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_order.size() == count;
+    }));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_order;
+  }
+
+private:
+  std::atomic<bool> m_releaseFirst{false}, m_releaseSecond{false};
+  std::atomic<int> m_blocking{0};
+  std::mutex m_mutex;
+  std::vector<int> m_order;
+};
+
+} // namespace
+
+TEST(SplitsTheWorkersBetweenLanes) {
+  TaskExecutor executor(4);
+  CHECK_EQ(executor.Threads(), size_t(4));
+  CHECK_EQ(executor.LaneLimit(TaskPriority::Critical), size_t(4));
+  CHECK_EQ(executor.LaneLimit(TaskPriority::Interactive), size_t(3));
+  CHECK_EQ(executor.LaneLimit(TaskPriority::Background), size_t(2));
+
+  TaskExecutor small(1);
+  CHECK_EQ(small.Threads(), size_t(2));
+  CHECK_EQ(small.LaneLimit(TaskPriority::Interactive), size_t(1));
+  CHECK_EQ(small.LaneLimit(TaskPriority::Background), size_t(1));
+  CHECK_EQ(TaskExecutor(100).Threads(), TaskExecutor::kMaxThreads);
+}
+
+TEST(HandsOnValuesErrorsAndCancellations) {
+  TaskExecutor executor(4);
+  auto value = Run<int>(executor, TaskPriority::Interactive, CancellationToken(),
+                        [](const CancellationToken &) { return 42; });
+  CHECK(value.status == TaskStatus::Completed);
+  CHECK_EQ(value.value, 42);
+
+  auto failed = Run<std::string>(executor, TaskPriority::Background, CancellationToken(),
+                                 [](const CancellationToken &) -> std::string { throw std::runtime_error("boom"); });
+  CHECK(failed.status == TaskStatus::Failed);
+  CHECK_EQ(failed.error, std::string("boom"));
+  auto unknown = Run<int>(executor, TaskPriority::Background, CancellationToken(),
+                          [](const CancellationToken &) -> int { throw 1; });
+  CHECK(unknown.status == TaskStatus::Failed);
+  CHECK_EQ(unknown.error, std::string("Unknown error"));
+
+  CancellationToken token;
+  token.Cancel();
+  bool ran = false;
+  auto cancelled = Run<int>(executor, TaskPriority::Critical, token, [&](const CancellationToken &) {
+    ran = true;
+    return 1;
+  });
+  CHECK(cancelled.status == TaskStatus::Cancelled);
+  CHECK(!ran);
+
+  // Completions run before the worker counts the task
+  CHECK(WaitFor([&] {
+    auto lanes = executor.Stats().lanes;
+    return lanes[kInteractive].completed + lanes[kBackground].failed + lanes[kCritical].cancelled == 4;
+  }));
+  auto stats = executor.Stats();
+  CHECK_EQ(stats.threads, size_t(4));
+  CHECK_EQ(stats.lanes[kInteractive].completed, uint64_t(1));
+  CHECK_EQ(stats.lanes[kBackground].failed, uint64_t(2));
+  CHECK_EQ(stats.lanes[kCritical].cancelled, uint64_t(1));
+}
+
+TEST(RunningTasksSeeTheirCancellation) {
+  TaskExecutor executor(2);
+  CancellationToken token;
+  std::atomic<bool> started{false};
+  std::promise<TaskOutcome<int>> outcome;
+  executor.Submit(
+      TaskPriority::Interactive, token,
+      [&](const CancellationToken &running) {
+        started = true;
+        int polls = 0;
+        while (!running.IsCancelled()) {
+          std::this_thread::sleep_for(1ms);
+          ++polls;
+        }
+        return polls;
+      },
+      [&](TaskOutcome<int> o) { outcome.set_value(std::move(o)); });
+  CHECK(WaitFor([&] { return started.load(); }));
+  token.Cancel();
+  auto future = outcome.get_future();
+  CHECK(future.wait_for(5s) == std::future_status::ready);
+  // It had started, so it completed, with whatever it got done
+  CHECK(future.get().status == TaskStatus::Completed);
+}
+
+TEST(CountsWhatPostedWorkThrows) {
+  TaskExecutor executor(4);
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 100; ++i) {
+    executor.Post(TaskPriority::Background, [&, i] {
+      ++ran;
+      if (i % 10 == 0) throw std::runtime_error("dropped");
+    });
+  }
+  CHECK(WaitFor([&] {
+    auto lane = executor.Stats().lanes[kBackground];
+    return lane.completed + lane.failed == 100;
+  }));
+  auto lane = executor.Stats().lanes[kBackground];
+  CHECK_EQ(ran.load(), 100);
+  CHECK_EQ(lane.completed, uint64_t(90));
+  CHECK_EQ(lane.failed, uint64_t(10));
+  CHECK_EQ(lane.queued, size_t(0));
+  CHECK_EQ(lane.running, size_t(0));
+  CHECK(lane.maxWaitMicros <= lane.totalWaitMicros);
+}
+
+TEST(KeepsLanesWithinTheirLimits) {
+  TaskExecutor executor(4);
+  std::atomic<bool> release{false};
+  std::atomic<int> background{0}, mostBackground{0}, nonCritical{0}, mostNonCritical{0};
+  for (int i = 0; i < 10; ++i) {
+    executor.Post(TaskPriority::Background, [&] {
+      Raise(background, mostBackground);
+      Raise(nonCritical, mostNonCritical);
+      while (!release) std::this_thread::sleep_for(1ms);
+      --background;
+      --nonCritical;
+    });
+    executor.Post(TaskPriority::Interactive, [&] {
+      Raise(nonCritical, mostNonCritical);
+      while (!release) std::this_thread::sleep_for(1ms);
+      --nonCritical;
+    });
+  }
+  CHECK(WaitFor([&] { return nonCritical == 3; }));
+
+  // Every lane below it is saturated, and Critical work still gets a worker
+  std::promise<void> critical;
+  executor.Post(TaskPriority::Critical, [&] { critical.set_value(); });
+  CHECK(critical.get_future().wait_for(5s) == std::future_status::ready);
+  auto stats = executor.Stats();
+  CHECK(stats.lanes[kBackground].running <= 2);
+  CHECK(stats.lanes[kInteractive].running + stats.lanes[kBackground].running <= 3);
+  CHECK(stats.lanes[kBackground].queued > 0);
+
+  release = true;
+  CHECK(WaitFor([&] {
+    auto now = executor.Stats();
+    return now.lanes[kInteractive].completed + now.lanes[kBackground].completed == 20;
+  }));
+  CHECK(mostBackground <= 2);
+  CHECK(mostNonCritical <= 3);
+}
+
+TEST(TakesTheHighestLaneFirst) {
+  TaskExecutor executor(2);
+  HeldWorkers held(executor);
+  for (int i = 0; i < 3; ++i) executor.Post(TaskPriority::Background, held.Record(200 + i));
+  for (int i = 0; i < 3; ++i) executor.Post(TaskPriority::Interactive, held.Record(100 + i));
+  for (int i = 0; i < 3; ++i) executor.Post(TaskPriority::Critical, held.Record(i));
+
+  // One worker frees up and takes everything, in lane order and then queue order
+  held.ReleaseOne();
+  CHECK(held.Order(9) == std::vector<int>({0, 1, 2, 100, 101, 102, 200, 201, 202}));
+}
+
+TEST(RunsStarvedWorkAheadOfHigherLanes) {
+  TaskExecutor executor(2);
+  HeldWorkers held(executor);
+  for (int i = 0; i < 2; ++i) executor.Post(TaskPriority::Background, held.Record(200 + i));
+  std::this_thread::sleep_for(std::chrono::microseconds(TaskExecutor::kStarvationLimitMicros) + 50ms);
+  for (int i = 0; i < 2; ++i) executor.Post(TaskPriority::Interactive, held.Record(100 + i));
+
+  held.ReleaseOne();
+  CHECK(held.Order(4) == std::vector<int>({200, 201, 100, 101}));
+  CHECK(executor.Stats().lanes[kBackground].maxWaitMicros >= TaskExecutor::kStarvationLimitMicros);
+}
+
+TEST(RunsTheLongestStarvedFirst) {
+  TaskExecutor executor(2);
+  HeldWorkers held(executor);
+  // Every front is past the limit, so the lanes take turns by how long their fronts have waited
+  for (int i = 0; i < 2; ++i) {
+    executor.Post(TaskPriority::Interactive, held.Record(100 + i));
+    std::this_thread::sleep_for(1ms);
+    executor.Post(TaskPriority::Background, held.Record(200 + i));
+    std::this_thread::sleep_for(1ms);
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(TaskExecutor::kStarvationLimitMicros) + 50ms);
+
+  held.ReleaseOne();
+  CHECK(held.Order(4) == std::vector<int>({100, 200, 101, 201}));
+}
+
+TEST(CancelsQueuedWorkWhenDestroyed) {
+  std::atomic<bool> release{false};
+  std::atomic<int> ran{0}, cancelled{0};
+  std::thread releaser;
+  {
+    TaskExecutor executor(2);
+    std::atomic<int> blocking{0};
+    for (int i = 0; i < 2; ++i) {
+      executor.Post(TaskPriority::Critical, [&] {
+        ++blocking;
+        while (!release) std::this_thread::sleep_for(1ms);
+      });
+    }
+    CHECK(WaitFor([&] { return blocking == 2; }));
+    for (int i = 0; i < 50; ++i) {
+      executor.Submit(
+          TaskPriority::Background, CancellationToken(),
+          [&](const CancellationToken &) {
+            ++ran;
+            return 0;
+          },
+          [&](TaskOutcome<int> o) {
+            if (o.status == TaskStatus::Cancelled) ++cancelled;
+          });
+    }
+    // The destructor waits for the blocking tasks, so let them go while it does
+    releaser = std::thread([&] {
+      std::this_thread::sleep_for(20ms);
+      release = true;
+    });
+  }
+  releaser.join();
+  CHECK_EQ(ran.load(), 0);
+  CHECK_EQ(cancelled.load(), 50);
+}
@@ -0,0 +1,39 @@
+//
+//  TerminalStream.bench.cpp
+//  Reactotron
+//
+//  A build log's worth of colored output, progress lines redrawn with \r, fed
+//  in pipe-sized reads into a 4 MB scrollback.
+//
+
+#include "IRRunShellCommand/TerminalStream.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace reactotron;
+
+int main() {
+  std::string output;
+  for (int i = 0; output.size() < (32u << 20); i++) {
+    output += "\x1b[32m✓\x1b[0m compiled \x1b[1mmodule_" + std::to_string(i) + "\x1b[22m in " +
+              std::to_string(i % 900) + " ms\n";
+    if (i % 20 == 0) output += "\r[" + std::string(i % 40, '=') + ">]\r\x1b[K";
+  }
+
+  TerminalScrollback scrollback(4 * 1024 * 1024);
+  TerminalStreamParser parser;
+  constexpr size_t kReadSize = 16 * 1024;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t position = 0; position < output.size(); position += kReadSize) {
+    parser.Feed(output.data() + position, std::min(kReadSize, output.size() - position), scrollback);
+  }
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::printf("%.1f MB in %.0f ms, %.0f MB/s; kept lines [%llu, %llu)\n", output.size() / 1e6, seconds * 1e3,
+              output.size() / seconds / 1e6, static_cast<unsigned long long>(scrollback.FirstLine()),
+              static_cast<unsigned long long>(scrollback.EndLine()));
+  return 0;
+}
@@ -0,0 +1,159 @@
+//
+//  TerminalStream.test.cpp
+//  Reactotron
+//
+//  Scrollback is compared as a dump: "[first,end)" then "|text{start,length,fg,bg,flags}"
+//  for each line, colors in hex.
+//
+
+#include "NativeTest.h"
+#include "IRRunShellCommand/TerminalStream.h"
+#include "TextTranscoding/TextTranscoding.h"
+
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+std::string Dump(const TerminalScrollback &scrollback) {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "[%llu,%llu)", static_cast<unsigned long long>(scrollback.FirstLine()),
+                static_cast<unsigned long long>(scrollback.EndLine()));
+  std::string out = buffer;
+  for (uint64_t i = scrollback.FirstLine(); i < scrollback.EndLine(); ++i) {
+    const TerminalLine *line = scrollback.Line(i);
+    out += "|" + line->text;
+    for (const auto &span : line->spans) {
+      std::snprintf(buffer, sizeof(buffer), "{%u,%u,%x,%x,%x}", span.start, span.length, span.style.foreground,
+                    span.style.background, span.style.flags);
+      out += buffer;
+    }
+  }
+  return out;
+}
+
+/** Lines are valid UTF-8 and spans are ordered, in bounds, non-empty and styled. */
+void CheckWellFormed(const TerminalScrollback &scrollback) {
+  for (uint64_t i = scrollback.FirstLine(); i < scrollback.EndLine(); ++i) {
+    const TerminalLine *line = scrollback.Line(i);
+    CHECK(IsValidUtf8(line->text.data(), line->text.size()));
+    uint32_t previousEnd = 0;
+    for (const auto &span : line->spans) {
+      CHECK(span.length > 0);
+      CHECK(span.start >= previousEnd);
+      CHECK(span.start + span.length <= line->text.size());
+      CHECK(!span.style.IsDefault());
+      previousEnd = span.start + span.length;
+    }
+  }
+}
+
+/** Feeds `input` in pieces split at `cuts` and dumps the result. */
+std::string Run(const std::string &input, const std::vector<size_t> &cuts = {}, size_t byteCap = 1 << 20) {
+  TerminalScrollback scrollback(byteCap);
+  TerminalStreamParser parser;
+  size_t position = 0;
+  for (size_t cut : cuts) {
+    parser.Feed(input.data() + position, cut - position, scrollback);
+    CheckWellFormed(scrollback);
+    position = cut;
+  }
+  parser.Feed(input.data() + position, input.size() - position, scrollback);
+  CheckWellFormed(scrollback);
+  return Dump(scrollback);
+}
+
+} // namespace
+
+TEST(SplitsLines) {
+  CHECK_EQ(Run("hello\nworld"), "[0,2)|hello|world");
+  CHECK_EQ(Run("a\tb"), "[0,1)|a       b");
+  CHECK_EQ(Run("ab\bc"), "[0,1)|ac");
+}
+
+TEST(AppliesSgrStyles) {
+  CHECK_EQ(Run("a\x1b[31mred\x1b[0m b\n"), "[0,2)|ared b{1,3,1,ffffffff,0}|");
+  CHECK_EQ(Run("\x1b[38;5;196mA\x1b[48;2;1;2;3mB\x1b[38:2::4:5:6mC"),
+           "[0,1)|ABC{0,1,c4,ffffffff,0}{1,1,c4,1010203,0}{2,1,1040506,1010203,0}");
+  CHECK_EQ(Run("\x1b[1;4mA\x1b[22mB"), "[0,1)|AB{0,1,ffffffff,ffffffff,9}{1,1,ffffffff,ffffffff,8}");
+}
+
+TEST(OverwritesOnCarriageReturn) {
+  CHECK_EQ(Run("10%\r20%\r\x1b[K30%\n"), "[0,2)|30%|");
+  CHECK_EQ(Run("abcdef\rXY"), "[0,1)|XYcdef");
+  CHECK_EQ(Run("abcdef\r\x1b[31mXY"), "[0,1)|XYcdef{0,2,1,ffffffff,0}");
+  CHECK_EQ(Run("\x1b[32mabcdef\x1b[0m\r\x1b[2CXY"), "[0,1)|abXYef{0,2,2,ffffffff,0}{4,2,2,ffffffff,0}");
+  // Columns count characters, not bytes
+  CHECK_EQ(Run("h\xc3\xa9llo\rX"), "[0,1)|X\xc3\xa9llo");
+  CHECK_EQ(Run("h\xc3\xa9llo\r\x1b[1CX"), "[0,1)|hXllo");
+}
+
+TEST(ErasesInLine) {
+  CHECK_EQ(Run("abc\x1b[2K\x1b[1Gx"), "[0,1)|x");
+  CHECK_EQ(Run("abc\x1b[2Kx"), "[0,1)|   x");
+  CHECK_EQ(Run("abcdef\x1b[3D\x1b[1K"), "[0,1)|    ef");
+}
+
+TEST(IgnoresUnsupportedSequences) {
+  CHECK_EQ(Run("\x1b]0;title\x07ok\x1b]8;;http://x\x1b\\link\x1b]8;;\x1b\\"), "[0,1)|oklink");
+  CHECK_EQ(Run("\x1b[?25lhi\x1b[?25h"), "[0,1)|hi");
+  CHECK_EQ(Run("\x1b(Bok\x1b" "c"), "[0,1)|ok");
+}
+
+TEST(ReplacesInvalidUtf8) {
+  CHECK_EQ(Run("bad\xff\xfe!"), "[0,1)|bad\xef\xbf\xbd\xef\xbf\xbd!");
+}
+
+TEST(SameResultWhereverReadsSplit) {
+  std::string input = "h\xc3\xa9l\xf0\x9f\x98\x80o \x1b[38;2;10;20;30mcol\x1b[0m\r\x1b[K\xe2\x82\xac\x1b]0;t\x1b\\z\n";
+  std::string whole = Run(input);
+  for (size_t a = 0; a <= input.size(); ++a) {
+    for (size_t b = a; b <= input.size(); ++b) CHECK_EQ(Run(input, {a, b}), whole);
+  }
+}
+
+TEST(DropsOldestLinesPastTheByteCap) {
+  TerminalScrollback scrollback(4096);
+  TerminalStreamParser parser;
+  for (int i = 0; i < 1000; ++i) {
+    std::string line = "line " + std::to_string(i) + "\n";
+    parser.Feed(line.data(), line.size(), scrollback);
+  }
+  CHECK(scrollback.ByteSize() <= 4096);
+  CHECK_EQ(scrollback.EndLine(), 1001u);
+  CHECK(scrollback.FirstLine() > 0);
+  CHECK_EQ(scrollback.Line(scrollback.EndLine() - 2)->text, "line 999");
+}
+
+TEST(TracksTheFirstChangedLine) {
+  TerminalScrollback scrollback;
+  TerminalStreamParser parser;
+  parser.Feed("a\nb\nc", 5, scrollback);
+  CHECK_EQ(scrollback.TakeFirstChangedLine(), 0u);
+  CHECK_EQ(scrollback.TakeFirstChangedLine(), 3u); // Nothing changed since
+  parser.Feed("\rd", 2, scrollback);
+  CHECK_EQ(scrollback.TakeFirstChangedLine(), 2u);
+}
+
+TEST(RandomChunkingMatchesWholeInput) {
+  const char *tokens[] = {
+    "abc", "hello world ", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xff", "\xc3", "\r", "\n", "\r\n", "\b", "\t",
+    "\x1b[31m", "\x1b[0m", "\x1b[1;38;5;200m", "\x1b[48:2::1:2:3m", "\x1b[K", "\x1b[1K", "\x1b[2K", "\x1b[5G", "\x1b[3C",
+    "\x1b[2D", "\x1b]0;x\x07", "\x1b]8;;u\x1b\\", "\x1b[?1049h", "\x1b(B", "\x1b", "\x1b[", "\x1b[999999999999m", "\x7f",
+    "\x07"};
+  std::mt19937_64 rng(42);
+  for (int iteration = 0; iteration < 3000; ++iteration) {
+    std::string input;
+    int pieces = rng() % 60;
+    bool raw = iteration % 4 == 0;
+    for (int k = 0; k < pieces; ++k) {
+      if (raw) input.push_back(static_cast<char>(rng()));
+      else input += tokens[rng() % std::size(tokens)];
+    }
+    size_t byteCap = 256 + rng() % 2048;
+    std::vector<size_t> cuts;
+    for (size_t position = 1 + rng() % 8; position < input.size(); position += 1 + rng() % 8) cuts.push_back(position);
+    CHECK_EQ(Run(input, cuts, byteCap), Run(input, {}, byteCap));
+  }
+}
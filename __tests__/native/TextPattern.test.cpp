@@ -0,0 +1,101 @@
+//
+//  TextPattern.test.cpp
+//  Reactotron
+//
+//  Matches are checked against std::regex with the same flags, over fixed
+//  patterns and texts and a fuzz of small patterns.
+//
+
+#include "NativeTest.h"
+#include "IRTimelineQuery/TextPattern.h"
+
+#include <random>
+#include <regex>
+
+using namespace reactotron;
+
+namespace {
+
+/** Compiles `pattern` both ways and checks they agree on `text`. Skips patterns std::regex rejects. */
+void CheckSameAsStdRegex(const std::string &pattern, const std::string &text) {
+  std::regex reference;
+  try {
+    reference = std::regex(pattern, std::regex::ECMAScript | std::regex::icase);
+  } catch (const std::regex_error &) {
+    return;
+  }
+  std::string error;
+  auto compiled = TextPattern::Compile(pattern, error);
+  CHECK_EQ(error, "");
+  if (!compiled) return;
+  bool expected = std::regex_search(text, reference);
+  if (compiled->Search(text) != expected) {
+    ::reactotron::test::Fail(__FILE__, __LINE__, "/" + pattern + "/ on \"" + text + "\" should be " + (expected ? "true" : "false"));
+  }
+}
+
+bool Rejects(const std::string &pattern) {
+  std::string error;
+  return !TextPattern::Compile(pattern, error) && !error.empty();
+}
+
+} // namespace
+
+TEST(AgreesWithStdRegex) {
+  const char *patterns[] = {
+    "abc", "^abc", "abc$", "^$", "a.c", "a|b|cd", "(ab)+c", "a{2,3}b", "a{2}", "a{2,}", "[a-c]+x", "[^a-c]", "\\d+",
+    "\\D", "\\w+\\s\\W", "\\bfoo\\b", "\\Bfoo", "/users/\\d+", "colou?r", "(?:ab|cd)*e", "x*", "[]a]", "a\\.b", "\\x41",
+    "\\u0041b", "[\\d_]+$", "(a|)+b", "HELLO", "[A-Z]+", "a+?b", "\\/api\\/", "[-a]", "[a-]", "\\t"};
+  const char *texts[] = {
+    "", "abc", "xabcx", "ABC", "aXc", "cd", "ababc", "aab", "aaab", "aaaab", "bbx", "ddd", "a12", "x y!", "foo bar",
+    "afoo", "/users/42", "/users/x", "color", "colour", "abcde", "e", "a]", "a.b", "axb", "A", "ab", "12_", "b", "hello",
+    "HeLLo", "/api/", "-", "\x01", "\t"};
+  for (const char *pattern : patterns) {
+    for (const char *text : texts) CheckSameAsStdRegex(pattern, text);
+  }
+}
+
+TEST(AgreesWithStdRegexOnRandomPatterns) {
+  std::mt19937 rng(3);
+  for (int i = 0; i < 5000; i++) {
+    std::string pattern;
+    for (int atoms = 1 + rng() % 6; atoms > 0; atoms--) {
+      int kind = rng() % 10;
+      if (kind < 6) pattern += "ab."[rng() % 3];
+      else if (kind < 7) pattern += "(a|b)";
+      else if (kind < 8) pattern += "[ab]";
+      else if (kind < 9) pattern += "(ab)";
+      else pattern += "^";
+      switch (rng() % 6) {
+        case 0: pattern += '*'; break;
+        case 1: pattern += '+'; break;
+        case 2: pattern += '?'; break;
+        case 3: pattern += "{1,2}"; break;
+        default: break;
+      }
+    }
+    if (rng() % 4 == 0) pattern += '$';
+    std::string text;
+    for (int length = rng() % 8; length > 0; length--) text += "abAB"[rng() % 4];
+    CheckSameAsStdRegex(pattern, text);
+  }
+}
+
+TEST(RejectsUnsupportedAndMalformedPatterns) {
+  for (const char *pattern : {"a(?=b)", "(?!x)", "(a)\\1", "(ab", "ab)", "[ab", "*a", "a**", "^*", "a{3,2}", "a{5000}",
+                              "\\", "[z-a]", "((a{1000}){1000})"}) {
+    CHECK(Rejects(pattern));
+  }
+  CHECK(Rejects(std::string(TextPattern::kMaxNesting + 4, '(') + "a" + std::string(TextPattern::kMaxNesting + 4, ')')));
+}
+
+TEST(LongTextsAndAmbiguousPatternsStayLinear) {
+  std::string error;
+  auto alternation = TextPattern::Compile("(a|b)*c", error);
+  std::string as(20000, 'a');
+  CHECK(!alternation->Search(as));
+  CHECK(alternation->Search(as + "c"));
+  CHECK(!TextPattern::Compile(".*x", error)->Search(std::string(50000, 'y')));
+  CHECK(!TextPattern::Compile("(a*)*b", error)->Search(std::string(50000, 'a')));
+  CHECK(!TextPattern::Compile("(x+x+)+y", error)->Search(std::string(5000, 'x')));
+}
@@ -0,0 +1,63 @@
+//
+//  TextTranscoding.bench.cpp
+//  Reactotron
+//
+//  64 MB of relay-style JSON lines with some accented text mixed in, against a
+//  byte-at-a-time loop that only handles valid input.
+//
+
+#include "TextTranscoding/TextTranscoding.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace reactotron;
+
+int main() {
+  std::string text;
+  for (int i = 0; text.size() < (64u << 20); i++) {
+    text += "{\"clientId\":\"abc\",\"messageId\":12345,\"payload\":{\"level\":\"debug\",\"message\":\"hello world\"}}\n";
+    if (i % 50 == 0) text += "caf\xc3\xa9 \xe2\x82\xac\n";
+  }
+  std::vector<char16_t> utf16(text.size());
+  std::vector<char> utf8(text.size() * 3);
+  auto bytes = reinterpret_cast<const unsigned char *>(text.data());
+  size_t length = text.size();
+
+  using Clock = std::chrono::steady_clock;
+  auto gbPerSecond = [&](Clock::time_point start, Clock::time_point end) {
+    return length / std::chrono::duration<double>(end - start).count() / 1e9;
+  };
+
+  for (int run = 0; run < 3; run++) {
+    auto t0 = Clock::now();
+    size_t naive = 0;
+    for (size_t i = 0; i < length;) {
+      unsigned c = bytes[i];
+      if (c < 0x80) {
+        utf16[naive++] = static_cast<char16_t>(c);
+        i++;
+      } else if (c < 0xE0) {
+        utf16[naive++] = static_cast<char16_t>(((c & 0x1F) << 6) | (bytes[i + 1] & 0x3F));
+        i += 2;
+      } else {
+        utf16[naive++] = static_cast<char16_t>(((c & 0x0F) << 12) | ((bytes[i + 1] & 0x3F) << 6) | (bytes[i + 2] & 0x3F));
+        i += 3;
+      }
+    }
+    auto t1 = Clock::now();
+    size_t units = ConvertUtf8ToUtf16(text.data(), length, utf16.data());
+    auto t2 = Clock::now();
+    size_t back = ConvertUtf16ToUtf8(utf16.data(), units, utf8.data());
+    auto t3 = Clock::now();
+    bool valid = IsValidUtf8(text.data(), length);
+    auto t4 = Clock::now();
+
+    std::printf("%s: naive 8->16 %.2f, 8->16 %.2f, 16->8 %.2f, validate %.2f GB/s (%zu %zu %zu %d)\n",
+                ActiveTranscodingKernel(), gbPerSecond(t0, t1), gbPerSecond(t1, t2), gbPerSecond(t2, t3),
+                gbPerSecond(t3, t4), naive, units, back, valid);
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+//
+//  TextTranscoding.test.cpp
+//  Reactotron
+//
+//  The vectorized kernels are checked against a byte-at-a-time decoder with the
+//  same replacement policy: each maximal invalid subsequence becomes one U+FFFD.
+//
+
+#include "NativeTest.h"
+#include "TextTranscoding/TextTranscoding.h"
+
+#include <cstring>
+#include <random>
+
+using namespace reactotron;
+
+namespace {
+
+bool IsContinuation(unsigned char byte) { return (byte & 0xC0) == 0x80; }
+
+std::u16string ReferenceUtf8ToUtf16(std::string_view text) {
+  std::u16string out;
+  auto bytes = reinterpret_cast<const unsigned char *>(text.data());
+  size_t length = text.size();
+  for (size_t i = 0; i < length;) {
+    unsigned lead = bytes[i];
+    uint32_t codePoint = 0xFFFD;
+    size_t used = 1;
+    if (lead < 0x80) {
+      codePoint = lead;
+    } else if (lead >= 0xC2 && lead < 0xE0 && i + 1 < length && IsContinuation(bytes[i + 1])) {
+      codePoint = ((lead & 0x1F) << 6) | (bytes[i + 1] & 0x3F);
+      used = 2;
+    } else if (lead >= 0xE0 && lead < 0xF0 && i + 2 < length) {
+      unsigned low = lead == 0xE0 ? 0xA0 : 0x80, high = lead == 0xED ? 0x9F : 0xBF;
+      if (bytes[i + 1] >= low && bytes[i + 1] <= high && IsContinuation(bytes[i + 2])) {
+        codePoint = ((lead & 0x0F) << 12) | ((bytes[i + 1] & 0x3F) << 6) | (bytes[i + 2] & 0x3F);
+        used = 3;
+      }
+    } else if (lead >= 0xF0 && lead < 0xF5 && i + 3 < length) {
+      unsigned low = lead == 0xF0 ? 0x90 : 0x80, high = lead == 0xF4 ? 0x8F : 0xBF;
+      if (bytes[i + 1] >= low && bytes[i + 1] <= high && IsContinuation(bytes[i + 2]) && IsContinuation(bytes[i + 3])) {
+        codePoint = ((lead & 0x07) << 18) | ((bytes[i + 1] & 0x3F) << 12) | ((bytes[i + 2] & 0x3F) << 6) |
+                    (bytes[i + 3] & 0x3F);
+        used = 4;
+      }
+    }
+    i += used;
+    if (codePoint >= 0x10000) {
+      codePoint -= 0x10000;
+      out += static_cast<char16_t>(0xD800 + (codePoint >> 10));
+      out += static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+    } else {
+      out += static_cast<char16_t>(codePoint);
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(DecodesValidAndInvalidSamples) {
+  const char *samples[] = {
+    "hello",
+    "h\xc3\xa9llo w\xc3\xb6rld \xe2\x82\xac \xf0\x9f\x98\x80",
+    "\xed\xa0\x80",     // Encoded surrogate
+    "\xc0\xaf",         // Overlong
+    "\xf4\x90\x80\x80", // Past U+10FFFF
+    "\xe2\x82",         // Truncated
+  };
+  for (const char *sample : samples) {
+    std::string text = sample;
+    auto utf16 = Utf8ToUtf16(text);
+    CHECK(utf16 == ReferenceUtf8ToUtf16(text));
+    CHECK_EQ(utf16.size(), Utf16LengthForUtf8(text.data(), text.size()));
+  }
+}
+
+TEST(ValidatesUtf8) {
+  const char *text = "h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80";
+  CHECK(IsValidUtf8(text, std::strlen(text)));
+  CHECK(!IsValidUtf8("\xed\xa0\x80", 3));
+  CHECK(!IsValidUtf8("\xc0\xaf", 2));
+}
+
+TEST(FindsIncompleteTails) {
+  CHECK_EQ(Utf8IncompleteTailLength("ab\xe2\x82", 4), 2u);
+  CHECK_EQ(Utf8IncompleteTailLength("ab\xf0", 3), 1u);
+  CHECK_EQ(Utf8IncompleteTailLength("ab\xe2\x82\xac", 5), 0u);
+  // Already invalid, so there's nothing to wait for
+  CHECK_EQ(Utf8IncompleteTailLength("ab\xed\xa0", 4), 0u);
+  CHECK_EQ(Utf8IncompleteTailLength("\x80\x80", 2), 0u);
+}
+
+TEST(MatchesReferenceOnRandomText) {
+  std::mt19937 rng(42);
+  const char *multibyte[] = {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xe4\xb8\xad"};
+  for (int iteration = 0; iteration < 5000; iteration++) {
+    size_t length = rng() % 200;
+    std::string text;
+    for (size_t i = 0; i < length; i++) {
+      int kind = rng() % 10;
+      if (kind < 6) text += static_cast<char>('a' + rng() % 26);
+      else if (kind < 8) text += multibyte[rng() % 4];
+      else text += static_cast<char>(rng() % 256);
+    }
+
+    auto utf16 = Utf8ToUtf16(text);
+    auto expected = ReferenceUtf8ToUtf16(text);
+    CHECK(utf16 == expected);
+    CHECK_EQ(Utf16LengthForUtf8(text.data(), text.size()), utf16.size());
+
+    // The generator never writes a real U+FFFD, so any in the output came from invalid bytes
+    bool valid = expected.find(u'\xFFFD') == std::u16string::npos;
+    CHECK_EQ(IsValidUtf8(text.data(), text.size()), valid);
+    auto roundTrip = Utf16ToUtf8(utf16);
+    if (valid) CHECK(roundTrip == text);
+    CHECK(Utf8ToUtf16(roundTrip) == utf16);
+
+    // Lone surrogates encode as U+FFFD, so the result is always valid
+    std::u16string randomUtf16;
+    for (size_t i = 0; i < length; i++) {
+      randomUtf16 += static_cast<char16_t>(rng() % 3 ? 'a' + rng() % 26 : rng() % 65536);
+    }
+    auto utf8 = Utf16ToUtf8(randomUtf16);
+    CHECK(IsValidUtf8(utf8.data(), utf8.size()));
+    CHECK_EQ(utf8.size(), Utf8LengthForUtf16(randomUtf16.data(), randomUtf16.size()));
+  }
+}
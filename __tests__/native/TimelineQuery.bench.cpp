@@ -0,0 +1,84 @@
+//
+//  TimelineQuery.bench.cpp
+//  Reactotron
+//
+//  A million timeline rows, queried on one and four threads, then 1000 new
+//  rows evaluated incrementally. Takes the row count as an optional argument.
+//
+
+#include "IRTimelineQuery/TimelineQuery.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const char *types[] = {"log", "api.response", "state.action.complete", "benchmark.report", "display"};
+  const char *levels[] = {"debug", "warn", "error"};
+  const char *methods[] = {"GET", "POST", "PUT"};
+  const int statuses[] = {200, 201, 304, 400, 404, 500};
+  std::mt19937 rng(7);
+
+  TimelineColumns columns;
+  std::string url;
+  auto start = Clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    TimelineRow row{};
+    for (double &number : row.numbers) number = NAN;
+    row.strings[0] = types[rng() % 5];
+    if (row.strings[0] == "log") row.strings[1] = levels[rng() % 3];
+    if (row.strings[0] == "api.response") {
+      url = "https://api.example.com/users/" + std::to_string(rng() % 5000) + (rng() % 2 ? "/posts" : "");
+      row.strings[2] = url;
+      row.strings[3] = methods[rng() % 3];
+      row.numbers[0] = statuses[rng() % 6];
+      row.numbers[1] = rng() % 2000;
+    }
+    row.strings[5] = rng() % 2 ? "client-a" : "client-b";
+    row.numbers[2] = 1.76e12 + i * 10.0;
+    columns.Append(row);
+  }
+  std::printf("append %zu rows: %.1f ms, %.1f MB\n", count, MsSince(start), columns.ByteSize() / 1e6);
+
+  for (const char *source : {"type:api.response status>=400 url~\"/users/\\d+$\" duration>500",
+                             "level:error OR (type:benchmark -name:startup)", "duration>=1.5s client:B"}) {
+    std::string error;
+    std::vector<uint32_t> matches;
+    start = Clock::now();
+    TimelineQuery::Compile(source, error)->Evaluate(columns, matches, 1);
+    double oneThread = MsSince(start);
+    matches.clear();
+    start = Clock::now();
+    TimelineQuery::Compile(source, error)->Evaluate(columns, matches, 4);
+    std::printf("%-64s %7zu matches, 1 thread %6.2f ms, 4 threads %6.2f ms\n", source, matches.size(), oneThread,
+                MsSince(start));
+  }
+
+  std::string error;
+  auto query = TimelineQuery::Compile("type:log level:error", error);
+  std::vector<uint32_t> matches;
+  query->Evaluate(columns, matches);
+  TimelineRow row{};
+  row.strings[0] = "log";
+  row.strings[1] = "error";
+  for (double &number : row.numbers) number = NAN;
+  for (int i = 0; i < 1000; ++i) columns.Append(row);
+  start = Clock::now();
+  query->Evaluate(columns, matches);
+  std::printf("1000 new rows: %.3f ms\n", MsSince(start));
+  return 0;
+}
@@ -0,0 +1,240 @@
+//
+//  TimelineQuery.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRTimelineQuery/TimelineQuery.h"
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <regex>
+
+using namespace reactotron;
+
+namespace {
+
+struct Item {
+  std::string strings[kTimelineStringFields];
+  double numbers[kTimelineNumberFields] = {NAN, NAN, NAN};
+
+  TimelineRow Row() const {
+    TimelineRow row;
+    for (size_t i = 0; i < kTimelineStringFields; i++) row.strings[i] = strings[i];
+    for (size_t i = 0; i < kTimelineNumberFields; i++) row.numbers[i] = numbers[i];
+    return row;
+  }
+  const std::string &String(TimelineField field) const { return strings[static_cast<size_t>(field)]; }
+  double Number(TimelineField field) const {
+    return numbers[static_cast<size_t>(field) - kTimelineStringFields];
+  }
+};
+
+std::vector<Item> MakeItems(size_t count) {
+  const char *types[] = {"log", "api.response", "state.action.complete", "benchmark.report", "display"};
+  const char *levels[] = {"debug", "warn", "error"};
+  const char *methods[] = {"GET", "POST", "PUT"};
+  const int statuses[] = {200, 201, 304, 400, 404, 500};
+  std::mt19937 rng(7);
+  std::vector<Item> items(count);
+  for (size_t i = 0; i < count; ++i) {
+    Item &item = items[i];
+    auto &s = item.strings;
+    auto &n = item.numbers;
+    s[0] = types[rng() % 5];
+    if (s[0] == "log") s[1] = levels[rng() % 3];
+    if (s[0] == "api.response") {
+      s[2] = "https://api.example.com/users/" + std::to_string(rng() % 5000) + (rng() % 2 ? "/posts" : "");
+      s[3] = methods[rng() % 3];
+      n[0] = statuses[rng() % 6];
+      n[1] = rng() % 2000;
+    }
+    if (s[0] == "benchmark.report") {
+      s[4] = rng() % 2 ? "startup" : "render";
+      n[1] = rng() % 1000;
+    }
+    s[5] = rng() % 2 ? "client-a" : "client-b";
+    n[2] = 1.76e12 + i * 10.0;
+  }
+  return items;
+}
+
+std::string Lower(std::string text) {
+  for (auto &c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return text;
+}
+
+bool Has(const std::string &value, const char *part) { return Lower(value).find(part) != std::string::npos; }
+
+} // namespace
+
+TEST(EvaluatesLikeARowAtATimeFilter) {
+  using F = TimelineField;
+  std::regex users("/users/\\d+$", std::regex::icase);
+  struct Case {
+    const char *query;
+    std::function<bool(const Item &)> matches;
+  };
+  std::vector<Case> cases = {
+    {"type:api.response status>=400 url~\"/users/\\d+$\" duration>500",
+     [&](const Item &i) {
+       return Has(i.String(F::Type), "api.response") && i.Number(F::Status) >= 400 &&
+              std::regex_search(i.String(F::Url), users) && i.Number(F::Duration) > 500;
+     }},
+    {"level:error OR (type:benchmark -name:startup)",
+     [](const Item &i) {
+       return Has(i.String(F::Level), "error") || (Has(i.String(F::Type), "benchmark") && !Has(i.String(F::Name), "startup"));
+     }},
+    {"NOT type=log method!=get",
+     [](const Item &i) { return i.String(F::Type) != "log" && !i.String(F::Method).empty() && Lower(i.String(F::Method)) != "get"; }},
+    {"duration>=1.5s client:B", [](const Item &i) { return i.Number(F::Duration) >= 1500 && Has(i.String(F::Client), "b"); }},
+    {"status:404 OR status:500 OR status<201",
+     [](const Item &i) { return i.Number(F::Status) == 404 || i.Number(F::Status) == 500 || i.Number(F::Status) < 201; }},
+    {"time>=2025-10-09T09:00:00Z", [](const Item &i) { return i.Number(F::Time) >= 1760000400000.0; }},
+  };
+
+  // Enough rows that evaluation goes parallel
+  auto items = MakeItems(TimelineQuery::kParallelRows * 2 + 1234);
+  TimelineColumns columns;
+  for (const auto &item : items) columns.Append(item.Row());
+
+  std::mt19937 rng(11);
+  for (const auto &testCase : cases) {
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < items.size(); ++i) {
+      if (testCase.matches(items[i])) expected.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::string error;
+    auto oneThread = TimelineQuery::Compile(testCase.query, error);
+    CHECK_EQ(error, "");
+    if (!oneThread) continue;
+    std::vector<uint32_t> matches;
+    oneThread->Evaluate(columns, matches, 1);
+    CHECK(matches == expected);
+
+    matches.clear();
+    TimelineQuery::Compile(testCase.query, error)->Evaluate(columns, matches, 4);
+    CHECK(matches == expected);
+
+    // Rows arriving in batches, evaluated as they come
+    auto incremental = TimelineQuery::Compile(testCase.query, error);
+    TimelineColumns growing;
+    matches.clear();
+    for (size_t next = 0; next < items.size();) {
+      bool first = next == 0;
+      size_t end = std::min(items.size(), next + 1 + rng() % 70000);
+      for (; next < end; ++next) growing.Append(items[next].Row());
+      CHECK(incremental->Evaluate(growing, matches) || first);
+    }
+    CHECK(matches == expected);
+  }
+}
+
+TEST(StartsOverAfterTheColumnsAreCleared) {
+  auto items = MakeItems(1000);
+  TimelineColumns columns;
+  for (const auto &item : items) columns.Append(item.Row());
+  std::string error;
+  auto query = TimelineQuery::Compile("type:log", error);
+  std::vector<uint32_t> matches;
+  query->Evaluate(columns, matches);
+  CHECK(!matches.empty());
+  CHECK(query->Evaluate(columns, matches));
+
+  columns.Clear();
+  matches.clear();
+  CHECK(!query->Evaluate(columns, matches));
+  CHECK(matches.empty());
+}
+
+TEST(KeepsRowNumbersWhenOldRowsAreDropped) {
+  auto items = MakeItems(3000);
+  const char *source = "type:api.response status>=400 url~\"/posts$\"";
+  auto expected = [&](size_t begin, size_t end) {
+    std::vector<uint32_t> rows;
+    for (size_t i = begin; i < end; ++i) {
+      const Item &item = items[i];
+      if (item.String(TimelineField::Type) == "api.response" && item.Number(TimelineField::Status) >= 400 &&
+          item.String(TimelineField::Url).size() >= 6 &&
+          item.String(TimelineField::Url).compare(item.String(TimelineField::Url).size() - 6, 6, "/posts") == 0) {
+        rows.push_back(static_cast<uint32_t>(i));
+      }
+    }
+    return rows;
+  };
+
+  TimelineColumns columns;
+  for (size_t i = 0; i < 1000; ++i) columns.Append(items[i].Row());
+  std::string error;
+  auto query = TimelineQuery::Compile(source, error);
+  std::vector<uint32_t> matches;
+  query->Evaluate(columns, matches);
+  CHECK(matches == expected(0, 1000));
+
+  size_t urls = columns.StringValues(static_cast<size_t>(TimelineField::Url)).size();
+  size_t bytes = columns.ByteSize();
+  CHECK_EQ(columns.DropBefore(600), size_t(600));
+  CHECK_EQ(columns.FirstRow(), uint32_t(600));
+  CHECK_EQ(columns.Rows(), size_t(400));
+  CHECK(columns.StringValues(static_cast<size_t>(TimelineField::Url)).size() < urls);
+  CHECK(columns.ByteSize() < bytes);
+  CHECK_EQ(columns.DropBefore(600), size_t(0));
+
+  // New rows go on from where the numbers were, and the query carries on with them
+  for (size_t i = 1000; i < 2000; ++i) CHECK_EQ(columns.Append(items[i].Row()), uint32_t(i));
+  matches.clear();
+  CHECK(query->Evaluate(columns, matches));
+  CHECK(matches == expected(1000, 2000));
+
+  // A query compiled now sees only the rows still held
+  matches.clear();
+  TimelineQuery::Compile(source, error)->Evaluate(columns, matches);
+  CHECK(matches == expected(600, 2000));
+
+  // Rows dropped before they were evaluated are skipped
+  for (size_t i = 2000; i < 3000; ++i) columns.Append(items[i].Row());
+  CHECK_EQ(columns.DropBefore(2500), size_t(1900));
+  matches.clear();
+  CHECK(query->Evaluate(columns, matches));
+  CHECK(matches == expected(2500, 3000));
+
+  // Shrinking drops from the oldest end too
+  CHECK_EQ(columns.OldestTime(), static_cast<int64_t>(items[2500].Number(TimelineField::Time)));
+  bytes = columns.ByteSize();
+  uint64_t freed = columns.Shrink(bytes / 2);
+  CHECK(freed > 0);
+  CHECK_EQ(columns.ByteSize(), bytes - freed);
+  CHECK(columns.FirstRow() > 2500);
+  CHECK_EQ(columns.EndRow(), uint32_t(3000));
+
+  columns.Clear();
+  CHECK_EQ(columns.FirstRow(), uint32_t(0));
+  CHECK_EQ(columns.Append(items[0].Row()), uint32_t(0));
+}
+
+TEST(RejectsMalformedQueries) {
+  for (const char *source : {"status>abc", "url>3", "status~4", "(foo)", "a OR b", "url:\"x", "type:log OR foo",
+                             "(type:log", "type:log)", "url~\"(\"", "--x", "()", "NOT"}) {
+    std::string error;
+    CHECK(!TimelineQuery::Compile(source, error));
+    CHECK(!error.empty());
+  }
+  std::string error;
+  TimelineQuery::Compile("url~\"(a\"", error);
+  CHECK(error.rfind("Invalid regex (a: ", 0) == 0);
+}
+
+TEST(SplitsOutFreeText) {
+  for (const char *source : {"", "unknown:x", "-type:log", "NOT (level:error OR level:warn)", "duration<20ms time<2026-01-01"}) {
+    std::string error;
+    CHECK(TimelineQuery::Compile(source, error) != nullptr);
+  }
+  std::string error;
+  auto query = TimelineQuery::Compile("Foo type:log \"two words\" -bar", error);
+  CHECK(query && query->HasTerms());
+  if (query) CHECK((query->Text() == std::vector<std::string>{"foo", "two words", "-bar"}));
+  query = TimelineQuery::Compile("foo -bar", error);
+  CHECK(query && !query->HasTerms());
+}
@@ -0,0 +1,45 @@
+//
+//  Uuid7.bench.cpp
+//  Reactotron
+//
+//  UUIDv7s made a batch at a time and one at a time, against fetching the
+//  random bits from the OS for every ID.
+//
+
+#include "IRIds/Uuid7.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace reactotron;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double NsPer(Clock::time_point start, size_t count) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(count);
+}
+
+} // namespace
+
+int main() {
+  Uuid7Generator generator;
+  const size_t count = 2'000'000;
+  std::string out;
+  out.reserve(count * Uuid7Generator::kStringLength);
+  auto start = Clock::now();
+  generator.Append(out, count);
+  std::printf("batched:               %.1f ns/id\n", NsPer(start, count));
+
+  size_t length = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < 200000; ++i) length += generator.Next().size();
+  std::printf("one at a time:         %.1f ns/id\n", NsPer(start, 200000));
+
+  uint8_t bytes[16];
+  start = Clock::now();
+  for (size_t i = 0; i < 200000; ++i) SecureRandomBytes(bytes, sizeof(bytes));
+  std::printf("OS random bytes per id: %.1f ns/id\n", NsPer(start, 200000));
+  return length == 0;
+}
@@ -0,0 +1,65 @@
+//
+//  Uuid7.test.cpp
+//  Reactotron
+//
+
+#include "NativeTest.h"
+#include "IRIds/Uuid7.h"
+
+#include <cstring>
+#include <set>
+
+using namespace reactotron;
+
+namespace {
+
+uint64_t TimeOf(const uint8_t bytes[16]) {
+  uint64_t ms = 0;
+  for (int i = 0; i < 6; ++i) ms = ms << 8 | bytes[i];
+  return ms;
+}
+
+} // namespace
+
+TEST(Uuid7sAreWellFormedOrderedAndUnique) {
+  Uuid7Generator generator;
+  std::string batch;
+  generator.Append(batch, 20000);
+  CHECK_EQ(batch.size(), size_t(20000) * Uuid7Generator::kStringLength);
+  std::set<std::string> seen;
+  std::string previous;
+  for (size_t i = 0; i < 20000; ++i) {
+    std::string id = batch.substr(i * 36, 36);
+    CHECK(id[8] == '-' && id[13] == '-' && id[18] == '-' && id[23] == '-');
+    CHECK_EQ(id[14], '7');
+    CHECK(std::strchr("89ab", id[19]) != nullptr);
+    CHECK(id.find_first_not_of("0123456789abcdef-") == std::string::npos);
+    CHECK(id > previous);
+    previous = id;
+    seen.insert(id);
+  }
+  CHECK_EQ(seen.size(), size_t(20000));
+  CHECK(generator.Next() > previous);
+}
+
+TEST(Uuid7sCarryTheirTimeAndStayOrderedWhenTheClockGoesBack) {
+  Uuid7Generator generator;
+  uint8_t bytes[16];
+  generator.Next(bytes, 1'760'000'123'456);
+  CHECK_EQ(TimeOf(bytes), uint64_t(1'760'000'123'456));
+
+  uint8_t last[16];
+  generator.Next(last, 1'760'000'200'000);
+  for (int i = 0; i < 10000; ++i) {
+    generator.Next(bytes, 1'760'000'100'000);
+    CHECK(std::memcmp(bytes, last, 16) > 0);
+    std::memcpy(last, bytes, 16);
+  }
+  // 10000 IDs overflow the 12-bit counter, so they borrow later milliseconds
+  CHECK(TimeOf(last) > 1'760'000'200'000);
+
+  char text[Uuid7Generator::kStringLength];
+  uint8_t known[16] = {0x01, 0x9a, 0x23, 0x45, 0x67, 0x89, 0x7a, 0xbc, 0x8d, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab};
+  Uuid7Generator::Format(known, text);
+  CHECK_EQ(std::string(text, sizeof(text)), "019a2345-6789-7abc-8def-0123456789ab");
+}
@@ -0,0 +1,166 @@
+const { RelayStats, LatencyHistogram } = require("../relay-stats")
+
+function standInSocket({ readyState = 1, error = null } = {}) {
+  return {
+    readyState,
+    bufferedAmount: 0,
+    texts: [],
+    send(text, callback) {
+      this.texts.push(text)
+      callback(error)
+    },
+  }
+}
+
+describe("LatencyHistogram", () => {
+  test("bounds each percentile from above, within a quarter", () => {
+    const histogram = new LatencyHistogram()
+    const samples = []
+    for (let i = 1; i <= 10000; i++) {
+      const us = (i * 7919) % 200000
+      samples.push(us)
+      histogram.record(us)
+    }
+    samples.sort((a, b) => a - b)
+    for (const fraction of [0.5, 0.9, 0.99]) {
+      const exact = samples[Math.ceil(samples.length * fraction) - 1] / 1000
+      const estimate = histogram.percentile(fraction)
+      expect(estimate).toBeGreaterThanOrEqual(exact)
+      expect(estimate).toBeLessThanOrEqual(exact * 1.25)
+    }
+    const max = samples[samples.length - 1] / 1000
+    expect(histogram.summary()).toMatchObject({ count: 10000, max })
+  })
+
+  test("never reports more than the largest sample", () => {
+    const histogram = new LatencyHistogram()
+    histogram.record(1000)
+    expect(histogram.percentile(0.5)).toBe(1)
+    expect(histogram.percentile(0.99)).toBe(1)
+  })
+
+  test("reads zero when empty or reset", () => {
+    const histogram = new LatencyHistogram()
+    expect(histogram.summary()).toEqual({ count: 0, p50: 0, p90: 0, p99: 0, max: 0 })
+    histogram.record(500)
+    histogram.reset()
+    expect(histogram.summary()).toEqual({ count: 0, p50: 0, p90: 0, p99: 0, max: 0 })
+  })
+})
+
+describe("RelayStats", () => {
+  test("counts a client's messages forwarded to an app", () => {
+    const stats = new RelayStats()
+    const clientSocket = standInSocket()
+    const appSocket = standInSocket()
+    const app = stats.peer(appSocket)
+    stats.subscribed(app, "app-1")
+
+    for (let i = 0; i < 10; i++) {
+      const peer = stats.peer(clientSocket)
+      stats.received(peer, 100)
+      // The client's first command ties it to the socket its message came in on
+      const client = stats.client("client-1", "My App")
+      expect(client).toBe(peer)
+      stats.send(app, "x".repeat(50), client)
+    }
+
+    const snapshot = stats.snapshot()
+    expect(snapshot.totals).toEqual({
+      messagesIn: 10,
+      bytesIn: 1000,
+      messagesOut: 10,
+      bytesOut: 500,
+      drops: 0,
+    })
+    expect(snapshot.clients).toHaveLength(1)
+    expect(snapshot.clients[0]).toMatchObject({
+      kind: "client",
+      id: "client-1",
+      name: "My App",
+      messagesIn: 10,
+      bytesIn: 1000,
+    })
+    expect(snapshot.clients[0].latency.count).toBe(10)
+    expect(snapshot.subscribers).toHaveLength(1)
+    expect(snapshot.subscribers[0]).toMatchObject({
+      kind: "subscriber",
+      id: "app-1",
+      messagesOut: 10,
+    })
+    expect(snapshot.subscribers[0].latency.count).toBe(10)
+    expect(appSocket.texts).toHaveLength(10)
+  })
+
+  test("covers only the interval since the last snapshot in rates and latencies", () => {
+    const stats = new RelayStats()
+    const app = stats.peer(standInSocket())
+    stats.subscribed(app, "app-1")
+    const client = stats.peer(standInSocket())
+    stats.received(client, 10)
+    stats.send(app, "hello", stats.client("client-1"))
+
+    const first = stats.snapshot()
+    expect(first.subscribers[0].messagesOut).toBe(1)
+    expect(first.subscribers[0].latency.count).toBe(1)
+
+    const second = stats.snapshot()
+    // Totals keep counting; rates and latencies start again
+    expect(second.totals.messagesOut).toBe(1)
+    expect(second.subscribers[0].messagesOut).toBe(1)
+    expect(second.subscribers[0].messagesOutPerSec).toBe(0)
+    expect(second.subscribers[0].latency.count).toBe(0)
+  })
+
+  test("keeps the deepest queue seen until the next snapshot", () => {
+    const stats = new RelayStats()
+    const socket = standInSocket()
+    const app = stats.peer(socket)
+    stats.subscribed(app, "app-1")
+    socket.bufferedAmount = 4096
+    stats.send(app, "a")
+    socket.bufferedAmount = 10
+
+    expect(stats.snapshot().subscribers[0]).toMatchObject({ queueDepth: 10, maxQueueDepth: 4096 })
+    expect(stats.snapshot().subscribers[0]).toMatchObject({ queueDepth: 10, maxQueueDepth: 10 })
+  })
+
+  test("counts sends to closed sockets and failed sends as drops", () => {
+    const stats = new RelayStats()
+    const closed = stats.peer(standInSocket({ readyState: 3 }))
+    const failing = stats.peer(standInSocket({ error: new Error("reset") }))
+    stats.subscribed(closed, "closed")
+    stats.subscribed(failing, "failing")
+    stats.send(closed, "a")
+    stats.send(failing, "b")
+
+    const snapshot = stats.snapshot()
+    expect(snapshot.totals.drops).toBe(2)
+    expect(snapshot.subscribers.map((peer) => peer.drops)).toEqual([1, 1])
+    // The failed send was written, so it counts as sent too
+    expect(snapshot.totals.messagesOut).toBe(1)
+  })
+
+  test("counts messages no app was there to take", () => {
+    const stats = new RelayStats()
+    const peer = stats.peer(standInSocket())
+    stats.received(peer, 10)
+    stats.unrouted(stats.client("client-1"))
+    expect(stats.snapshot().clients[0].unrouted).toBe(1)
+  })
+
+  test("forgets sockets and clients that go away", () => {
+    const stats = new RelayStats()
+    const socket = standInSocket()
+    stats.received(stats.peer(socket), 10)
+    stats.client("client-1")
+    // Known only by its commands, with no socket matched
+    stats.client("client-2")
+    expect(stats.snapshot().clients).toHaveLength(2)
+
+    stats.disconnect(socket)
+    stats.clientGone("client-2")
+    expect(stats.snapshot().clients).toHaveLength(0)
+    expect(stats.snapshot().totals.messagesIn).toBe(1)
+  })
+})
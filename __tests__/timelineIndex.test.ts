@@ -0,0 +1,133 @@
+import { CommandType } from "reactotron-core-contract"
+import type { TimelineItem } from "../app/types"
+import { getTimelineIndex } from "../app/utils/timelineIndex"
+
+let _nextId = 1
+
+function item(type: string, second: number, payload: any = {}, extra: any = {}): TimelineItem {
+  const date = new Date(Date.UTC(2026, 9, 18, 12, 0, second)).toISOString()
+  return { id: _nextId++, type, date, clientId: "c", payload, ...extra } as unknown as TimelineItem
+}
+
+const log = (second: number, level = "debug") => item(CommandType.Log, second, { level })
+const api = (second: number, status: number) =>
+  item(CommandType.ApiResponse, second, { response: { status } })
+
+function ids(items: readonly TimelineItem[]) {
+  return items.map((i) => i.id)
+}
+
+/** Items in time order, then arrival order: what the index should keep. */
+function byTime(items: readonly TimelineItem[]) {
+  return items
+    .map((entry, arrival) => ({ entry, arrival }))
+    .sort((a, b) => Date.parse(a.entry.date) - Date.parse(b.entry.date) || a.arrival - b.arrival)
+    .map(({ entry }) => entry)
+}
+
+const all = () => true
+
+describe("timelineIndex", () => {
+  test("merge-inserts late arrivals and keeps arrival order for equal times", () => {
+    const items = [log(5), log(1), log(3), log(3), log(0), log(5)]
+    let timeline: TimelineItem[] = []
+    // One at a time, as messages arrive
+    for (const entry of items) {
+      timeline = [...timeline, entry]
+      getTimelineIndex(timeline)
+    }
+    const index = getTimelineIndex(timeline)
+    const oldest = ids(index.select("time-oldest", all))
+    expect(oldest).toEqual(ids(byTime(items)))
+    expect(ids(index.select("time-newest", all))).toEqual([...oldest].reverse())
+  })
+
+  test("sorts bulk appends the same as one at a time", () => {
+    const items: TimelineItem[] = []
+    for (let i = 0; i < 1000; i++) items.push(log((i * 37) % 60))
+    // A small append, then one past the bulk threshold
+    getTimelineIndex(items.slice(0, 10))
+    const index = getTimelineIndex(items)
+    expect(ids(index.select("time-oldest", all))).toEqual(ids(byTime(items)))
+  })
+
+  test("rebuilds when the array is anything but appended to", () => {
+    const items = [log(2), log(1), log(3)]
+    getTimelineIndex(items)
+    const trimmed = items.slice(1)
+    expect(ids(getTimelineIndex(trimmed).select("time-oldest", all))).toEqual(
+      ids(byTime(trimmed)),
+    )
+    const replaced = [log(9), log(8)]
+    expect(ids(getTimelineIndex(replaced).select("time-oldest", all))).toEqual(
+      ids(byTime(replaced)),
+    )
+  })
+
+  test("groups by type, newest first within each group", () => {
+    const items = [
+      item(CommandType.Display, 1),
+      log(2),
+      api(3, 200),
+      item(CommandType.StateActionComplete, 4),
+      log(5),
+      item(CommandType.Benchmark, 6),
+      api(7, 200),
+    ]
+    const sorted = getTimelineIndex(items).select("type", all)
+    const expected = [items[4], items[1], items[6], items[2], items[5], items[0], items[3]]
+    expect(ids(sorted)).toEqual(ids(expected))
+  })
+
+  test("groups by level, most severe first and newest first within each group", () => {
+    const items = [
+      log(1, "debug"),
+      api(2, 500),
+      log(3, "warn"),
+      api(4, 302),
+      log(5, "error"),
+      item(CommandType.Display, 6),
+      api(7, 200),
+      item(CommandType.Benchmark, 8, {}, { verdict: { change: "regressed" } }),
+      log(9, "info"),
+    ]
+    const index = getTimelineIndex(items)
+    // 0: errors, 5xx and regressions; 1: warnings and redirects; 2: debug and 2xx; 3: the rest
+    const expected = [
+      items[7],
+      items[4],
+      items[1],
+      items[3],
+      items[2],
+      items[6],
+      items[0],
+      items[8],
+      items[5],
+    ]
+    expect(ids(index.select("level", all))).toEqual(ids(expected))
+    const ranks = items.map((_, position) => index.levelRank(position))
+    expect(ranks).toEqual([2, 0, 1, 1, 0, 3, 2, 0, 3])
+  })
+
+  test("hands include the position whose keys it may read", () => {
+    const items = [log(1, "error"), log(2, "debug"), log(3, "warn")]
+    const index = getTimelineIndex(items)
+    const severe = index.select("time-oldest", (_, position) => index.levelRank(position) <= 1)
+    expect(ids(severe)).toEqual(ids([items[0], items[2]]))
+  })
+
+  test("reads each item's payload once, even across rebuilds", () => {
+    let reads = 0
+    const entry = item(CommandType.Log, 1)
+    Object.defineProperty(entry, "payload", {
+      get() {
+        reads++
+        return { level: "warn" }
+      },
+    })
+    const items = [log(0), entry]
+    getTimelineIndex(items)
+    getTimelineIndex(items.slice(1))
+    expect(reads).toBe(1)
+  })
+})
@@ -5,7 +5,7 @@
  * @format
  */
 import { DevSettings, NativeModules, StatusBar, View, type ViewStyle } from "react-native"
-import { connectToServer } from "./state/connectToServer"
+import { connectToServer, replayMessages } from "./state/connectToServer"
 import { useTheme, themed } from "./theme/theme"
 import { useEffect, useMemo, useState } from "react"
 import { TimelineScreen } from "./screens/TimelineScreen"
@@ -21,6 +21,14 @@ import { PortalHost } from "./components/Portal"
 import { StateScreen } from "./screens/StateScreen"
 import { AboutModal } from "./components/AboutModal"
 import { CustomCommandsScreen } from "./screens/CustomCommandsScreen"
+import { resetLogRuns } from "./utils/logStats"
+import { finishSessionExport, importSession, startSessionExport } from "./utils/sessionArchive"
+import { releasePayloads } from "./utils/payloadArena"
+import { clearQueryRows } from "./utils/timelineQuery"
+import { clearItemHandles } from "./utils/itemHandles"
+import { startMemoryGovernor } from "./utils/memoryGovernor"
+import { startSystemHistory } from "./utils/system"
+import { startFontCatalog } from "./utils/fonts"
 
 if (__DEV__) {
   // This is for debugging Reactotron with ... Reactotron!
@@ -34,6 +42,7 @@ function App(): React.JSX.Element {
   const [activeItem, setActiveItem] = useGlobal<MenuItemId>("sidebar-active-item", "logs")
   const [, setTimelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
   const [aboutVisible, setAboutVisible] = useState(false)
+  const [sessionExportPath] = useGlobal("sessionExportPath", "")
 
   const menuConfig = useMemo(
     () => ({
@@ -103,12 +112,36 @@ function App(): React.JSX.Element {
           {
             label: "Clear Timeline Items",
             shortcut: "cmd+k",
-            action: () => setTimelineItems([]),
+            action: () => {
+              setTimelineItems((prev) => {
+                releasePayloads(prev)
+                return []
+              })
+              resetLogRuns()
+              clearQueryRows()
+              clearItemHandles()
+            },
+          },
+          {
+            label: "Export Session…",
+            shortcut: "cmd+shift+e",
+            enabled: !sessionExportPath,
+            action: () => startSessionExport().catch((error) => console.error(error)),
+          },
+          {
+            label: "Finish Session Export",
+            enabled: !!sessionExportPath,
+            action: () => finishSessionExport().catch((error) => console.error(error)),
+          },
+          {
+            label: "Import Session…",
+            shortcut: "cmd+shift+o",
+            action: () => importSession(replayMessages).catch((error) => console.error(error)),
           },
         ],
       },
     }),
-    [toggleSidebar, setActiveItem],
+    [toggleSidebar, setActiveItem, sessionExportPath],
   )
 
   useMenuItem(menuConfig)
@@ -126,6 +159,15 @@ function App(): React.JSX.Element {
   // and handle all websocket events.
   useEffect(() => connectToServer(), [])
 
+  // Keep the timeline, snapshots and task output within their memory budgets
+  useEffect(() => startMemoryGovernor(), [])
+
+  // Record memory and CPU for the session, so the system info charts can show all of it
+  useEffect(() => startSystemHistory(), [])
+
+  // Load the installed fonts in the background, so font pickers don't wait on enumeration
+  useEffect(() => startFontCatalog(), [])
+
   const renderActiveItem = () => {
     switch (activeItem) {
       case "help":
@@ -0,0 +1,332 @@
+import { useEffect, useMemo, useRef, useState } from "react"
+import {
+  Pressable,
+  ScrollView,
+  Text,
+  TextInput,
+  View,
+  type NativeScrollEvent,
+  type NativeSyntheticEvent,
+  type TextStyle,
+  type ViewStyle,
+} from "react-native"
+import { themed, useThemeName } from "../theme/theme"
+import IRBodyViewer, { BodyInfo } from "../native/IRBodyViewer/NativeIRBodyViewer"
+import type { DecodedBody } from "../native/IRBodyStore/NativeIRBodyStore"
+import { BodyRef, decodeBody } from "../utils/bodyStore"
+import { stringifySafe } from "../utils/stringifySafe"
+import { TreeViewWithProvider } from "./TreeView"
+
+// Values whose JSON is longer than this get the body viewer instead of a tree
+export const LARGE_BODY_LENGTH = 128 * 1024
+
+const LINE_HEIGHT = 18
+const VIEWER_HEIGHT = 480
+const VISIBLE_ROWS = Math.ceil(VIEWER_HEIGHT / LINE_HEIGHT)
+// Rows fetched above and below the visible ones, so scrolling a little doesn't refetch
+const OVERSCAN_ROWS = 20
+const PAGE_ROWS = VISIBLE_ROWS + OVERSCAN_ROWS * 3
+// Past this, scroll positions map to rows proportionally rather than a row per LINE_HEIGHT,
+// since native scroll views lose precision with very tall content
+const MAX_CONTENT_HEIGHT = 4_000_000
+
+/** The value as text for the body viewer, or null if it's small enough for a tree. */
+export function largeBodyText(value: unknown): string | null {
+  if (typeof value === "string") return value.length > LARGE_BODY_LENGTH ? value : null
+  if (value === null || typeof value !== "object") return null
+  const text = stringifySafe(value)
+  return text && text.length > LARGE_BODY_LENGTH ? text : null
+}
+
+/**
+ * A tree for ordinary values; a virtualized body viewer for large ones. Pass `json` when the
+ * value's JSON is already at hand, so it isn't stringified again.
+ */
+export function DataViewer({ data, json }: { data: unknown; json?: string }) {
+  const text = useMemo(() => largeBodyText(json ?? data), [data, json])
+  return text ? <BodyViewer text={text} /> : <TreeViewWithProvider data={data} />
+}
+
+/**
+ * A body the relay set aside, decoded natively when it's first shown: base64, content
+ * encodings and charsets are undone there, and binary bodies come back as a hex dump.
+ */
+export function StoredBodyViewer({ body }: { body: BodyRef }) {
+  const [decoded, setDecoded] = useState<DecodedBody | null | undefined>(undefined)
+
+  useEffect(() => {
+    let cancelled = false
+    setDecoded(undefined)
+    decodeBody(body).then((result) => {
+      if (!cancelled) setDecoded(result)
+    })
+    return () => {
+      cancelled = true
+    }
+  }, [body.$body])
+
+  // Small JSON is parsed for a tree, like any other value
+  const tree = useMemo(() => {
+    if (!decoded?.json || decoded.text.length > LARGE_BODY_LENGTH) return undefined
+    try {
+      return JSON.parse(decoded.text)
+    } catch {
+      return undefined
+    }
+  }, [decoded])
+
+  if (decoded === undefined) {
+    return <Text style={$status()}>Decoding {formatLength(body.size)}…</Text>
+  }
+  if (decoded === null) return <Text style={$status()}>No longer available</Text>
+
+  return (
+    <View>
+      {(decoded.steps.length > 0 || decoded.error !== "") && (
+        <Text style={$status()}>
+          {decoded.steps.join(" → ")}
+          {decoded.error ? `${decoded.steps.length > 0 ? " · " : ""}${decoded.error}` : ""}
+        </Text>
+      )}
+      {tree !== undefined ? (
+        <TreeViewWithProvider data={tree} />
+      ) : decoded.text.length > LARGE_BODY_LENGTH ? (
+        <BodyViewer text={decoded.text} />
+      ) : (
+        <Text style={$lineText()} selectable>
+          {decoded.text}
+        </Text>
+      )}
+    </View>
+  )
+}
+
+/**
+ * Pretty-prints a large body a page at a time. The body is indexed natively, off the JS
+ * thread; only the rows on screen are formatted and sent back. Objects and arrays fold, and
+ * search walks the whole body, unfolding whatever hides a match.
+ */
+export function BodyViewer({ text }: { text: string }) {
+  const theme = useThemeName()
+  const [info, setInfo] = useState<BodyInfo | null>(null)
+  const [rowCount, setRowCount] = useState(0)
+  const [scrollY, setScrollY] = useState(0)
+  const [revision, setRevision] = useState(0)
+  const [search, setSearch] = useState("")
+  const [matchLine, setMatchLine] = useState(-1)
+  const [notFound, setNotFound] = useState(false)
+  const scrollRef = useRef<ScrollView>(null)
+
+  useEffect(() => {
+    let bodyId = 0
+    let cancelled = false
+    setInfo(null)
+    setMatchLine(-1)
+    IRBodyViewer.open(text).then((opened) => {
+      if (cancelled) {
+        IRBodyViewer.close(opened.bodyId)
+        return
+      }
+      bodyId = opened.bodyId
+      setInfo(opened)
+      setRowCount(IRBodyViewer.getRowCount(opened.bodyId))
+    })
+    return () => {
+      cancelled = true
+      if (bodyId) IRBodyViewer.close(bodyId)
+    }
+  }, [text])
+
+  const contentHeight = Math.min(rowCount * LINE_HEIGHT, MAX_CONTENT_HEIGHT)
+  const maxScroll = Math.max(0, contentHeight - VIEWER_HEIGHT)
+  const maxFirstRow = Math.max(0, rowCount - VISIBLE_ROWS)
+  const scaled = rowCount * LINE_HEIGHT > MAX_CONTENT_HEIGHT
+  const rowAt = (y: number) =>
+    scaled ? Math.floor((y / maxScroll) * maxFirstRow) : Math.floor(y / LINE_HEIGHT)
+  const offsetOf = (row: number) =>
+    scaled ? (Math.min(row, maxFirstRow) / maxFirstRow) * maxScroll : row * LINE_HEIGHT
+
+  const firstRow = Math.min(rowAt(scrollY), maxFirstRow)
+  const startRow = Math.max(0, firstRow - OVERSCAN_ROWS)
+  // Fetching a page per OVERSCAN_ROWS step keeps small scrolls from refetching
+  const pageStart = startRow - (startRow % OVERSCAN_ROWS)
+  const rows = useMemo(
+    () => (info ? IRBodyViewer.getRows(info.bodyId, pageStart, PAGE_ROWS) : []),
+    [info, pageStart, revision],
+  )
+  // Unscaled, rows sit at their own offsets; scaled, the page follows the scroll position
+  const pageTop = scaled ? scrollY - (firstRow - pageStart) * LINE_HEIGHT : pageStart * LINE_HEIGHT
+
+  const onScroll = (event: NativeSyntheticEvent<NativeScrollEvent>) =>
+    setScrollY(event.nativeEvent.contentOffset.y)
+
+  const toggleFold = (line: number) => {
+    if (!info) return
+    const count = IRBodyViewer.toggleFold(info.bodyId, line)
+    if (count < 0) return
+    setRowCount(count)
+    setRevision((r) => r + 1)
+  }
+
+  const find = (backwards: boolean) => {
+    if (!info || !search) return
+    const from = matchLine < 0 ? 0 : backwards ? matchLine - 1 : matchLine + 1
+    if (from < 0) {
+      setNotFound(true)
+      return
+    }
+    IRBodyViewer.find(info.bodyId, search, from, backwards).then((line) => {
+      setNotFound(line < 0)
+      if (line < 0) return
+      const row = IRBodyViewer.reveal(info.bodyId, line)
+      setRowCount(IRBodyViewer.getRowCount(info.bodyId))
+      setRevision((r) => r + 1)
+      setMatchLine(line)
+      // Put the match a few rows below the top
+      const y = offsetOf(Math.max(0, row - 3))
+      scrollRef.current?.scrollTo({ y, animated: false })
+      setScrollY(y)
+    })
+  }
+
+  if (!info) return <Text style={$status()}>Formatting {formatLength(text.length)}…</Text>
+
+  return (
+    <View>
+      <View style={$toolbar()}>
+        <Text style={$status()}>
+          {info.lines.toLocaleString()} lines{info.json ? "" : ", plain text"}
+        </Text>
+        <TextInput
+          value={search}
+          placeholder="Find"
+          style={$searchInput()}
+          placeholderTextColor={theme === "dark" ? "white" : "black"}
+          onChangeText={(value) => {
+            setSearch(value)
+            setMatchLine(-1)
+            setNotFound(false)
+          }}
+          onSubmitEditing={() => find(false)}
+        />
+        <Pressable style={$button()} onPress={() => find(true)}>
+          <Text style={$buttonText()}>↑</Text>
+        </Pressable>
+        <Pressable style={$button()} onPress={() => find(false)}>
+          <Text style={$buttonText()}>↓</Text>
+        </Pressable>
+        {notFound && <Text style={$status()}>No more matches</Text>}
+      </View>
+      <ScrollView
+        ref={scrollRef}
+        style={$viewer()}
+        onScroll={onScroll}
+        scrollEventThrottle={16}
+        showsVerticalScrollIndicator={true}
+      >
+        <View style={{ height: Math.max(contentHeight, LINE_HEIGHT) }}>
+          <View style={[$page, { top: pageTop }]}>
+            {rows.map((row) => (
+              <View key={row.line} style={[$row, row.line === matchLine && $matchRow()]}>
+                <Pressable
+                  style={$gutter}
+                  disabled={!row.foldable}
+                  onPress={() => toggleFold(row.line)}
+                >
+                  <Text style={$gutterText()}>{row.foldable ? (row.folded ? "▸" : "▾") : ""}</Text>
+                </Pressable>
+                <Text style={$lineText()} numberOfLines={1}>
+                  {row.text}
+                  {row.truncated ? " …" : ""}
+                  {row.folded ? `  (${row.hiddenLines.toLocaleString()} lines)` : ""}
+                </Text>
+              </View>
+            ))}
+          </View>
+        </View>
+      </ScrollView>
+    </View>
+  )
+}
+
+function formatLength(length: number) {
+  return length >= 1024 * 1024
+    ? `${(length / (1024 * 1024)).toFixed(1)} MB`
+    : `${Math.ceil(length / 1024)} KB`
+}
+
+const $toolbar = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  gap: spacing.xs,
+  marginBottom: spacing.xs,
+}))
+
+const $status = themed<TextStyle>(({ colors, typography }) => ({
+  fontSize: typography.caption,
+  color: colors.neutral,
+}))
+
+const $searchInput = themed<TextStyle>(({ colors, typography, spacing }) => ({
+  width: 140,
+  fontSize: typography.caption,
+  backgroundColor: colors.background,
+  color: colors.mainText,
+  borderWidth: 1,
+  borderRadius: 4,
+  padding: spacing.xxs,
+}))
+
+const $button = themed<ViewStyle>(({ colors, spacing }) => ({
+  paddingHorizontal: spacing.xs,
+  borderRadius: 4,
+  backgroundColor: colors.cardBackground,
+  cursor: "pointer",
+}))
+
+const $buttonText = themed<TextStyle>(({ colors, typography }) => ({
+  fontSize: typography.caption,
+  color: colors.mainText,
+}))
+
+const $viewer = themed<ViewStyle>(({ colors }) => ({
+  height: VIEWER_HEIGHT,
+  borderWidth: 1,
+  borderColor: colors.border,
+  borderRadius: 4,
+}))
+
+const $page: ViewStyle = {
+  position: "absolute",
+  left: 0,
+  right: 0,
+}
+
+const $row: ViewStyle = {
+  flexDirection: "row",
+  height: LINE_HEIGHT,
+  alignItems: "center",
+}
+
+const $matchRow = themed<ViewStyle>(({ colors }) => ({
+  backgroundColor: colors.cardBackground,
+}))
+
+const $gutter: ViewStyle = {
+  width: 16,
+  alignItems: "center",
+  cursor: "pointer",
+}
+
+const $gutterText = themed<TextStyle>(({ colors, typography }) => ({
+  fontSize: typography.caption,
+  color: colors.neutral,
+}))
+
+const $lineText = themed<TextStyle>(({ colors, typography }) => ({
+  flex: 1,
+  fontSize: typography.caption,
+  lineHeight: LINE_HEIGHT,
+  color: colors.mainText,
+  fontFamily: typography.code.normal,
+}))
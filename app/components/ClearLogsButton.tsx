@@ -2,21 +2,20 @@ import { Button, StyleProp, View, ViewStyle } from "react-native"
 import { useGlobal, withGlobal } from "../state/useGlobal"
 import type { TimelineItem } from "../types"
 import { useCallback } from "react"
-import { useKeyboardEvents } from "../utils/system"
+import { endLogRun } from "../utils/logStats"
+import { releasePayloads } from "../utils/payloadArena"
 
 export function ClearLogsButton() {
-  useKeyboardEvents((event) => {
-    if (event.type === "keydown" && event.key === "k" && event.modifiers.cmd) {
-      clearLogs()
-    }
-  })
-
   // Using withGlobal so we don't rerender when the logs change
   const [_timelineItems, setTimelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
   const [activeClientId] = useGlobal("activeClientId", "")
   const clearLogs = useCallback(() => {
-    setTimelineItems((prev) => prev.filter((item) => item.clientId !== activeClientId))
-  }, [setTimelineItems])
+    setTimelineItems((prev) => {
+      releasePayloads(prev.filter((item) => item.clientId === activeClientId))
+      return prev.filter((item) => item.clientId !== activeClientId)
+    })
+    endLogRun(activeClientId)
+  }, [setTimelineItems, activeClientId])
 
   return (
     <View style={$buttonContainer}>
@@ -8,16 +8,27 @@ import {
   type ImageStyle,
   Pressable,
   Linking,
+  Button,
 } from "react-native"
+import { useMemo, useState } from "react"
 import { themed } from "../theme/theme"
 import { CommandType } from "reactotron-core-contract"
 import { TimelineItem, TimelineItemBenchmark } from "../types"
 import { TreeViewWithProvider } from "./TreeView"
+import { DataViewer, StoredBodyViewer, largeBodyText } from "./BodyViewer"
 import ActionButton from "./ActionButton"
 import { Tooltip } from "./Tooltip"
 import IRClipboard from "../native/IRClipboard/NativeIRClipboard"
 import { $flex } from "../theme/basics"
 import { formatTime } from "../utils/formatTime"
+import { payloadJson } from "../utils/payloadArena"
+import { isBodyRef } from "../utils/bodyStore"
+import { useSymbolicatedStack } from "../utils/symbolication"
+import {
+  captureBenchmarkBaseline,
+  clearBenchmarkBaseline,
+  getBenchmarkSummary,
+} from "../utils/benchmarkStats"
 
 type DetailPanelProps = {
   selectedItem: TimelineItem | null
@@ -137,7 +148,7 @@ function StateActionDetailContent({
         <Text style={$valueText()}>{name}</Text>
       </DetailSection>
       <DetailSection title="Payload">
-        <TreeViewWithProvider data={action.payload} />
+        <DataViewer data={action.payload} />
       </DetailSection>
     </View>
   )
@@ -195,7 +206,7 @@ function DisplayDetailContent({
       ) : null}
       {renderImage()}
       <DetailSection title="Full Payload">
-        <TreeViewWithProvider data={rest} />
+        <DataViewer data={rest} />
       </DetailSection>
       <DetailSection title="Metadata">
         <TreeViewWithProvider
@@ -237,6 +248,7 @@ function BenchmarkDetailContent({ item }: { item: TimelineItemBenchmark }) {
           )
         })}
       </DetailSection>
+      <BenchmarkRunsSection item={item} />
       <DetailSection title="Payload">
         <TreeViewWithProvider data={payload} />
       </DetailSection>
@@ -257,11 +269,71 @@ function BenchmarkDetailContent({ item }: { item: TimelineItemBenchmark }) {
   )
 }
 
+/**
+ * Aggregates of every run of this benchmark title, with this run's comparison against
+ * the baseline.
+ */
+function BenchmarkRunsSection({ item }: { item: TimelineItemBenchmark }) {
+  const { title } = item.payload
+  // Bumped to re-read the native aggregates after changing the baseline
+  const [, setRevision] = useState(0)
+  const summary = getBenchmarkSummary(title)
+  const hasBaseline = summary.some((step) => step.baseline)
+  const verdicts = item.verdict?.steps ?? []
+
+  const handleUseAsBaseline = () => {
+    captureBenchmarkBaseline(title)
+    setRevision((revision) => revision + 1)
+  }
+  const handleClearBaseline = () => {
+    clearBenchmarkBaseline(title)
+    setRevision((revision) => revision + 1)
+  }
+
+  return (
+    <DetailSection title={`Across Runs (run ${item.verdict?.run ?? "?"})`}>
+      {summary.map((step) => {
+        const verdict = verdicts.find((v) => v.step === step.step)
+        const compared = verdict && verdict.change !== "none"
+        const percent = compared ? Math.round((verdict.ratio - 1) * 100) : 0
+        return (
+          <View key={step.step} style={$benchmarkRow()}>
+            <Text style={$valueText()}>{step.step}</Text>
+            <Text style={$valueText()}>
+              {step.mean.toFixed(3)}ms ± {step.standardDeviation.toFixed(3)} · p90{" "}
+              {step.p90.toFixed(3)}ms · n={step.count}
+              {compared && (
+                <Text
+                  style={[
+                    verdict.change === "regressed" && $errorText(),
+                    verdict.change === "improved" && $improvedText(),
+                  ]}
+                >
+                  {" "}
+                  ({percent >= 0 ? "+" : ""}
+                  {percent}%, p={verdict.pValue.toPrecision(2)})
+                </Text>
+              )}
+            </Text>
+          </View>
+        )
+      })}
+      <View style={$benchmarkActions()}>
+        <Button onPress={handleUseAsBaseline} title="Use Runs as Baseline" />
+        {hasBaseline && <Button onPress={handleClearBaseline} title="Clear Baseline" />}
+      </View>
+    </DetailSection>
+  )
+}
+
 /**
  * Renders detailed content for log timeline items including level, message, stack trace, and metadata.
  */
 function LogDetailContent({ item }: { item: TimelineItem & { type: typeof CommandType.Log } }) {
   const { payload } = item
+  const json = useMemo(() => payloadJson(item), [item])
+  // Bundle frames are shown as is until they're mapped to their sources
+  const stack = useSymbolicatedStack("stack" in payload ? payload.stack : undefined)
 
   return (
     <View style={$detailContent()}>
@@ -269,23 +341,31 @@ function LogDetailContent({ item }: { item: TimelineItem & { type: typeof Comman
         <Text style={$valueText()}>{payload.level.toUpperCase()}</Text>
       </DetailSection>
 
+      {item.repeatCount && item.lastDate && (
+        <DetailSection title="Repeated">
+          <Text style={$valueText()}>
+            {item.repeatCount} times, last at {formatTime(new Date(item.lastDate))}
+          </Text>
+        </DetailSection>
+      )}
+
       <DetailSection title="Message">
         {typeof payload.message === "string" ? (
           <Text style={$valueText()}>{payload.message}</Text>
         ) : (
-          <TreeViewWithProvider data={payload.message} />
+          <DataViewer data={payload.message} />
         )}
       </DetailSection>
 
       {/* Show stack trace only for error level logs that have stack data */}
       {payload.level === "error" && "stack" in payload && (
         <DetailSection title="Stack Trace">
-          <TreeViewWithProvider data={payload.stack} />
+          <TreeViewWithProvider data={stack} />
         </DetailSection>
       )}
 
       <DetailSection title="Full Payload">
-        <TreeViewWithProvider data={payload} />
+        <DataViewer data={payload} json={json} />
       </DetailSection>
 
       <DetailSection title="Metadata">
@@ -314,6 +394,16 @@ function NetworkDetailContent({
   item: TimelineItem & { type: typeof CommandType.ApiResponse }
 }) {
   const { payload } = item
+  const json = useMemo(() => payloadJson(item), [item])
+  // A large body gets a section of its own, so the rest of the response stays a tree
+  const requestData = payload.request?.data
+  const storedRequestData = isBodyRef(requestData) ? requestData : null
+  const responseData = payload.response?.data
+  const storedResponseData = isBodyRef(responseData) ? responseData : null
+  const largeResponseData = useMemo(
+    () => (isBodyRef(responseData) ? null : largeBodyText(responseData)),
+    [responseData],
+  )
 
   return (
     <View style={$detailContent()}>
@@ -321,8 +411,13 @@ function NetworkDetailContent({
       {payload.request && (
         <>
           <DetailSection title="Request">
-            <TreeViewWithProvider data={payload.request} />
+            <DataViewer data={storedRequestData ? withoutData(payload.request) : payload.request} />
           </DetailSection>
+          {storedRequestData && (
+            <DetailSection title="Request Body">
+              <StoredBodyViewer body={storedRequestData} />
+            </DetailSection>
+          )}
         </>
       )}
 
@@ -330,8 +425,24 @@ function NetworkDetailContent({
       {payload.response && (
         <>
           <DetailSection title="Response">
-            <TreeViewWithProvider data={payload.response} />
+            <TreeViewWithProvider
+              data={
+                largeResponseData || storedResponseData
+                  ? withoutData(payload.response)
+                  : payload.response
+              }
+            />
           </DetailSection>
+          {largeResponseData && (
+            <DetailSection title="Response Body">
+              <DataViewer data={responseData} json={largeResponseData} />
+            </DetailSection>
+          )}
+          {storedResponseData && (
+            <DetailSection title="Response Body">
+              <StoredBodyViewer body={storedResponseData} />
+            </DetailSection>
+          )}
         </>
       )}
 
@@ -343,7 +454,7 @@ function NetworkDetailContent({
       )}
 
       <DetailSection title="Full Payload">
-        <TreeViewWithProvider data={payload} />
+        <DataViewer data={payload} json={json} />
       </DetailSection>
 
       <DetailSection title="Metadata">
@@ -363,6 +474,10 @@ function NetworkDetailContent({
   )
 }
 
+function withoutData<T extends { data?: unknown }>({ data: _data, ...rest }: T) {
+  return rest
+}
+
 /**
  * A reusable section component with a header and content area for organizing detail information.
  */
@@ -509,6 +624,16 @@ const $benchmarkRowStep = themed<ViewStyle>(({ colors }) => ({
   backgroundColor: colors.border,
 }))
 
+const $benchmarkActions = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  gap: spacing.xs,
+  marginTop: spacing.sm,
+}))
+
+const $improvedText = themed<TextStyle>(({ colors }) => ({
+  color: colors.success,
+}))
+
 const $sectionTitle = themed<TextStyle>(({ colors, typography }) => ({
   color: colors.mainText,
   fontSize: typography.body,
@@ -0,0 +1,144 @@
+import { Button, ScrollView, Text, View, type TextStyle, type ViewStyle } from "react-native"
+import { themed } from "../theme/theme"
+import { clearLogHeavyHitters, useLogHeavyHitters } from "../utils/logStats"
+
+/**
+ * The session's noisiest log sources: logs grouped by level, stack top and message
+ * template, counted natively as they arrive.
+ */
+export function LogSourcesPanel() {
+  const { total, sources } = useLogHeavyHitters()
+
+  return (
+    <View style={$container()}>
+      <View style={$header()}>
+        <View>
+          <Text style={$headerTitle()}>Noisiest Sources</Text>
+          <Text style={$headerInfoText()}>{total} logs this session</Text>
+        </View>
+        <Button onPress={clearLogHeavyHitters} title="Reset" />
+      </View>
+      {sources.length === 0 ? (
+        <View style={$emptyContainer()}>
+          <Text style={$emptyText()}>No logs yet</Text>
+        </View>
+      ) : (
+        <ScrollView contentContainerStyle={$scrollContent()}>
+          {sources.map((source, index) => {
+            const share = total ? (source.count / total) * 100 : 0
+            return (
+              <View key={`${index}-${source.label}`} style={$row()}>
+                <View style={$shareBar(share)} />
+                <View style={$rowText}>
+                  <Text style={$label()} numberOfLines={2}>
+                    <Text style={source.level === "error" ? $errorLevel() : $level()}>
+                      {source.level.toUpperCase()}
+                    </Text>{" "}
+                    {source.label}
+                  </Text>
+                  {!!source.stackTop && (
+                    <Text style={$stackTop()} numberOfLines={1}>
+                      {source.stackTop}
+                    </Text>
+                  )}
+                </View>
+                <Text style={$count()}>
+                  {source.count} ({share.toFixed(share < 10 ? 1 : 0)}%)
+                </Text>
+              </View>
+            )
+          })}
+        </ScrollView>
+      )}
+    </View>
+  )
+}
+
+const $container = themed<ViewStyle>(({ colors }) => ({
+  flex: 1,
+  backgroundColor: colors.background,
+  borderLeftWidth: 1,
+  borderLeftColor: colors.border,
+}))
+
+const $header = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  justifyContent: "space-between",
+  alignItems: "center",
+  padding: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.border,
+}))
+
+const $headerTitle = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.subheading,
+  fontFamily: typography.primary.semiBold,
+}))
+
+const $headerInfoText = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.caption,
+}))
+
+const $emptyContainer = themed<ViewStyle>(() => ({
+  flex: 1,
+  justifyContent: "center",
+  alignItems: "center",
+}))
+
+const $emptyText = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.body,
+}))
+
+const $scrollContent = themed<ViewStyle>(({ spacing }) => ({
+  paddingBottom: spacing.xl,
+}))
+
+const $row = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  paddingVertical: spacing.xs,
+  paddingHorizontal: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.keyline,
+}))
+
+const $shareBar = (share: number) =>
+  themed<ViewStyle>(({ colors }) => ({
+    position: "absolute",
+    left: 0,
+    top: 0,
+    bottom: 0,
+    width: `${Math.min(share, 100)}%`,
+    backgroundColor: colors.cardBackground,
+  }))()
+
+const $rowText: ViewStyle = { flex: 1, paddingRight: 8 }
+
+const $label = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.caption,
+  fontFamily: typography.code.normal,
+}))
+
+const $level = themed<TextStyle>(({ colors }) => ({
+  color: colors.primary,
+}))
+
+const $errorLevel = themed<TextStyle>(({ colors }) => ({
+  color: colors.danger,
+}))
+
+const $stackTop = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.small,
+  fontFamily: typography.code.normal,
+}))
+
+const $count = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.caption,
+  fontFamily: typography.code.normal,
+}))
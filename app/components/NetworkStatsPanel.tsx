@@ -0,0 +1,190 @@
+import { useState } from "react"
+import {
+  Button,
+  Pressable,
+  ScrollView,
+  Text,
+  View,
+  type TextStyle,
+  type ViewStyle,
+} from "react-native"
+import { themed } from "../theme/theme"
+import { clearNetworkStats, useNetworkStats, type NetworkStatsWindow } from "../utils/networkStats"
+import type { EndpointStats } from "../native/IRNetworkStats/NativeIRNetworkStats"
+
+const WINDOWS: { id: NetworkStatsWindow; label: string }[] = [
+  { id: "1m", label: "1 min" },
+  { id: "5m", label: "5 min" },
+  { id: "session", label: "Session" },
+]
+
+function formatMs(ms: number) {
+  if (ms >= 1000) return `${(ms / 1000).toFixed(2)}s`
+  if (ms >= 10) return `${Math.round(ms)}ms`
+  return `${ms.toFixed(1)}ms`
+}
+
+function formatBytes(bytes: number) {
+  if (bytes >= 1024 * 1024) return `${(bytes / (1024 * 1024)).toFixed(1)} MB`
+  if (bytes >= 1024) return `${(bytes / 1024).toFixed(1)} KB`
+  return `${bytes} B`
+}
+
+/**
+ * Per-endpoint latency percentiles, error rates and payload sizes for the network
+ * timeline, aggregated natively as api.response commands arrive.
+ */
+export function NetworkStatsPanel() {
+  const [window, setWindow] = useState<NetworkStatsWindow>("5m")
+  const stats = useNetworkStats(window)
+
+  return (
+    <View style={$container()}>
+      <View style={$header()}>
+        <Text style={$headerTitle()}>Endpoints</Text>
+        <View style={$headerActions()}>
+          {WINDOWS.map(({ id, label }) => (
+            <Pressable key={id} onPress={() => setWindow(id)} style={$windowButton(id === window)}>
+              <Text style={$windowLabel(id === window)}>{label}</Text>
+            </Pressable>
+          ))}
+          <Button onPress={clearNetworkStats} title="Reset" />
+        </View>
+      </View>
+      {stats.length === 0 ? (
+        <View style={$emptyContainer()}>
+          <Text style={$emptyText()}>No network traffic in this window</Text>
+        </View>
+      ) : (
+        <ScrollView contentContainerStyle={$scrollContent()}>
+          <View style={$row()}>
+            <Text style={[$headerCell(), $routeCell]}>Endpoint</Text>
+            <Text style={[$headerCell(), $numberCell]}>Count</Text>
+            <Text style={[$headerCell(), $numberCell]}>Errors</Text>
+            <Text style={[$headerCell(), $numberCell]}>p50</Text>
+            <Text style={[$headerCell(), $numberCell]}>p90</Text>
+            <Text style={[$headerCell(), $numberCell]}>p99</Text>
+            <Text style={[$headerCell(), $numberCell]}>Max</Text>
+            <Text style={[$headerCell(), $numberCell]}>Avg size</Text>
+          </View>
+          {stats.map((endpoint) => (
+            <EndpointRow key={`${endpoint.method} ${endpoint.route}`} endpoint={endpoint} />
+          ))}
+        </ScrollView>
+      )}
+    </View>
+  )
+}
+
+function EndpointRow({ endpoint }: { endpoint: EndpointStats }) {
+  const errorRate = endpoint.count ? (endpoint.errorCount / endpoint.count) * 100 : 0
+  return (
+    <View style={$row()}>
+      <Text style={[$cell(), $routeCell]} numberOfLines={1}>
+        <Text style={$method()}>{endpoint.method}</Text> {endpoint.route}
+      </Text>
+      <Text style={[$cell(), $numberCell]}>{endpoint.count}</Text>
+      <Text style={[$cell(), $numberCell, endpoint.errorCount > 0 && $errorCell()]}>
+        {errorRate.toFixed(errorRate > 0 && errorRate < 10 ? 1 : 0)}%
+      </Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(endpoint.p50)}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(endpoint.p90)}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(endpoint.p99)}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(endpoint.max)}</Text>
+      <Text style={[$cell(), $numberCell]}>
+        {formatBytes(Math.round(endpoint.responseBytes / endpoint.count))}
+      </Text>
+    </View>
+  )
+}
+
+const $container = themed<ViewStyle>(({ colors }) => ({
+  flex: 1,
+  backgroundColor: colors.background,
+  borderLeftWidth: 1,
+  borderLeftColor: colors.border,
+}))
+
+const $header = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  justifyContent: "space-between",
+  alignItems: "center",
+  padding: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.border,
+}))
+
+const $headerTitle = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.subheading,
+  fontFamily: typography.primary.semiBold,
+}))
+
+const $headerActions = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  gap: spacing.xs,
+}))
+
+const $windowButton = (selected: boolean) =>
+  themed<ViewStyle>(({ colors, spacing }) => ({
+    paddingVertical: spacing.xxs,
+    paddingHorizontal: spacing.xs,
+    borderRadius: spacing.xxs,
+    borderWidth: 1,
+    borderColor: selected ? colors.primary : colors.border,
+    cursor: "pointer",
+  }))()
+
+const $windowLabel = (selected: boolean) =>
+  themed<TextStyle>(({ colors, typography }) => ({
+    color: selected ? colors.primary : colors.neutral,
+    fontSize: typography.caption,
+  }))()
+
+const $emptyContainer = themed<ViewStyle>(() => ({
+  flex: 1,
+  justifyContent: "center",
+  alignItems: "center",
+}))
+
+const $emptyText = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.body,
+}))
+
+const $scrollContent = themed<ViewStyle>(({ spacing }) => ({
+  paddingBottom: spacing.xl,
+}))
+
+const $row = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  paddingVertical: spacing.xs,
+  paddingHorizontal: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.keyline,
+}))
+
+const $routeCell: TextStyle = { flex: 1, paddingRight: 8 }
+const $numberCell: TextStyle = { width: 64, textAlign: "right" }
+
+const $headerCell = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.caption,
+  fontFamily: typography.primary.semiBold,
+}))
+
+const $cell = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.caption,
+  fontFamily: typography.code.normal,
+}))
+
+const $method = themed<TextStyle>(({ colors }) => ({
+  color: colors.primary,
+}))
+
+const $errorCell = themed<TextStyle>(({ colors }) => ({
+  color: colors.danger,
+}))
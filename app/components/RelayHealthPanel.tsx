@@ -0,0 +1,208 @@
+import { ScrollView, Text, View, type TextStyle, type ViewStyle } from "react-native"
+import { themed } from "../theme/theme"
+import { getReactotronAppId } from "../state/connectToServer"
+import { useRelayHealth, type RelayPeerStats } from "../utils/relayStats"
+import type { RelayClientStats } from "../native/IRRelaySocket/NativeIRRelaySocket"
+
+function formatMs(ms: number) {
+  if (ms >= 1000) return `${(ms / 1000).toFixed(2)}s`
+  if (ms >= 10) return `${Math.round(ms)}ms`
+  return `${ms.toFixed(1)}ms`
+}
+
+function formatBytes(bytes: number) {
+  if (bytes >= 1024 * 1024) return `${(bytes / (1024 * 1024)).toFixed(1)} MB`
+  if (bytes >= 1024) return `${(bytes / 1024).toFixed(1)} KB`
+  return `${Math.round(bytes)} B`
+}
+
+function formatRate(perSec: number) {
+  return perSec >= 100 ? `${Math.round(perSec)}` : perSec.toFixed(1)
+}
+
+/**
+ * Where time goes between the apps being debugged and this one: per-client and per-app
+ * message rates, socket queue depths and forward latencies, as counted by the standalone relay,
+ * next to what this app has received from each client.
+ */
+export function RelayHealthPanel() {
+  const health = useRelayHealth()
+  const appId = getReactotronAppId()
+
+  return (
+    <View style={$container()}>
+      <View style={$header()}>
+        <Text style={$headerTitle()}>Relay Health</Text>
+        {!!health && (
+          <Text style={$headerInfoText()}>
+            Up {Math.round(health.relay.uptime / 60_000)} min,{" "}
+            {formatBytes(health.relay.totals.bytesIn)} in, {health.relay.totals.drops} dropped
+          </Text>
+        )}
+      </View>
+      {!health ? (
+        <View style={$emptyContainer()}>
+          <Text style={$emptyText()}>The relay hasn't sent any stats yet</Text>
+        </View>
+      ) : (
+        <ScrollView contentContainerStyle={$scrollContent()}>
+          <Text style={$sectionTitle()}>Clients</Text>
+          <View style={$row()}>
+            <Text style={[$headerCell(), $nameCell]}>Client</Text>
+            <Text style={[$headerCell(), $numberCell]}>Msg/s</Text>
+            <Text style={[$headerCell(), $numberCell]}>Bytes/s</Text>
+            <Text style={[$headerCell(), $numberCell]}>Relayed</Text>
+            <Text style={[$headerCell(), $numberCell]}>Received</Text>
+            <Text style={[$headerCell(), $numberCell]}>p50</Text>
+            <Text style={[$headerCell(), $numberCell]}>p99</Text>
+            <Text style={[$headerCell(), $numberCell]}>Unrouted</Text>
+          </View>
+          {health.relay.clients.map((client) => (
+            <ClientRow
+              key={client.id}
+              client={client}
+              received={health.received.find((stats) => stats.clientId === client.id)}
+            />
+          ))}
+
+          <Text style={$sectionTitle()}>Reactotron Apps</Text>
+          <View style={$row()}>
+            <Text style={[$headerCell(), $nameCell]}>App</Text>
+            <Text style={[$headerCell(), $numberCell]}>Msg/s</Text>
+            <Text style={[$headerCell(), $numberCell]}>Bytes/s</Text>
+            <Text style={[$headerCell(), $numberCell]}>Queued</Text>
+            <Text style={[$headerCell(), $numberCell]}>Peak</Text>
+            <Text style={[$headerCell(), $numberCell]}>p50</Text>
+            <Text style={[$headerCell(), $numberCell]}>p99</Text>
+            <Text style={[$headerCell(), $numberCell]}>Drops</Text>
+          </View>
+          {health.relay.subscribers.map((subscriber, index) => (
+            <View key={`${index}-${subscriber.id}`} style={$row()}>
+              <Text style={[$cell(), $nameCell]} numberOfLines={1}>
+                {subscriber.id === appId ? "This app" : subscriber.id || "Unknown"}
+              </Text>
+              <Text style={[$cell(), $numberCell]}>{formatRate(subscriber.messagesOutPerSec)}</Text>
+              <Text style={[$cell(), $numberCell]}>{formatBytes(subscriber.bytesOutPerSec)}</Text>
+              <Text style={[$cell(), $numberCell]}>{formatBytes(subscriber.queueDepth)}</Text>
+              <Text style={[$cell(), $numberCell]}>{formatBytes(subscriber.maxQueueDepth)}</Text>
+              <Text style={[$cell(), $numberCell]}>{formatMs(subscriber.latency.p50)}</Text>
+              <Text style={[$cell(), $numberCell]}>{formatMs(subscriber.latency.p99)}</Text>
+              <Text style={[$cell(), $numberCell, subscriber.drops > 0 && $warningCell()]}>
+                {subscriber.drops}
+              </Text>
+            </View>
+          ))}
+          <Text style={$footnote()}>
+            Rates, peaks and latencies cover the last {Math.round(health.relay.intervalMs)}ms.
+            Latency runs from a message reaching the relay to its write to each app. Relayed
+            counts what the relay got from a client, Received what reached this app.
+          </Text>
+        </ScrollView>
+      )}
+    </View>
+  )
+}
+
+function ClientRow({ client, received }: { client: RelayPeerStats; received?: RelayClientStats }) {
+  return (
+    <View style={$row()}>
+      <Text style={[$cell(), $nameCell]} numberOfLines={1}>
+        {client.name || client.id}
+      </Text>
+      <Text style={[$cell(), $numberCell]}>{formatRate(client.messagesInPerSec)}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatBytes(client.bytesInPerSec)}</Text>
+      <Text style={[$cell(), $numberCell]}>{client.messagesIn}</Text>
+      <Text style={[$cell(), $numberCell]}>{received?.messages ?? 0}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(client.latency.p50)}</Text>
+      <Text style={[$cell(), $numberCell]}>{formatMs(client.latency.p99)}</Text>
+      <Text style={[$cell(), $numberCell, client.unrouted > 0 && $warningCell()]}>
+        {client.unrouted}
+      </Text>
+    </View>
+  )
+}
+
+const $container = themed<ViewStyle>(({ colors }) => ({
+  flex: 1,
+  backgroundColor: colors.background,
+  borderLeftWidth: 1,
+  borderLeftColor: colors.border,
+}))
+
+const $header = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  justifyContent: "space-between",
+  alignItems: "center",
+  padding: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.border,
+}))
+
+const $headerTitle = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.subheading,
+  fontFamily: typography.primary.semiBold,
+}))
+
+const $headerInfoText = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.caption,
+}))
+
+const $emptyContainer = themed<ViewStyle>(() => ({
+  flex: 1,
+  justifyContent: "center",
+  alignItems: "center",
+}))
+
+const $emptyText = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.body,
+}))
+
+const $scrollContent = themed<ViewStyle>(({ spacing }) => ({
+  paddingBottom: spacing.xl,
+}))
+
+const $sectionTitle = themed<TextStyle>(({ colors, typography, spacing }) => ({
+  color: colors.mainText,
+  fontSize: typography.body,
+  fontFamily: typography.primary.semiBold,
+  paddingHorizontal: spacing.md,
+  paddingTop: spacing.md,
+  paddingBottom: spacing.xs,
+}))
+
+const $row = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  paddingVertical: spacing.xs,
+  paddingHorizontal: spacing.md,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.keyline,
+}))
+
+const $nameCell: TextStyle = { flex: 1, paddingRight: 8 }
+const $numberCell: TextStyle = { width: 64, textAlign: "right" }
+
+const $headerCell = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.caption,
+  fontFamily: typography.primary.semiBold,
+}))
+
+const $cell = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.caption,
+  fontFamily: typography.code.normal,
+}))
+
+const $warningCell = themed<TextStyle>(({ colors }) => ({
+  color: colors.danger,
+}))
+
+const $footnote = themed<TextStyle>(({ colors, typography, spacing }) => ({
+  color: colors.neutral,
+  fontSize: typography.small,
+  padding: spacing.md,
+}))
@@ -0,0 +1,211 @@
+import { useEffect, useState } from "react"
+import { Pressable, Text, View, type TextStyle, type ViewStyle } from "react-native"
+import { themed } from "../theme/theme"
+import { sendToClient } from "../state/connectToServer"
+import { useGlobal } from "../state/useGlobal"
+import { Icon } from "./Icon"
+import type { StateSnapshotChange } from "../native/IRStateSnapshots/NativeIRStateSnapshots"
+import {
+  clearStateSnapshots,
+  diffStateSnapshots,
+  expectStateSnapshot,
+  loadStateSnapshot,
+  removeStateSnapshot,
+  useStateSnapshots,
+} from "../utils/stateSnapshots"
+
+// Changes listed under a selected snapshot; the rest are counted
+const MAX_SHOWN_CHANGES = 50
+
+/**
+ * The client's state history: snapshots taken on demand or after every action, each
+ * restorable, and what changed since the one before.
+ */
+export function StateSnapshotsPanel({ clientId }: { clientId: string }) {
+  const [capture, setCapture] = useGlobal("stateSnapshotCapture", false, { persist: true })
+  const snapshots = useStateSnapshots(clientId)
+  const [selectedId, setSelectedId] = useState(0)
+  const [changes, setChanges] = useState<StateSnapshotChange[] | null>(null)
+
+  const selectedIndex = snapshots.findIndex((snapshot) => snapshot.id === selectedId)
+  const previousId = selectedIndex > 0 ? snapshots[selectedIndex - 1].id : 0
+
+  useEffect(() => {
+    setChanges(null)
+    if (!selectedId || !previousId) return
+    let cancelled = false
+    diffStateSnapshots(previousId, selectedId).then((result) => {
+      if (!cancelled) setChanges(result)
+    })
+    return () => {
+      cancelled = true
+    }
+  }, [selectedId, previousId])
+
+  const takeSnapshot = () => {
+    if (expectStateSnapshot(clientId, "Snapshot")) {
+      sendToClient("state.backup.request", {}, clientId)
+    }
+  }
+
+  const restore = async (id: number) => {
+    const state = await loadStateSnapshot(id)
+    sendToClient("state.restore.request", { state }, clientId)
+  }
+
+  return (
+    <View style={$container()}>
+      <View style={$header()}>
+        <Text style={$title()}>Snapshots</Text>
+        <View style={$buttonsContainer()}>
+          <Pressable style={$button()} onPress={() => setCapture(!capture)}>
+            <Text>{capture ? "Stop Capturing" : "Capture Every Action"}</Text>
+          </Pressable>
+          <Pressable style={$button()} onPress={takeSnapshot} disabled={!clientId}>
+            <Text>Take Snapshot</Text>
+          </Pressable>
+          <Pressable style={$button()} onPress={clearStateSnapshots}>
+            <Text>Clear Snapshots</Text>
+          </Pressable>
+        </View>
+      </View>
+      {snapshots.length === 0 ? (
+        <Text style={$emptyText()}>No snapshots yet</Text>
+      ) : (
+        [...snapshots].reverse().map((snapshot) => {
+          const selected = snapshot.id === selectedId
+          return (
+            <View key={snapshot.id}>
+              <Pressable style={$row()} onPress={() => setSelectedId(selected ? 0 : snapshot.id)}>
+                <Text style={$label()} numberOfLines={1}>
+                  {snapshot.label}
+                </Text>
+                <Text style={$meta()}>
+                  {new Date(snapshot.time).toLocaleTimeString()} · {formatSize(snapshot.size)}
+                </Text>
+                <Pressable style={$button()} onPress={() => restore(snapshot.id)}>
+                  <Text>Restore</Text>
+                </Pressable>
+                <Pressable onPress={() => removeStateSnapshot(snapshot.id)}>
+                  <Icon icon="trash" size={20} />
+                </Pressable>
+              </Pressable>
+              {selected && (
+                <View style={$changes()}>
+                  {!previousId ? (
+                    <Text style={$meta()}>First snapshot</Text>
+                  ) : !changes ? (
+                    <Text style={$meta()}>Comparing…</Text>
+                  ) : changes.length === 0 ? (
+                    <Text style={$meta()}>No changes since the previous snapshot</Text>
+                  ) : (
+                    <>
+                      {changes.slice(0, MAX_SHOWN_CHANGES).map((change, index) => (
+                        <Text key={`${index}-${change.path}`} style={$change()} numberOfLines={2}>
+                          <Text style={$changeKind(change.kind)}>{change.kind}</Text>{" "}
+                          {change.path || "(root)"}
+                          {changeValue(change)}
+                        </Text>
+                      ))}
+                      {changes.length > MAX_SHOWN_CHANGES && (
+                        <Text style={$meta()}>
+                          and {changes.length - MAX_SHOWN_CHANGES} more changes
+                        </Text>
+                      )}
+                    </>
+                  )}
+                </View>
+              )}
+            </View>
+          )
+        })
+      )}
+    </View>
+  )
+}
+
+function changeValue(change: StateSnapshotChange): string {
+  if (change.kind === "removed") return ""
+  return ` = ${change.truncated ? `(${formatSize(change.valueSize)})` : change.value}`
+}
+
+function formatSize(bytes: number): string {
+  if (bytes < 1024) return `${bytes} B`
+  if (bytes < 1024 * 1024) return `${(bytes / 1024).toFixed(1)} KB`
+  return `${(bytes / 1024 / 1024).toFixed(1)} MB`
+}
+
+const $container = themed<ViewStyle>(({ spacing }) => ({
+  marginTop: spacing.xl,
+}))
+
+const $header = themed<ViewStyle>(() => ({
+  flexDirection: "row",
+  justifyContent: "space-between",
+  alignItems: "center",
+}))
+
+const $title = themed<TextStyle>(({ colors, typography }) => ({
+  fontSize: typography.subheading,
+  fontWeight: "bold",
+  color: colors.mainText,
+  fontFamily: typography.code.normal,
+}))
+
+const $buttonsContainer = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  gap: spacing.sm,
+}))
+
+const $button = themed<ViewStyle>(({ colors, spacing }) => ({
+  padding: spacing.xs,
+  backgroundColor: colors.cardBackground,
+  borderRadius: 8,
+  cursor: "pointer",
+}))
+
+const $emptyText = themed<TextStyle>(({ colors, typography, spacing }) => ({
+  color: colors.neutral,
+  fontSize: typography.body,
+  marginTop: spacing.sm,
+}))
+
+const $row = themed<ViewStyle>(({ colors, spacing }) => ({
+  flexDirection: "row",
+  alignItems: "center",
+  gap: spacing.sm,
+  paddingVertical: spacing.xs,
+  borderBottomWidth: 1,
+  borderBottomColor: colors.keyline,
+  cursor: "pointer",
+}))
+
+const $label = themed<TextStyle>(({ colors, typography }) => ({
+  flex: 1,
+  color: colors.mainText,
+  fontSize: typography.caption,
+  fontFamily: typography.code.normal,
+}))
+
+const $meta = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.neutral,
+  fontSize: typography.caption,
+}))
+
+const $changes = themed<ViewStyle>(({ spacing }) => ({
+  paddingVertical: spacing.sm,
+  paddingLeft: spacing.md,
+  gap: spacing.xxs,
+}))
+
+const $change = themed<TextStyle>(({ colors, typography }) => ({
+  color: colors.mainText,
+  fontSize: typography.small,
+  fontFamily: typography.code.normal,
+}))
+
+const $changeKind = (kind: string) =>
+  themed<TextStyle>(({ colors }) => ({
+    color:
+      kind === "added" ? colors.primary : kind === "removed" ? colors.danger : colors.neutral,
+  }))()
@@ -1,30 +1,48 @@
-import { useState } from "react"
-import { View, Text, type TextStyle, type ViewStyle } from "react-native"
+import { useMemo, useState } from "react"
+import { Pressable, View, Text, type TextStyle, type ViewStyle } from "react-native"
 import { useTheme, themed } from "../theme/theme"
 import { useSystemInfo } from "../utils/system"
+import { useGlobal } from "../state/useGlobal"
+import type { MemoryUsage } from "../native/IRMemoryGovernor/NativeIRMemoryGovernor"
+import IRSystemInfo, { MetricPoint } from "../native/IRSystemInfo/NativeIRSystemInfo"
 
-export function SystemInfo() {
-  const { colors } = useTheme()
-  const [cpuData, setCpuData] = useState<number[]>([])
-  const [memoryData, setMemoryData] = useState<number[]>([])
-  const [maxMemory, setMaxMemory] = useState<number>(0)
-
-  useSystemInfo((info) => {
-    const memoryUsage = info.rss
-    const mockCpuUsage = info.cpu
-
-    setCpuData((prev) => {
-      const newData = [...prev, mockCpuUsage]
-      return newData.slice(-100) // Keep only last 100 items
-    })
+function formatMB(bytes: number) {
+  return `${(bytes / (1024 * 1024)).toFixed(1)} MB`
+}
 
-    setMemoryData((prev) => {
-      const newData = [...prev, memoryUsage]
-      return newData.slice(-100) // Keep only last 100 items
-    })
+// Each bar takes its width plus a margin either side
+const BAR_WIDTH = 3
+const BAR_SPACING = BAR_WIDTH + 2
+const RANGES = [
+  { label: "1m", ms: 60_000 },
+  { label: "10m", ms: 600_000 },
+  { label: "1h", ms: 3_600_000 },
+  { label: "24h", ms: 86_400_000 },
+]
 
-    setMaxMemory((prev) => Math.max(prev, memoryUsage))
-  })
+export function SystemInfo() {
+  const { colors } = useTheme()
+  const [range, setRange] = useState(RANGES[0].ms)
+  const [chartWidth, setChartWidth] = useState(0)
+  const [tick, setTick] = useState(0)
+  const [memoryUsage] = useGlobal<MemoryUsage | null>("memoryUsage", null)
+
+  // The history is kept natively; each event just means there's a newer sample to show
+  useSystemInfo(() => setTick((t) => t + 1))
+
+  // A bar per point, so the native side downsamples to exactly what's drawn
+  const points = Math.max(2, Math.floor(chartWidth / BAR_SPACING))
+  const [cpuData, memoryData] = useMemo<[MetricPoint[], MetricPoint[]]>(() => {
+    if (!chartWidth) return [[], []]
+    const now = Date.now()
+    return [
+      IRSystemInfo.getHistory("cpu", now - range, now, points),
+      IRSystemInfo.getHistory("rss", now - range, now, points),
+    ]
+  }, [tick, range, points, chartWidth])
+  const maxMemory = memoryData.reduce((max, point) => Math.max(max, point.max), 0)
+  const maxCpu = cpuData.reduce((max, point) => Math.max(max, point.max), 0)
+  const latest = (data: MetricPoint[]) => data[data.length - 1]?.value ?? 0
 
   const getCpuColor = (usage: number) => {
     if (usage < 30) return colors.success
@@ -33,33 +51,69 @@ export function SystemInfo() {
     return colors.danger
   }
 
-  const renderBar = (value: number, maxValue: number, color: string, height: number) => (
-    <View key={Math.random()} style={$barStyle(value, maxValue, color, height)} />
+  const renderBar = (point: MetricPoint, maxValue: number, color: string, height: number) => (
+    <View key={point.time} style={$barStyle(point.value, maxValue, color, height)} />
   )
 
   return (
     <View style={$systemInfoContainer()}>
       <Text style={$systemInfoTitle()}>System Info</Text>
 
+      <View style={$rangeRow()}>
+        {RANGES.map((option) => (
+          <Pressable
+            key={option.label}
+            style={[$rangeButton(), option.ms === range && $rangeButtonActive()]}
+            onPress={() => setRange(option.ms)}
+          >
+            <Text style={$chartLabel()}>{option.label}</Text>
+          </Pressable>
+        ))}
+      </View>
+
       <View style={$chartContainer()}>
         <View style={$chartSection()}>
           <Text style={$chartLabel()}>CPU Usage</Text>
-          <View style={$chartBars()}>
-            {cpuData.map((usage, _index) => renderBar(usage, 100, getCpuColor(usage), 80))}
+          <View
+            style={$chartBars()}
+            onLayout={(event) => setChartWidth(event.nativeEvent.layout.width)}
+          >
+            {cpuData.map((point) => renderBar(point, 100, getCpuColor(point.value), 80))}
           </View>
-          <Text style={$chartValue()}>{cpuData[cpuData.length - 1]?.toFixed(1) || 0}%</Text>
+          <Text style={$chartValue()}>
+            {latest(cpuData).toFixed(1)}%, peak {maxCpu.toFixed(1)}%
+          </Text>
         </View>
 
         <View style={$chartSection()}>
           <Text style={$chartLabel()}>Memory Usage</Text>
           <View style={$chartBars()}>
-            {memoryData.map((usage, _index) => renderBar(usage, maxMemory, colors.primary, 80))}
+            {memoryData.map((point) => renderBar(point, maxMemory, colors.primary, 80))}
           </View>
           <Text style={$chartValue()}>
-            {memoryData[memoryData.length - 1]?.toFixed(1) || 0} MB / {maxMemory.toFixed(1)} MB
+            {latest(memoryData).toFixed(1)} MB / {maxMemory.toFixed(1)} MB
           </Text>
         </View>
       </View>
+
+      {memoryUsage && (
+        <View style={$storesContainer()}>
+          <Text style={$chartLabel()}>
+            Stores: {formatMB(memoryUsage.totalBytes)}
+            {memoryUsage.globalBudget ? ` / ${formatMB(memoryUsage.globalBudget)}` : ""}
+          </Text>
+          {memoryUsage.stores.map((store) => (
+            <View key={store.name} style={$storeRow()}>
+              <Text style={$storeName()}>{store.name}</Text>
+              <Text style={$chartValue()}>
+                {formatMB(store.bytes)}
+                {store.budget ? ` / ${formatMB(store.budget)}` : ""}
+                {store.evictedBytes ? `, ${formatMB(store.evictedBytes)} evicted` : ""}
+              </Text>
+            </View>
+          ))}
+        </View>
+      )}
     </View>
   )
 }
@@ -92,7 +146,24 @@ const $chartLabel = themed<TextStyle>(({ colors, typography }) => ({
   color: colors.neutral,
 }))
 
+const $rangeRow = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  justifyContent: "center",
+  gap: spacing.xs,
+}))
+
+const $rangeButton = themed<ViewStyle>(({ spacing }) => ({
+  paddingHorizontal: spacing.sm,
+  borderRadius: 4,
+  cursor: "pointer",
+}))
+
+const $rangeButtonActive = themed<ViewStyle>(({ colors }) => ({
+  backgroundColor: colors.cardBackground,
+}))
+
 const $chartBars = themed<ViewStyle>(({ spacing }) => ({
+  alignSelf: "stretch",
   flexDirection: "row",
   alignItems: "flex-end",
   height: 80,
@@ -105,8 +176,23 @@ const $chartValue = themed<TextStyle>(({ colors, typography }) => ({
   color: colors.mainText,
 }))
 
+const $storesContainer = themed<ViewStyle>(({ spacing }) => ({
+  alignItems: "center",
+  gap: spacing.xs,
+}))
+
+const $storeRow = themed<ViewStyle>(({ spacing }) => ({
+  flexDirection: "row",
+  gap: spacing.sm,
+}))
+
+const $storeName = themed<TextStyle>(({ colors, typography }) => ({
+  fontSize: typography.caption,
+  color: colors.neutral,
+}))
+
 const $barStyle = (value: number, maxValue: number, color: string, height: number): ViewStyle => ({
-  width: 3,
+  width: BAR_WIDTH,
   height: Math.max(2, (value / maxValue) * height),
   backgroundColor: color,
   borderRadius: 1,
@@ -1,5 +1,6 @@
 import { CommandType, TimelineItemBenchmark } from "../types"
 import { TimelineItem } from "./TimelineItem"
+import { mostChangedStep } from "../utils/benchmarkStats"
 type TimelineBenchmarkItemProps = {
   item: TimelineItemBenchmark
   isSelected?: boolean
@@ -20,13 +21,23 @@ export function TimelineBenchmmarkItem({
 
   const totalDuration = payload.steps[payload.steps.length - 1].time
 
+  // Flag runs that differ significantly from the baseline, naming the step that moved most
+  let change = ""
+  const changedStep = item.verdict && mostChangedStep(item.verdict)
+  if (changedStep) {
+    const percent = Math.round(Math.abs(changedStep.ratio - 1) * 100)
+    const direction = changedStep.ratio > 1 ? "slower" : "faster"
+    change = ` · ${changedStep.step} ${percent}% ${direction}`
+  }
+  const isRegression = item.verdict?.change === "regressed"
+
   return (
     <TimelineItem
       title={"BENCHMARK"}
       date={new Date(date)}
       deltaTime={deltaTime}
-      preview={`${payload.title} in ${totalDuration.toFixed(3)}ms`}
-      isImportant={important}
+      preview={`${payload.title} in ${totalDuration.toFixed(3)}ms${change}`}
+      isImportant={important || isRegression}
       isTagged={important}
       isSelected={isSelected}
       onSelect={onSelect}
@@ -44,7 +44,7 @@ export function TimelineLogItem({ item, isSelected = false, onSelect }: Timeline
 
   return (
     <TimelineItem
-      title={level}
+      title={item.repeatCount ? `${level} ×${item.repeatCount}` : level}
       date={new Date(date)}
       deltaTime={deltaTime}
       preview={preview}
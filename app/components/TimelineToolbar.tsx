@@ -7,14 +7,14 @@ export type FilterType =
   | typeof CommandType.ApiResponse
   | typeof CommandType.StateActionComplete
   | typeof CommandType.Benchmark
-// export type LogLevel = "all" | "debug" | "warn" | "error"
-// export type SortBy = "time-newest" | "time-oldest" | "type" | "level"
+export type LogLevel = "all" | "debug" | "warn" | "error"
+export type SortBy = "time-newest" | "time-oldest" | "type" | "level"
 
 export interface TimelineFilters {
   types: FilterType[]
   clientId: string
-  // logLevel: LogLevel
-  // sortBy: SortBy
+  logLevel?: LogLevel // The least severe log shown; defaults to "all"
+  sortBy?: SortBy // Defaults to "time-newest"
 }
 
 // TODO: TimelineToolbar component
@@ -0,0 +1,309 @@
+//
+//  BenchmarkStats.cpp
+//  Reactotron
+//
+
+#include "BenchmarkStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reactotron {
+
+namespace {
+
+const double kGamma = (1 + QuantileSketch::kRelativeAccuracy) / (1 - QuantileSketch::kRelativeAccuracy);
+const double kLogGamma = std::log(kGamma);
+
+/**
+ * Continued fraction for the incomplete beta function (modified Lentz).
+ */
+double BetaContinuedFraction(double a, double b, double x) noexcept {
+  const double tiny = 1e-300;
+  double qab = a + b;
+  double qap = a + 1;
+  double qam = a - 1;
+  double c = 1;
+  double d = 1 - qab * x / qap;
+  if (std::fabs(d) < tiny) d = tiny;
+  d = 1 / d;
+  double h = d;
+  for (int m = 1; m <= 300; ++m) {
+    int m2 = 2 * m;
+    double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+    d = 1 + aa * d;
+    if (std::fabs(d) < tiny) d = tiny;
+    c = 1 + aa / c;
+    if (std::fabs(c) < tiny) c = tiny;
+    d = 1 / d;
+    h *= d * c;
+    aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+    d = 1 + aa * d;
+    if (std::fabs(d) < tiny) d = tiny;
+    c = 1 + aa / c;
+    if (std::fabs(c) < tiny) c = tiny;
+    d = 1 / d;
+    double delta = d * c;
+    h *= delta;
+    if (std::fabs(delta - 1) < 1e-12) break;
+  }
+  return h;
+}
+
+/** The regularized incomplete beta function I_x(a, b). */
+double IncompleteBeta(double a, double b, double x) noexcept {
+  if (x <= 0) return 0;
+  if (x >= 1) return 1;
+  double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) +
+                          b * std::log1p(-x));
+  if (x < (a + 1) / (a + b + 2)) return front * BetaContinuedFraction(a, b, x) / a;
+  return 1 - front * BetaContinuedFraction(b, a, 1 - x) / b;
+}
+
+} // namespace
+
+double StudentTTwoSidedPValue(double t, double degreesOfFreedom) noexcept {
+  if (std::isnan(t) || !(degreesOfFreedom > 0)) return 1;
+  if (std::isinf(t)) return 0;
+  return IncompleteBeta(degreesOfFreedom / 2, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+}
+
+// RunningStats
+
+void RunningStats::Add(double value) noexcept {
+  count++;
+  double delta = value - mean;
+  mean += delta / static_cast<double>(count);
+  m2 += delta * (value - mean);
+  if (count == 1) {
+    min = max = value;
+  } else {
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+
+double RunningStats::StandardDeviation() const noexcept { return std::sqrt(Variance()); }
+
+// QuantileSketch
+
+int QuantileSketch::BucketIndex(double value) noexcept {
+  return static_cast<int>(std::ceil(std::log(value) / kLogGamma));
+}
+
+double QuantileSketch::BucketValue(int index) noexcept {
+  // Bucket i holds (gamma^(i-1), gamma^i]; its midpoint in relative terms
+  return 2 * std::pow(kGamma, index) / (kGamma + 1);
+}
+
+void QuantileSketch::Add(double value) {
+  m_count++;
+  if (!(value > 0) || !std::isfinite(value)) {
+    m_zeroCount++;
+    return;
+  }
+
+  int index = BucketIndex(value);
+  if (m_buckets.empty()) {
+    m_offset = index;
+    m_buckets.push_back(1);
+    return;
+  }
+
+  int top = m_offset + static_cast<int>(m_buckets.size()) - 1;
+  if (index > top) {
+    m_buckets.resize(static_cast<size_t>(index - m_offset) + 1, 0);
+    // Over the cap: fold the lowest buckets into the new lowest one
+    if (m_buckets.size() > kMaxBuckets) {
+      size_t excess = m_buckets.size() - kMaxBuckets;
+      uint64_t folded = 0;
+      for (size_t i = 0; i <= excess; ++i) folded += m_buckets[i];
+      m_buckets.erase(m_buckets.begin(), m_buckets.begin() + static_cast<std::ptrdiff_t>(excess));
+      m_buckets[0] = static_cast<uint32_t>(std::min<uint64_t>(folded, UINT32_MAX));
+      m_offset += static_cast<int>(excess);
+    }
+  } else if (index < m_offset) {
+    int lowest = std::max(index, top - static_cast<int>(kMaxBuckets) + 1);
+    if (lowest < m_offset) {
+      m_buckets.insert(m_buckets.begin(), static_cast<size_t>(m_offset - lowest), 0);
+      m_offset = lowest;
+    }
+    index = std::max(index, m_offset);
+  }
+  m_buckets[static_cast<size_t>(index - m_offset)]++;
+}
+
+double QuantileSketch::ValueAtQuantile(double quantile) const noexcept {
+  if (m_count == 0) return 0;
+  double clamped = std::min(std::max(quantile, 0.0), 1.0);
+  uint64_t rank = static_cast<uint64_t>(clamped * static_cast<double>(m_count - 1));
+  if (rank < m_zeroCount) return 0;
+  uint64_t seen = m_zeroCount;
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    seen += m_buckets[i];
+    if (seen > rank) return BucketValue(m_offset + static_cast<int>(i));
+  }
+  return BucketValue(m_offset + static_cast<int>(m_buckets.size()) - 1);
+}
+
+// BenchmarkStats
+
+BenchmarkStats::BenchmarkStats(size_t maxSeries) : m_maxSeries(std::max<size_t>(maxSeries, 1)) {}
+
+BenchmarkStats::Benchmark &BenchmarkStats::Lookup(std::string_view title) {
+  return m_benchmarks[std::string(title)];
+}
+
+BenchmarkStats::Series *BenchmarkStats::FindSeries(Benchmark &benchmark, const std::string &step, bool create) {
+  auto it = benchmark.index.find(step);
+  if (it != benchmark.index.end()) return &benchmark.series[it->second];
+  if (!create || m_seriesCount >= m_maxSeries) return nullptr;
+  benchmark.index.emplace(step, benchmark.series.size());
+  benchmark.series.emplace_back();
+  benchmark.series.back().step = step;
+  m_seriesCount++;
+  return &benchmark.series.back();
+}
+
+BenchmarkStepVerdict BenchmarkStats::Test(const Series *series, const std::string &step, double duration) {
+  BenchmarkStepVerdict verdict;
+  verdict.step = step;
+  verdict.duration = duration;
+  if (!series) return verdict;
+
+  // Earlier runs of this session stand in until a baseline is set
+  BenchmarkBaseline baseline = series->baseline;
+  if (!series->hasBaseline) {
+    baseline.count = series->stats.count;
+    baseline.mean = series->stats.mean;
+    baseline.standardDeviation = series->stats.StandardDeviation();
+  }
+  if (baseline.count < kMinimumBaselineRuns || !(baseline.mean > 0)) return verdict;
+
+  verdict.ratio = duration / baseline.mean;
+  // Prediction interval for one new observation: its spread plus the mean's
+  double n = static_cast<double>(baseline.count);
+  double standardError = baseline.standardDeviation * std::sqrt(1 + 1 / n);
+  if (standardError > 0) {
+    verdict.pValue = StudentTTwoSidedPValue((duration - baseline.mean) / standardError, n - 1);
+  } else {
+    verdict.pValue = duration == baseline.mean ? 1 : 0;
+  }
+
+  verdict.change = BenchmarkChange::Unchanged;
+  if (verdict.pValue < kSignificance && std::fabs(verdict.ratio - 1) >= kMinimumEffect) {
+    verdict.change = verdict.ratio > 1 ? BenchmarkChange::Regressed : BenchmarkChange::Improved;
+  }
+  return verdict;
+}
+
+BenchmarkVerdict BenchmarkStats::Record(std::string_view title, const std::vector<std::string> &stepTitles,
+                                        const std::vector<double> &deltas) {
+  BenchmarkVerdict verdict;
+  Benchmark &benchmark = Lookup(title);
+  verdict.run = ++benchmark.runs;
+
+  // Step 0 is the report's start marker, always 0ms
+  size_t stepCount = std::min(stepTitles.size(), deltas.size());
+  if (stepCount < 2) return verdict;
+
+  std::unordered_map<std::string_view, int> occurrences;
+  std::string name;
+  double total = 0;
+  auto add = [&](const std::string &step, double duration) {
+    Series *series = FindSeries(benchmark, step, true);
+    verdict.steps.push_back(Test(series, step, duration));
+    if (series) {
+      series->stats.Add(duration);
+      series->sketch.Add(duration);
+    }
+  };
+  for (size_t i = 1; i < stepCount; ++i) {
+    double duration = std::isfinite(deltas[i]) ? std::max(deltas[i], 0.0) : 0;
+    total += duration;
+    int occurrence = ++occurrences[stepTitles[i]];
+    name = stepTitles[i];
+    if (occurrence > 1) name += " #" + std::to_string(occurrence);
+    add(name, duration);
+  }
+  add(kTotalStep, total);
+
+  bool tested = false;
+  for (const auto &step : verdict.steps) {
+    if (step.change == BenchmarkChange::NoBaseline) continue;
+    tested = true;
+    if (step.change == BenchmarkChange::Regressed) verdict.change = BenchmarkChange::Regressed;
+    if (step.change == BenchmarkChange::Improved && verdict.change != BenchmarkChange::Regressed) {
+      verdict.change = BenchmarkChange::Improved;
+    }
+  }
+  if (tested && verdict.change == BenchmarkChange::NoBaseline) verdict.change = BenchmarkChange::Unchanged;
+  return verdict;
+}
+
+std::vector<BenchmarkStepSummary> BenchmarkStats::Summary(std::string_view title) const {
+  std::vector<BenchmarkStepSummary> summary;
+  auto it = m_benchmarks.find(std::string(title));
+  if (it == m_benchmarks.end()) return summary;
+  for (const Series &series : it->second.series) {
+    BenchmarkStepSummary step;
+    step.step = series.step;
+    step.stats = series.stats;
+    auto quantile = [&](double q) {
+      return std::min(std::max(series.sketch.ValueAtQuantile(q), series.stats.min), series.stats.max);
+    };
+    if (series.stats.count) {
+      step.p50 = quantile(0.5);
+      step.p90 = quantile(0.9);
+      step.p99 = quantile(0.99);
+    }
+    step.hasBaseline = series.hasBaseline;
+    step.baseline = series.baseline;
+    summary.push_back(std::move(step));
+  }
+  return summary;
+}
+
+void BenchmarkStats::SetBaseline(std::string_view title, std::string_view step, const BenchmarkBaseline &baseline) {
+  Series *series = FindSeries(Lookup(title), std::string(step), true);
+  if (!series) return;
+  series->hasBaseline = true;
+  series->baseline = baseline;
+}
+
+std::vector<std::pair<std::string, BenchmarkBaseline>> BenchmarkStats::CaptureBaseline(std::string_view title) {
+  std::vector<std::pair<std::string, BenchmarkBaseline>> captured;
+  auto it = m_benchmarks.find(std::string(title));
+  if (it == m_benchmarks.end()) return captured;
+  for (Series &series : it->second.series) {
+    if (series.stats.count == 0) continue;
+    series.hasBaseline = true;
+    series.baseline.count = series.stats.count;
+    series.baseline.mean = series.stats.mean;
+    series.baseline.standardDeviation = series.stats.StandardDeviation();
+    captured.emplace_back(series.step, series.baseline);
+  }
+  return captured;
+}
+
+void BenchmarkStats::ClearBaseline(std::string_view title) {
+  auto it = m_benchmarks.find(std::string(title));
+  if (it == m_benchmarks.end()) return;
+  for (Series &series : it->second.series) {
+    series.hasBaseline = false;
+    series.baseline = BenchmarkBaseline();
+  }
+}
+
+void BenchmarkStats::Clear() {
+  for (auto &entry : m_benchmarks) {
+    Benchmark &benchmark = entry.second;
+    benchmark.runs = 0;
+    for (Series &series : benchmark.series) {
+      series.stats = RunningStats();
+      series.sketch = QuantileSketch();
+    }
+  }
+}
+
+} // namespace reactotron
@@ -0,0 +1,168 @@
+#pragma once
+
+//
+//  BenchmarkStats.h
+//  Reactotron
+//
+//  Aggregates benchmark.report commands across runs: reports are grouped by
+//  title and step, each step keeps a running distribution of its durations, and
+//  every new run is tested against a baseline to flag regressions.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace reactotron {
+
+/**
+ * Running count, mean and variance (Welford), plus min and max. Numerically
+ * stable for long series.
+ */
+struct RunningStats {
+  uint64_t count = 0;
+  double mean = 0;
+  double m2 = 0; // Sum of squared differences from the mean
+  double min = 0;
+  double max = 0;
+
+  void Add(double value) noexcept;
+  double Variance() const noexcept { return count > 1 ? m2 / static_cast<double>(count - 1) : 0; }
+  double StandardDeviation() const noexcept;
+};
+
+/**
+ * Relative-error quantile sketch (DDSketch): values land in logarithmic buckets
+ * so any quantile is reported within `kRelativeAccuracy` of a real sample. The
+ * bucket count is capped; past the cap the lowest buckets are collapsed, which
+ * only costs accuracy at the bottom of the distribution.
+ */
+class QuantileSketch {
+ public:
+  static constexpr double kRelativeAccuracy = 0.01;
+  static constexpr size_t kMaxBuckets = 2048;
+
+  void Add(double value);
+  uint64_t Count() const noexcept { return m_count; }
+  /** The value at `quantile` (0-1), or 0 when empty. */
+  double ValueAtQuantile(double quantile) const noexcept;
+  size_t BucketCount() const noexcept { return m_buckets.size(); }
+
+ private:
+  static int BucketIndex(double value) noexcept;
+  static double BucketValue(int index) noexcept;
+
+  std::vector<uint32_t> m_buckets; // m_buckets[i] counts index m_offset + i
+  int m_offset = 0;
+  uint64_t m_zeroCount = 0; // Values <= 0, too small for a logarithmic bucket
+  uint64_t m_count = 0;
+};
+
+/** Baseline distribution of one step, enough to test new runs against. */
+struct BenchmarkBaseline {
+  uint64_t count = 0;
+  double mean = 0;
+  double standardDeviation = 0;
+};
+
+enum class BenchmarkChange { NoBaseline, Unchanged, Improved, Regressed };
+
+struct BenchmarkStepVerdict {
+  std::string step;
+  double duration = 0;
+  BenchmarkChange change = BenchmarkChange::NoBaseline;
+  double ratio = 0;  // duration / baseline mean
+  double pValue = 1; // Two-sided
+};
+
+struct BenchmarkVerdict {
+  uint64_t run = 0; // 1-based run number of this title in the session
+  BenchmarkChange change = BenchmarkChange::NoBaseline; // Regressed if any step regressed
+  std::vector<BenchmarkStepVerdict> steps;
+};
+
+struct BenchmarkStepSummary {
+  std::string step;
+  RunningStats stats;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+  bool hasBaseline = false;
+  BenchmarkBaseline baseline;
+};
+
+/**
+ * Two-sided p-value of Student's t distribution with `degreesOfFreedom`.
+ */
+double StudentTTwoSidedPValue(double t, double degreesOfFreedom) noexcept;
+
+/**
+ * The aggregator. Step durations are the reports' `delta` values in ms; each run
+ * also records a synthetic "(total)" step. A step title that repeats within one
+ * run is numbered ("fetch", "fetch #2").
+ *
+ * A run is tested against the title's persisted baseline if it has one, otherwise
+ * against the session's earlier runs. Each step is a prediction-interval t-test
+ * of the new duration against the baseline distribution; it counts as a change
+ * when p < `kSignificance` and the duration moved by at least `kMinimumEffect`.
+ *
+ * Memory is bounded by `maxSeries` (title, step) pairs; steps past the cap are
+ * neither aggregated nor tested.
+ *
+ * Not thread-safe.
+ */
+class BenchmarkStats {
+ public:
+  static constexpr double kSignificance = 0.01;
+  static constexpr double kMinimumEffect = 0.05;
+  static constexpr uint64_t kMinimumBaselineRuns = 3;
+  static constexpr const char *kTotalStep = "(total)";
+
+  explicit BenchmarkStats(size_t maxSeries = 4096);
+
+  /** Records one report and returns how it compares with the baseline. */
+  BenchmarkVerdict Record(std::string_view title, const std::vector<std::string> &stepTitles,
+                          const std::vector<double> &deltas);
+
+  /** Per-step aggregates for `title`, in first-seen step order. */
+  std::vector<BenchmarkStepSummary> Summary(std::string_view title) const;
+
+  void SetBaseline(std::string_view title, std::string_view step, const BenchmarkBaseline &baseline);
+  /** Makes the session's aggregates the baseline of `title` and returns them by step. */
+  std::vector<std::pair<std::string, BenchmarkBaseline>> CaptureBaseline(std::string_view title);
+  void ClearBaseline(std::string_view title);
+
+  /** Forgets the session's runs; baselines are kept. */
+  void Clear();
+
+  size_t SeriesCount() const noexcept { return m_seriesCount; }
+
+ private:
+  struct Series {
+    std::string step;
+    RunningStats stats;
+    QuantileSketch sketch;
+    bool hasBaseline = false;
+    BenchmarkBaseline baseline;
+  };
+
+  struct Benchmark {
+    uint64_t runs = 0;
+    std::vector<Series> series; // First-seen order
+    std::unordered_map<std::string, size_t> index;
+  };
+
+  Benchmark &Lookup(std::string_view title);
+  Series *FindSeries(Benchmark &benchmark, const std::string &step, bool create);
+  static BenchmarkStepVerdict Test(const Series *series, const std::string &step, double duration);
+
+  size_t m_maxSeries;
+  size_t m_seriesCount = 0;
+  std::unordered_map<std::string, Benchmark> m_benchmarks;
+};
+
+} // namespace reactotron
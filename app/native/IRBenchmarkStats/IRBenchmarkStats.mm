@@ -0,0 +1,144 @@
+//
+//  IRBenchmarkStats.mm
+//  Reactotron-macOS
+//
+//  Cross-run aggregation and regression detection for benchmark.report commands.
+//
+
+#import "IRBenchmarkStats.h"
+#include "BenchmarkStats.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+@implementation IRBenchmarkStats {
+  reactotron::BenchmarkStats _stats;
+  std::mutex _statsMutex;
+}
+
+RCT_EXPORT_MODULE()
+
+static NSString *IRBenchmarkString(const std::string &string) {
+  return [NSString stringWithUTF8String:string.c_str()] ?: @"";
+}
+
+static NSString *IRBenchmarkChangeName(reactotron::BenchmarkChange change) {
+  switch (change) {
+    case reactotron::BenchmarkChange::Unchanged: return @"unchanged";
+    case reactotron::BenchmarkChange::Improved: return @"improved";
+    case reactotron::BenchmarkChange::Regressed: return @"regressed";
+    default: return @"none";
+  }
+}
+
+static NSDictionary *IRBenchmarkBaselineDictionary(const std::string &step, const reactotron::BenchmarkBaseline &baseline) {
+  return @{
+    @"step": IRBenchmarkString(step),
+    @"count": @(baseline.count),
+    @"mean": @(baseline.mean),
+    @"standardDeviation": @(baseline.standardDeviation),
+  };
+}
+
+- (NSDictionary *)record:(NSString *)title stepTitles:(NSArray *)stepTitles deltas:(NSArray *)deltas {
+  std::vector<std::string> steps;
+  steps.reserve(stepTitles.count);
+  for (id step in stepTitles) {
+    steps.emplace_back([step isKindOfClass:[NSString class]] ? [(NSString *)step UTF8String] : "");
+  }
+  std::vector<double> durations;
+  durations.reserve(deltas.count);
+  for (id delta in deltas) {
+    durations.push_back([delta isKindOfClass:[NSNumber class]] ? [(NSNumber *)delta doubleValue] : 0);
+  }
+
+  reactotron::BenchmarkVerdict verdict;
+  {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    verdict = _stats.Record(title.UTF8String ?: "", steps, durations);
+  }
+
+  NSMutableArray<NSDictionary *> *stepVerdicts = [NSMutableArray arrayWithCapacity:verdict.steps.size()];
+  for (const auto &step : verdict.steps) {
+    [stepVerdicts addObject:@{
+      @"step": IRBenchmarkString(step.step),
+      @"duration": @(step.duration),
+      @"change": IRBenchmarkChangeName(step.change),
+      @"ratio": @(step.ratio),
+      @"pValue": @(step.pValue),
+    }];
+  }
+  return @{
+    @"run": @(verdict.run),
+    @"change": IRBenchmarkChangeName(verdict.change),
+    @"steps": stepVerdicts,
+  };
+}
+
+- (NSArray<NSDictionary *> *)getSummary:(NSString *)title {
+  std::vector<reactotron::BenchmarkStepSummary> summary;
+  {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    summary = _stats.Summary(title.UTF8String ?: "");
+  }
+
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:summary.size()];
+  for (const auto &step : summary) {
+    NSMutableDictionary *entry = [@{
+      @"step": IRBenchmarkString(step.step),
+      @"count": @(step.stats.count),
+      @"mean": @(step.stats.mean),
+      @"standardDeviation": @(step.stats.StandardDeviation()),
+      @"min": @(step.stats.min),
+      @"max": @(step.stats.max),
+      @"p50": @(step.p50),
+      @"p90": @(step.p90),
+      @"p99": @(step.p99),
+    } mutableCopy];
+    if (step.hasBaseline) entry[@"baseline"] = IRBenchmarkBaselineDictionary(step.step, step.baseline);
+    [result addObject:entry];
+  }
+  return result;
+}
+
+- (void)setBaseline:(NSString *)title
+               step:(NSString *)step
+              count:(double)count
+               mean:(double)mean
+  standardDeviation:(double)standardDeviation {
+  reactotron::BenchmarkBaseline baseline;
+  baseline.count = (uint64_t)MAX(count, 0);
+  baseline.mean = mean;
+  baseline.standardDeviation = standardDeviation;
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  _stats.SetBaseline(title.UTF8String ?: "", step.UTF8String ?: "", baseline);
+}
+
+- (NSArray<NSDictionary *> *)captureBaseline:(NSString *)title {
+  std::vector<std::pair<std::string, reactotron::BenchmarkBaseline>> captured;
+  {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    captured = _stats.CaptureBaseline(title.UTF8String ?: "");
+  }
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:captured.size()];
+  for (const auto &entry : captured) {
+    [result addObject:IRBenchmarkBaselineDictionary(entry.first, entry.second)];
+  }
+  return result;
+}
+
+- (void)clearBaseline:(NSString *)title {
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  _stats.ClearBaseline(title.UTF8String ?: "");
+}
+
+- (void)clear {
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  _stats.Clear();
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRBenchmarkStatsSpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,125 @@
+//
+//  IRBenchmarkStats.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared BenchmarkStats aggregator
+//
+
+#include "pch.h"
+#include "IRBenchmarkStats.windows.h"
+#include <algorithm>
+
+namespace winrt::reactotron::implementation
+{
+    namespace
+    {
+        const char *ChangeName(::reactotron::BenchmarkChange change) noexcept
+        {
+            switch (change)
+            {
+            case ::reactotron::BenchmarkChange::Unchanged: return "unchanged";
+            case ::reactotron::BenchmarkChange::Improved: return "improved";
+            case ::reactotron::BenchmarkChange::Regressed: return "regressed";
+            default: return "none";
+            }
+        }
+
+        Microsoft::ReactNative::JSValueObject BaselineObject(const std::string &step, const ::reactotron::BenchmarkBaseline &baseline)
+        {
+            Microsoft::ReactNative::JSValueObject object;
+            object["step"] = step;
+            object["count"] = static_cast<double>(baseline.count);
+            object["mean"] = baseline.mean;
+            object["standardDeviation"] = baseline.standardDeviation;
+            return object;
+        }
+    }
+
+    Microsoft::ReactNative::JSValue IRBenchmarkStats::record(std::string title, std::vector<std::string> stepTitles, std::vector<double> deltas) noexcept
+    {
+        ::reactotron::BenchmarkVerdict verdict;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            verdict = m_stats.Record(title, stepTitles, deltas);
+        }
+
+        Microsoft::ReactNative::JSValueArray steps;
+        for (const auto &step : verdict.steps)
+        {
+            Microsoft::ReactNative::JSValueObject stepVerdict;
+            stepVerdict["step"] = step.step;
+            stepVerdict["duration"] = step.duration;
+            stepVerdict["change"] = ChangeName(step.change);
+            stepVerdict["ratio"] = step.ratio;
+            stepVerdict["pValue"] = step.pValue;
+            steps.push_back(std::move(stepVerdict));
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["run"] = static_cast<double>(verdict.run);
+        result["change"] = ChangeName(verdict.change);
+        result["steps"] = std::move(steps);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    Microsoft::ReactNative::JSValue IRBenchmarkStats::getSummary(std::string title) noexcept
+    {
+        std::vector<::reactotron::BenchmarkStepSummary> summary;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            summary = m_stats.Summary(title);
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (const auto &step : summary)
+        {
+            Microsoft::ReactNative::JSValueObject entry;
+            entry["step"] = step.step;
+            entry["count"] = static_cast<double>(step.stats.count);
+            entry["mean"] = step.stats.mean;
+            entry["standardDeviation"] = step.stats.StandardDeviation();
+            entry["min"] = step.stats.min;
+            entry["max"] = step.stats.max;
+            entry["p50"] = step.p50;
+            entry["p90"] = step.p90;
+            entry["p99"] = step.p99;
+            if (step.hasBaseline) entry["baseline"] = BaselineObject(step.step, step.baseline);
+            result.push_back(std::move(entry));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    void IRBenchmarkStats::setBaseline(std::string title, std::string step, double count, double mean, double standardDeviation) noexcept
+    {
+        ::reactotron::BenchmarkBaseline baseline;
+        baseline.count = static_cast<uint64_t>((std::max)(count, 0.0));
+        baseline.mean = mean;
+        baseline.standardDeviation = standardDeviation;
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.SetBaseline(title, step, baseline);
+    }
+
+    Microsoft::ReactNative::JSValue IRBenchmarkStats::captureBaseline(std::string title) noexcept
+    {
+        std::vector<std::pair<std::string, ::reactotron::BenchmarkBaseline>> captured;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            captured = m_stats.CaptureBaseline(title);
+        }
+        Microsoft::ReactNative::JSValueArray result;
+        for (const auto &entry : captured) result.push_back(BaselineObject(entry.first, entry.second));
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    void IRBenchmarkStats::clearBaseline(std::string title) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.ClearBaseline(title);
+    }
+
+    void IRBenchmarkStats::clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.Clear();
+    }
+}
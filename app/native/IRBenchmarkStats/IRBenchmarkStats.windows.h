@@ -0,0 +1,35 @@
+#pragma once
+#include "NativeModules.h"
+#include "BenchmarkStats.h"
+#include <mutex>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRBenchmarkStats)
+    struct IRBenchmarkStats
+    {
+        IRBenchmarkStats() noexcept = default;
+
+        REACT_SYNC_METHOD(record)
+        Microsoft::ReactNative::JSValue record(std::string title, std::vector<std::string> stepTitles, std::vector<double> deltas) noexcept;
+
+        REACT_SYNC_METHOD(getSummary)
+        Microsoft::ReactNative::JSValue getSummary(std::string title) noexcept;
+
+        REACT_METHOD(setBaseline)
+        void setBaseline(std::string title, std::string step, double count, double mean, double standardDeviation) noexcept;
+
+        REACT_SYNC_METHOD(captureBaseline)
+        Microsoft::ReactNative::JSValue captureBaseline(std::string title) noexcept;
+
+        REACT_METHOD(clearBaseline)
+        void clearBaseline(std::string title) noexcept;
+
+        REACT_METHOD(clear)
+        void clear() noexcept;
+
+    private:
+        ::reactotron::BenchmarkStats m_stats;
+        std::mutex m_statsMutex;
+    };
+}
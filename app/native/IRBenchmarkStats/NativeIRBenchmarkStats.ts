@@ -0,0 +1,60 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+/** "none" until the step has a baseline (or at least 3 earlier runs) to compare with. */
+export type BenchmarkChange = "none" | "unchanged" | "improved" | "regressed"
+
+export interface BenchmarkStepVerdict {
+  step: string
+  duration: number
+  change: string
+  /** duration / baseline mean, 0 without a baseline. */
+  ratio: number
+  pValue: number
+}
+
+export interface BenchmarkVerdict {
+  /** 1-based run number of this benchmark title in the session. */
+  run: number
+  change: string
+  steps: ReadonlyArray<BenchmarkStepVerdict>
+}
+
+export interface BenchmarkBaseline {
+  step: string
+  count: number
+  mean: number
+  standardDeviation: number
+}
+
+export interface BenchmarkStepSummary {
+  step: string
+  count: number
+  mean: number
+  standardDeviation: number
+  min: number
+  max: number
+  p50: number
+  p90: number
+  p99: number
+  baseline?: BenchmarkBaseline
+}
+
+export interface Spec extends TurboModule {
+  /** Step titles and deltas of one benchmark.report, including the start marker. */
+  record(title: string, stepTitles: string[], deltas: number[]): BenchmarkVerdict
+  getSummary(title: string): ReadonlyArray<BenchmarkStepSummary>
+  setBaseline(
+    title: string,
+    step: string,
+    count: number,
+    mean: number,
+    standardDeviation: number,
+  ): void
+  /** Makes this session's runs of `title` its baseline. */
+  captureBaseline(title: string): ReadonlyArray<BenchmarkBaseline>
+  clearBaseline(title: string): void
+  clear(): void
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRBenchmarkStats")
@@ -0,0 +1,964 @@
+//
+//  BodyDecoding.cpp
+//  Reactotron
+//
+
+#include "BodyDecoding.h"
+#include "../TextTranscoding/TextTranscoding.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__APPLE__)
+#include <compression.h>
+#elif defined(_WIN32)
+// No system deflate or brotli decoder
+#else
+#if __has_include(<brotli/decode.h>)
+#define IR_BODY_BROTLI 1
+#include <brotli/decode.h>
+#endif
+#if __has_include(<zlib.h>)
+#define IR_BODY_ZLIB 1
+#include <climits>
+#include <zlib.h>
+#endif
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kSniffBytes = 256;
+constexpr size_t kMinBase64Length = 16;
+
+inline bool IsSpace(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+inline char ToLower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+std::string_view Trim(std::string_view text) noexcept {
+  while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+  while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+  return text;
+}
+
+std::string Lower(std::string_view text) {
+  std::string lower(text);
+  for (char &c : lower) c = ToLower(c);
+  return lower;
+}
+
+// ---- Base64 ----
+
+constexpr int8_t kInvalid = -1;
+constexpr int8_t kSkip = -2;
+constexpr int8_t kPad = -3;
+
+constexpr std::array<int8_t, 256> MakeBase64Table() {
+  std::array<int8_t, 256> table{};
+  for (auto &entry : table) entry = kInvalid;
+  for (int i = 0; i < 26; ++i) {
+    table['A' + i] = static_cast<int8_t>(i);
+    table['a' + i] = static_cast<int8_t>(26 + i);
+  }
+  for (int i = 0; i < 10; ++i) table['0' + i] = static_cast<int8_t>(52 + i);
+  table['+'] = table['-'] = 62;
+  table['/'] = table['_'] = 63;
+  table['='] = kPad;
+  table[' '] = table['\n'] = table['\r'] = table['\t'] = kSkip;
+  return table;
+}
+
+constexpr std::array<int8_t, 256> kBase64 = MakeBase64Table();
+
+/** Everything is in the base64 alphabet and there's enough of it to be worth trying. */
+bool LooksLikeBase64(std::string_view text) noexcept {
+  size_t digits = 0;
+  bool padded = false;
+  for (char c : text) {
+    int8_t value = kBase64[static_cast<uint8_t>(c)];
+    if (value == kInvalid) return false;
+    if (value == kPad) {
+      padded = true;
+    } else if (value >= 0) {
+      if (padded) return false; // Data after padding
+      ++digits;
+    }
+  }
+  return digits >= kMinBase64Length && digits % 4 != 1;
+}
+
+bool HasCompressionMagic(std::string_view bytes) noexcept {
+  if (bytes.size() < 2) return false;
+  auto b0 = static_cast<uint8_t>(bytes[0]);
+  auto b1 = static_cast<uint8_t>(bytes[1]);
+  if (b0 == 0x1F && b1 == 0x8B) return true;
+  return (b0 & 0x0F) == 8 && (b0 >> 4) <= 7 && ((b0 << 8) | b1) % 31 == 0 && !(b1 & 0x20);
+}
+
+// ---- Inflate ----
+
+constexpr uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistanceBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+/** Reads DEFLATE's least-significant-bit-first stream. Past the end it reads zeros, and Drop() fails. */
+class BitReader {
+ public:
+  explicit BitReader(std::string_view data)
+      : m_p(reinterpret_cast<const uint8_t *>(data.data())), m_end(m_p + data.size()) {}
+
+  uint32_t Peek(unsigned count) noexcept {
+    if (m_count < count) Refill();
+    return static_cast<uint32_t>(m_bits & ((uint64_t{1} << count) - 1));
+  }
+
+  bool Drop(unsigned count) noexcept {
+    if (m_count < count) return false;
+    m_bits >>= count;
+    m_count -= count;
+    return true;
+  }
+
+  bool Get(unsigned count, uint32_t &value) noexcept {
+    value = Peek(count);
+    return Drop(count);
+  }
+
+  void AlignToByte() noexcept { Drop(m_count % 8); }
+
+  /** After AlignToByte(). */
+  bool CopyBytes(size_t count, std::string &out) {
+    for (; count > 0 && m_count >= 8; --count) {
+      out.push_back(static_cast<char>(m_bits & 0xFF));
+      m_bits >>= 8;
+      m_count -= 8;
+    }
+    if (static_cast<size_t>(m_end - m_p) < count) return false;
+    out.append(reinterpret_cast<const char *>(m_p), count);
+    m_p += count;
+    return true;
+  }
+
+ private:
+  void Refill() noexcept {
+    while (m_count <= 56 && m_p < m_end) {
+      m_bits |= static_cast<uint64_t>(*m_p++) << m_count;
+      m_count += 8;
+    }
+  }
+
+  const uint8_t *m_p;
+  const uint8_t *m_end;
+  uint64_t m_bits = 0;
+  unsigned m_count = 0;
+};
+
+/** A canonical Huffman code, decoded with one table lookup per symbol. */
+class Huffman {
+ public:
+  /**
+   * False for a code that zlib would refuse: oversubscribed, or incomplete
+   * other than a single 1-bit code, which is never allowed for the code
+   * length code.
+   */
+  bool Build(const uint8_t *lengths, size_t count, bool codeLengthCode = false) {
+    uint16_t counts[16] = {};
+    for (size_t i = 0; i < count; ++i) counts[lengths[i]]++;
+    counts[0] = 0;
+    m_bits = 0;
+    for (unsigned length = 1; length <= 15; ++length) {
+      if (counts[length]) m_bits = length;
+    }
+    m_table.clear();
+    if (m_bits == 0) return true; // No codes; only an error to use
+
+    int left = 1;
+    for (unsigned length = 1; length <= 15; ++length) {
+      left = (left << 1) - counts[length];
+      if (left < 0) return false; // Oversubscribed
+    }
+    if (left > 0 && (codeLengthCode || m_bits != 1)) return false; // Incomplete
+
+    uint16_t next[16] = {};
+    uint32_t code = 0;
+    for (unsigned length = 1; length <= 15; ++length) {
+      code = (code + counts[length - 1]) << 1;
+      next[length] = static_cast<uint16_t>(code);
+    }
+
+    m_table.assign(size_t{1} << m_bits, 0);
+    for (size_t symbol = 0; symbol < count; ++symbol) {
+      unsigned length = lengths[symbol];
+      if (!length) continue;
+      uint32_t reversed = 0;
+      for (uint32_t c = next[length]++, i = 0; i < length; ++i, c >>= 1) reversed = (reversed << 1) | (c & 1);
+      for (size_t entry = reversed; entry < m_table.size(); entry += size_t{1} << length) {
+        m_table[entry] = static_cast<uint16_t>(symbol << 4 | length);
+      }
+    }
+    return true;
+  }
+
+  /** The next symbol, or -1. */
+  int Decode(BitReader &in) const noexcept {
+    if (m_bits == 0) return -1;
+    uint16_t entry = m_table[in.Peek(m_bits)];
+    unsigned length = entry & 0x0F;
+    if (length == 0 || !in.Drop(length)) return -1;
+    return entry >> 4;
+  }
+
+ private:
+  std::vector<uint16_t> m_table; // Symbol << 4 | code length, by the next m_bits bits
+  unsigned m_bits = 0;
+};
+
+struct FixedCodes {
+  Huffman literals;
+  Huffman distances;
+
+  FixedCodes() {
+    uint8_t lengths[288];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + 288, 8);
+    literals.Build(lengths, 288);
+    std::fill(lengths, lengths + 32, 5); // 30 and 31 complete the code but are invalid distances
+    distances.Build(lengths, 32);
+  }
+};
+
+bool ReadDynamicCodes(BitReader &in, Huffman &literals, Huffman &distances) {
+  uint32_t literalCount, distanceCount, codeLengthCount;
+  if (!in.Get(5, literalCount) || !in.Get(5, distanceCount) || !in.Get(4, codeLengthCount)) return false;
+  literalCount += 257;
+  distanceCount += 1;
+  codeLengthCount += 4;
+  if (literalCount > 286 || distanceCount > 30) return false;
+
+  uint8_t codeLengthLengths[19] = {};
+  for (uint32_t i = 0; i < codeLengthCount; ++i) {
+    uint32_t length;
+    if (!in.Get(3, length)) return false;
+    codeLengthLengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(length);
+  }
+  Huffman codeLengths;
+  if (!codeLengths.Build(codeLengthLengths, 19, true)) return false;
+
+  uint8_t lengths[286 + 30] = {};
+  uint32_t total = literalCount + distanceCount;
+  for (uint32_t i = 0; i < total;) {
+    int symbol = codeLengths.Decode(in);
+    if (symbol < 0) return false;
+    if (symbol < 16) {
+      lengths[i++] = static_cast<uint8_t>(symbol);
+      continue;
+    }
+    uint32_t repeat;
+    uint8_t value = 0;
+    if (symbol == 16) {
+      if (i == 0 || !in.Get(2, repeat)) return false;
+      value = lengths[i - 1];
+      repeat += 3;
+    } else if (symbol == 17) {
+      if (!in.Get(3, repeat)) return false;
+      repeat += 3;
+    } else {
+      if (!in.Get(7, repeat)) return false;
+      repeat += 11;
+    }
+    if (i + repeat > total) return false;
+    std::fill(lengths + i, lengths + i + repeat, value);
+    i += repeat;
+  }
+  if (lengths[256] == 0) return false; // No end of block
+  return literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+}
+
+bool InflateBlock(BitReader &in, const Huffman &literals, const Huffman &distances, std::string &out, size_t maxSize) {
+  for (;;) {
+    int symbol = literals.Decode(in);
+    if (symbol < 0) return false;
+    if (symbol < 256) {
+      if (out.size() >= maxSize) return false;
+      out.push_back(static_cast<char>(symbol));
+      continue;
+    }
+    if (symbol == 256) return true;
+
+    symbol -= 257;
+    if (symbol >= 29) return false;
+    uint32_t extra;
+    if (!in.Get(kLengthExtra[symbol], extra)) return false;
+    size_t length = kLengthBase[symbol] + extra;
+    int distanceSymbol = distances.Decode(in);
+    if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+    if (!in.Get(kDistanceExtra[distanceSymbol], extra)) return false;
+    size_t distance = kDistanceBase[distanceSymbol] + extra;
+    if (distance > out.size() || length > maxSize - out.size()) return false;
+
+    size_t from = out.size() - distance;
+    if (distance >= length) {
+      if (out.capacity() < out.size() + length) out.reserve(std::max(out.capacity() * 2, out.size() + length));
+      out.append(out.data() + from, length);
+    } else {
+      for (size_t i = 0; i < length; ++i) out.push_back(out[from + i]); // Overlaps what it writes
+    }
+  }
+}
+
+/** Matches may reach back into `dictionary`, which is left at the start of `out`. */
+bool InflateRaw(std::string_view data, std::string &out, size_t maxSize, std::string_view dictionary = {}) {
+  static const FixedCodes fixed;
+  BitReader in(data);
+  maxSize += dictionary.size();
+  out.reserve(std::min(maxSize, dictionary.size() + data.size() * 4));
+  out.assign(dictionary);
+  Huffman literals;
+  Huffman distances;
+  for (;;) {
+    uint32_t final, type;
+    if (!in.Get(1, final) || !in.Get(2, type)) return false;
+    if (type == 0) {
+      in.AlignToByte();
+      uint32_t length, complement;
+      if (!in.Get(16, length) || !in.Get(16, complement) || (length ^ 0xFFFF) != complement) return false;
+      if (length > maxSize - out.size() || !in.CopyBytes(length, out)) return false;
+    } else if (type == 1) {
+      if (!InflateBlock(in, fixed.literals, fixed.distances, out, maxSize)) return false;
+    } else if (type == 2) {
+      if (!ReadDynamicCodes(in, literals, distances)) return false;
+      if (!InflateBlock(in, literals, distances, out, maxSize)) return false;
+    } else {
+      return false;
+    }
+    if (final) return true;
+  }
+}
+
+/** Where the DEFLATE data starts after a gzip header, or 0 if it isn't one. */
+size_t GzipHeaderSize(std::string_view data) noexcept {
+  auto byte = [&](size_t i) { return static_cast<uint8_t>(data[i]); };
+  if (data.size() < 18 || byte(0) != 0x1F || byte(1) != 0x8B || byte(2) != 8) return 0;
+  uint8_t flags = byte(3);
+  size_t at = 10;
+  if (flags & 0x04) { // FEXTRA
+    if (at + 2 > data.size()) return 0;
+    at += 2 + (byte(at) | byte(at + 1) << 8);
+  }
+  for (uint8_t flag : {uint8_t{0x08}, uint8_t{0x10}}) { // FNAME, FCOMMENT
+    if (!(flags & flag)) continue;
+    while (at < data.size() && data[at] != '\0') ++at;
+    ++at;
+  }
+  if (flags & 0x02) at += 2; // FHCRC
+  return at < data.size() ? at : 0;
+}
+
+/** Narrows `data` to the DEFLATE data inside `wrapper`. False if it isn't wrapped that way. */
+bool Unwrap(std::string_view &data, DeflateWrapper wrapper) noexcept {
+  if (wrapper == DeflateWrapper::Gzip) {
+    size_t header = GzipHeaderSize(data);
+    if (header == 0) return false;
+    data.remove_prefix(header);
+  } else if (wrapper == DeflateWrapper::Zlib) {
+    if (data.size() < 6) return false;
+    auto cmf = static_cast<uint8_t>(data[0]);
+    auto flg = static_cast<uint8_t>(data[1]);
+    if ((cmf & 0x0F) != 8 || (cmf << 8 | flg) % 31 != 0 || (flg & 0x20)) return false; // No preset dictionaries
+    data.remove_prefix(2);
+  }
+  return true;
+}
+
+#if defined(__APPLE__)
+/** Decodes with libcompression, which takes DEFLATE without a wrapper as COMPRESSION_ZLIB. */
+bool DecodeWithCompression(compression_algorithm algorithm, std::string_view data, std::string &out, size_t maxSize) {
+  out.clear();
+  compression_stream stream;
+  if (compression_stream_init(&stream, COMPRESSION_STREAM_DECODE, algorithm) != COMPRESSION_STATUS_OK) return false;
+  std::vector<uint8_t> buffer(64 * 1024);
+  stream.src_ptr = reinterpret_cast<const uint8_t *>(data.data());
+  stream.src_size = data.size();
+  compression_status status;
+  do {
+    stream.dst_ptr = buffer.data();
+    stream.dst_size = buffer.size();
+    status = compression_stream_process(&stream, COMPRESSION_STREAM_FINALIZE);
+    out.append(reinterpret_cast<const char *>(buffer.data()), buffer.size() - stream.dst_size);
+  } while (status == COMPRESSION_STATUS_OK && out.size() <= maxSize);
+  compression_stream_destroy(&stream);
+  return status == COMPRESSION_STATUS_END && out.size() <= maxSize;
+}
+#elif defined(IR_BODY_ZLIB)
+bool InflateWithZlib(std::string_view data, std::string &out, size_t maxSize) {
+  out.clear();
+  z_stream stream{};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+  std::vector<uint8_t> buffer(64 * 1024);
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  size_t remaining = data.size();
+  int result;
+  do {
+    if (stream.avail_in == 0 && remaining > 0) { // avail_in is 32-bit
+      stream.avail_in = static_cast<uInt>(std::min<size_t>(remaining, UINT_MAX));
+      remaining -= stream.avail_in;
+    }
+    stream.next_out = buffer.data();
+    stream.avail_out = static_cast<uInt>(buffer.size());
+    result = inflate(&stream, Z_NO_FLUSH);
+    out.append(reinterpret_cast<const char *>(buffer.data()), buffer.size() - stream.avail_out);
+  } while (result == Z_OK && out.size() <= maxSize);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && out.size() <= maxSize;
+}
+#endif
+
+// ---- Text ----
+
+/** Windows-1252's 0x80-0x9F; the rest of it is Latin-1. Unassigned bytes map to U+FFFD. */
+constexpr char16_t kWindows1252[32] = {
+    0x20AC, 0xFFFD, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+    0x2039, 0x0152, 0xFFFD, 0x017D, 0xFFFD, 0xFFFD, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+    0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0xFFFD, 0x017E, 0x0178};
+
+/** A parameter of a header value, such as the charset of a content type, lower case and unquoted. */
+std::string HeaderParameter(std::string_view header, std::string_view name) {
+  std::string lower = Lower(header);
+  std::string_view rest(lower);
+  for (size_t semicolon = rest.find(';'); semicolon != std::string_view::npos; semicolon = rest.find(';')) {
+    rest.remove_prefix(semicolon + 1);
+    std::string_view parameter = Trim(rest.substr(0, rest.find(';')));
+    size_t equals = parameter.find('=');
+    if (equals == std::string_view::npos || Trim(parameter.substr(0, equals)) != name) continue;
+    std::string_view value = Trim(parameter.substr(equals + 1));
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') value = value.substr(1, value.size() - 2);
+    return std::string(value);
+  }
+  return {};
+}
+
+std::string MediaType(std::string_view contentType) { return Lower(Trim(contentType.substr(0, contentType.find(';')))); }
+
+bool IsJsonType(std::string_view media) noexcept {
+  return media == "application/json" || (media.size() > 5 && media.substr(media.size() - 5) == "+json");
+}
+
+bool IsTextType(std::string_view media) noexcept {
+  static constexpr std::string_view kTextual[] = {"json", "xml", "javascript", "ecmascript", "x-www-form-urlencoded",
+                                                  "graphql", "csv", "yaml", "html"};
+  if (media.compare(0, 5, "text/") == 0) return true;
+  return std::any_of(std::begin(kTextual), std::end(kTextual),
+                     [&](std::string_view part) { return media.find(part) != std::string_view::npos; });
+}
+
+bool IsBinaryType(std::string_view media) noexcept {
+  static constexpr std::string_view kBinary[] = {"image/", "audio/", "video/", "font/", "application/octet-stream",
+                                                 "application/pdf", "application/zip", "application/protobuf",
+                                                 "application/x-protobuf", "application/wasm"};
+  return std::any_of(std::begin(kBinary), std::end(kBinary),
+                     [&](std::string_view prefix) { return media.compare(0, prefix.size(), prefix) == 0; });
+}
+
+bool HasByteOrderMark(std::string_view bytes) noexcept {
+  return bytes.compare(0, 3, "\xEF\xBB\xBF") == 0 || bytes.compare(0, 2, "\xFF\xFE") == 0 ||
+         bytes.compare(0, 2, "\xFE\xFF") == 0;
+}
+
+/** Nothing but printable characters and whitespace, as text would be. */
+bool IsPrintableUtf8(std::string_view bytes) noexcept {
+  for (char c : bytes) {
+    auto b = static_cast<uint8_t>(c);
+    if (b < 0x20 && b != '\n' && b != '\r' && b != '\t') return false;
+  }
+  return IsValidUtf8(bytes.data(), bytes.size());
+}
+
+std::string Utf16BytesToUtf8(std::string_view bytes, bool bigEndian) {
+  std::u16string units(bytes.size() / 2, u'\0');
+  for (size_t i = 0; i < units.size(); ++i) {
+    auto hi = static_cast<uint8_t>(bytes[2 * i + (bigEndian ? 0 : 1)]);
+    auto lo = static_cast<uint8_t>(bytes[2 * i + (bigEndian ? 1 : 0)]);
+    units[i] = static_cast<char16_t>(hi << 8 | lo);
+  }
+  return Utf16ToUtf8(units);
+}
+
+std::string SingleByteToUtf8(std::string_view bytes) {
+  std::u16string units(bytes.size(), u'\0');
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    auto b = static_cast<uint8_t>(bytes[i]);
+    units[i] = b >= 0x80 && b < 0xA0 ? kWindows1252[b - 0x80] : static_cast<char16_t>(b);
+  }
+  return Utf16ToUtf8(units);
+}
+
+/** Converts decoded bytes to UTF-8 text; false if they don't look like text at all. */
+bool BytesToText(std::string_view bytes, std::string_view contentType, std::string &text,
+                 std::vector<std::string> &steps) {
+  auto starts = [&](std::string_view bom) { return bytes.compare(0, bom.size(), bom) == 0; };
+  if (starts("\xEF\xBB\xBF")) bytes.remove_prefix(3);
+  std::string charset = HeaderParameter(contentType, "charset");
+  if (starts("\xFF\xFE") || starts("\xFE\xFF")) {
+    charset = bytes[0] == '\xFF' ? "utf-16le" : "utf-16be";
+    bytes.remove_prefix(2);
+  }
+
+  if (charset == "utf-16le" || charset == "utf-16") {
+    text = Utf16BytesToUtf8(bytes, false);
+  } else if (charset == "utf-16be") {
+    text = Utf16BytesToUtf8(bytes, true);
+  } else if (charset == "iso-8859-1" || charset == "latin1" || charset == "windows-1252" || charset == "cp1252" ||
+             charset == "us-ascii" || charset == "ascii") {
+    if (IsValidUtf8(bytes.data(), bytes.size()) && charset.find("ascii") != std::string::npos) {
+      text.assign(bytes);
+      return true;
+    }
+    text = SingleByteToUtf8(bytes);
+  } else {
+    // UTF-8, whether or not it says so; another charset isn't converted
+    if (!IsPrintableUtf8(bytes.substr(0, std::min<size_t>(bytes.size(), 4096))) ||
+        !IsValidUtf8(bytes.data(), bytes.size())) {
+      return false;
+    }
+    text.assign(bytes);
+    return true;
+  }
+  steps.push_back("charset:" + charset);
+  return true;
+}
+
+std::string HexDump(std::string_view bytes) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  size_t shown = std::min(bytes.size(), kHexDumpBytes);
+  std::string out;
+  out.reserve(shown / 16 * 78 + 80);
+  for (size_t line = 0; line < shown; line += 16) {
+    char offset[24]; // Room for any size_t, though dumps stop at kHexDumpBytes
+    std::snprintf(offset, sizeof(offset), "%08zx  ", line);
+    out += offset;
+    for (size_t i = line; i < line + 16; ++i) {
+      if (i < shown) {
+        auto b = static_cast<uint8_t>(bytes[i]);
+        out += kHex[b >> 4];
+        out += kHex[b & 0x0F];
+        out += ' ';
+      } else {
+        out += "   ";
+      }
+      if (i == line + 7) out += ' ';
+    }
+    out += " |";
+    for (size_t i = line; i < line + 16 && i < shown; ++i) {
+      auto b = static_cast<uint8_t>(bytes[i]);
+      out += b >= 0x20 && b < 0x7F ? static_cast<char>(b) : '.';
+    }
+    out += "|\n";
+  }
+  if (shown < bytes.size()) out += "... " + std::to_string(bytes.size() - shown) + " more bytes\n";
+  return out;
+}
+
+// ---- JSON ----
+
+/** The closing quote of the string opening at `open`, or npos. */
+size_t StringEnd(std::string_view text, size_t open) noexcept {
+  for (size_t i = open + 1; i < text.size(); ++i) {
+    auto c = static_cast<uint8_t>(text[i]);
+    if (c == '"') return i;
+    if (c < 0x20) return std::string_view::npos;
+    if (c == '\\') {
+      if (++i >= text.size()) return std::string_view::npos;
+      if (text[i] == 'u') {
+        if (i + 4 >= text.size()) return std::string_view::npos;
+        for (size_t j = i + 1; j <= i + 4; ++j) {
+          if (!std::isxdigit(static_cast<unsigned char>(text[j]))) return std::string_view::npos;
+        }
+        i += 4;
+      } else if (!std::strchr("\"\\/bfnrt", text[i]) || text[i] == '\0') {
+        return std::string_view::npos;
+      }
+    }
+  }
+  return std::string_view::npos;
+}
+
+size_t ScalarEnd(std::string_view text, size_t i) noexcept {
+  for (std::string_view literal : {"true", "false", "null"}) {
+    if (text.compare(i, literal.size(), literal) == 0) return i + literal.size();
+  }
+  size_t start = i;
+  auto digits = [&] {
+    size_t from = i;
+    while (i < text.size() && text[i] >= '0' && text[i] <= '9') ++i;
+    return i > from;
+  };
+  if (i < text.size() && text[i] == '-') ++i;
+  if (i < text.size() && text[i] == '0') {
+    ++i;
+  } else if (!digits()) {
+    return std::string_view::npos;
+  }
+  if (i < text.size() && text[i] == '.' && (++i, !digits())) return std::string_view::npos;
+  if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+    ++i;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-')) ++i;
+    if (!digits()) return std::string_view::npos;
+  }
+  return i > start ? i : std::string_view::npos;
+}
+
+size_t SkipSpace(std::string_view text, size_t i) noexcept {
+  while (i < text.size() && IsSpace(text[i])) ++i;
+  return i;
+}
+
+/** Text that starts like an object or array, worth checking for JSON even if the type doesn't say so. */
+bool OpensJson(std::string_view text) noexcept {
+  size_t i = SkipSpace(text, 0);
+  return i < text.size() && (text[i] == '{' || text[i] == '[');
+}
+
+void AppendUtf8(uint32_t code, std::string &out) {
+  if (code < 0x80) {
+    out += static_cast<char>(code);
+  } else if (code < 0x800) {
+    out += static_cast<char>(0xC0 | code >> 6);
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else if (code < 0x10000) {
+    out += static_cast<char>(0xE0 | code >> 12);
+    out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | code >> 18);
+    out += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+    out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  }
+}
+
+uint32_t Hex4(std::string_view text, size_t at) noexcept {
+  uint32_t value = 0;
+  for (size_t i = at; i < at + 4; ++i) {
+    char h = text[i];
+    value = value * 16 + static_cast<uint32_t>(h <= '9' ? h - '0' : (h | 0x20) - 'a' + 10);
+  }
+  return value;
+}
+
+} // namespace
+
+const char *BodyFormatName(BodyFormat format) noexcept {
+  switch (format) {
+    case BodyFormat::Json:
+      return "json";
+    case BodyFormat::Text:
+      return "text";
+    case BodyFormat::Base64:
+      return "base64";
+  }
+  return "text";
+}
+
+BodyFormat SniffBody(std::string_view raw) noexcept {
+  raw = Trim(raw);
+  if (raw.empty() || raw[0] != '"') return BodyFormat::Json;
+  // Only a prefix: a few hundred bytes say as much as the whole body
+  std::string_view prefix = raw.substr(1, kSniffBytes);
+  if (raw.size() - 1 <= kSniffBytes) prefix.remove_suffix(1); // The whole string; drop its closing quote
+  return LooksLikeBase64(prefix) ? BodyFormat::Base64 : BodyFormat::Text;
+}
+
+bool UnescapeJsonString(std::string_view literal, std::string &out) {
+  if (literal.size() < 2 || literal.front() != '"' || literal.back() != '"') return false;
+  std::string_view text = literal.substr(1, literal.size() - 2);
+  out.clear();
+  out.reserve(text.size());
+  for (size_t i = 0; i < text.size();) {
+    size_t escape = text.find('\\', i);
+    out.append(text.substr(i, escape == std::string_view::npos ? std::string_view::npos : escape - i));
+    if (escape == std::string_view::npos) break;
+    i = escape + 1;
+    if (i >= text.size()) return false;
+    char c = text[i++];
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        out += c;
+        break;
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        if (i + 4 > text.size()) return false;
+        uint32_t code = Hex4(text, i);
+        i += 4;
+        if (code >= 0xD800 && code < 0xDC00 && i + 6 <= text.size() && text[i] == '\\' && text[i + 1] == 'u') {
+          uint32_t low = Hex4(text, i + 2);
+          if (low >= 0xDC00 && low < 0xE000) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          }
+        }
+        if (code >= 0xD800 && code < 0xE000) code = 0xFFFD; // Lone surrogate
+        AppendUtf8(code, out);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool DecodeBase64(std::string_view text, std::string &out) {
+  out.clear();
+  out.reserve(text.size() / 4 * 3 + 3);
+  uint32_t bits = 0;
+  int count = 0;
+  bool padded = false;
+  for (char c : text) {
+    int8_t value = kBase64[static_cast<uint8_t>(c)];
+    if (value == kSkip) continue;
+    if (value == kPad) {
+      padded = true;
+      continue;
+    }
+    if (value == kInvalid || padded) return false;
+    bits = bits << 6 | static_cast<uint32_t>(value);
+    if (++count == 4) {
+      out += static_cast<char>(bits >> 16);
+      out += static_cast<char>(bits >> 8);
+      out += static_cast<char>(bits);
+      bits = 0;
+      count = 0;
+    }
+  }
+  if (count == 1) return false;
+  if (count == 2) out += static_cast<char>(bits >> 4);
+  if (count == 3) {
+    out += static_cast<char>(bits >> 10);
+    out += static_cast<char>(bits >> 2);
+  }
+  return true;
+}
+
+bool Inflate(std::string_view data, DeflateWrapper wrapper, std::string &out, size_t maxSize) {
+  if (!Unwrap(data, wrapper)) return false;
+#if defined(__APPLE__)
+  return DecodeWithCompression(COMPRESSION_ZLIB, data, out, maxSize);
+#elif defined(IR_BODY_ZLIB)
+  return InflateWithZlib(data, out, maxSize);
+#else
+  return InflateRaw(data, out, maxSize);
+#endif
+}
+
+bool InflateBuiltIn(std::string_view data, DeflateWrapper wrapper, std::string &out, size_t maxSize,
+                    std::string_view dictionary) {
+  if (!Unwrap(data, wrapper) || !InflateRaw(data, out, maxSize, dictionary)) return false;
+  out.erase(0, dictionary.size());
+  return true;
+}
+
+bool DecodeBrotli(std::string_view data, std::string &out, size_t maxSize) {
+  out.clear();
+#if defined(__APPLE__)
+  if (__builtin_available(macOS 12.0, *)) return DecodeWithCompression(COMPRESSION_BROTLI, data, out, maxSize);
+  return false;
+#elif defined(IR_BODY_BROTLI)
+  BrotliDecoderState *state = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+  if (!state) return false;
+  std::vector<uint8_t> buffer(64 * 1024);
+  size_t availableIn = data.size();
+  auto nextIn = reinterpret_cast<const uint8_t *>(data.data());
+  BrotliDecoderResult result;
+  do {
+    size_t availableOut = buffer.size();
+    uint8_t *nextOut = buffer.data();
+    result = BrotliDecoderDecompressStream(state, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+    out.append(reinterpret_cast<const char *>(buffer.data()), buffer.size() - availableOut);
+  } while (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT && out.size() <= maxSize);
+  BrotliDecoderDestroyInstance(state);
+  return result == BROTLI_DECODER_RESULT_SUCCESS && out.size() <= maxSize;
+#else
+  (void)data;
+  (void)maxSize;
+  return false;
+#endif
+}
+
+bool IsJson(std::string_view text) noexcept {
+  std::vector<char> closers; // What each open object or array ends with
+  size_t i = SkipSpace(text, 0);
+  auto key = [&]() {
+    if (i >= text.size() || text[i] != '"') return false;
+    size_t end = StringEnd(text, i);
+    if (end == std::string_view::npos) return false;
+    i = SkipSpace(text, end + 1);
+    if (i >= text.size() || text[i] != ':') return false;
+    i = SkipSpace(text, i + 1);
+    return true;
+  };
+
+  for (;;) {
+    // A value
+    if (i >= text.size()) return false;
+    char c = text[i];
+    if (c == '{' || c == '[') {
+      i = SkipSpace(text, i + 1);
+      char closer = c == '{' ? '}' : ']';
+      if (i < text.size() && text[i] == closer) {
+        ++i;
+      } else {
+        closers.push_back(closer);
+        if (closer == '}' && !key()) return false;
+        continue;
+      }
+    } else if (c == '"') {
+      size_t end = StringEnd(text, i);
+      if (end == std::string_view::npos) return false;
+      i = end + 1;
+    } else {
+      i = ScalarEnd(text, i);
+      if (i == std::string_view::npos) return false;
+    }
+
+    // What follows it
+    for (;;) {
+      i = SkipSpace(text, i);
+      if (closers.empty()) return i == text.size();
+      if (i >= text.size()) return false;
+      if (text[i] == closers.back()) {
+        closers.pop_back();
+        ++i;
+        continue;
+      }
+      if (text[i] != ',') return false;
+      i = SkipSpace(text, i + 1);
+      if (closers.back() == '}' && !key()) return false;
+      break;
+    }
+  }
+}
+
+DecodedBody DecodeBody(std::string_view raw, std::string_view contentType, std::string_view contentEncoding) {
+  DecodedBody body;
+  raw = Trim(raw);
+  if (raw.empty() || raw[0] != '"') {
+    // Already JSON; the client parsed it
+    body.text.assign(raw);
+    body.bytes = raw.size();
+    body.json = !raw.empty();
+    return body;
+  }
+
+  std::string value;
+  if (!UnescapeJsonString(raw, value)) {
+    body.text.assign(raw);
+    body.bytes = raw.size();
+    body.error = "The body isn't a valid JSON string";
+    return body;
+  }
+
+  std::string media = MediaType(contentType);
+  std::vector<std::string> encodings;
+  for (std::string_view rest = contentEncoding; !rest.empty();) {
+    size_t comma = rest.find(',');
+    std::string encoding = Lower(Trim(rest.substr(0, comma)));
+    if (!encoding.empty() && encoding != "identity") encodings.push_back(encoding);
+    rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+  }
+
+  // Strings are text unless they decode as base64 into something that fits what the headers say
+  std::string bytes;
+  bool base64 = false;
+  if (LooksLikeBase64(value) && DecodeBase64(value, bytes)) {
+    if (!encodings.empty() || IsBinaryType(media) || HasCompressionMagic(bytes)) {
+      base64 = true;
+    } else if (IsTextType(media)) {
+      // Real text is rarely long without a space, and never decodes to JSON
+      std::string charset = HeaderParameter(contentType, "charset");
+      base64 = (!charset.empty() && charset != "utf-8") || HasByteOrderMark(bytes) ||
+               (IsPrintableUtf8(bytes) && (value.size() >= kSniffBytes || IsJson(bytes)));
+    } else {
+      base64 = IsPrintableUtf8(bytes);
+    }
+  }
+  if (!base64) {
+    body.text = std::move(value);
+    body.bytes = body.text.size();
+    if ((IsJsonType(media) || OpensJson(body.text)) && IsJson(body.text)) {
+      body.json = true;
+      body.steps.push_back("json");
+    }
+    return body;
+  }
+  body.steps.push_back("base64");
+
+  // Content encodings are listed in the order they were applied. The client may have undone
+  // them already (fetch does), so one that doesn't fit the bytes is skipped
+  std::string decoded;
+  if (encodings.empty() && HasCompressionMagic(bytes)) {
+    encodings.push_back(static_cast<uint8_t>(bytes[0]) == 0x1F ? "gzip" : "deflate");
+  }
+  for (auto it = encodings.rbegin(); it != encodings.rend(); ++it) {
+    const std::string &encoding = *it;
+    bool ok = false;
+    if (encoding == "gzip" || encoding == "x-gzip") {
+      if (GzipHeaderSize(bytes) == 0) continue;
+      ok = Inflate(bytes, DeflateWrapper::Gzip, decoded);
+    } else if (encoding == "deflate") {
+      ok = Inflate(bytes, DeflateWrapper::Zlib, decoded) || Inflate(bytes, DeflateWrapper::Raw, decoded);
+    } else if (encoding == "br") {
+      ok = DecodeBrotli(bytes, decoded);
+    } else {
+      body.error = "Unsupported content encoding: " + encoding;
+      break;
+    }
+    if (!ok) {
+      if (!IsPrintableUtf8(bytes.substr(0, 4096))) body.error = "Couldn't decode " + encoding;
+      break;
+    }
+    bytes.swap(decoded);
+    body.steps.push_back(encoding);
+  }
+  decoded.clear();
+  decoded.shrink_to_fit();
+
+  body.bytes = bytes.size();
+  if (IsBinaryType(media) || !BytesToText(bytes, contentType, body.text, body.steps)) {
+    body.binary = true;
+    body.text = HexDump(bytes);
+    return body;
+  }
+  if ((IsJsonType(media) || OpensJson(body.text)) && IsJson(body.text)) {
+    body.json = true;
+    body.steps.push_back("json");
+  }
+  return body;
+}
+
+} // namespace reactotron
@@ -0,0 +1,87 @@
+#pragma once
+
+//
+//  BodyDecoding.h
+//  Reactotron
+//
+//  Turns an API body, as its JSON value arrived in an api.response command,
+//  into text that can be shown: base64 is decoded, gzip/deflate/brotli
+//  content encodings are undone, the charset is converted to UTF-8 and JSON
+//  is recognized. Bytes that still aren't text become a hex dump.
+//
+//  The system decoders are used where there are any: libcompression on
+//  macOS (brotli from macOS 12), and zlib and libbrotlidec on Linux. Windows
+//  has neither, so DEFLATE is inflated by InflateBuiltIn() there and brotli
+//  bodies are shown as they arrived.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+/** What a body looked like on arrival, judged from its first bytes. */
+enum class BodyFormat : uint8_t {
+  Json,   // An object, array or other non-string value
+  Text,   // A string that isn't base64
+  Base64, // A string that looks like base64
+};
+
+const char *BodyFormatName(BodyFormat format) noexcept;
+
+struct DecodedBody {
+  std::string text; // UTF-8
+  bool json = false;
+  bool binary = false; // `text` is a hex dump of the bytes
+  uint64_t bytes = 0;  // Decoded, before any hex dump
+  std::vector<std::string> steps; // What was undone, in order: "base64", "gzip", "charset:utf-16le"...
+  std::string error; // Why decoding stopped short, if it did; `text` is what it got to
+};
+
+/** Bodies never decode to more than this, whatever they claim. */
+constexpr size_t kMaxDecodedBodySize = 256 * 1024 * 1024;
+/** A binary body's hex dump covers this much of it. */
+constexpr size_t kHexDumpBytes = 64 * 1024;
+
+/** Sniffs the format of a body's raw JSON value from a prefix of it. */
+BodyFormat SniffBody(std::string_view raw) noexcept;
+
+/**
+ * Decodes `raw`, the body's JSON value. `contentType` and `contentEncoding`
+ * are the header values, or "" if there weren't any.
+ */
+DecodedBody DecodeBody(std::string_view raw, std::string_view contentType, std::string_view contentEncoding);
+
+/** The value of a JSON string literal, quotes included, as UTF-8. False if it's malformed. */
+bool UnescapeJsonString(std::string_view literal, std::string &out);
+
+/** Standard or URL-safe base64; whitespace is skipped and padding is optional. */
+bool DecodeBase64(std::string_view text, std::string &out);
+
+enum class DeflateWrapper : uint8_t {
+  Raw,  // RFC 1951
+  Zlib, // RFC 1950
+  Gzip, // RFC 1952
+};
+
+/** Inflates `data` into `out`, failing past `maxSize` bytes. */
+bool Inflate(std::string_view data, DeflateWrapper wrapper, std::string &out, size_t maxSize = kMaxDecodedBodySize);
+
+/**
+ * Inflate() without the system decoder, as on Windows. Checked against zlib by
+ * the tests. `dictionary` is a preset dictionary for raw data, as zlib's
+ * inflateSetDictionary() takes.
+ */
+bool InflateBuiltIn(std::string_view data, DeflateWrapper wrapper, std::string &out,
+                    size_t maxSize = kMaxDecodedBodySize, std::string_view dictionary = {});
+
+/** False where there's no brotli decoder (see above) as well as for bad input. */
+bool DecodeBrotli(std::string_view data, std::string &out, size_t maxSize = kMaxDecodedBodySize);
+
+/** True if `text` is one complete JSON value. */
+bool IsJson(std::string_view text) noexcept;
+
+} // namespace reactotron
@@ -0,0 +1,145 @@
+//
+//  BodyStore.cpp
+//  Reactotron
+//
+
+#include "BodyStore.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+
+
+namespace reactotron {
+
+BodyStore &BodyStore::Shared() {
+  static BodyStore *shared = new BodyStore(); // Never destroyed, so ingest workers can outlive static teardown
+  return *shared;
+}
+
+BodyStore::BodyStore() {
+  m_memoryStoreId = MemoryGovernor::Shared().Register("apiBodies", [this](uint64_t bytes) -> uint64_t {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t before = m_cachedBytes;
+    TrimCache(before > bytes ? before - bytes : 0);
+    ReportMemory();
+    return before - m_cachedBytes;
+  });
+}
+
+BodyStore::~BodyStore() { MemoryGovernor::Shared().Unregister(m_memoryStoreId); }
+
+uint32_t BodyStore::Store(std::string raw, std::string contentType, std::string contentEncoding) {
+  auto shared = std::make_shared<const std::string>(std::move(raw));
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint32_t id = ++m_nextId;
+  m_rawBytes += shared->size();
+  m_bodies.emplace(id, Body{std::move(shared), std::move(contentType), std::move(contentEncoding)});
+  ReportMemory();
+  return id;
+}
+
+std::shared_ptr<const DecodedBody> BodyStore::Decode(uint32_t id) {
+  Body body;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto cached = m_cache.find(id); cached != m_cache.end()) {
+      m_recent.splice(m_recent.begin(), m_recent, cached->second.recent);
+      m_cacheHits++;
+      return cached->second.decoded;
+    }
+    auto it = m_bodies.find(id);
+    if (it == m_bodies.end()) return nullptr;
+    body = it->second;
+  }
+
+  // Without the lock, so a large body doesn't hold up ingest; two views racing may both decode it
+  auto decoded = std::make_shared<const DecodedBody>(DecodeBody(*body.raw, body.contentType, body.contentEncoding));
+  uint64_t bytes = DecodedSize(*decoded);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_decodes++;
+  // Released meanwhile, or too big to be worth evicting everything else for
+  if (!m_bodies.count(id) || m_cache.count(id) || bytes > m_cacheBudget) return decoded;
+  m_recent.push_front(id);
+  m_cache.emplace(id, CacheEntry{decoded, m_recent.begin(), bytes});
+  m_cachedBytes += bytes;
+  TrimCache(m_cacheBudget);
+  ReportMemory();
+  return decoded;
+}
+
+bool BodyStore::Raw(uint32_t id, std::string &out) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_bodies.find(id);
+  if (it == m_bodies.end()) return false;
+  out = *it->second.raw;
+  return true;
+}
+
+uint64_t BodyStore::RawSize(uint32_t id) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_bodies.find(id);
+  return it == m_bodies.end() ? 0 : it->second.raw->size();
+}
+
+void BodyStore::Release(uint32_t id) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_bodies.find(id);
+  if (it == m_bodies.end()) return;
+  m_rawBytes -= it->second.raw->size();
+  m_bodies.erase(it);
+  Uncache(id);
+  ReportMemory();
+}
+
+void BodyStore::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_bodies.clear();
+  m_rawBytes = 0;
+  m_cache.clear();
+  m_recent.clear();
+  m_cachedBytes = 0;
+  ReportMemory();
+}
+
+void BodyStore::SetCacheBudget(uint64_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cacheBudget = bytes;
+  TrimCache(bytes);
+  ReportMemory();
+}
+
+BodyStoreStats BodyStore::Stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  BodyStoreStats stats;
+  stats.bodies = m_bodies.size();
+  stats.rawBytes = m_rawBytes;
+  stats.cached = m_cache.size();
+  stats.cachedBytes = m_cachedBytes;
+  stats.cacheBudget = m_cacheBudget;
+  stats.decodes = m_decodes;
+  stats.cacheHits = m_cacheHits;
+  return stats;
+}
+
+uint64_t BodyStore::DecodedSize(const DecodedBody &body) noexcept {
+  uint64_t bytes = sizeof(DecodedBody) + body.text.capacity() + body.error.capacity();
+  for (const std::string &step : body.steps) bytes += sizeof(std::string) + step.capacity();
+  return bytes;
+}
+
+void BodyStore::Uncache(uint32_t id) {
+  auto it = m_cache.find(id);
+  if (it == m_cache.end()) return;
+  m_cachedBytes -= it->second.bytes;
+  m_recent.erase(it->second.recent);
+  m_cache.erase(it);
+}
+
+void BodyStore::TrimCache(uint64_t budget) {
+  while (m_cachedBytes > budget && !m_recent.empty()) Uncache(m_recent.back());
+}
+
+void BodyStore::ReportMemory() {
+  MemoryGovernor::Shared().Report(m_memoryStoreId, m_rawBytes + m_cachedBytes, 0);
+}
+
+} // namespace reactotron
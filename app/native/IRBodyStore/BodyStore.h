@@ -0,0 +1,111 @@
+#pragma once
+
+//
+//  BodyStore.h
+//  Reactotron
+//
+//  Large API request and response bodies, kept as the JSON value they
+//  arrived as instead of being parsed into JS objects with the rest of the
+//  api.response command. The relay's ingest workers lift them out of the
+//  message (see IngestPipeline) and leave a small reference in their place.
+//  A body is decoded only when it's first viewed, and decoded bodies are
+//  kept in a least recently used cache with a byte budget.
+//
+//  The store reports its size to the MemoryGovernor as "apiBodies"; asked to
+//  free memory, it empties the decoded cache. Stored bodies belong to their
+//  timeline items and are released with them.
+//
+
+#include "BodyDecoding.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct BodyStoreStats {
+  size_t bodies = 0;
+  uint64_t rawBytes = 0;
+  size_t cached = 0; // Decoded bodies in the cache
+  uint64_t cachedBytes = 0;
+  uint64_t cacheBudget = 0;
+  uint64_t decodes = 0;
+  uint64_t cacheHits = 0;
+};
+
+/**
+ * The store; Shared() is the one the ingest workers fill and the modules
+ * read. Thread-safe. Ids are never reused.
+ */
+class BodyStore {
+ public:
+  static constexpr uint64_t kDefaultCacheBudget = 64 * 1024 * 1024;
+
+  static BodyStore &Shared();
+
+  BodyStore();
+  ~BodyStore();
+  BodyStore(const BodyStore &) = delete;
+  BodyStore &operator=(const BodyStore &) = delete;
+
+  /**
+   * Keeps `raw`, a body's JSON value as received, with the content type and
+   * encoding headers that came with it. Returns its id.
+   */
+  uint32_t Store(std::string raw, std::string contentType, std::string contentEncoding);
+
+  /** The decoded body, decoding it now if it isn't cached; null if `id` isn't stored. */
+  std::shared_ptr<const DecodedBody> Decode(uint32_t id);
+  /** The body's JSON value as it arrived. */
+  bool Raw(uint32_t id, std::string &out) const;
+  uint64_t RawSize(uint32_t id) const;
+
+  void Release(uint32_t id);
+  void Clear();
+
+  /** 0 turns caching off. */
+  void SetCacheBudget(uint64_t bytes);
+  BodyStoreStats Stats() const;
+
+ private:
+  struct Body {
+    std::shared_ptr<const std::string> raw; // Shared so decoding can run without the lock
+    std::string contentType;
+    std::string contentEncoding;
+  };
+
+  struct CacheEntry {
+    std::shared_ptr<const DecodedBody> decoded;
+    std::list<uint32_t>::iterator recent;
+    uint64_t bytes = 0;
+  };
+
+  static uint64_t DecodedSize(const DecodedBody &body) noexcept;
+  // Call these with m_mutex held
+  void Uncache(uint32_t id);
+  void TrimCache(uint64_t budget);
+  void ReportMemory();
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<uint32_t, Body> m_bodies;
+  uint32_t m_nextId = 0;
+  uint64_t m_rawBytes = 0;
+
+  std::unordered_map<uint32_t, CacheEntry> m_cache;
+  std::list<uint32_t> m_recent; // Cached ids, most recently used first
+  uint64_t m_cachedBytes = 0;
+  uint64_t m_cacheBudget = kDefaultCacheBudget;
+  uint64_t m_decodes = 0;
+  uint64_t m_cacheHits = 0;
+
+  uint32_t m_memoryStoreId = 0;
+};
+
+} // namespace reactotron
@@ -0,0 +1,83 @@
+//
+//  IRBodyStore.mm
+//  Reactotron-macOS
+//
+//  API bodies the relay's ingest workers set aside, decoded off the JS thread
+//  the first time they're viewed.
+//
+
+#import "IRBodyStore.h"
+#include "BodyStore.h"
+#include "../TaskExecutor/TaskExecutor.h"
+#include <string>
+
+@implementation IRBodyStore
+
+RCT_EXPORT_MODULE()
+
+static NSString *IRBodyStoreNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+- (void)decode:(double)bodyId resolve:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  reactotron::TaskExecutor::Shared().Post(reactotron::TaskPriority::Interactive, [bodyId, resolve] {
+    auto body = reactotron::BodyStore::Shared().Decode(static_cast<uint32_t>(bodyId));
+    if (!body) {
+      resolve([NSNull null]);
+      return;
+    }
+    NSMutableArray<NSString *> *steps = [NSMutableArray arrayWithCapacity:body->steps.size()];
+    for (const std::string &step : body->steps) [steps addObject:IRBodyStoreNSString(step)];
+    resolve(@{
+      @"text": IRBodyStoreNSString(body->text),
+      @"json": @(body->json),
+      @"binary": @(body->binary),
+      @"bytes": @(body->bytes),
+      @"steps": steps,
+      @"error": IRBodyStoreNSString(body->error),
+    });
+  });
+}
+
+- (NSString *)rawJson:(double)bodyId {
+  std::string raw;
+  if (!reactotron::BodyStore::Shared().Raw(static_cast<uint32_t>(bodyId), raw)) return @"";
+  return IRBodyStoreNSString(raw);
+}
+
+- (NSNumber *)releaseBodies:(NSArray *)bodyIds {
+  auto &store = reactotron::BodyStore::Shared();
+  size_t before = store.Stats().bodies;
+  for (NSNumber *bodyId in bodyIds) store.Release(bodyId.unsignedIntValue);
+  return @(before - store.Stats().bodies);
+}
+
+- (NSNumber *)clear {
+  auto &store = reactotron::BodyStore::Shared();
+  size_t released = store.Stats().bodies;
+  store.Clear();
+  return @(released);
+}
+
+- (void)setCacheBudget:(double)bytes {
+  reactotron::BodyStore::Shared().SetCacheBudget(bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
+}
+
+- (NSDictionary *)getStats {
+  reactotron::BodyStoreStats stats = reactotron::BodyStore::Shared().Stats();
+  return @{
+    @"bodies": @(stats.bodies),
+    @"rawBytes": @(stats.rawBytes),
+    @"cached": @(stats.cached),
+    @"cachedBytes": @(stats.cachedBytes),
+    @"cacheBudget": @(stats.cacheBudget),
+    @"decodes": @(stats.decodes),
+    @"cacheHits": @(stats.cacheHits),
+  };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRBodyStoreSpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,76 @@
+//
+//  IRBodyStore.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared BodyStore
+//
+
+#include "pch.h"
+#include "IRBodyStore.windows.h"
+
+namespace winrt::reactotron::implementation
+{
+    void IRBodyStore::decode(double bodyId, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        ::reactotron::TaskExecutor::Shared().Post(::reactotron::TaskPriority::Interactive, [bodyId, promise] {
+            auto body = ::reactotron::BodyStore::Shared().Decode(static_cast<uint32_t>(bodyId));
+            if (!body)
+            {
+                promise.Resolve(Microsoft::ReactNative::JSValue(nullptr));
+                return;
+            }
+            Microsoft::ReactNative::JSValueArray steps;
+            for (auto const &step : body->steps) steps.push_back(step);
+            Microsoft::ReactNative::JSValueObject result;
+            result["text"] = body->text;
+            result["json"] = body->json;
+            result["binary"] = body->binary;
+            result["bytes"] = static_cast<double>(body->bytes);
+            result["steps"] = std::move(steps);
+            result["error"] = body->error;
+            promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+        });
+    }
+
+    std::string IRBodyStore::rawJson(double bodyId) noexcept
+    {
+        std::string raw;
+        ::reactotron::BodyStore::Shared().Raw(static_cast<uint32_t>(bodyId), raw);
+        return raw;
+    }
+
+    double IRBodyStore::releaseBodies(std::vector<double> bodyIds) noexcept
+    {
+        auto &store = ::reactotron::BodyStore::Shared();
+        size_t before = store.Stats().bodies;
+        for (double bodyId : bodyIds) store.Release(static_cast<uint32_t>(bodyId));
+        return static_cast<double>(before - store.Stats().bodies);
+    }
+
+    double IRBodyStore::clear() noexcept
+    {
+        auto &store = ::reactotron::BodyStore::Shared();
+        size_t released = store.Stats().bodies;
+        store.Clear();
+        return static_cast<double>(released);
+    }
+
+    void IRBodyStore::setCacheBudget(double bytes) noexcept
+    {
+        ::reactotron::BodyStore::Shared().SetCacheBudget(bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
+    }
+
+    Microsoft::ReactNative::JSValue IRBodyStore::getStats() noexcept
+    {
+        ::reactotron::BodyStoreStats stats = ::reactotron::BodyStore::Shared().Stats();
+        Microsoft::ReactNative::JSValueObject result;
+        result["bodies"] = static_cast<double>(stats.bodies);
+        result["rawBytes"] = static_cast<double>(stats.rawBytes);
+        result["cached"] = static_cast<double>(stats.cached);
+        result["cachedBytes"] = static_cast<double>(stats.cachedBytes);
+        result["cacheBudget"] = static_cast<double>(stats.cacheBudget);
+        result["decodes"] = static_cast<double>(stats.decodes);
+        result["cacheHits"] = static_cast<double>(stats.cacheHits);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "NativeModules.h"
+#include "BodyStore.h"
+#include "../TaskExecutor/TaskExecutor.h"
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRBodyStore)
+    struct IRBodyStore
+    {
+        IRBodyStore() noexcept = default;
+
+        REACT_METHOD(decode)
+        void decode(double bodyId, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_SYNC_METHOD(rawJson)
+        std::string rawJson(double bodyId) noexcept;
+
+        REACT_SYNC_METHOD(releaseBodies)
+        double releaseBodies(std::vector<double> bodyIds) noexcept;
+
+        REACT_SYNC_METHOD(clear)
+        double clear() noexcept;
+
+        REACT_METHOD(setCacheBudget)
+        void setCacheBudget(double bytes) noexcept;
+
+        REACT_SYNC_METHOD(getStats)
+        Microsoft::ReactNative::JSValue getStats() noexcept;
+    };
+}
@@ -0,0 +1,41 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface DecodedBody {
+  /** UTF-8 text; a hex dump if the body is binary. */
+  text: string
+  json: boolean
+  binary: boolean
+  /** Size once decoded. */
+  bytes: number
+  /** What was undone to get the text, in order, e.g. ["base64", "gzip", "json"]. */
+  steps: string[]
+  /** Why decoding stopped short, or "". */
+  error: string
+}
+
+export interface BodyStoreStats {
+  bodies: number
+  rawBytes: number
+  /** Decoded bodies kept for the next view. */
+  cached: number
+  cachedBytes: number
+  cacheBudget: number
+  decodes: number
+  cacheHits: number
+}
+
+export interface Spec extends TurboModule {
+  /** Decodes off the JS thread the first time; null if the body was released. */
+  decode(bodyId: number): Promise<DecodedBody | null>
+  /** The body's JSON value as it arrived, or "" if it was released. */
+  rawJson(bodyId: number): string
+  /** Returns how many bodies were released. */
+  releaseBodies(bodyIds: ReadonlyArray<number>): number
+  clear(): number
+  /** Bytes of decoded bodies to keep; 0 keeps none. */
+  setCacheBudget(bytes: number): void
+  getStats(): BodyStoreStats
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRBodyStore")
@@ -0,0 +1,366 @@
+//
+//  BodyIndex.cpp
+//  Reactotron
+//
+
+#include "BodyIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace reactotron {
+
+namespace {
+
+bool IsSpace(char c) noexcept { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+size_t SkipSpace(std::string_view s, size_t pos) noexcept {
+  while (pos < s.size() && IsSpace(s[pos])) ++pos;
+  return pos;
+}
+
+/** Past the closing quote of the string opening at `pos`; npos if it doesn't close. */
+size_t SkipString(std::string_view s, size_t pos) noexcept {
+  for (++pos; pos < s.size(); ++pos) {
+    const char *quote = static_cast<const char *>(std::memchr(s.data() + pos, '"', s.size() - pos));
+    if (!quote) return std::string_view::npos;
+    pos = static_cast<size_t>(quote - s.data());
+    size_t backslashes = 0;
+    while (backslashes < pos && s[pos - 1 - backslashes] == '\\') ++backslashes;
+    if (backslashes % 2 == 0) return pos + 1;
+  }
+  return std::string_view::npos;
+}
+
+/** Past a number or literal starting at `pos`. */
+size_t SkipScalar(std::string_view s, size_t pos) noexcept {
+  while (pos < s.size()) {
+    char c = s[pos];
+    if (IsSpace(c) || c == ',' || c == '}' || c == ']' || c == ':') break;
+    ++pos;
+  }
+  return pos;
+}
+
+bool IsScalar(std::string_view token) noexcept {
+  if (token == "true" || token == "false" || token == "null") return true;
+  if (token.empty()) return false;
+  size_t i = token[0] == '-' ? 1 : 0;
+  if (i >= token.size() || token[i] < '0' || token[i] > '9') return false;
+  for (; i < token.size(); ++i) {
+    char c = token[i];
+    if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')) return false;
+  }
+  return true;
+}
+
+char Lower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+/** Appends s[begin, end) to `out`, stopping short of `maxBytes` without splitting a UTF-8 character. */
+void AppendCapped(std::string &out, std::string_view s, size_t begin, size_t end, size_t maxBytes, bool &truncated) {
+  if (out.size() >= maxBytes) {
+    truncated |= begin < end;
+    return;
+  }
+  size_t room = maxBytes - out.size();
+  if (end - begin > room) {
+    end = begin + room;
+    while (end > begin && (static_cast<unsigned char>(s[end]) & 0xC0) == 0x80) --end;
+    truncated = true;
+  }
+  out.append(s.data() + begin, end - begin);
+}
+
+} // namespace
+
+BodyIndex::BodyIndex(std::string body) : m_body(std::move(body)) {
+  if (m_body.size() > kMaxBodySize) m_body.resize(kMaxBodySize);
+  m_json = IndexJson();
+  if (!m_json) IndexText();
+  m_offsets.shrink_to_fit();
+  m_depths.shrink_to_fit();
+  m_regions.shrink_to_fit();
+}
+
+bool BodyIndex::IndexJson() {
+  std::string_view s = m_body;
+  // Open containers: the region each opened, and whether it's an object
+  std::vector<std::pair<uint32_t, bool>> open;
+  enum class Expect { Value, After, Key, Element } expect = Expect::Value;
+
+  auto startLine = [&](size_t pos) {
+    m_offsets.push_back(static_cast<uint32_t>(pos));
+    m_depths.push_back(static_cast<uint16_t>(open.size()));
+  };
+
+  size_t pos = SkipSpace(s, 0);
+  if (pos == s.size()) return false;
+  startLine(pos);
+
+  for (;;) {
+    switch (expect) {
+      case Expect::Key:
+        pos = SkipSpace(s, pos);
+        if (pos >= s.size() || s[pos] != '"') return false;
+        startLine(pos);
+        pos = SkipString(s, pos);
+        if (pos == std::string_view::npos) return false;
+        pos = SkipSpace(s, pos);
+        if (pos >= s.size() || s[pos] != ':') return false;
+        pos = SkipSpace(s, pos + 1);
+        expect = Expect::Value;
+        break;
+
+      case Expect::Element:
+        pos = SkipSpace(s, pos);
+        if (pos >= s.size()) return false;
+        startLine(pos);
+        expect = Expect::Value;
+        break;
+
+      case Expect::Value: {
+        // Continues the current line
+        if (pos >= s.size()) return false;
+        char c = s[pos];
+        if (c == '{' || c == '[') {
+          char close = c == '{' ? '}' : ']';
+          pos = SkipSpace(s, pos + 1);
+          if (pos < s.size() && s[pos] == close) {
+            // Empty, so it stays on this line
+            ++pos;
+            expect = Expect::After;
+            break;
+          }
+          if (open.size() >= kMaxDepth) return false;
+          m_regions.push_back(Region{static_cast<uint32_t>(m_offsets.size() - 1), 0});
+          open.emplace_back(static_cast<uint32_t>(m_regions.size() - 1), c == '{');
+          expect = c == '{' ? Expect::Key : Expect::Element;
+        } else if (c == '"') {
+          pos = SkipString(s, pos);
+          if (pos == std::string_view::npos) return false;
+          expect = Expect::After;
+        } else {
+          size_t end = SkipScalar(s, pos);
+          if (!IsScalar(s.substr(pos, end - pos))) return false;
+          pos = end;
+          expect = Expect::After;
+        }
+        break;
+      }
+
+      case Expect::After: {
+        pos = SkipSpace(s, pos);
+        if (open.empty()) return pos == s.size();
+        if (pos >= s.size()) return false;
+        auto [region, object] = open.back();
+        if (s[pos] == ',') {
+          ++pos;
+          expect = object ? Expect::Key : Expect::Element;
+        } else if (s[pos] == (object ? '}' : ']')) {
+          open.pop_back();
+          startLine(pos);
+          m_regions[region].close = static_cast<uint32_t>(m_offsets.size() - 1);
+          ++pos;
+        } else {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+}
+
+void BodyIndex::IndexText() {
+  m_offsets.clear();
+  m_depths.clear();
+  m_regions.clear();
+  m_offsets.push_back(0);
+  const char *data = m_body.data();
+  size_t size = m_body.size();
+  for (size_t pos = 0; pos < size;) {
+    const char *newline = static_cast<const char *>(std::memchr(data + pos, '\n', size - pos));
+    if (!newline || static_cast<size_t>(newline - data) + 1 == size) break;
+    pos = static_cast<size_t>(newline - data) + 1;
+    m_offsets.push_back(static_cast<uint32_t>(pos));
+  }
+  m_depths.assign(m_offsets.size(), 0);
+}
+
+void BodyIndex::Format(uint32_t line, std::string &out, bool &truncated, size_t maxBytes) const {
+  std::string_view s = m_body;
+  out.assign(std::min<size_t>(m_depths[line] * kIndent, maxBytes), ' ');
+  size_t pos = m_offsets[line];
+
+  if (!m_json) {
+    size_t end = line + 1 < m_offsets.size() ? m_offsets[line + 1] : s.size();
+    while (end > pos && (s[end - 1] == '\n' || s[end - 1] == '\r')) --end;
+    AppendCapped(out, s, pos, end, maxBytes, truncated);
+    return;
+  }
+
+  char c = s[pos];
+  if (c == '}' || c == ']') {
+    out += c;
+    ++pos;
+  } else {
+    if (c == '"') {
+      size_t end = SkipString(s, pos);
+      size_t colon = SkipSpace(s, end);
+      if (colon < s.size() && s[colon] == ':') {
+        AppendCapped(out, s, pos, end, maxBytes, truncated);
+        AppendCapped(out, ": ", 0, 2, maxBytes, truncated);
+        pos = SkipSpace(s, colon + 1);
+        c = s[pos];
+      }
+    }
+    if (c == '{' || c == '[') {
+      char close = c == '{' ? '}' : ']';
+      size_t next = SkipSpace(s, pos + 1);
+      out += c;
+      if (s[next] != close) return; // The comma is on the closing line
+      out += close;
+      pos = next + 1;
+    } else {
+      size_t end = c == '"' ? SkipString(s, pos) : SkipScalar(s, pos);
+      AppendCapped(out, s, pos, end, maxBytes, truncated);
+      pos = end;
+    }
+  }
+  pos = SkipSpace(s, pos);
+  if (pos < s.size() && s[pos] == ',') out += ',';
+}
+
+const BodyIndex::Region *BodyIndex::RegionAt(uint32_t line) const noexcept {
+  auto it = std::lower_bound(m_regions.begin(), m_regions.end(), line,
+                             [](const Region &region, uint32_t open) { return region.open < open; });
+  return it != m_regions.end() && it->open == line ? &*it : nullptr;
+}
+
+std::vector<BodyLine> BodyIndex::Rows(size_t row, size_t count) const {
+  std::vector<BodyLine> rows;
+  size_t end = std::min(RowCount(), row + count);
+  if (row >= end) return rows;
+  rows.reserve(end - row);
+
+  uint32_t line = RowToLine(row);
+  for (size_t i = row; i < end; ++i) {
+    BodyLine out;
+    out.line = line;
+    Format(line, out.text, out.truncated, kMaxLineBytes);
+    const Region *region = RegionAt(line);
+    out.foldable = region != nullptr;
+    out.folded = region && std::binary_search(m_folded.begin(), m_folded.end(), line);
+    if (out.folded) {
+      // `{…}` with the closing line's comma
+      std::string close;
+      bool closeTruncated = false;
+      Format(region->close, close, closeTruncated, kMaxLineBytes);
+      out.text += "…";
+      out.text += close.substr(m_depths[region->close] * kIndent);
+      out.hiddenLines = region->close - line;
+      line = region->close + 1;
+    } else {
+      ++line;
+    }
+    rows.push_back(std::move(out));
+  }
+  return rows;
+}
+
+uint32_t BodyIndex::RowToLine(size_t row) const noexcept {
+  // The last hidden range starting at or before the row, counted in rows
+  size_t lo = 0, hi = m_hidden.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (m_hidden[mid].first - m_hiddenBefore[mid] <= row) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) return static_cast<uint32_t>(row);
+  size_t i = lo - 1;
+  return static_cast<uint32_t>(row + m_hiddenBefore[i] + (m_hidden[i].second - m_hidden[i].first + 1));
+}
+
+size_t BodyIndex::LineToRow(uint32_t line) const noexcept {
+  auto it = std::lower_bound(m_hidden.begin(), m_hidden.end(), line,
+                             [](const auto &range, uint32_t l) { return range.second < l; });
+  size_t i = static_cast<size_t>(it - m_hidden.begin());
+  uint32_t hidden = i < m_hidden.size() ? m_hiddenBefore[i] : static_cast<uint32_t>(m_hiddenTotal);
+  return line - hidden;
+}
+
+void BodyIndex::UpdateHidden() {
+  m_hidden.clear();
+  m_hiddenBefore.clear();
+  m_hiddenTotal = 0;
+  for (uint32_t open : m_folded) {
+    const Region *region = RegionAt(open);
+    if (!region) continue;
+    // Folds inside a folded region are already hidden
+    if (!m_hidden.empty() && open <= m_hidden.back().second) continue;
+    m_hidden.emplace_back(open + 1, region->close);
+    m_hiddenBefore.push_back(static_cast<uint32_t>(m_hiddenTotal));
+    m_hiddenTotal += region->close - open;
+  }
+}
+
+bool BodyIndex::ToggleFold(uint32_t line) {
+  if (!RegionAt(line)) return false;
+  auto it = std::lower_bound(m_folded.begin(), m_folded.end(), line);
+  if (it != m_folded.end() && *it == line) {
+    m_folded.erase(it);
+  } else {
+    m_folded.insert(it, line);
+  }
+  UpdateHidden();
+  return true;
+}
+
+size_t BodyIndex::Reveal(uint32_t line) {
+  if (line >= m_offsets.size()) return RowCount();
+  for (;;) {
+    auto it = std::lower_bound(m_hidden.begin(), m_hidden.end(), line,
+                               [](const auto &range, uint32_t l) { return range.second < l; });
+    if (it == m_hidden.end() || it->first > line) break;
+    // Unfold the outermost fold hiding it; one nested inside may still hide it
+    m_folded.erase(std::lower_bound(m_folded.begin(), m_folded.end(), it->first - 1));
+    UpdateHidden();
+  }
+  return LineToRow(line);
+}
+
+int64_t BodyIndex::Find(std::string_view needle, uint32_t from, bool backwards) const {
+  if (needle.empty() || m_offsets.empty()) return -1;
+  std::string lowered(needle.size(), '\0');
+  std::transform(needle.begin(), needle.end(), lowered.begin(), Lower);
+
+  std::string text;
+  auto matches = [&](uint32_t line) {
+    bool truncated = false;
+    Format(line, text, truncated, SIZE_MAX);
+    auto it = std::search(text.begin(), text.end(), lowered.begin(), lowered.end(),
+                          [](char a, char b) { return Lower(a) == b; });
+    return it != text.end();
+  };
+
+  uint32_t count = static_cast<uint32_t>(m_offsets.size());
+  if (backwards) {
+    for (int64_t line = std::min<int64_t>(from, count - 1); line >= 0; --line) {
+      if (matches(static_cast<uint32_t>(line))) return line;
+    }
+  } else {
+    for (uint32_t line = from; line < count; ++line) {
+      if (matches(line)) return line;
+    }
+  }
+  return -1;
+}
+
+size_t BodyIndex::ByteSize() const noexcept {
+  return m_body.capacity() + m_offsets.capacity() * sizeof(uint32_t) + m_depths.capacity() * sizeof(uint16_t) +
+         m_regions.capacity() * sizeof(Region);
+}
+
+} // namespace reactotron
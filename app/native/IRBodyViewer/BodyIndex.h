@@ -0,0 +1,99 @@
+#pragma once
+
+//
+//  BodyIndex.h
+//  Reactotron
+//
+//  Large API bodies and state values, pretty-printed a page at a time. One
+//  pass over the raw text records where each pretty-printed line starts and
+//  which lines open and close a foldable object or array; the pretty text is
+//  never built as a whole. A line is formatted from the raw text when it's
+//  shown, so a large body costs its raw size plus a few bytes per line.
+//
+//  Text that isn't JSON is shown as it is, line by line.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace reactotron {
+
+struct BodyLine {
+  uint32_t line = 0; // Among all lines, folded or not
+  std::string text;  // Indented
+  bool truncated = false; // Longer than BodyIndex::kMaxLineBytes
+  bool foldable = false;
+  bool folded = false;
+  uint32_t hiddenLines = 0; // Folded away after this one
+};
+
+/**
+ * The index of one body, and which of its regions are folded. Rows are
+ * positions among the lines left visible by the folds.
+ *
+ * Not thread-safe, except that Find() may run alongside the fold methods.
+ */
+class BodyIndex {
+ public:
+  static constexpr size_t kIndent = 2;
+  static constexpr size_t kMaxDepth = 4096; // Deeper JSON is shown as text
+  static constexpr size_t kMaxLineBytes = 4096;
+  static constexpr uint64_t kMaxBodySize = UINT32_MAX; // Longer bodies are cut off
+
+  explicit BodyIndex(std::string body);
+  BodyIndex(const BodyIndex &) = delete;
+  BodyIndex &operator=(const BodyIndex &) = delete;
+
+  bool IsJson() const noexcept { return m_json; }
+  size_t LineCount() const noexcept { return m_offsets.size(); }
+  size_t RowCount() const noexcept { return m_offsets.size() - m_hiddenTotal; }
+
+  /** Up to `count` rows starting at `row`. */
+  std::vector<BodyLine> Rows(size_t row, size_t count) const;
+  /** Folds or unfolds the region opened by `line`; returns false if none is. */
+  bool ToggleFold(uint32_t line);
+  /** Unfolds the regions hiding `line` and returns its row. */
+  size_t Reveal(uint32_t line);
+
+  /**
+   * The first line from `from` (the last up to it, if `backwards`) whose text
+   * contains `needle`, ignoring ASCII case; -1 if there's none.
+   */
+  int64_t Find(std::string_view needle, uint32_t from, bool backwards) const;
+
+  size_t ByteSize() const noexcept;
+
+ private:
+  /** A foldable region: the lines opening and closing a non-empty object or array. */
+  struct Region {
+    uint32_t open;
+    uint32_t close;
+  };
+
+  bool IndexJson();
+  void IndexText();
+  /** The line as pretty-printed, without folding. */
+  void Format(uint32_t line, std::string &out, bool &truncated, size_t maxBytes) const;
+  const Region *RegionAt(uint32_t line) const noexcept;
+  uint32_t RowToLine(size_t row) const noexcept;
+  size_t LineToRow(uint32_t line) const noexcept;
+  void UpdateHidden();
+
+  std::string m_body;
+  bool m_json = false;
+  std::vector<uint32_t> m_offsets; // Where each line starts in m_body
+  std::vector<uint16_t> m_depths;
+  std::vector<Region> m_regions; // By open line
+
+  std::vector<uint32_t> m_folded; // Open lines of folded regions, sorted
+  // Line ranges hidden by the outermost folds, [first, last], sorted, with the hidden lines before each
+  std::vector<std::pair<uint32_t, uint32_t>> m_hidden;
+  std::vector<uint32_t> m_hiddenBefore;
+  size_t m_hiddenTotal = 0;
+};
+
+} // namespace reactotron
@@ -0,0 +1,169 @@
+//
+//  IRBodyViewer.mm
+//  Reactotron-macOS
+//
+//  Large bodies indexed once off the JS thread, then pretty-printed a page of
+//  lines at a time as the viewer scrolls.
+//
+
+#import "IRBodyViewer.h"
+#include "BodyIndex.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include "../TaskExecutor/TaskExecutor.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct OpenBody {
+  explicit OpenBody(std::string body) : index(std::move(body)) {}
+  reactotron::BodyIndex index;
+  std::mutex mutex; // For the folds; Find() doesn't need it
+  reactotron::CancellationToken closed; // Searches still queued when it's closed don't run
+};
+
+} // namespace
+
+@implementation IRBodyViewer {
+  std::unordered_map<uint32_t, std::shared_ptr<OpenBody>> _bodies;
+  uint32_t _nextBodyId;
+  std::mutex _bodiesMutex;
+  uint32_t _memoryStoreId;
+}
+
+RCT_EXPORT_MODULE()
+
+- (instancetype)init {
+  if (self = [super init]) {
+    // Bodies are open only while a viewer shows them, so they're reported but never evicted
+    _memoryStoreId = reactotron::MemoryGovernor::Shared().Register("bodyViewer", nullptr);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  reactotron::MemoryGovernor::Shared().Unregister(_memoryStoreId);
+}
+
+static NSString *IRBodyViewerNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+- (std::shared_ptr<OpenBody>)bodyForId:(double)bodyId {
+  std::lock_guard<std::mutex> lock(_bodiesMutex);
+  auto it = _bodies.find(static_cast<uint32_t>(bodyId));
+  return it == _bodies.end() ? nullptr : it->second;
+}
+
+/** Call with _bodiesMutex held. */
+- (void)reportMemory {
+  uint64_t bytes = 0;
+  for (const auto &entry : _bodies) bytes += entry.second->index.ByteSize();
+  reactotron::MemoryGovernor::Shared().Report(_memoryStoreId, bytes, 0);
+}
+
+- (void)open:(NSString *)body resolve:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  reactotron::TaskExecutor::Shared().Post(reactotron::TaskPriority::Interactive, [self, body, resolve] {
+    const char *utf8 = body.UTF8String;
+    auto opened = std::make_shared<OpenBody>(utf8 ? std::string(utf8) : std::string());
+    uint32_t bodyId;
+    {
+      std::lock_guard<std::mutex> lock(self->_bodiesMutex);
+      bodyId = ++self->_nextBodyId;
+      self->_bodies[bodyId] = opened;
+      [self reportMemory];
+    }
+    resolve(@{
+      @"bodyId": @(bodyId),
+      @"json": @(opened->index.IsJson()),
+      @"lines": @(opened->index.LineCount()),
+    });
+  });
+}
+
+- (NSNumber *)getRowCount:(double)bodyId {
+  auto body = [self bodyForId:bodyId];
+  if (!body) return @0;
+  std::lock_guard<std::mutex> lock(body->mutex);
+  return @(body->index.RowCount());
+}
+
+- (NSArray<NSDictionary *> *)getRows:(double)bodyId row:(double)row count:(double)count {
+  auto body = [self bodyForId:bodyId];
+  if (!body || row < 0 || count <= 0) return @[];
+  std::vector<reactotron::BodyLine> lines;
+  {
+    std::lock_guard<std::mutex> lock(body->mutex);
+    lines = body->index.Rows(static_cast<size_t>(row), static_cast<size_t>(count));
+  }
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:lines.size()];
+  for (const auto &line : lines) {
+    [result addObject:@{
+      @"line": @(line.line),
+      @"text": IRBodyViewerNSString(line.text),
+      @"truncated": @(line.truncated),
+      @"foldable": @(line.foldable),
+      @"folded": @(line.folded),
+      @"hiddenLines": @(line.hiddenLines),
+    }];
+  }
+  return result;
+}
+
+- (NSNumber *)toggleFold:(double)bodyId line:(double)line {
+  auto body = [self bodyForId:bodyId];
+  if (!body || line < 0) return @(-1);
+  std::lock_guard<std::mutex> lock(body->mutex);
+  if (!body->index.ToggleFold(static_cast<uint32_t>(line))) return @(-1);
+  return @(body->index.RowCount());
+}
+
+- (NSNumber *)reveal:(double)bodyId line:(double)line {
+  auto body = [self bodyForId:bodyId];
+  if (!body || line < 0) return @0;
+  std::lock_guard<std::mutex> lock(body->mutex);
+  return @(body->index.Reveal(static_cast<uint32_t>(line)));
+}
+
+- (void)find:(double)bodyId
+      needle:(NSString *)needle
+    fromLine:(double)fromLine
+   backwards:(BOOL)backwards
+     resolve:(nonnull RCTPromiseResolveBlock)resolve
+      reject:(nonnull RCTPromiseRejectBlock)reject {
+  auto body = [self bodyForId:bodyId];
+  if (!body) {
+    resolve(@(-1));
+    return;
+  }
+  const char *utf8 = needle.UTF8String;
+  std::string needleString = utf8 ? std::string(utf8) : std::string();
+  uint32_t from = fromLine > 0 ? static_cast<uint32_t>(fromLine) : 0;
+  reactotron::TaskExecutor::Shared().Submit(
+      reactotron::TaskPriority::Interactive, body->closed,
+      [body, needleString, from, backwards](const reactotron::CancellationToken &) {
+        return body->index.Find(needleString, from, backwards);
+      },
+      [resolve](reactotron::TaskOutcome<int64_t> outcome) {
+        resolve(@(outcome.status == reactotron::TaskStatus::Completed ? outcome.value : -1));
+      });
+}
+
+- (NSNumber *)close:(double)bodyId {
+  std::lock_guard<std::mutex> lock(_bodiesMutex);
+  auto it = _bodies.find(static_cast<uint32_t>(bodyId));
+  if (it == _bodies.end()) return @0;
+  it->second->closed.Cancel();
+  _bodies.erase(it);
+  [self reportMemory];
+  return @1;
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRBodyViewerSpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,139 @@
+//
+//  IRBodyViewer.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared BodyIndex
+//
+
+#include "pch.h"
+#include "IRBodyViewer.windows.h"
+
+namespace winrt::reactotron::implementation
+{
+    IRBodyViewer::IRBodyViewer() noexcept
+    {
+        // Bodies are open only while a viewer shows them, so they're reported but never evicted
+        m_memoryStoreId = ::reactotron::MemoryGovernor::Shared().Register("bodyViewer", nullptr);
+    }
+
+    IRBodyViewer::~IRBodyViewer() noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().Unregister(m_memoryStoreId);
+    }
+
+    std::shared_ptr<IRBodyViewer::OpenBody> IRBodyViewer::Body(double bodyId) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_bodies.find(static_cast<uint32_t>(bodyId));
+        return it == m_bodies.end() ? nullptr : it->second;
+    }
+
+    void IRBodyViewer::ReportMemory() noexcept
+    {
+        uint64_t bytes = 0;
+        for (const auto &entry : m_bodies) bytes += entry.second->index.ByteSize();
+        ::reactotron::MemoryGovernor::Shared().Report(m_memoryStoreId, bytes, 0);
+    }
+
+    // REACT_METHOD calls run off the JS thread, so indexing a large body doesn't stall it. Searches
+    // go to the shared TaskExecutor, so a long one doesn't hold up the module's other calls.
+
+    void IRBodyViewer::open(std::string body, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        auto opened = std::make_shared<OpenBody>(std::move(body));
+        uint32_t bodyId;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            bodyId = ++m_nextBodyId;
+            m_bodies[bodyId] = opened;
+            ReportMemory();
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["bodyId"] = static_cast<double>(bodyId);
+        result["json"] = opened->index.IsJson();
+        result["lines"] = static_cast<double>(opened->index.LineCount());
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    double IRBodyViewer::getRowCount(double bodyId) noexcept
+    {
+        auto body = Body(bodyId);
+        if (!body) return 0;
+        std::lock_guard<std::mutex> lock(body->mutex);
+        return static_cast<double>(body->index.RowCount());
+    }
+
+    Microsoft::ReactNative::JSValue IRBodyViewer::getRows(double bodyId, double row, double count) noexcept
+    {
+        Microsoft::ReactNative::JSValueArray result;
+        auto body = Body(bodyId);
+        if (!body || row < 0 || count <= 0) return Microsoft::ReactNative::JSValue(std::move(result));
+
+        std::vector<::reactotron::BodyLine> lines;
+        {
+            std::lock_guard<std::mutex> lock(body->mutex);
+            lines = body->index.Rows(static_cast<size_t>(row), static_cast<size_t>(count));
+        }
+        for (auto &line : lines)
+        {
+            Microsoft::ReactNative::JSValueObject item;
+            item["line"] = static_cast<double>(line.line);
+            item["text"] = std::move(line.text);
+            item["truncated"] = line.truncated;
+            item["foldable"] = line.foldable;
+            item["folded"] = line.folded;
+            item["hiddenLines"] = static_cast<double>(line.hiddenLines);
+            result.push_back(std::move(item));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    double IRBodyViewer::toggleFold(double bodyId, double line) noexcept
+    {
+        auto body = Body(bodyId);
+        if (!body || line < 0) return -1;
+        std::lock_guard<std::mutex> lock(body->mutex);
+        if (!body->index.ToggleFold(static_cast<uint32_t>(line))) return -1;
+        return static_cast<double>(body->index.RowCount());
+    }
+
+    double IRBodyViewer::reveal(double bodyId, double line) noexcept
+    {
+        auto body = Body(bodyId);
+        if (!body || line < 0) return 0;
+        std::lock_guard<std::mutex> lock(body->mutex);
+        return static_cast<double>(body->index.Reveal(static_cast<uint32_t>(line)));
+    }
+
+    void IRBodyViewer::find(double bodyId, std::string needle, double fromLine, bool backwards,
+                            Microsoft::ReactNative::ReactPromise<double> const &promise) noexcept
+    {
+        auto body = Body(bodyId);
+        if (!body)
+        {
+            promise.Resolve(-1);
+            return;
+        }
+        uint32_t from = fromLine > 0 ? static_cast<uint32_t>(fromLine) : 0;
+        ::reactotron::TaskExecutor::Shared().Submit(
+            ::reactotron::TaskPriority::Interactive, body->closed,
+            [body, needle = std::move(needle), from, backwards](const ::reactotron::CancellationToken &) {
+                return body->index.Find(needle, from, backwards);
+            },
+            [promise](::reactotron::TaskOutcome<int64_t> outcome) {
+                promise.Resolve(outcome.status == ::reactotron::TaskStatus::Completed ? static_cast<double>(outcome.value) : -1);
+            });
+    }
+
+    double IRBodyViewer::close(double bodyId) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_bodies.find(static_cast<uint32_t>(bodyId));
+        if (it == m_bodies.end()) return 0;
+        it->second->closed.Cancel();
+        m_bodies.erase(it);
+        ReportMemory();
+        return 1;
+    }
+}
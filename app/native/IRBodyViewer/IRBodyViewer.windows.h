@@ -0,0 +1,58 @@
+#pragma once
+#include "NativeModules.h"
+#include "BodyIndex.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include "../TaskExecutor/TaskExecutor.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRBodyViewer)
+    struct IRBodyViewer
+    {
+        IRBodyViewer() noexcept;
+        ~IRBodyViewer() noexcept;
+
+        REACT_METHOD(open)
+        void open(std::string body, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_SYNC_METHOD(getRowCount)
+        double getRowCount(double bodyId) noexcept;
+
+        REACT_SYNC_METHOD(getRows)
+        Microsoft::ReactNative::JSValue getRows(double bodyId, double row, double count) noexcept;
+
+        REACT_SYNC_METHOD(toggleFold)
+        double toggleFold(double bodyId, double line) noexcept;
+
+        REACT_SYNC_METHOD(reveal)
+        double reveal(double bodyId, double line) noexcept;
+
+        REACT_METHOD(find)
+        void find(double bodyId, std::string needle, double fromLine, bool backwards,
+                  Microsoft::ReactNative::ReactPromise<double> const &promise) noexcept;
+
+        REACT_SYNC_METHOD(close)
+        double close(double bodyId) noexcept;
+
+    private:
+        struct OpenBody
+        {
+            explicit OpenBody(std::string body) : index(std::move(body)) {}
+            ::reactotron::BodyIndex index;
+            std::mutex mutex; // For the folds; Find() doesn't need it
+            ::reactotron::CancellationToken closed; // Searches still queued when it's closed don't run
+        };
+
+        std::shared_ptr<OpenBody> Body(double bodyId) noexcept;
+        /** Call with m_mutex held. */
+        void ReportMemory() noexcept;
+
+        std::unordered_map<uint32_t, std::shared_ptr<OpenBody>> m_bodies;
+        uint32_t m_nextBodyId = 0;
+        std::mutex m_mutex;
+        uint32_t m_memoryStoreId = 0;
+    };
+}
@@ -0,0 +1,42 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface BodyInfo {
+  bodyId: number
+  /** False if the body isn't JSON and is shown as plain text. */
+  json: boolean
+  lines: number
+}
+
+export interface BodyRow {
+  /** Among all lines, folded or not. */
+  line: number
+  /** Indented. Long lines are cut off, see truncated. */
+  text: string
+  truncated: boolean
+  foldable: boolean
+  folded: boolean
+  /** Lines folded away after this one. */
+  hiddenLines: number
+}
+
+export interface Spec extends TurboModule {
+  /** Indexes the body off the JS thread; the pretty-printed text is never built as a whole. */
+  open(body: string): Promise<BodyInfo>
+  /** Rows are positions among the lines the folds leave visible. */
+  getRowCount(bodyId: number): number
+  getRows(bodyId: number, row: number, count: number): BodyRow[]
+  /** Returns the new row count, or -1 if no region opens at `line`. */
+  toggleFold(bodyId: number, line: number): number
+  /** Unfolds whatever hides `line` and returns its row. */
+  reveal(bodyId: number, line: number): number
+  /**
+   * The first line from `fromLine` (the last up to it, if `backwards`) containing `needle`,
+   * ignoring case; -1 if there's none.
+   */
+  find(bodyId: number, needle: string, fromLine: number, backwards: boolean): Promise<number>
+  /** Returns a value so it runs synchronously, in order with the other calls. */
+  close(bodyId: number): number
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRBodyViewer")
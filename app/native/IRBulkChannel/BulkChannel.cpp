@@ -0,0 +1,142 @@
+//
+//  BulkChannel.cpp
+//  Reactotron
+//
+
+#include "BulkChannel.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+
+namespace reactotron {
+
+BulkChannels &BulkChannels::Shared() {
+  static BulkChannels *shared = new BulkChannels(); // Never destroyed, so producers can outlive static teardown
+  return *shared;
+}
+
+BulkChannels::BulkChannels() {
+  m_memoryStoreId = MemoryGovernor::Shared().Register("bulkChannels", [this](uint64_t bytes) -> uint64_t {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t before = m_queuedBytes;
+    // Oldest first across the channels, a batch from each in turn
+    bool dropped = true;
+    while (dropped && before - m_queuedBytes < bytes) {
+      dropped = false;
+      for (auto &[name, channel] : m_channels) {
+        if (channel.batches.empty()) continue;
+        DropOldest(channel);
+        dropped = true;
+        if (before - m_queuedBytes >= bytes) break;
+      }
+    }
+    ReportMemory();
+    return before - m_queuedBytes;
+  });
+}
+
+BulkChannels::~BulkChannels() { MemoryGovernor::Shared().Unregister(m_memoryStoreId); }
+
+void BulkChannels::Push(std::string_view name, std::shared_ptr<RecordBatch> batch) {
+  if (!batch || batch->Count() == 0) return;
+  PendingCallback notify;
+  std::string notifyName;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Channel &channel = Find(name);
+    channel.stats.pushed++;
+    channel.stats.records += batch->Count();
+    m_queuedBytes += batch->Size();
+    channel.stats.queuedBytes += batch->Size();
+    channel.batches.push_back(std::move(batch));
+    // Keep the newest batch even if it's over the limit on its own
+    while (channel.batches.size() > 1 && channel.stats.queuedBytes > channel.stats.byteLimit) DropOldest(channel);
+    if (!channel.notified && m_onPending) {
+      channel.notified = true;
+      notify = m_onPending;
+      notifyName = channel.stats.name;
+    }
+    ReportMemory();
+  }
+  if (notify) notify(notifyName);
+}
+
+std::shared_ptr<RecordBatch> BulkChannels::Take(std::string_view name) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_channels.find(name);
+  if (it == m_channels.end()) return nullptr;
+  Channel &channel = it->second;
+  if (channel.batches.empty()) {
+    channel.notified = false;
+    return nullptr;
+  }
+  std::shared_ptr<RecordBatch> batch = std::move(channel.batches.front());
+  channel.batches.pop_front();
+  channel.stats.taken++;
+  channel.stats.queuedBytes -= batch->Size();
+  m_queuedBytes -= batch->Size();
+  ReportMemory();
+  return batch;
+}
+
+void BulkChannels::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &[name, channel] : m_channels) {
+    while (!channel.batches.empty()) DropOldest(channel);
+  }
+  ReportMemory();
+}
+
+void BulkChannels::SetByteLimit(std::string_view name, uint64_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Channel &channel = Find(name);
+  channel.stats.byteLimit = bytes;
+  while (channel.batches.size() > 1 && channel.stats.queuedBytes > bytes) DropOldest(channel);
+  ReportMemory();
+}
+
+void BulkChannels::SetPendingCallback(PendingCallback callback) {
+  std::vector<std::string> waiting;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onPending = callback;
+    for (auto &[name, channel] : m_channels) {
+      channel.notified = m_onPending && !channel.batches.empty();
+      if (channel.notified) waiting.push_back(name);
+    }
+  }
+  // Batches pushed before anyone was listening
+  for (const std::string &name : waiting) callback(name);
+}
+
+std::vector<BulkChannelStats> BulkChannels::Stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<BulkChannelStats> stats;
+  stats.reserve(m_channels.size());
+  for (const auto &[name, channel] : m_channels) {
+    stats.push_back(channel.stats);
+    stats.back().queued = channel.batches.size();
+  }
+  return stats;
+}
+
+BulkChannels::Channel &BulkChannels::Find(std::string_view name) {
+  auto it = m_channels.find(name);
+  if (it == m_channels.end()) {
+    it = m_channels.emplace(std::string(name), Channel()).first;
+    it->second.stats.name = std::string(name);
+    it->second.stats.byteLimit = kDefaultByteLimit;
+  }
+  return it->second;
+}
+
+void BulkChannels::DropOldest(Channel &channel) {
+  const auto &batch = channel.batches.front();
+  channel.stats.dropped++;
+  channel.stats.droppedRecords += batch->Count();
+  channel.stats.queuedBytes -= batch->Size();
+  m_queuedBytes -= batch->Size();
+  channel.batches.pop_front();
+}
+
+void BulkChannels::ReportMemory() { MemoryGovernor::Shared().Report(m_memoryStoreId, m_queuedBytes, 0); }
+
+} // namespace reactotron
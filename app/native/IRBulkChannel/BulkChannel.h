@@ -0,0 +1,93 @@
+#pragma once
+
+//
+//  BulkChannel.h
+//  Reactotron
+//
+//  Named queues of record batches on their way to JS. A module pushes a
+//  batch from whatever thread made it. The channel then tells the
+//  IRBulkChannel module once that it has batches waiting, and JS takes
+//  them, each as an ArrayBuffer over the batch's own memory.
+//
+//  Each channel holds at most its byte limit. Past it, the oldest batches
+//  are dropped and counted, so a producer JS can't keep up with loses old
+//  records rather than growing without bound. The queues report to the
+//  MemoryGovernor as "bulkChannels" and drop their oldest batches when asked
+//  to free memory.
+//
+
+#include "RecordBatch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+struct BulkChannelStats {
+  std::string name;
+  size_t queued = 0; // Batches waiting to be taken
+  uint64_t queuedBytes = 0;
+  uint64_t byteLimit = 0;
+  uint64_t pushed = 0; // Batches
+  uint64_t records = 0; // In the batches pushed
+  uint64_t taken = 0;
+  uint64_t dropped = 0; // Batches dropped unread
+  uint64_t droppedRecords = 0;
+};
+
+/** The channels; Shared() is the one modules push to and JS takes from. Thread-safe. */
+class BulkChannels {
+ public:
+  static constexpr uint64_t kDefaultByteLimit = 32 * 1024 * 1024;
+
+  /** Called on the pushing thread when a channel gets batches; not again until it's been emptied. */
+  using PendingCallback = std::function<void(const std::string &channel)>;
+
+  static BulkChannels &Shared();
+
+  BulkChannels();
+  ~BulkChannels();
+  BulkChannels(const BulkChannels &) = delete;
+  BulkChannels &operator=(const BulkChannels &) = delete;
+
+  /** Queues `batch` on `channel`, made on first use. Empty batches are ignored. */
+  void Push(std::string_view channel, std::shared_ptr<RecordBatch> batch);
+  /** The channel's oldest batch, or null once it's empty. */
+  std::shared_ptr<RecordBatch> Take(std::string_view channel);
+  /** Drops what's queued on every channel; the drops are counted. */
+  void Clear();
+
+  void SetByteLimit(std::string_view channel, uint64_t bytes);
+  /** Channels already holding batches are announced to `callback` straight away. */
+  void SetPendingCallback(PendingCallback callback);
+  std::vector<BulkChannelStats> Stats() const;
+
+ private:
+  struct Channel {
+    std::deque<std::shared_ptr<RecordBatch>> batches;
+    bool notified = false;
+    BulkChannelStats stats;
+  };
+
+  // Call these with m_mutex held
+  Channel &Find(std::string_view name);
+  void DropOldest(Channel &channel);
+  void ReportMemory();
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Channel, std::less<>> m_channels;
+  uint64_t m_queuedBytes = 0;
+  PendingCallback m_onPending;
+
+  uint32_t m_memoryStoreId = 0;
+};
+
+} // namespace reactotron
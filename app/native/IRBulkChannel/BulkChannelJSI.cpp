@@ -0,0 +1,57 @@
+//
+//  BulkChannelJSI.cpp
+//  Reactotron
+//
+
+#include "BulkChannelJSI.h"
+#include "BulkChannel.h"
+
+#include <jsi/jsi.h>
+
+#include <cstring>
+
+namespace jsi = facebook::jsi;
+
+namespace reactotron {
+
+namespace {
+
+/** Lends a batch's bytes to an ArrayBuffer; the batch lives as long as the buffer does. */
+class BatchBuffer : public jsi::MutableBuffer {
+ public:
+  explicit BatchBuffer(std::shared_ptr<RecordBatch> batch) : m_batch(std::move(batch)) {}
+
+  size_t size() const override { return m_batch->Size(); }
+  uint8_t *data() override { return m_batch->Data(); }
+
+ private:
+  std::shared_ptr<RecordBatch> m_batch;
+};
+
+jsi::Value CopiedArrayBuffer(jsi::Runtime &runtime, const RecordBatch &batch) {
+  jsi::Function constructor = runtime.global().getPropertyAsFunction(runtime, "ArrayBuffer");
+  jsi::Object buffer = constructor.callAsConstructor(runtime, static_cast<double>(batch.Size())).asObject(runtime);
+  std::memcpy(buffer.getArrayBuffer(runtime).data(runtime), batch.Data(), batch.Size());
+  return jsi::Value(std::move(buffer));
+}
+
+} // namespace
+
+void InstallBulkChannelBindings(jsi::Runtime &runtime) {
+  auto take = jsi::Function::createFromHostFunction(
+      runtime, jsi::PropNameID::forAscii(runtime, "__irBulkTake"), 1,
+      [](jsi::Runtime &runtime, const jsi::Value &, const jsi::Value *args, size_t count) -> jsi::Value {
+        if (count < 1 || !args[0].isString()) throw jsi::JSError(runtime, "__irBulkTake expects a channel name");
+        std::shared_ptr<RecordBatch> batch = BulkChannels::Shared().Take(args[0].getString(runtime).utf8(runtime));
+        if (!batch) return jsi::Value::null();
+        try {
+          return jsi::ArrayBuffer(runtime, std::make_shared<BatchBuffer>(batch));
+        } catch (const jsi::JSINativeException &) {
+          // The runtime can't wrap memory it doesn't own
+          return CopiedArrayBuffer(runtime, *batch);
+        }
+      });
+  runtime.global().setProperty(runtime, "__irBulkTake", std::move(take));
+}
+
+} // namespace reactotron
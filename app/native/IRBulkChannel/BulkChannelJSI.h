@@ -0,0 +1,27 @@
+#pragma once
+
+//
+//  BulkChannelJSI.h
+//  Reactotron
+//
+//  The JS side of the bulk channels. Codegen specs can't pass ArrayBuffers,
+//  so IRBulkChannel installs a function on the runtime's global object
+//  instead:
+//
+//    __irBulkTake(channel: string): ArrayBuffer | null
+//
+//  It takes the channel's oldest batch. The ArrayBuffer is the batch's own
+//  memory, kept alive by JS until it's collected, so nothing is copied where
+//  the runtime supports external buffers (Hermes does); elsewhere the batch
+//  is copied into a new ArrayBuffer once. Call it on the JS thread.
+//
+
+namespace facebook::jsi {
+class Runtime;
+}
+
+namespace reactotron {
+
+void InstallBulkChannelBindings(facebook::jsi::Runtime &runtime);
+
+} // namespace reactotron
@@ -0,0 +1,65 @@
+//
+//  IRBulkChannel.mm
+//  Reactotron-macOS
+//
+//  Hands batches of fixed-layout records to JS as ArrayBuffers. See
+//  BulkChannel.h and BulkChannelJSI.h.
+//
+
+#import "IRBulkChannel.h"
+#import <ReactCommon/RCTTurboModuleWithJSIBindings.h>
+#include "BulkChannel.h"
+#include "BulkChannelJSI.h"
+#include <string>
+
+@interface IRBulkChannel () <RCTTurboModuleWithJSIBindings>
+@end
+
+@implementation IRBulkChannel
+
+RCT_EXPORT_MODULE()
+
+- (void)installJSIBindingsWithRuntime:(facebook::jsi::Runtime &)runtime {
+  reactotron::InstallBulkChannelBindings(runtime);
+
+  __weak IRBulkChannel *weakSelf = self;
+  reactotron::BulkChannels::Shared().SetPendingCallback([weakSelf](const std::string &channel) {
+    NSString *name = [NSString stringWithUTF8String:channel.c_str()] ?: @"";
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [weakSelf emitOnBulkChannelPending:@{ @"channel": name }];
+    });
+  });
+}
+
+- (void)setByteLimit:(NSString *)channel bytes:(double)bytes {
+  reactotron::BulkChannels::Shared().SetByteLimit(channel.UTF8String ?: "", bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
+}
+
+- (void)clear {
+  reactotron::BulkChannels::Shared().Clear();
+}
+
+- (NSArray *)getStats {
+  auto stats = reactotron::BulkChannels::Shared().Stats();
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:stats.size()];
+  for (const auto &channel : stats) {
+    [result addObject:@{
+      @"name": [NSString stringWithUTF8String:channel.name.c_str()] ?: @"",
+      @"queued": @(channel.queued),
+      @"queuedBytes": @(channel.queuedBytes),
+      @"byteLimit": @(channel.byteLimit),
+      @"pushed": @(channel.pushed),
+      @"records": @(channel.records),
+      @"taken": @(channel.taken),
+      @"dropped": @(channel.dropped),
+      @"droppedRecords": @(channel.droppedRecords),
+    }];
+  }
+  return result;
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRBulkChannelSpecJSI>(params);
+}
+
+@end
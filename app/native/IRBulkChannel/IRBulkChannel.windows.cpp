@@ -0,0 +1,61 @@
+//
+//  IRBulkChannel.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared BulkChannels
+//
+
+#include "pch.h"
+#include "IRBulkChannel.windows.h"
+#include <JSI/JsiApiContext.h>
+
+namespace winrt::reactotron::implementation
+{
+    IRBulkChannel::~IRBulkChannel() noexcept
+    {
+        ::reactotron::BulkChannels::Shared().SetPendingCallback(nullptr);
+    }
+
+    void IRBulkChannel::Initialize(Microsoft::ReactNative::ReactContext const &reactContext) noexcept
+    {
+        Microsoft::ReactNative::ExecuteJsi(reactContext, [](facebook::jsi::Runtime &runtime) {
+            ::reactotron::InstallBulkChannelBindings(runtime);
+        });
+
+        ::reactotron::BulkChannels::Shared().SetPendingCallback([this](const std::string &channel) {
+            Microsoft::ReactNative::JSValueObject event;
+            event["channel"] = channel;
+            if (onBulkChannelPending) onBulkChannelPending(Microsoft::ReactNative::JSValue(std::move(event)));
+        });
+    }
+
+    void IRBulkChannel::setByteLimit(std::string channel, double bytes) noexcept
+    {
+        ::reactotron::BulkChannels::Shared().SetByteLimit(channel, bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
+    }
+
+    void IRBulkChannel::clear() noexcept
+    {
+        ::reactotron::BulkChannels::Shared().Clear();
+    }
+
+    Microsoft::ReactNative::JSValue IRBulkChannel::getStats() noexcept
+    {
+        Microsoft::ReactNative::JSValueArray channels;
+        for (const auto &stats : ::reactotron::BulkChannels::Shared().Stats())
+        {
+            Microsoft::ReactNative::JSValueObject entry;
+            entry["name"] = stats.name;
+            entry["queued"] = static_cast<double>(stats.queued);
+            entry["queuedBytes"] = static_cast<double>(stats.queuedBytes);
+            entry["byteLimit"] = static_cast<double>(stats.byteLimit);
+            entry["pushed"] = static_cast<double>(stats.pushed);
+            entry["records"] = static_cast<double>(stats.records);
+            entry["taken"] = static_cast<double>(stats.taken);
+            entry["dropped"] = static_cast<double>(stats.dropped);
+            entry["droppedRecords"] = static_cast<double>(stats.droppedRecords);
+            channels.push_back(std::move(entry));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(channels));
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "NativeModules.h"
+#include "BulkChannel.h"
+#include "BulkChannelJSI.h"
+#include <functional>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRBulkChannel)
+    struct IRBulkChannel
+    {
+        IRBulkChannel() noexcept = default;
+        ~IRBulkChannel() noexcept;
+
+        REACT_INIT(Initialize)
+        void Initialize(Microsoft::ReactNative::ReactContext const &reactContext) noexcept;
+
+        REACT_METHOD(setByteLimit)
+        void setByteLimit(std::string channel, double bytes) noexcept;
+
+        REACT_METHOD(clear)
+        void clear() noexcept;
+
+        REACT_SYNC_METHOD(getStats)
+        Microsoft::ReactNative::JSValue getStats() noexcept;
+
+        REACT_EVENT(onBulkChannelPending)
+        std::function<void(Microsoft::ReactNative::JSValue)> onBulkChannelPending;
+    };
+}
@@ -0,0 +1,37 @@
+import type { EventEmitter } from "react-native/Libraries/Types/CodegenTypes"
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface BulkChannelStats {
+  name: string
+  /** Batches waiting to be taken. */
+  queued: number
+  queuedBytes: number
+  byteLimit: number
+  /** Batches pushed, and the records in them. */
+  pushed: number
+  records: number
+  taken: number
+  /** Batches dropped unread because the channel was over its byte limit, and their records. */
+  dropped: number
+  droppedRecords: number
+}
+
+export interface BulkChannelPendingEvent {
+  channel: string
+}
+
+/**
+ * Batches themselves are taken with the global __irBulkTake(channel), which this module
+ * installs when it's loaded (see BulkChannelJSI.h); codegen can't pass ArrayBuffers.
+ */
+export interface Spec extends TurboModule {
+  /** Past `bytes` queued, the channel drops its oldest batches. */
+  setByteLimit(channel: string, bytes: number): void
+  clear(): void
+  getStats(): BulkChannelStats[]
+  /** Sent once when a channel gets batches, then not again until it has been emptied. */
+  readonly onBulkChannelPending: EventEmitter<BulkChannelPendingEvent>
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRBulkChannel")
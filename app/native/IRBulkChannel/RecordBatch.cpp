@@ -0,0 +1,242 @@
+//
+//  RecordBatch.cpp
+//  Reactotron
+//
+
+#include "RecordBatch.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace reactotron {
+
+namespace {
+
+constexpr struct {
+  const char *name;
+  RecordFieldType type;
+  uint32_t size;
+} kFieldTypes[] = {
+    {"bool", RecordFieldType::Bool, 1}, {"u8", RecordFieldType::U8, 1},   {"i8", RecordFieldType::I8, 1},
+    {"u16", RecordFieldType::U16, 2},   {"i16", RecordFieldType::I16, 2}, {"u32", RecordFieldType::U32, 4},
+    {"i32", RecordFieldType::I32, 4},   {"f32", RecordFieldType::F32, 4}, {"f64", RecordFieldType::F64, 8},
+    {"string", RecordFieldType::String, 8},
+};
+
+uint32_t FieldAlignment(RecordFieldType type) noexcept {
+  return type == RecordFieldType::String ? 4 : RecordFieldSize(type);
+}
+
+uint32_t AlignUp(uint32_t value, uint32_t alignment) noexcept { return (value + alignment - 1) / alignment * alignment; }
+
+std::string_view Trim(std::string_view text) noexcept {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+  return text;
+}
+
+bool IsIdentifier(std::string_view name) noexcept {
+  if (name.empty() || (name[0] >= '0' && name[0] <= '9')) return false;
+  for (char c : name) {
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    if (!ok) return false;
+  }
+  return true;
+}
+
+uint32_t Fnv1a(std::string_view text) noexcept {
+  uint32_t hash = 2166136261u;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+uint32_t ReadU32(const uint8_t *data) noexcept {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void Store(uint8_t *at, T value) noexcept {
+  std::memcpy(at, &value, sizeof(value));
+}
+
+/** Wraps like a JS typed array store: truncate toward zero, then modulo 2^64. NaN and infinities become 0. */
+uint64_t WrapInteger(double value) noexcept {
+  if (!std::isfinite(value)) return 0;
+  constexpr double kTwo63 = 9223372036854775808.0;
+  constexpr double kTwo64 = 2 * kTwo63;
+  value = std::fmod(std::trunc(value), kTwo64);
+  if (value >= kTwo63) return static_cast<uint64_t>(value);
+  if (value >= -kTwo63) return static_cast<uint64_t>(static_cast<int64_t>(value));
+  return static_cast<uint64_t>(value + kTwo64); // Exact: the value is a multiple of 2^11 this far out
+}
+
+} // namespace
+
+const char *RecordFieldTypeName(RecordFieldType type) noexcept {
+  for (const auto &entry : kFieldTypes) {
+    if (entry.type == type) return entry.name;
+  }
+  return "";
+}
+
+bool ParseRecordFieldType(std::string_view name, RecordFieldType &type) noexcept {
+  for (const auto &entry : kFieldTypes) {
+    if (name == entry.name) {
+      type = entry.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t RecordFieldSize(RecordFieldType type) noexcept {
+  for (const auto &entry : kFieldTypes) {
+    if (entry.type == type) return entry.size;
+  }
+  return 0;
+}
+
+bool RecordLayout::Parse(std::string_view schema, RecordLayout &layout, std::string &error) {
+  RecordLayout parsed;
+  uint32_t offset = 0;
+  uint32_t alignment = 1;
+  while (!schema.empty()) {
+    size_t end = schema.find_first_of(",;\n");
+    std::string_view entry = Trim(schema.substr(0, end));
+    schema.remove_prefix(end == std::string_view::npos ? schema.size() : end + 1);
+    if (entry.empty()) continue;
+
+    size_t colon = entry.find(':');
+    if (colon == std::string_view::npos) {
+      error = "Expected \"name: type\", got \"" + std::string(entry) + "\"";
+      return false;
+    }
+    std::string_view name = Trim(entry.substr(0, colon));
+    std::string_view typeName = Trim(entry.substr(colon + 1));
+    RecordField field;
+    if (!IsIdentifier(name)) {
+      error = "Bad field name \"" + std::string(name) + "\"";
+      return false;
+    }
+    if (!ParseRecordFieldType(typeName, field.type)) {
+      error = "Unknown type \"" + std::string(typeName) + "\" for field " + std::string(name);
+      return false;
+    }
+    if (parsed.FieldIndex(name) != kNoField) {
+      error = "Field " + std::string(name) + " is listed twice";
+      return false;
+    }
+
+    uint32_t fieldAlignment = FieldAlignment(field.type);
+    field.name = std::string(name);
+    field.offset = AlignUp(offset, fieldAlignment);
+    offset = field.offset + RecordFieldSize(field.type);
+    if (fieldAlignment > alignment) alignment = fieldAlignment;
+
+    if (!parsed.m_schema.empty()) parsed.m_schema += ", ";
+    parsed.m_schema += field.name + ": " + RecordFieldTypeName(field.type);
+    parsed.m_fields.push_back(std::move(field));
+  }
+  if (parsed.m_fields.empty()) {
+    error = "The schema has no fields";
+    return false;
+  }
+  parsed.m_recordSize = AlignUp(offset, alignment);
+  parsed.m_hash = Fnv1a(parsed.m_schema);
+  layout = std::move(parsed);
+  return true;
+}
+
+RecordLayout RecordLayout::Make(std::string_view schema) {
+  RecordLayout layout;
+  std::string error;
+  Parse(schema, layout, error);
+  return layout;
+}
+
+size_t RecordLayout::FieldIndex(std::string_view name) const noexcept {
+  for (size_t i = 0; i < m_fields.size(); i++) {
+    if (m_fields[i].name == name) return i;
+  }
+  return kNoField;
+}
+
+uint32_t RecordBatch::Count() const noexcept {
+  return m_bytes.size() >= kRecordBatchHeaderSize ? ReadU32(m_bytes.data() + 16) : 0;
+}
+
+uint32_t RecordBatch::LayoutHash() const noexcept {
+  return m_bytes.size() >= kRecordBatchHeaderSize ? ReadU32(m_bytes.data() + 8) : 0;
+}
+
+void RecordBatchWriter::Record::SetNumber(size_t field, double value) noexcept {
+  const auto &fields = m_writer.m_layout.Fields();
+  if (field >= fields.size()) return;
+  uint8_t *at = m_writer.m_records.data() + m_offset + fields[field].offset;
+  switch (fields[field].type) {
+    case RecordFieldType::Bool: Store<uint8_t>(at, value != 0 && !std::isnan(value)); break;
+    case RecordFieldType::U8:
+    case RecordFieldType::I8: Store(at, static_cast<uint8_t>(WrapInteger(value))); break;
+    case RecordFieldType::U16:
+    case RecordFieldType::I16: Store(at, static_cast<uint16_t>(WrapInteger(value))); break;
+    case RecordFieldType::U32:
+    case RecordFieldType::I32: Store(at, static_cast<uint32_t>(WrapInteger(value))); break;
+    case RecordFieldType::F32: Store(at, static_cast<float>(value)); break;
+    case RecordFieldType::F64: Store(at, value); break;
+    case RecordFieldType::String: break;
+  }
+}
+
+void RecordBatchWriter::Record::Set(size_t field, std::string_view value) {
+  const auto &fields = m_writer.m_layout.Fields();
+  if (field >= fields.size() || fields[field].type != RecordFieldType::String) return;
+  std::string &strings = m_writer.m_strings;
+  // Offsets and lengths are u32; a heap that would outgrow them gets "" instead.
+  if (value.size() > std::numeric_limits<uint32_t>::max() - strings.size()) return;
+  uint8_t *at = m_writer.m_records.data() + m_offset + fields[field].offset;
+  Store(at, static_cast<uint32_t>(strings.size()));
+  Store(at + 4, static_cast<uint32_t>(value.size()));
+  strings.append(value);
+}
+
+RecordBatchWriter::RecordBatchWriter(const RecordLayout &layout, size_t reserveRecords) : m_layout(layout) {
+  m_records.reserve(reserveRecords * layout.RecordSize());
+}
+
+RecordBatchWriter::Record RecordBatchWriter::Append() {
+  size_t offset = m_records.size();
+  m_records.resize(offset + m_layout.RecordSize());
+  m_count++;
+  return Record(*this, offset);
+}
+
+std::shared_ptr<RecordBatch> RecordBatchWriter::Finish() {
+  std::vector<uint8_t> bytes(ByteSize());
+  uint32_t recordsOffset = kRecordBatchHeaderSize;
+  uint32_t stringsOffset = recordsOffset + static_cast<uint32_t>(m_records.size());
+  uint8_t *header = bytes.data();
+  Store(header, kRecordBatchMagic);
+  Store(header + 4, kRecordBatchVersion);
+  Store(header + 6, static_cast<uint16_t>(kRecordBatchHeaderSize));
+  Store(header + 8, m_layout.Hash());
+  Store(header + 12, m_layout.RecordSize());
+  Store(header + 16, static_cast<uint32_t>(m_count));
+  Store(header + 20, recordsOffset);
+  Store(header + 24, stringsOffset);
+  Store(header + 28, static_cast<uint32_t>(m_strings.size()));
+  if (!m_records.empty()) std::memcpy(bytes.data() + recordsOffset, m_records.data(), m_records.size());
+  if (!m_strings.empty()) std::memcpy(bytes.data() + stringsOffset, m_strings.data(), m_strings.size());
+
+  m_records.clear();
+  m_strings.clear();
+  m_count = 0;
+  return std::make_shared<RecordBatch>(std::move(bytes));
+}
+
+} // namespace reactotron
@@ -0,0 +1,152 @@
+#pragma once
+
+//
+//  RecordBatch.h
+//  Reactotron
+//
+//  Fixed-layout records packed into one buffer, so a module can hand JS
+//  thousands of them as an ArrayBuffer instead of a dictionary per record
+//  converted field by field. A schema such as
+//
+//    "id: u32, time: f64, level: u8, message: string"
+//
+//  gives each field a type and, in declared order, an offset aligned to its
+//  size. JS reads fields straight out of the buffer (app/utils/bulkChannel.ts
+//  lays the same schema out the same way). Strings go in a heap after the
+//  records; their field holds a u32 offset into it and a u32 byte length.
+//
+//  Buffer layout, little-endian:
+//
+//    0   u32  magic "IRRB"
+//    4   u16  version
+//    6   u16  header size (32)
+//    8   u32  layout hash, to catch a reader built from another schema
+//    12  u32  record size
+//    16  u32  record count
+//    20  u32  records offset
+//    24  u32  string heap offset
+//    28  u32  string heap size
+//
+//  List fields largest first to keep padding out of the records.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace reactotron {
+
+enum class RecordFieldType : uint8_t { Bool, U8, I8, U16, I16, U32, I32, F32, F64, String };
+
+/** The schema name of `type`: "bool", "u8"... "string". */
+const char *RecordFieldTypeName(RecordFieldType type) noexcept;
+bool ParseRecordFieldType(std::string_view name, RecordFieldType &type) noexcept;
+/** Bytes the field takes in a record; a string's offset and length take 8. */
+uint32_t RecordFieldSize(RecordFieldType type) noexcept;
+
+struct RecordField {
+  std::string name;
+  RecordFieldType type = RecordFieldType::U8;
+  uint32_t offset = 0;
+};
+
+/** A schema laid out. Immutable once made, so it can be shared between threads. */
+class RecordLayout {
+ public:
+  static constexpr size_t kNoField = static_cast<size_t>(-1);
+
+  /** Lays out `schema`; false with `error` if it's malformed. */
+  static bool Parse(std::string_view schema, RecordLayout &layout, std::string &error);
+  /**
+   * For a schema fixed at build time. One that doesn't parse makes a layout
+   * with no fields, whose batches JS refuses to read.
+   */
+  static RecordLayout Make(std::string_view schema);
+
+  RecordLayout() = default;
+
+  const std::vector<RecordField> &Fields() const noexcept { return m_fields; }
+  size_t FieldIndex(std::string_view name) const noexcept;
+  uint32_t RecordSize() const noexcept { return m_recordSize; }
+  /** FNV-1a over Schema(), so a field renamed, retyped or moved changes it. */
+  uint32_t Hash() const noexcept { return m_hash; }
+  /** The schema, normalized: "name: type, name: type". */
+  const std::string &Schema() const noexcept { return m_schema; }
+
+ private:
+  std::vector<RecordField> m_fields;
+  uint32_t m_recordSize = 0;
+  uint32_t m_hash = 0;
+  std::string m_schema;
+};
+
+constexpr uint32_t kRecordBatchMagic = 0x42525249; // "IRRB"
+constexpr uint16_t kRecordBatchVersion = 1;
+constexpr uint32_t kRecordBatchHeaderSize = 32;
+
+/** A finished buffer. Immutable, though its bytes are handed to JS as a mutable ArrayBuffer. */
+class RecordBatch {
+ public:
+  explicit RecordBatch(std::vector<uint8_t> bytes) : m_bytes(std::move(bytes)) {}
+
+  uint8_t *Data() noexcept { return m_bytes.data(); }
+  const uint8_t *Data() const noexcept { return m_bytes.data(); }
+  size_t Size() const noexcept { return m_bytes.size(); }
+  uint32_t Count() const noexcept;
+  uint32_t LayoutHash() const noexcept;
+
+ private:
+  std::vector<uint8_t> m_bytes;
+};
+
+/**
+ * Fills a batch one record at a time. Not thread-safe; one writer per
+ * producer, each making batches of its own.
+ */
+class RecordBatchWriter {
+ public:
+  /** Where Set() writes; valid until the next Append() or Finish(). */
+  class Record {
+   public:
+    /** Numbers are converted to the field's type; integers out of its range wrap. */
+    template <typename Number, std::enable_if_t<std::is_arithmetic_v<Number>, int> = 0>
+    void Set(size_t field, Number value) noexcept {
+      SetNumber(field, static_cast<double>(value));
+    }
+    void Set(size_t field, std::string_view value);
+    void Set(size_t field, const char *value) { Set(field, std::string_view(value ? value : "")); }
+
+   private:
+    friend class RecordBatchWriter;
+    Record(RecordBatchWriter &writer, size_t offset) : m_writer(writer), m_offset(offset) {}
+    void SetNumber(size_t field, double value) noexcept;
+
+    RecordBatchWriter &m_writer;
+    size_t m_offset;
+  };
+
+  /** `layout` must outlive the writer. */
+  explicit RecordBatchWriter(const RecordLayout &layout, size_t reserveRecords = 0);
+
+  /** A zeroed record at the end of the batch: 0 numbers, false, "". */
+  Record Append();
+
+  size_t Count() const noexcept { return m_count; }
+  /** What Finish() would return, in bytes. */
+  size_t ByteSize() const noexcept { return kRecordBatchHeaderSize + m_records.size() + m_strings.size(); }
+
+  /** The records so far as a batch; the writer starts over empty. */
+  std::shared_ptr<RecordBatch> Finish();
+
+ private:
+  const RecordLayout &m_layout;
+  std::vector<uint8_t> m_records;
+  std::string m_strings;
+  size_t m_count = 0;
+};
+
+} // namespace reactotron
@@ -8,11 +8,25 @@
 #import <Cocoa/Cocoa.h>
 #import "IRClipboard.h"
 
+// Copies at least this long are only handed to the pasteboard server when something pastes them
+static const NSUInteger kDelayedRenderThreshold = 1024 * 1024;
+
+@interface IRClipboard () <NSPasteboardItemDataProvider>
+@property (nonatomic, copy, nullable) NSString *pendingText;
+@property (nonatomic, assign) NSInteger pendingChangeCount;
+@end
+
 @implementation IRClipboard RCT_EXPORT_MODULE()
 
 // Sync: get current clipboard string
 - (NSString *)getString {
   NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
+  // Our own delayed copy: answer it without forcing the provider round trip
+  @synchronized (self) {
+    if (self.pendingText != nil && pasteboard.changeCount == self.pendingChangeCount) {
+      return self.pendingText;
+    }
+  }
   NSString *string = [pasteboard stringForType:NSPasteboardTypeString];
   return string ?: @"";
 }
@@ -22,7 +36,39 @@
   if (text == nil) { return; }
   NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
   [pasteboard clearContents];
-  [pasteboard setString:text forType:NSPasteboardTypeString];
+
+  if (text.length < kDelayedRenderThreshold) {
+    @synchronized (self) { self.pendingText = nil; }
+    [pasteboard setString:text forType:NSPasteboardTypeString];
+    return;
+  }
+
+  // Promise the string and provide it on demand (or when the app quits)
+  NSPasteboardItem *item = [[NSPasteboardItem alloc] init];
+  [item setDataProvider:self forTypes:@[NSPasteboardTypeString]];
+  @synchronized (self) {
+    self.pendingText = text;
+    if ([pasteboard writeObjects:@[item]]) {
+      self.pendingChangeCount = pasteboard.changeCount;
+    } else {
+      self.pendingText = nil;
+      [pasteboard setString:text forType:NSPasteboardTypeString];
+    }
+  }
+}
+
+#pragma mark - NSPasteboardItemDataProvider
+
+- (void)pasteboard:(NSPasteboard *)pasteboard item:(NSPasteboardItem *)item provideDataForType:(NSPasteboardType)type {
+  NSString *text;
+  @synchronized (self) { text = self.pendingText; }
+  if (text != nil) {
+    [item setString:text forType:type];
+  }
+}
+
+- (void)pasteboardFinishedWithDataProvider:(NSPasteboard *)pasteboard {
+  @synchronized (self) { self.pendingText = nil; }
 }
 
 // Required by TurboModules.
@@ -7,44 +7,306 @@
 
 #include "pch.h"
 #include "IRClipboard.windows.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include <future>
+#include <mutex>
+#include <thread>
 
 namespace winrt::reactotron::implementation
 {
+    namespace
+    {
+        // Copies at least this large are only converted and handed to Windows when something pastes them
+        constexpr size_t kDelayedRenderThreshold = 1024 * 1024;
+
+        // Converts UTF-8 straight into a movable global buffer suitable for CF_UNICODETEXT.
+        HGLOBAL AllocUnicodeText(const std::string &text) noexcept
+        {
+            size_t units = ::reactotron::Utf16LengthForUtf8(text.data(), text.size());
+            HGLOBAL hData = GlobalAlloc(GMEM_MOVEABLE, (units + 1) * sizeof(wchar_t));
+            if (hData == nullptr)
+            {
+                return nullptr;
+            }
+
+            auto *pchData = static_cast<char16_t *>(GlobalLock(hData));
+            if (pchData == nullptr)
+            {
+                GlobalFree(hData);
+                return nullptr;
+            }
+
+            ::reactotron::ConvertUtf8ToUtf16(text.data(), text.size(), pchData);
+            pchData[units] = u'\0';
+            GlobalUnlock(hData);
+            return hData;
+        }
+
+        bool ReadUnicodeText(std::string &text) noexcept
+        {
+            HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+            if (hData == nullptr)
+            {
+                return false;
+            }
+
+            auto *pszText = static_cast<const char16_t *>(GlobalLock(hData));
+            if (pszText == nullptr)
+            {
+                return false;
+            }
+
+            // Don't trust the terminator; never read past the allocation
+            size_t capacity = GlobalSize(hData) / sizeof(char16_t);
+            size_t length = 0;
+            while (length < capacity && pszText[length] != u'\0')
+            {
+                length++;
+            }
+
+            text.resize(::reactotron::Utf8LengthForUtf16(pszText, length));
+            ::reactotron::ConvertUtf16ToUtf8(pszText, length, text.data());
+            GlobalUnlock(hData);
+            return true;
+        }
+
+        bool ReadAnsiText(std::string &text) noexcept
+        {
+            HANDLE hData = GetClipboardData(CF_TEXT);
+            if (hData == nullptr)
+            {
+                return false;
+            }
+
+            char *pszText = static_cast<char *>(GlobalLock(hData));
+            if (pszText == nullptr)
+            {
+                return false;
+            }
+
+            text.assign(pszText, strnlen(pszText, GlobalSize(hData)));
+            GlobalUnlock(hData);
+            return true;
+        }
+    }
+
+    /**
+     * Owns a message-only window on its own thread so it can take clipboard ownership and
+     * answer WM_RENDERFORMAT. Large copies advertise CF_UNICODETEXT without data; the
+     * UTF-16 conversion and the global allocation only happen if something pastes.
+     */
+    class DelayedClipboardRenderer
+    {
+    public:
+        DelayedClipboardRenderer() noexcept
+        {
+            std::promise<HWND> ready;
+            auto hwndFuture = ready.get_future();
+            m_thread = std::thread([this, ready = std::move(ready)]() mutable { Run(std::move(ready)); });
+            m_hwnd = hwndFuture.get();
+        }
+
+        ~DelayedClipboardRenderer() noexcept
+        {
+            // Destroying the owner window sends WM_RENDERALLFORMATS, so a pending copy
+            // survives the module going away.
+            if (m_hwnd)
+            {
+                PostMessageW(m_hwnd, WM_CLOSE, 0, 0);
+            }
+            if (m_thread.joinable())
+            {
+                m_thread.join();
+            }
+        }
+
+        // Takes `text` only if the clipboard could be claimed.
+        bool SetText(std::string &text) noexcept
+        {
+            if (!m_hwnd || !OpenClipboard(m_hwnd))
+            {
+                return false;
+            }
+
+            // EmptyClipboard sends WM_DESTROYCLIPBOARD to the previous owner (possibly us),
+            // so only stash the new text after it returns.
+            EmptyClipboard();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending = std::make_shared<const std::string>(std::move(text));
+            }
+            SetClipboardData(CF_UNICODETEXT, nullptr);
+            CloseClipboard();
+            return true;
+        }
+
+        // Returns the pending text without rendering it, if we still own the clipboard.
+        bool TryGetPendingText(std::string &text) noexcept
+        {
+            if (!m_hwnd || GetClipboardOwner() != m_hwnd)
+            {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pending)
+            {
+                return false;
+            }
+            text = *m_pending;
+            return true;
+        }
+
+    private:
+        static constexpr const wchar_t *kWindowClass = L"IRClipboardDelayedRenderer";
+
+        void Run(std::promise<HWND> ready) noexcept
+        {
+            WNDCLASSEXW wc{};
+            wc.cbSize = sizeof(wc);
+            wc.lpfnWndProc = WndProc;
+            wc.hInstance = GetModuleHandleW(nullptr);
+            wc.lpszClassName = kWindowClass;
+            RegisterClassExW(&wc); // Fails harmlessly if already registered
+
+            HWND hwnd = CreateWindowExW(0, kWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr,
+                                        wc.hInstance, this);
+            ready.set_value(hwnd);
+            if (!hwnd)
+            {
+                return;
+            }
+
+            MSG msg;
+            while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+            {
+                TranslateMessage(&msg);
+                DispatchMessageW(&msg);
+            }
+        }
+
+        HANDLE Render() noexcept
+        {
+            std::shared_ptr<const std::string> pending;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                pending = m_pending;
+            }
+            return pending ? AllocUnicodeText(*pending) : nullptr;
+        }
+
+        static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) noexcept
+        {
+            if (message == WM_NCCREATE)
+            {
+                auto *create = reinterpret_cast<CREATESTRUCTW *>(lParam);
+                SetWindowLongPtrW(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create->lpCreateParams));
+            }
+
+            auto *self = reinterpret_cast<DelayedClipboardRenderer *>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+            if (self)
+            {
+                switch (message)
+                {
+                case WM_RENDERFORMAT:
+                    // The clipboard is already open on behalf of whoever is pasting
+                    if (wParam == CF_UNICODETEXT)
+                    {
+                        if (HANDLE hData = self->Render())
+                        {
+                            if (SetClipboardData(CF_UNICODETEXT, hData) == nullptr)
+                            {
+                                GlobalFree(hData);
+                            }
+                        }
+                    }
+                    return 0;
+
+                case WM_RENDERALLFORMATS:
+                    if (OpenClipboard(hwnd))
+                    {
+                        if (GetClipboardOwner() == hwnd)
+                        {
+                            if (HANDLE hData = self->Render())
+                            {
+                                if (SetClipboardData(CF_UNICODETEXT, hData) == nullptr)
+                                {
+                                    GlobalFree(hData);
+                                }
+                            }
+                        }
+                        CloseClipboard();
+                    }
+                    return 0;
+
+                case WM_DESTROYCLIPBOARD:
+                {
+                    std::lock_guard<std::mutex> lock(self->m_mutex);
+                    self->m_pending.reset();
+                    return 0;
+                }
+
+                case WM_DESTROY:
+                    PostQuitMessage(0);
+                    return 0;
+                }
+            }
+
+            return DefWindowProcW(hwnd, message, wParam, lParam);
+        }
+
+        std::thread m_thread;
+        HWND m_hwnd = nullptr;
+        std::mutex m_mutex;
+        std::shared_ptr<const std::string> m_pending;
+    };
+
     IRClipboard::IRClipboard() noexcept
     {
         // TurboModule initialization
     }
 
+    IRClipboard::~IRClipboard() noexcept = default;
+
     std::string IRClipboard::getString() noexcept
     {
-        if (!OpenClipboard(nullptr))
+        std::string text;
+
+        // Our own delayed copy: skip the round trip through UTF-16
+        if (m_delayedRenderer && m_delayedRenderer->TryGetPendingText(text))
         {
-            return "";
+            return text;
         }
 
-        HANDLE hData = GetClipboardData(CF_TEXT);
-        if (hData == nullptr)
+        if (!OpenClipboard(nullptr))
         {
-            CloseClipboard();
             return "";
         }
 
-        char* pszText = static_cast<char*>(GlobalLock(hData));
-        if (pszText == nullptr)
+        // Prefer the Unicode format; Windows synthesizes it from CF_TEXT when needed
+        if (!ReadUnicodeText(text) && !ReadAnsiText(text))
         {
-            CloseClipboard();
-            return "";
+            text.clear();
         }
 
-        std::string text(pszText);
-        GlobalUnlock(hData);
         CloseClipboard();
-
         return text;
     }
 
     void IRClipboard::setString(std::string text) noexcept
     {
+        if (text.size() >= kDelayedRenderThreshold)
+        {
+            if (!m_delayedRenderer)
+            {
+                m_delayedRenderer = std::make_unique<DelayedClipboardRenderer>();
+            }
+            if (m_delayedRenderer->SetText(text))
+            {
+                return;
+            }
+            // The renderer window couldn't take the clipboard; copy eagerly instead
+        }
+
         if (!OpenClipboard(nullptr))
         {
             return;
@@ -52,30 +314,18 @@ namespace winrt::reactotron::implementation
 
         EmptyClipboard();
 
-        size_t textLength = text.length() + 1;
-        HGLOBAL hClipboardData = GlobalAlloc(GMEM_DDESHARE, textLength);
+        HGLOBAL hClipboardData = AllocUnicodeText(text);
         if (hClipboardData == nullptr)
         {
             CloseClipboard();
             return;
         }
 
-        char* pchData = static_cast<char*>(GlobalLock(hClipboardData));
-        if (pchData == nullptr)
-        {
-            GlobalFree(hClipboardData);
-            CloseClipboard();
-            return;
-        }
-
-        strcpy_s(pchData, textLength, text.c_str());
-        GlobalUnlock(hClipboardData);
-
-        if (SetClipboardData(CF_TEXT, hClipboardData) == nullptr)
+        if (SetClipboardData(CF_UNICODETEXT, hClipboardData) == nullptr)
         {
             GlobalFree(hClipboardData);
         }
 
         CloseClipboard();
     }
-}
\ No newline at end of file
+}
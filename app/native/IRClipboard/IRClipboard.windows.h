@@ -1,17 +1,25 @@
 #pragma once
 #include "NativeModules.h"
+#include <memory>
 
 namespace winrt::reactotron::implementation
 {
+    class DelayedClipboardRenderer;
+
     REACT_MODULE(IRClipboard)
     struct IRClipboard
     {
         IRClipboard() noexcept;
+        ~IRClipboard() noexcept;
 
         REACT_SYNC_METHOD(getString)
         std::string getString() noexcept;
 
         REACT_METHOD(setString)
         void setString(std::string text) noexcept;
+
+    private:
+        // Created on the first large copy; owns the clipboard while a delayed copy is pending
+        std::unique_ptr<DelayedClipboardRenderer> m_delayedRenderer;
     };
-}
\ No newline at end of file
+}
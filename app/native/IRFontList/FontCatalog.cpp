@@ -0,0 +1,508 @@
+//
+//  FontCatalog.cpp
+//  Reactotron
+//
+
+#include "FontCatalog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#if defined(__APPLE__)
+#include <CoreText/CoreText.h>
+#elif defined(_WIN32)
+#include "../TextTranscoding/TextTranscoding.h"
+#include <dwrite_1.h>
+#include <wrl/client.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "dwrite.lib")
+#endif
+#else
+#include <fontconfig/fontconfig.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char kCacheMagic[4] = {'I', 'R', 'F', 'C'};
+constexpr uint32_t kMaxCachedFamilies = 1 << 20;
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+inline char ToLower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+std::string Lower(std::string_view text) {
+  std::string lower(text);
+  for (char &c : lower) c = ToLower(c);
+  return lower;
+}
+
+fs::path PathFromUtf8(const std::string &path) { return fs::path(std::u8string(path.begin(), path.end())); }
+
+/** The bit for a CSS/OpenType weight, rounded to the nearest hundred. */
+uint16_t WeightBit(int weight) noexcept {
+  int hundreds = std::clamp((weight + 50) / 100, 1, 9);
+  return static_cast<uint16_t>(1u << (hundreds - 1));
+}
+
+/** Folds faces into families, sorted by name ignoring case. */
+std::vector<FontFamily> MergeFaces(std::vector<FontFamily> faces) {
+  std::vector<std::pair<std::string, FontFamily>> keyed;
+  keyed.reserve(faces.size());
+  for (FontFamily &face : faces) {
+    if (face.name.empty()) continue;
+    keyed.emplace_back(Lower(face.name), std::move(face));
+  }
+  std::sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) {
+    return a.first != b.first ? a.first < b.first : a.second.name < b.second.name;
+  });
+
+  std::vector<FontFamily> families;
+  for (size_t i = 0; i < keyed.size(); ++i) {
+    FontFamily &face = keyed[i].second;
+    if (i > 0 && keyed[i - 1].first == keyed[i].first) {
+      families.back().monospace |= face.monospace;
+      families.back().weights |= face.weights;
+    } else {
+      families.push_back(std::move(face));
+    }
+  }
+  return families;
+}
+
+std::vector<fs::path> FontDirectories() {
+  std::vector<fs::path> directories;
+  auto fromEnvironment = [&](const char *name, const char *suffix) {
+#if defined(_WIN32)
+    std::wstring wideName(name, name + std::strlen(name));
+    if (const wchar_t *value = _wgetenv(wideName.c_str())) directories.push_back(fs::path(value) / suffix);
+#else
+    if (const char *value = std::getenv(name)) directories.push_back(fs::path(value) / suffix);
+#endif
+  };
+#if defined(__APPLE__)
+  directories.emplace_back("/System/Library/Fonts");
+  directories.emplace_back("/Library/Fonts");
+  fromEnvironment("HOME", "Library/Fonts");
+#elif defined(_WIN32)
+  fromEnvironment("WINDIR", "Fonts");
+  fromEnvironment("LOCALAPPDATA", "Microsoft\\Windows\\Fonts");
+#else
+  directories.emplace_back("/usr/share/fonts");
+  directories.emplace_back("/usr/local/share/fonts");
+  fromEnvironment("HOME", ".local/share/fonts");
+  fromEnvironment("HOME", ".fonts");
+#endif
+  return directories;
+}
+
+struct Fnv1a {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+
+  void Add(const void *data, size_t size) noexcept {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+  }
+};
+
+void AddDirectory(Fnv1a &signature, const fs::path &directory) {
+  std::error_code error;
+  auto modified = fs::last_write_time(directory, error);
+  int64_t ticks = error ? -1 : static_cast<int64_t>(modified.time_since_epoch().count());
+  const auto &native = directory.native();
+  signature.Add(native.data(), native.size() * sizeof(native[0]));
+  signature.Add(&ticks, sizeof(ticks));
+}
+
+#if defined(__APPLE__)
+
+std::string Utf8(CFStringRef string) {
+  CFIndex size = CFStringGetMaximumSizeForEncoding(CFStringGetLength(string), kCFStringEncodingUTF8) + 1;
+  std::string out(static_cast<size_t>(size), '\0');
+  if (!CFStringGetCString(string, out.data(), size, kCFStringEncodingUTF8)) return {};
+  out.resize(std::strlen(out.c_str()));
+  return out;
+}
+
+/** CoreText weights run from -1 to 1; these are where NSFontWeightUltraLight...Black fall. */
+int CssWeight(double weight) noexcept {
+  static constexpr double kWeights[] = {-0.8, -0.6, -0.4, 0, 0.23, 0.3, 0.4, 0.56, 0.62};
+  size_t nearest = 0;
+  for (size_t i = 1; i < std::size(kWeights); ++i) {
+    if (std::abs(kWeights[i] - weight) < std::abs(kWeights[nearest] - weight)) nearest = i;
+  }
+  return static_cast<int>(nearest + 1) * 100;
+}
+
+std::vector<FontFamily> EnumerateFaces() {
+  std::vector<FontFamily> faces;
+  CTFontCollectionRef collection = CTFontCollectionCreateFromAvailableFonts(nullptr);
+  if (!collection) return faces;
+  CFArrayRef descriptors = CTFontCollectionCreateMatchingFontDescriptors(collection);
+  CFRelease(collection);
+  if (!descriptors) return faces;
+
+  CFIndex count = CFArrayGetCount(descriptors);
+  faces.reserve(static_cast<size_t>(count));
+  for (CFIndex i = 0; i < count; ++i) {
+    auto descriptor = static_cast<CTFontDescriptorRef>(CFArrayGetValueAtIndex(descriptors, i));
+    auto name = static_cast<CFStringRef>(CTFontDescriptorCopyAttribute(descriptor, kCTFontFamilyNameAttribute));
+    if (!name) continue;
+    FontFamily face;
+    face.name = Utf8(name);
+    CFRelease(name);
+    // System UI families are hidden behind a leading dot, as availableFontFamilies hides them
+    if (face.name.empty() || face.name[0] == '.') continue;
+
+    auto traits = static_cast<CFDictionaryRef>(CTFontDescriptorCopyAttribute(descriptor, kCTFontTraitsAttribute));
+    double weight = 0;
+    if (traits) {
+      uint32_t symbolic = 0;
+      if (auto value = static_cast<CFNumberRef>(CFDictionaryGetValue(traits, kCTFontSymbolicTrait))) {
+        CFNumberGetValue(value, kCFNumberSInt32Type, &symbolic);
+      }
+      if (auto value = static_cast<CFNumberRef>(CFDictionaryGetValue(traits, kCTFontWeightTrait))) {
+        CFNumberGetValue(value, kCFNumberDoubleType, &weight);
+      }
+      face.monospace = symbolic & kCTFontTraitMonoSpace;
+      CFRelease(traits);
+    }
+    face.weights = WeightBit(CssWeight(weight));
+    faces.push_back(std::move(face));
+  }
+  CFRelease(descriptors);
+  return faces;
+}
+
+#elif defined(_WIN32)
+
+std::vector<FontFamily> EnumerateFaces() {
+  using Microsoft::WRL::ComPtr;
+  std::vector<FontFamily> faces;
+  ComPtr<IDWriteFactory> factory;
+  if (FAILED(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory),
+                                 reinterpret_cast<IUnknown **>(factory.GetAddressOf())))) {
+    return faces;
+  }
+  ComPtr<IDWriteFontCollection> collection;
+  if (FAILED(factory->GetSystemFontCollection(&collection, FALSE))) return faces;
+
+  UINT32 count = collection->GetFontFamilyCount();
+  faces.reserve(count);
+  for (UINT32 i = 0; i < count; ++i) {
+    ComPtr<IDWriteFontFamily> family;
+    ComPtr<IDWriteLocalizedStrings> names;
+    if (FAILED(collection->GetFontFamily(i, &family)) || FAILED(family->GetFamilyNames(&names))) continue;
+    UINT32 index = 0;
+    BOOL exists = FALSE;
+    if (FAILED(names->FindLocaleName(L"en-us", &index, &exists)) || !exists) index = 0;
+    UINT32 length = 0;
+    if (FAILED(names->GetStringLength(index, &length))) continue;
+    std::u16string name(length + 1, u'\0');
+    if (FAILED(names->GetString(index, reinterpret_cast<wchar_t *>(name.data()), length + 1))) continue;
+    name.resize(length);
+
+    FontFamily face;
+    face.name = Utf16ToUtf8(name);
+    for (UINT32 j = 0, fonts = family->GetFontCount(); j < fonts; ++j) {
+      ComPtr<IDWriteFont> font;
+      if (FAILED(family->GetFont(j, &font))) continue;
+      // Bold or oblique made up from another face isn't a weight the family has
+      if (font->GetSimulations() != DWRITE_FONT_SIMULATIONS_NONE) continue;
+      face.weights |= WeightBit(static_cast<int>(font->GetWeight()));
+      ComPtr<IDWriteFont1> font1;
+      if (SUCCEEDED(font.As(&font1)) && font1->IsMonospacedFont()) face.monospace = true;
+    }
+    faces.push_back(std::move(face));
+  }
+  return faces;
+}
+
+#else
+
+std::vector<FontFamily> EnumerateFaces() {
+  std::vector<FontFamily> faces;
+  FcConfig *config = FcInitLoadConfigAndFonts();
+  if (!config) return faces;
+  FcPattern *pattern = FcPatternCreate();
+  FcObjectSet *objects = FcObjectSetBuild(FC_FAMILY, FC_SPACING, FC_WEIGHT, nullptr);
+  FcFontSet *fonts = FcFontList(config, pattern, objects);
+  for (int i = 0; fonts && i < fonts->nfont; ++i) {
+    FcPattern *font = fonts->fonts[i];
+    FcChar8 *family = nullptr;
+    // The first family name is the default one; the rest are translations
+    if (FcPatternGetString(font, FC_FAMILY, 0, &family) != FcResultMatch) continue;
+    FontFamily face;
+    face.name = reinterpret_cast<const char *>(family);
+    int spacing = FC_PROPORTIONAL;
+    FcPatternGetInteger(font, FC_SPACING, 0, &spacing);
+    face.monospace = spacing == FC_MONO || spacing == FC_CHARCELL;
+    int weight = FC_WEIGHT_REGULAR;
+    FcPatternGetInteger(font, FC_WEIGHT, 0, &weight);
+    face.weights = WeightBit(FcWeightToOpenType(weight));
+    faces.push_back(std::move(face));
+  }
+  if (fonts) FcFontSetDestroy(fonts);
+  FcObjectSetDestroy(objects);
+  FcPatternDestroy(pattern);
+  FcConfigDestroy(config);
+  return faces;
+}
+
+#endif
+
+constexpr int kNoMatch = INT_MIN;
+
+/**
+ * How well `name` matches `query` as a subsequence, higher is better; may be
+ * negative for a scattered match. kNoMatch if it doesn't.
+ */
+int FuzzyScore(std::string_view name, std::string_view query) noexcept {
+  int score = 0;
+  size_t at = 0;
+  size_t previous = std::string_view::npos;
+  for (char c : query) {
+    size_t found = name.find(c, at);
+    if (found == std::string_view::npos) return kNoMatch;
+    bool wordStart = found == 0 || name[found - 1] == ' ' || name[found - 1] == '-' || name[found - 1] == '_';
+    score += 1;
+    if (previous != std::string_view::npos && found == previous + 1) score += 4;
+    if (wordStart) score += 3;
+    score -= static_cast<int>(std::min<size_t>(found - at, 8)); // Skipped characters
+    previous = found;
+    at = found + 1;
+  }
+  return score;
+}
+
+bool HasWordStartingWith(std::string_view name, std::string_view prefix) noexcept {
+  for (size_t i = 1; i + prefix.size() <= name.size(); ++i) {
+    char before = name[i - 1];
+    if ((before == ' ' || before == '-' || before == '_') && name.compare(i, prefix.size(), prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+FontCatalog &FontCatalog::Shared() {
+  static FontCatalog *shared = new FontCatalog(); // Never destroyed, so loading can outlive static teardown
+  return *shared;
+}
+
+FontCatalog::~FontCatalog() {
+  if (m_thread.joinable()) m_thread.join();
+}
+
+void FontCatalog::Start(std::string cachePath) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_started) return;
+  m_started = true;
+  m_startedAt = NowMicros();
+  m_thread = std::thread(&FontCatalog::Load, this, std::move(cachePath));
+}
+
+bool FontCatalog::Ready() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_ready;
+}
+
+void FontCatalog::WhenReady(std::function<void()> callback) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_ready) {
+      m_waiting.push_back(std::move(callback));
+      return;
+    }
+  }
+  callback();
+}
+
+std::vector<FontFamily> FontCatalog::Families() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_families;
+}
+
+std::vector<FontFamily> FontCatalog::Search(std::string_view query, size_t limit, bool monospaceOnly) const {
+  std::string needle = Lower(query);
+  while (!needle.empty() && needle.front() == ' ') needle.erase(needle.begin());
+  while (!needle.empty() && needle.back() == ' ') needle.pop_back();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<FontFamily> matches;
+  if (limit == 0) return matches;
+
+  // Prefix matches are a contiguous run of the sorted names, found without a scan
+  auto first = std::lower_bound(m_lowerNames.begin(), m_lowerNames.end(), needle);
+  std::vector<bool> taken;
+  for (auto it = first; it != m_lowerNames.end() && it->compare(0, needle.size(), needle) == 0; ++it) {
+    size_t index = static_cast<size_t>(it - m_lowerNames.begin());
+    if (monospaceOnly && !m_families[index].monospace) continue;
+    matches.push_back(m_families[index]);
+    if (matches.size() == limit) return matches;
+    if (taken.empty()) taken.resize(m_families.size());
+    taken[index] = true;
+  }
+
+  struct Ranked {
+    int tier;
+    int score;
+    size_t index;
+  };
+  std::vector<Ranked> ranked;
+  for (size_t i = 0; i < m_families.size(); ++i) {
+    if ((!taken.empty() && taken[i]) || (monospaceOnly && !m_families[i].monospace)) continue;
+    const std::string &name = m_lowerNames[i];
+    if (HasWordStartingWith(name, needle)) {
+      ranked.push_back({0, 0, i});
+    } else if (int score = FuzzyScore(name, needle); score != kNoMatch) {
+      ranked.push_back({1, score, i});
+    }
+  }
+  size_t wanted = std::min(ranked.size(), limit - matches.size());
+  // Names are sorted already, so the index breaks ties alphabetically
+  std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(wanted), ranked.end(),
+                    [](const Ranked &a, const Ranked &b) {
+                      if (a.tier != b.tier) return a.tier < b.tier;
+                      if (a.score != b.score) return a.score > b.score;
+                      return a.index < b.index;
+                    });
+  for (size_t i = 0; i < wanted; ++i) matches.push_back(m_families[ranked[i].index]);
+  return matches;
+}
+
+FontCatalogStats FontCatalog::Stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+std::vector<FontFamily> FontCatalog::Enumerate() { return MergeFaces(EnumerateFaces()); }
+
+uint64_t FontCatalog::FontDirectorySignature() {
+  Fnv1a signature;
+  for (const fs::path &root : FontDirectories()) {
+    AddDirectory(signature, root);
+    std::error_code error;
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, error);
+    for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+      if (it->is_directory(error)) AddDirectory(signature, it->path());
+    }
+  }
+  return signature.hash;
+}
+
+void FontCatalog::Load(std::string cachePath) {
+  uint64_t signature = FontDirectorySignature();
+  std::vector<FontFamily> families;
+  if (!cachePath.empty() && ReadCache(cachePath, signature, families)) {
+    Publish(std::move(families), true);
+    return;
+  }
+  families = Enumerate();
+  Publish(families, false);
+  if (!cachePath.empty()) WriteCache(cachePath, signature, families);
+}
+
+void FontCatalog::Publish(std::vector<FontFamily> families, bool fromCache) {
+  std::vector<std::string> lowerNames;
+  lowerNames.reserve(families.size());
+  for (const FontFamily &family : families) lowerNames.push_back(Lower(family.name));
+
+  std::vector<std::function<void()>> waiting;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_families = std::move(families);
+    m_lowerNames = std::move(lowerNames);
+    m_ready = true;
+    m_stats.families = m_families.size();
+    m_stats.fromCache = fromCache;
+    m_stats.loadMs = static_cast<double>(NowMicros() - m_startedAt) / 1000.0;
+    waiting.swap(m_waiting);
+  }
+  for (auto &callback : waiting) callback();
+}
+
+bool FontCatalog::ReadCache(const std::string &path, uint64_t signature, std::vector<FontFamily> &families) {
+  std::ifstream file(PathFromUtf8(path), std::ios::binary);
+  if (!file) return false;
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  size_t offset = 0;
+  auto read = [&](void *out, size_t size) {
+    if (data.size() - offset < size) return false;
+    std::memcpy(out, data.data() + offset, size);
+    offset += size;
+    return true;
+  };
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t cachedSignature = 0;
+  uint32_t count = 0;
+  if (!read(magic, sizeof(magic)) || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0) return false;
+  if (!read(&version, sizeof(version)) || version != kCacheVersion) return false;
+  if (!read(&cachedSignature, sizeof(cachedSignature)) || cachedSignature != signature) return false;
+  if (!read(&count, sizeof(count)) || count > kMaxCachedFamilies) return false;
+
+  std::vector<FontFamily> cached(count);
+  for (FontFamily &family : cached) {
+    uint16_t length = 0;
+    uint8_t monospace = 0;
+    if (!read(&length, sizeof(length)) || !read(&monospace, sizeof(monospace)) ||
+        !read(&family.weights, sizeof(family.weights)) || data.size() - offset < length) {
+      return false;
+    }
+    family.monospace = monospace != 0;
+    family.name.assign(data, offset, length);
+    offset += length;
+  }
+  if (offset != data.size()) return false;
+  families = std::move(cached);
+  return true;
+}
+
+void FontCatalog::WriteCache(const std::string &path, uint64_t signature, const std::vector<FontFamily> &families) {
+  std::string data(kCacheMagic, sizeof(kCacheMagic));
+  auto write = [&](const void *in, size_t size) { data.append(static_cast<const char *>(in), size); };
+  uint32_t version = kCacheVersion;
+  auto count = static_cast<uint32_t>(families.size());
+  write(&version, sizeof(version));
+  write(&signature, sizeof(signature));
+  write(&count, sizeof(count));
+  for (const FontFamily &family : families) {
+    auto length = static_cast<uint16_t>(std::min<size_t>(family.name.size(), UINT16_MAX));
+    uint8_t monospace = family.monospace ? 1 : 0;
+    write(&length, sizeof(length));
+    write(&monospace, sizeof(monospace));
+    write(&family.weights, sizeof(family.weights));
+    write(family.name.data(), length);
+  }
+
+  // Written aside and renamed over, so a crash midway can't leave a torn cache
+  fs::path target = PathFromUtf8(path);
+  fs::path temporary = target;
+  temporary += ".tmp";
+  std::error_code error;
+  fs::create_directories(target.parent_path(), error);
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(data.data(), static_cast<std::streamsize>(data.size()))) return;
+  }
+  fs::rename(temporary, target, error);
+}
+
+} // namespace reactotron
@@ -0,0 +1,102 @@
+#pragma once
+
+//
+//  FontCatalog.h
+//  Reactotron
+//
+//  The installed font families, enumerated once on a background thread and
+//  kept in an on-disk cache so later launches skip the enumeration. The
+//  cache records a signature of the font directories (their paths and
+//  modification times); installing or removing a font changes it, and the
+//  next launch enumerates again. Lookups by prefix or fuzzy match run on the
+//  loaded list without touching the system's font APIs.
+//
+//  Enumeration uses CoreText on macOS, DirectWrite on Windows and
+//  fontconfig on Linux.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace reactotron {
+
+struct FontFamily {
+  std::string name;
+  bool monospace = false; // Any of its faces is
+  uint16_t weights = 0;   // Bit n set if a face has weight (n + 1) * 100
+};
+
+struct FontCatalogStats {
+  size_t families = 0;
+  bool fromCache = false;
+  double loadMs = 0; // From Start() until the families were ready
+};
+
+/**
+ * The catalog. Start() once; everything else may be called from any thread
+ * and returns nothing useful until it's loaded.
+ */
+class FontCatalog {
+ public:
+  static constexpr uint32_t kCacheVersion = 1;
+
+  static FontCatalog &Shared();
+
+  FontCatalog() = default;
+  ~FontCatalog();
+  FontCatalog(const FontCatalog &) = delete;
+  FontCatalog &operator=(const FontCatalog &) = delete;
+
+  /**
+   * Starts loading from the cache at `cachePath` (UTF-8), or by enumerating
+   * if it's missing or stale, in which case the cache is rewritten. Later
+   * calls do nothing.
+   */
+  void Start(std::string cachePath);
+
+  bool Ready() const;
+  /** Runs `callback` once the catalog is loaded: right away if it is, otherwise on the loading thread. */
+  void WhenReady(std::function<void()> callback);
+
+  /** Every family, sorted by name ignoring case. */
+  std::vector<FontFamily> Families() const;
+  /**
+   * Up to `limit` families matching `query`, best first: names starting
+   * with it, then names with a word starting with it, then names containing
+   * its characters in order. Case is ignored. An empty query matches all.
+   */
+  std::vector<FontFamily> Search(std::string_view query, size_t limit, bool monospaceOnly) const;
+
+  FontCatalogStats Stats() const;
+
+  /** Asks the system for its font families, the slow part the cache avoids. */
+  static std::vector<FontFamily> Enumerate();
+  /** Changes whenever a font directory, or one below it, gains or loses a file. */
+  static uint64_t FontDirectorySignature();
+
+ private:
+  void Load(std::string cachePath);
+  void Publish(std::vector<FontFamily> families, bool fromCache);
+
+  static bool ReadCache(const std::string &path, uint64_t signature, std::vector<FontFamily> &families);
+  static void WriteCache(const std::string &path, uint64_t signature, const std::vector<FontFamily> &families);
+
+  std::thread m_thread;
+  int64_t m_startedAt = 0; // Steady clock, microseconds
+
+  mutable std::mutex m_mutex;
+  bool m_started = false;
+  bool m_ready = false;
+  std::vector<FontFamily> m_families;
+  std::vector<std::string> m_lowerNames; // Parallel to m_families, for searching
+  std::vector<std::function<void()>> m_waiting;
+  FontCatalogStats m_stats;
+};
+
+} // namespace reactotron
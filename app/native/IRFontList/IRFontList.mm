@@ -4,24 +4,81 @@
 //
 //  Created by Jamon Holmgren on 4/9/25.
 //
+//  Font families come from the shared FontCatalog, which enumerates them on a
+//  background thread (or reads its cache), so none of these block on CoreText.
+//
 #import <Cocoa/Cocoa.h>
 #import "IRFontList.h"
+#include "FontCatalog.h"
+#include <string>
+#include <vector>
 
 @implementation IRFontList RCT_EXPORT_MODULE()
 
-// Add your methods here *******************************************************
+static std::string IRFontListCachePath() {
+  NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+  if (!caches) return std::string();
+  NSString *bundleId = [NSBundle mainBundle].bundleIdentifier ?: @"com.reactotron";
+  NSURL *url = [[caches URLByAppendingPathComponent:bundleId] URLByAppendingPathComponent:@"FontCatalog.bin"];
+  const char *path = url.fileSystemRepresentation;
+  return path ? std::string(path) : std::string();
+}
+
+static void IRFontListStart() {
+  reactotron::FontCatalog::Shared().Start(IRFontListCachePath());
+}
 
-// Sync example (very fast)
+static NSArray<NSString *> *IRFontListNames(const std::vector<reactotron::FontFamily> &families) {
+  NSMutableArray<NSString *> *names = [NSMutableArray arrayWithCapacity:families.size()];
+  for (const auto &family : families) {
+    NSString *name = [NSString stringWithUTF8String:family.name.c_str()];
+    if (name) [names addObject:name];
+  }
+  return names;
+}
+
+static NSArray<NSDictionary *> *IRFontListFamilies(const std::vector<reactotron::FontFamily> &families) {
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:families.size()];
+  for (const auto &family : families) {
+    NSString *name = [NSString stringWithUTF8String:family.name.c_str()];
+    if (!name) continue;
+    NSMutableArray<NSNumber *> *weights = [NSMutableArray array];
+    for (int bit = 0; bit < 9; ++bit) {
+      if (family.weights & (1u << bit)) [weights addObject:@((bit + 1) * 100)];
+    }
+    [result addObject:@{@"name" : name, @"monospace" : @(family.monospace), @"weights" : weights}];
+  }
+  return result;
+}
+
+- (void)startCatalog {
+  IRFontListStart();
+}
+
+// Whatever's loaded so far: empty until the catalog is ready
 - (NSArray<NSString *> *)getFontListSync {
-  return [[NSFontManager sharedFontManager] availableFontFamilies];
+  IRFontListStart();
+  return IRFontListNames(reactotron::FontCatalog::Shared().Families());
 }
 
-// Async example (slower)
 - (void)getFontList:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
-  resolve([[NSFontManager sharedFontManager] availableFontFamilies]);
+  IRFontListStart();
+  reactotron::FontCatalog::Shared().WhenReady(
+      [resolve]() { resolve(IRFontListNames(reactotron::FontCatalog::Shared().Families())); });
 }
 
-// End ************************************************************************
+- (void)getFontFamilies:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  IRFontListStart();
+  reactotron::FontCatalog::Shared().WhenReady(
+      [resolve]() { resolve(IRFontListFamilies(reactotron::FontCatalog::Shared().Families())); });
+}
+
+- (NSArray<NSDictionary *> *)searchFonts:(NSString *)query limit:(double)limit monospaceOnly:(BOOL)monospaceOnly {
+  IRFontListStart();
+  const char *utf8 = query.UTF8String;
+  size_t count = limit > 0 ? static_cast<size_t>(limit) : 0;
+  return IRFontListFamilies(reactotron::FontCatalog::Shared().Search(utf8 ? utf8 : "", count, monospaceOnly));
+}
 
 // Required by TurboModules.
 - (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
@@ -2,41 +2,95 @@
 //  IRFontList.cpp
 //  Reactotron-Windows
 //
-//  Windows TurboModule implementation of font list functionality
+//  Windows TurboModule wrapper around the shared FontCatalog, which enumerates
+//  fonts through DirectWrite on a background thread and caches the result
 //
 
 #include "pch.h"
 #include "IRFontList.windows.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include <cstdlib>
+#include <vector>
 
 namespace winrt::reactotron::implementation
 {
+    namespace
+    {
+        void StartCatalog()
+        {
+            std::string cachePath;
+            if (const wchar_t *localAppData = _wgetenv(L"LOCALAPPDATA"))
+            {
+                std::wstring path = std::wstring(localAppData) + L"\\Reactotron\\FontCatalog.bin";
+                cachePath = ::reactotron::Utf16ToUtf8(std::u16string(reinterpret_cast<const char16_t *>(path.c_str()), path.size()));
+            }
+            ::reactotron::FontCatalog::Shared().Start(std::move(cachePath));
+        }
+
+        Microsoft::ReactNative::JSValue Names(std::vector<::reactotron::FontFamily> const &families)
+        {
+            Microsoft::ReactNative::JSValueArray names;
+            for (auto const &family : families) names.push_back(family.name);
+            return Microsoft::ReactNative::JSValue(std::move(names));
+        }
+
+        Microsoft::ReactNative::JSValue Families(std::vector<::reactotron::FontFamily> const &families)
+        {
+            Microsoft::ReactNative::JSValueArray result;
+            for (auto const &family : families)
+            {
+                Microsoft::ReactNative::JSValueArray weights;
+                for (int bit = 0; bit < 9; ++bit)
+                {
+                    if (family.weights & (1u << bit)) weights.push_back(static_cast<double>((bit + 1) * 100));
+                }
+                Microsoft::ReactNative::JSValueObject entry;
+                entry["name"] = family.name;
+                entry["monospace"] = family.monospace;
+                entry["weights"] = std::move(weights);
+                result.push_back(std::move(entry));
+            }
+            return Microsoft::ReactNative::JSValue(std::move(result));
+        }
+    }
+
     IRFontList::IRFontList() noexcept
     {
         // TurboModule initialization
     }
 
+    void IRFontList::startCatalog() noexcept
+    {
+        StartCatalog();
+    }
+
     void IRFontList::getFontList(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
     {
-        // TODO: Implement font list retrieval for Windows
-        // Enumerate system fonts using EnumFontFamiliesEx or similar
-        Microsoft::ReactNative::JSValueArray fontList;
-        // Add stub fonts for now
-        fontList.push_back("Segoe UI");
-        fontList.push_back("Consolas");
-        fontList.push_back("Arial");
-
-        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(fontList)));
+        StartCatalog();
+        ::reactotron::FontCatalog::Shared().WhenReady([promise]() {
+            promise.Resolve(Names(::reactotron::FontCatalog::Shared().Families()));
+        });
     }
 
     Microsoft::ReactNative::JSValue IRFontList::getFontListSync() noexcept
     {
-        // TODO: Implement synchronous font list retrieval for Windows
-        Microsoft::ReactNative::JSValueArray fontList;
-        // Add stub fonts for now
-        fontList.push_back("Segoe UI");
-        fontList.push_back("Consolas");
-        fontList.push_back("Arial");
-
-        return Microsoft::ReactNative::JSValue(std::move(fontList));
+        // Whatever's loaded so far: empty until the catalog is ready
+        StartCatalog();
+        return Names(::reactotron::FontCatalog::Shared().Families());
+    }
+
+    void IRFontList::getFontFamilies(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        StartCatalog();
+        ::reactotron::FontCatalog::Shared().WhenReady([promise]() {
+            promise.Resolve(Families(::reactotron::FontCatalog::Shared().Families()));
+        });
+    }
+
+    Microsoft::ReactNative::JSValue IRFontList::searchFonts(std::string query, double limit, bool monospaceOnly) noexcept
+    {
+        StartCatalog();
+        size_t count = limit > 0 ? static_cast<size_t>(limit) : 0;
+        return Families(::reactotron::FontCatalog::Shared().Search(query, count, monospaceOnly));
     }
-}
\ No newline at end of file
+}
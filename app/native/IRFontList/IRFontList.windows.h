@@ -1,5 +1,6 @@
 #pragma once
 #include "NativeModules.h"
+#include "FontCatalog.h"
 
 namespace winrt::reactotron::implementation
 {
@@ -8,10 +9,19 @@ namespace winrt::reactotron::implementation
     {
         IRFontList() noexcept;
 
+        REACT_METHOD(startCatalog)
+        void startCatalog() noexcept;
+
         REACT_METHOD(getFontList)
         void getFontList(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const& promise) noexcept;
 
         REACT_SYNC_METHOD(getFontListSync)
         Microsoft::ReactNative::JSValue getFontListSync() noexcept;
+
+        REACT_METHOD(getFontFamilies)
+        void getFontFamilies(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const& promise) noexcept;
+
+        REACT_SYNC_METHOD(searchFonts)
+        Microsoft::ReactNative::JSValue searchFonts(std::string query, double limit, bool monospaceOnly) noexcept;
     };
-}
\ No newline at end of file
+}
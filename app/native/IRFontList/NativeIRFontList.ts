@@ -1,9 +1,22 @@
 import type { TurboModule } from "react-native"
 import { TurboModuleRegistry } from "react-native"
 
+export interface FontFamily {
+  name: string
+  monospace: boolean
+  // CSS weights the family has faces for, e.g. [400, 700]
+  weights: number[]
+}
+
 export interface Spec extends TurboModule {
+  // Starts loading the catalog in the background; the other calls start it too
+  startCatalog(): void
   getFontList(): Promise<string[]>
+  // Empty until the catalog has loaded
   getFontListSync(): string[]
+  getFontFamilies(): Promise<FontFamily[]>
+  // Best matches first; empty until the catalog has loaded
+  searchFonts(query: string, limit: number, monospaceOnly: boolean): FontFamily[]
 }
 
 export default TurboModuleRegistry.getEnforcing<Spec>("IRFontList")
@@ -0,0 +1,80 @@
+//
+//  IRIds.mm
+//  Reactotron-macOS
+//
+//  Time-ordered UUIDs, and lookups of the timeline item handles the relay's
+//  ingest pipeline numbers in SharedItemHandles.
+//
+
+#import "IRIds.h"
+#include "Uuid7.h"
+#include "ItemHandles.h"
+#include <mutex>
+#include <string>
+
+@implementation IRIds {
+  reactotron::Uuid7Generator _uuids;
+  std::mutex _uuidMutex;
+}
+
+RCT_EXPORT_MODULE()
+
+// Most UUIDs one getUUIDs call makes
+static const NSUInteger kMaxUUIDBatch = 4096;
+
+static std::string IRIdsString(NSString *string) {
+  const char *utf8 = string.UTF8String;
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+static uint64_t IRIdsMessageId(double messageId) {
+  return messageId > 0 ? static_cast<uint64_t>(messageId) : 0;
+}
+
+- (NSArray<NSString *> *)getUUIDs:(double)count {
+  NSUInteger total = count > 0 ? MIN(static_cast<NSUInteger>(count), kMaxUUIDBatch) : 0;
+  std::string text;
+  {
+    std::lock_guard<std::mutex> lock(_uuidMutex);
+    _uuids.Append(text, total);
+  }
+  NSMutableArray<NSString *> *result = [NSMutableArray arrayWithCapacity:total];
+  for (NSUInteger i = 0; i < total; ++i) {
+    [result addObject:[[NSString alloc] initWithBytes:text.data() + i * reactotron::Uuid7Generator::kStringLength
+                                               length:reactotron::Uuid7Generator::kStringLength
+                                             encoding:NSASCIIStringEncoding]];
+  }
+  return result;
+}
+
+- (NSNumber *)findItem:(NSString *)clientId messageId:(double)messageId {
+  std::string client = IRIdsString(clientId);
+  auto &shared = reactotron::SharedItemHandles::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  return @(shared.table.Find(client, IRIdsMessageId(messageId)));
+}
+
+- (NSDictionary *)getItemKey:(double)handle {
+  std::string clientId;
+  uint64_t messageId = 0;
+  {
+    auto &shared = reactotron::SharedItemHandles::Get();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (handle < 1 || !shared.table.Key(static_cast<uint64_t>(handle), clientId, messageId)) return nil;
+  }
+  NSString *client = [[NSString alloc] initWithBytes:clientId.data() length:clientId.size() encoding:NSUTF8StringEncoding];
+  return @{ @"clientId": client ?: @"", @"messageId": @(messageId) };
+}
+
+- (NSNumber *)clearItems {
+  auto &shared = reactotron::SharedItemHandles::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  shared.table.Clear();
+  return @1;
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRIdsSpecJSI>(params);
+}
+
+@end
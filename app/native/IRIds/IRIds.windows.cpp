@@ -0,0 +1,70 @@
+//
+//  IRIds.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared UUID generator and item handles
+//
+
+#include "pch.h"
+#include "IRIds.windows.h"
+
+namespace winrt::reactotron::implementation
+{
+    // Most UUIDs one getUUIDs call makes
+    static constexpr size_t kMaxUUIDBatch = 4096;
+
+    static uint64_t MessageId(double messageId) noexcept
+    {
+        return messageId > 0 ? static_cast<uint64_t>(messageId) : 0;
+    }
+
+    Microsoft::ReactNative::JSValue IRIds::getUUIDs(double count) noexcept
+    {
+        size_t total = count > 0 ? (std::min)(static_cast<size_t>(count), kMaxUUIDBatch) : 0;
+        std::string text;
+        {
+            std::lock_guard<std::mutex> lock(m_uuidMutex);
+            m_uuids.Append(text, total);
+        }
+        Microsoft::ReactNative::JSValueArray result;
+        for (size_t i = 0; i < total; ++i)
+        {
+            constexpr size_t length = ::reactotron::Uuid7Generator::kStringLength;
+            result.push_back(text.substr(i * length, length));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    double IRIds::findItem(std::string clientId, double messageId) noexcept
+    {
+        auto &shared = ::reactotron::SharedItemHandles::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        return static_cast<double>(shared.table.Find(clientId, MessageId(messageId)));
+    }
+
+    Microsoft::ReactNative::JSValue IRIds::getItemKey(double handle) noexcept
+    {
+        std::string clientId;
+        uint64_t messageId = 0;
+        {
+            auto &shared = ::reactotron::SharedItemHandles::Get();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (handle < 1 || !shared.table.Key(static_cast<uint64_t>(handle), clientId, messageId))
+            {
+                return nullptr;
+            }
+        }
+        Microsoft::ReactNative::JSValueObject key;
+        key["clientId"] = std::move(clientId);
+        key["messageId"] = static_cast<double>(messageId);
+        return Microsoft::ReactNative::JSValue(std::move(key));
+    }
+
+    double IRIds::clearItems() noexcept
+    {
+        auto &shared = ::reactotron::SharedItemHandles::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.table.Clear();
+        return 1;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "NativeModules.h"
+#include "Uuid7.h"
+#include "ItemHandles.h"
+#include <algorithm>
+#include <mutex>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRIds)
+    struct IRIds
+    {
+        IRIds() noexcept = default;
+
+        REACT_SYNC_METHOD(getUUIDs)
+        Microsoft::ReactNative::JSValue getUUIDs(double count) noexcept;
+
+        REACT_SYNC_METHOD(findItem)
+        double findItem(std::string clientId, double messageId) noexcept;
+
+        REACT_SYNC_METHOD(getItemKey)
+        Microsoft::ReactNative::JSValue getItemKey(double handle) noexcept;
+
+        REACT_SYNC_METHOD(clearItems)
+        double clearItems() noexcept;
+
+    private:
+        ::reactotron::Uuid7Generator m_uuids;
+        std::mutex m_uuidMutex;
+    };
+}
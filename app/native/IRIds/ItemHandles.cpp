@@ -0,0 +1,108 @@
+//
+//  ItemHandles.cpp
+//  Reactotron
+//
+
+#include "ItemHandles.h"
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kInitialSlots = 1024; // A power of two
+
+} // namespace
+
+uint64_t ItemHandleTable::Hash(uint32_t client, uint64_t message) noexcept {
+  // splitmix64's finalizer; message IDs count up, so their low bits alone would cluster
+  uint64_t x = message ^ (static_cast<uint64_t>(client) * 0x9E3779B97F4A7C15ull);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+size_t ItemHandleTable::Probe(uint32_t client, uint64_t message) const noexcept {
+  size_t mask = m_slots.size() - 1;
+  for (size_t slot = Hash(client, message) & mask;; slot = (slot + 1) & mask) {
+    uint32_t index = m_slots[slot];
+    if (index == 0) return slot;
+    const ItemKey &key = m_keys[index - 1];
+    if (key.message == message && key.client == client) return slot;
+  }
+}
+
+void ItemHandleTable::Grow() {
+  std::vector<uint32_t> slots(m_slots.empty() ? kInitialSlots : m_slots.size() * 2, 0);
+  m_slots.swap(slots);
+  size_t mask = m_slots.size() - 1;
+  for (uint32_t index = 1; index <= m_keys.size(); ++index) {
+    const ItemKey &key = m_keys[index - 1];
+    size_t slot = Hash(key.client, key.message) & mask;
+    while (m_slots[slot] != 0) slot = (slot + 1) & mask;
+    m_slots[slot] = index;
+  }
+}
+
+uint32_t ItemHandleTable::FindClient(std::string_view clientId) const {
+  if (m_lastClient < m_clients.size() && m_clients[m_lastClient] == clientId) return m_lastClient;
+  auto client = m_clientIndex.find(std::string(clientId));
+  if (client == m_clientIndex.end()) return UINT32_MAX;
+  m_lastClient = client->second;
+  return m_lastClient;
+}
+
+uint64_t ItemHandleTable::Intern(std::string_view clientId, uint64_t messageId) {
+  uint32_t clientIndex = FindClient(clientId);
+  if (clientIndex == UINT32_MAX) {
+    clientIndex = static_cast<uint32_t>(m_clients.size());
+    m_clients.emplace_back(clientId);
+    m_clientIndex.emplace(m_clients.back(), clientIndex);
+    m_lastClient = clientIndex;
+  }
+
+  // Kept at most half full
+  if ((m_keys.size() + 1) * 2 > m_slots.size()) Grow();
+  size_t slot = Probe(clientIndex, messageId);
+  if (m_slots[slot] == 0) {
+    m_keys.push_back({clientIndex, messageId});
+    m_slots[slot] = static_cast<uint32_t>(m_keys.size());
+  }
+  return m_cleared + m_slots[slot];
+}
+
+uint64_t ItemHandleTable::Find(std::string_view clientId, uint64_t messageId) const {
+  if (m_slots.empty()) return 0;
+  uint32_t clientIndex = FindClient(clientId);
+  uint32_t index = clientIndex == UINT32_MAX ? 0 : m_slots[Probe(clientIndex, messageId)];
+  return index ? m_cleared + index : 0;
+}
+
+bool ItemHandleTable::Key(uint64_t handle, std::string &clientId, uint64_t &messageId) const {
+  if (handle <= m_cleared || handle - m_cleared > m_keys.size()) return false;
+  const ItemKey &key = m_keys[handle - m_cleared - 1];
+  clientId = m_clients[key.client];
+  messageId = key.message;
+  return true;
+}
+
+void ItemHandleTable::Clear() {
+  m_cleared += m_keys.size();
+  m_clientIndex.clear();
+  m_clients.clear();
+  m_lastClient = UINT32_MAX;
+  m_keys = {};
+  m_slots = {};
+}
+
+size_t ItemHandleTable::ByteSize() const noexcept {
+  size_t bytes = sizeof(*this) + m_keys.capacity() * sizeof(ItemKey) + m_slots.capacity() * sizeof(uint32_t);
+  for (const std::string &client : m_clients) bytes += 2 * (sizeof(std::string) + client.capacity()) + sizeof(uint32_t);
+  return bytes;
+}
+
+SharedItemHandles &SharedItemHandles::Get() {
+  static SharedItemHandles *shared = new SharedItemHandles(); // Never destroyed, so ingest workers can outlive static teardown
+  return *shared;
+}
+
+} // namespace reactotron
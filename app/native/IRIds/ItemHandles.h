@@ -0,0 +1,78 @@
+#pragma once
+
+//
+//  ItemHandles.h
+//  Reactotron
+//
+//  Timeline items are identified by the client that sent them and that
+//  client's message ID. Instead of joining the two into a string per item,
+//  the pair is interned once into a dense handle (1, 2, 3... in the order
+//  items arrive) that the timeline, search and detail views all key by.
+//  Client IDs are interned too, so a lookup hashes two integers.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+/**
+ * Handles start at 1; 0 means "none". They stay valid until Clear(), and
+ * aren't reused after it, so a stale handle never finds a newer item.
+ *
+ * Not thread-safe.
+ */
+class ItemHandleTable {
+ public:
+  /** The pair's handle, making one if it's new. */
+  uint64_t Intern(std::string_view clientId, uint64_t messageId);
+  /** The pair's handle, or 0 if it hasn't been interned. */
+  uint64_t Find(std::string_view clientId, uint64_t messageId) const;
+  /** The pair `handle` stands for; false if it doesn't stand for one. */
+  bool Key(uint64_t handle, std::string &clientId, uint64_t &messageId) const;
+
+  size_t Size() const noexcept { return m_keys.size(); }
+  /** Forgets every pair; new handles carry on from the last one. */
+  void Clear();
+  size_t ByteSize() const noexcept;
+
+ private:
+  struct ItemKey {
+    uint32_t client;
+    uint64_t message;
+  };
+
+  /** The client's index, or UINT32_MAX if it hasn't been seen. */
+  uint32_t FindClient(std::string_view clientId) const;
+  static uint64_t Hash(uint32_t client, uint64_t message) noexcept;
+  /** The slot holding the pair, or the empty slot it would go in. */
+  size_t Probe(uint32_t client, uint64_t message) const noexcept;
+  void Grow();
+
+  std::unordered_map<std::string, uint32_t> m_clientIndex;
+  std::vector<std::string> m_clients;
+  // Items arrive in runs from one client, so its index is usually this one
+  mutable uint32_t m_lastClient = UINT32_MAX;
+  uint64_t m_cleared = 0; // Handles given out before the last Clear()
+  std::vector<ItemKey> m_keys; // By handle - m_cleared - 1
+  std::vector<uint32_t> m_slots; // Open addressing: m_keys index + 1, or 0 if empty
+};
+
+/**
+ * The session's handles: the relay's ingest pipeline interns each timeline
+ * item as it's committed, in the order the relay sent them, and clears them
+ * at a "clear" command; IRIds looks them up. Hold `mutex` to use `table`.
+ */
+struct SharedItemHandles {
+  std::mutex mutex;
+  ItemHandleTable table;
+
+  static SharedItemHandles &Get();
+};
+
+} // namespace reactotron
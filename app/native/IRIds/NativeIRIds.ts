@@ -0,0 +1,22 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface ItemKey {
+  clientId: string
+  messageId: number
+}
+
+export interface Spec extends TurboModule {
+  /** `count` time-ordered (version 7) UUIDs, each later than the last. */
+  getUUIDs(count: number): string[]
+  /**
+   * The timeline item's handle, or 0 if it hasn't been numbered. The relay's ingest pipeline
+   * numbers items 1, 2, 3... in the order they arrive; see RelaySocketBatch.itemIds.
+   */
+  findItem(clientId: string, messageId: number): number
+  getItemKey(handle: number): ItemKey | null
+  /** Forgets every handle, for when the timeline is cleared. */
+  clearItems(): number
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRIds")
@@ -0,0 +1,125 @@
+//
+//  Uuid7.cpp
+//  Reactotron
+//
+
+#include "Uuid7.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <bcrypt.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "bcrypt.lib")
+#endif
+#elif defined(__APPLE__)
+#include <stdlib.h>
+#else
+#include <cerrno>
+#include <sys/random.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr uint16_t kMaxCounter = 0x0FFF;
+// A new millisecond's counter starts at random below this, leaving room to count up
+constexpr uint16_t kCounterSeedRange = 0x0800;
+
+} // namespace
+
+bool SecureRandomBytes(void *out, size_t size) noexcept {
+#if defined(_WIN32)
+  return BCRYPT_SUCCESS(BCryptGenRandom(nullptr, static_cast<PUCHAR>(out), static_cast<ULONG>(size),
+                                        BCRYPT_USE_SYSTEM_PREFERRED_RNG));
+#elif defined(__APPLE__)
+  arc4random_buf(out, size);
+  return true;
+#else
+  auto *bytes = static_cast<uint8_t *>(out);
+  while (size > 0) {
+    ssize_t read = getrandom(bytes, size, 0);
+    if (read < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    bytes += read;
+    size -= static_cast<size_t>(read);
+  }
+  return true;
+#endif
+}
+
+void Uuid7Generator::Random(void *out, size_t size) {
+  if (m_entropyUsed + size > kEntropyBatch) {
+    if (!SecureRandomBytes(m_entropy, kEntropyBatch)) {
+      // Never expected; still better than repeating bytes
+      std::random_device device;
+      for (size_t i = 0; i < kEntropyBatch; ++i) m_entropy[i] = static_cast<uint8_t>(device());
+    }
+    m_entropyUsed = 0;
+  }
+  std::memcpy(out, m_entropy + m_entropyUsed, size);
+  m_entropyUsed += size;
+}
+
+void Uuid7Generator::Next(uint8_t out[16]) {
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  Next(out, std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+void Uuid7Generator::Next(uint8_t out[16], int64_t unixMs) {
+  if (unixMs > m_lastMs) {
+    m_lastMs = unixMs;
+    Random(&m_counter, sizeof(m_counter));
+    m_counter %= kCounterSeedRange;
+  } else if (m_counter < kMaxCounter) {
+    m_counter++;
+  } else {
+    // 4096 IDs in one millisecond; borrow the next one
+    m_lastMs++;
+    Random(&m_counter, sizeof(m_counter));
+    m_counter %= kCounterSeedRange;
+  }
+
+  uint64_t ms = static_cast<uint64_t>(m_lastMs);
+  for (int i = 0; i < 6; ++i) out[i] = static_cast<uint8_t>(ms >> (40 - 8 * i));
+  out[6] = static_cast<uint8_t>(0x70 | (m_counter >> 8));
+  out[7] = static_cast<uint8_t>(m_counter);
+  Random(out + 8, 8);
+  out[8] = static_cast<uint8_t>(0x80 | (out[8] & 0x3F));
+}
+
+void Uuid7Generator::Format(const uint8_t bytes[16], char out[kStringLength]) noexcept {
+  static const char kHex[] = "0123456789abcdef";
+  size_t at = 0;
+  for (int i = 0; i < 16; ++i) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) out[at++] = '-';
+    out[at++] = kHex[bytes[i] >> 4];
+    out[at++] = kHex[bytes[i] & 0x0F];
+  }
+}
+
+void Uuid7Generator::Append(std::string &out, size_t count) {
+  size_t at = out.size();
+  out.resize(at + count * kStringLength);
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+  uint8_t bytes[16];
+  for (size_t i = 0; i < count; ++i, at += kStringLength) {
+    Next(bytes, ms);
+    Format(bytes, &out[at]);
+  }
+}
+
+std::string Uuid7Generator::Next() {
+  std::string out;
+  Append(out, 1);
+  return out;
+}
+
+} // namespace reactotron
@@ -0,0 +1,54 @@
+#pragma once
+
+//
+//  Uuid7.h
+//  Reactotron
+//
+//  Time-ordered UUIDs (version 7, RFC 9562): a millisecond timestamp, a
+//  counter that keeps IDs made in the same millisecond in order, and 62
+//  random bits from the OS CSPRNG. Randomness is fetched a batch at a time,
+//  so most IDs cost no system call. IDs sort by creation time, as strings or
+//  bytes, so indexes keyed by them only ever append.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace reactotron {
+
+/** Fills `out` with `size` bytes from the OS CSPRNG; false if it couldn't. */
+bool SecureRandomBytes(void *out, size_t size) noexcept;
+
+/**
+ * Each ID is greater than the last, even if the clock goes backwards.
+ *
+ * Not thread-safe.
+ */
+class Uuid7Generator {
+ public:
+  static constexpr size_t kEntropyBatch = 4096; // Bytes fetched from the OS at a time
+  static constexpr size_t kStringLength = 36;
+
+  /** The next ID's 16 bytes, for the current time. */
+  void Next(uint8_t out[16]);
+  /** The same, at `unixMs` (or the last ID's time, if that's later). */
+  void Next(uint8_t out[16], int64_t unixMs);
+
+  /** Appends the next `count` IDs to `out`, formatted. */
+  void Append(std::string &out, size_t count);
+  std::string Next();
+
+  /** Lowercase 8-4-4-4-12 hex. */
+  static void Format(const uint8_t bytes[16], char out[kStringLength]) noexcept;
+
+ private:
+  void Random(void *out, size_t size);
+
+  int64_t m_lastMs = -1;
+  uint16_t m_counter = 0; // 12 bits
+  uint8_t m_entropy[kEntropyBatch];
+  size_t m_entropyUsed = kEntropyBatch;
+};
+
+} // namespace reactotron
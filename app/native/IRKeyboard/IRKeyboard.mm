@@ -6,15 +6,25 @@
 //
 
 #import "IRKeyboard.h"
+#include "ShortcutMatcher.h"
+#include <mutex>
 
 @interface IRKeyboard ()
 // Private properties
 @property (nonatomic, strong) id keyDownMonitor;
 @property (nonatomic, strong) id keyUpMonitor;
 @property (nonatomic, strong) id modifierFlagsMonitor;
+// Raw keydown/keyup/modifier events are only bridged to JS when someone asked for them.
+@property (nonatomic, assign) BOOL rawEventsEnabled;
 @end
 
-@implementation IRKeyboard RCT_EXPORT_MODULE()
+@implementation IRKeyboard {
+  // Registered from the JS thread, matched on the main thread.
+  reactotron::ShortcutMatcher _matcher;
+  std::mutex _matcherMutex;
+}
+
+RCT_EXPORT_MODULE()
 
 - (instancetype)init {
   self = [super init];
@@ -22,10 +32,82 @@
     self.keyDownMonitor = nil;
     self.keyUpMonitor = nil;
     self.modifierFlagsMonitor = nil;
+    self.rawEventsEnabled = NO;
   }
   return self;
 }
 
+static int64_t IRKeyboardMillis(NSTimeInterval seconds) {
+  return (int64_t)(seconds * 1000.0);
+}
+
+// Maps an NSEvent to the same key names the shortcut grammar uses ("escape", "enter", "k").
+- (reactotron::KeyChord)chordFromEvent:(NSEvent *)event {
+  reactotron::KeyChord chord;
+  NSEventModifierFlags flags = event.modifierFlags;
+  if (flags & NSEventModifierFlagControl) chord.modifiers |= reactotron::kShortcutModifierCtrl;
+  if (flags & NSEventModifierFlagOption) chord.modifiers |= reactotron::kShortcutModifierAlt;
+  if (flags & NSEventModifierFlagShift) chord.modifiers |= reactotron::kShortcutModifierShift;
+  if (flags & NSEventModifierFlagCommand) chord.modifiers |= reactotron::kShortcutModifierCmd;
+
+  switch (event.keyCode) {
+    case 53: chord.key = "escape"; return chord;
+    case 36: case 76: chord.key = "enter"; return chord;
+    case 48: chord.key = "tab"; return chord;
+    case 49: chord.key = "space"; return chord;
+    case 51: chord.key = "backspace"; return chord;
+    case 117: chord.key = "delete"; return chord;
+    case 123: chord.key = "left"; return chord;
+    case 124: chord.key = "right"; return chord;
+    case 125: chord.key = "down"; return chord;
+    case 126: chord.key = "up"; return chord;
+    default: break;
+  }
+
+  NSString *key = event.charactersIgnoringModifiers ?: @"";
+  chord.key = reactotron::NormalizeKeyName(key.UTF8String ?: "");
+  return chord;
+}
+
+- (void)emitShortcutMatches:(const std::vector<std::string> &)matches {
+  for (const auto &shortcutId : matches) {
+    [self emitOnShortcut:@{ @"id": [NSString stringWithUTF8String:shortcutId.c_str()] ?: @"" }];
+  }
+}
+
+- (void)matchKeyDown:(NSEvent *)event {
+  // Holding a key down shouldn't re-trigger shortcuts.
+  if (event.isARepeat) return;
+
+  std::vector<std::string> matches;
+  int64_t deadline = -1;
+  {
+    std::lock_guard<std::mutex> lock(_matcherMutex);
+    if (_matcher.Empty()) return;
+    _matcher.HandleKeyDown([self chordFromEvent:event], IRKeyboardMillis(event.timestamp), matches);
+    deadline = _matcher.PendingDeadline();
+  }
+  [self emitShortcutMatches:matches];
+  if (deadline >= 0) [self scheduleExpiryAt:deadline];
+}
+
+// A partial sequence ("g" of "g g") may be holding back a shorter shortcut; settle it once it times out.
+- (void)scheduleExpiryAt:(int64_t)deadline {
+  int64_t now = IRKeyboardMillis([[NSProcessInfo processInfo] systemUptime]);
+  int64_t delay = MAX((int64_t)0, deadline - now) + 1;
+  __weak IRKeyboard *weakSelf = self;
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay * NSEC_PER_MSEC), dispatch_get_main_queue(), ^{
+    IRKeyboard *strongSelf = weakSelf;
+    if (!strongSelf) return;
+    std::vector<std::string> matches;
+    {
+      std::lock_guard<std::mutex> lock(strongSelf->_matcherMutex);
+      strongSelf->_matcher.Expire(IRKeyboardMillis([[NSProcessInfo processInfo] systemUptime]), matches);
+    }
+    [strongSelf emitShortcutMatches:matches];
+  });
+}
+
 - (NSDictionary *)keyboardEventFromEvent:(NSEvent *)event withType:(NSString *)type {
   return @{
     @"type": type,
@@ -59,6 +141,27 @@
   return [NSNumber numberWithInt:([NSEvent modifierFlags] & NSEventModifierFlagCommand)];
 }
 
+/**
+ * Registers a shortcut like "cmd+shift+k" or a sequence like "g g" under `shortcutId`.
+ * Matches are emitted as onShortcut events. Returns NO if the shortcut can't be parsed.
+ */
+- (NSNumber *)registerShortcut:(NSString *)shortcutId shortcut:(NSString *)shortcut {
+  std::lock_guard<std::mutex> lock(_matcherMutex);
+  return @(_matcher.Register(shortcutId.UTF8String ?: "", shortcut.UTF8String ?: ""));
+}
+
+- (void)unregisterShortcut:(NSString *)shortcutId {
+  std::lock_guard<std::mutex> lock(_matcherMutex);
+  _matcher.Unregister(shortcutId.UTF8String ?: "");
+}
+
+/**
+ * Opt in to receiving every keydown/keyup/modifier change as onKeyboardEvent.
+ */
+- (void)setRawEventsEnabled:(BOOL)enabled {
+  _rawEventsEnabled = enabled;
+}
+
 /*
 when hitting a modifier key, we get this
 Event: NSEvent: type=FlagsChanged loc=(0,748) time=1139752.5 flags=0x20102 win=0x146111a10 winNum=93927 ctxt=0x0 keyCode=56
@@ -68,19 +171,25 @@ Event: NSEvent: type=FlagsChanged loc=(0,748) time=1139752.5 flags=0x20102 win=0
  * Starts listening for keyboard events.
  */
 - (void)startListening {
+  if (self.keyDownMonitor) return;
+
   self.keyDownMonitor = [NSEvent addLocalMonitorForEventsMatchingMask:NSEventMaskKeyDown handler:^NSEvent *(NSEvent *event) {
+    [self matchKeyDown:event];
+    if (!self.rawEventsEnabled) return event;
     NSDictionary *keyboardEvent = [self keyboardEventFromEvent:event withType:@"keydown"];
     [self emitOnKeyboardEvent:keyboardEvent];
     return event;
   }];
   
   self.keyUpMonitor = [NSEvent addLocalMonitorForEventsMatchingMask:NSEventMaskKeyUp handler:^NSEvent *(NSEvent *event) {
+    if (!self.rawEventsEnabled) return event;
     NSDictionary *keyboardEvent = [self keyboardEventFromEvent:event withType:@"keyup"];
     [self emitOnKeyboardEvent:keyboardEvent];
     return event;
   }];
 
   self.modifierFlagsMonitor = [NSEvent addLocalMonitorForEventsMatchingMask:NSEventMaskFlagsChanged handler:^NSEvent *(NSEvent *event) {
+    if (!self.rawEventsEnabled) return event;
     // Is "modifierKeyChanged" the right event type?
     NSDictionary *keyboardEvent = @{
       @"type": @"modifierKeyChanged",
@@ -4,11 +4,55 @@
 
 using namespace winrt::reactotron::implementation;
 
+std::atomic<IRKeyboard *> IRKeyboard::s_listening{nullptr};
+
 namespace
 {
     inline bool IsKeyDown(int vk) noexcept { return (GetKeyState(vk) & 0x8000) != 0; }
+    // Low-level hooks run ahead of the message queue, so GetKeyState lags there
+    inline bool IsKeyDownNow(int vk) noexcept { return (GetAsyncKeyState(vk) & 0x8000) != 0; }
+
+    // Keys are seen system-wide; only those typed into this app count
+    bool IsOwnWindowForeground() noexcept
+    {
+        DWORD processId = 0;
+        GetWindowThreadProcessId(GetForegroundWindow(), &processId);
+        return processId == GetCurrentProcessId();
+    }
+
+    // The shortcut grammar's name for a virtual key: "escape", "f5", "k", "/". Empty for modifiers.
+    std::string KeyName(DWORD vk)
+    {
+        switch (vk)
+        {
+        case VK_ESCAPE: return "escape";
+        case VK_RETURN: return "enter";
+        case VK_TAB: return "tab";
+        case VK_SPACE: return "space";
+        case VK_BACK: return "backspace";
+        case VK_DELETE: return "delete";
+        case VK_LEFT: return "left";
+        case VK_RIGHT: return "right";
+        case VK_UP: return "up";
+        case VK_DOWN: return "down";
+        case VK_HOME: return "home";
+        case VK_END: return "end";
+        case VK_PRIOR: return "pageup";
+        case VK_NEXT: return "pagedown";
+        default: break;
+        }
+        if (vk >= VK_F1 && vk <= VK_F24) return "f" + std::to_string(vk - VK_F1 + 1);
+        // The unshifted character on the current layout, so shift+/ is "/" and not "?"
+        UINT character = MapVirtualKeyW(vk, MAPVK_VK_TO_CHAR) & 0x7FFFFFFF;
+        if (character <= ' ' || character >= 0x7F) return std::string();
+        return ::reactotron::NormalizeKeyName(std::string(1, static_cast<char>(character)));
+    }
+
+    int64_t NowMs() noexcept { return static_cast<int64_t>(GetTickCount64()); }
 }
 
+IRKeyboard::~IRKeyboard() noexcept { stopListening(); }
+
 bool IRKeyboard::ctrl() noexcept { return IsKeyDown(VK_CONTROL); }
 bool IRKeyboard::alt() noexcept { return IsKeyDown(VK_MENU); }
 bool IRKeyboard::shift() noexcept { return IsKeyDown(VK_SHIFT); }
@@ -16,18 +60,148 @@ bool IRKeyboard::cmd() noexcept { return IsKeyDown(VK_LWIN) || IsKeyDown(VK_RWIN
 
 void IRKeyboard::startListening() noexcept
 {
-    m_isListening = true;
+    if (m_hookThread.joinable()) return;
+    // One module instance owns the hook at a time
+    IRKeyboard *expected = nullptr;
+    if (!s_listening.compare_exchange_strong(expected, this)) return;
+    m_hookThread = std::thread([this] { RunHook(); });
+}
+
+void IRKeyboard::stopListening() noexcept
+{
+    if (!m_hookThread.joinable()) return;
+    DWORD threadId;
+    while ((threadId = m_hookThreadId.load()) == 0) std::this_thread::yield();
+    PostThreadMessageW(threadId, WM_QUIT, 0, 0);
+    m_hookThread.join();
+    m_hookThreadId = 0;
+    IRKeyboard *self = this;
+    s_listening.compare_exchange_strong(self, nullptr);
+}
+
+void IRKeyboard::RunHook() noexcept
+{
+    MSG msg;
+    // Gives the thread its message queue before anyone posts WM_QUIT to it
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    m_hookThreadId = GetCurrentThreadId();
+    HHOOK hook = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardProc, GetModuleHandleW(nullptr), 0);
+
+    for (;;)
+    {
+        // Wake when a partial sequence ("g" of "g g") times out, to settle what it held back
+        DWORD timeout = INFINITE;
+        {
+            std::lock_guard<std::mutex> lock(m_matcherMutex);
+            int64_t deadline = m_matcher.PendingDeadline();
+            if (deadline >= 0) timeout = static_cast<DWORD>(std::max<int64_t>(0, deadline - NowMs()) + 1);
+        }
+        if (MsgWaitForMultipleObjects(0, nullptr, FALSE, timeout, QS_ALLINPUT) == WAIT_TIMEOUT)
+        {
+            ExpirePending();
+            continue;
+        }
+        bool quit = false;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+        {
+            if (msg.message == WM_QUIT) quit = true;
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+        if (quit) break;
+    }
+
+    if (hook) UnhookWindowsHookEx(hook);
+}
 
-    // Emit a synthetic event to verify wiring
+LRESULT CALLBACK IRKeyboard::KeyboardProc(int code, WPARAM wParam, LPARAM lParam) noexcept
+{
+    if (code == HC_ACTION)
+    {
+        IRKeyboard *keyboard = s_listening.load();
+        bool down = wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN;
+        bool up = wParam == WM_KEYUP || wParam == WM_SYSKEYUP;
+        if (keyboard && (down || up) && IsOwnWindowForeground())
+            keyboard->HandleKey(down, reinterpret_cast<const KBDLLHOOKSTRUCT *>(lParam)->vkCode);
+    }
+    return CallNextHookEx(nullptr, code, wParam, lParam);
+}
+
+void IRKeyboard::HandleKey(bool down, DWORD vkCode) noexcept
+{
     reactotronCodegen::IRKeyboardSpec_KeyboardEvent evt{};
-    evt.type = "keydown";
-    evt.key = "A";
-    evt.characters = "a";
-    evt.keyCode = 65;
-    evt.modifiers = reactotronCodegen::IRKeyboardSpec_KeyboardEvent_modifiers{ctrl(), alt(), shift(), cmd()};
+    evt.type = down ? "keydown" : "keyup";
+    evt.key = KeyName(vkCode);
+    evt.characters = evt.key.size() == 1 ? evt.key : std::string();
+    evt.keyCode = static_cast<double>(vkCode);
+    evt.modifiers = reactotronCodegen::IRKeyboardSpec_KeyboardEvent_modifiers{
+        IsKeyDownNow(VK_CONTROL), IsKeyDownNow(VK_MENU), IsKeyDownNow(VK_SHIFT),
+        IsKeyDownNow(VK_LWIN) || IsKeyDownNow(VK_RWIN)};
 
-    if (onKeyboardEvent)
-        onKeyboardEvent(std::move(evt));
+    if (!down)
+    {
+        if (vkCode == m_repeatingKey) m_repeatingKey = 0;
+    }
+    else if (vkCode != m_repeatingKey)
+    {
+        // Holding a key down shouldn't re-trigger shortcuts
+        m_repeatingKey = vkCode;
+        HandleKeyDown(evt);
+    }
+
+    if (m_rawEventsEnabled && onKeyboardEvent)
+        onKeyboardEvent(evt);
 }
 
-void IRKeyboard::stopListening() noexcept { m_isListening = false; }
+bool IRKeyboard::registerShortcut(std::string shortcutId, std::string shortcut) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_matcherMutex);
+    return m_matcher.Register(shortcutId, shortcut);
+}
+
+void IRKeyboard::unregisterShortcut(std::string shortcutId) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_matcherMutex);
+    m_matcher.Unregister(shortcutId);
+}
+
+void IRKeyboard::setRawEventsEnabled(bool enabled) noexcept { m_rawEventsEnabled = enabled; }
+
+void IRKeyboard::HandleKeyDown(const reactotronCodegen::IRKeyboardSpec_KeyboardEvent &evt) noexcept
+{
+    ::reactotron::KeyChord chord;
+    if (evt.modifiers.ctrl) chord.modifiers |= ::reactotron::kShortcutModifierCtrl;
+    if (evt.modifiers.alt) chord.modifiers |= ::reactotron::kShortcutModifierAlt;
+    if (evt.modifiers.shift) chord.modifiers |= ::reactotron::kShortcutModifierShift;
+    if (evt.modifiers.cmd) chord.modifiers |= ::reactotron::kShortcutModifierCmd;
+    chord.key = ::reactotron::NormalizeKeyName(evt.key);
+
+    std::vector<std::string> matches;
+    {
+        std::lock_guard<std::mutex> lock(m_matcherMutex);
+        if (m_matcher.Empty()) return;
+        m_matcher.HandleKeyDown(chord, NowMs(), matches);
+    }
+    EmitShortcuts(matches);
+}
+
+void IRKeyboard::ExpirePending() noexcept
+{
+    std::vector<std::string> matches;
+    {
+        std::lock_guard<std::mutex> lock(m_matcherMutex);
+        m_matcher.Expire(NowMs(), matches);
+    }
+    EmitShortcuts(matches);
+}
+
+void IRKeyboard::EmitShortcuts(std::vector<std::string> &matches) noexcept
+{
+    if (!onShortcut) return;
+    for (auto &shortcutId : matches)
+    {
+        reactotronCodegen::IRKeyboardSpec_ShortcutEvent shortcutEvt{};
+        shortcutEvt.id = std::move(shortcutId);
+        onShortcut(std::move(shortcutEvt));
+    }
+}
@@ -2,6 +2,10 @@
 #include "NativeModules.h"
 #include "..\..\..\windows\reactotron\codegen\NativeIRKeyboardDataTypes.g.h"
 #include "..\..\..\windows\reactotron\codegen\NativeIRKeyboardSpec.g.h"
+#include "ShortcutMatcher.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace winrt::reactotron::implementation
 {
@@ -9,6 +13,7 @@ namespace winrt::reactotron::implementation
     struct IRKeyboard
     {
         IRKeyboard() noexcept = default;
+        ~IRKeyboard() noexcept;
 
         REACT_SYNC_METHOD(ctrl)
         bool ctrl() noexcept;
@@ -24,11 +29,35 @@ namespace winrt::reactotron::implementation
         REACT_METHOD(stopListening)
         void stopListening() noexcept;
 
+        REACT_SYNC_METHOD(registerShortcut)
+        bool registerShortcut(std::string shortcutId, std::string shortcut) noexcept;
+        REACT_METHOD(unregisterShortcut)
+        void unregisterShortcut(std::string shortcutId) noexcept;
+        REACT_METHOD(setRawEventsEnabled)
+        void setRawEventsEnabled(bool enabled) noexcept;
+
         REACT_EVENT(onKeyboardEvent)
         std::function<void(reactotronCodegen::IRKeyboardSpec_KeyboardEvent)> onKeyboardEvent;
 
+        REACT_EVENT(onShortcut)
+        std::function<void(reactotronCodegen::IRKeyboardSpec_ShortcutEvent)> onShortcut;
+
     private:
-        bool m_isListening = false;
-        HHOOK m_keyboardHook = nullptr;
+        static LRESULT CALLBACK KeyboardProc(int code, WPARAM wParam, LPARAM lParam) noexcept;
+        // The hook's thread: low-level hooks are called on the thread that set them, which must pump messages
+        void RunHook() noexcept;
+        void HandleKey(bool down, DWORD vkCode) noexcept;
+        void HandleKeyDown(const reactotronCodegen::IRKeyboardSpec_KeyboardEvent &evt) noexcept;
+        void ExpirePending() noexcept;
+        void EmitShortcuts(std::vector<std::string> &matches) noexcept;
+
+        static std::atomic<IRKeyboard *> s_listening;
+
+        std::thread m_hookThread;
+        std::atomic<DWORD> m_hookThreadId{0};
+        std::atomic<bool> m_rawEventsEnabled{false};
+        DWORD m_repeatingKey = 0; // Held down, so its repeats don't trigger shortcuts again; hook thread only
+        ::reactotron::ShortcutMatcher m_matcher;
+        std::mutex m_matcherMutex;
     };
 }
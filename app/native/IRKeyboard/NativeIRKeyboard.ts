@@ -15,6 +15,10 @@ export interface KeyboardEvent {
   }
 }
 
+export interface ShortcutEvent {
+  id: string
+}
+
 export interface Spec extends TurboModule {
   ctrl(): boolean
   alt(): boolean
@@ -22,7 +26,11 @@ export interface Spec extends TurboModule {
   cmd(): boolean
   startListening(): void
   stopListening(): void
+  registerShortcut(shortcutId: string, shortcut: string): boolean
+  unregisterShortcut(shortcutId: string): void
+  setRawEventsEnabled(enabled: boolean): void
   readonly onKeyboardEvent: EventEmitter<KeyboardEvent>
+  readonly onShortcut: EventEmitter<ShortcutEvent>
 }
 
 export default TurboModuleRegistry.getEnforcing<Spec>("IRKeyboard")
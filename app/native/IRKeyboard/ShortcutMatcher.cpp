@@ -0,0 +1,232 @@
+//
+//  ShortcutMatcher.cpp
+//  Reactotron
+//
+
+#include "ShortcutMatcher.h"
+
+#include <cctype>
+
+namespace reactotron {
+
+namespace {
+
+std::string ToLower(std::string_view s) {
+  std::string out(s);
+  for (auto &c : out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return out;
+}
+
+bool ModifierFromName(const std::string &name, uint8_t &modifier) {
+  if (name == "cmd" || name == "command") modifier = kShortcutModifierCmd;
+  else if (name == "shift") modifier = kShortcutModifierShift;
+  else if (name == "alt" || name == "option") modifier = kShortcutModifierAlt;
+  else if (name == "ctrl" || name == "control") modifier = kShortcutModifierCtrl;
+  else return false;
+  return true;
+}
+
+bool ParseChord(std::string_view text, KeyChord &chord) {
+  chord = {};
+
+  // A trailing "+" is the plus key itself ("cmd++" or just "+").
+  std::string_view keyPart;
+  std::string_view modifierPart;
+  if (text.size() >= 1 && text.back() == '+' && (text.size() == 1 || text[text.size() - 2] == '+')) {
+    keyPart = "+";
+    modifierPart = text.substr(0, text.size() >= 2 ? text.size() - 2 : 0);
+  } else {
+    size_t lastPlus = text.rfind('+');
+    keyPart = lastPlus == std::string_view::npos ? text : text.substr(lastPlus + 1);
+    modifierPart = lastPlus == std::string_view::npos ? std::string_view() : text.substr(0, lastPlus);
+  }
+
+  if (keyPart.empty()) return false;
+
+  while (!modifierPart.empty()) {
+    size_t plus = modifierPart.find('+');
+    std::string name = ToLower(modifierPart.substr(0, plus));
+    uint8_t modifier = 0;
+    if (!ModifierFromName(name, modifier)) return false;
+    chord.modifiers |= modifier;
+    if (plus == std::string_view::npos) break;
+    modifierPart.remove_prefix(plus + 1);
+  }
+
+  chord.key = NormalizeKeyName(keyPart);
+  // "?" is typed as shift+/, so it's registered as that
+  if (UnshiftedKey(chord.key) != chord.key) chord.modifiers |= kShortcutModifierShift;
+  return true;
+}
+
+} // namespace
+
+std::string_view UnshiftedKey(std::string_view key) noexcept {
+  if (key.size() != 1) return key;
+  static constexpr std::string_view kShifted = "~!@#$%^&*()_+{}|:\"<>?";
+  static constexpr std::string_view kUnshifted = "`1234567890-=[]\\;',./";
+  size_t at = kShifted.find(key[0]);
+  return at == std::string_view::npos ? key : kUnshifted.substr(at, 1);
+}
+
+std::string NormalizeKeyName(std::string_view key) {
+  std::string name = ToLower(key);
+  if (name == "esc") return "escape";
+  if (name == "return") return "enter";
+  if (name == "del") return "delete";
+  if (name == "arrowup") return "up";
+  if (name == "arrowdown") return "down";
+  if (name == "arrowleft") return "left";
+  if (name == "arrowright") return "right";
+  if (name == " ") return "space";
+  return name;
+}
+
+bool ParseShortcut(std::string_view shortcut, std::vector<KeyChord> &sequence) {
+  sequence.clear();
+  size_t i = 0;
+  while (i < shortcut.size()) {
+    while (i < shortcut.size() && std::isspace(static_cast<unsigned char>(shortcut[i]))) i++;
+    size_t start = i;
+    while (i < shortcut.size() && !std::isspace(static_cast<unsigned char>(shortcut[i]))) i++;
+    if (start == i) break;
+
+    KeyChord chord;
+    if (!ParseChord(shortcut.substr(start, i - start), chord)) {
+      sequence.clear();
+      return false;
+    }
+    sequence.push_back(std::move(chord));
+  }
+  return !sequence.empty();
+}
+
+std::string FormatShortcut(const std::vector<KeyChord> &sequence) {
+  std::string out;
+  for (const auto &chord : sequence) {
+    if (!out.empty()) out += ' ';
+    if (chord.modifiers & kShortcutModifierCmd) out += "cmd+";
+    if (chord.modifiers & kShortcutModifierCtrl) out += "ctrl+";
+    if (chord.modifiers & kShortcutModifierAlt) out += "alt+";
+    if (chord.modifiers & kShortcutModifierShift) out += "shift+";
+    out += chord.key;
+  }
+  return out;
+}
+
+ShortcutMatcher::ShortcutMatcher(int64_t sequenceTimeoutMs) : m_timeoutMs(sequenceTimeoutMs) {
+  m_nodes.emplace_back();
+}
+
+bool ShortcutMatcher::Register(const std::string &id, std::string_view shortcut) {
+  std::vector<KeyChord> sequence;
+  if (!ParseShortcut(shortcut, sequence)) return false;
+
+  bool replacing = m_shortcuts.count(id) > 0;
+  m_shortcuts[id] = sequence;
+  if (replacing) {
+    Rebuild();
+  } else {
+    Insert(id, sequence);
+  }
+  return true;
+}
+
+bool ShortcutMatcher::Unregister(const std::string &id) {
+  if (m_shortcuts.erase(id) == 0) return false;
+  Rebuild();
+  return true;
+}
+
+void ShortcutMatcher::Clear() {
+  m_shortcuts.clear();
+  Rebuild();
+}
+
+bool ShortcutMatcher::HandleKeyDown(const KeyChord &chord, int64_t timestampMs, std::vector<std::string> &matches) {
+  if (chord.key.empty()) return false;
+
+  if (m_current != kRoot && timestampMs - m_lastTimestamp > m_timeoutMs) {
+    Reset(&matches);
+  }
+
+  std::string chordKey = ChordKey(chord);
+  uint32_t next = Child(m_current, chordKey);
+
+  // The sequence in progress doesn't continue with this chord. Settle it and try
+  // the chord as the start of a new one.
+  if (next == kRoot && m_current != kRoot) {
+    Reset(&matches);
+    next = Child(kRoot, chordKey);
+  }
+
+  if (next == kRoot) return false;
+
+  const Node &node = m_nodes[next];
+  if (node.children.empty()) {
+    matches.insert(matches.end(), node.ids.begin(), node.ids.end());
+    Reset(nullptr);
+    return true;
+  }
+
+  m_current = next;
+  m_lastTimestamp = timestampMs;
+  return true;
+}
+
+bool ShortcutMatcher::Expire(int64_t nowMs, std::vector<std::string> &matches) {
+  if (m_current == kRoot || nowMs - m_lastTimestamp < m_timeoutMs) return false;
+  Reset(&matches);
+  return true;
+}
+
+int64_t ShortcutMatcher::PendingDeadline() const noexcept {
+  return m_current == kRoot ? -1 : m_lastTimestamp + m_timeoutMs;
+}
+
+std::string ShortcutMatcher::ChordKey(const KeyChord &chord) {
+  std::string key;
+  key.reserve(chord.key.size() + 1);
+  key += static_cast<char>('0' + chord.modifiers);
+  // Platforms report shift+/ as "?" or "/"; both match the same shortcut
+  key += chord.modifiers & kShortcutModifierShift ? UnshiftedKey(chord.key) : std::string_view(chord.key);
+  return key;
+}
+
+uint32_t ShortcutMatcher::Child(uint32_t node, const std::string &chordKey) const {
+  const auto &children = m_nodes[node].children;
+  auto it = children.find(chordKey);
+  return it == children.end() ? kRoot : it->second;
+}
+
+void ShortcutMatcher::Rebuild() {
+  m_nodes.clear();
+  m_nodes.emplace_back();
+  m_current = kRoot;
+  for (const auto &entry : m_shortcuts) Insert(entry.first, entry.second);
+}
+
+void ShortcutMatcher::Insert(const std::string &id, const std::vector<KeyChord> &sequence) {
+  uint32_t node = kRoot;
+  for (const auto &chord : sequence) {
+    std::string chordKey = ChordKey(chord);
+    uint32_t next = Child(node, chordKey);
+    if (next == kRoot) {
+      next = static_cast<uint32_t>(m_nodes.size());
+      m_nodes.emplace_back();
+      m_nodes[node].children.emplace(std::move(chordKey), next);
+    }
+    node = next;
+  }
+  m_nodes[node].ids.push_back(id);
+}
+
+void ShortcutMatcher::Reset(std::vector<std::string> *matches) {
+  if (matches && m_current != kRoot) {
+    const auto &held = m_nodes[m_current].ids;
+    matches->insert(matches->end(), held.begin(), held.end());
+  }
+  m_current = kRoot;
+}
+
+} // namespace reactotron
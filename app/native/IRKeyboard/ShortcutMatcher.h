@@ -0,0 +1,127 @@
+#pragma once
+
+//
+//  ShortcutMatcher.h
+//  Reactotron
+//
+//  Platform-independent keyboard shortcut registry. IRKeyboard feeds it every
+//  key-down and only bridges the shortcuts that actually matched, instead of
+//  sending every keystroke to JS.
+//
+//  Shortcuts use the same grammar as IRMenuItemManager's applyShortcut:
+//  "+"-separated modifiers followed by a key, e.g. "cmd+shift+k". Chords
+//  separated by whitespace form a sequence, e.g. "g g".
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+enum ShortcutModifier : uint8_t {
+  kShortcutModifierCtrl = 1 << 0,
+  kShortcutModifierAlt = 1 << 1,
+  kShortcutModifierShift = 1 << 2,
+  kShortcutModifierCmd = 1 << 3,
+};
+
+struct KeyChord {
+  uint8_t modifiers = 0;
+  std::string key;
+
+  bool operator==(const KeyChord &other) const noexcept {
+    return modifiers == other.modifiers && key == other.key;
+  }
+};
+
+/**
+ * Lowercases a key name and folds aliases ("esc" -> "escape", "return" -> "enter").
+ */
+std::string NormalizeKeyName(std::string_view key);
+
+/**
+ * The key that types `key` with shift held on a US layout ("?" -> "/",
+ * "!" -> "1"), or `key` itself.
+ */
+std::string_view UnshiftedKey(std::string_view key) noexcept;
+
+/**
+ * Parses "cmd+shift+k" or "g g" into a chord sequence. Returns false for an empty
+ * shortcut, an unknown modifier or a chord without a key.
+ */
+bool ParseShortcut(std::string_view shortcut, std::vector<KeyChord> &sequence);
+
+/**
+ * Formats a chord sequence back into canonical shortcut grammar.
+ */
+std::string FormatShortcut(const std::vector<KeyChord> &sequence);
+
+/**
+ * A trie over chord sequences with a timeout between chords.
+ *
+ * When a registered shortcut is also the prefix of a longer one ("g" and "g g"),
+ * the shorter one is held back until the next chord breaks the sequence or the
+ * timeout passes, so the caller should call Expire() at PendingDeadline().
+ *
+ * Not thread-safe.
+ */
+class ShortcutMatcher {
+ public:
+  explicit ShortcutMatcher(int64_t sequenceTimeoutMs = 1000);
+
+  /**
+   * Registers (or replaces) a shortcut under `id`. Returns false if the shortcut
+   * can't be parsed, in which case any previous registration for `id` is kept.
+   */
+  bool Register(const std::string &id, std::string_view shortcut);
+  bool Unregister(const std::string &id);
+  void Clear();
+
+  /**
+   * Feeds a key-down. Appends the ids of any shortcuts completed by it to `matches`
+   * and returns true if the chord was consumed by a registered shortcut (complete
+   * or partial).
+   */
+  bool HandleKeyDown(const KeyChord &chord, int64_t timestampMs, std::vector<std::string> &matches);
+
+  /**
+   * Abandons a partial sequence whose timeout has passed, appending any held back
+   * shortcut to `matches`. Returns true if the matcher state changed.
+   */
+  bool Expire(int64_t nowMs, std::vector<std::string> &matches);
+
+  /**
+   * When a partial sequence is in progress, the time at which it times out; -1 otherwise.
+   */
+  int64_t PendingDeadline() const noexcept;
+
+  bool Empty() const noexcept { return m_shortcuts.empty(); }
+  size_t Size() const noexcept { return m_shortcuts.size(); }
+  int64_t SequenceTimeout() const noexcept { return m_timeoutMs; }
+
+ private:
+  struct Node {
+    std::unordered_map<std::string, uint32_t> children;
+    std::vector<std::string> ids;
+  };
+
+  static constexpr uint32_t kRoot = 0;
+
+  static std::string ChordKey(const KeyChord &chord);
+  uint32_t Child(uint32_t node, const std::string &chordKey) const;
+  void Rebuild();
+  void Insert(const std::string &id, const std::vector<KeyChord> &sequence);
+  void Reset(std::vector<std::string> *matches);
+
+  int64_t m_timeoutMs;
+  std::unordered_map<std::string, std::vector<KeyChord>> m_shortcuts;
+  std::vector<Node> m_nodes;
+  uint32_t m_current = kRoot;
+  int64_t m_lastTimestamp = 0;
+};
+
+} // namespace reactotron
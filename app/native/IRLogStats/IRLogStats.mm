@@ -0,0 +1,53 @@
+//
+//  IRLogStats.mm
+//  Reactotron-macOS
+//
+//  The session's noisiest log sources, counted by the relay's ingest workers.
+//
+
+#import "IRLogStats.h"
+#include "LogStats.h"
+#include <mutex>
+#include <vector>
+
+@implementation IRLogStats
+
+RCT_EXPORT_MODULE()
+
+static NSString *IRLogStatsString(const std::string &string) {
+  return [NSString stringWithUTF8String:string.c_str()] ?: @"";
+}
+
+- (NSDictionary *)getHeavyHitters {
+  std::vector<reactotron::LogSource> sources;
+  uint64_t total;
+  {
+    auto &shared = reactotron::SharedLogStats::Get();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    sources = shared.stats.HeavyHitters();
+    total = shared.stats.Total();
+  }
+
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:sources.size()];
+  for (const auto &source : sources) {
+    [result addObject:@{
+      @"level": IRLogStatsString(source.level),
+      @"label": IRLogStatsString(source.label),
+      @"stackTop": IRLogStatsString(source.stackTop),
+      @"count": @(source.count),
+    }];
+  }
+  return @{@"total": @(total), @"sources": result};
+}
+
+- (void)clear {
+  auto &shared = reactotron::SharedLogStats::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  shared.stats.Clear();
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRLogStatsSpecJSI>(params);
+}
+
+@end
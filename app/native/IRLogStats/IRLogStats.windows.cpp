@@ -0,0 +1,49 @@
+//
+//  IRLogStats.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared LogStats tracker, which the
+//  relay's ingest workers record logs into
+//
+
+#include "pch.h"
+#include "IRLogStats.windows.h"
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    Microsoft::ReactNative::JSValue IRLogStats::getHeavyHitters() noexcept
+    {
+        std::vector<::reactotron::LogSource> sources;
+        uint64_t total;
+        {
+            auto &shared = ::reactotron::SharedLogStats::Get();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            sources = shared.stats.HeavyHitters();
+            total = shared.stats.Total();
+        }
+
+        Microsoft::ReactNative::JSValueArray sourceArray;
+        for (const auto &source : sources)
+        {
+            Microsoft::ReactNative::JSValueObject entry;
+            entry["level"] = source.level;
+            entry["label"] = source.label;
+            entry["stackTop"] = source.stackTop;
+            entry["count"] = static_cast<double>(source.count);
+            sourceArray.push_back(std::move(entry));
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["total"] = static_cast<double>(total);
+        result["sources"] = std::move(sourceArray);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    void IRLogStats::clear() noexcept
+    {
+        auto &shared = ::reactotron::SharedLogStats::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.stats.Clear();
+    }
+}
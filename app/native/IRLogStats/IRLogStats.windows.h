@@ -0,0 +1,18 @@
+#pragma once
+#include "NativeModules.h"
+#include "LogStats.h"
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRLogStats)
+    struct IRLogStats
+    {
+        IRLogStats() noexcept = default;
+
+        REACT_SYNC_METHOD(getHeavyHitters)
+        Microsoft::ReactNative::JSValue getHeavyHitters() noexcept;
+
+        REACT_METHOD(clear)
+        void clear() noexcept;
+    };
+}
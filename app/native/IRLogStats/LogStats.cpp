@@ -0,0 +1,243 @@
+//
+//  LogStats.cpp
+//  Reactotron
+//
+
+#include "LogStats.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace reactotron {
+
+namespace {
+
+constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ull;
+
+// splitmix64 finalizer
+inline uint64_t Mix(uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  x ^= x >> 31;
+  return x;
+}
+
+inline bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+inline bool IsHex(char c) noexcept {
+  return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool IsWordChar(char c) noexcept {
+  return IsDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+/** Ids, addresses and hashes: "0x7ffe…", or 8+ hex characters with a digit. */
+bool IsOpaqueToken(std::string_view token) noexcept {
+  if (token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) return true;
+  if (token.size() < 8) return false;
+  for (char c : token) {
+    if (!IsHex(c)) return false;
+  }
+  return true;
+}
+
+size_t RoundUpToPowerOfTwo(size_t value) noexcept {
+  size_t result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+} // namespace
+
+uint64_t HashBytes(std::string_view data, uint64_t seed) noexcept {
+  const char *p = data.data();
+  size_t length = data.size();
+  uint64_t hash = Mix(seed ^ (length * kGolden));
+  while (length >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    hash = (hash ^ Mix(word)) * kGolden;
+    p += 8;
+    length -= 8;
+  }
+  uint64_t tail = 0;
+  if (length) std::memcpy(&tail, p, length); // p may be null for an empty view
+  hash = (hash ^ Mix(tail ^ length)) * kGolden;
+  return Mix(hash);
+}
+
+void AppendLogTemplate(std::string_view message, size_t maxLength, std::string &out) {
+  size_t start = out.size();
+  size_t limit = start + maxLength;
+  size_t i = 0;
+  while (i < message.size() && out.size() < limit) {
+    char c = message[i];
+    if (!IsWordChar(c)) {
+      out.push_back(c);
+      ++i;
+      continue;
+    }
+
+    size_t end = i;
+    bool anyDigit = false;
+    while (end < message.size() && IsWordChar(message[end])) anyDigit |= IsDigit(message[end++]);
+    std::string_view token = message.substr(i, end - i);
+    i = end;
+
+    if (!anyDigit) {
+      out.append(token);
+    } else if (IsOpaqueToken(token)) {
+      out.push_back('#');
+    } else {
+      // "user42" -> "user#"
+      for (size_t k = 0; k < token.size(); ++k) {
+        if (!IsDigit(token[k])) {
+          out.push_back(token[k]);
+        } else if (k == 0 || !IsDigit(token[k - 1])) {
+          out.push_back('#');
+        }
+      }
+    }
+  }
+
+  if (out.size() > limit) out.resize(limit);
+  if (out.size() == limit && i < message.size()) {
+    // Don't leave half a UTF-8 character behind
+    size_t lead = out.size();
+    while (lead > start && (static_cast<uint8_t>(out[lead - 1]) & 0xC0) == 0x80) --lead;
+    if (lead > start) {
+      uint8_t byte = static_cast<uint8_t>(out[lead - 1]);
+      size_t expected = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+      if (out.size() - (lead - 1) < expected) out.resize(lead - 1);
+    }
+  }
+}
+
+// CountMinSketch
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : m_width(RoundUpToPowerOfTwo(std::max<size_t>(width, 1))), m_depth(std::max<size_t>(depth, 1)),
+      m_counters(m_width * m_depth, 0) {}
+
+size_t CountMinSketch::Cell(size_t row, uint64_t hash) const noexcept {
+  uint64_t rowHash = Mix(hash + (row + 1) * kGolden);
+  return row * m_width + static_cast<size_t>(rowHash & (m_width - 1));
+}
+
+uint32_t CountMinSketch::Add(uint64_t hash) noexcept {
+  // Conservative update: only the counters at the current minimum move
+  uint32_t estimate = Estimate(hash);
+  if (estimate == UINT32_MAX) return estimate;
+  for (size_t row = 0; row < m_depth; ++row) {
+    uint32_t &counter = m_counters[Cell(row, hash)];
+    if (counter == estimate) counter++;
+  }
+  return estimate + 1;
+}
+
+uint32_t CountMinSketch::Estimate(uint64_t hash) const noexcept {
+  uint32_t estimate = UINT32_MAX;
+  for (size_t row = 0; row < m_depth; ++row) {
+    estimate = std::min(estimate, m_counters[Cell(row, hash)]);
+  }
+  return estimate;
+}
+
+void CountMinSketch::Clear() noexcept { std::fill(m_counters.begin(), m_counters.end(), 0); }
+
+// LogStats
+
+LogStats::LogStats(size_t topK, size_t sketchWidth, size_t sketchDepth)
+    : m_topK(std::max<size_t>(topK, 1)), m_sketch(sketchWidth, sketchDepth) {
+  m_heap.reserve(m_topK);
+}
+
+uint64_t LogStats::Record(std::string_view level, std::string_view message, std::string_view stackTop) {
+  m_total++;
+  uint64_t context = HashBytes(stackTop, HashBytes(level));
+  uint64_t fingerprint = HashBytes(message, context);
+
+  m_template.clear();
+  AppendLogTemplate(message, kMaxLabelLength, m_template);
+  uint64_t source = HashBytes(m_template, ~context);
+
+  uint32_t count = m_sketch.Add(source);
+  auto it = m_positions.find(source);
+  if (it != m_positions.end()) {
+    m_heap[it->second].count = count;
+    SiftDown(it->second);
+    return fingerprint;
+  }
+  if (m_heap.size() == m_topK && count <= m_heap[0].count) return fingerprint;
+
+  LogSource entry;
+  entry.hash = source;
+  entry.count = count;
+  entry.level = level;
+  entry.label = m_template;
+  entry.stackTop = stackTop.substr(0, kMaxLabelLength);
+  if (m_heap.size() < m_topK) {
+    m_heap.push_back(std::move(entry));
+    m_positions[source] = m_heap.size() - 1;
+    SiftUp(m_heap.size() - 1);
+  } else {
+    // Evict the smallest
+    m_positions.erase(m_heap[0].hash);
+    m_heap[0] = std::move(entry);
+    m_positions[source] = 0;
+    SiftDown(0);
+  }
+  return fingerprint;
+}
+
+void LogStats::Swap(size_t a, size_t b) noexcept {
+  std::swap(m_heap[a], m_heap[b]);
+  m_positions[m_heap[a].hash] = a;
+  m_positions[m_heap[b].hash] = b;
+}
+
+void LogStats::SiftUp(size_t index) noexcept {
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (m_heap[parent].count <= m_heap[index].count) break;
+    Swap(parent, index);
+    index = parent;
+  }
+}
+
+void LogStats::SiftDown(size_t index) noexcept {
+  for (;;) {
+    size_t smallest = index;
+    size_t left = 2 * index + 1;
+    size_t right = left + 1;
+    if (left < m_heap.size() && m_heap[left].count < m_heap[smallest].count) smallest = left;
+    if (right < m_heap.size() && m_heap[right].count < m_heap[smallest].count) smallest = right;
+    if (smallest == index) return;
+    Swap(smallest, index);
+    index = smallest;
+  }
+}
+
+std::vector<LogSource> LogStats::HeavyHitters() const {
+  std::vector<LogSource> sources = m_heap;
+  std::sort(sources.begin(), sources.end(),
+            [](const LogSource &a, const LogSource &b) { return a.count > b.count; });
+  return sources;
+}
+
+void LogStats::Clear() {
+  m_sketch.Clear();
+  m_heap.clear();
+  m_positions.clear();
+  m_total = 0;
+}
+
+SharedLogStats &SharedLogStats::Get() {
+  static SharedLogStats *shared = new SharedLogStats(); // Never destroyed, so ingest workers can outlive static teardown
+  return *shared;
+}
+
+} // namespace reactotron
@@ -0,0 +1,108 @@
+#pragma once
+
+//
+//  LogStats.h
+//  Reactotron
+//
+//  Ingest-side bookkeeping for log commands: a fingerprint that identifies
+//  repeated payloads, so the timeline can collapse them into one row, and a
+//  bounded heavy-hitter tracker that finds the noisiest log sources of the
+//  session however many logs go through it.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+/** 64-bit non-cryptographic hash of `data`. */
+uint64_t HashBytes(std::string_view data, uint64_t seed = 0) noexcept;
+
+/**
+ * Reduces a log message to its template for grouping: digit runs and long hex
+ * tokens (ids, addresses, hashes) become "#", so "retry 3 of 10" and "retry 4 of
+ * 10" count as one source. Appends to `out`, at most `maxLength` bytes.
+ */
+void AppendLogTemplate(std::string_view message, size_t maxLength, std::string &out);
+
+/**
+ * Count-min sketch with conservative update: estimates are never below the true
+ * count and, for skewed streams, rarely far above it. Fixed size.
+ */
+class CountMinSketch {
+ public:
+  CountMinSketch(size_t width, size_t depth);
+
+  /** Adds one occurrence of `hash` and returns its new estimated count. */
+  uint32_t Add(uint64_t hash) noexcept;
+  uint32_t Estimate(uint64_t hash) const noexcept;
+  void Clear() noexcept;
+  size_t ByteSize() const noexcept { return m_counters.size() * sizeof(uint32_t); }
+
+ private:
+  size_t Cell(size_t row, uint64_t hash) const noexcept;
+
+  size_t m_width;
+  size_t m_depth;
+  std::vector<uint32_t> m_counters; // m_depth rows of m_width
+};
+
+struct LogSource {
+  uint64_t hash = 0;
+  uint32_t count = 0; // Estimated, never an undercount
+  std::string level;
+  std::string label; // Message template
+  std::string stackTop;
+};
+
+/**
+ * Session-wide log counters. Record() returns the exact fingerprint of the log
+ * (level, message and stack top) and counts its source (level, message template
+ * and stack top) in a count-min sketch, keeping the `topK` biggest in a min-heap.
+ * Strings are only copied when a source enters the top K.
+ *
+ * Not thread-safe.
+ */
+class LogStats {
+ public:
+  explicit LogStats(size_t topK = 20, size_t sketchWidth = 4096, size_t sketchDepth = 4);
+
+  uint64_t Record(std::string_view level, std::string_view message, std::string_view stackTop);
+
+  /** The top sources, most frequent first. */
+  std::vector<LogSource> HeavyHitters() const;
+  uint64_t Total() const noexcept { return m_total; }
+  void Clear();
+
+  static constexpr size_t kMaxLabelLength = 200;
+
+ private:
+  void SiftDown(size_t index) noexcept;
+  void SiftUp(size_t index) noexcept;
+  void Swap(size_t a, size_t b) noexcept;
+
+  size_t m_topK;
+  CountMinSketch m_sketch;
+  std::vector<LogSource> m_heap; // Min-heap by count
+  std::unordered_map<uint64_t, size_t> m_positions; // Source hash -> m_heap index
+  uint64_t m_total = 0;
+  std::string m_template; // Reused template buffer
+};
+
+/**
+ * The session's log stats: IRLogStats reads them, and the relay's ingest
+ * workers record every log they see into them. Hold `mutex` to use `stats`.
+ */
+struct SharedLogStats {
+  std::mutex mutex;
+  LogStats stats;
+
+  static SharedLogStats &Get();
+};
+
+} // namespace reactotron
@@ -0,0 +1,27 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+/**
+ * A group of logs with the same level, stack top and message template (digits and
+ * ids replaced by "#"). Counts are estimates and never undercount.
+ */
+export interface LogSource {
+  level: string
+  label: string
+  stackTop: string
+  count: number
+}
+
+export interface LogHeavyHitters {
+  /** Logs recorded this session. */
+  total: number
+  /** Most frequent first. */
+  sources: ReadonlyArray<LogSource>
+}
+
+export interface Spec extends TurboModule {
+  getHeavyHitters(): LogHeavyHitters
+  clear(): void
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRLogStats")
@@ -0,0 +1,83 @@
+//
+//  IRMemoryGovernor.mm
+//  Reactotron-macOS
+//
+//  Memory budgets across the app's stores, and a live breakdown of what each holds.
+//
+
+#import "IRMemoryGovernor.h"
+#include "MemoryGovernor.h"
+#include <string>
+#include <vector>
+
+@implementation IRMemoryGovernor
+
+RCT_EXPORT_MODULE()
+
+static std::string IRMemoryGovernorString(NSString *string) {
+  const char *utf8 = string.UTF8String;
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+static NSString *IRMemoryGovernorNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+static uint64_t IRMemoryGovernorBytes(double bytes) {
+  return bytes > 0 ? static_cast<uint64_t>(bytes) : 0;
+}
+
+- (NSNumber *)report:(NSString *)store bytes:(double)bytes oldest:(double)oldest evictable:(BOOL)evictable {
+  reactotron::MemoryGovernor::Shared().Report(IRMemoryGovernorString(store), IRMemoryGovernorBytes(bytes),
+                                              static_cast<int64_t>(oldest), evictable);
+  return @1;
+}
+
+- (NSNumber *)setBudget:(NSString *)store bytes:(double)bytes {
+  reactotron::MemoryGovernor::Shared().SetBudget(IRMemoryGovernorString(store), IRMemoryGovernorBytes(bytes));
+  return @1;
+}
+
+- (NSNumber *)setGlobalBudget:(double)bytes {
+  reactotron::MemoryGovernor::Shared().SetGlobalBudget(IRMemoryGovernorBytes(bytes));
+  return @1;
+}
+
+- (NSArray<NSDictionary *> *)enforce {
+  std::vector<reactotron::MemoryEviction> evictions = reactotron::MemoryGovernor::Shared().Enforce();
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:evictions.size()];
+  for (const auto &eviction : evictions) {
+    [result addObject:@{
+      @"store": IRMemoryGovernorNSString(eviction.store),
+      @"bytes": @(eviction.bytes),
+      @"native": @(eviction.native),
+    }];
+  }
+  return result;
+}
+
+- (NSDictionary *)getUsage {
+  reactotron::MemoryGovernor &governor = reactotron::MemoryGovernor::Shared();
+  std::vector<reactotron::MemoryStoreUsage> usage = governor.Usage();
+  NSMutableArray<NSDictionary *> *stores = [NSMutableArray arrayWithCapacity:usage.size()];
+  uint64_t totalBytes = 0;
+  for (const auto &store : usage) {
+    totalBytes += store.bytes;
+    [stores addObject:@{
+      @"name": IRMemoryGovernorNSString(store.name),
+      @"bytes": @(store.bytes),
+      @"budget": @(store.budget),
+      @"oldest": @(store.oldest),
+      @"evictable": @(store.evictable),
+      @"evictedBytes": @(store.evictedBytes),
+      @"evictions": @(store.evictions),
+    }];
+  }
+  return @{ @"globalBudget": @(governor.GlobalBudget()), @"totalBytes": @(totalBytes), @"stores": stores };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRMemoryGovernorSpecJSI>(params);
+}
+
+@end
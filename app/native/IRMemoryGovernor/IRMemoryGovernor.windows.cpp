@@ -0,0 +1,75 @@
+//
+//  IRMemoryGovernor.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared MemoryGovernor
+//
+
+#include "pch.h"
+#include "IRMemoryGovernor.windows.h"
+
+namespace winrt::reactotron::implementation
+{
+    static uint64_t Bytes(double bytes) noexcept
+    {
+        return bytes > 0 ? static_cast<uint64_t>(bytes) : 0;
+    }
+
+    double IRMemoryGovernor::report(std::string store, double bytes, double oldest, bool evictable) noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().Report(store, Bytes(bytes), static_cast<int64_t>(oldest), evictable);
+        return 1;
+    }
+
+    double IRMemoryGovernor::setBudget(std::string store, double bytes) noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().SetBudget(store, Bytes(bytes));
+        return 1;
+    }
+
+    double IRMemoryGovernor::setGlobalBudget(double bytes) noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().SetGlobalBudget(Bytes(bytes));
+        return 1;
+    }
+
+    Microsoft::ReactNative::JSValue IRMemoryGovernor::enforce() noexcept
+    {
+        Microsoft::ReactNative::JSValueArray result;
+        for (auto &eviction : ::reactotron::MemoryGovernor::Shared().Enforce())
+        {
+            Microsoft::ReactNative::JSValueObject item;
+            item["store"] = std::move(eviction.store);
+            item["bytes"] = static_cast<double>(eviction.bytes);
+            item["native"] = eviction.native;
+            result.push_back(std::move(item));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    Microsoft::ReactNative::JSValue IRMemoryGovernor::getUsage() noexcept
+    {
+        ::reactotron::MemoryGovernor &governor = ::reactotron::MemoryGovernor::Shared();
+        Microsoft::ReactNative::JSValueArray stores;
+        uint64_t totalBytes = 0;
+        for (auto &store : governor.Usage())
+        {
+            totalBytes += store.bytes;
+            Microsoft::ReactNative::JSValueObject item;
+            item["name"] = std::move(store.name);
+            item["bytes"] = static_cast<double>(store.bytes);
+            item["budget"] = static_cast<double>(store.budget);
+            item["oldest"] = static_cast<double>(store.oldest);
+            item["evictable"] = store.evictable;
+            item["evictedBytes"] = static_cast<double>(store.evictedBytes);
+            item["evictions"] = static_cast<double>(store.evictions);
+            stores.push_back(std::move(item));
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["globalBudget"] = static_cast<double>(governor.GlobalBudget());
+        result["totalBytes"] = static_cast<double>(totalBytes);
+        result["stores"] = std::move(stores);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
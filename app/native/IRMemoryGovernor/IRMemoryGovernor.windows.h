@@ -0,0 +1,27 @@
+#pragma once
+#include "NativeModules.h"
+#include "MemoryGovernor.h"
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRMemoryGovernor)
+    struct IRMemoryGovernor
+    {
+        IRMemoryGovernor() noexcept = default;
+
+        REACT_SYNC_METHOD(report)
+        double report(std::string store, double bytes, double oldest, bool evictable) noexcept;
+
+        REACT_SYNC_METHOD(setBudget)
+        double setBudget(std::string store, double bytes) noexcept;
+
+        REACT_SYNC_METHOD(setGlobalBudget)
+        double setGlobalBudget(double bytes) noexcept;
+
+        REACT_SYNC_METHOD(enforce)
+        Microsoft::ReactNative::JSValue enforce() noexcept;
+
+        REACT_SYNC_METHOD(getUsage)
+        Microsoft::ReactNative::JSValue getUsage() noexcept;
+    };
+}
@@ -0,0 +1,175 @@
+//
+//  MemoryGovernor.cpp
+//  Reactotron
+//
+
+#include "MemoryGovernor.h"
+
+#include <algorithm>
+
+namespace reactotron {
+
+MemoryGovernor &MemoryGovernor::Shared() {
+  static MemoryGovernor governor;
+  return governor;
+}
+
+uint32_t MemoryGovernor::Register(std::string name, MemoryEvictCallback evict) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto store = std::make_shared<Store>();
+  store->id = m_nextId++;
+  store->evict = std::move(evict);
+  store->usage.evictable = static_cast<bool>(store->evict);
+  auto budget = m_budgets.find(name);
+  if (budget != m_budgets.end()) store->usage.budget = budget->second;
+  store->usage.name = std::move(name);
+  m_stores.push_back(store);
+  return store->id;
+}
+
+void MemoryGovernor::Unregister(uint32_t id) {
+  std::lock_guard<std::recursive_mutex> enforcing(m_enforceMutex);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // An Enforce() further up this thread still holds it
+  for (auto &store : m_stores) {
+    if (store->id == id) store->unregistered = true;
+  }
+  m_stores.erase(std::remove_if(m_stores.begin(), m_stores.end(), [id](const auto &store) { return store->id == id; }),
+                 m_stores.end());
+}
+
+MemoryGovernor::Store *MemoryGovernor::Find(std::string_view name) {
+  for (auto &store : m_stores) {
+    if (store->usage.name == name) return store.get();
+  }
+  return nullptr;
+}
+
+void MemoryGovernor::Report(uint32_t id, uint64_t bytes, int64_t oldest) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &store : m_stores) {
+    if (store->id != id) continue;
+    store->usage.bytes = bytes;
+    store->usage.oldest = oldest;
+    store->reports++;
+    return;
+  }
+}
+
+void MemoryGovernor::Report(std::string_view name, uint64_t bytes, int64_t oldest, bool evictable) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Store *store = Find(name);
+  if (!store) {
+    auto added = std::make_shared<Store>();
+    added->id = m_nextId++;
+    added->usage.name = std::string(name);
+    auto budget = m_budgets.find(added->usage.name);
+    if (budget != m_budgets.end()) added->usage.budget = budget->second;
+    m_stores.push_back(added);
+    store = added.get();
+  }
+  store->usage.bytes = bytes;
+  store->usage.oldest = oldest;
+  store->usage.evictable = store->evict ? true : evictable;
+  store->reports++;
+}
+
+void MemoryGovernor::SetBudget(std::string_view name, uint64_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budgets[std::string(name)] = bytes;
+  if (Store *store = Find(name)) store->usage.budget = bytes;
+}
+
+void MemoryGovernor::SetGlobalBudget(uint64_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_globalBudget = bytes;
+}
+
+uint64_t MemoryGovernor::GlobalBudget() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_globalBudget;
+}
+
+std::vector<MemoryEviction> MemoryGovernor::Enforce() {
+  std::lock_guard<std::recursive_mutex> enforcing(m_enforceMutex);
+
+  // Work on a copy, so stores can report while their callbacks run
+  std::vector<std::shared_ptr<Store>> stores;
+  std::vector<MemoryStoreUsage> usage;
+  uint64_t globalBudget;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stores = m_stores;
+    for (const auto &store : stores) usage.push_back(store->usage);
+    globalBudget = m_globalBudget;
+  }
+
+  std::vector<MemoryEviction> evictions;
+  auto evict = [&](size_t index, uint64_t bytes) -> uint64_t {
+    MemoryStoreUsage &store = usage[index];
+    if (!store.evictable || bytes == 0) return 0;
+    uint64_t freed = bytes; // JS stores are trusted to free what they're asked to
+    bool native = static_cast<bool>(stores[index]->evict);
+    uint64_t reports;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (stores[index]->unregistered) return 0;
+      reports = stores[index]->reports;
+    }
+    if (native) freed = std::min(stores[index]->evict(bytes), store.bytes);
+    if (!freed) return 0;
+    store.bytes -= std::min(freed, store.bytes);
+
+    auto it = std::find_if(evictions.begin(), evictions.end(), [&](const auto &e) { return e.store == store.name; });
+    if (it == evictions.end()) it = evictions.insert(evictions.end(), MemoryEviction{store.name, 0, 0, native});
+    it->bytes += bytes;
+    if (native) it->freed += freed;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MemoryStoreUsage &live = stores[index]->usage;
+    // Until the store reports again, assume it freed what it said
+    if (stores[index]->reports == reports) live.bytes -= std::min(freed, live.bytes);
+    live.evictedBytes += freed;
+    live.evictions++;
+    return freed;
+  };
+
+  // Each store within its own budget
+  for (size_t i = 0; i < usage.size(); ++i) {
+    uint64_t budget = usage[i].budget;
+    if (budget && usage[i].bytes > budget) {
+      evict(i, usage[i].bytes - static_cast<uint64_t>(static_cast<double>(budget) * kLowWater));
+    }
+  }
+
+  // Then the total, least recently used data first; stores that can't say how old theirs is go last
+  uint64_t total = 0;
+  for (const auto &store : usage) total += store.bytes;
+  if (globalBudget && total > globalBudget) {
+    uint64_t excess = total - static_cast<uint64_t>(static_cast<double>(globalBudget) * kLowWater);
+    std::vector<size_t> order;
+    for (size_t i = 0; i < usage.size(); ++i) {
+      if (usage[i].evictable && usage[i].bytes) order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      int64_t x = usage[a].oldest ? usage[a].oldest : INT64_MAX;
+      int64_t y = usage[b].oldest ? usage[b].oldest : INT64_MAX;
+      return x < y;
+    });
+    for (size_t i : order) {
+      if (!excess) break;
+      excess -= std::min(excess, evict(i, std::min(excess, usage[i].bytes)));
+    }
+  }
+  return evictions;
+}
+
+std::vector<MemoryStoreUsage> MemoryGovernor::Usage() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<MemoryStoreUsage> usage;
+  usage.reserve(m_stores.size());
+  for (const auto &store : m_stores) usage.push_back(store->usage);
+  return usage;
+}
+
+} // namespace reactotron
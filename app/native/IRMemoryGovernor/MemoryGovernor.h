@@ -0,0 +1,105 @@
+#pragma once
+
+//
+//  MemoryGovernor.h
+//  Reactotron
+//
+//  One place that knows how much memory each store holds (timeline, task
+//  scrollback, state snapshots, the search columns) and keeps them within
+//  budget. Stores report their usage as it changes; Enforce() brings each over
+//  its own budget back down, then the total under the global budget, taking
+//  from the stores with the least recently used data first.
+//
+//  Native stores free memory in their own eviction callback. Stores that live
+//  in JS have none; Enforce() returns what they should free instead.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct MemoryStoreUsage {
+  std::string name;
+  uint64_t bytes = 0;
+  uint64_t budget = 0; // 0 if it has none of its own
+  int64_t oldest = 0;  // When its least recently used data arrived, ms since the epoch; 0 if unknown
+  bool evictable = false;
+  uint64_t evictedBytes = 0; // This session
+  uint64_t evictions = 0;
+};
+
+struct MemoryEviction {
+  std::string store;
+  uint64_t bytes = 0; // Asked to free
+  uint64_t freed = 0; // Freed (or scheduled) by a native store; 0 for requests the caller carries out
+  bool native = false;
+};
+
+/**
+ * Frees about `bytes`, oldest data first, and returns how many bytes it freed.
+ * It may free them later (on the store's own queue), as long as it reports
+ * the new usage when it has.
+ */
+using MemoryEvictCallback = std::function<uint64_t(uint64_t bytes)>;
+
+/**
+ * The governor; Shared() is the one every module reports to. Thread-safe.
+ * Callbacks are called without the governor's lock held, so they may report.
+ */
+class MemoryGovernor {
+ public:
+  static constexpr double kLowWater = 0.9; // Eviction frees down to this much of a budget
+
+  static MemoryGovernor &Shared();
+
+  /** Registers a native store and returns its id. A null `evict` means it can't free anything. */
+  uint32_t Register(std::string name, MemoryEvictCallback evict);
+  /**
+   * Waits for an Enforce() that may be calling the store to finish, unless
+   * it's called from that store's own callback; either way the store isn't
+   * called again.
+   */
+  void Unregister(uint32_t id);
+
+  void Report(uint32_t id, uint64_t bytes, int64_t oldest);
+  /** For stores in JS; the first report registers them. */
+  void Report(std::string_view name, uint64_t bytes, int64_t oldest, bool evictable);
+
+  /** 0 removes the budget. Budgets may be set before the store registers. */
+  void SetBudget(std::string_view name, uint64_t bytes);
+  void SetGlobalBudget(uint64_t bytes);
+  uint64_t GlobalBudget() const;
+
+  std::vector<MemoryEviction> Enforce();
+  std::vector<MemoryStoreUsage> Usage() const;
+
+ private:
+  struct Store {
+    uint32_t id = 0;
+    MemoryEvictCallback evict;
+    MemoryStoreUsage usage;
+    uint64_t reports = 0;
+    bool unregistered = false;
+  };
+
+  Store *Find(std::string_view name);
+
+  // Held across callbacks, and taken before m_mutex. Recursive, as a callback
+  // that drops the last reference to its store unregisters it.
+  std::recursive_mutex m_enforceMutex;
+  mutable std::mutex m_mutex;
+  std::vector<std::shared_ptr<Store>> m_stores;
+  std::unordered_map<std::string, uint64_t> m_budgets;
+  uint64_t m_globalBudget = 0;
+  uint32_t m_nextId = 1;
+};
+
+} // namespace reactotron
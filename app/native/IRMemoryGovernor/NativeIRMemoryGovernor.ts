@@ -0,0 +1,45 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface MemoryStoreUsage {
+  name: string
+  bytes: number
+  /** 0 if the store has no budget of its own. */
+  budget: number
+  /** When its least recently used data arrived, ms since the epoch; 0 if unknown. */
+  oldest: number
+  evictable: boolean
+  /** Freed by eviction this session. */
+  evictedBytes: number
+  evictions: number
+}
+
+export interface MemoryUsage {
+  globalBudget: number
+  totalBytes: number
+  stores: MemoryStoreUsage[]
+}
+
+export interface MemoryEviction {
+  store: string
+  /** How many bytes the store was asked to free. */
+  bytes: number
+  /** Native stores free memory themselves; the caller carries out the rest. */
+  native: boolean
+}
+
+export interface Spec extends TurboModule {
+  /**
+   * Reports the usage of a store kept in JS. These return a value so they run synchronously,
+   * in order with enforce().
+   */
+  report(store: string, bytes: number, oldest: number, evictable: boolean): number
+  /** 0 removes the budget. */
+  setBudget(store: string, bytes: number): number
+  setGlobalBudget(bytes: number): number
+  /** Brings the stores back within their budgets and returns what each was asked to free. */
+  enforce(): MemoryEviction[]
+  getUsage(): MemoryUsage
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRMemoryGovernor")
@@ -15,36 +15,35 @@ RCT_EXPORT_MODULE()
 
 #pragma mark - API
 
+// The sync reads block the JS thread until the main thread is free to walk the menus; the
+// async ones below don't, so prefer those.
+
 - (NSArray<NSString *> *)getAvailableMenus {
-  __block NSMutableArray<NSString *> *menuNames;
-  dispatch_sync(dispatch_get_main_queue(), ^{
-    menuNames = [NSMutableArray array];
-    NSMenu *mainMenu = [NSApp mainMenu];
-    for (NSMenuItem *item in mainMenu.itemArray) {
-      if (item.title.length > 0) [menuNames addObject:item.title];
-    }
+  __block NSArray<NSString *> *menuNames;
+  RCTUnsafeExecuteOnMainQueueSync(^{
+    menuNames = [self availableMenus];
   });
-  return [menuNames copy];
+  return menuNames;
 }
 
 - (NSArray *)getMenuStructure {
-  __block NSMutableArray *result = [NSMutableArray array];
-
-  dispatch_sync(dispatch_get_main_queue(), ^{
-    NSMenu *mainMenu = [NSApp mainMenu];
-    for (NSMenuItem *menuItem in mainMenu.itemArray) {
-      if (menuItem.title.length == 0 || !menuItem.submenu) continue;
-
-      NSDictionary *entry = @{
-        @"title": menuItem.title,
-        @"items": [self nodesFromMenu:menuItem.submenu parentPath:@[menuItem.title]]
-      };
-      [result addObject:entry];
-    }
+  __block NSArray *result;
+  RCTUnsafeExecuteOnMainQueueSync(^{
+    result = [self menuStructure];
   });
+  return result;
+}
 
-  // Return shape - Array<{ title, items: MenuNode[] }>
-  return [result copy];
+- (void)getAvailableMenusAsync:(RCTPromiseResolveBlock)resolve reject:(RCTPromiseRejectBlock)reject {
+  RCTExecuteOnMainQueue(^{
+    resolve([self availableMenus]);
+  });
+}
+
+- (void)getMenuStructureAsync:(RCTPromiseResolveBlock)resolve reject:(RCTPromiseRejectBlock)reject {
+  RCTExecuteOnMainQueue(^{
+    resolve([self menuStructure]);
+  });
 }
 
 - (void)createMenu:(NSString *)menuName
@@ -211,6 +210,32 @@ RCT_EXPORT_MODULE()
 
 #pragma mark - Helpers
 
+// Call these on the main queue
+
+- (NSArray<NSString *> *)availableMenus {
+  NSMutableArray<NSString *> *menuNames = [NSMutableArray array];
+  for (NSMenuItem *item in [NSApp mainMenu].itemArray) {
+    if (item.title.length > 0) [menuNames addObject:item.title];
+  }
+  return [menuNames copy];
+}
+
+- (NSArray *)menuStructure {
+  NSMutableArray *result = [NSMutableArray array];
+  for (NSMenuItem *menuItem in [NSApp mainMenu].itemArray) {
+    if (menuItem.title.length == 0 || !menuItem.submenu) continue;
+
+    NSDictionary *entry = @{
+      @"title": menuItem.title,
+      @"items": [self nodesFromMenu:menuItem.submenu parentPath:@[menuItem.title]]
+    };
+    [result addObject:entry];
+  }
+
+  // Return shape - Array<{ title, items: MenuNode[] }>
+  return [result copy];
+}
+
 - (NSMenuItem *)findTopLevelMenuByTitle:(NSString *)title {
   NSMenu *mainMenu = [NSApp mainMenu];
   for (NSMenuItem *item in mainMenu.itemArray) {
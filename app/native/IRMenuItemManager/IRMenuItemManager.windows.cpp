@@ -12,6 +12,16 @@ using winrt::reactotron::implementation::IRMenuItemManager;
 
 namespace winrt::reactotron::implementation
 {
+    void IRMenuItemManager::getAvailableMenusAsync(::React::ReactPromise<std::vector<std::string>> &&result) noexcept
+    {
+        result.Resolve(std::vector<std::string>{});
+    }
+
+    void IRMenuItemManager::getMenuStructureAsync(::React::ReactPromise<std::vector<MenuEntry>> &&result) noexcept
+    {
+        result.Resolve(std::vector<MenuEntry>{});
+    }
+
     void IRMenuItemManager::createMenu(std::string menuName,
                                        ::React::ReactPromise<CreateRet> &&result) noexcept
     {
@@ -15,6 +15,14 @@ namespace winrt::reactotron::implementation
         // Only the essential types needed for the event
         using PressEvent = reactotronCodegen::IRMenuItemManagerSpec_MenuItemPressedEvent;
         using CreateRet = reactotronCodegen::IRMenuItemManagerSpec_createMenu_returnType;
+        using MenuEntry = reactotronCodegen::IRMenuItemManagerSpec_MenuEntry;
+
+        // There's no app menu bar here yet, so these resolve empty
+        REACT_METHOD(getAvailableMenusAsync)
+        void getAvailableMenusAsync(::React::ReactPromise<std::vector<std::string>> &&result) noexcept;
+
+        REACT_METHOD(getMenuStructureAsync)
+        void getMenuStructureAsync(::React::ReactPromise<std::vector<MenuEntry>> &&result) noexcept;
 
         // One simple method to test event emission
         REACT_METHOD(createMenu)
@@ -39,8 +39,11 @@ export interface MenuItem {
 export type MenuListEntry = MenuItem | typeof SEPARATOR
 
 export interface Spec extends TurboModule {
+  // These block the JS thread until the main thread is free; prefer the async versions
   getAvailableMenus(): string[]
   getMenuStructure(): MenuStructure
+  getAvailableMenusAsync(): Promise<string[]>
+  getMenuStructureAsync(): Promise<MenuStructure>
   createMenu(menuName: string): Promise<{ success: boolean; existed: boolean; menuName: string }>
   addMenuItemAtPath(
     parentPath: string[],
@@ -0,0 +1,84 @@
+//
+//  IRNetworkStats.mm
+//  Reactotron-macOS
+//
+//  Per-endpoint latency and status aggregates for api.response traffic.
+//
+
+#import "IRNetworkStats.h"
+#import <QuartzCore/QuartzCore.h>
+#include "NetworkStats.h"
+#include <mutex>
+#include <vector>
+
+@implementation IRNetworkStats {
+  reactotron::NetworkStats _stats;
+  std::mutex _statsMutex;
+}
+
+RCT_EXPORT_MODULE()
+
+static int64_t IRNetworkStatsNowMs() {
+  return (int64_t)(CACurrentMediaTime() * 1000.0);
+}
+
+static NSNumber *IRNetworkStatsMillis(uint64_t micros) {
+  return @((double)micros / 1000.0);
+}
+
+- (void)record:(NSString *)method
+           url:(NSString *)url
+        status:(double)status
+    durationMs:(double)durationMs
+  requestBytes:(double)requestBytes
+ responseBytes:(double)responseBytes {
+  const char *methodUtf8 = method.UTF8String ?: "";
+  const char *urlUtf8 = url.UTF8String ?: "";
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  _stats.Record(methodUtf8, urlUtf8, (int)status, durationMs, (uint64_t)MAX(requestBytes, 0),
+                (uint64_t)MAX(responseBytes, 0), IRNetworkStatsNowMs());
+}
+
+- (NSArray<NSDictionary *> *)getSnapshot:(NSString *)window {
+  reactotron::NetworkStatsWindow statsWindow = reactotron::NetworkStatsWindow::Session;
+  if ([window isEqualToString:@"1m"]) statsWindow = reactotron::NetworkStatsWindow::Minute;
+  if ([window isEqualToString:@"5m"]) statsWindow = reactotron::NetworkStatsWindow::FiveMinutes;
+
+  std::vector<reactotron::EndpointSnapshot> snapshots;
+  {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.Snapshot(statsWindow, IRNetworkStatsNowMs(), snapshots);
+  }
+
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:snapshots.size()];
+  for (const auto &snapshot : snapshots) {
+    const auto &stats = snapshot.stats;
+    NSMutableArray<NSNumber *> *statusCounts = [NSMutableArray arrayWithCapacity:stats.statusClasses.size()];
+    for (uint64_t count : stats.statusClasses) [statusCounts addObject:@(count)];
+    [result addObject:@{
+      @"method": [NSString stringWithUTF8String:snapshot.method.c_str()] ?: @"",
+      @"route": [NSString stringWithUTF8String:snapshot.route.c_str()] ?: @"",
+      @"count": @(stats.count),
+      @"errorCount": @(stats.errors),
+      @"p50": IRNetworkStatsMillis(stats.latency.ValueAtPercentile(50)),
+      @"p90": IRNetworkStatsMillis(stats.latency.ValueAtPercentile(90)),
+      @"p99": IRNetworkStatsMillis(stats.latency.ValueAtPercentile(99)),
+      @"max": IRNetworkStatsMillis(stats.latency.Max()),
+      @"statusCounts": statusCounts,
+      @"requestBytes": @(stats.requestBytes),
+      @"responseBytes": @(stats.responseBytes),
+    }];
+  }
+  return result;
+}
+
+- (void)clear {
+  std::lock_guard<std::mutex> lock(_statsMutex);
+  _stats.Clear();
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRNetworkStatsSpecJSI>(params);
+}
+
+@end
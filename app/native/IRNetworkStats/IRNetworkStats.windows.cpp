@@ -0,0 +1,71 @@
+//
+//  IRNetworkStats.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared NetworkStats aggregator
+//
+
+#include "pch.h"
+#include "IRNetworkStats.windows.h"
+#include <windows.h>
+#include <algorithm>
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    namespace
+    {
+        inline int64_t NowMs() noexcept { return static_cast<int64_t>(GetTickCount64()); }
+
+        inline double Millis(uint64_t micros) noexcept { return static_cast<double>(micros) / 1000.0; }
+    }
+
+    void IRNetworkStats::record(std::string method, std::string url, double status, double durationMs, double requestBytes, double responseBytes) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.Record(method, url, static_cast<int>(status), durationMs, static_cast<uint64_t>((std::max)(requestBytes, 0.0)),
+                       static_cast<uint64_t>((std::max)(responseBytes, 0.0)), NowMs());
+    }
+
+    Microsoft::ReactNative::JSValue IRNetworkStats::getSnapshot(std::string window) noexcept
+    {
+        auto statsWindow = ::reactotron::NetworkStatsWindow::Session;
+        if (window == "1m") statsWindow = ::reactotron::NetworkStatsWindow::Minute;
+        if (window == "5m") statsWindow = ::reactotron::NetworkStatsWindow::FiveMinutes;
+
+        std::vector<::reactotron::EndpointSnapshot> snapshots;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats.Snapshot(statsWindow, NowMs(), snapshots);
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (const auto &snapshot : snapshots)
+        {
+            const auto &stats = snapshot.stats;
+            Microsoft::ReactNative::JSValueArray statusCounts;
+            for (uint64_t count : stats.statusClasses) statusCounts.push_back(static_cast<double>(count));
+
+            Microsoft::ReactNative::JSValueObject endpoint;
+            endpoint["method"] = snapshot.method;
+            endpoint["route"] = snapshot.route;
+            endpoint["count"] = static_cast<double>(stats.count);
+            endpoint["errorCount"] = static_cast<double>(stats.errors);
+            endpoint["p50"] = Millis(stats.latency.ValueAtPercentile(50));
+            endpoint["p90"] = Millis(stats.latency.ValueAtPercentile(90));
+            endpoint["p99"] = Millis(stats.latency.ValueAtPercentile(99));
+            endpoint["max"] = Millis(stats.latency.Max());
+            endpoint["statusCounts"] = std::move(statusCounts);
+            endpoint["requestBytes"] = static_cast<double>(stats.requestBytes);
+            endpoint["responseBytes"] = static_cast<double>(stats.responseBytes);
+            result.push_back(std::move(endpoint));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    void IRNetworkStats::clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.Clear();
+    }
+}
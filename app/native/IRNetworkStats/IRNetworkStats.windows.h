@@ -0,0 +1,26 @@
+#pragma once
+#include "NativeModules.h"
+#include "NetworkStats.h"
+#include <mutex>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRNetworkStats)
+    struct IRNetworkStats
+    {
+        IRNetworkStats() noexcept = default;
+
+        REACT_METHOD(record)
+        void record(std::string method, std::string url, double status, double durationMs, double requestBytes, double responseBytes) noexcept;
+
+        REACT_SYNC_METHOD(getSnapshot)
+        Microsoft::ReactNative::JSValue getSnapshot(std::string window) noexcept;
+
+        REACT_METHOD(clear)
+        void clear() noexcept;
+
+    private:
+        ::reactotron::NetworkStats m_stats;
+        std::mutex m_statsMutex;
+    };
+}
@@ -0,0 +1,37 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+/**
+ * Aggregates for one method + route template, e.g. "GET api.example.com/users/:id".
+ * Latencies are in milliseconds, accurate to about 6%.
+ */
+export interface EndpointStats {
+  method: string
+  route: string
+  count: number
+  errorCount: number
+  p50: number
+  p90: number
+  p99: number
+  max: number
+  /** Responses without a status, then 1xx through 5xx. */
+  statusCounts: ReadonlyArray<number>
+  requestBytes: number
+  responseBytes: number
+}
+
+export interface Spec extends TurboModule {
+  record(
+    method: string,
+    url: string,
+    status: number,
+    durationMs: number,
+    requestBytes: number,
+    responseBytes: number,
+  ): void
+  /** `window` is "1m", "5m" or "session". */
+  getSnapshot(window: string): ReadonlyArray<EndpointStats>
+  clear(): void
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRNetworkStats")
@@ -0,0 +1,312 @@
+//
+//  NetworkStats.cpp
+//  Reactotron
+//
+
+#include "NetworkStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+inline unsigned HighestBit(uint64_t value) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+inline bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+inline bool IsHex(char c) noexcept {
+  return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline char ToLower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+inline char ToUpper(char c) noexcept { return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c; }
+
+bool IsUuid(std::string_view segment) noexcept {
+  if (segment.size() != 36) return false;
+  for (size_t i = 0; i < segment.size(); ++i) {
+    bool hyphen = i == 8 || i == 13 || i == 18 || i == 23;
+    if (hyphen ? segment[i] != '-' : !IsHex(segment[i])) return false;
+  }
+  return true;
+}
+
+/**
+ * Returns the placeholder for an id-like path segment, or nullptr to keep it as is.
+ */
+const char *Placeholder(std::string_view segment) noexcept {
+  if (segment.empty()) return nullptr;
+  bool digits = true;
+  bool hex = true;
+  bool anyDigit = false;
+  for (char c : segment) {
+    digits &= IsDigit(c);
+    hex &= IsHex(c);
+    anyDigit |= IsDigit(c);
+  }
+  if (digits) return ":id";
+  // Object ids, hashes and tokens; the digit check keeps long hex-looking words
+  if (hex && anyDigit && segment.size() >= 16) return ":hash";
+  if (IsUuid(segment)) return ":uuid";
+  return nullptr;
+}
+
+} // namespace
+
+std::string NormalizeRoute(std::string_view url) {
+  size_t end = url.find_first_of("?#");
+  if (end != std::string_view::npos) url = url.substr(0, end);
+
+  size_t scheme = url.find("://");
+  if (scheme != std::string_view::npos) url.remove_prefix(scheme + 3);
+
+  std::string route;
+  route.reserve(url.size());
+
+  // Relative URLs start straight at the path
+  size_t pathStart = url.find('/');
+  std::string_view host = url.substr(0, pathStart);
+  size_t userInfo = host.rfind('@');
+  if (userInfo != std::string_view::npos) host.remove_prefix(userInfo + 1);
+  for (char c : host) route.push_back(ToLower(c));
+
+  if (pathStart != std::string_view::npos) {
+    std::string_view path = url.substr(pathStart);
+    size_t i = 0;
+    while (i < path.size()) {
+      size_t next = path.find('/', i);
+      if (next == std::string_view::npos) next = path.size();
+      std::string_view segment = path.substr(i, next - i);
+      if (!segment.empty()) {
+        route.push_back('/');
+        // "42.json" keeps its extension: ":id.json"
+        size_t dot = segment.rfind('.');
+        std::string_view stem = dot == std::string_view::npos || dot == 0 ? segment : segment.substr(0, dot);
+        const char *placeholder = Placeholder(stem);
+        if (placeholder) {
+          route.append(placeholder);
+          route.append(segment.substr(stem.size()));
+        } else {
+          route.append(segment);
+        }
+      }
+      i = next + 1;
+    }
+  }
+
+  if (route.empty() || (pathStart != std::string_view::npos && route.size() == host.size())) {
+    route.push_back('/');
+  }
+  return route;
+}
+
+// LatencyHistogram
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros) noexcept {
+  if (micros < kSubBuckets) return static_cast<size_t>(micros);
+  unsigned msb = HighestBit(micros); // >= 4
+  size_t group = msb - 3;
+  if (group * kSubBuckets >= kBucketCount) return kBucketCount - 1;
+  return group * kSubBuckets + static_cast<size_t>((micros >> (msb - 4)) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) noexcept {
+  size_t group = index / kSubBuckets;
+  uint64_t sub = index % kSubBuckets;
+  return group == 0 ? sub : (kSubBuckets + sub) << (group - 1);
+}
+
+uint64_t LatencyHistogram::BucketWidth(size_t index) noexcept {
+  size_t group = index / kSubBuckets;
+  return group == 0 ? 1 : uint64_t(1) << (group - 1);
+}
+
+void LatencyHistogram::Record(uint64_t micros) noexcept {
+  if (m_buckets.empty()) m_buckets.assign(kBucketCount, 0);
+  m_buckets[BucketIndex(micros)]++;
+  m_count++;
+  m_sum += micros;
+  m_min = std::min(m_min, micros);
+  m_max = std::max(m_max, micros);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  if (other.m_count == 0) return;
+  if (m_buckets.empty()) m_buckets.assign(kBucketCount, 0);
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    m_buckets[i] += other.m_buckets[i];
+  }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::Clear() noexcept {
+  // Keep the storage: slots are cleared and refilled as the windows rotate
+  if (m_count) std::fill(m_buckets.begin(), m_buckets.end(), 0);
+  m_count = 0;
+  m_sum = 0;
+  m_min = UINT64_MAX;
+  m_max = 0;
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const noexcept {
+  if (m_count == 0) return 0;
+  double clamped = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(m_count)));
+  target = std::min(std::max<uint64_t>(target, 1), m_count);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += m_buckets[i];
+    if (seen >= target) {
+      uint64_t value = BucketLowerBound(i) + BucketWidth(i) / 2;
+      return std::min(std::max(value, m_min), m_max);
+    }
+  }
+  return m_max;
+}
+
+// EndpointStats
+
+void EndpointStats::Record(int status, uint64_t micros, uint64_t requestSize, uint64_t responseSize) noexcept {
+  size_t statusClass = status >= 100 && status < 600 ? static_cast<size_t>(status / 100) : 0;
+  count++;
+  statusClasses[statusClass]++;
+  if (statusClass == 0 || statusClass >= 4) errors++;
+  requestBytes += requestSize;
+  responseBytes += responseSize;
+  latency.Record(micros);
+}
+
+void EndpointStats::Merge(const EndpointStats &other) {
+  if (other.count == 0) return;
+  count += other.count;
+  errors += other.errors;
+  for (size_t i = 0; i < statusClasses.size(); ++i) {
+    statusClasses[i] += other.statusClasses[i];
+  }
+  requestBytes += other.requestBytes;
+  responseBytes += other.responseBytes;
+  latency.Merge(other.latency);
+}
+
+void EndpointStats::Clear() noexcept {
+  count = 0;
+  errors = 0;
+  statusClasses.fill(0);
+  requestBytes = 0;
+  responseBytes = 0;
+  latency.Clear();
+}
+
+// NetworkStats
+
+NetworkStats::NetworkStats(size_t maxRoutes) : m_maxRoutes(std::max<size_t>(maxRoutes, 1)) {}
+
+template <size_t N>
+EndpointStats &NetworkStats::Slot(SlotRing<N> &ring, int64_t slotMs, int64_t nowMs) {
+  int64_t slot = nowMs >= 0 ? nowMs / slotMs : (nowMs - slotMs + 1) / slotMs;
+  size_t index = static_cast<size_t>(((slot % static_cast<int64_t>(N)) + N) % N);
+  int64_t start = slot * slotMs;
+  if (ring.starts[index] != start) {
+    ring.slots[index].Clear();
+    ring.starts[index] = start;
+  }
+  return ring.slots[index];
+}
+
+template <size_t N>
+void NetworkStats::MergeWindow(const SlotRing<N> &ring, int64_t slotMs, int64_t windowMs, int64_t nowMs,
+                               EndpointStats &out) {
+  int64_t slot = nowMs >= 0 ? nowMs / slotMs : (nowMs - slotMs + 1) / slotMs;
+  int64_t current = slot * slotMs;
+  for (size_t i = 0; i < N; ++i) {
+    int64_t start = ring.starts[i];
+    if (start != INT64_MIN && start <= current && start > current - windowMs) {
+      out.Merge(ring.slots[i]);
+    }
+  }
+}
+
+NetworkStats::Endpoint &NetworkStats::Lookup(std::string_view method, std::string_view url) {
+  std::string route = NormalizeRoute(url);
+
+  m_key.clear();
+  for (char c : method) m_key.push_back(ToUpper(c));
+  if (m_key.empty()) m_key = "GET";
+  size_t methodLength = m_key.size();
+  m_key.push_back(' ');
+  m_key.append(route);
+
+  auto it = m_index.find(m_key);
+  if (it != m_index.end()) return *m_endpoints[it->second];
+
+  if (m_endpoints.size() >= m_maxRoutes) {
+    // Past the cap everything shares one bucket, so memory stays bounded
+    m_key = std::string("* ") + kOverflowRoute;
+    it = m_index.find(m_key);
+    if (it != m_index.end()) return *m_endpoints[it->second];
+    methodLength = 1;
+    route = kOverflowRoute;
+  }
+
+  auto endpoint = std::make_unique<Endpoint>();
+  endpoint->method = m_key.substr(0, methodLength);
+  endpoint->route = std::move(route);
+  m_index.emplace(m_key, m_endpoints.size());
+  m_endpoints.push_back(std::move(endpoint));
+  return *m_endpoints.back();
+}
+
+void NetworkStats::Record(std::string_view method, std::string_view url, int status, double durationMs,
+                          uint64_t requestBytes, uint64_t responseBytes, int64_t nowMs) {
+  uint64_t micros = durationMs > 0 && std::isfinite(durationMs) ? static_cast<uint64_t>(std::llround(durationMs * 1000.0)) : 0;
+  Endpoint &endpoint = Lookup(method, url);
+  endpoint.session.Record(status, micros, requestBytes, responseBytes);
+  Slot(endpoint.shortSlots, kShortSlotMs, nowMs).Record(status, micros, requestBytes, responseBytes);
+  Slot(endpoint.longSlots, kLongSlotMs, nowMs).Record(status, micros, requestBytes, responseBytes);
+}
+
+void NetworkStats::Snapshot(NetworkStatsWindow window, int64_t nowMs, std::vector<EndpointSnapshot> &out) const {
+  for (const auto &endpoint : m_endpoints) {
+    EndpointSnapshot snapshot;
+    switch (window) {
+    case NetworkStatsWindow::Minute:
+      MergeWindow(endpoint->shortSlots, kShortSlotMs, 60 * 1000, nowMs, snapshot.stats);
+      break;
+    case NetworkStatsWindow::FiveMinutes:
+      MergeWindow(endpoint->longSlots, kLongSlotMs, 5 * 60 * 1000, nowMs, snapshot.stats);
+      break;
+    case NetworkStatsWindow::Session:
+      snapshot.stats = endpoint->session;
+      break;
+    }
+    if (snapshot.stats.count == 0) continue;
+    snapshot.method = endpoint->method;
+    snapshot.route = endpoint->route;
+    out.push_back(std::move(snapshot));
+  }
+}
+
+void NetworkStats::Clear() {
+  m_index.clear();
+  m_endpoints.clear();
+}
+
+} // namespace reactotron
@@ -0,0 +1,145 @@
+#pragma once
+
+//
+//  NetworkStats.h
+//  Reactotron
+//
+//  Streaming per-endpoint aggregates for api.response traffic: latency
+//  histograms, status-class and payload-size counters, for the whole session
+//  and for sliding 1 and 5 minute windows. Memory is bounded by the number of
+//  distinct routes (capped), not by the number of responses.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+/**
+ * Collapses a URL into a route template: drops the scheme, query and fragment,
+ * lowercases the host and replaces id-like path segments with placeholders.
+ * "https://api.example.com/users/42/posts?page=2" -> "api.example.com/users/:id/posts"
+ *
+ * Placeholders: ":id" for integers, ":uuid" for UUIDs, ":hash" for long hex strings.
+ */
+std::string NormalizeRoute(std::string_view url);
+
+/**
+ * Log-linear histogram of durations in microseconds, HDR style: 16 linear buckets
+ * per power of two, so any recorded value is reported within 6.25%. Histograms
+ * merge by adding counts. Storage is allocated on the first Record().
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBuckets = 16;
+  static constexpr size_t kBucketCount = 32 * kSubBuckets; // Up to 2^35us, about 9.5 hours
+
+  void Record(uint64_t micros) noexcept;
+  void Merge(const LatencyHistogram &other);
+  void Clear() noexcept;
+
+  uint64_t Count() const noexcept { return m_count; }
+  uint64_t Min() const noexcept { return m_count ? m_min : 0; }
+  uint64_t Max() const noexcept { return m_max; }
+  uint64_t Sum() const noexcept { return m_sum; }
+
+  /** The value at `percentile` (0-100), as the midpoint of its bucket. */
+  uint64_t ValueAtPercentile(double percentile) const noexcept;
+
+  static size_t BucketIndex(uint64_t micros) noexcept;
+  static uint64_t BucketLowerBound(size_t index) noexcept;
+  static uint64_t BucketWidth(size_t index) noexcept;
+
+ private:
+  std::vector<uint32_t> m_buckets;
+  uint64_t m_count = 0;
+  uint64_t m_sum = 0;
+  uint64_t m_min = UINT64_MAX;
+  uint64_t m_max = 0;
+};
+
+struct EndpointStats {
+  uint64_t count = 0;
+  uint64_t errors = 0; // No status, or 4xx/5xx
+  // Index 0 is responses without a status, then 1xx through 5xx
+  std::array<uint64_t, 6> statusClasses = {};
+  uint64_t requestBytes = 0;
+  uint64_t responseBytes = 0;
+  LatencyHistogram latency;
+
+  void Record(int status, uint64_t micros, uint64_t requestSize, uint64_t responseSize) noexcept;
+  void Merge(const EndpointStats &other);
+  void Clear() noexcept;
+};
+
+struct EndpointSnapshot {
+  std::string method;
+  std::string route;
+  EndpointStats stats;
+};
+
+enum class NetworkStatsWindow { Minute, FiveMinutes, Session };
+
+/**
+ * The aggregation engine. Windows are built from fixed time slots (10s for the
+ * 1 minute window, 1m for the 5 minute one), so they are accurate to one slot.
+ * Once `maxRoutes` distinct method+route pairs have been seen, new ones are
+ * counted under the route "(other)".
+ *
+ * Not thread-safe.
+ */
+class NetworkStats {
+ public:
+  explicit NetworkStats(size_t maxRoutes = 256);
+
+  void Record(std::string_view method, std::string_view url, int status, double durationMs,
+              uint64_t requestBytes, uint64_t responseBytes, int64_t nowMs);
+
+  /** Appends one snapshot per endpoint with traffic in `window`, in first-seen order. */
+  void Snapshot(NetworkStatsWindow window, int64_t nowMs, std::vector<EndpointSnapshot> &out) const;
+
+  size_t EndpointCount() const noexcept { return m_endpoints.size(); }
+  void Clear();
+
+  static constexpr const char *kOverflowRoute = "(other)";
+
+ private:
+  template <size_t N>
+  struct SlotRing {
+    std::array<EndpointStats, N> slots;
+    std::array<int64_t, N> starts;
+    SlotRing() { starts.fill(INT64_MIN); }
+  };
+
+  static constexpr int64_t kShortSlotMs = 10 * 1000;
+  static constexpr int64_t kLongSlotMs = 60 * 1000;
+
+  struct Endpoint {
+    std::string method;
+    std::string route;
+    EndpointStats session;
+    SlotRing<6> shortSlots; // 1 minute in 10 second slots
+    SlotRing<5> longSlots;  // 5 minutes in 1 minute slots
+  };
+
+  template <size_t N>
+  static EndpointStats &Slot(SlotRing<N> &ring, int64_t slotMs, int64_t nowMs);
+  template <size_t N>
+  static void MergeWindow(const SlotRing<N> &ring, int64_t slotMs, int64_t windowMs, int64_t nowMs,
+                          EndpointStats &out);
+
+  Endpoint &Lookup(std::string_view method, std::string_view url);
+
+  size_t m_maxRoutes;
+  std::unordered_map<std::string, size_t> m_index; // "METHOD route" -> m_endpoints index
+  std::vector<std::unique_ptr<Endpoint>> m_endpoints;
+  std::string m_key; // Reused lookup buffer
+};
+
+} // namespace reactotron
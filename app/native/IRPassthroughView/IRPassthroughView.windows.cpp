@@ -7,6 +7,9 @@
 namespace winrt::reactotron::implementation {
 
 std::vector<IRPassthroughView*> IRPassthroughView::s_instances;
+::reactotron::PassthroughRegionTracker IRPassthroughView::s_regions;
+HWND IRPassthroughView::s_hwnd = nullptr;
+winrt::Microsoft::UI::Input::InputNonClientPointerSource IRPassthroughView::s_nonClientInputSrc{nullptr};
 
 IRPassthroughView::IRPassthroughView() {
   s_instances.push_back(this);
@@ -20,7 +23,7 @@ IRPassthroughView::~IRPassthroughView() {
   if (it != s_instances.end()) {
     s_instances.erase(it);
     DebugLog("Destructor fallback cleanup - this should rarely happen");
-    UpdateAllPassthroughRegions();
+    UntrackPassthroughRect();
   }
 }
 
@@ -47,7 +50,7 @@ void IRPassthroughView::Initialize(const winrt::Microsoft::ReactNative::Componen
       [wkThis = get_weak()](
           const winrt::IInspectable & /*sender*/, const winrt::Microsoft::ReactNative::LayoutMetricsChangedArgs &args) {
         if (auto strongThis = wkThis.get()) {
-          UpdateAllPassthroughRegions();
+          strongThis->TrackPassthroughRect();
         }
       });
 }
@@ -62,7 +65,7 @@ void IRPassthroughView::UnmountChildComponentView(const winrt::Microsoft::ReactN
     if (it != s_instances.end()) {
       s_instances.erase(it);
       DebugLog("Component unmounted - cleaned up passthrough region");
-      UpdateAllPassthroughRegions();
+      UntrackPassthroughRect();
     }
   }
 }
@@ -93,65 +96,127 @@ winrt::Windows::Graphics::RectInt32 IRPassthroughView::GetPassthroughRect() cons
   }
 }
 
-void IRPassthroughView::UpdateAllPassthroughRegions() noexcept {
+void IRPassthroughView::TrackPassthroughRect() noexcept {
+  auto rect = GetPassthroughRect();
+  if (s_regions.Update(reinterpret_cast<uintptr_t>(this), {rect.X, rect.Y, rect.Width, rect.Height})) {
+    SchedulePassthroughFlush();
+  }
+}
+
+void IRPassthroughView::UntrackPassthroughRect() noexcept {
+  if (s_regions.Remove(reinterpret_cast<uintptr_t>(this))) {
+    SchedulePassthroughFlush();
+  }
+}
+
+void IRPassthroughView::SchedulePassthroughFlush() noexcept {
+  // Layout passes fire LayoutMetricsChanged for every instance back to back. Enqueue a single
+  // low-priority flush so all of them land in one SetRegionRects call after layout settles.
   try {
-    // Find the main application window by enumerating all windows for this process
-    HWND hwnd = nullptr;
-    EnumWindows([](HWND h, LPARAM p) -> BOOL {
-      DWORD pid = 0;
-      GetWindowThreadProcessId(h, &pid);
-      if (pid == GetCurrentProcessId() && IsWindowVisible(h) && !GetParent(h)) {
-        *reinterpret_cast<HWND*>(p) = h;
-        return FALSE;
-      }
-      return TRUE;
-    }, reinterpret_cast<LPARAM>(&hwnd));
-
-    if (!hwnd) {
-      DebugLog("Application window not found");
+    auto queue = winrt::Microsoft::UI::Dispatching::DispatcherQueue::GetForCurrentThread();
+    if (queue && queue.TryEnqueue(winrt::Microsoft::UI::Dispatching::DispatcherQueuePriority::Low,
+                                  []() { FlushPassthroughRegions(); })) {
       return;
     }
+  } catch (...) {
+    DebugLog("Failed to enqueue passthrough flush - flushing inline");
+  }
+  FlushPassthroughRegions();
+}
 
+winrt::Microsoft::UI::Input::InputNonClientPointerSource IRPassthroughView::GetNonClientInputSource() noexcept {
+  // The cached handle stays valid for the lifetime of the window; only rediscover it when it's gone.
+  if (s_hwnd && IsWindow(s_hwnd) && s_nonClientInputSrc) {
+    return s_nonClientInputSrc;
+  }
+
+  s_hwnd = nullptr;
+  s_nonClientInputSrc = nullptr;
+
+  // Find the main application window by enumerating all windows for this process
+  HWND hwnd = nullptr;
+  EnumWindows([](HWND h, LPARAM p) -> BOOL {
+    DWORD pid = 0;
+    GetWindowThreadProcessId(h, &pid);
+    if (pid == GetCurrentProcessId() && IsWindowVisible(h) && !GetParent(h)) {
+      *reinterpret_cast<HWND*>(p) = h;
+      return FALSE;
+    }
+    return TRUE;
+  }, reinterpret_cast<LPARAM>(&hwnd));
+
+  if (!hwnd) {
+    DebugLog("Application window not found");
+    return nullptr;
+  }
+
+  try {
     // Get Windows App SDK components needed for passthrough region management
     auto windowId = winrt::Microsoft::UI::GetWindowIdFromWindow(hwnd);
     auto appWindow = winrt::Microsoft::UI::Windowing::AppWindow::GetFromWindowId(windowId);
     if (!appWindow) {
       DebugLog("Failed to get AppWindow from window handle");
-      return;
+      return nullptr;
     }
 
     auto nonClientInputSrc = winrt::Microsoft::UI::Input::InputNonClientPointerSource::GetForWindowId(appWindow.Id());
     if (!nonClientInputSrc) {
       DebugLog("Failed to get InputNonClientPointerSource");
+      return nullptr;
+    }
+
+    s_hwnd = hwnd;
+    s_nonClientInputSrc = nonClientInputSrc;
+  } catch (...) {
+    DebugLog("Exception resolving InputNonClientPointerSource");
+    return nullptr;
+  }
+
+  // A new window starts without our regions, so whatever we pushed before no longer applies
+  s_regions.ForgetLastPushed();
+  return s_nonClientInputSrc;
+}
+
+void IRPassthroughView::FlushPassthroughRegions() noexcept {
+  try {
+    auto nonClientInputSrc = GetNonClientInputSource();
+
+    std::vector<::reactotron::PassthroughRect> merged;
+    if (!s_regions.Flush(merged)) {
+      // Nothing changed since the last push
       return;
     }
 
-    // CRITICAL: Clear only passthrough regions, not all regions (which would break title bar dragging)
-    // This prevents accumulation of stale regions from unmounted components
-    nonClientInputSrc.ClearRegionRects(winrt::Microsoft::UI::Input::NonClientRegionKind::Passthrough);
+    if (!nonClientInputSrc) {
+      // Try again with the next layout change once the window exists
+      s_regions.ForgetLastPushed();
+      return;
+    }
+
+    // CRITICAL: Only touch passthrough regions, not all regions (which would break title bar dragging)
+    if (merged.empty()) {
+      nonClientInputSrc.ClearRegionRects(winrt::Microsoft::UI::Input::NonClientRegionKind::Passthrough);
+      return;
+    }
 
-    // Collect rectangles from all currently mounted PassthroughView instances
     std::vector<winrt::Windows::Graphics::RectInt32> passthroughRects;
-    for (auto* instance : s_instances) {
-      if (instance && instance->m_view) {
-        auto rect = instance->GetPassthroughRect();
-        if (rect.Width > 0 && rect.Height > 0) {
-          passthroughRects.push_back(rect);
-        }
-      }
+    passthroughRects.reserve(merged.size());
+    for (const auto &rect : merged) {
+      passthroughRects.push_back({rect.x, rect.y, rect.width, rect.height});
     }
 
-    // Apply the complete new set of passthrough regions to Windows
     // SetRegionRects replaces ALL existing passthrough regions with this new set
-    if (!passthroughRects.empty()) {
-      nonClientInputSrc.SetRegionRects(
-        winrt::Microsoft::UI::Input::NonClientRegionKind::Passthrough,
-        passthroughRects
-      );
-    }
+    nonClientInputSrc.SetRegionRects(
+      winrt::Microsoft::UI::Input::NonClientRegionKind::Passthrough,
+      passthroughRects
+    );
 
   } catch (...) {
-    DebugLog("Exception in UpdateAllPassthroughRegions");
+    DebugLog("Exception in FlushPassthroughRegions");
+    // Drop the cached window so the next flush rediscovers it and pushes the full set again
+    s_hwnd = nullptr;
+    s_nonClientInputSrc = nullptr;
+    s_regions.ForgetLastPushed();
   }
 }
 
@@ -5,6 +5,8 @@
 #include <winrt/Microsoft.UI.h>
 #include <winrt/Microsoft.UI.Windowing.h>
 #include <winrt/Microsoft.UI.Input.h>
+#include <winrt/Microsoft.UI.Dispatching.h>
+#include "PassthroughRegions.h"
 
 
 namespace winrt::reactotron::implementation
@@ -31,7 +33,19 @@ namespace winrt::reactotron::implementation
         winrt::Microsoft::ReactNative::ComponentView m_view{nullptr};
 
         static std::vector<IRPassthroughView*> s_instances;
-        static void UpdateAllPassthroughRegions() noexcept;
+
+        // Merged passthrough rects for all instances, pushed to Windows at most once per frame
+        static ::reactotron::PassthroughRegionTracker s_regions;
+
+        // Cached so layout updates don't re-enumerate top-level windows every time
+        static HWND s_hwnd;
+        static winrt::Microsoft::UI::Input::InputNonClientPointerSource s_nonClientInputSrc;
+
+        void TrackPassthroughRect() noexcept;
+        void UntrackPassthroughRect() noexcept;
+        static void SchedulePassthroughFlush() noexcept;
+        static void FlushPassthroughRegions() noexcept;
+        static winrt::Microsoft::UI::Input::InputNonClientPointerSource GetNonClientInputSource() noexcept;
 
         winrt::Windows::Graphics::RectInt32 GetPassthroughRect() const noexcept;
 
@@ -0,0 +1,117 @@
+//
+//  PassthroughRegions.cpp
+//  Reactotron
+//
+
+#include "PassthroughRegions.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace reactotron {
+
+bool RectContains(const PassthroughRect &outer, const PassthroughRect &inner) noexcept {
+  return outer.x <= inner.x && outer.y <= inner.y && outer.right() >= inner.right() &&
+         outer.bottom() >= inner.bottom();
+}
+
+bool TryMergeRects(const PassthroughRect &a, const PassthroughRect &b, PassthroughRect &merged) noexcept {
+  if (RectContains(a, b)) {
+    merged = a;
+    return true;
+  }
+  if (RectContains(b, a)) {
+    merged = b;
+    return true;
+  }
+
+  // Same column, overlapping or touching vertically.
+  if (a.x == b.x && a.width == b.width && a.y <= b.bottom() && b.y <= a.bottom()) {
+    int32_t top = std::min(a.y, b.y);
+    merged = {a.x, top, a.width, std::max(a.bottom(), b.bottom()) - top};
+    return true;
+  }
+
+  // Same row, overlapping or touching horizontally.
+  if (a.y == b.y && a.height == b.height && a.x <= b.right() && b.x <= a.right()) {
+    int32_t left = std::min(a.x, b.x);
+    merged = {left, a.y, std::max(a.right(), b.right()) - left, a.height};
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<PassthroughRect> CoalesceRects(std::vector<PassthroughRect> rects) {
+  rects.erase(std::remove_if(rects.begin(), rects.end(), [](const PassthroughRect &r) { return r.empty(); }),
+              rects.end());
+
+  // There are only ever a handful of passthrough views, so a quadratic fixpoint is
+  // cheaper than anything cleverer. Every merge shrinks the list, so this terminates.
+  bool mergedAny = true;
+  while (mergedAny && rects.size() > 1) {
+    mergedAny = false;
+    for (size_t i = 0; i < rects.size() && !mergedAny; i++) {
+      for (size_t j = i + 1; j < rects.size(); j++) {
+        PassthroughRect merged;
+        if (TryMergeRects(rects[i], rects[j], merged)) {
+          rects[i] = merged;
+          rects.erase(rects.begin() + j);
+          mergedAny = true;
+          break;
+        }
+      }
+    }
+  }
+
+  std::sort(rects.begin(), rects.end(), [](const PassthroughRect &a, const PassthroughRect &b) {
+    return std::tie(a.y, a.x, a.height, a.width) < std::tie(b.y, b.x, b.height, b.width);
+  });
+  return rects;
+}
+
+bool PassthroughRegionTracker::Update(InstanceId id, const PassthroughRect &rect) {
+  auto it = m_rects.find(id);
+  if (it != m_rects.end() && it->second == rect) return false;
+  m_rects[id] = rect;
+  return MarkDirty();
+}
+
+bool PassthroughRegionTracker::Remove(InstanceId id) {
+  if (m_rects.erase(id) == 0) return false;
+  return MarkDirty();
+}
+
+bool PassthroughRegionTracker::Invalidate() {
+  ForgetLastPushed();
+  return MarkDirty();
+}
+
+void PassthroughRegionTracker::ForgetLastPushed() noexcept {
+  m_lastPushed.clear();
+  m_forcePush = true;
+}
+
+bool PassthroughRegionTracker::Flush(std::vector<PassthroughRect> &out) {
+  m_flushPending = false;
+
+  std::vector<PassthroughRect> current;
+  current.reserve(m_rects.size());
+  for (const auto &entry : m_rects) current.push_back(entry.second);
+  current = CoalesceRects(std::move(current));
+
+  if (!m_forcePush && current == m_lastPushed) return false;
+
+  m_forcePush = false;
+  m_lastPushed = current;
+  out = std::move(current);
+  return true;
+}
+
+bool PassthroughRegionTracker::MarkDirty() {
+  if (m_flushPending) return false;
+  m_flushPending = true;
+  return true;
+}
+
+} // namespace reactotron
@@ -0,0 +1,116 @@
+#pragma once
+
+//
+//  PassthroughRegions.h
+//  Reactotron
+//
+//  Platform-independent bookkeeping for titlebar passthrough regions.
+//  IRPassthroughView feeds it one rect per mounted instance and only pushes
+//  the merged set to Windows when it actually changed.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct PassthroughRect {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t width = 0;
+  int32_t height = 0;
+
+  bool empty() const noexcept { return width <= 0 || height <= 0; }
+  int32_t right() const noexcept { return x + width; }
+  int32_t bottom() const noexcept { return y + height; }
+
+  bool operator==(const PassthroughRect &other) const noexcept {
+    return x == other.x && y == other.y && width == other.width && height == other.height;
+  }
+  bool operator!=(const PassthroughRect &other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * Returns true if `outer` fully covers `inner`.
+ */
+bool RectContains(const PassthroughRect &outer, const PassthroughRect &inner) noexcept;
+
+/**
+ * If the union of `a` and `b` is exactly a rectangle (they share an edge span and
+ * overlap or touch along the other axis, or one contains the other), writes it to
+ * `merged` and returns true. Never grows the covered area beyond a ∪ b, so hit
+ * testing in the titlebar is unchanged.
+ */
+bool TryMergeRects(const PassthroughRect &a, const PassthroughRect &b, PassthroughRect &merged) noexcept;
+
+/**
+ * Drops empty rects, removes rects covered by another, merges pairs whose union is a
+ * rectangle until nothing else merges, and returns the result in a canonical
+ * (y, x, height, width) order so two sets can be compared with ==.
+ */
+std::vector<PassthroughRect> CoalesceRects(std::vector<PassthroughRect> rects);
+
+/**
+ * Tracks the passthrough rect of every mounted instance and coalesces layout updates
+ * into a single flush.
+ *
+ * Typical use from the UI thread:
+ *
+ *   if (tracker.Update(id, rect)) scheduleFlushOnce();  // any number of times per frame
+ *   ...
+ *   std::vector<PassthroughRect> rects;
+ *   if (tracker.Flush(rects)) pushToWindows(rects);       // once per frame
+ *
+ * Not thread-safe; all calls are expected on the thread that owns the views.
+ */
+class PassthroughRegionTracker {
+ public:
+  using InstanceId = uintptr_t;
+
+  /**
+   * Records the latest rect for an instance. Returns true if this call turned a clean
+   * tracker dirty, i.e. the caller should schedule a flush. Returns false if the rect
+   * didn't change or a flush is already pending.
+   */
+  bool Update(InstanceId id, const PassthroughRect &rect);
+
+  /**
+   * Forgets an instance. Same return semantics as Update().
+   */
+  bool Remove(InstanceId id);
+
+  /**
+   * Marks the tracker dirty and forces the next Flush() to report the merged set even
+   * if it didn't change, e.g. after the host window was recreated. Same return
+   * semantics as Update().
+   */
+  bool Invalidate();
+
+  /**
+   * Forces the next Flush() to report the merged set without scheduling anything.
+   * Use when a push failed and Windows may be out of sync with LastPushed().
+   */
+  void ForgetLastPushed() noexcept;
+
+  /**
+   * Clears the pending flag and, if the merged set differs from the last one returned,
+   * writes it to `out` and returns true.
+   */
+  bool Flush(std::vector<PassthroughRect> &out);
+
+  bool IsFlushPending() const noexcept { return m_flushPending; }
+  size_t InstanceCount() const noexcept { return m_rects.size(); }
+  const std::vector<PassthroughRect> &LastPushed() const noexcept { return m_lastPushed; }
+
+ private:
+  bool MarkDirty();
+
+  std::unordered_map<InstanceId, PassthroughRect> m_rects;
+  std::vector<PassthroughRect> m_lastPushed;
+  bool m_flushPending = false;
+  bool m_forcePush = false;
+};
+
+} // namespace reactotron
@@ -0,0 +1,81 @@
+//
+//  IRPayloadArena.mm
+//  Reactotron-macOS
+//
+//  Compact storage for timeline payloads, materialized on demand. The relay's
+//  ingest workers store them; JS reads and releases them by handle.
+//
+
+#import "IRPayloadArena.h"
+#include "PayloadArena.h"
+#include <mutex>
+#include <string>
+
+@implementation IRPayloadArena
+
+RCT_EXPORT_MODULE()
+
+static std::string_view IRPayloadArenaView(NSString *string) {
+  const char *utf8 = string.UTF8String;
+  return utf8 ? std::string_view(utf8) : std::string_view();
+}
+
+- (NSNumber *)store:(NSString *)json {
+  auto &shared = reactotron::SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  return @(shared.arena.Store(IRPayloadArenaView(json)));
+}
+
+- (NSString *)materialize:(double)handle {
+  std::string json;
+  {
+    auto &shared = reactotron::SharedPayloadArena::Get();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (!shared.arena.Materialize(static_cast<uint32_t>(handle), json)) return @"";
+  }
+  return [[NSString alloc] initWithBytes:json.data() length:json.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+- (NSNumber *)contains:(double)handle needle:(NSString *)needle {
+  auto &shared = reactotron::SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  return @(shared.arena.Contains(static_cast<uint32_t>(handle), IRPayloadArenaView(needle)));
+}
+
+- (NSNumber *)releasePayloads:(NSArray *)handles {
+  auto &shared = reactotron::SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  size_t before = shared.arena.Stats().payloads;
+  for (NSNumber *handle in handles) shared.arena.Release(handle.unsignedIntValue);
+  return @(before - shared.arena.Stats().payloads);
+}
+
+- (NSNumber *)clear {
+  auto &shared = reactotron::SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  size_t released = shared.arena.Stats().payloads;
+  shared.arena.Clear();
+  return @(released);
+}
+
+- (NSDictionary *)getStats {
+  reactotron::PayloadArenaStats stats;
+  {
+    auto &shared = reactotron::SharedPayloadArena::Get();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    stats = shared.arena.Stats();
+  }
+  return @{
+    @"payloads": @(stats.payloads),
+    @"strings": @(stats.strings),
+    @"shapes": @(stats.shapes),
+    @"payloadBytes": @(stats.payloadBytes),
+    @"allocatedBytes": @(stats.allocatedBytes),
+  };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRPayloadArenaSpecJSI>(params);
+}
+
+@end
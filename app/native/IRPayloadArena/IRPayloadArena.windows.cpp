@@ -0,0 +1,71 @@
+//
+//  IRPayloadArena.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared PayloadArena
+//
+
+#include "pch.h"
+#include "IRPayloadArena.windows.h"
+
+namespace winrt::reactotron::implementation
+{
+    double IRPayloadArena::store(std::string json) noexcept
+    {
+        auto &shared = ::reactotron::SharedPayloadArena::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        return static_cast<double>(shared.arena.Store(json));
+    }
+
+    std::string IRPayloadArena::materialize(double handle) noexcept
+    {
+        std::string json;
+        auto &shared = ::reactotron::SharedPayloadArena::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.arena.Materialize(static_cast<uint32_t>(handle), json);
+        return json;
+    }
+
+    bool IRPayloadArena::contains(double handle, std::string needle) noexcept
+    {
+        auto &shared = ::reactotron::SharedPayloadArena::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        return shared.arena.Contains(static_cast<uint32_t>(handle), needle);
+    }
+
+    double IRPayloadArena::releasePayloads(std::vector<double> handles) noexcept
+    {
+        auto &shared = ::reactotron::SharedPayloadArena::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        size_t before = shared.arena.Stats().payloads;
+        for (double handle : handles) shared.arena.Release(static_cast<uint32_t>(handle));
+        return static_cast<double>(before - shared.arena.Stats().payloads);
+    }
+
+    double IRPayloadArena::clear() noexcept
+    {
+        auto &shared = ::reactotron::SharedPayloadArena::Get();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        size_t released = shared.arena.Stats().payloads;
+        shared.arena.Clear();
+        return static_cast<double>(released);
+    }
+
+    Microsoft::ReactNative::JSValue IRPayloadArena::getStats() noexcept
+    {
+        ::reactotron::PayloadArenaStats stats;
+        {
+            auto &shared = ::reactotron::SharedPayloadArena::Get();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            stats = shared.arena.Stats();
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["payloads"] = static_cast<double>(stats.payloads);
+        result["strings"] = static_cast<double>(stats.strings);
+        result["shapes"] = static_cast<double>(stats.shapes);
+        result["payloadBytes"] = static_cast<double>(stats.payloadBytes);
+        result["allocatedBytes"] = static_cast<double>(stats.allocatedBytes);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "NativeModules.h"
+#include "PayloadArena.h"
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRPayloadArena)
+    struct IRPayloadArena
+    {
+        IRPayloadArena() noexcept = default;
+
+        REACT_SYNC_METHOD(store)
+        double store(std::string json) noexcept;
+
+        REACT_SYNC_METHOD(materialize)
+        std::string materialize(double handle) noexcept;
+
+        REACT_SYNC_METHOD(contains)
+        bool contains(double handle, std::string needle) noexcept;
+
+        REACT_SYNC_METHOD(releasePayloads)
+        double releasePayloads(std::vector<double> handles) noexcept;
+
+        REACT_SYNC_METHOD(clear)
+        double clear() noexcept;
+
+        REACT_SYNC_METHOD(getStats)
+        Microsoft::ReactNative::JSValue getStats() noexcept;
+    };
+}
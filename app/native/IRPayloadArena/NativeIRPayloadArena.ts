@@ -0,0 +1,35 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface PayloadArenaStats {
+  payloads: number
+  /** Interned keys and repeated short values. */
+  strings: number
+  /** Distinct object layouts. */
+  shapes: number
+  /** Size of the stored payloads. */
+  payloadBytes: number
+  /** Everything the arena holds, including its string and shape tables. */
+  allocatedBytes: number
+}
+
+export interface Spec extends TurboModule {
+  /** Stores a payload's JSON and returns its handle, or 0 if it isn't valid JSON. */
+  store(json: string): number
+  /** The payload's JSON, or "" if the handle was released. */
+  materialize(handle: number): string
+  /**
+   * True if one of the payload's values contains `needle` (lower case), ignoring ASCII case.
+   * Keys are not searched.
+   */
+  contains(handle: number, needle: string): boolean
+  /**
+   * Returns how many payloads were released. These return a value so they run
+   * synchronously, in order with store().
+   */
+  releasePayloads(handles: ReadonlyArray<number>): number
+  clear(): number
+  getStats(): PayloadArenaStats
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRPayloadArena")
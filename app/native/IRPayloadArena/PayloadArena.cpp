@@ -0,0 +1,583 @@
+//
+//  PayloadArena.cpp
+//  Reactotron
+//
+
+#include "PayloadArena.h"
+#include "../IRLogStats/LogStats.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kBlockSize = 256 * 1024;
+constexpr size_t kLargePayloadSize = kBlockSize / 4; // Gets a block of its own
+constexpr size_t kSeenValuesSize = 16 * 1024;
+constexpr uint64_t kShapeSeed = 0x5BD1E9955BD1E995ull;
+constexpr size_t kMaxIntegerDigits = 15; // Always exact as a double
+
+enum Tag : uint8_t {
+  kNull,
+  kFalse,
+  kTrue,
+  kInteger,   // Zigzag varint
+  kNumber,    // Varint length, then the number's JSON text
+  kString,    // Varint length, then the raw text between the quotes
+  kStringRef, // Varint string id
+  kArray,     // Varint count, then the elements
+  kObject,    // Varint shape id, then the values in the shape's key order
+};
+
+inline bool IsSpace(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+size_t SkipSpace(std::string_view text, size_t pos) noexcept {
+  while (pos < text.size() && IsSpace(text[pos])) ++pos;
+  return pos;
+}
+
+void PutVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+uint64_t GetVarint(const uint8_t *&p) noexcept {
+  uint64_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = *p++;
+    value |= uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+inline char LowerAscii(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c; }
+
+/** `needle` must already be lower case. */
+bool ContainsIgnoringCase(std::string_view text, std::string_view needle) noexcept {
+  if (needle.size() > text.size()) return false;
+  for (size_t i = 0; i + needle.size() <= text.size(); ++i) {
+    size_t j = 0;
+    while (j < needle.size() && LowerAscii(text[i + j]) == needle[j]) ++j;
+    if (j == needle.size()) return true;
+  }
+  return false;
+}
+
+/** The slot holding the id that `equals` accepts, or the empty slot where it would go. */
+template <class Equals>
+uint32_t &FindSlot(std::vector<uint32_t> &slots, uint64_t hash, Equals &&equals) {
+  size_t mask = slots.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    uint32_t &slot = slots[i];
+    if (!slot || equals(slot - 1)) return slot;
+  }
+}
+
+/** Makes room for one more id, keeping the table at most half full. */
+void Reserve(std::vector<uint32_t> &slots, size_t count, const std::vector<uint64_t> &hashes) {
+  if ((count + 1) * 2 <= slots.size()) return;
+  std::vector<uint32_t> grown(std::max<size_t>(slots.size() * 2, 256), 0);
+  size_t mask = grown.size() - 1;
+  for (size_t id = 0; id < hashes.size(); ++id) {
+    size_t i = hashes[id] & mask;
+    while (grown[i]) i = (i + 1) & mask;
+    grown[i] = static_cast<uint32_t>(id + 1);
+  }
+  slots.swap(grown);
+}
+
+} // namespace
+
+/**
+ * Parses one payload into the tagged form. Object shapes and array lengths are
+ * only known once the container closes, so they're inserted after its tag then.
+ */
+class PayloadArena::Encoder {
+ public:
+  Encoder(PayloadArena &arena, std::string_view text, std::string &out) : m_arena(arena), m_text(text), m_out(out) {}
+
+  bool Encode() {
+    m_out.clear();
+    m_arena.m_keyStack.clear();
+    return Value(0) && SkipSpace(m_text, m_pos) == m_text.size();
+  }
+
+ private:
+  bool Value(size_t depth) {
+    m_pos = SkipSpace(m_text, m_pos);
+    if (m_pos >= m_text.size()) return false;
+    switch (m_text[m_pos]) {
+      case '{':
+        return Object(depth);
+      case '[':
+        return Array(depth);
+      case '"': {
+        std::string_view text;
+        if (!String(text)) return false;
+        EncodeString(text);
+        return true;
+      }
+      case 't':
+        return Literal("true", kTrue);
+      case 'f':
+        return Literal("false", kFalse);
+      case 'n':
+        return Literal("null", kNull);
+      default:
+        return Number();
+    }
+  }
+
+  bool Object(size_t depth) {
+    if (depth >= kMaxDepth) return false;
+    size_t start = m_out.size();
+    m_out.push_back(static_cast<char>(kObject));
+    auto &keys = m_arena.m_keyStack;
+    size_t firstKey = keys.size();
+
+    m_pos = SkipSpace(m_text, m_pos + 1);
+    if (m_pos < m_text.size() && m_text[m_pos] == '}') {
+      ++m_pos;
+    } else {
+      for (;;) {
+        m_pos = SkipSpace(m_text, m_pos);
+        std::string_view key;
+        if (m_pos >= m_text.size() || m_text[m_pos] != '"' || !String(key)) return false;
+        keys.push_back(m_arena.FindString(key, true));
+        m_pos = SkipSpace(m_text, m_pos);
+        if (m_pos >= m_text.size() || m_text[m_pos] != ':') return false;
+        ++m_pos;
+        if (!Value(depth + 1)) return false;
+
+        m_pos = SkipSpace(m_text, m_pos);
+        if (m_pos >= m_text.size()) return false;
+        char c = m_text[m_pos++];
+        if (c == '}') break;
+        if (c != ',') return false;
+      }
+    }
+
+    uint32_t shape = m_arena.InternShape(keys.data() + firstKey, keys.size() - firstKey);
+    keys.resize(firstKey);
+    InsertVarint(start + 1, shape);
+    return true;
+  }
+
+  bool Array(size_t depth) {
+    if (depth >= kMaxDepth) return false;
+    size_t start = m_out.size();
+    m_out.push_back(static_cast<char>(kArray));
+    uint64_t count = 0;
+
+    m_pos = SkipSpace(m_text, m_pos + 1);
+    if (m_pos < m_text.size() && m_text[m_pos] == ']') {
+      ++m_pos;
+    } else {
+      for (;;) {
+        if (!Value(depth + 1)) return false;
+        ++count;
+        m_pos = SkipSpace(m_text, m_pos);
+        if (m_pos >= m_text.size()) return false;
+        char c = m_text[m_pos++];
+        if (c == ']') break;
+        if (c != ',') return false;
+      }
+    }
+
+    InsertVarint(start + 1, count);
+    return true;
+  }
+
+  /** Reads the string at m_pos; `text` is what's between the quotes, escapes and all. */
+  bool String(std::string_view &text) {
+    size_t begin = m_pos + 1;
+    for (size_t pos = begin; pos < m_text.size(); ++pos) {
+      if (m_text[pos] == '\\') {
+        ++pos;
+      } else if (m_text[pos] == '"') {
+        text = m_text.substr(begin, pos - begin);
+        m_pos = pos + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void EncodeString(std::string_view text) {
+    uint32_t id = text.size() <= kMaxInternedValueSize ? m_arena.FindString(text, false) : kNoId;
+    if (id == kNoId && text.size() <= kMaxInternedValueSize) {
+      // Interning a value pays off from its second use; unique ids and timestamps stay inline
+      uint64_t hash = HashBytes(text);
+      uint64_t &seen = m_arena.m_seenValues[hash & (kSeenValuesSize - 1)];
+      if (seen == hash) {
+        id = m_arena.FindString(text, true);
+      } else {
+        seen = hash;
+      }
+    }
+    if (id != kNoId) {
+      m_out.push_back(static_cast<char>(kStringRef));
+      PutVarint(m_out, id);
+    } else {
+      m_out.push_back(static_cast<char>(kString));
+      PutVarint(m_out, text.size());
+      m_out.append(text);
+    }
+  }
+
+  bool Literal(std::string_view literal, Tag tag) {
+    if (m_text.substr(m_pos, literal.size()) != literal) return false;
+    m_pos += literal.size();
+    m_out.push_back(static_cast<char>(tag));
+    return true;
+  }
+
+  bool Number() {
+    size_t begin = m_pos;
+    bool integer = true;
+    size_t digits = 0;
+    while (m_pos < m_text.size()) {
+      char c = m_text[m_pos];
+      if (c >= '0' && c <= '9') {
+        ++digits;
+      } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || (c == '-' && m_pos > begin)) {
+        integer = false;
+      } else if (c != '-') {
+        break;
+      }
+      ++m_pos;
+    }
+    if (!digits) return false;
+
+    std::string_view text = m_text.substr(begin, m_pos - begin);
+    bool negative = text[0] == '-';
+    std::string_view magnitude = text.substr(negative ? 1 : 0);
+    // Only forms that print back the same way: no leading zeros, no "-0"
+    if (integer && digits <= kMaxIntegerDigits && magnitude.size() == digits &&
+        (magnitude[0] != '0' || (digits == 1 && !negative))) {
+      uint64_t value = 0;
+      for (char c : magnitude) value = value * 10 + static_cast<uint64_t>(c - '0');
+      m_out.push_back(static_cast<char>(kInteger));
+      PutVarint(m_out, negative ? value * 2 - 1 : value * 2);
+      return true;
+    }
+    m_out.push_back(static_cast<char>(kNumber));
+    PutVarint(m_out, text.size());
+    m_out.append(text);
+    return true;
+  }
+
+  void InsertVarint(size_t at, uint64_t value) {
+    char bytes[10];
+    size_t size = 0;
+    while (value >= 0x80) {
+      bytes[size++] = static_cast<char>((value & 0x7F) | 0x80);
+      value >>= 7;
+    }
+    bytes[size++] = static_cast<char>(value);
+    m_out.insert(at, bytes, size);
+  }
+
+  PayloadArena &m_arena;
+  std::string_view m_text;
+  std::string &m_out;
+  size_t m_pos = 0;
+};
+
+/** Walks one stored payload. */
+class PayloadArena::Decoder {
+ public:
+  Decoder(const PayloadArena &arena, const uint8_t *data) : m_arena(arena), m_p(data) {}
+
+  void Json(std::string &out) {
+    uint8_t tag = *m_p++;
+    switch (tag) {
+      case kNull:
+        out.append("null");
+        return;
+      case kFalse:
+        out.append("false");
+        return;
+      case kTrue:
+        out.append("true");
+        return;
+      case kInteger: {
+        uint64_t zigzag = GetVarint(m_p);
+        if (zigzag & 1) out.push_back('-');
+        out.append(std::to_string((zigzag + 1) >> 1));
+        return;
+      }
+      case kNumber:
+        out.append(Inline());
+        return;
+      case kString:
+        out.push_back('"');
+        out.append(Inline());
+        out.push_back('"');
+        return;
+      case kStringRef:
+        out.push_back('"');
+        out.append(m_arena.String(static_cast<uint32_t>(GetVarint(m_p))));
+        out.push_back('"');
+        return;
+      case kArray: {
+        uint64_t count = GetVarint(m_p);
+        out.push_back('[');
+        for (uint64_t i = 0; i < count; ++i) {
+          if (i) out.push_back(',');
+          Json(out);
+        }
+        out.push_back(']');
+        return;
+      }
+      case kObject: {
+        uint32_t shape = static_cast<uint32_t>(GetVarint(m_p));
+        uint32_t begin = shape ? m_arena.m_shapeEnds[shape - 1] : 0;
+        uint32_t end = m_arena.m_shapeEnds[shape];
+        out.push_back('{');
+        for (uint32_t i = begin; i < end; ++i) {
+          if (i != begin) out.push_back(',');
+          out.push_back('"');
+          out.append(m_arena.String(m_arena.m_shapeKeys[i]));
+          out.append("\":");
+          Json(out);
+        }
+        out.push_back('}');
+        return;
+      }
+    }
+  }
+
+  /** Walks the value at the cursor to its end, unless a match stops it early. */
+  bool Contains(std::string_view needle) {
+    uint8_t tag = *m_p++;
+    switch (tag) {
+      case kNull:
+        return false;
+      case kFalse:
+        return ContainsIgnoringCase("false", needle);
+      case kTrue:
+        return ContainsIgnoringCase("true", needle);
+      case kInteger: {
+        uint64_t zigzag = GetVarint(m_p);
+        std::string text = (zigzag & 1 ? "-" : "") + std::to_string((zigzag + 1) >> 1);
+        return ContainsIgnoringCase(text, needle);
+      }
+      case kNumber:
+      case kString:
+        return ContainsIgnoringCase(Inline(), needle);
+      case kStringRef:
+        return ContainsIgnoringCase(m_arena.String(static_cast<uint32_t>(GetVarint(m_p))), needle);
+      case kArray: {
+        uint64_t count = GetVarint(m_p);
+        for (uint64_t i = 0; i < count; ++i) {
+          if (Contains(needle)) return true;
+        }
+        return false;
+      }
+      case kObject: {
+        uint32_t shape = static_cast<uint32_t>(GetVarint(m_p));
+        uint32_t count = m_arena.m_shapeEnds[shape] - (shape ? m_arena.m_shapeEnds[shape - 1] : 0);
+        for (uint32_t i = 0; i < count; ++i) {
+          if (Contains(needle)) return true;
+        }
+        return false;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::string_view Inline() noexcept {
+    size_t size = static_cast<size_t>(GetVarint(m_p));
+    std::string_view text(reinterpret_cast<const char *>(m_p), size);
+    m_p += size;
+    return text;
+  }
+
+  const PayloadArena &m_arena;
+  const uint8_t *m_p;
+};
+
+PayloadArena::PayloadArena() : m_seenValues(kSeenValuesSize, 0) {}
+
+uint32_t PayloadArena::FindString(std::string_view text, bool insert) {
+  uint64_t hash = HashBytes(text);
+  if (insert) Reserve(m_stringTable.slots, m_stringTable.count, m_stringHashes);
+  if (m_stringTable.slots.empty()) return kNoId;
+
+  uint32_t &slot = FindSlot(m_stringTable.slots, hash, [&](uint32_t id) {
+    return m_stringHashes[id] == hash && String(id) == text;
+  });
+  if (slot) return slot - 1;
+  if (!insert) return kNoId;
+
+  uint32_t id = static_cast<uint32_t>(m_stringEnds.size());
+  m_stringData.append(text);
+  m_stringEnds.push_back(static_cast<uint32_t>(m_stringData.size()));
+  m_stringHashes.push_back(hash);
+  slot = id + 1;
+  m_stringTable.count++;
+  return id;
+}
+
+uint32_t PayloadArena::InternShape(const uint32_t *keys, size_t count) {
+  std::string_view bytes(reinterpret_cast<const char *>(keys), count * sizeof(uint32_t));
+  uint64_t hash = HashBytes(bytes, kShapeSeed);
+  Reserve(m_shapeTable.slots, m_shapeTable.count, m_shapeHashes);
+
+  uint32_t &slot = FindSlot(m_shapeTable.slots, hash, [&](uint32_t id) {
+    uint32_t begin = id ? m_shapeEnds[id - 1] : 0;
+    return m_shapeHashes[id] == hash && m_shapeEnds[id] - begin == count &&
+           std::equal(keys, keys + count, m_shapeKeys.begin() + begin);
+  });
+  if (slot) return slot - 1;
+
+  uint32_t id = static_cast<uint32_t>(m_shapeEnds.size());
+  m_shapeKeys.insert(m_shapeKeys.end(), keys, keys + count);
+  m_shapeEnds.push_back(static_cast<uint32_t>(m_shapeKeys.size()));
+  m_shapeHashes.push_back(hash);
+  slot = id + 1;
+  m_shapeTable.count++;
+  return id;
+}
+
+std::string_view PayloadArena::String(uint32_t id) const noexcept {
+  uint32_t begin = id ? m_stringEnds[id - 1] : 0;
+  return std::string_view(m_stringData).substr(begin, m_stringEnds[id] - begin);
+}
+
+uint32_t PayloadArena::Store(std::string_view json) {
+  if (m_firstHandle + m_slots.size() >= UINT32_MAX) return 0;
+  if (!Encoder(*this, json, m_scratch).Encode()) return 0;
+
+  size_t size = m_scratch.size();
+  size_t blockIndex = m_currentBlock;
+  if (size >= kLargePayloadSize || blockIndex == SIZE_MAX ||
+      m_blocks[blockIndex].capacity - m_blocks[blockIndex].used < size) {
+    Block block;
+    block.capacity = std::max(kBlockSize, size);
+    block.data.reset(new uint8_t[block.capacity]);
+    blockIndex = m_blocks.size();
+    m_blocks.push_back(std::move(block));
+    if (size < kLargePayloadSize) {
+      // The previous block keeps its payloads; it's freed once they're all released
+      if (m_currentBlock != SIZE_MAX && !m_blocks[m_currentBlock].live) {
+        m_blocks[m_currentBlock] = Block();
+      }
+      m_currentBlock = blockIndex;
+    }
+  }
+
+  Block &block = m_blocks[blockIndex];
+  Slot slot;
+  slot.block = static_cast<uint32_t>(blockIndex);
+  slot.offset = static_cast<uint32_t>(block.used);
+  slot.size = static_cast<uint32_t>(size);
+  slot.live = true;
+  std::memcpy(block.data.get() + block.used, m_scratch.data(), size);
+  block.used += size;
+  block.live += size;
+  m_slots.push_back(slot);
+  m_livePayloads++;
+  m_payloadBytes += size;
+
+  // A one-off huge payload shouldn't pin a huge scratch buffer
+  if (m_scratch.capacity() > kBlockSize) std::string().swap(m_scratch);
+  return static_cast<uint32_t>(m_firstHandle + m_slots.size() - 1);
+}
+
+const uint8_t *PayloadArena::Payload(uint32_t handle, size_t &size) const noexcept {
+  if (handle < m_firstHandle || handle - m_firstHandle >= m_slots.size()) return nullptr;
+  const Slot &slot = m_slots[handle - m_firstHandle];
+  if (!slot.live) return nullptr;
+  size = slot.size;
+  return m_blocks[slot.block].data.get() + slot.offset;
+}
+
+bool PayloadArena::Materialize(uint32_t handle, std::string &out) const {
+  size_t size = 0;
+  const uint8_t *data = Payload(handle, size);
+  if (!data) return false;
+  out.clear();
+  out.reserve(size * 2);
+  Decoder(*this, data).Json(out);
+  return true;
+}
+
+bool PayloadArena::Contains(uint32_t handle, std::string_view needle) const {
+  size_t size = 0;
+  const uint8_t *data = Payload(handle, size);
+  if (!data) return false;
+  if (needle.empty()) return true;
+  return Decoder(*this, data).Contains(needle);
+}
+
+void PayloadArena::Release(uint32_t handle) {
+  if (handle < m_firstHandle || handle - m_firstHandle >= m_slots.size()) return;
+  Slot &slot = m_slots[handle - m_firstHandle];
+  if (!slot.live) return;
+  slot.live = false;
+  m_livePayloads--;
+  m_payloadBytes -= slot.size;
+
+  Block &block = m_blocks[slot.block];
+  block.live -= slot.size;
+  if (block.live) return;
+  if (slot.block == m_currentBlock) {
+    block.used = 0;
+  } else {
+    block = Block();
+  }
+}
+
+void PayloadArena::Clear() {
+  m_firstHandle += static_cast<uint32_t>(m_slots.size());
+  m_blocks.clear();
+  m_currentBlock = SIZE_MAX;
+  m_slots.clear();
+  m_slots.shrink_to_fit();
+  m_livePayloads = 0;
+  m_payloadBytes = 0;
+
+  std::string().swap(m_stringData);
+  std::vector<uint32_t>().swap(m_stringEnds);
+  std::vector<uint64_t>().swap(m_stringHashes);
+  m_stringTable = IdTable();
+  std::vector<uint32_t>().swap(m_shapeKeys);
+  std::vector<uint32_t>().swap(m_shapeEnds);
+  std::vector<uint64_t>().swap(m_shapeHashes);
+  m_shapeTable = IdTable();
+  std::fill(m_seenValues.begin(), m_seenValues.end(), 0);
+}
+
+PayloadArenaStats PayloadArena::Stats() const noexcept {
+  PayloadArenaStats stats;
+  stats.payloads = m_livePayloads;
+  stats.strings = m_stringEnds.size();
+  stats.shapes = m_shapeEnds.size();
+  stats.payloadBytes = m_payloadBytes;
+  uint64_t allocated = 0;
+  for (const Block &block : m_blocks) allocated += block.capacity;
+  allocated += m_stringData.capacity();
+  allocated += (m_stringEnds.capacity() + m_stringTable.slots.capacity()) * sizeof(uint32_t);
+  allocated += m_stringHashes.capacity() * sizeof(uint64_t);
+  allocated += (m_shapeKeys.capacity() + m_shapeEnds.capacity() + m_shapeTable.slots.capacity()) * sizeof(uint32_t);
+  allocated += m_shapeHashes.capacity() * sizeof(uint64_t);
+  allocated += m_seenValues.capacity() * sizeof(uint64_t);
+  allocated += m_slots.capacity() * sizeof(Slot);
+  stats.allocatedBytes = allocated;
+  return stats;
+}
+
+SharedPayloadArena &SharedPayloadArena::Get() {
+  static SharedPayloadArena *shared = new SharedPayloadArena(); // Never destroyed, so ingest workers can outlive static teardown
+  return *shared;
+}
+
+} // namespace reactotron
@@ -0,0 +1,138 @@
+#pragma once
+
+//
+//  PayloadArena.h
+//  Reactotron
+//
+//  Compact native storage for timeline payloads. A parsed JS payload repeats
+//  every key and object layout per item; here keys are interned once per
+//  session, each object stores only the id of its shape (its key list) and
+//  its values, and short strings that recur (levels, methods, header values)
+//  are interned too. Payloads are tagged byte strings in shared blocks, turned
+//  back into JSON only when a row or the detail panel needs them.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+struct PayloadArenaStats {
+  size_t payloads = 0;
+  size_t strings = 0; // Interned keys and values
+  size_t shapes = 0;
+  uint64_t payloadBytes = 0;   // Encoded payloads still stored
+  uint64_t allocatedBytes = 0; // Blocks, string and shape tables, handles
+};
+
+/**
+ * The arena. Store() parses a payload's JSON once into the compact form and
+ * returns a handle; Materialize() writes the JSON back out, and Contains()
+ * searches the values without materializing. Handles are never reused, so a
+ * stale one fails rather than finding another payload.
+ *
+ * Strings keep their JSON escapes, so a payload round-trips byte for byte as
+ * long as it was compact (as JSON.stringify writes it).
+ *
+ * Not thread-safe.
+ */
+class PayloadArena {
+ public:
+  static constexpr size_t kMaxDepth = 256;
+  static constexpr size_t kMaxInternedValueSize = 64;
+
+  PayloadArena();
+  PayloadArena(const PayloadArena &) = delete;
+  PayloadArena &operator=(const PayloadArena &) = delete;
+
+  /** Returns 0 if `json` is malformed or nested deeper than kMaxDepth. */
+  uint32_t Store(std::string_view json);
+  bool Materialize(uint32_t handle, std::string &out) const;
+  /**
+   * True if a string, number or boolean in the payload contains `needle`,
+   * ignoring ASCII case. Keys are not searched, as in the timeline search.
+   */
+  bool Contains(uint32_t handle, std::string_view needle) const;
+
+  void Release(uint32_t handle);
+  /** Releases every payload and forgets the interned strings and shapes. */
+  void Clear();
+
+  PayloadArenaStats Stats() const noexcept;
+
+ private:
+  struct Slot {
+    uint32_t block = 0;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    bool live = false;
+  };
+
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t live = 0; // Bytes of payloads not yet released
+  };
+
+  /** Open-addressed set of ids (stored + 1, 0 if empty); contents are compared by the caller. */
+  struct IdTable {
+    std::vector<uint32_t> slots;
+    size_t count = 0;
+  };
+
+  class Encoder;
+  class Decoder;
+
+  static constexpr uint32_t kNoId = UINT32_MAX;
+
+  /** The string's id, interning it if `insert`; kNoId if it's not interned and not `insert`. */
+  uint32_t FindString(std::string_view text, bool insert);
+  uint32_t InternShape(const uint32_t *keys, size_t count);
+  std::string_view String(uint32_t id) const noexcept;
+  const uint8_t *Payload(uint32_t handle, size_t &size) const noexcept;
+
+  std::vector<Block> m_blocks;
+  size_t m_currentBlock = SIZE_MAX; // Where small payloads go; large ones get a block each
+  std::vector<Slot> m_slots; // By handle - m_firstHandle
+  uint32_t m_firstHandle = 1;
+  size_t m_livePayloads = 0;
+  uint64_t m_payloadBytes = 0;
+
+  // Interned strings, back to back; string i spans m_stringEnds[i - 1] to m_stringEnds[i]
+  std::string m_stringData;
+  std::vector<uint32_t> m_stringEnds;
+  std::vector<uint64_t> m_stringHashes;
+  IdTable m_stringTable;
+
+  // Shapes' key ids, back to back, delimited like the strings
+  std::vector<uint32_t> m_shapeKeys;
+  std::vector<uint32_t> m_shapeEnds;
+  std::vector<uint64_t> m_shapeHashes;
+  IdTable m_shapeTable;
+
+  // Hashes of short value strings seen once; a second sighting interns them
+  std::vector<uint64_t> m_seenValues;
+
+  std::string m_scratch;
+  std::vector<uint32_t> m_keyStack;
+};
+
+/**
+ * The session's payloads: the relay's ingest workers store each timeline
+ * command's payload here from the message itself, and IRPayloadArena reads
+ * and releases them by handle. Hold `mutex` to use `arena`.
+ */
+struct SharedPayloadArena {
+  std::mutex mutex;
+  PayloadArena arena;
+
+  static SharedPayloadArena &Get();
+};
+
+} // namespace reactotron
@@ -0,0 +1,168 @@
+//
+//  IRRelaySocket.mm
+//  Reactotron-macOS
+//
+//  The relay WebSocket, read on a native I/O thread and handed to JS in batches.
+//
+
+#import "IRRelaySocket.h"
+#include "RelaySocket.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+@implementation IRRelaySocket {
+  std::unordered_map<uint32_t, std::unique_ptr<reactotron::RelaySocket>> _sockets;
+  uint32_t _nextSocketId;
+  std::mutex _socketsMutex;
+}
+
+RCT_EXPORT_MODULE()
+
+static NSString *IRRelaySocketString(const std::string &text) {
+  NSString *string = [[NSString alloc] initWithBytes:text.data() length:text.size() encoding:NSUTF8StringEncoding];
+  if (string) return string;
+  // Invalid UTF-8 would otherwise lose the whole message
+  std::u16string utf16 = reactotron::Utf8ToUtf16(text);
+  return [NSString stringWithCharacters:reinterpret_cast<const unichar *>(utf16.data()) length:utf16.size()];
+}
+
+// Hex, since JS numbers can't hold 64 bits; "" for messages that aren't logs
+static NSArray<NSString *> *IRRelaySocketLogKeys(const std::vector<reactotron::IngestedItem> &items) {
+  NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:items.size()];
+  for (const reactotron::IngestedItem &item : items) {
+    [keys addObject:item.logKey ? [NSString stringWithFormat:@"%016llx", (unsigned long long)item.logKey] : @""];
+  }
+  return keys;
+}
+
+// 0 for messages whose payload isn't in the arena
+static NSArray<NSNumber *> *IRRelaySocketPayloadHandles(const std::vector<reactotron::IngestedItem> &items) {
+  NSMutableArray<NSNumber *> *handles = [NSMutableArray arrayWithCapacity:items.size()];
+  for (const reactotron::IngestedItem &item : items) [handles addObject:@(item.payloadHandle)];
+  return handles;
+}
+
+// The IRIds handle of a timeline command's item, numbered as it was committed; 0 for other messages
+static NSArray<NSNumber *> *IRRelaySocketItemIds(const std::vector<reactotron::IngestedItem> &items) {
+  NSMutableArray<NSNumber *> *ids = [NSMutableArray arrayWithCapacity:items.size()];
+  for (const reactotron::IngestedItem &item : items) [ids addObject:@(item.itemId)];
+  return ids;
+}
+
+- (NSNumber *)connect:(NSString *)url {
+  __weak IRRelaySocket *weakSelf = self;
+  uint32_t socketId;
+  {
+    std::lock_guard<std::mutex> lock(_socketsMutex);
+    socketId = ++_nextSocketId;
+  }
+  auto socket = std::make_unique<reactotron::RelaySocket>([weakSelf, socketId] {
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [weakSelf emitOnRelaySocketPending:@{ @"socketId": @(socketId) }];
+    });
+  });
+  socket->Connect(url.UTF8String ?: "");
+  std::lock_guard<std::mutex> lock(_socketsMutex);
+  _sockets[socketId] = std::move(socket);
+  return @(socketId);
+}
+
+- (NSNumber *)send:(double)socketId text:(NSString *)text {
+  const char *utf8 = text.UTF8String;
+  std::lock_guard<std::mutex> lock(_socketsMutex);
+  auto it = _sockets.find(static_cast<uint32_t>(socketId));
+  return @(it != _sockets.end() && utf8 && it->second->Send(utf8));
+}
+
+- (NSNumber *)close:(double)socketId {
+  std::unique_ptr<reactotron::RelaySocket> socket;
+  {
+    std::lock_guard<std::mutex> lock(_socketsMutex);
+    auto it = _sockets.find(static_cast<uint32_t>(socketId));
+    if (it == _sockets.end()) return @0;
+    socket = std::move(it->second);
+    _sockets.erase(it);
+  }
+  socket->Close();
+  return @1;
+}
+
+- (NSDictionary *)takeBatch:(double)socketId {
+  reactotron::RelayBatch batch;
+  std::unique_ptr<reactotron::RelaySocket> finished;
+  {
+    std::lock_guard<std::mutex> lock(_socketsMutex);
+    auto it = _sockets.find(static_cast<uint32_t>(socketId));
+    if (it != _sockets.end()) {
+      batch = it->second->TakeBatch();
+      if (batch.closed) {
+        finished = std::move(it->second);
+        _sockets.erase(it);
+      }
+    }
+  }
+  NSMutableArray *messages = [NSMutableArray arrayWithCapacity:batch.messages.size()];
+  for (const std::string &message : batch.messages) [messages addObject:IRRelaySocketString(message)];
+  return @{
+    @"opened": @(batch.opened),
+    @"messages": messages,
+    @"logKeys": IRRelaySocketLogKeys(batch.items),
+    @"payloadHandles": IRRelaySocketPayloadHandles(batch.items),
+    @"itemIds": IRRelaySocketItemIds(batch.items),
+    @"error": IRRelaySocketString(batch.error),
+    @"closed": @(batch.closed),
+  };
+}
+
+- (NSArray *)clientStats:(double)socketId {
+  reactotron::IngestStats stats;
+  {
+    std::lock_guard<std::mutex> lock(_socketsMutex);
+    auto it = _sockets.find(static_cast<uint32_t>(socketId));
+    if (it == _sockets.end()) return @[];
+    stats = it->second->ClientStats();
+  }
+  NSMutableArray *clients = [NSMutableArray arrayWithCapacity:stats.clients.size()];
+  for (const reactotron::IngestClientStats &client : stats.clients) {
+    [clients addObject:@{
+      @"clientId": IRRelaySocketString(client.clientId),
+      @"messages": @(client.messages),
+      @"bytes": @(client.bytes),
+      @"malformed": @(client.malformed),
+      @"unsafeKeys": @(client.unsafeKeys),
+      @"commands": @(client.commands),
+      @"bodies": @(client.bodies),
+      @"largestMessage": @(client.largestMessage),
+    }];
+  }
+  return clients;
+}
+
+- (NSDictionary *)ingest:(NSArray *)texts {
+  std::vector<std::string> messages;
+  messages.reserve(texts.count);
+  for (id text in texts) {
+    const char *utf8 = [text isKindOfClass:[NSString class]] ? [(NSString *)text UTF8String] : nullptr;
+    if (utf8) messages.emplace_back(utf8);
+  }
+  std::vector<reactotron::IngestedItem> items;
+  reactotron::IngestPipeline::Ingest(messages, items);
+  NSMutableArray *result = [NSMutableArray arrayWithCapacity:messages.size()];
+  for (const std::string &message : messages) [result addObject:IRRelaySocketString(message)];
+  return @{
+    @"messages": result,
+    @"logKeys": IRRelaySocketLogKeys(items),
+    @"payloadHandles": IRRelaySocketPayloadHandles(items),
+    @"itemIds": IRRelaySocketItemIds(items),
+  };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRRelaySocketSpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,165 @@
+//
+//  IRRelaySocket.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared RelaySocket
+//
+
+#include "pch.h"
+#include "IRRelaySocket.windows.h"
+#include <cstdio>
+
+namespace winrt::reactotron::implementation
+{
+    namespace
+    {
+        // Hex, since JS numbers can't hold 64 bits; "" for messages that aren't logs
+        Microsoft::ReactNative::JSValueArray LogKeys(const std::vector<::reactotron::IngestedItem> &items)
+        {
+            Microsoft::ReactNative::JSValueArray keys;
+            keys.reserve(items.size());
+            for (const auto &item : items)
+            {
+                char hex[17] = "";
+                if (item.logKey) snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(item.logKey));
+                keys.push_back(std::string(hex));
+            }
+            return keys;
+        }
+
+        // 0 for messages whose payload isn't in the arena
+        Microsoft::ReactNative::JSValueArray PayloadHandles(const std::vector<::reactotron::IngestedItem> &items)
+        {
+            Microsoft::ReactNative::JSValueArray handles;
+            handles.reserve(items.size());
+            for (const auto &item : items) handles.push_back(static_cast<double>(item.payloadHandle));
+            return handles;
+        }
+
+        // The IRIds handle of a timeline command's item, numbered as it was committed; 0 for other messages
+        Microsoft::ReactNative::JSValueArray ItemIds(const std::vector<::reactotron::IngestedItem> &items)
+        {
+            Microsoft::ReactNative::JSValueArray ids;
+            ids.reserve(items.size());
+            for (const auto &item : items) ids.push_back(static_cast<double>(item.itemId));
+            return ids;
+        }
+    }
+
+    double IRRelaySocket::connect(std::string url) noexcept
+    {
+        uint32_t socketId;
+        {
+            std::lock_guard<std::mutex> lock(m_socketsMutex);
+            socketId = ++m_nextSocketId;
+        }
+        auto socket = std::make_unique<::reactotron::RelaySocket>([this, socketId] {
+            Microsoft::ReactNative::JSValueObject event;
+            event["socketId"] = static_cast<double>(socketId);
+            if (onRelaySocketPending) onRelaySocketPending(Microsoft::ReactNative::JSValue(std::move(event)));
+        });
+        socket->Connect(url);
+
+        std::lock_guard<std::mutex> lock(m_socketsMutex);
+        m_sockets[socketId] = std::move(socket);
+        return static_cast<double>(socketId);
+    }
+
+    bool IRRelaySocket::send(double socketId, std::string text) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_socketsMutex);
+        auto it = m_sockets.find(static_cast<uint32_t>(socketId));
+        return it != m_sockets.end() && it->second->Send(text);
+    }
+
+    double IRRelaySocket::close(double socketId) noexcept
+    {
+        std::unique_ptr<::reactotron::RelaySocket> socket;
+        {
+            std::lock_guard<std::mutex> lock(m_socketsMutex);
+            auto it = m_sockets.find(static_cast<uint32_t>(socketId));
+            if (it == m_sockets.end()) return 0;
+            socket = std::move(it->second);
+            m_sockets.erase(it);
+        }
+        socket->Close();
+        return 1;
+    }
+
+    Microsoft::ReactNative::JSValue IRRelaySocket::takeBatch(double socketId) noexcept
+    {
+        ::reactotron::RelayBatch batch;
+        std::unique_ptr<::reactotron::RelaySocket> finished;
+        {
+            std::lock_guard<std::mutex> lock(m_socketsMutex);
+            auto it = m_sockets.find(static_cast<uint32_t>(socketId));
+            if (it != m_sockets.end())
+            {
+                batch = it->second->TakeBatch();
+                if (batch.closed)
+                {
+                    finished = std::move(it->second);
+                    m_sockets.erase(it);
+                }
+            }
+        }
+
+        Microsoft::ReactNative::JSValueArray messages;
+        messages.reserve(batch.messages.size());
+        for (std::string &message : batch.messages) messages.push_back(std::move(message));
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["opened"] = batch.opened;
+        result["messages"] = std::move(messages);
+        result["logKeys"] = LogKeys(batch.items);
+        result["payloadHandles"] = PayloadHandles(batch.items);
+        result["itemIds"] = ItemIds(batch.items);
+        result["error"] = batch.error;
+        result["closed"] = batch.closed;
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    Microsoft::ReactNative::JSValue IRRelaySocket::clientStats(double socketId) noexcept
+    {
+        ::reactotron::IngestStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_socketsMutex);
+            auto it = m_sockets.find(static_cast<uint32_t>(socketId));
+            if (it != m_sockets.end()) stats = it->second->ClientStats();
+        }
+
+        Microsoft::ReactNative::JSValueArray clients;
+        clients.reserve(stats.clients.size());
+        for (const auto &client : stats.clients)
+        {
+            Microsoft::ReactNative::JSValueObject entry;
+            entry["clientId"] = client.clientId;
+            entry["messages"] = static_cast<double>(client.messages);
+            entry["bytes"] = static_cast<double>(client.bytes);
+            entry["malformed"] = static_cast<double>(client.malformed);
+            entry["unsafeKeys"] = static_cast<double>(client.unsafeKeys);
+            entry["commands"] = static_cast<double>(client.commands);
+            entry["bodies"] = static_cast<double>(client.bodies);
+            entry["largestMessage"] = static_cast<double>(client.largestMessage);
+            clients.push_back(std::move(entry));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(clients));
+    }
+
+    Microsoft::ReactNative::JSValue IRRelaySocket::ingest(std::vector<std::string> texts) noexcept
+    {
+        std::vector<::reactotron::IngestedItem> items;
+        ::reactotron::IngestPipeline::Ingest(texts, items);
+
+        Microsoft::ReactNative::JSValueArray messages;
+        messages.reserve(texts.size());
+        for (std::string &text : texts) messages.push_back(std::move(text));
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["messages"] = std::move(messages);
+        result["logKeys"] = LogKeys(items);
+        result["payloadHandles"] = PayloadHandles(items);
+        result["itemIds"] = ItemIds(items);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
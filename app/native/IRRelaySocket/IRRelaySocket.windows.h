@@ -0,0 +1,43 @@
+#pragma once
+#include "NativeModules.h"
+#include "RelaySocket.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRRelaySocket)
+    struct IRRelaySocket
+    {
+        IRRelaySocket() noexcept = default;
+
+        REACT_SYNC_METHOD(connect)
+        double connect(std::string url) noexcept;
+
+        REACT_SYNC_METHOD(send)
+        bool send(double socketId, std::string text) noexcept;
+
+        REACT_SYNC_METHOD(close)
+        double close(double socketId) noexcept;
+
+        REACT_SYNC_METHOD(takeBatch)
+        Microsoft::ReactNative::JSValue takeBatch(double socketId) noexcept;
+
+        REACT_SYNC_METHOD(clientStats)
+        Microsoft::ReactNative::JSValue clientStats(double socketId) noexcept;
+
+        REACT_SYNC_METHOD(ingest)
+        Microsoft::ReactNative::JSValue ingest(std::vector<std::string> texts) noexcept;
+
+        REACT_EVENT(onRelaySocketPending)
+        std::function<void(Microsoft::ReactNative::JSValue)> onRelaySocketPending;
+
+    private:
+        std::unordered_map<uint32_t, std::unique_ptr<::reactotron::RelaySocket>> m_sockets;
+        uint32_t m_nextSocketId = 0;
+        std::mutex m_socketsMutex;
+    };
+}
@@ -0,0 +1,826 @@
+//
+//  IngestPipeline.cpp
+//  Reactotron
+//
+
+#include "IngestPipeline.h"
+#include "../IRBodyStore/BodyStore.h"
+#include "../IRIds/ItemHandles.h"
+#include "../IRLogStats/LogStats.h"
+#include "../IRPayloadArena/PayloadArena.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IR_INGEST_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define IR_INGEST_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kMaxDepth = 256;
+constexpr size_t kNone = SIZE_MAX;
+
+inline bool IsSpace(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+inline bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+inline size_t SkipSpace(std::string_view text, size_t i) noexcept {
+  while (i < text.size() && IsSpace(text[i])) ++i;
+  return i;
+}
+
+#if defined(IR_INGEST_SSE2)
+inline unsigned CountTrailingZeros(unsigned mask) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * The length of the run at `p` that a string can hold as is: everything but
+ * quotes, backslashes and control characters. Most of a message is this.
+ */
+size_t PlainRun(const uint8_t *p, size_t length) noexcept {
+  size_t i = 0;
+#if defined(IR_INGEST_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i controlMax = _mm_set1_epi8(0x1F);
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    // Unsigned b <= 0x1F, without the signed compare treating UTF-8 bytes as negative
+    __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                   _mm_cmpeq_epi8(_mm_min_epu8(v, controlMax), v));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask) return i + CountTrailingZeros(mask);
+  }
+#elif defined(IR_INGEST_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t v = vld1q_u8(p + i);
+    uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)), vcltq_u8(v, space));
+    if (vmaxvq_u8(special)) break; // The scalar loop finds the exact byte
+  }
+#endif
+  for (; i < length; ++i) {
+    uint8_t b = p[i];
+    if (b == '"' || b == '\\' || b < 0x20) break;
+  }
+  return i;
+}
+
+/**
+ * The closing quote of the string opening at `open`, or kNone if it isn't a
+ * valid JSON string.
+ */
+size_t StringEnd(std::string_view text, size_t open) noexcept {
+  const char *data = text.data();
+  size_t size = text.size();
+  size_t i = open + 1;
+  for (;;) {
+    i += PlainRun(reinterpret_cast<const uint8_t *>(data + i), size - i);
+    if (i >= size) return kNone;
+
+    // A quote, a control character or an escape
+    if (data[i] == '"') return i;
+    if (data[i] != '\\' || i + 1 >= size) return kNone;
+    char escape = data[i + 1];
+    if (escape == 'u') {
+      if (i + 6 > size) return kNone;
+      for (size_t j = i + 2; j < i + 6; ++j) {
+        if (!std::isxdigit(static_cast<unsigned char>(data[j]))) return kNone;
+      }
+      i += 6;
+    } else if (escape != '\0' && std::strchr("\"\\/bfnrt", escape)) {
+      i += 2;
+    } else {
+      return kNone;
+    }
+  }
+}
+
+inline bool EqualsIgnoringCase(std::string_view a, std::string_view lower) noexcept {
+  if (a.size() != lower.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    char c = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+    if (c != lower[i]) return false;
+  }
+  return true;
+}
+
+/** An api.response body's JSON value and the headers that say how to decode it, as spans of the message. */
+struct BodySpan {
+  size_t start = kNone;
+  size_t end = kNone;
+  std::string_view contentType; // String literals, quotes included
+  std::string_view contentEncoding;
+};
+
+/** Where a log command's payload keeps what identifies it, as spans of the message; empty if missing. */
+struct LogSpans {
+  std::string_view level;
+  std::string_view message;
+  std::string_view stack;
+  // The first stack frame's, if the stack is an array of frames
+  std::string_view functionName;
+  std::string_view fileName;
+  std::string_view lineNumber;
+};
+
+/**
+ * Validates a relay message as JSON in one pass, noting the members to cut
+ * to sanitize it, whether it's a command and where its payload is, where an
+ * api.response keeps its bodies, and what a log's fingerprint is made of.
+ */
+class MessageScanner {
+ public:
+  /** Where an object sits, as far as finding the bodies goes. */
+  enum class Context : uint8_t { Other, Envelope, Command, Payload, Request, Response, Headers, Stack, StackFrame };
+
+  explicit MessageScanner(std::string_view text) : m_text(text) {}
+
+  bool Scan() {
+    size_t i = SkipSpace(m_text, 0);
+    if (!Value(i, 0, Context::Envelope, 0)) return false;
+    return SkipSpace(m_text, i) == m_text.size();
+  }
+
+  bool IsCommand() const noexcept { return m_command; }
+  std::string_view CommandType() const noexcept { return m_commandType; }
+  size_t UnsafeKeys() const noexcept { return m_unsafeKeys; }
+  /** The request's body, then the response's. */
+  const BodySpan &Body(size_t side) const noexcept { return m_bodies[side]; }
+  const LogSpans &Log() const noexcept { return m_log; }
+  /** The command's payload, as a view of the message; empty if it has none. */
+  std::string_view Payload() const noexcept { return m_payload; }
+  /** The command's "clientId" and "messageId" literals; empty if it has none. */
+  std::string_view ClientId() const noexcept { return m_clientId; }
+  std::string_view MessageId() const noexcept { return m_messageId; }
+  /** [start, end) of `span`, a view of the message. */
+  size_t Offset(std::string_view span) const noexcept { return static_cast<size_t>(span.data() - m_text.data()); }
+
+  /** Has [start, end) rewritten as `replacement`. */
+  void Replace(size_t start, size_t end, std::string replacement) {
+    m_edits.push_back(Edit{start, end, std::move(replacement)});
+  }
+
+  /** [start, end) of the message with the unsafe members in it cut. */
+  std::string Slice(size_t start, size_t end) {
+    std::sort(m_edits.begin(), m_edits.end());
+    std::string out;
+    out.reserve(end - start);
+    size_t from = start;
+    for (const Edit &edit : m_edits) {
+      if (edit.end <= from || edit.start >= end) continue;
+      out.append(m_text.substr(from, edit.start - from));
+      out.append(edit.replacement);
+      from = edit.end;
+    }
+    out.append(m_text.substr(from, end - from));
+    return out;
+  }
+
+  /** The message without its unsafe members, and with its edits. */
+  std::string Rewritten() { return Slice(0, m_text.size()); }
+
+ private:
+  struct Edit {
+    size_t start;
+    size_t end;
+    std::string replacement;
+
+    // Outer edits sort before the ones inside them, which Slice() then skips
+    bool operator<(const Edit &other) const noexcept {
+      return start != other.start ? start < other.start : end > other.end;
+    }
+  };
+
+  bool Value(size_t &i, size_t depth, Context context, size_t side) {
+    if (i >= m_text.size()) return false;
+    switch (m_text[i]) {
+      case '{':
+        return Object(i, depth + 1, context, side);
+      case '[':
+        return Array(i, depth + 1, context);
+      case '"': {
+        size_t end = StringEnd(m_text, i);
+        if (end == kNone) return false;
+        i = end + 1;
+        return true;
+      }
+      case 't':
+        return Literal(i, "true");
+      case 'f':
+        return Literal(i, "false");
+      case 'n':
+        return Literal(i, "null");
+      default:
+        return Number(i);
+    }
+  }
+
+  bool Object(size_t &i, size_t depth, Context context, size_t side) {
+    if (depth > kMaxDepth) return false;
+    ++i;
+    // A run of unsafe members is cut from its first key up to the next member's key, or from
+    // the end of the last member kept if it runs to the end, so the commas stay right
+    size_t lastKeptEnd = kNone;
+    size_t cutStart = kNone;
+    size_t cutEnd = kNone;
+    i = SkipSpace(m_text, i);
+    if (i < m_text.size() && m_text[i] == '}') {
+      ++i;
+      return true;
+    }
+    for (;;) {
+      if (i >= m_text.size() || m_text[i] != '"') return false;
+      size_t keyStart = i;
+      size_t keyEnd = StringEnd(m_text, i);
+      if (keyEnd == kNone) return false;
+      if (cutStart != kNone) {
+        m_edits.push_back(Edit{cutStart, keyStart, {}});
+        cutStart = kNone;
+      }
+      std::string_view key = m_text.substr(keyStart + 1, keyEnd - keyStart - 1);
+      i = SkipSpace(m_text, keyEnd + 1);
+      if (i >= m_text.size() || m_text[i] != ':') return false;
+      i = SkipSpace(m_text, i + 1);
+
+      Context child = Context::Other;
+      size_t childSide = side;
+      if (context != Context::Other) child = ChildContext(context, key, childSide);
+      size_t valueStart = i;
+      if (!Value(i, depth, child, childSide)) return false;
+      if (context != Context::Other) Note(context, key, side, valueStart, i);
+
+      if (IsUnsafeKey(key)) {
+        m_unsafeKeys++;
+        if (cutStart == kNone) cutStart = keyStart;
+        cutEnd = i;
+      } else {
+        lastKeptEnd = i;
+      }
+
+      i = SkipSpace(m_text, i);
+      if (i >= m_text.size()) return false;
+      if (m_text[i] == ',') {
+        i = SkipSpace(m_text, i + 1);
+        continue;
+      }
+      if (m_text[i] != '}') return false;
+      if (cutStart != kNone) m_edits.push_back(Edit{lastKeptEnd != kNone ? lastKeptEnd : cutStart, cutEnd, {}});
+      ++i;
+      return true;
+    }
+  }
+
+  bool Array(size_t &i, size_t depth, Context context) {
+    if (depth > kMaxDepth) return false;
+    i = SkipSpace(m_text, i + 1);
+    if (i < m_text.size() && m_text[i] == ']') {
+      ++i;
+      return true;
+    }
+    // Only a stack's first frame goes into a log's fingerprint
+    Context element = context == Context::Stack ? Context::StackFrame : Context::Other;
+    for (;;) {
+      if (!Value(i, depth, element, 0)) return false;
+      element = Context::Other;
+      i = SkipSpace(m_text, i);
+      if (i >= m_text.size()) return false;
+      if (m_text[i] == ']') {
+        ++i;
+        return true;
+      }
+      if (m_text[i] != ',') return false;
+      i = SkipSpace(m_text, i + 1);
+    }
+  }
+
+  bool Literal(size_t &i, std::string_view literal) const {
+    if (m_text.substr(i, literal.size()) != literal) return false;
+    i += literal.size();
+    return true;
+  }
+
+  bool Number(size_t &i) const {
+    size_t start = i;
+    if (i < m_text.size() && m_text[i] == '-') ++i;
+    if (i >= m_text.size() || !IsDigit(m_text[i])) return false;
+    if (m_text[i] == '0') {
+      ++i;
+    } else {
+      while (i < m_text.size() && IsDigit(m_text[i])) ++i;
+    }
+    if (i < m_text.size() && m_text[i] == '.') {
+      if (++i >= m_text.size() || !IsDigit(m_text[i])) return false;
+      while (i < m_text.size() && IsDigit(m_text[i])) ++i;
+    }
+    if (i < m_text.size() && (m_text[i] == 'e' || m_text[i] == 'E')) {
+      ++i;
+      if (i < m_text.size() && (m_text[i] == '+' || m_text[i] == '-')) ++i;
+      if (i >= m_text.size() || !IsDigit(m_text[i])) return false;
+      while (i < m_text.size() && IsDigit(m_text[i])) ++i;
+    }
+    return i > start;
+  }
+
+  /**
+   * "__proto__", however it's escaped. JSON.parse makes it an ordinary
+   * property, but copying the object with Object.assign or a merge would
+   * replace the copy's prototype instead.
+   */
+  static bool IsUnsafeKey(std::string_view key) noexcept {
+    static constexpr std::string_view kProto = "__proto__";
+    if (key.find('\\') == std::string_view::npos) return key == kProto;
+    size_t matched = 0;
+    for (size_t i = 0; i < key.size(); ++i) {
+      char c = key[i];
+      if (c == '\\') {
+        if (key[i + 1] != 'u') return false; // Nothing else escapes to a letter or underscore
+        unsigned value = 0;
+        for (size_t j = 2; j <= 5; ++j) {
+          char h = key[i + j];
+          value = value * 16 + static_cast<unsigned>(IsDigit(h) ? h - '0' : (h | 0x20) - 'a' + 10);
+        }
+        if (value > 0x7F) return false;
+        c = static_cast<char>(value);
+        i += 5;
+      }
+      if (matched == kProto.size() || c != kProto[matched]) return false;
+      ++matched;
+    }
+    return matched == kProto.size();
+  }
+
+  static Context ChildContext(Context context, std::string_view key, size_t &side) noexcept {
+    switch (context) {
+      case Context::Envelope:
+        return key == "cmd" ? Context::Command : Context::Other;
+      case Context::Command:
+        return key == "payload" ? Context::Payload : Context::Other;
+      case Context::Payload:
+        if (key == "stack") return Context::Stack;
+        if (key == "request" || key == "response") {
+          side = key == "request" ? 0 : 1;
+          return key == "request" ? Context::Request : Context::Response;
+        }
+        return Context::Other;
+      case Context::Request:
+      case Context::Response:
+        return key == "headers" ? Context::Headers : Context::Other;
+      default:
+        return Context::Other;
+    }
+  }
+
+  /** Records the member `key` of an object in `context`, whose value is [start, end). */
+  void Note(Context context, std::string_view key, size_t side, size_t start, size_t end) {
+    std::string_view value = m_text.substr(start, end - start);
+    switch (context) {
+      case Context::Envelope:
+        if (key == "type") m_command = value == "\"command\"";
+        break;
+      case Context::Command:
+        if (key == "type") m_commandType = value;
+        if (key == "payload") m_payload = value;
+        if (key == "clientId") m_clientId = value;
+        if (key == "messageId") m_messageId = value;
+        break;
+      case Context::Payload:
+        if (key == "level") m_log.level = value;
+        if (key == "message") m_log.message = value;
+        if (key == "stack") m_log.stack = value;
+        break;
+      case Context::StackFrame:
+        if (key == "functionName") m_log.functionName = value;
+        if (key == "fileName") m_log.fileName = value;
+        if (key == "lineNumber") m_log.lineNumber = value;
+        break;
+      case Context::Request:
+      case Context::Response:
+        if (key == "data") {
+          m_bodies[side].start = start;
+          m_bodies[side].end = end;
+        }
+        break;
+      case Context::Headers:
+        if (value.empty() || value[0] != '"') break;
+        if (EqualsIgnoringCase(key, "content-type")) m_bodies[side].contentType = value;
+        if (EqualsIgnoringCase(key, "content-encoding")) m_bodies[side].contentEncoding = value;
+        break;
+      default:
+        break;
+    }
+  }
+
+  std::string_view m_text;
+  std::vector<Edit> m_edits;
+  size_t m_unsafeKeys = 0;
+  bool m_command = false;
+  std::string_view m_commandType;
+  std::string_view m_payload;
+  std::string_view m_clientId;
+  std::string_view m_messageId;
+  BodySpan m_bodies[2];
+  LogSpans m_log;
+};
+
+/** A header's value from its string literal, or "" if there's none. */
+std::string HeaderValue(std::string_view literal) {
+  std::string value;
+  if (!literal.empty() && !UnescapeJsonString(literal, value)) value.clear();
+  return value;
+}
+
+/**
+ * A payload member as text, as JS would turn it into one: a string's value,
+ * `missing` if it's absent, and anything else as its JSON, with the
+ * scanner's edits applied.
+ */
+std::string MemberText(MessageScanner &scanner, std::string_view span, std::string_view missing) {
+  if (span.empty()) return std::string(missing);
+  std::string text;
+  if (span[0] == '"') {
+    if (!UnescapeJsonString(span, text)) text.clear();
+    return text;
+  }
+  size_t start = scanner.Offset(span);
+  return scanner.Slice(start, start + span.size());
+}
+
+/**
+ * The log's stack top: an error's first non-blank stack line, or its first
+ * frame as "function (file:line)". Empty for other levels.
+ */
+std::string StackTop(MessageScanner &scanner, std::string_view level) {
+  const LogSpans &log = scanner.Log();
+  if (level != "error" || log.stack.empty()) return std::string();
+  if (log.stack[0] == '"') {
+    std::string stack = MemberText(scanner, log.stack, "");
+    size_t start = 0;
+    while (start < stack.size()) {
+      size_t end = std::min(stack.find('\n', start), stack.size());
+      size_t first = start;
+      size_t last = end;
+      while (first < last && std::isspace(static_cast<unsigned char>(stack[first]))) ++first;
+      while (last > first && std::isspace(static_cast<unsigned char>(stack[last - 1]))) --last;
+      if (first < last) return stack.substr(first, last - first);
+      start = end + 1;
+    }
+    return std::string();
+  }
+  if (log.stack[0] != '[' || log.stack == "[]" || SkipSpace(log.stack, 1) == log.stack.size() - 1) return std::string();
+  auto part = [&scanner](std::string_view span) {
+    return span == "null" ? std::string("?") : MemberText(scanner, span, "?");
+  };
+  return part(log.functionName) + " (" + part(log.fileName) + ":" + part(log.lineNumber) + ")";
+}
+
+/** Counts a log in SharedLogStats and returns its fingerprint: its level, message and stack top. */
+uint64_t RecordLog(MessageScanner &scanner) {
+  const LogSpans &log = scanner.Log();
+  std::string level = MemberText(scanner, log.level, "undefined");
+  std::string message = MemberText(scanner, log.message, "undefined");
+  std::string stackTop = StackTop(scanner, level);
+  auto &shared = SharedLogStats::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  return shared.stats.Record(level, message, stackTop);
+}
+
+/** Commands that become timeline items, whose payloads go into SharedPayloadArena. String literals, quotes included. */
+bool IsTimelineCommand(std::string_view type) noexcept {
+  return type == "\"log\"" || type == "\"api.response\"" || type == "\"display\"" ||
+         type == "\"state.action.complete\"" || type == "\"benchmark.report\"";
+}
+
+/** Stores the command's payload, with the scanner's edits, in SharedPayloadArena; 0 if it can't be. */
+uint32_t StorePayload(MessageScanner &scanner) {
+  std::string_view payload = scanner.Payload();
+  if (payload.empty()) return 0;
+  size_t start = scanner.Offset(payload);
+  std::string json = scanner.Slice(start, start + payload.size());
+  auto &shared = SharedPayloadArena::Get();
+  std::lock_guard<std::mutex> lock(shared.mutex);
+  return shared.arena.Store(json);
+}
+
+/** A "messageId" literal as JS would key by it: a whole number, or 0. */
+uint64_t MessageIdNumber(std::string_view literal) noexcept {
+  uint64_t id = 0;
+  for (char c : literal) {
+    if (!IsDigit(c) || id > UINT64_MAX / 10) return 0;
+    id = id * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return id;
+}
+
+} // namespace
+
+IngestPipeline::IngestPipeline(size_t workers, CommitCallback onCommit) : m_onCommit(std::move(onCommit)) {
+  if (workers == 0) workers = DefaultWorkers();
+  workers = std::min(workers, kMaxWorkers);
+  for (size_t i = 0; i < workers; ++i) m_workers.push_back(std::make_unique<Worker>());
+  for (size_t i = 0; i < workers; ++i) m_threads.emplace_back(&IngestPipeline::Run, this, i);
+}
+
+IngestPipeline::~IngestPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  for (std::thread &thread : m_threads) thread.join();
+}
+
+size_t IngestPipeline::DefaultWorkers() {
+  size_t cores = std::thread::hardware_concurrency();
+  return std::clamp<size_t>(cores > 1 ? cores - 1 : 1, 1, kMaxWorkers);
+}
+
+std::string_view IngestPipeline::ShardKey(std::string_view message) noexcept {
+  static constexpr std::string_view kKey = "clientId";
+  size_t depth = 0;
+  for (size_t i = 0; i < message.size(); ++i) {
+    char c = message[i];
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      --depth;
+    } else if (c == '"') {
+      size_t end = StringEnd(message, i);
+      if (end == kNone) return {};
+      // Only a key is followed by a colon
+      if (depth == 2 && end - i - 1 == kKey.size() && message.compare(i + 1, kKey.size(), kKey) == 0) {
+        size_t value = SkipSpace(message, end + 1);
+        if (value < message.size() && message[value] == ':') {
+          value = SkipSpace(message, value + 1);
+          if (value >= message.size() || message[value] != '"') return {};
+          size_t valueEnd = StringEnd(message, value);
+          if (valueEnd == kNone) return {};
+          return message.substr(value + 1, valueEnd - value - 1);
+        }
+      }
+      i = end;
+    }
+  }
+  return {};
+}
+
+void IngestPipeline::Submit(std::string message) {
+  std::string_view key = ShardKey(message);
+  Client *client = m_lastClient;
+  if (!client || client->id != key) {
+    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    auto it = m_clients.find(std::string(key));
+    if (it == m_clients.end()) {
+      auto created = std::make_unique<Client>();
+      created->id = std::string(key);
+      created->stats.clientId = created->id;
+      created->home = std::hash<std::string_view>()(key) % m_workers.size();
+      it = m_clients.emplace(created->id, std::move(created)).first;
+    }
+    client = it->second.get();
+    m_lastClient = client;
+  }
+
+  uint64_t sequence;
+  {
+    std::lock_guard<std::mutex> lock(m_commitMutex);
+    sequence = m_submitted++;
+    m_reorder.emplace_back();
+  }
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(client->mutex);
+    client->pending.push_back(Pending{sequence, std::move(message), {}, {}});
+    schedule = !client->scheduled;
+    client->scheduled = true;
+  }
+  if (schedule) Schedule(client, client->home);
+}
+
+void IngestPipeline::Drain() {
+  std::unique_lock<std::mutex> lock(m_commitMutex);
+  uint64_t target = m_submitted;
+  m_committedChanged.wait(lock, [&] { return m_committed >= target; });
+}
+
+IngestStats IngestPipeline::Stats() const {
+  IngestStats stats;
+  stats.workers = m_workers.size();
+  stats.steals = m_steals.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(m_commitMutex);
+    stats.submitted = m_submitted;
+    stats.committed = m_committed;
+  }
+  std::lock_guard<std::mutex> lock(m_clientsMutex);
+  for (const auto &[id, client] : m_clients) {
+    std::lock_guard<std::mutex> clientLock(client->mutex);
+    stats.clients.push_back(client->stats);
+  }
+  std::sort(stats.clients.begin(), stats.clients.end(),
+            [](const IngestClientStats &a, const IngestClientStats &b) { return a.clientId < b.clientId; });
+  return stats;
+}
+
+void IngestPipeline::Schedule(Client *client, size_t worker) {
+  {
+    std::lock_guard<std::mutex> lock(m_workers[worker]->mutex);
+    m_workers[worker]->queue.push_back(client);
+  }
+  m_queued.fetch_add(1);
+  { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+  m_wake.notify_one();
+}
+
+IngestPipeline::Client *IngestPipeline::NextClient(size_t index) {
+  auto take = [this](Worker &worker) -> Client * {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) return nullptr;
+    Client *client = worker.queue.front();
+    worker.queue.pop_front();
+    m_queued.fetch_sub(1);
+    return client;
+  };
+
+  for (;;) {
+    if (Client *client = take(*m_workers[index])) return client;
+    // The oldest waiting client elsewhere, so the commit point isn't held up behind it
+    for (size_t k = 1; k < m_workers.size(); ++k) {
+      if (Client *client = take(*m_workers[(index + k) % m_workers.size()])) {
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return client;
+      }
+    }
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+    if (m_stopping && m_queued.load() == 0) return nullptr;
+  }
+}
+
+void IngestPipeline::Run(size_t index) {
+  std::vector<Pending> turn;
+  std::vector<bool> keep;
+  while (Client *client = NextClient(index)) {
+    {
+      std::lock_guard<std::mutex> lock(client->mutex);
+      size_t count = std::min(client->pending.size(), kMessagesPerTurn);
+      for (size_t i = 0; i < count; ++i) {
+        turn.push_back(std::move(client->pending.front()));
+        client->pending.pop_front();
+      }
+    }
+
+    IngestClientStats delta;
+    for (Pending &pending : turn) keep.push_back(Process(pending.text, pending.item, pending.key, delta));
+
+    // Counted before committing, so Stats() after Drain() includes everything
+    bool more;
+    {
+      std::lock_guard<std::mutex> lock(client->mutex);
+      IngestClientStats &stats = client->stats;
+      stats.messages += delta.messages;
+      stats.bytes += delta.bytes;
+      stats.malformed += delta.malformed;
+      stats.unsafeKeys += delta.unsafeKeys;
+      stats.commands += delta.commands;
+      stats.bodies += delta.bodies;
+      stats.largestMessage = std::max(stats.largestMessage, delta.largestMessage);
+      more = !client->pending.empty();
+      client->scheduled = more;
+    }
+    Commit(turn, keep);
+    turn.clear();
+    keep.clear();
+    // Back of the queue, so the other clients here get their turn first
+    if (more) Schedule(client, index);
+  }
+}
+
+void IngestPipeline::Ingest(std::vector<std::string> &messages, std::vector<IngestedItem> &items) {
+  IngestClientStats delta;
+  items.clear();
+  size_t kept = 0;
+  auto &handles = SharedItemHandles::Get();
+  for (std::string &message : messages) {
+    IngestedItem item;
+    ItemKey key;
+    if (!Process(message, item, key, delta)) continue;
+    {
+      std::lock_guard<std::mutex> lock(handles.mutex);
+      NumberItem(key, item);
+    }
+    if (&messages[kept] != &message) messages[kept] = std::move(message);
+    items.push_back(item);
+    ++kept;
+  }
+  messages.resize(kept);
+}
+
+bool IngestPipeline::Process(std::string &text, IngestedItem &item, ItemKey &key, IngestClientStats &delta) {
+  delta.messages++;
+  delta.bytes += text.size();
+  delta.largestMessage = std::max<uint64_t>(delta.largestMessage, text.size());
+
+  MessageScanner scanner(text);
+  if (!scanner.Scan()) {
+    delta.malformed++;
+    return false;
+  }
+  if (scanner.IsCommand()) delta.commands++;
+  bool rewrite = scanner.UnsafeKeys() > 0;
+  delta.unsafeKeys += scanner.UnsafeKeys();
+
+  if (scanner.IsCommand() && scanner.CommandType() == "\"api.response\"") {
+    for (size_t side = 0; side < 2; ++side) {
+      const BodySpan &body = scanner.Body(side);
+      if (body.start == kNone || body.end - body.start < kMinLiftedBody) continue;
+      std::string raw = scanner.Slice(body.start, body.end);
+      const char *format = BodyFormatName(SniffBody(raw));
+      size_t size = raw.size();
+      uint32_t id = BodyStore::Shared().Store(std::move(raw), HeaderValue(body.contentType),
+                                              HeaderValue(body.contentEncoding));
+      scanner.Replace(body.start, body.end,
+                      "{\"$body\":" + std::to_string(id) + ",\"size\":" + std::to_string(size) + ",\"format\":\"" +
+                          format + "\"}");
+      delta.bodies++;
+      rewrite = true;
+    }
+  }
+  if (scanner.IsCommand() && scanner.CommandType() == "\"log\"") item.logKey = RecordLog(scanner);
+  if (scanner.IsCommand() && IsTimelineCommand(scanner.CommandType())) {
+    item.payloadHandle = StorePayload(scanner);
+    key.action = ItemKey::Action::Intern;
+    key.clientId = MemberText(scanner, scanner.ClientId(), "");
+    key.messageId = MessageIdNumber(scanner.MessageId());
+  } else if (scanner.IsCommand() && scanner.CommandType() == "\"clear\"") {
+    key.action = ItemKey::Action::Clear;
+  }
+  if (rewrite) text = scanner.Rewritten();
+  return true;
+}
+
+void IngestPipeline::NumberItem(ItemKey &key, IngestedItem &item) {
+  ItemHandleTable &table = SharedItemHandles::Get().table;
+  if (key.action == ItemKey::Action::Intern) item.itemId = table.Intern(key.clientId, key.messageId);
+  if (key.action == ItemKey::Action::Clear) table.Clear();
+}
+
+void IngestPipeline::Commit(std::vector<Pending> &turn, const std::vector<bool> &keep) {
+  std::lock_guard<std::mutex> lock(m_commitMutex);
+  for (size_t i = 0; i < turn.size(); ++i) {
+    Result &result = m_reorder[turn[i].sequence - m_committed];
+    result.done = true;
+    result.keep = keep[i];
+    if (keep[i]) {
+      result.text = std::move(turn[i].text);
+      result.item = turn[i].item;
+      result.key = std::move(turn[i].key);
+    }
+  }
+  if (!m_reorder.front().done) return;
+
+  uint64_t bytes = 0;
+  auto &handles = SharedItemHandles::Get();
+  std::unique_lock<std::mutex> numbering(handles.mutex);
+  while (!m_reorder.empty() && m_reorder.front().done) {
+    Result &result = m_reorder.front();
+    if (result.keep) {
+      NumberItem(result.key, result.item);
+      bytes += result.text.size();
+      m_ready.push_back(std::move(result.text));
+      m_readyItems.push_back(result.item);
+    }
+    m_reorder.pop_front();
+    m_committed++;
+  }
+  numbering.unlock();
+  if (!m_ready.empty()) {
+    m_onCommit(m_ready, m_readyItems, bytes);
+    m_ready.clear();
+    m_readyItems.clear();
+  }
+  m_committedChanged.notify_all();
+}
+
+} // namespace reactotron
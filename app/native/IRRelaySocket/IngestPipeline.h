@@ -0,0 +1,192 @@
+#pragma once
+
+//
+//  IngestPipeline.h
+//  Reactotron
+//
+//  Per-message work on what the relay sends, spread over a pool of worker
+//  threads. Messages are sharded by the clientId of the device that sent
+//  them: each client's messages go through its own queue, handled by one
+//  worker at a time, so they're processed in the order they arrived while
+//  different clients' run in parallel. A worker with nothing to do steals a
+//  waiting client from another's run queue, so clients stuck behind a busy
+//  one on the same worker don't wait for it.
+//
+//  Each message is parsed and validated, stripped of "__proto__" members and
+//  counted against its client. Large api.response bodies are moved into the
+//  BodyStore, and the message keeps a {"$body": id, "size", "format"}
+//  reference in their place, so JS doesn't parse bodies nobody opens. Logs
+//  are fingerprinted from the raw message and counted in SharedLogStats, so
+//  JS folds repeats by comparing keys instead of making a native call each.
+//  Timeline commands' payloads are stored in SharedPayloadArena from the
+//  message text, so JS never stringifies a payload to move it there; whoever
+//  takes a message owns its payload handle and must release it.
+//  Results pass through a single commit point that releases them in the
+//  order they were submitted, so JS sees exactly the order the relay sent.
+//  Timeline items are numbered there, in SharedItemHandles, so their handles
+//  count up in that order too, and a "clear" command clears the handles at
+//  the point in the stream it was sent.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct IngestClientStats {
+  std::string clientId; // "" for messages that aren't from a client
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  uint64_t malformed = 0;  // Not valid JSON, so dropped
+  uint64_t unsafeKeys = 0; // "__proto__" members removed
+  uint64_t commands = 0;
+  uint64_t bodies = 0; // Moved to the BodyStore
+  uint64_t largestMessage = 0; // Bytes
+};
+
+struct IngestStats {
+  size_t workers = 0;
+  uint64_t submitted = 0;
+  uint64_t committed = 0;
+  uint64_t steals = 0; // Clients a worker took from another's queue
+  std::vector<IngestClientStats> clients;
+};
+
+/** What the workers found out about a message, handed to JS beside it. */
+struct IngestedItem {
+  uint64_t logKey = 0; // The log's LogStats fingerprint; 0 if it isn't a log
+  uint32_t payloadHandle = 0; // A timeline command's payload in SharedPayloadArena; 0 if it wasn't stored
+  uint64_t itemId = 0; // A timeline command's handle in SharedItemHandles; 0 if it isn't one
+};
+
+/**
+ * The pipeline. Submit() from one thread (the socket's reader); the commit
+ * callback runs on the workers, one call at a time, in submission order.
+ * Stats() may be called from any thread.
+ */
+class IngestPipeline {
+ public:
+  /** Messages that made it through, in the order they were submitted, what was found out about each, and their total size. */
+  using CommitCallback =
+      std::function<void(std::vector<std::string> &messages, std::vector<IngestedItem> &items, uint64_t bytes)>;
+
+  static constexpr size_t kMaxWorkers = 8;
+  static constexpr size_t kMessagesPerTurn = 64; // Before a worker lets other clients have a go
+  static constexpr size_t kMinLiftedBody = 16 * 1024; // Smaller bodies stay in the message
+
+  /** `workers` 0 picks DefaultWorkers(). */
+  IngestPipeline(size_t workers, CommitCallback onCommit);
+  ~IngestPipeline();
+  IngestPipeline(const IngestPipeline &) = delete;
+  IngestPipeline &operator=(const IngestPipeline &) = delete;
+
+  void Submit(std::string message);
+  /** Waits until everything submitted so far has been committed. */
+  void Drain();
+
+  IngestStats Stats() const;
+
+  /**
+   * Runs the stages over `messages` on the calling thread, for messages that
+   * didn't come through a socket (a session being imported). Malformed ones
+   * are dropped; `items` is filled to match what's left.
+   */
+  static void Ingest(std::vector<std::string> &messages, std::vector<IngestedItem> &items);
+
+  /** One fewer than the cores, as the socket's reader and the JS thread need one each too. */
+  static size_t DefaultWorkers();
+
+  /**
+   * The clientId a relay message is about: the "clientId" of its "cmd" or
+   * "conn" object, or "" if there isn't one. Only scans as far as it needs
+   * to and doesn't validate the JSON; the worker does that.
+   */
+  static std::string_view ShardKey(std::string_view message) noexcept;
+
+ private:
+  /** What a message does to SharedItemHandles once it's committed. */
+  struct ItemKey {
+    enum class Action : uint8_t { None, Intern, Clear };
+    Action action = Action::None;
+    std::string clientId;
+    uint64_t messageId = 0;
+  };
+
+  struct Pending {
+    uint64_t sequence;
+    std::string text;
+    IngestedItem item;
+    ItemKey key;
+  };
+
+  /** A client's queue and counters. */
+  struct Client {
+    std::string id;
+    size_t home = 0; // The worker it's scheduled on first
+
+    std::mutex mutex; // Guards `pending`, `scheduled` and `stats`
+    std::deque<Pending> pending;
+    bool scheduled = false; // In a run queue or being worked on
+    IngestClientStats stats;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Client *> queue;
+  };
+
+  struct Result {
+    bool done = false;
+    bool keep = false;
+    std::string text;
+    IngestedItem item;
+    ItemKey key;
+  };
+
+  void Run(size_t index);
+  Client *NextClient(size_t index);
+  void Schedule(Client *client, size_t worker);
+  /** Runs the stages on `text`; false if it should be dropped. */
+  static bool Process(std::string &text, IngestedItem &item, ItemKey &key, IngestClientStats &delta);
+  /** Interns `key` into `item`, or clears the handles. Hold SharedItemHandles' mutex. */
+  static void NumberItem(ItemKey &key, IngestedItem &item);
+  /** Hands over a turn's results; `keep` is parallel to `turn`. */
+  void Commit(std::vector<Pending> &turn, const std::vector<bool> &keep);
+
+  CommitCallback m_onCommit;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wake;
+  std::atomic<size_t> m_queued{0}; // Clients in run queues
+  bool m_stopping = false;
+
+  mutable std::mutex m_clientsMutex;
+  std::unordered_map<std::string, std::unique_ptr<Client>> m_clients;
+  Client *m_lastClient = nullptr; // Submit()'s; clients are never removed
+
+  std::atomic<uint64_t> m_steals{0};
+
+  // The commit point: results wait here until everything before them is done
+  mutable std::mutex m_commitMutex;
+  std::condition_variable m_committedChanged;
+  std::deque<Result> m_reorder; // By sequence - m_committed
+  uint64_t m_committed = 0;
+  uint64_t m_submitted = 0; // Also the next sequence number
+  std::vector<std::string> m_ready;
+  std::vector<IngestedItem> m_readyItems;
+};
+
+} // namespace reactotron
@@ -0,0 +1,79 @@
+import type { EventEmitter } from "react-native/Libraries/Types/CodegenTypes"
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+/** Everything that happened on a socket since the last takeBatch(), in this order. */
+export interface RelaySocketBatch {
+  opened: boolean
+  messages: string[]
+  /**
+   * Per message: a log's fingerprint, the same for logs with the same level, message and stack
+   * top, or "" if it isn't a log.
+   */
+  logKeys: string[]
+  /**
+   * Per message: the IRPayloadArena handle of a timeline command's payload, or 0. The handle is
+   * the caller's to release, whether or not the message becomes a timeline item.
+   */
+  payloadHandles: number[]
+  /**
+   * Per message: a timeline command's IRIds item handle, numbered in the order the relay sent
+   * them, or 0. Handles are forgotten at a "clear" command, where it falls in the stream.
+   */
+  itemIds: number[]
+  /** Why the connection failed or dropped, or "". */
+  error: string
+  /** The socket is gone after a closed batch; its id won't be used again. */
+  closed: boolean
+}
+
+/** What a socket has received from one client, counted as messages pass through natively. */
+export interface RelayClientStats {
+  /** "" for messages that aren't from a client. */
+  clientId: string
+  messages: number
+  bytes: number
+  /** Not valid JSON, so dropped before reaching JS. */
+  malformed: number
+  /** "__proto__" members removed from its messages. */
+  unsafeKeys: number
+  commands: number
+  /** api.response bodies moved to IRBodyStore. */
+  bodies: number
+  largestMessage: number
+}
+
+/** Messages run through the socket's checks without a socket; see ingest(). */
+export interface IngestedMessages {
+  messages: string[]
+  logKeys: string[]
+  payloadHandles: number[]
+  itemIds: number[]
+}
+
+export interface RelaySocketPendingEvent {
+  socketId: number
+}
+
+export interface Spec extends TurboModule {
+  /**
+   * Starts connecting to a ws:// URL on a native I/O thread and returns the socket's id. A URL
+   * that isn't usable fails like any connection: its first batch is closed, with the reason.
+   */
+  connect(url: string): number
+  /** False if the socket isn't open. */
+  send(socketId: number, text: string): boolean
+  /** Closes the socket; returns 1 if it existed. Returns a value so it runs synchronously. */
+  close(socketId: number): number
+  takeBatch(socketId: number): RelaySocketBatch
+  clientStats(socketId: number): RelayClientStats[]
+  /**
+   * Validates, sanitizes and fingerprints messages that didn't come from the relay, such as an
+   * imported session's, as a socket would. Malformed messages are dropped.
+   */
+  ingest(texts: string[]): IngestedMessages
+  /** Sent once when a batch starts waiting, and not again until it's taken. */
+  readonly onRelaySocketPending: EventEmitter<RelaySocketPendingEvent>
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRRelaySocket")
@@ -0,0 +1,507 @@
+//
+//  RelaySocket.cpp
+//  Reactotron
+//
+
+#include "RelaySocket.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kReadSize = 64 * 1024;
+constexpr size_t kMaxHandshakeSize = 16 * 1024;
+constexpr std::string_view kAcceptGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+#if defined(_WIN32)
+using Socket = SOCKET;
+constexpr Socket kNoSocket = INVALID_SOCKET;
+inline void CloseSocket(Socket s) { closesocket(s); }
+constexpr int kShutdownBoth = SD_BOTH;
+constexpr int kSendFlags = 0;
+#else
+using Socket = int;
+constexpr Socket kNoSocket = -1;
+inline void CloseSocket(Socket s) { close(s); }
+constexpr int kShutdownBoth = SHUT_RDWR;
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0; // SO_NOSIGPIPE is set on the socket instead
+#endif
+#endif
+
+inline Socket ToSocket(intptr_t handle) noexcept { return static_cast<Socket>(handle); }
+
+inline uint32_t RotateLeft(uint32_t value, int bits) noexcept { return (value << bits) | (value >> (32 - bits)); }
+
+/** SHA-1, only to check the server's handshake answer. */
+std::string Sha1(std::string_view data) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string message(data);
+  uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+  message.push_back(static_cast<char>(0x80));
+  while (message.size() % 64 != 56) message.push_back(0);
+  for (int i = 7; i >= 0; --i) message.push_back(static_cast<char>(bits >> (i * 8)));
+
+  for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      const auto *p = reinterpret_cast<const uint8_t *>(message.data() + chunk + i * 4);
+      w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+    for (int i = 16; i < 80; ++i) w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t t = RotateLeft(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = RotateLeft(b, 30);
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  std::string digest;
+  for (uint32_t word : h) {
+    for (int i = 3; i >= 0; --i) digest.push_back(static_cast<char>(word >> (i * 8)));
+  }
+  return digest;
+}
+
+std::string Base64(std::string_view data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t n = uint32_t(uint8_t(data[i])) << 16;
+    if (i + 1 < data.size()) n |= uint32_t(uint8_t(data[i + 1])) << 8;
+    if (i + 2 < data.size()) n |= uint8_t(data[i + 2]);
+    out.push_back(kAlphabet[(n >> 18) & 63]);
+    out.push_back(kAlphabet[(n >> 12) & 63]);
+    out.push_back(i + 1 < data.size() ? kAlphabet[(n >> 6) & 63] : '=');
+    out.push_back(i + 2 < data.size() ? kAlphabet[n & 63] : '=');
+  }
+  return out;
+}
+
+inline char ToLower(char c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+/** The value of `name` in an HTTP response head, or "" if it's missing. */
+std::string_view Header(std::string_view head, std::string_view name) {
+  size_t line = head.find("\r\n");
+  while (line != std::string_view::npos && line + 2 < head.size()) {
+    size_t start = line + 2;
+    size_t end = head.find("\r\n", start);
+    if (end == std::string_view::npos) end = head.size();
+    std::string_view field = head.substr(start, end - start);
+    size_t colon = field.find(':');
+    if (colon == name.size()) {
+      bool same = true;
+      for (size_t i = 0; i < colon && same; ++i) same = ToLower(field[i]) == ToLower(name[i]);
+      if (same) {
+        std::string_view value = field.substr(colon + 1);
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        return value;
+      }
+    }
+    line = end;
+  }
+  return {};
+}
+
+#if defined(_WIN32)
+/** Winsock needs starting once per process; it's never stopped. */
+void StartSockets() {
+  static const bool started = [] {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+  }();
+  (void)started;
+}
+#else
+void StartSockets() {}
+#endif
+
+} // namespace
+
+RelaySocket::RelaySocket(PendingCallback onPending) : m_onPending(std::move(onPending)) {
+  m_ingest = std::make_unique<IngestPipeline>(
+      0, [this](std::vector<std::string> &messages, std::vector<IngestedItem> &items, uint64_t bytes) {
+        Queue([&](RelayBatch &batch) {
+          m_stats.messages += messages.size();
+          m_stats.bytes += bytes;
+          if (batch.messages.empty()) {
+            batch.messages.swap(messages);
+            batch.items.swap(items);
+          } else {
+            for (auto &text : messages) batch.messages.push_back(std::move(text));
+            batch.items.insert(batch.items.end(), items.begin(), items.end());
+          }
+        });
+      });
+}
+
+RelaySocket::~RelaySocket() { Close(); }
+
+void RelaySocket::Connect(std::string_view url) {
+  if (m_thread.joinable()) return;
+  // A URL that can't be used is reported as the connection failing
+  auto fail = [this](const char *error) {
+    Queue([error](RelayBatch &batch) {
+      batch.error = error;
+      batch.closed = true;
+    });
+  };
+  if (url.substr(0, 5) != "ws://") return fail("Only ws:// URLs are supported");
+  url.remove_prefix(5);
+  size_t slash = url.find('/');
+  std::string_view authority = url.substr(0, slash);
+  std::string path = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+
+  std::string host(authority);
+  uint16_t port = 80;
+  size_t colon = authority.rfind(':');
+  if (colon != std::string_view::npos && authority.find(']', colon) == std::string_view::npos) {
+    host = std::string(authority.substr(0, colon));
+    unsigned long parsed = 0;
+    std::string_view digits = authority.substr(colon + 1);
+    for (char c : digits) {
+      if (c < '0' || c > '9' || parsed > 65535) break;
+      parsed = parsed * 10 + static_cast<unsigned long>(c - '0');
+    }
+    if (digits.empty() || parsed == 0 || parsed > 65535) return fail("Invalid port");
+    port = static_cast<uint16_t>(parsed);
+  }
+  if (host.size() > 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+  if (host.empty()) return fail("Missing host");
+
+  m_closing = false;
+  m_thread = std::thread(&RelaySocket::Run, this, std::move(host), port, std::move(path));
+}
+
+bool RelaySocket::Send(std::string_view text) {
+  if (!m_open) return false;
+  return SendFrame(Opcode::Text, text);
+}
+
+void RelaySocket::Close() {
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_closing = true;
+    if (m_socket != -1) {
+      if (m_open) {
+        // Best effort close frame (status 1000), then stop the reader
+        static constexpr char kCloseFrame[] = {char(0x88), char(0x82), 0, 0, 0, 0, 0x03, char(0xE8)};
+        send(ToSocket(m_socket), kCloseFrame, sizeof(kCloseFrame), kSendFlags);
+      }
+      shutdown(ToSocket(m_socket), kShutdownBoth);
+    }
+  }
+  if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) m_thread.join();
+}
+
+RelayBatch RelaySocket::TakeBatch() {
+  std::lock_guard<std::mutex> lock(m_batchMutex);
+  RelayBatch batch = std::move(m_batch);
+  m_batch = RelayBatch();
+  m_notified = false;
+  if (!batch.messages.empty()) m_stats.batches++;
+  return batch;
+}
+
+RelaySocketStats RelaySocket::Stats() const {
+  std::lock_guard<std::mutex> lock(m_batchMutex);
+  return m_stats;
+}
+
+IngestStats RelaySocket::ClientStats() const { return m_ingest->Stats(); }
+
+void RelaySocket::Queue(const std::function<void(RelayBatch &)> &update) {
+  bool notify = false;
+  {
+    std::lock_guard<std::mutex> lock(m_batchMutex);
+    update(m_batch);
+    notify = !m_notified;
+    m_notified = true;
+  }
+  if (notify && m_onPending) m_onPending();
+}
+
+void RelaySocket::Run(std::string host, uint16_t port, std::string path) {
+  std::string buffer;
+  std::string error;
+  if (Open(host, port, path, buffer, error)) {
+    m_open = true;
+    Queue([](RelayBatch &batch) { batch.opened = true; });
+    error = Read(buffer);
+    // Everything read goes out before the close does
+    m_ingest->Drain();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_open = false;
+    if (m_socket != -1) CloseSocket(ToSocket(m_socket));
+    m_socket = -1;
+  }
+  // Closing on purpose isn't an error
+  if (m_closing) error.clear();
+  Queue([&error](RelayBatch &batch) {
+    batch.error = std::move(error);
+    batch.closed = true;
+  });
+}
+
+bool RelaySocket::Open(const std::string &host, uint16_t port, const std::string &path, std::string &buffer,
+                       std::string &error) {
+  StartSockets();
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *addresses = nullptr;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 || !addresses) {
+    error = "Could not resolve " + host;
+    return false;
+  }
+
+  bool connected = false;
+  for (addrinfo *address = addresses; address && !connected; address = address->ai_next) {
+    Socket s = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (s == kNoSocket) continue;
+    {
+      std::lock_guard<std::mutex> lock(m_sendMutex);
+      if (m_closing) {
+        CloseSocket(s);
+        break;
+      }
+      m_socket = static_cast<intptr_t>(s);
+    }
+    connected = connect(s, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0;
+    if (!connected) {
+      std::lock_guard<std::mutex> lock(m_sendMutex);
+      CloseSocket(s);
+      m_socket = -1;
+    }
+  }
+  freeaddrinfo(addresses);
+  if (!connected) {
+    error = "Could not connect to " + host + ":" + std::to_string(port);
+    return false;
+  }
+
+  Socket s = ToSocket(m_socket);
+  int on = 1;
+  setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&on), sizeof(on));
+#if defined(SO_NOSIGPIPE)
+  setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+  // Handshake
+  std::random_device random;
+  std::string nonce;
+  for (int i = 0; i < 16; ++i) nonce.push_back(static_cast<char>(random() & 0xFF));
+  std::string key = Base64(nonce);
+  std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + host + ":" + std::to_string(port) +
+                        "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+                        "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+  if (!WriteAll(request.data(), request.size())) {
+    error = "Could not send the handshake";
+    return false;
+  }
+
+  size_t headEnd;
+  char chunk[4096];
+  while ((headEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+    if (buffer.size() > kMaxHandshakeSize) {
+      error = "Handshake response too large";
+      return false;
+    }
+    int read = static_cast<int>(recv(s, chunk, sizeof(chunk), 0));
+    if (read <= 0) {
+      error = "Connection closed during the handshake";
+      return false;
+    }
+    buffer.append(chunk, static_cast<size_t>(read));
+  }
+  std::string_view head(buffer.data(), headEnd);
+  if (head.substr(0, 12) != "HTTP/1.1 101") {
+    error = "Server refused the upgrade: " + std::string(head.substr(0, head.find("\r\n")));
+    return false;
+  }
+  if (Header(head, "Sec-WebSocket-Accept") != Base64(Sha1(key + std::string(kAcceptGuid)))) {
+    error = "Server answered the handshake incorrectly";
+    return false;
+  }
+  // Anything after the head is already frames
+  buffer.erase(0, headEnd + 4);
+  return true;
+}
+
+std::string RelaySocket::Read(std::string &buffer) {
+  Socket s = ToSocket(m_socket);
+  std::string message; // Being reassembled from fragments
+  bool inMessage = false;
+  size_t offset = 0;   // Parsed up to here
+
+  for (;;) {
+    // Unframe everything complete in the buffer
+    for (;;) {
+      size_t available = buffer.size() - offset;
+      if (available < 2) break;
+      const auto *p = reinterpret_cast<const uint8_t *>(buffer.data() + offset);
+      bool fin = p[0] & 0x80;
+      auto opcode = static_cast<Opcode>(p[0] & 0x0F);
+      bool masked = p[1] & 0x80;
+      uint64_t length = p[1] & 0x7F;
+      size_t header = 2;
+      if (length == 126) {
+        if (available < 4) break;
+        length = (uint64_t(p[2]) << 8) | p[3];
+        header = 4;
+      } else if (length == 127) {
+        if (available < 10) break;
+        length = 0;
+        for (int i = 0; i < 8; ++i) length = (length << 8) | p[2 + i];
+        header = 10;
+      }
+      if (length > kMaxMessageSize) return "Message too large";
+      size_t maskOffset = header;
+      if (masked) header += 4;
+      if (available < header + length) break;
+
+      char *payload = buffer.data() + offset + header;
+      if (masked) {
+        for (size_t i = 0; i < length; ++i) payload[i] ^= static_cast<char>(p[maskOffset + (i & 3)]);
+      }
+      std::string_view data(payload, static_cast<size_t>(length));
+      offset += header + static_cast<size_t>(length);
+
+      switch (opcode) {
+        case Opcode::Text:
+        case Opcode::Binary:
+          if (inMessage) return "Unexpected new message inside a fragmented one";
+          if (fin) {
+            m_ingest->Submit(std::string(data));
+          } else {
+            message.assign(data);
+            inMessage = true;
+          }
+          break;
+        case Opcode::Continuation:
+          if (!inMessage) return "Unexpected continuation frame";
+          if (message.size() + data.size() > kMaxMessageSize) return "Message too large";
+          message.append(data);
+          if (fin) {
+            m_ingest->Submit(std::move(message));
+            message.clear();
+            inMessage = false;
+          }
+          break;
+        case Opcode::Ping:
+          SendFrame(Opcode::Pong, data);
+          break;
+        case Opcode::Pong:
+          break;
+        case Opcode::Close:
+          SendFrame(Opcode::Close, data.substr(0, 2));
+          buffer.clear();
+          return "";
+        default:
+          return "Unknown frame type";
+      }
+    }
+
+    buffer.erase(0, offset);
+    offset = 0;
+
+    size_t used = buffer.size();
+    buffer.resize(used + kReadSize);
+    int read = static_cast<int>(recv(s, buffer.data() + used, static_cast<int>(kReadSize), 0));
+    if (read <= 0) {
+      buffer.resize(used);
+      return m_closing ? "" : "Connection lost";
+    }
+    buffer.resize(used + static_cast<size_t>(read));
+  }
+}
+
+bool RelaySocket::SendFrame(Opcode opcode, std::string_view payload) {
+  // Masking only has to be unpredictable to intermediaries, not cryptographically strong
+  thread_local std::minstd_rand random(std::random_device{}());
+  uint32_t mask = static_cast<uint32_t>(random());
+  std::string frame;
+  frame.reserve(payload.size() + 14);
+  frame.push_back(static_cast<char>(0x80 | static_cast<uint8_t>(opcode)));
+  if (payload.size() < 126) {
+    frame.push_back(static_cast<char>(0x80 | payload.size()));
+  } else if (payload.size() <= 0xFFFF) {
+    frame.push_back(static_cast<char>(0x80 | 126));
+    frame.push_back(static_cast<char>(payload.size() >> 8));
+    frame.push_back(static_cast<char>(payload.size()));
+  } else {
+    frame.push_back(static_cast<char>(0x80 | 127));
+    for (int i = 7; i >= 0; --i) frame.push_back(static_cast<char>(uint64_t(payload.size()) >> (i * 8)));
+  }
+  char key[4];
+  std::memcpy(key, &mask, 4);
+  frame.append(key, 4);
+  size_t start = frame.size();
+  frame.append(payload);
+  for (size_t i = 0; i < payload.size(); ++i) frame[start + i] ^= key[i & 3];
+
+  std::lock_guard<std::mutex> lock(m_sendMutex);
+  if (m_socket == -1 || m_closing) return false;
+  return WriteAll(frame.data(), frame.size());
+}
+
+bool RelaySocket::WriteAll(const char *data, size_t size) {
+  Socket s = ToSocket(m_socket);
+  while (size > 0) {
+    int chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+    int sent = static_cast<int>(send(s, data, chunk, kSendFlags));
+    if (sent <= 0) return false;
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+} // namespace reactotron
@@ -0,0 +1,108 @@
+#pragma once
+
+//
+//  RelaySocket.h
+//  Reactotron
+//
+//  The WebSocket to the relay server, off the JS thread. An I/O thread of its
+//  own connects, reads and unframes messages, and queues them; JS takes
+//  everything queued so far in one call, once per frame, instead of running a
+//  callback per message. The owner is told (once, until it takes the batch)
+//  when something is waiting.
+//
+//  Messages are checked and sanitized on an IngestPipeline on the way, one
+//  client's in parallel with another's, and batched in the order they came.
+//
+//  Only what the relay needs: plain ws:// URLs, text messages, no extensions.
+//
+
+#include "IngestPipeline.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace reactotron {
+
+/** Everything that happened since the last TakeBatch(), in this order. */
+struct RelayBatch {
+  bool opened = false;
+  std::vector<std::string> messages;
+  std::vector<IngestedItem> items; // One per message
+  std::string error; // Why the connection failed or dropped, if it did
+  bool closed = false;
+};
+
+struct RelaySocketStats {
+  uint64_t messages = 0; // Received and passed on
+  uint64_t bytes = 0;
+  uint64_t batches = 0; // Taken with messages in them
+};
+
+/**
+ * One connection; Connect() once, then Close() or destroy it. Send(),
+ * TakeBatch() and Close() may be called from any thread.
+ */
+class RelaySocket {
+ public:
+  static constexpr size_t kMaxMessageSize = 64 * 1024 * 1024;
+
+  /** Called on the I/O thread when a batch starts waiting; not again until it's taken. */
+  using PendingCallback = std::function<void()>;
+
+  explicit RelaySocket(PendingCallback onPending);
+  ~RelaySocket();
+  RelaySocket(const RelaySocket &) = delete;
+  RelaySocket &operator=(const RelaySocket &) = delete;
+
+  /**
+   * Starts connecting to a ws://host[:port][/path] URL. A URL it can't use
+   * fails like a refused connection: a closed batch with the reason follows.
+   */
+  void Connect(std::string_view url);
+  /** Sends a text message; false if the socket isn't open. */
+  bool Send(std::string_view text);
+  /** Closes the connection and waits for the I/O thread. A closed batch follows if it was open. */
+  void Close();
+
+  RelayBatch TakeBatch();
+  RelaySocketStats Stats() const;
+  /** What the ingest pipeline has seen from each client. */
+  IngestStats ClientStats() const;
+
+ private:
+  enum class Opcode : uint8_t { Continuation = 0, Text = 1, Binary = 2, Close = 8, Ping = 9, Pong = 10 };
+
+  void Run(std::string host, uint16_t port, std::string path);
+  bool Open(const std::string &host, uint16_t port, const std::string &path, std::string &buffer, std::string &error);
+  /** Reads frames until the connection ends; returns why, or "" if it closed cleanly. */
+  std::string Read(std::string &buffer);
+  bool SendFrame(Opcode opcode, std::string_view payload);
+  bool WriteAll(const char *data, size_t size);
+
+  void Queue(const std::function<void(RelayBatch &)> &update);
+
+  PendingCallback m_onPending;
+  std::thread m_thread;
+  intptr_t m_socket = -1; // Set before the thread starts connecting; closed when it ends
+  std::atomic<bool> m_open{false};
+  std::atomic<bool> m_closing{false};
+  std::mutex m_sendMutex;
+
+  mutable std::mutex m_batchMutex;
+  RelayBatch m_batch;
+  bool m_notified = false;
+  RelaySocketStats m_stats;
+
+  // Last, so it stops before what it commits to goes away
+  std::unique_ptr<IngestPipeline> m_ingest;
+};
+
+} // namespace reactotron
@@ -7,10 +7,61 @@
 
 #import "IRRunShellCommand.h"
 #import <objc/runtime.h>
+#include "TerminalStream.h"
+#include "ShutdownCommands.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include "../TaskExecutor/TaskExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-task scrollback budget; the oldest lines are dropped past this
+static const size_t kTaskScrollbackByteCap = 4 * 1024 * 1024;
+// Most lines a single getTaskScrollback call returns
+static const NSUInteger kMaxScrollbackWindow = 2000;
+
+namespace {
+
+// Output state for one task. The stdout and stderr handlers run on different queues.
+struct TaskOutput {
+  std::mutex mutex;
+  reactotron::TerminalScrollback scrollback{kTaskScrollbackByteCap};
+  reactotron::TerminalStreamParser stdoutParser;
+  reactotron::TerminalStreamParser stderrParser;
+  // UTF-8 split across reads, held back from onShellCommandOutput until complete
+  std::string stdoutCarry;
+  std::string stderrCarry;
+  bool notifyPending = false;
+  int64_t lastWrite = 0; // ms since the epoch, so the memory governor trims idle tasks first
+};
+
+NSString *StringFromUtf8(const char *data, size_t length) {
+  NSString *string = [[NSString alloc] initWithBytes:data length:length encoding:NSUTF8StringEncoding];
+  if (string) return string;
+  // Invalid UTF-8 would otherwise drop the whole chunk
+  std::u16string utf16 = reactotron::Utf8ToUtf16(std::string_view(data, length));
+  return [NSString stringWithCharacters:reinterpret_cast<const unichar *>(utf16.data()) length:utf16.size()];
+}
+
+NSNumber *ColorNumber(uint32_t color) {
+  return color == reactotron::kTerminalDefaultColor ? @(-1) : @(color);
+}
 
-@interface IRRunShellCommand ()
+} // namespace
+
+@interface IRRunShellCommand () {
+  // Guarded by tasksLock. Kept after a task exits until clearTaskScrollback.
+  std::unordered_map<std::string, std::shared_ptr<TaskOutput>> _taskOutputs;
+  uint32_t _memoryStoreId;
+  BOOL _observingTermination;
+}
 
-@property (nonatomic, strong) NSMutableArray<NSString *> *shutdownCommands;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, NSTask *> *runningTasks;
 @property (nonatomic, strong) NSLock *tasksLock;
 
@@ -23,10 +74,19 @@
   if (self) {
     _runningTasks = [NSMutableDictionary dictionary];
     _tasksLock = [[NSLock alloc] init];
+    __weak IRRunShellCommand *weakSelf = self;
+    _memoryStoreId = reactotron::MemoryGovernor::Shared().Register("taskScrollback", [weakSelf](uint64_t bytes) -> uint64_t {
+      IRRunShellCommand *strongSelf = weakSelf;
+      return strongSelf ? [strongSelf _trimScrollback:bytes] : 0;
+    });
   }
   return self;
 }
 
+- (void)dealloc {
+  reactotron::MemoryGovernor::Shared().Unregister(_memoryStoreId);
+}
+
 
 // Below this are the interfaces that can be called from JS.
 
@@ -46,41 +106,52 @@
 
 /**
  * This method runs a command and returns the output as a string.
- * It's async, so use it for long-running commands.
+ * It's async, so use it for long-running commands. It runs in the shared
+ * executor's background lane, which never takes every worker, so a slow
+ * command can't hold up interactive work.
  */
 
 - (void)runAsync:(NSString *)command resolve:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
-  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-    @try {
-      NSString *output = [self _run_c:command];
-      dispatch_async(dispatch_get_main_queue(), ^{ resolve(output); });
-    } @catch (NSException *exception) {
-      dispatch_async(dispatch_get_main_queue(), ^{ reject(@"command_error", exception.reason, nil); });
-    }
-  });
-}
-
-- (NSString *)runSync:(NSString *)command {
-  return [self _run_c:command];
+  reactotron::TaskExecutor::Shared().Submit(
+      reactotron::TaskPriority::Background, reactotron::CancellationToken(),
+      [self, command](const reactotron::CancellationToken &) -> NSString * {
+        @try {
+          return [self _run_c:command];
+        } @catch (NSException *exception) {
+          throw std::runtime_error(exception.reason.UTF8String ?: "Command failed");
+        }
+      },
+      [resolve, reject](reactotron::TaskOutcome<NSString *> outcome) {
+        if (outcome.status == reactotron::TaskStatus::Completed) {
+          resolve(outcome.value);
+        } else {
+          reject(@"command_error", StringFromUtf8(outcome.error.data(), outcome.error.size()), nil);
+        }
+      });
 }
 
 /*
- * Executes a shell command asynchronously on a background queue.
+ * Launches a shell command from the shared executor's interactive lane.
  * Captures both stdout and stderr streams, and emits events with their output and completion status.
+ * Output is also parsed into a styled per-task scrollback, see getTaskScrollback.
+ * Completion is reported by the task's termination handler, so no worker waits for it to exit.
  */
 
 - (void)runTaskWithCommand:(NSString *)command
                       args:(NSArray<NSString *> *)args
                     taskId:(NSString *)taskId {
-  dispatch_async(
-    dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+  reactotron::TaskExecutor::Shared().Post(
+    reactotron::TaskPriority::Interactive, [self, command, args, taskId] {
       @autoreleasepool {
         NSTask *task = [NSTask new];
         task.executableURL = [NSURL fileURLWithPath:command];
         task.arguments = args;
 
+        auto taskOutput = std::make_shared<TaskOutput>();
+
         [self.tasksLock lock];
         self.runningTasks[taskId] = task;
+        self->_taskOutputs[taskId.UTF8String] = taskOutput;
         [self.tasksLock unlock];
 
         NSPipe *outPipe = [NSPipe pipe];
@@ -97,10 +168,8 @@
               NSData *d = h.availableData;
               if (d.length == 0)
                 return;
-              NSString *output =
-              [[NSString alloc] initWithData:d
-                                    encoding:NSUTF8StringEncoding];
-              if (output && !completed) {
+              NSString *output = [self _consumeOutput:d stream:stream taskId:taskId taskOutput:taskOutput];
+              if (output.length > 0 && !completed) {
                 dispatch_async(dispatch_get_main_queue(), ^{
                   if (!completed) {
                     [self emitOnShellCommandOutput:@{
@@ -135,7 +204,31 @@
           outPipe.fileHandleForReading.readabilityHandler = nil;
           errPipe.fileHandleForReading.readabilityHandler = nil;
 
+          // A character the task never finished is sent as is, rather than lost
+          std::string stdoutTail, stderrTail;
+          {
+            std::lock_guard<std::mutex> lock(taskOutput->mutex);
+            stdoutTail.swap(taskOutput->stdoutCarry);
+            stderrTail.swap(taskOutput->stderrCarry);
+          }
+          NSString *stdoutRest = stdoutTail.empty() ? nil : StringFromUtf8(stdoutTail.data(), stdoutTail.size());
+          NSString *stderrRest = stderrTail.empty() ? nil : StringFromUtf8(stderrTail.data(), stderrTail.size());
+
           dispatch_async(dispatch_get_main_queue(), ^{
+            if (stdoutRest.length > 0) {
+              [self emitOnShellCommandOutput:@{
+              @"taskId" : taskId,
+              @"output" : stdoutRest,
+              @"type" : @"stdout"
+              }];
+            }
+            if (stderrRest.length > 0) {
+              [self emitOnShellCommandOutput:@{
+              @"taskId" : taskId,
+              @"output" : stderrRest,
+              @"type" : @"stderr"
+              }];
+            }
             [self emitOnShellCommandComplete:@{
             @"taskId" : taskId,
             @"exitCode" : @(t.terminationStatus)
@@ -153,10 +246,14 @@
           [self.runningTasks removeObjectForKey:taskId];
           [self.tasksLock unlock];
 
+          NSString *message = err.localizedDescription ?: @"launch error";
+          NSData *messageData = [[message stringByAppendingString:@"\n"] dataUsingEncoding:NSUTF8StringEncoding];
+          [self _consumeOutput:messageData stream:@"stderr" taskId:taskId taskOutput:taskOutput];
+
           dispatch_async(dispatch_get_main_queue(), ^{
             [self emitOnShellCommandOutput:@{
             @"taskId" : taskId,
-            @"output" : err.localizedDescription ?: @"launch error",
+            @"output" : message,
             @"type" : @"stderr"
             }];
             [self emitOnShellCommandComplete:@{
@@ -166,10 +263,174 @@
           });
           return;
         }
+      }
+    });
+}
 
-        [task waitUntilExit];
+/**
+ * Feeds a chunk of task output into the task's scrollback and returns the text for
+ * onShellCommandOutput, with any UTF-8 character split by the read held back for the
+ * next chunk. Scrollback change events are coalesced to one per main queue turn.
+ */
+- (NSString *)_consumeOutput:(NSData *)data
+                      stream:(NSString *)stream
+                      taskId:(NSString *)taskId
+                  taskOutput:(std::shared_ptr<TaskOutput>)taskOutput {
+  BOOL isStderr = [stream isEqualToString:@"stderr"];
+  const char *bytes = static_cast<const char *>(data.bytes);
+  std::string text;
+  BOOL scheduleNotify = NO;
+  {
+    std::lock_guard<std::mutex> lock(taskOutput->mutex);
+    auto &parser = isStderr ? taskOutput->stderrParser : taskOutput->stdoutParser;
+    parser.Feed(bytes, data.length, taskOutput->scrollback);
+    taskOutput->lastWrite = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::string &carry = isStderr ? taskOutput->stderrCarry : taskOutput->stdoutCarry;
+    carry.append(bytes, data.length);
+    size_t complete = carry.size() - reactotron::Utf8IncompleteTailLength(carry.data(), carry.size());
+    text.assign(carry, 0, complete);
+    carry.erase(0, complete);
+
+    if (!taskOutput->notifyPending) {
+      taskOutput->notifyPending = true;
+      scheduleNotify = YES;
+    }
+  }
+
+  if (scheduleNotify) {
+    dispatch_async(dispatch_get_main_queue(), ^{
+      uint64_t firstLine, endLine, firstChangedLine;
+      {
+        std::lock_guard<std::mutex> lock(taskOutput->mutex);
+        taskOutput->notifyPending = false;
+        firstLine = taskOutput->scrollback.FirstLine();
+        endLine = taskOutput->scrollback.EndLine();
+        firstChangedLine = taskOutput->scrollback.TakeFirstChangedLine();
       }
+      [self _reportScrollbackMemory];
+      if (firstChangedLine >= endLine) return;
+      [self emitOnShellCommandScrollback:@{
+        @"taskId" : taskId,
+        @"firstLine" : @(firstLine),
+        @"endLine" : @(endLine),
+        @"firstChangedLine" : @(firstChangedLine)
+      }];
     });
+  }
+
+  return StringFromUtf8(text.data(), text.size());
+}
+
+/**
+ * Tells the memory governor how much all the tasks' scrollback holds.
+ */
+- (void)_reportScrollbackMemory {
+  uint64_t bytes = 0;
+  int64_t oldest = 0;
+  [self.tasksLock lock];
+  for (const auto &entry : _taskOutputs) {
+    std::lock_guard<std::mutex> lock(entry.second->mutex);
+    bytes += entry.second->scrollback.ByteSize();
+    if (entry.second->lastWrite && (!oldest || entry.second->lastWrite < oldest)) oldest = entry.second->lastWrite;
+  }
+  [self.tasksLock unlock];
+  reactotron::MemoryGovernor::Shared().Report(_memoryStoreId, bytes, oldest);
+}
+
+/**
+ * The memory governor's eviction callback. Drops the oldest lines of the tasks written to
+ * least recently, until about `bytes` are freed, and returns how many were.
+ */
+- (uint64_t)_trimScrollback:(uint64_t)bytes {
+  uint64_t freed = 0;
+  [self.tasksLock lock];
+  std::vector<std::pair<int64_t, std::shared_ptr<TaskOutput>>> outputs;
+  for (const auto &entry : _taskOutputs) {
+    std::lock_guard<std::mutex> lock(entry.second->mutex);
+    outputs.emplace_back(entry.second->lastWrite, entry.second);
+  }
+  std::sort(outputs.begin(), outputs.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  for (const auto &output : outputs) {
+    if (freed >= bytes) break;
+    std::lock_guard<std::mutex> lock(output.second->mutex);
+    freed += output.second->scrollback.Trim(bytes - freed);
+  }
+  [self.tasksLock unlock];
+  [self _reportScrollbackMemory];
+  return freed;
+}
+
+- (std::shared_ptr<TaskOutput>)_taskOutputForId:(NSString *)taskId {
+  [self.tasksLock lock];
+  auto it = _taskOutputs.find(taskId.UTF8String);
+  std::shared_ptr<TaskOutput> taskOutput = it == _taskOutputs.end() ? nullptr : it->second;
+  [self.tasksLock unlock];
+  return taskOutput;
+}
+
+/**
+ * Returns up to `lineCount` styled lines starting at `startLine` (clamped to the
+ * retained range). Span offsets are in UTF-16 code units so JS can slice `text`.
+ */
+- (NSDictionary *)getTaskScrollback:(NSString *)taskId startLine:(double)startLine lineCount:(double)lineCount {
+  std::shared_ptr<TaskOutput> taskOutput = [self _taskOutputForId:taskId];
+  if (!taskOutput) {
+    return @{ @"firstLine" : @0, @"endLine" : @0, @"lines" : @[] };
+  }
+
+  std::lock_guard<std::mutex> lock(taskOutput->mutex);
+  const reactotron::TerminalScrollback &scrollback = taskOutput->scrollback;
+  uint64_t firstLine = scrollback.FirstLine();
+  uint64_t endLine = scrollback.EndLine();
+  uint64_t start = startLine > 0 ? std::max(firstLine, static_cast<uint64_t>(startLine)) : firstLine;
+  uint64_t count = lineCount > 0 ? std::min(static_cast<uint64_t>(lineCount), static_cast<uint64_t>(kMaxScrollbackWindow)) : 0;
+  uint64_t end = std::min(endLine, start + count);
+
+  NSMutableArray *lines = [NSMutableArray arrayWithCapacity:end > start ? end - start : 0];
+  for (uint64_t index = start; index < end; index++) {
+    const reactotron::TerminalLine *line = scrollback.Line(index);
+    NSMutableArray<NSNumber *> *spans = [NSMutableArray arrayWithCapacity:line->spans.size() * 5];
+    // Spans are sorted, so byte offsets convert to UTF-16 offsets in one pass
+    size_t byteOffset = 0;
+    size_t utf16Offset = 0;
+    for (const reactotron::TerminalSpan &span : line->spans) {
+      utf16Offset += reactotron::Utf16LengthForUtf8(line->text.data() + byteOffset, span.start - byteOffset);
+      size_t utf16Length = reactotron::Utf16LengthForUtf8(line->text.data() + span.start, span.length);
+      [spans addObject:@(utf16Offset)];
+      [spans addObject:@(utf16Length)];
+      [spans addObject:ColorNumber(span.style.foreground)];
+      [spans addObject:ColorNumber(span.style.background)];
+      [spans addObject:@(span.style.flags)];
+      byteOffset = span.start + span.length;
+      utf16Offset += utf16Length;
+    }
+    [lines addObject:@{
+      @"text" : StringFromUtf8(line->text.data(), line->text.size()),
+      @"spans" : spans
+    }];
+  }
+
+  return @{ @"firstLine" : @(firstLine), @"endLine" : @(endLine), @"lines" : lines };
+}
+
+/**
+ * Frees a task's scrollback. A running task starts over with an empty one.
+ */
+- (void)clearTaskScrollback:(NSString *)taskId {
+  [self.tasksLock lock];
+  auto it = _taskOutputs.find(taskId.UTF8String);
+  if (it != _taskOutputs.end()) {
+    if (self.runningTasks[taskId]) {
+      std::lock_guard<std::mutex> lock(it->second->mutex);
+      it->second->scrollback.Clear();
+    } else {
+      _taskOutputs.erase(it);
+    }
+  }
+  [self.tasksLock unlock];
+  [self _reportScrollbackMemory];
 }
 
 - (NSNumber *)killTaskWithId:(NSString *)taskId {
@@ -262,9 +523,9 @@
   return result;
 }
 
-- (void)runCommandOnShutdown:(NSString *)command {
-  if (!self.shutdownCommands) {
-    self.shutdownCommands = [NSMutableArray array];
+- (void)runCommandOnShutdown:(NSString *)command captureOutput:(NSNumber *)captureOutput deadlineMs:(NSNumber *)deadlineMs {
+  if (!_observingTermination) {
+    _observingTermination = YES;
 
     // Register for the NSApplicationWillTerminateNotification
     [[NSNotificationCenter defaultCenter]
@@ -274,24 +535,22 @@
      object:nil
     ];
   }
-  [self.shutdownCommands addObject:command];
+  double deadline = deadlineMs.doubleValue;
+  reactotron::ShutdownCommands::Shared().Add(
+      command.UTF8String ?: "", captureOutput.boolValue,
+      deadline > 0 ? static_cast<uint32_t>(std::min(deadline, double(UINT32_MAX))) : reactotron::ShutdownCommands::kQuitDeadline);
 }
 
 - (void)_handleAppTermination:(NSNotification *)notification {
   // Remove the observer
   [[NSNotificationCenter defaultCenter] removeObserver:self name:NSApplicationWillTerminateNotification object:nil];
 
-  // If there are no shutdown commands, do nothing
-  if (!self.shutdownCommands || self.shutdownCommands.count == 0) return;
-
-  // Run all shutdown commands
-  for (NSString *command in self.shutdownCommands) {
-    NSLog(@"Running shutdown command: %@", command);
-    [self _run_c:command];
+  // Run all shutdown commands at once; quitting waits for them only up to the deadline
+  for (const auto &result : reactotron::ShutdownCommands::Shared().Run()) {
+    std::string line = reactotron::ShutdownCommands::Describe(result);
+    NSLog(@"[IRRunShellCommand] Shutdown command %@", StringFromUtf8(line.data(), line.size()));
+    if (!result.output.empty()) NSLog(@"%@", StringFromUtf8(result.output.data(), result.output.size()));
   }
-
-  // Clear the shutdown commands
-  self.shutdownCommands = nil;
 }
 
 // Required by TurboModules.
@@ -7,6 +7,7 @@
 
 #include "pch.h"
 #include "IRRunShellCommand.windows.h"
+#include <algorithm>
 #include <process.h>
 
 namespace winrt::reactotron::implementation
@@ -34,15 +35,13 @@ namespace winrt::reactotron::implementation
         promise.Resolve("");
     }
 
-    std::string IRRunShellCommand::runSync(std::string command) noexcept
+    void IRRunShellCommand::runCommandOnShutdown(std::string command, std::optional<bool> captureOutput, std::optional<double> deadlineMs) noexcept
     {
-        // TODO: Run Windows command synchronously
-        return "";
-    }
-
-    void IRRunShellCommand::runCommandOnShutdown(std::string command) noexcept
-    {
-        // TODO: Register Windows command to run on application shutdown
+        // Run by WinMain once the app window closes
+        double deadline = deadlineMs.value_or(0);
+        ::reactotron::ShutdownCommands::Shared().Add(
+            std::move(command), captureOutput.value_or(false),
+            deadline > 0 ? static_cast<uint32_t>(std::min(deadline, double(UINT32_MAX))) : ::reactotron::ShutdownCommands::kQuitDeadline);
     }
 
     void IRRunShellCommand::runTaskWithCommand(std::string command, Microsoft::ReactNative::JSValue args, std::string taskId) noexcept
@@ -69,4 +68,5 @@ namespace winrt::reactotron::implementation
     {
         // TODO: Kill all running Windows tasks
     }
+
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "NativeModules.h"
+#include "ShutdownCommands.h"
 
 namespace winrt::reactotron::implementation
 {
@@ -17,11 +18,8 @@ namespace winrt::reactotron::implementation
         REACT_METHOD(runAsync)
         void runAsync(std::string command, Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept;
 
-        REACT_SYNC_METHOD(runSync)
-        std::string runSync(std::string command) noexcept;
-
         REACT_METHOD(runCommandOnShutdown)
-        void runCommandOnShutdown(std::string command) noexcept;
+        void runCommandOnShutdown(std::string command, std::optional<bool> captureOutput, std::optional<double> deadlineMs) noexcept;
 
         REACT_METHOD(runTaskWithCommand)
         void runTaskWithCommand(std::string command, Microsoft::ReactNative::JSValue args, std::string taskId) noexcept;
@@ -35,6 +33,9 @@ namespace winrt::reactotron::implementation
         REACT_METHOD(killAllTasks)
         void killAllTasks() noexcept;
 
+        // getTaskScrollback, clearTaskScrollback and onShellCommandScrollback are macOS only until
+        // runTaskWithCommand runs tasks here
+
         REACT_EVENT(onShellCommandOutput)
         std::function<void(Microsoft::ReactNative::JSValue)> onShellCommandOutput;
 
@@ -13,18 +13,53 @@ export interface ShellCommandCompleteEvent {
   exitCode: number
 }
 
+/**
+ * Lines are numbered from the start of the task and keep counting up as old lines are
+ * dropped, so [firstLine, endLine) is what's still retained.
+ */
+export interface ShellCommandScrollbackEvent {
+  taskId: string
+  firstLine: number
+  endLine: number
+  firstChangedLine: number
+}
+
+export interface TerminalLine {
+  text: string
+  /**
+   * Flattened [start, length, foreground, background, flags] tuples, in UTF-16 units of
+   * `text`. Colors are -1 (default), 0-255 (palette) or 0x1000000 | 0xRRGGBB. Flags:
+   * 1 bold, 2 dim, 4 italic, 8 underline, 16 inverse, 32 strikethrough.
+   */
+  spans: ReadonlyArray<number>
+}
+
+export interface TaskScrollback {
+  firstLine: number
+  endLine: number
+  lines: ReadonlyArray<TerminalLine>
+}
+
 export interface Spec extends TurboModule {
   appPath(): string
   appPID(): number
   runAsync(command: string): Promise<string>
-  runSync(command: string): string
-  runCommandOnShutdown(command: string): void
+  /**
+   * Runs `command` when the app quits, alongside the other shutdown commands. Quitting waits
+   * for them for up to 3 seconds, or `deadlineMs` if that's sooner, then stops whatever's
+   * still running. Output is only kept (and logged) if `captureOutput` is set.
+   */
+  runCommandOnShutdown(command: string, captureOutput?: boolean, deadlineMs?: number): void
   runTaskWithCommand(command: string, args: string[], taskId: string): void
   getRunningTaskIds(): ReadonlyArray<string>
   killTaskWithId(taskId: string): boolean
   killAllTasks(): void
+  /** macOS only, as are clearTaskScrollback and onShellCommandScrollback. */
+  getTaskScrollback(taskId: string, startLine: number, lineCount: number): TaskScrollback
+  clearTaskScrollback(taskId: string): void
   readonly onShellCommandOutput: EventEmitter<ShellCommandOutputEvent>
   readonly onShellCommandComplete: EventEmitter<ShellCommandCompleteEvent>
+  readonly onShellCommandScrollback: EventEmitter<ShellCommandScrollbackEvent>
 }
 
 export default TurboModuleRegistry.getEnforcing<Spec>("IRRunShellCommand")
@@ -0,0 +1,340 @@
+//
+//  ShutdownCommands.cpp
+//  Reactotron
+//
+
+#include "ShutdownCommands.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include "../TextTranscoding/TextTranscoding.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+namespace reactotron {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How often exits are checked for while output is idle
+constexpr auto kPollInterval = std::chrono::milliseconds(5);
+
+struct Running {
+  bool capture = false;
+  bool exited = false;
+  bool terminated = false;
+  bool killed = false;
+  Clock::time_point start;
+  Clock::time_point deadline;
+#if defined(_WIN32)
+  HANDLE process = nullptr;
+  HANDLE job = nullptr; // So stopping the command stops what it started, too
+  HANDLE output = nullptr;
+#else
+  pid_t pid = -1; // Also its process group
+  int output = -1;
+#endif
+};
+
+void AppendOutput(ShutdownCommandResult &result, const char *data, size_t size) {
+  size_t room = ShutdownCommands::kMaxOutputBytes - std::min(result.output.size(), ShutdownCommands::kMaxOutputBytes);
+  result.output.append(data, std::min(size, room));
+}
+
+#if defined(_WIN32)
+
+bool Launch(const std::string &command, Running &running) {
+  SECURITY_ATTRIBUTES inherit = {sizeof(inherit), nullptr, TRUE};
+  HANDLE readEnd = nullptr, writeEnd = nullptr;
+  if (running.capture && CreatePipe(&readEnd, &writeEnd, &inherit, 0)) {
+    SetHandleInformation(readEnd, HANDLE_FLAG_INHERIT, 0);
+  } else {
+    running.capture = false;
+  }
+  HANDLE nul = CreateFileW(L"NUL", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &inherit,
+                           OPEN_EXISTING, 0, nullptr);
+
+  STARTUPINFOW startup = {};
+  startup.cb = sizeof(startup);
+  startup.dwFlags = STARTF_USESTDHANDLES;
+  startup.hStdInput = nul;
+  startup.hStdOutput = startup.hStdError = running.capture ? writeEnd : nul;
+
+  std::u16string line = Utf8ToUtf16("cmd.exe /d /s /c \"" + command + "\"");
+  std::wstring commandLine(line.begin(), line.end());
+  PROCESS_INFORMATION info = {};
+  BOOL created = CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, TRUE,
+                                CREATE_NO_WINDOW | CREATE_SUSPENDED, nullptr, nullptr, &startup, &info);
+  if (nul != INVALID_HANDLE_VALUE) CloseHandle(nul);
+  if (writeEnd) CloseHandle(writeEnd);
+  if (!created) {
+    if (readEnd) CloseHandle(readEnd);
+    return false;
+  }
+
+  running.job = CreateJobObjectW(nullptr, nullptr);
+  if (running.job && !AssignProcessToJobObject(running.job, info.hProcess)) {
+    CloseHandle(running.job);
+    running.job = nullptr;
+  }
+  ResumeThread(info.hThread);
+  CloseHandle(info.hThread);
+  running.process = info.hProcess;
+  running.output = readEnd;
+  return true;
+}
+
+void ReadOutput(Running &running, ShutdownCommandResult &result) {
+  char buffer[4096];
+  while (running.output) {
+    DWORD available = 0, read = 0;
+    if (!PeekNamedPipe(running.output, nullptr, 0, nullptr, &available, nullptr)) {
+      CloseHandle(running.output);
+      running.output = nullptr;
+      return;
+    }
+    if (!available || !ReadFile(running.output, buffer, std::min<DWORD>(available, sizeof(buffer)), &read, nullptr)) {
+      return;
+    }
+    AppendOutput(result, buffer, read);
+  }
+}
+
+bool Reap(Running &running, ShutdownCommandResult &result) {
+  if (WaitForSingleObject(running.process, 0) != WAIT_OBJECT_0) return false;
+  DWORD exitCode = 0;
+  result.exitCode = GetExitCodeProcess(running.process, &exitCode) ? static_cast<int>(exitCode) : -1;
+  return true;
+}
+
+// Windows has no SIGTERM for processes without a console, so asking a command to stop ends it
+void Terminate(Running &running) {
+  if (running.job) {
+    TerminateJobObject(running.job, 1);
+  } else {
+    TerminateProcess(running.process, 1);
+  }
+}
+
+void Kill(Running &running) { Terminate(running); }
+
+void Close(Running &running) {
+  if (running.output) CloseHandle(running.output);
+  if (running.job) CloseHandle(running.job);
+  if (running.process) CloseHandle(running.process);
+  running.output = running.job = running.process = nullptr;
+}
+
+void Wait(std::vector<Running> &, Clock::duration timeout) { std::this_thread::sleep_for(timeout); }
+
+#else
+
+bool Launch(const std::string &command, Running &running) {
+  int pipeFds[2] = {-1, -1};
+  if (running.capture && pipe(pipeFds) == 0) {
+    // Only the dup2'd copies reach the command
+    fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+    fcntl(pipeFds[0], F_SETFL, O_NONBLOCK);
+  } else {
+    running.capture = false;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  if (running.capture) {
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+  } else {
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  }
+
+  // A process group of its own, so signals reach whatever the command starts
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+  posix_spawnattr_setpgroup(&attributes, 0);
+  sigset_t signals;
+  sigemptyset(&signals);
+  posix_spawnattr_setsigmask(&attributes, &signals);
+  sigaddset(&signals, SIGPIPE);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGHUP);
+  posix_spawnattr_setsigdefault(&attributes, &signals);
+
+  const char *argv[] = {"/bin/sh", "-c", command.c_str(), nullptr};
+  pid_t pid = -1;
+  int error = posix_spawn(&pid, "/bin/sh", &actions, &attributes, const_cast<char *const *>(argv), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attributes);
+  if (pipeFds[1] >= 0) close(pipeFds[1]);
+  if (error != 0) {
+    if (pipeFds[0] >= 0) close(pipeFds[0]);
+    return false;
+  }
+  running.pid = pid;
+  running.output = running.capture ? pipeFds[0] : -1;
+  return true;
+}
+
+void ReadOutput(Running &running, ShutdownCommandResult &result) {
+  char buffer[4096];
+  while (running.output >= 0) {
+    ssize_t read = ::read(running.output, buffer, sizeof(buffer));
+    if (read > 0) {
+      AppendOutput(result, buffer, static_cast<size_t>(read));
+    } else if (read < 0 && errno == EINTR) {
+      continue;
+    } else {
+      // EOF, or EAGAIN until there's more
+      if (read == 0) {
+        close(running.output);
+        running.output = -1;
+      }
+      return;
+    }
+  }
+}
+
+bool Reap(Running &running, ShutdownCommandResult &result) {
+  int status = 0;
+  pid_t reaped = waitpid(running.pid, &status, WNOHANG);
+  if (reaped == 0 || (reaped < 0 && errno == EINTR)) return false;
+  if (reaped == running.pid && WIFEXITED(status)) {
+    result.exitCode = WEXITSTATUS(status);
+  } else if (reaped == running.pid && WIFSIGNALED(status)) {
+    result.exitCode = 128 + WTERMSIG(status);
+  }
+  // Otherwise something else reaped it (SIGCHLD ignored); the exit code is lost
+  return true;
+}
+
+void Terminate(Running &running) { kill(-running.pid, SIGTERM); }
+
+void Kill(Running &running) { kill(-running.pid, SIGKILL); }
+
+void Close(Running &running) {
+  if (running.output >= 0) close(running.output);
+  running.output = -1;
+}
+
+/** Sleeps until output arrives or `timeout` passes. */
+void Wait(std::vector<Running> &running, Clock::duration timeout) {
+  std::vector<pollfd> fds;
+  for (const Running &command : running) {
+    if (!command.exited && command.output >= 0) fds.push_back({command.output, POLLIN, 0});
+  }
+  auto ms = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+  poll(fds.data(), static_cast<nfds_t>(fds.size()), static_cast<int>(std::max<decltype(ms)>(ms, 0)));
+}
+
+#endif
+
+uint32_t ElapsedMs(Clock::time_point from, Clock::time_point to) {
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+}
+
+} // namespace
+
+ShutdownCommands &ShutdownCommands::Shared() {
+  static ShutdownCommands *shared = new ShutdownCommands(); // Never destroyed, so it outlives static teardown
+  return *shared;
+}
+
+void ShutdownCommands::Add(std::string command, bool captureOutput, uint32_t deadlineMs) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_commands.push_back({std::move(command), captureOutput, deadlineMs});
+}
+
+size_t ShutdownCommands::Count() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_commands.size();
+}
+
+std::vector<ShutdownCommandResult> ShutdownCommands::Run(uint32_t deadlineMs) {
+  std::vector<Command> commands;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    commands.swap(m_commands);
+  }
+
+  std::vector<ShutdownCommandResult> results(commands.size());
+  std::vector<Running> running(commands.size());
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < commands.size(); ++i) {
+    results[i].command = commands[i].command;
+    running[i].capture = commands[i].captureOutput;
+    uint32_t deadline = deadlineMs;
+    if (commands[i].deadlineMs != kQuitDeadline) deadline = std::min(deadline, commands[i].deadlineMs);
+    running[i].deadline = start + std::chrono::milliseconds(deadline);
+    running[i].start = Clock::now();
+    results[i].started = Launch(commands[i].command, running[i]);
+    running[i].exited = !results[i].started;
+  }
+
+  constexpr auto kGrace = std::chrono::milliseconds(kKillGraceMs);
+  for (;;) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point next = now + kPollInterval;
+    size_t left = 0;
+    for (size_t i = 0; i < running.size(); ++i) {
+      Running &command = running[i];
+      if (command.exited) continue;
+      ReadOutput(command, results[i]);
+      if (Reap(command, results[i])) {
+        ReadOutput(command, results[i]);
+        Close(command);
+        command.exited = true;
+        results[i].elapsedMs = ElapsedMs(command.start, Clock::now());
+        continue;
+      }
+      if (!command.terminated && now >= command.deadline) {
+        command.terminated = results[i].timedOut = true;
+        Terminate(command);
+      } else if (command.terminated && !command.killed && now >= command.deadline + kGrace) {
+        command.killed = results[i].killed = true;
+        Kill(command);
+      } else if (command.killed && now >= command.deadline + 2 * kGrace) {
+        // Not even killing it ended it; the app is going away regardless
+        Close(command);
+        command.exited = true;
+        results[i].elapsedMs = ElapsedMs(command.start, now);
+        continue;
+      }
+      next = std::min(next, command.deadline + (command.killed ? 2 : command.terminated ? 1 : 0) * kGrace);
+      left++;
+    }
+    if (left == 0) break;
+    Wait(running, std::max<Clock::duration>(next - now, Clock::duration::zero()));
+  }
+  return results;
+}
+
+std::string ShutdownCommands::Describe(const ShutdownCommandResult &result) {
+  if (!result.started) return "failed to start: " + result.command;
+  std::string line = "exited " + std::to_string(result.exitCode) + " in " + std::to_string(result.elapsedMs) + " ms";
+  if (result.killed) {
+    line += " (killed)";
+  } else if (result.timedOut) {
+    line += " (timed out)";
+  }
+  return line + ": " + result.command;
+}
+
+} // namespace reactotron
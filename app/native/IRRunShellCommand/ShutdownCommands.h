@@ -0,0 +1,73 @@
+#pragma once
+
+//
+//  ShutdownCommands.h
+//  Reactotron
+//
+//  Cleanup commands registered with runCommandOnShutdown (stopping an
+//  emulator, killing Metro), run when the app quits. They all start at once
+//  and quitting waits for them only up to a deadline: commands still running
+//  then are asked to stop (SIGTERM to their process group) and killed shortly
+//  after if they haven't. A command may ask for an earlier deadline of its
+//  own, never a later one, so one hung command can't keep the app from
+//  quitting. Output is thrown away unless a command asks for it.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace reactotron {
+
+struct ShutdownCommandResult {
+  std::string command;
+  bool started = false;
+  int exitCode = -1;        // 128 + the signal if one ended it, as shells report it
+  bool timedOut = false;    // Still running at its deadline
+  bool killed = false;      // Still running after the grace period, so killed outright
+  uint32_t elapsedMs = 0;   // From launch to exit
+  std::string output;       // stdout and stderr, only for commands that capture it
+};
+
+/**
+ * The commands to run at shutdown. Add() may be called from any thread;
+ * Run() takes them all, so running again does nothing unless more were added.
+ */
+class ShutdownCommands {
+ public:
+  static constexpr uint32_t kDefaultDeadlineMs = 3000;
+  static constexpr uint32_t kQuitDeadline = 0; // A command deadline that defers to Run()'s
+  static constexpr uint32_t kKillGraceMs = 500; // Between asking commands to stop and killing them
+  static constexpr size_t kMaxOutputBytes = 64 * 1024; // Per command; the rest is dropped
+
+  /** The app's commands. */
+  static ShutdownCommands &Shared();
+
+  /** `deadlineMs` counts from when the commands start; past Run()'s deadline it has no effect. */
+  void Add(std::string command, bool captureOutput = false, uint32_t deadlineMs = kQuitDeadline);
+  size_t Count() const;
+
+  /**
+   * Starts every command and waits until each has exited, or its deadline
+   * (at the latest `deadlineMs`) and then the kill grace period have passed.
+   * Results are in the order the commands were added.
+   */
+  std::vector<ShutdownCommandResult> Run(uint32_t deadlineMs = kDefaultDeadlineMs);
+
+  /** One line for the log: how `result` ended, how long it took and the command, e.g. "exited 0 in 12 ms: ...". */
+  static std::string Describe(const ShutdownCommandResult &result);
+
+ private:
+  struct Command {
+    std::string command;
+    bool captureOutput;
+    uint32_t deadlineMs;
+  };
+
+  mutable std::mutex m_mutex;
+  std::vector<Command> m_commands;
+};
+
+} // namespace reactotron
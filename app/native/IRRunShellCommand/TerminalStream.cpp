@@ -0,0 +1,570 @@
+//
+//  TerminalStream.cpp
+//  Reactotron
+//
+
+#include "TerminalStream.h"
+#include "../TextTranscoding/TextTranscoding.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IR_TERMINAL_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define IR_TERMINAL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kTabWidth = 8;
+constexpr size_t kMaxCsiParams = 16;
+
+inline bool IsContinuation(uint8_t b) noexcept { return (b & 0xC0) == 0x80; }
+
+#if defined(IR_TERMINAL_SSE2)
+inline unsigned CountTrailingZeros(unsigned mask) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * Returns the length of the run of printable bytes at `p` (everything but C0 controls
+ * and DEL), and whether that run is pure ASCII. This is the hot loop: typical build
+ * output is long escape-free stretches between newlines.
+ */
+size_t ScanText(const uint8_t *p, size_t length, bool &ascii) noexcept {
+  size_t i = 0;
+  bool high = false;
+#if defined(IR_TERMINAL_SSE2)
+  const __m128i controlMax = _mm_set1_epi8(0x1F);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    // Unsigned b <= 0x1F, without the signed compare treating UTF-8 bytes as negative
+    __m128i control = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, controlMax), v), _mm_cmpeq_epi8(v, del));
+    unsigned controlMask = static_cast<unsigned>(_mm_movemask_epi8(control));
+    unsigned highMask = static_cast<unsigned>(_mm_movemask_epi8(v));
+    if (controlMask) {
+      unsigned index = CountTrailingZeros(controlMask);
+      ascii = !high && (highMask & ((1u << index) - 1)) == 0;
+      return i + index;
+    }
+    high |= highMask != 0;
+  }
+#elif defined(IR_TERMINAL_NEON)
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  const uint8x16_t del = vdupq_n_u8(0x7F);
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t v = vld1q_u8(p + i);
+    uint8x16_t control = vorrq_u8(vcltq_u8(v, space), vceqq_u8(v, del));
+    if (vmaxvq_u8(control)) break; // The scalar loop finds the exact byte
+    high |= vmaxvq_u8(v) >= 0x80;
+  }
+#endif
+  for (; i < length; ++i) {
+    uint8_t b = p[i];
+    if (b < 0x20 || b == 0x7F) break;
+    high |= b >= 0x80;
+  }
+  ascii = !high;
+  return i;
+}
+
+size_t CountColumns(const uint8_t *p, size_t length) noexcept {
+  size_t columns = 0;
+  for (size_t i = 0; i < length; ++i) {
+    columns += !IsContinuation(p[i]);
+  }
+  return columns;
+}
+
+void WriteText(const uint8_t *p, size_t length, bool ascii, TerminalScrollback &screen) {
+  const char *text = reinterpret_cast<const char *>(p);
+  if (ascii) {
+    screen.Write(std::string_view(text, length), length, true);
+    return;
+  }
+  if (IsValidUtf8(text, length)) {
+    screen.Write(std::string_view(text, length), CountColumns(p, length), false);
+    return;
+  }
+  // Keep the scrollback valid UTF-8: each bad byte becomes U+FFFD
+  std::string clean = Utf16ToUtf8(Utf8ToUtf16(std::string_view(text, length)));
+  screen.Write(clean, CountColumns(reinterpret_cast<const uint8_t *>(clean.data()), clean.size()), false);
+}
+
+size_t Utf8SequenceLength(uint8_t lead) noexcept {
+  if (lead >= 0xF0 && lead < 0xF5) return 4;
+  if (lead >= 0xE0) return lead < 0xF0 ? 3 : 1;
+  if (lead >= 0xC2) return 2;
+  return 1;
+}
+
+void ApplySgr(const int *params, size_t count, bool colons, TerminalStyle &style) {
+  if (count == 0) {
+    style = TerminalStyle{};
+    return;
+  }
+
+  auto at = [&](size_t k) { return params[k] < 0 ? 0 : params[k]; };
+
+  // 38/48 extended colors: "5;n" for the palette, "2;r;g;b" for RGB. The colon form
+  // may carry an extra (usually empty) color space id before r.
+  auto extendedColor = [&](size_t &k, uint32_t &color) {
+    if (k + 1 >= count) return;
+    int mode = at(k + 1);
+    if (mode == 5 && k + 2 < count) {
+      color = static_cast<uint32_t>(std::min(at(k + 2), 255));
+      k += 2;
+    } else if (mode == 2) {
+      size_t first = k + 2;
+      if (colons && count - first >= 4) first++;
+      if (first + 2 < count) {
+        uint32_t r = static_cast<uint32_t>(std::min(at(first), 255));
+        uint32_t g = static_cast<uint32_t>(std::min(at(first + 1), 255));
+        uint32_t b = static_cast<uint32_t>(std::min(at(first + 2), 255));
+        color = kTerminalRgbColor | (r << 16) | (g << 8) | b;
+        k = first + 2;
+      } else {
+        k = count;
+      }
+    } else {
+      k = count;
+    }
+  };
+
+  for (size_t k = 0; k < count; ++k) {
+    int code = at(k);
+    switch (code) {
+    case 0: style = TerminalStyle{}; break;
+    case 1: style.flags |= kTerminalBold; break;
+    case 2: style.flags |= kTerminalDim; break;
+    case 3: style.flags |= kTerminalItalic; break;
+    case 4:
+    case 21: style.flags |= kTerminalUnderline; break;
+    case 7: style.flags |= kTerminalInverse; break;
+    case 9: style.flags |= kTerminalStrikethrough; break;
+    case 22: style.flags &= ~(kTerminalBold | kTerminalDim); break;
+    case 23: style.flags &= ~kTerminalItalic; break;
+    case 24: style.flags &= ~kTerminalUnderline; break;
+    case 27: style.flags &= ~kTerminalInverse; break;
+    case 29: style.flags &= ~kTerminalStrikethrough; break;
+    case 38: extendedColor(k, style.foreground); break;
+    case 39: style.foreground = kTerminalDefaultColor; break;
+    case 48: extendedColor(k, style.background); break;
+    case 49: style.background = kTerminalDefaultColor; break;
+    default:
+      if (code >= 30 && code <= 37) {
+        style.foreground = static_cast<uint32_t>(code - 30);
+      } else if (code >= 40 && code <= 47) {
+        style.background = static_cast<uint32_t>(code - 40);
+      } else if (code >= 90 && code <= 97) {
+        style.foreground = static_cast<uint32_t>(code - 90 + 8);
+      } else if (code >= 100 && code <= 107) {
+        style.background = static_cast<uint32_t>(code - 100 + 8);
+      }
+      break;
+    }
+  }
+}
+
+} // namespace
+
+// TerminalScrollback
+
+TerminalScrollback::TerminalScrollback(size_t byteCap) : m_byteCap(byteCap) {
+  m_lines.emplace_back();
+}
+
+size_t TerminalScrollback::Cost(const TerminalLine &line) noexcept {
+  return sizeof(TerminalLine) + line.text.size() + line.spans.size() * sizeof(TerminalSpan);
+}
+
+const TerminalLine *TerminalScrollback::Line(uint64_t index) const noexcept {
+  if (index < m_firstLine || index >= EndLine()) return nullptr;
+  return &m_lines[static_cast<size_t>(index - m_firstLine)];
+}
+
+uint64_t TerminalScrollback::TakeFirstChangedLine() noexcept {
+  uint64_t first = m_firstChanged == UINT64_MAX ? EndLine() : std::max(m_firstChanged, m_firstLine);
+  m_firstChanged = UINT64_MAX;
+  return first;
+}
+
+void TerminalScrollback::MarkOpenLineChanged() noexcept {
+  m_firstChanged = std::min(m_firstChanged, EndLine() - 1);
+}
+
+size_t TerminalScrollback::ByteOffset(size_t column) const noexcept {
+  const std::string &text = m_lines.back().text;
+  if (m_lineAscii) return std::min(column, text.size());
+  size_t seen = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (!IsContinuation(static_cast<uint8_t>(text[i]))) {
+      if (seen == column) return i;
+      seen++;
+    }
+  }
+  return text.size();
+}
+
+void TerminalScrollback::Replace(size_t begin, size_t end, std::string_view text, const TerminalStyle &style) {
+  TerminalLine &line = m_lines.back();
+  const long delta = static_cast<long>(text.size()) - static_cast<long>(end - begin);
+  line.text.replace(begin, end - begin, text);
+
+  std::vector<TerminalSpan> spans;
+  spans.reserve(line.spans.size() + 2);
+  auto push = [&spans](uint32_t start, uint32_t length, const TerminalStyle &spanStyle) {
+    if (length == 0) return;
+    if (!spans.empty()) {
+      TerminalSpan &last = spans.back();
+      if (last.start + last.length == start && last.style == spanStyle) {
+        last.length += length;
+        return;
+      }
+    }
+    spans.push_back({start, length, spanStyle});
+  };
+
+  const uint32_t b = static_cast<uint32_t>(begin);
+  const uint32_t e = static_cast<uint32_t>(end);
+  const uint32_t n = static_cast<uint32_t>(text.size());
+  bool inserted = false;
+  for (const TerminalSpan &span : line.spans) {
+    uint32_t spanEnd = span.start + span.length;
+    if (spanEnd <= b) {
+      push(span.start, span.length, span.style);
+      continue;
+    }
+    if (span.start < b) push(span.start, b - span.start, span.style);
+    if (!inserted) {
+      if (!style.IsDefault()) push(b, n, style);
+      inserted = true;
+    }
+    if (spanEnd > e) {
+      uint32_t from = std::max(span.start, e);
+      push(static_cast<uint32_t>(static_cast<long>(from) + delta), spanEnd - from, span.style);
+    }
+  }
+  if (!inserted && !style.IsDefault()) push(b, n, style);
+  line.spans.swap(spans);
+}
+
+void TerminalScrollback::PadToCursor() {
+  if (m_column <= m_lineColumns) return;
+  // Cells the cursor skipped over (tabs, cursor forward) read back as blanks
+  m_lines.back().text.append(m_column - m_lineColumns, ' ');
+  m_lineColumns = m_column;
+}
+
+void TerminalScrollback::Write(std::string_view text, size_t columns, bool ascii) {
+  if (text.empty()) return;
+  MarkOpenLineChanged();
+  PadToCursor();
+
+  TerminalLine &line = m_lines.back();
+  if (m_column == m_lineColumns) {
+    // Appending at the end of the line is by far the common case
+    uint32_t start = static_cast<uint32_t>(line.text.size());
+    uint32_t length = static_cast<uint32_t>(text.size());
+    line.text.append(text);
+    if (!m_style.IsDefault()) {
+      if (!line.spans.empty() && line.spans.back().start + line.spans.back().length == start &&
+          line.spans.back().style == m_style) {
+        line.spans.back().length += length;
+      } else {
+        line.spans.push_back({start, length, m_style});
+      }
+    }
+    m_lineColumns += columns;
+  } else {
+    size_t overwritten = std::min(columns, m_lineColumns - m_column);
+    size_t begin = ByteOffset(m_column);
+    size_t end = ByteOffset(m_column + overwritten);
+    Replace(begin, end, text, m_style);
+    m_lineColumns += columns - overwritten;
+  }
+  m_column += columns;
+  if (!ascii) m_lineAscii = false;
+
+  // Output that never ends a line would otherwise grow past the cap; wrap it
+  if (Cost(line) > m_byteCap) LineFeed();
+}
+
+void TerminalScrollback::LineFeed() {
+  m_committedBytes += Cost(m_lines.back());
+  m_lines.emplace_back();
+  m_firstChanged = std::min(m_firstChanged, EndLine() - 1);
+  m_column = 0;
+  m_lineColumns = 0;
+  m_lineAscii = true;
+  Evict();
+}
+
+void TerminalScrollback::Backspace() noexcept {
+  if (m_column > 0) m_column--;
+}
+
+void TerminalScrollback::Tab() {
+  m_column = (m_column / kTabWidth + 1) * kTabWidth;
+}
+
+void TerminalScrollback::MoveCursor(long delta) noexcept {
+  if (delta < 0 && static_cast<size_t>(-delta) > m_column) {
+    m_column = 0;
+  } else {
+    m_column = static_cast<size_t>(static_cast<long>(m_column) + delta);
+  }
+}
+
+void TerminalScrollback::EraseInLine(int mode) {
+  TerminalLine &line = m_lines.back();
+  if (mode == 0) {
+    if (m_column >= m_lineColumns) return;
+    Replace(ByteOffset(m_column), line.text.size(), std::string_view(), TerminalStyle{});
+    m_lineColumns = m_column;
+  } else if (mode == 1) {
+    size_t erased = std::min(m_column + 1, m_lineColumns);
+    if (erased == 0) return;
+    Replace(0, ByteOffset(erased), std::string(erased, ' '), TerminalStyle{});
+  } else if (mode == 2) {
+    if (line.text.empty()) return;
+    line.text.clear();
+    line.spans.clear();
+    m_lineColumns = 0;
+    m_lineAscii = true;
+  } else {
+    return;
+  }
+  MarkOpenLineChanged();
+}
+
+void TerminalScrollback::Evict() {
+  if (ByteSize() > m_byteCap) Trim(ByteSize() - m_byteCap);
+}
+
+size_t TerminalScrollback::Trim(size_t bytes) {
+  size_t before = m_committedBytes;
+  while (m_lines.size() > 1 && before - m_committedBytes < bytes) {
+    m_committedBytes -= Cost(m_lines.front());
+    m_lines.pop_front();
+    m_firstLine++;
+  }
+  return before - m_committedBytes;
+}
+
+void TerminalScrollback::Clear() {
+  // Line numbers keep counting up so views holding old indices don't alias new lines
+  m_firstLine = EndLine();
+  m_lines.clear();
+  m_lines.emplace_back();
+  m_committedBytes = 0;
+  m_firstChanged = m_firstLine;
+  m_lineColumns = 0;
+  m_lineAscii = true;
+  m_column = 0;
+  m_style = TerminalStyle{};
+}
+
+// TerminalStreamParser
+
+void TerminalStreamParser::Reset() noexcept {
+  m_state = State::Ground;
+  m_csi.clear();
+  m_csiOverflow = false;
+  m_carryLength = 0;
+}
+
+void TerminalStreamParser::Execute(uint8_t byte, TerminalScrollback &screen) {
+  switch (byte) {
+  case '\n': screen.LineFeed(); break;
+  case '\r': screen.CarriageReturn(); break;
+  case '\b': screen.Backspace(); break;
+  case '\t': screen.Tab(); break;
+  default: break; // BEL and the rest have no visible effect
+  }
+}
+
+size_t TerminalStreamParser::CompleteCarry(const uint8_t *data, size_t length, TerminalScrollback &screen) {
+  size_t expected = Utf8SequenceLength(m_carry[0]);
+  size_t used = 0;
+  while (m_carryLength < expected && used < length && IsContinuation(data[used])) {
+    size_t next = m_carryLength + 1u;
+    m_carry[m_carryLength] = data[used];
+    // Same rule as the chunk tail: only keep bytes that can still become a valid character
+    if (next < expected && Utf8IncompleteTailLength(reinterpret_cast<const char *>(m_carry), next) != next) {
+      break;
+    }
+    m_carryLength++;
+    used++;
+  }
+  if (m_carryLength < expected && used == length) {
+    return used; // Still waiting on the rest of the character
+  }
+  // Either complete, or cut short by a non-continuation byte (written as U+FFFD)
+  WriteText(m_carry, m_carryLength, false, screen);
+  m_carryLength = 0;
+  return used;
+}
+
+void TerminalStreamParser::DispatchCsi(uint8_t final, TerminalScrollback &screen) {
+  if (m_csiOverflow) return;
+  // Private (DEC) modes and sequences with intermediates don't affect line content
+  if (!m_csi.empty() && (m_csi[0] == '<' || m_csi[0] == '=' || m_csi[0] == '>' || m_csi[0] == '?')) return;
+
+  int params[kMaxCsiParams];
+  size_t count = 0;
+  bool colons = false;
+  int value = -1;
+  for (char c : m_csi) {
+    if (c >= '0' && c <= '9') {
+      value = std::min((value < 0 ? 0 : value) * 10 + (c - '0'), 65535);
+    } else if (c == ';' || c == ':') {
+      colons |= c == ':';
+      if (count < kMaxCsiParams) params[count++] = value;
+      value = -1;
+    } else {
+      return;
+    }
+  }
+  if (!m_csi.empty() && count < kMaxCsiParams) params[count++] = value;
+
+  int first = count > 0 && params[0] >= 0 ? params[0] : 0;
+  switch (final) {
+  case 'm': ApplySgr(params, count, colons, screen.Style()); break;
+  case 'K': screen.EraseInLine(first); break;
+  case 'G':
+  case '`': screen.SetColumn(first > 0 ? static_cast<size_t>(first - 1) : 0); break;
+  case 'C': screen.MoveCursor(std::max(first, 1)); break;
+  case 'D': screen.MoveCursor(-std::max(first, 1)); break;
+  default: break;
+  }
+}
+
+void TerminalStreamParser::Feed(const char *data, size_t length, TerminalScrollback &screen) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+  size_t i = 0;
+  while (i < length) {
+    if (m_state == State::Ground) {
+      if (m_carryLength) {
+        i += CompleteCarry(p + i, length - i, screen);
+        continue;
+      }
+
+      bool ascii;
+      size_t run = ScanText(p + i, length - i, ascii);
+      if (run) {
+        size_t write = run;
+        if (!ascii && i + run == length) {
+          // Hold back a character split by the end of the chunk
+          size_t tail = Utf8IncompleteTailLength(data + i, run);
+          write -= tail;
+          std::memcpy(m_carry, p + i + write, tail);
+          m_carryLength = static_cast<uint8_t>(tail);
+        }
+        if (write) WriteText(p + i, write, ascii, screen);
+        i += run;
+        continue;
+      }
+
+      uint8_t b = p[i++];
+      if (b == 0x1B) {
+        m_state = State::Escape;
+      } else {
+        Execute(b, screen);
+      }
+      continue;
+    }
+
+    uint8_t b = p[i++];
+    switch (m_state) {
+    case State::Escape:
+      if (b == '[') {
+        m_state = State::Csi;
+        m_csi.clear();
+        m_csiOverflow = false;
+      } else if (b == ']' || b == 'P' || b == 'X' || b == '^' || b == '_') {
+        m_state = State::String;
+      } else if (b >= 0x20 && b <= 0x2F) {
+        m_state = State::EscapeIntermediate;
+      } else if (b < 0x20) {
+        if (b != 0x1B) Execute(b, screen);
+      } else {
+        if (b == 'c') screen.Style() = TerminalStyle{}; // RIS
+        m_state = State::Ground;
+      }
+      break;
+
+    case State::EscapeIntermediate:
+      if (b >= 0x30 && b <= 0x7E) {
+        m_state = State::Ground;
+      } else if (b == 0x1B) {
+        m_state = State::Escape;
+      } else if (b < 0x20) {
+        Execute(b, screen);
+      }
+      break;
+
+    case State::Csi:
+      if (b >= 0x40 && b <= 0x7E) {
+        DispatchCsi(b, screen);
+        m_state = State::Ground;
+      } else if (b >= 0x20 && b <= 0x3F) {
+        if (m_csi.size() < kMaxCsiLength) {
+          m_csi.push_back(static_cast<char>(b));
+        } else {
+          m_csiOverflow = true;
+        }
+      } else if (b == 0x1B) {
+        m_state = State::Escape;
+      } else if (b < 0x20) {
+        Execute(b, screen);
+      }
+      break;
+
+    case State::String: {
+      // Skip the payload in one go (OSC 8 hyperlinks can be long)
+      const uint8_t *start = p + i - 1;
+      const uint8_t *end = p + length;
+      const uint8_t *stop = start;
+      while (stop < end && *stop != 0x07 && *stop != 0x1B) stop++;
+      i = static_cast<size_t>(stop - p);
+      if (stop < end) {
+        m_state = *stop == 0x07 ? State::Ground : State::StringEscape;
+        i++;
+      }
+      break;
+    }
+
+    case State::StringEscape:
+      if (b == '\\') {
+        m_state = State::Ground;
+      } else {
+        // Anything but ST aborts the string and starts a new escape
+        m_state = State::Escape;
+        i--;
+      }
+      break;
+
+    case State::Ground:
+      break;
+    }
+  }
+}
+
+} // namespace reactotron
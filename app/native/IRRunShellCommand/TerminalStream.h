@@ -0,0 +1,173 @@
+#pragma once
+
+//
+//  TerminalStream.h
+//  Reactotron
+//
+//  Incremental parser for the output of tasks started with runTaskWithCommand.
+//  Raw pipe chunks (ANSI escapes, progress bars, UTF-8 split anywhere) go in;
+//  styled lines come out in a bounded, line-indexed scrollback that JS can page
+//  through instead of re-parsing the whole log on every chunk.
+//
+//  This is a line-oriented terminal, not a full emulator: "\r" overwrites the
+//  current line, SGR colors and the line-editing CSI sequences are honored, and
+//  cursor movement across lines or screen clears are ignored.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+/**
+ * Colors are kTerminalDefaultColor, a 0-255 palette index, or
+ * kTerminalRgbColor | 0xRRGGBB.
+ */
+constexpr uint32_t kTerminalDefaultColor = 0xFFFFFFFF;
+constexpr uint32_t kTerminalRgbColor = 0x01000000;
+
+enum TerminalStyleFlag : uint8_t {
+  kTerminalBold = 1 << 0,
+  kTerminalDim = 1 << 1,
+  kTerminalItalic = 1 << 2,
+  kTerminalUnderline = 1 << 3,
+  kTerminalInverse = 1 << 4,
+  kTerminalStrikethrough = 1 << 5,
+};
+
+struct TerminalStyle {
+  uint32_t foreground = kTerminalDefaultColor;
+  uint32_t background = kTerminalDefaultColor;
+  uint8_t flags = 0;
+
+  bool IsDefault() const noexcept {
+    return foreground == kTerminalDefaultColor && background == kTerminalDefaultColor && flags == 0;
+  }
+  bool operator==(const TerminalStyle &other) const noexcept {
+    return foreground == other.foreground && background == other.background && flags == other.flags;
+  }
+  bool operator!=(const TerminalStyle &other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * A styled byte range of TerminalLine::text. Only non-default styles get spans.
+ */
+struct TerminalSpan {
+  uint32_t start = 0;
+  uint32_t length = 0;
+  TerminalStyle style;
+};
+
+struct TerminalLine {
+  std::string text; // Always valid UTF-8
+  std::vector<TerminalSpan> spans; // Sorted, non-overlapping
+};
+
+/**
+ * Line storage plus the cursor state the parser drives. Lines are addressed by an
+ * absolute index that keeps counting up as old lines are evicted, so a JS view can
+ * hold on to line numbers across updates. The last line is always the open one,
+ * the only one that can still change.
+ *
+ * Not thread-safe.
+ */
+class TerminalScrollback {
+ public:
+  explicit TerminalScrollback(size_t byteCap = 4 * 1024 * 1024);
+
+  /**
+   * Writes printable UTF-8 at the cursor, overwriting what's there. `columns` is the
+   * number of code points in `text`.
+   */
+  void Write(std::string_view text, size_t columns, bool ascii);
+  void CarriageReturn() noexcept { m_column = 0; }
+  void LineFeed();
+  void Backspace() noexcept;
+  void Tab();
+  void MoveCursor(long delta) noexcept;
+  void SetColumn(size_t column) noexcept { m_column = column; }
+  /** CSI K: 0 erases to the end of the line, 1 to the cursor, 2 the whole line. */
+  void EraseInLine(int mode);
+
+  TerminalStyle &Style() noexcept { return m_style; }
+
+  uint64_t FirstLine() const noexcept { return m_firstLine; }
+  uint64_t EndLine() const noexcept { return m_firstLine + m_lines.size(); }
+  /** Returns nullptr outside [FirstLine(), EndLine()). */
+  const TerminalLine *Line(uint64_t index) const noexcept;
+  size_t ByteSize() const noexcept { return m_committedBytes + Cost(m_lines.back()); }
+  size_t ByteCap() const noexcept { return m_byteCap; }
+
+  /**
+   * Returns the lowest line index changed since the last call (clamped to FirstLine()),
+   * or EndLine() if nothing changed.
+   */
+  uint64_t TakeFirstChangedLine() noexcept;
+
+  /** Drops the oldest lines, but never the open one, until about `bytes` are freed; returns how many were. */
+  size_t Trim(size_t bytes);
+  void Clear();
+
+ private:
+  static size_t Cost(const TerminalLine &line) noexcept;
+  size_t ByteOffset(size_t column) const noexcept;
+  void Replace(size_t begin, size_t end, std::string_view text, const TerminalStyle &style);
+  void PadToCursor();
+  void MarkOpenLineChanged() noexcept;
+  void Evict();
+
+  size_t m_byteCap;
+  std::deque<TerminalLine> m_lines;
+  uint64_t m_firstLine = 0;
+  size_t m_committedBytes = 0;
+  uint64_t m_firstChanged = UINT64_MAX;
+
+  // Open line bookkeeping, so the common all-ASCII append never rescans it
+  size_t m_lineColumns = 0;
+  bool m_lineAscii = true;
+
+  size_t m_column = 0;
+  TerminalStyle m_style;
+};
+
+/**
+ * Splits a byte stream into text and control sequences and applies them to a
+ * TerminalScrollback. Escape sequences and UTF-8 characters may be split across
+ * Feed() calls. Keep one parser per stream (stdout, stderr) and share the
+ * scrollback between them, as a terminal would.
+ *
+ * Not thread-safe.
+ */
+class TerminalStreamParser {
+ public:
+  void Feed(const char *data, size_t length, TerminalScrollback &screen);
+  void Reset() noexcept;
+
+ private:
+  enum class State : uint8_t {
+    Ground,
+    Escape,
+    EscapeIntermediate,
+    Csi,
+    String, // OSC, DCS, SOS, PM and APC payloads are skipped up to ST or BEL
+    StringEscape,
+  };
+
+  void Execute(uint8_t byte, TerminalScrollback &screen);
+  void DispatchCsi(uint8_t final, TerminalScrollback &screen);
+  size_t CompleteCarry(const uint8_t *data, size_t length, TerminalScrollback &screen);
+
+  static constexpr size_t kMaxCsiLength = 64;
+
+  State m_state = State::Ground;
+  std::string m_csi;
+  bool m_csiOverflow = false;
+  uint8_t m_carry[4] = {};
+  uint8_t m_carryLength = 0;
+};
+
+} // namespace reactotron
@@ -0,0 +1,239 @@
+//
+//  IRSessionArchive.mm
+//  Reactotron-macOS
+//
+//  Session export and import. Exports are written by SessionExport on the
+//  shared TaskExecutor, a relay batch at a time; archives are read on a serial
+//  background queue. Either way compression and disk I/O never block the JS
+//  thread.
+//
+
+#import <Cocoa/Cocoa.h>
+#import "IRSessionArchive.h"
+#include "SessionArchive.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+@implementation IRSessionArchive {
+  dispatch_queue_t _queue;
+  std::mutex _exportMutex;
+  std::shared_ptr<reactotron::SessionExport> _export; // Guarded by _exportMutex
+  // Only touched on _queue
+  std::unordered_map<int, std::unique_ptr<reactotron::SessionReader>> _readers;
+  int _nextSessionId;
+}
+
+RCT_EXPORT_MODULE()
+
+- (instancetype)init {
+  if (self = [super init]) {
+    _queue = dispatch_queue_create("com.reactotron.sessionArchive", DISPATCH_QUEUE_SERIAL);
+    _nextSessionId = 1;
+  }
+  return self;
+}
+
+static std::string IRSessionArchiveString(NSString *string) {
+  const char *utf8 = string.UTF8String;
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+static NSString *IRSessionArchiveNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+// Pickers
+
+- (void)pickExportPath:(NSString *)defaultName
+               resolve:(nonnull RCTPromiseResolveBlock)resolve
+                reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    NSSavePanel *panel = [NSSavePanel savePanel];
+    panel.nameFieldStringValue = defaultName;
+    panel.canCreateDirectories = YES;
+    [panel beginWithCompletionHandler:^(NSModalResponse response) {
+      resolve(response == NSModalResponseOK ? panel.URL.path : @"");
+    }];
+  });
+}
+
+- (void)pickImportPath:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    NSOpenPanel *panel = [NSOpenPanel openPanel];
+    panel.canChooseFiles = YES;
+    panel.canChooseDirectories = NO;
+    panel.allowsMultipleSelection = NO;
+    [panel beginWithCompletionHandler:^(NSModalResponse response) {
+      resolve(response == NSModalResponseOK ? panel.URL.path : @"");
+    }];
+  });
+}
+
+// Export
+
+- (NSNumber *)startExport:(NSString *)path {
+  auto session = std::make_shared<reactotron::SessionExport>();
+  if (!session->Open(IRSessionArchiveString(path))) return @NO;
+  std::shared_ptr<reactotron::SessionExport> previous;
+  {
+    std::lock_guard<std::mutex> lock(_exportMutex);
+    previous = std::move(_export);
+    _export = session;
+  }
+  // Finishing waits for what it has queued, so not on the JS thread
+  if (previous) dispatch_async(_queue, ^{ previous->Finish(); });
+  return @YES;
+}
+
+- (NSNumber *)appendBatch:(NSArray *)times types:(NSArray *)types texts:(NSArray *)texts {
+  std::shared_ptr<reactotron::SessionExport> session;
+  {
+    std::lock_guard<std::mutex> lock(_exportMutex);
+    session = _export;
+  }
+  if (!session) return @NO;
+  NSUInteger count = std::min({times.count, types.count, texts.count});
+  std::vector<reactotron::SessionRecord> batch;
+  batch.reserve(count);
+  for (NSUInteger i = 0; i < count; ++i) {
+    batch.push_back({static_cast<int64_t>([times[i] doubleValue]), IRSessionArchiveString(types[i]),
+                     IRSessionArchiveString(texts[i])});
+  }
+  return @(session->Append(std::move(batch)));
+}
+
+- (void)finishExport:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  std::shared_ptr<reactotron::SessionExport> session;
+  {
+    std::lock_guard<std::mutex> lock(_exportMutex);
+    session = std::move(_export);
+  }
+  if (!session) {
+    reject(@"no_export", @"No session export in progress", nil);
+    return;
+  }
+  dispatch_async(_queue, ^{
+    if (!session->Finish()) {
+      reject(@"write_failed", @"Could not finish writing the session archive", nil);
+      return;
+    }
+    const auto &writer = session->Writer();
+    resolve(@{
+      @"records": @(writer.Records()),
+      @"bytes": @(writer.Bytes()),
+      @"rawBytes": @(writer.RawBytes()),
+      @"dropped": @(session->Dropped()),
+    });
+  });
+}
+
+// Import
+
+- (void)openSession:(NSString *)path
+            resolve:(nonnull RCTPromiseResolveBlock)resolve
+             reject:(nonnull RCTPromiseRejectBlock)reject {
+  std::string pathString = IRSessionArchiveString(path);
+  dispatch_async(_queue, ^{
+    auto reader = std::make_unique<reactotron::SessionReader>();
+    if (!reader->Open(pathString)) {
+      reject(@"open_failed", [NSString stringWithFormat:@"%@ is not a readable session archive", path], nil);
+      return;
+    }
+
+    NSMutableArray<NSString *> *types = [NSMutableArray arrayWithCapacity:reader->Types().size()];
+    for (const auto &type : reader->Types()) [types addObject:IRSessionArchiveNSString(type)];
+    int64_t startTime = 0;
+    int64_t endTime = 0;
+    const auto &chunks = reader->Chunks();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      startTime = i == 0 ? chunks[i].minTime : std::min(startTime, chunks[i].minTime);
+      endTime = i == 0 ? chunks[i].maxTime : std::max(endTime, chunks[i].maxTime);
+    }
+
+    int sessionId = self->_nextSessionId++;
+    NSDictionary *info = @{
+      @"sessionId": @(sessionId),
+      @"records": @(reader->Records()),
+      @"chunks": @(chunks.size()),
+      @"startTime": @(startTime),
+      @"endTime": @(endTime),
+      @"types": types,
+      @"recovered": @(reader->Recovered()),
+    };
+    self->_readers[sessionId] = std::move(reader);
+    resolve(info);
+  });
+}
+
+- (void)readChunk:(double)sessionId
+            index:(double)index
+          resolve:(nonnull RCTPromiseResolveBlock)resolve
+           reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(_queue, ^{
+    auto it = self->_readers.find(static_cast<int>(sessionId));
+    reactotron::SessionChunk chunk;
+    if (it == self->_readers.end() || index < 0 || !it->second->ReadChunk(static_cast<size_t>(index), chunk)) {
+      reject(@"read_failed", @"Session chunk is missing or corrupt", nil);
+      return;
+    }
+
+    NSMutableArray<NSNumber *> *times = [NSMutableArray arrayWithCapacity:chunk.times.size()];
+    NSMutableArray<NSNumber *> *types = [NSMutableArray arrayWithCapacity:chunk.types.size()];
+    NSMutableArray<NSString *> *texts = [NSMutableArray arrayWithCapacity:chunk.texts.size()];
+    for (size_t i = 0; i < chunk.texts.size(); ++i) {
+      [times addObject:@(chunk.times[i])];
+      [types addObject:@(chunk.types[i])];
+      [texts addObject:IRSessionArchiveNSString(chunk.texts[i])];
+    }
+    resolve(@{@"times": times, @"types": types, @"texts": texts});
+  });
+}
+
+- (void)findChunks:(double)sessionId
+             types:(NSArray *)types
+              from:(double)from
+                to:(double)to
+           resolve:(nonnull RCTPromiseResolveBlock)resolve
+            reject:(nonnull RCTPromiseRejectBlock)reject {
+  std::vector<std::string> typeNames;
+  for (NSString *type in types) typeNames.push_back(IRSessionArchiveString(type));
+  dispatch_async(_queue, ^{
+    auto it = self->_readers.find(static_cast<int>(sessionId));
+    if (it == self->_readers.end()) {
+      reject(@"no_session", @"Session is not open", nil);
+      return;
+    }
+    const auto &names = it->second->Types();
+    std::vector<uint32_t> typeIds;
+    for (const auto &typeName : typeNames) {
+      auto name = std::find(names.begin(), names.end(), typeName);
+      if (name != names.end()) typeIds.push_back(static_cast<uint32_t>(name - names.begin()));
+    }
+    NSMutableArray<NSNumber *> *result = [NSMutableArray array];
+    // Types the archive doesn't have match nothing, rather than everything
+    if (!typeNames.empty() && typeIds.empty()) {
+      resolve(result);
+      return;
+    }
+    for (size_t index : it->second->FindChunks(typeIds, static_cast<int64_t>(from), static_cast<int64_t>(to))) {
+      [result addObject:@(index)];
+    }
+    resolve(result);
+  });
+}
+
+- (void)closeSession:(double)sessionId {
+  dispatch_async(_queue, ^{
+    self->_readers.erase(static_cast<int>(sessionId));
+  });
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRSessionArchiveSpecJSI>(params);
+}
+
+@end
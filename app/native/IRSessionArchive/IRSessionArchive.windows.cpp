@@ -0,0 +1,260 @@
+//
+//  IRSessionArchive.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared SessionArchive reader and writer
+//
+
+#include "pch.h"
+#include "IRSessionArchive.windows.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include <shobjidl.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const COMDLG_FILTERSPEC kArchiveFilter[] = {{L"Reactotron Session", L"*.rtsession"}};
+
+    // The app's top-level window, so the picker is modal to it
+    HWND MainWindow() noexcept
+    {
+        HWND hwnd = nullptr;
+        EnumWindows([](HWND h, LPARAM p) -> BOOL {
+            DWORD pid = 0;
+            GetWindowThreadProcessId(h, &pid);
+            if (pid == GetCurrentProcessId() && IsWindowVisible(h) && !GetParent(h))
+            {
+                *reinterpret_cast<HWND *>(p) = h;
+                return FALSE;
+            }
+            return TRUE;
+        }, reinterpret_cast<LPARAM>(&hwnd));
+        return hwnd;
+    }
+
+    // Shows `dialog` and returns the chosen file's path, or "" if it was cancelled
+    std::string ShowPicker(IFileDialog *dialog)
+    {
+        dialog->SetFileTypes(ARRAYSIZE(kArchiveFilter), kArchiveFilter);
+        dialog->SetDefaultExtension(L"rtsession");
+        if (FAILED(dialog->Show(MainWindow()))) return std::string();
+        winrt::com_ptr<IShellItem> item;
+        if (FAILED(dialog->GetResult(item.put()))) return std::string();
+        PWSTR path = nullptr;
+        if (FAILED(item->GetDisplayName(SIGDN_FILESYSPATH, &path))) return std::string();
+        std::u16string utf16(reinterpret_cast<const char16_t *>(path));
+        CoTaskMemFree(path);
+        return ::reactotron::Utf16ToUtf8(utf16);
+    }
+
+    // Pickers are modal, so each runs on its own thread rather than holding up other module calls
+    template <typename Show>
+    void RunPicker(winrt::Microsoft::ReactNative::ReactPromise<std::string> const &promise, Show show) noexcept
+    {
+        std::thread([promise, show]() {
+            winrt::init_apartment(winrt::apartment_type::single_threaded);
+            try
+            {
+                promise.Resolve(show());
+            }
+            catch (winrt::hresult_error const &error)
+            {
+                promise.Reject(winrt::to_string(error.message()).c_str());
+            }
+            winrt::uninit_apartment();
+        }).detach();
+    }
+}
+
+namespace winrt::reactotron::implementation
+{
+    void IRSessionArchive::pickExportPath(std::string defaultName, Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept
+    {
+        RunPicker(promise, [defaultName]() {
+            auto dialog = winrt::create_instance<IFileSaveDialog>(CLSID_FileSaveDialog);
+            std::u16string name = ::reactotron::Utf8ToUtf16(defaultName);
+            dialog->SetFileName(reinterpret_cast<LPCWSTR>(name.c_str()));
+            dialog->SetTitle(L"Export Session");
+            return ShowPicker(dialog.get());
+        });
+    }
+
+    void IRSessionArchive::pickImportPath(Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept
+    {
+        RunPicker(promise, []() {
+            auto dialog = winrt::create_instance<IFileOpenDialog>(CLSID_FileOpenDialog);
+            DWORD options = 0;
+            dialog->GetOptions(&options);
+            dialog->SetOptions(options | FOS_FILEMUSTEXIST | FOS_FORCEFILESYSTEM);
+            dialog->SetTitle(L"Import Session");
+            return ShowPicker(dialog.get());
+        });
+    }
+
+    bool IRSessionArchive::startExport(std::string path) noexcept
+    {
+        auto session = std::make_shared<::reactotron::SessionExport>();
+        if (!session->Open(path)) return false;
+        std::shared_ptr<::reactotron::SessionExport> previous;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            previous = std::move(m_export);
+            m_export = session;
+        }
+        // Finishing waits for what it has queued, so not on the JS thread
+        if (previous) std::thread([previous]() { previous->Finish(); }).detach();
+        return true;
+    }
+
+    bool IRSessionArchive::appendBatch(std::vector<double> times, std::vector<std::string> types, std::vector<std::string> texts) noexcept
+    {
+        // A sync method, so the batch is queued (or dropped) now rather than waiting in the module's own queue
+        std::shared_ptr<::reactotron::SessionExport> session;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            session = m_export;
+        }
+        if (!session) return false;
+        size_t count = (std::min)({times.size(), types.size(), texts.size()});
+        std::vector<::reactotron::SessionRecord> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch.push_back({static_cast<int64_t>(times[i]), std::move(types[i]), std::move(texts[i])});
+        }
+        return session->Append(std::move(batch));
+    }
+
+    void IRSessionArchive::finishExport(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        std::shared_ptr<::reactotron::SessionExport> session;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            session = std::move(m_export);
+        }
+        if (!session)
+        {
+            promise.Reject("No session export in progress");
+            return;
+        }
+        if (!session->Finish())
+        {
+            promise.Reject("Could not finish writing the session archive");
+            return;
+        }
+
+        const auto &writer = session->Writer();
+        Microsoft::ReactNative::JSValueObject result;
+        result["records"] = static_cast<double>(writer.Records());
+        result["bytes"] = static_cast<double>(writer.Bytes());
+        result["rawBytes"] = static_cast<double>(writer.RawBytes());
+        result["dropped"] = static_cast<double>(session->Dropped());
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    void IRSessionArchive::openSession(std::string path, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        auto reader = std::make_unique<::reactotron::SessionReader>();
+        if (!reader->Open(path))
+        {
+            promise.Reject((path + " is not a readable session archive").c_str());
+            return;
+        }
+
+        Microsoft::ReactNative::JSValueArray types;
+        for (const auto &type : reader->Types()) types.push_back(type);
+        int64_t startTime = 0;
+        int64_t endTime = 0;
+        const auto &chunks = reader->Chunks();
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            startTime = i == 0 ? chunks[i].minTime : (std::min)(startTime, chunks[i].minTime);
+            endTime = i == 0 ? chunks[i].maxTime : (std::max)(endTime, chunks[i].maxTime);
+        }
+
+        Microsoft::ReactNative::JSValueObject info;
+        info["records"] = static_cast<double>(reader->Records());
+        info["chunks"] = static_cast<double>(chunks.size());
+        info["startTime"] = static_cast<double>(startTime);
+        info["endTime"] = static_cast<double>(endTime);
+        info["types"] = std::move(types);
+        info["recovered"] = reader->Recovered();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            int sessionId = m_nextSessionId++;
+            info["sessionId"] = sessionId;
+            m_readers[sessionId] = std::move(reader);
+        }
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(info)));
+    }
+
+    void IRSessionArchive::readChunk(double sessionId, double index, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        ::reactotron::SessionChunk chunk;
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_readers.find(static_cast<int>(sessionId));
+            ok = it != m_readers.end() && index >= 0 && it->second->ReadChunk(static_cast<size_t>(index), chunk);
+        }
+        if (!ok)
+        {
+            promise.Reject("Session chunk is missing or corrupt");
+            return;
+        }
+
+        Microsoft::ReactNative::JSValueArray times;
+        Microsoft::ReactNative::JSValueArray types;
+        Microsoft::ReactNative::JSValueArray texts;
+        for (size_t i = 0; i < chunk.texts.size(); ++i)
+        {
+            times.push_back(static_cast<double>(chunk.times[i]));
+            types.push_back(static_cast<double>(chunk.types[i]));
+            texts.push_back(std::move(chunk.texts[i]));
+        }
+        Microsoft::ReactNative::JSValueObject result;
+        result["times"] = std::move(times);
+        result["types"] = std::move(types);
+        result["texts"] = std::move(texts);
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    void IRSessionArchive::findChunks(double sessionId, std::vector<std::string> types, double from, double to,
+                                      Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        std::vector<size_t> found;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_readers.find(static_cast<int>(sessionId));
+            if (it == m_readers.end())
+            {
+                promise.Reject("Session is not open");
+                return;
+            }
+            const auto &names = it->second->Types();
+            std::vector<uint32_t> typeIds;
+            for (const auto &type : types)
+            {
+                auto name = std::find(names.begin(), names.end(), type);
+                if (name != names.end()) typeIds.push_back(static_cast<uint32_t>(name - names.begin()));
+            }
+            // Types the archive doesn't have match nothing, rather than everything
+            if (types.empty() || !typeIds.empty())
+            {
+                found = it->second->FindChunks(typeIds, static_cast<int64_t>(from), static_cast<int64_t>(to));
+            }
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (size_t index : found) result.push_back(static_cast<double>(index));
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    void IRSessionArchive::closeSession(double sessionId) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_readers.erase(static_cast<int>(sessionId));
+    }
+}
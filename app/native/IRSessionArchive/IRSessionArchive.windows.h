@@ -0,0 +1,49 @@
+#pragma once
+#include "NativeModules.h"
+#include "SessionArchive.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRSessionArchive)
+    struct IRSessionArchive
+    {
+        IRSessionArchive() noexcept = default;
+
+        REACT_METHOD(pickExportPath)
+        void pickExportPath(std::string defaultName, Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept;
+
+        REACT_METHOD(pickImportPath)
+        void pickImportPath(Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept;
+
+        REACT_SYNC_METHOD(startExport)
+        bool startExport(std::string path) noexcept;
+
+        REACT_SYNC_METHOD(appendBatch)
+        bool appendBatch(std::vector<double> times, std::vector<std::string> types, std::vector<std::string> texts) noexcept;
+
+        REACT_METHOD(finishExport)
+        void finishExport(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(openSession)
+        void openSession(std::string path, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(readChunk)
+        void readChunk(double sessionId, double index, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(findChunks)
+        void findChunks(double sessionId, std::vector<std::string> types, double from, double to,
+                        Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(closeSession)
+        void closeSession(double sessionId) noexcept;
+
+    private:
+        std::shared_ptr<::reactotron::SessionExport> m_export;
+        std::unordered_map<int, std::unique_ptr<::reactotron::SessionReader>> m_readers;
+        int m_nextSessionId = 1;
+        std::mutex m_mutex;
+    };
+}
@@ -0,0 +1,71 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface SessionExportResult {
+  records: number
+  /** Size of the archive file. */
+  bytes: number
+  /** Total size of the messages before compression. */
+  rawBytes: number
+  /** Messages dropped because they arrived faster than they could be written. */
+  dropped: number
+}
+
+export interface SessionInfo {
+  /** Handle for readChunk, findChunks and closeSession. */
+  sessionId: number
+  records: number
+  chunks: number
+  /** Times are ms since the epoch. */
+  startTime: number
+  endTime: number
+  /** Message types in the archive; chunk `types` index into this. */
+  types: ReadonlyArray<string>
+  /** True if the export never finished and the archive was read up to its last whole chunk. */
+  recovered: boolean
+}
+
+/** One chunk of an archive, as parallel arrays in recording order. */
+export interface SessionChunk {
+  times: ReadonlyArray<number>
+  types: ReadonlyArray<number>
+  texts: ReadonlyArray<string>
+}
+
+export interface Spec extends TurboModule {
+  /** Asks the user where to save an archive. Resolves "" if cancelled. */
+  pickExportPath(defaultName: string): Promise<string>
+  /** Asks the user for an archive to open. Resolves "" if cancelled. */
+  pickImportPath(): Promise<string>
+
+  /** Starts writing an archive to `path`, ending any export in progress. */
+  startExport(path: string): boolean
+  /**
+   * Queues a batch of raw messages, as parallel arrays; compression and writes happen off the
+   * JS thread. Returns false if the batch was dropped, because too much is already queued or
+   * there's no export in progress.
+   */
+  appendBatch(
+    times: ReadonlyArray<number>,
+    types: ReadonlyArray<string>,
+    texts: ReadonlyArray<string>,
+  ): boolean
+  finishExport(): Promise<SessionExportResult>
+
+  /** Rejects if `path` is not a readable archive. */
+  openSession(path: string): Promise<SessionInfo>
+  readChunk(sessionId: number, index: number): Promise<SessionChunk>
+  /**
+   * Chunks that may hold messages of one of `types` (any type if empty) recorded
+   * between `from` and `to`.
+   */
+  findChunks(
+    sessionId: number,
+    types: ReadonlyArray<string>,
+    from: number,
+    to: number,
+  ): Promise<number[]>
+  closeSession(sessionId: number): void
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRSessionArchive")
@@ -0,0 +1,550 @@
+//
+//  SessionArchive.cpp
+//  Reactotron
+//
+
+#include "SessionArchive.h"
+#include "SessionCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include "../TextTranscoding/TextTranscoding.h"
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr char kFileMagic[8] = {'R', 'T', 'S', 'E', 'S', 'S', '\0', '\0'};
+// 1 and 2 put the version in the magic ("RTSESS02") and used a codec of our own; they are no longer read.
+// 3: blocks start with their method, stored or zlib DEFLATE
+constexpr uint32_t kFormatVersion = 3;
+constexpr uint32_t kDictionaryVersion = 1;
+constexpr uint32_t kChunkMagic = 0x4B435452;  // "RTCK"
+constexpr uint32_t kFooterMagic = 0x58495452; // "RTIX"
+constexpr uint32_t kEndMagic = 0x4E455452;    // "RTEN"
+constexpr size_t kFileHeaderSize = 16;
+constexpr size_t kChunkHeaderSize = 48;
+constexpr size_t kTrailerSize = 16;
+constexpr uint64_t kOverflowTypeBit = uint64_t(1) << 63;
+constexpr uint32_t kMaxChunkRawSize = 256u << 20; // One huge record makes a big chunk; a corrupt size is refused
+
+std::FILE *OpenFile(const std::string &path, const char *mode) {
+#if defined(_WIN32)
+  std::u16string widePath = Utf8ToUtf16(path);
+  std::wstring wideMode(mode, mode + std::strlen(mode));
+  return _wfopen(reinterpret_cast<const wchar_t *>(widePath.c_str()), wideMode.c_str());
+#else
+  return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool Seek(std::FILE *file, uint64_t offset) {
+#if defined(_WIN32)
+  return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+  return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool ReadAt(std::FILE *file, uint64_t offset, void *data, size_t size) {
+  return Seek(file, offset) && std::fread(data, 1, size, file) == size;
+}
+
+uint32_t Fnv1a(std::string_view data) noexcept {
+  uint32_t hash = 2166136261u;
+  for (char c : data) hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  return hash;
+}
+
+// Little-endian fields and varints
+
+void PutU32(std::string &out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void PutU64(std::string &out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void PutVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+uint64_t ZigZag(int64_t value) noexcept {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) noexcept {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/** Bounds-checked reader over a decoded chunk or footer. */
+class Cursor {
+ public:
+  explicit Cursor(std::string_view data) : m_data(data) {}
+
+  bool U32(uint32_t &value) noexcept {
+    if (m_data.size() - m_position < 4) return Fail();
+    value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(static_cast<uint8_t>(m_data[m_position++])) << (8 * i);
+    return true;
+  }
+
+  bool U64(uint64_t &value) noexcept {
+    if (m_data.size() - m_position < 8) return Fail();
+    value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(static_cast<uint8_t>(m_data[m_position++])) << (8 * i);
+    return true;
+  }
+
+  bool Varint(uint64_t &value) noexcept {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (m_position == m_data.size()) return Fail();
+      uint8_t byte = static_cast<uint8_t>(m_data[m_position++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) return true;
+    }
+    return Fail();
+  }
+
+  bool Bytes(size_t size, std::string_view &value) noexcept {
+    if (m_data.size() - m_position < size) return Fail();
+    value = m_data.substr(m_position, size);
+    m_position += size;
+    return true;
+  }
+
+  bool Ok() const noexcept { return m_ok; }
+
+ private:
+  bool Fail() noexcept {
+    m_ok = false;
+    return false;
+  }
+
+  std::string_view m_data;
+  size_t m_position = 0;
+  bool m_ok = true;
+};
+
+void PutChunkInfo(std::string &out, const SessionChunkInfo &chunk) {
+  PutU32(out, chunk.compressedSize);
+  PutU32(out, chunk.rawSize);
+  PutU32(out, chunk.records);
+  PutU64(out, static_cast<uint64_t>(chunk.minTime));
+  PutU64(out, static_cast<uint64_t>(chunk.maxTime));
+  PutU64(out, chunk.typeMask);
+  PutU32(out, chunk.checksum);
+}
+
+bool ReadChunkInfo(Cursor &cursor, SessionChunkInfo &chunk) {
+  uint64_t minTime = 0;
+  uint64_t maxTime = 0;
+  cursor.U32(chunk.compressedSize);
+  cursor.U32(chunk.rawSize);
+  cursor.U32(chunk.records);
+  cursor.U64(minTime);
+  cursor.U64(maxTime);
+  cursor.U64(chunk.typeMask);
+  cursor.U32(chunk.checksum);
+  chunk.minTime = static_cast<int64_t>(minTime);
+  chunk.maxTime = static_cast<int64_t>(maxTime);
+  return cursor.Ok();
+}
+
+/**
+ * Parses a decoded chunk. Type names it defines are appended to `types` when
+ * `defineTypes` is set (scanning a file without a footer), skipped otherwise.
+ */
+bool ParseChunk(std::string_view raw, uint32_t records, bool defineTypes, std::vector<std::string> &types,
+                SessionChunk *out) {
+  Cursor cursor(raw);
+  uint64_t newTypes = 0;
+  if (!cursor.Varint(newTypes) || newTypes > raw.size()) return false;
+  for (uint64_t i = 0; i < newTypes; ++i) {
+    uint64_t length = 0;
+    std::string_view name;
+    if (!cursor.Varint(length) || !cursor.Bytes(length, name)) return false;
+    if (defineTypes) types.emplace_back(name);
+  }
+  if (!out) return true;
+
+  uint64_t count = 0;
+  if (!cursor.Varint(count) || count != records) return false;
+  out->times.resize(count);
+  out->types.resize(count);
+  out->texts.resize(count);
+  int64_t time = 0;
+  for (auto &value : out->times) {
+    uint64_t delta = 0;
+    if (!cursor.Varint(delta)) return false;
+    time += UnZigZag(delta);
+    value = time;
+  }
+  for (auto &value : out->types) {
+    uint64_t id = 0;
+    if (!cursor.Varint(id) || id >= types.size()) return false;
+    value = static_cast<uint32_t>(id);
+  }
+  std::vector<uint64_t> lengths(count);
+  for (auto &length : lengths) {
+    if (!cursor.Varint(length)) return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    std::string_view text;
+    if (!cursor.Bytes(lengths[i], text)) return false;
+    out->texts[i].assign(text);
+  }
+  return true;
+}
+
+} // namespace
+
+// SessionWriter
+
+SessionWriter::~SessionWriter() {
+  if (m_file) std::fclose(m_file);
+}
+
+bool SessionWriter::Open(const std::string &path) {
+  if (m_file) std::fclose(m_file);
+  m_failed = false;
+  m_offset = m_records = m_rawBytes = 0;
+  m_types.clear();
+  m_typeIds.clear();
+  m_definedTypes = 0;
+  m_chunks.clear();
+  m_times.clear();
+  m_recordTypes.clear();
+  m_lengths.clear();
+  m_texts.clear();
+  m_file = OpenFile(path, "wb");
+  if (!m_file) return false;
+
+  std::string header(kFileMagic, sizeof(kFileMagic));
+  PutU32(header, kFormatVersion);
+  PutU32(header, kDictionaryVersion);
+  return Write(header.data(), header.size());
+}
+
+bool SessionWriter::Write(const void *data, size_t size) {
+  if (m_failed || !m_file) return false;
+  if (std::fwrite(data, 1, size, m_file) != size) {
+    m_failed = true;
+    return false;
+  }
+  m_offset += size;
+  return true;
+}
+
+uint32_t SessionWriter::TypeId(std::string_view type) {
+  std::string key(type);
+  auto it = m_typeIds.find(key);
+  if (it != m_typeIds.end()) return it->second;
+  uint32_t id = static_cast<uint32_t>(m_types.size());
+  m_types.push_back(key);
+  m_typeIds.emplace(std::move(key), id);
+  return id;
+}
+
+bool SessionWriter::Append(int64_t time, std::string_view type, std::string_view text) {
+  if (!m_file || m_failed) return false;
+  m_times.push_back(time);
+  m_recordTypes.push_back(TypeId(type));
+  m_lengths.push_back(static_cast<uint32_t>(text.size()));
+  m_texts.append(text);
+  m_records++;
+  m_rawBytes += text.size();
+  if (m_texts.size() >= kChunkRawSize || m_times.size() >= kChunkRecords) return Flush();
+  return true;
+}
+
+bool SessionWriter::Flush() {
+  if (!m_file || m_failed) return false;
+  if (m_times.empty()) return true;
+
+  SessionChunkInfo chunk;
+  chunk.offset = m_offset;
+  chunk.records = static_cast<uint32_t>(m_times.size());
+  chunk.minTime = *std::min_element(m_times.begin(), m_times.end());
+  chunk.maxTime = *std::max_element(m_times.begin(), m_times.end());
+
+  // Columns compress better than interleaved records: times, types, lengths, then the texts
+  std::string raw;
+  raw.reserve(m_texts.size() + m_times.size() * 6 + 64);
+  PutVarint(raw, m_types.size() - m_definedTypes);
+  for (size_t i = m_definedTypes; i < m_types.size(); ++i) {
+    PutVarint(raw, m_types[i].size());
+    raw.append(m_types[i]);
+  }
+  m_definedTypes = m_types.size();
+  PutVarint(raw, m_times.size());
+  int64_t previous = 0;
+  for (int64_t time : m_times) {
+    PutVarint(raw, ZigZag(time - previous));
+    previous = time;
+  }
+  for (uint32_t type : m_recordTypes) {
+    PutVarint(raw, type);
+    chunk.typeMask |= type < 63 ? uint64_t(1) << type : kOverflowTypeBit;
+  }
+  for (uint32_t length : m_lengths) PutVarint(raw, length);
+  raw.append(m_texts);
+
+  std::string block = CompressBlock(raw, SessionDictionary());
+  chunk.compressedSize = static_cast<uint32_t>(block.size());
+  chunk.rawSize = static_cast<uint32_t>(raw.size());
+  chunk.checksum = Fnv1a(block);
+
+  std::string header;
+  PutU32(header, kChunkMagic);
+  PutChunkInfo(header, chunk);
+  PutU32(header, 0);
+  if (!Write(header.data(), header.size()) || !Write(block.data(), block.size())) return false;
+  m_chunks.push_back(chunk);
+
+  m_times.clear();
+  m_recordTypes.clear();
+  m_lengths.clear();
+  m_texts.clear();
+  return true;
+}
+
+bool SessionWriter::Close() {
+  if (!m_file) return false;
+  bool ok = Flush();
+
+  if (ok) {
+    uint64_t footerOffset = m_offset;
+    std::string footer;
+    PutU32(footer, kFooterMagic);
+    PutVarint(footer, m_types.size());
+    for (const auto &type : m_types) {
+      PutVarint(footer, type.size());
+      footer.append(type);
+    }
+    PutVarint(footer, m_chunks.size());
+    for (const auto &chunk : m_chunks) {
+      PutU64(footer, chunk.offset);
+      PutChunkInfo(footer, chunk);
+    }
+    PutU64(footer, footerOffset);
+    PutU32(footer, static_cast<uint32_t>(footer.size() - 8));
+    PutU32(footer, kEndMagic);
+    ok = Write(footer.data(), footer.size());
+  }
+
+  ok = std::fclose(m_file) == 0 && ok;
+  m_file = nullptr;
+  return ok;
+}
+
+// SessionExport
+
+namespace {
+
+size_t BatchBytes(const std::vector<SessionRecord> &batch) noexcept {
+  size_t bytes = 0;
+  for (const auto &record : batch) bytes += record.type.size() + record.text.size();
+  return bytes;
+}
+
+} // namespace
+
+SessionExport::~SessionExport() { Finish(); }
+
+bool SessionExport::Append(std::vector<SessionRecord> batch) {
+  size_t bytes = BatchBytes(batch);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // One batch bigger than the whole budget still goes through an empty queue
+  if (m_finished || (m_queuedBytes > 0 && m_queuedBytes + bytes > kMaxQueuedBytes)) {
+    if (!m_finished) m_dropped += batch.size();
+    return false;
+  }
+  m_queuedBytes += bytes;
+  m_queue.push_back(std::move(batch));
+  if (!m_draining) {
+    m_draining = true;
+    m_executor.Post(TaskPriority::Background, [this] { Drain(); });
+  }
+  return true;
+}
+
+void SessionExport::Drain() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_queue.empty()) {
+    std::vector<SessionRecord> batch = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    for (const auto &record : batch) m_writer.Append(record.time, record.type, record.text);
+    lock.lock();
+    m_queuedBytes -= BatchBytes(batch);
+  }
+  m_draining = false;
+  m_drained.notify_all();
+}
+
+bool SessionExport::Finish() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_finished) return false;
+    m_finished = true;
+    m_drained.wait(lock, [&] { return !m_draining; });
+  }
+  return m_writer.Close();
+}
+
+uint64_t SessionExport::Dropped() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_dropped;
+}
+
+// SessionReader
+
+SessionReader::~SessionReader() { Close(); }
+
+void SessionReader::Close() {
+  if (m_file) std::fclose(m_file);
+  m_file = nullptr;
+  m_size = 0;
+  m_recovered = false;
+  m_types.clear();
+  m_chunks.clear();
+}
+
+bool SessionReader::Open(const std::string &path) {
+  Close();
+  m_file = OpenFile(path, "rb");
+  if (!m_file) return false;
+
+  char header[kFileHeaderSize];
+  bool ok = std::fread(header, 1, sizeof(header), m_file) == sizeof(header) &&
+            std::memcmp(header, kFileMagic, sizeof(kFileMagic)) == 0;
+  if (ok) {
+    Cursor cursor(std::string_view(header + 8, 8));
+    uint32_t format = 0, dictionary = 0;
+    ok = cursor.U32(format) && format == kFormatVersion && cursor.U32(dictionary) && dictionary == kDictionaryVersion;
+  }
+  if (ok && std::fseek(m_file, 0, SEEK_END) == 0) {
+#if defined(_WIN32)
+    m_size = static_cast<uint64_t>(_ftelli64(m_file));
+#else
+    m_size = static_cast<uint64_t>(ftello(m_file));
+#endif
+  }
+  if (ok && !ReadFooter()) {
+    m_recovered = true;
+    ok = ScanChunks();
+  }
+  if (!ok) Close();
+  return ok;
+}
+
+bool SessionReader::ReadFooter() {
+  if (m_size < kFileHeaderSize + kTrailerSize) return false;
+  char trailer[kTrailerSize];
+  if (!ReadAt(m_file, m_size - kTrailerSize, trailer, sizeof(trailer))) return false;
+  Cursor trailerCursor(std::string_view(trailer, sizeof(trailer)));
+  uint64_t footerOffset = 0;
+  uint32_t footerSize = 0;
+  uint32_t magic = 0;
+  trailerCursor.U64(footerOffset);
+  trailerCursor.U32(footerSize);
+  trailerCursor.U32(magic);
+  if (magic != kEndMagic || footerOffset < kFileHeaderSize || footerOffset + footerSize + kTrailerSize != m_size) return false;
+
+  std::string footer(footerSize, '\0');
+  if (!ReadAt(m_file, footerOffset, footer.data(), footer.size())) return false;
+  Cursor cursor(footer);
+  uint32_t footerMagic = 0;
+  uint64_t typeCount = 0;
+  if (!cursor.U32(footerMagic) || footerMagic != kFooterMagic || !cursor.Varint(typeCount) || typeCount > footerSize) {
+    return false;
+  }
+  std::vector<std::string> types;
+  types.reserve(typeCount);
+  for (uint64_t i = 0; i < typeCount; ++i) {
+    uint64_t length = 0;
+    std::string_view name;
+    if (!cursor.Varint(length) || !cursor.Bytes(length, name)) return false;
+    types.emplace_back(name);
+  }
+  uint64_t chunkCount = 0;
+  if (!cursor.Varint(chunkCount) || chunkCount > footerSize) return false;
+  std::vector<SessionChunkInfo> chunks(chunkCount);
+  for (auto &chunk : chunks) {
+    if (!cursor.U64(chunk.offset) || !ReadChunkInfo(cursor, chunk)) return false;
+    if (chunk.offset + kChunkHeaderSize + chunk.compressedSize > footerOffset) return false;
+  }
+
+  m_types = std::move(types);
+  m_chunks = std::move(chunks);
+  return true;
+}
+
+bool SessionReader::ScanChunks() {
+  // Keep every chunk up to the first damaged or truncated one
+  m_types.clear();
+  m_chunks.clear();
+  uint64_t offset = kFileHeaderSize;
+  std::string raw;
+  while (offset + kChunkHeaderSize <= m_size) {
+    char header[kChunkHeaderSize];
+    if (!ReadAt(m_file, offset, header, sizeof(header))) break;
+    Cursor cursor(std::string_view(header, sizeof(header)));
+    uint32_t magic = 0;
+    SessionChunkInfo chunk;
+    chunk.offset = offset;
+    if (!cursor.U32(magic) || magic != kChunkMagic || !ReadChunkInfo(cursor, chunk)) break;
+    if (offset + kChunkHeaderSize + chunk.compressedSize > m_size) break;
+    if (!ReadBlock(chunk, raw) || !ParseChunk(raw, chunk.records, true, m_types, nullptr)) break;
+    m_chunks.push_back(chunk);
+    offset += kChunkHeaderSize + chunk.compressedSize;
+  }
+  return true;
+}
+
+bool SessionReader::ReadBlock(const SessionChunkInfo &chunk, std::string &raw) {
+  if (chunk.rawSize > kMaxChunkRawSize) return false;
+  m_block.resize(chunk.compressedSize);
+  if (!ReadAt(m_file, chunk.offset + kChunkHeaderSize, m_block.data(), m_block.size())) return false;
+  if (Fnv1a(m_block) != chunk.checksum) return false;
+  return DecompressBlock(m_block, SessionDictionary(), chunk.rawSize, raw);
+}
+
+uint64_t SessionReader::Records() const noexcept {
+  uint64_t records = 0;
+  for (const auto &chunk : m_chunks) records += chunk.records;
+  return records;
+}
+
+bool SessionReader::ReadChunk(size_t index, SessionChunk &out) {
+  if (!m_file || index >= m_chunks.size()) return false;
+  std::string raw;
+  const SessionChunkInfo &chunk = m_chunks[index];
+  return ReadBlock(chunk, raw) && ParseChunk(raw, chunk.records, false, m_types, &out);
+}
+
+std::vector<size_t> SessionReader::FindChunks(const std::vector<uint32_t> &typeIds, int64_t from, int64_t to) const {
+  uint64_t mask = 0;
+  for (uint32_t id : typeIds) mask |= id < 63 ? uint64_t(1) << id : kOverflowTypeBit;
+
+  std::vector<size_t> found;
+  for (size_t i = 0; i < m_chunks.size(); ++i) {
+    const SessionChunkInfo &chunk = m_chunks[i];
+    if (chunk.maxTime < from || chunk.minTime > to) continue;
+    if (mask && !(chunk.typeMask & mask)) continue;
+    found.push_back(i);
+  }
+  return found;
+}
+
+} // namespace reactotron
@@ -0,0 +1,201 @@
+#pragma once
+
+//
+//  SessionArchive.h
+//  Reactotron
+//
+//  Session archive files: the raw messages of a session, in time order, written
+//  as independently compressed chunks with a footer index, so a session can be
+//  exported while it's captured and read back a chunk at a time.
+//
+//  Layout: a 16-byte file header (magic, then the format and dictionary
+//  versions), then chunks (a 48-byte header and a block from SessionCodec),
+//  then the footer (type table and one entry per chunk) and a 16-byte trailer
+//  pointing at it. A file without a footer, from an export that never
+//  finished, is still readable by scanning the chunk headers.
+//
+
+#include "../TaskExecutor/TaskExecutor.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct SessionChunkInfo {
+  uint64_t offset = 0; // Of the chunk header
+  uint32_t compressedSize = 0;
+  uint32_t rawSize = 0;
+  uint32_t records = 0;
+  int64_t minTime = 0;
+  int64_t maxTime = 0;
+  uint64_t typeMask = 0; // Bit i for type id i < 63; bit 63 for any later type
+  uint32_t checksum = 0; // FNV-1a of the compressed block
+};
+
+/** One decoded chunk, as parallel arrays. */
+struct SessionChunk {
+  std::vector<int64_t> times;
+  std::vector<uint32_t> types; // Ids into SessionReader::Types()
+  std::vector<std::string> texts;
+};
+
+/**
+ * Appends records to a new archive. Records are buffered until the chunk is full
+ * (kChunkRawSize bytes or kChunkRecords records), then compressed and written.
+ * Close() writes the footer; without it the file is still readable.
+ *
+ * Not thread-safe.
+ */
+class SessionWriter {
+ public:
+  static constexpr size_t kChunkRawSize = 1024 * 1024;
+  static constexpr size_t kChunkRecords = 16384;
+
+  SessionWriter() = default;
+  SessionWriter(const SessionWriter &) = delete;
+  SessionWriter &operator=(const SessionWriter &) = delete;
+  ~SessionWriter();
+
+  /** Creates (or truncates) `path`. Returns false if it can't be written. */
+  bool Open(const std::string &path);
+  bool IsOpen() const noexcept { return m_file != nullptr; }
+
+  /** `time` is in ms; records should come in time order, but any order is kept. */
+  bool Append(int64_t time, std::string_view type, std::string_view text);
+  /** Writes the buffered records as a chunk. */
+  bool Flush();
+  /** Flushes, writes the footer and closes the file. */
+  bool Close();
+
+  uint64_t Records() const noexcept { return m_records; }
+  uint64_t RawBytes() const noexcept { return m_rawBytes; }
+  uint64_t Bytes() const noexcept { return m_offset; }
+
+ private:
+  uint32_t TypeId(std::string_view type);
+  bool Write(const void *data, size_t size);
+
+  std::FILE *m_file = nullptr;
+  bool m_failed = false;
+  uint64_t m_offset = 0;
+  uint64_t m_records = 0;
+  uint64_t m_rawBytes = 0;
+
+  std::vector<std::string> m_types;
+  std::unordered_map<std::string, uint32_t> m_typeIds;
+  size_t m_definedTypes = 0; // Types already written in a chunk
+  std::vector<SessionChunkInfo> m_chunks;
+
+  // Pending chunk
+  std::vector<int64_t> m_times;
+  std::vector<uint32_t> m_recordTypes;
+  std::vector<uint32_t> m_lengths;
+  std::string m_texts;
+};
+
+struct SessionRecord {
+  int64_t time = 0; // ms
+  std::string type;
+  std::string text;
+};
+
+/**
+ * An export in progress, fed a batch of records at a time from the JS thread.
+ * Batches are written in order by one task at a time on the executor's
+ * Background lane, so compression and disk I/O stay off the JS thread. At most
+ * kMaxQueuedBytes of text wait to be written: a batch that would go past that
+ * is dropped and its records counted, rather than queueing without limit
+ * behind a slow disk.
+ *
+ * Thread-safe.
+ */
+class SessionExport {
+ public:
+  static constexpr size_t kMaxQueuedBytes = 32 * 1024 * 1024;
+
+  explicit SessionExport(TaskExecutor &executor = TaskExecutor::Shared()) : m_executor(executor) {}
+  SessionExport(const SessionExport &) = delete;
+  SessionExport &operator=(const SessionExport &) = delete;
+  /** Finishes the export if Finish() wasn't called. */
+  ~SessionExport();
+
+  /** Creates (or truncates) `path`. Returns false if it can't be written. */
+  bool Open(const std::string &path) { return m_writer.Open(path); }
+  /** Queues `batch`. False if it was dropped, or the export is finished. */
+  bool Append(std::vector<SessionRecord> batch);
+  /** Waits for the queued batches to be written, then closes the archive. */
+  bool Finish();
+
+  /** Call after Finish(). */
+  const SessionWriter &Writer() const noexcept { return m_writer; }
+  /** Records dropped because the queue was full. */
+  uint64_t Dropped() const;
+
+ private:
+  void Drain();
+
+  TaskExecutor &m_executor;
+  SessionWriter m_writer; // Only touched by Drain(), then by Finish()
+  mutable std::mutex m_mutex;
+  std::condition_variable m_drained;
+  std::deque<std::vector<SessionRecord>> m_queue;
+  size_t m_queuedBytes = 0;
+  bool m_draining = false; // A Drain() task is posted or running
+  bool m_finished = false;
+  uint64_t m_dropped = 0;
+};
+
+/**
+ * Reads an archive. Open() only reads the footer (or, for an unfinished export,
+ * scans the chunk headers); chunks are read and decoded on demand.
+ *
+ * Not thread-safe.
+ */
+class SessionReader {
+ public:
+  SessionReader() = default;
+  SessionReader(const SessionReader &) = delete;
+  SessionReader &operator=(const SessionReader &) = delete;
+  ~SessionReader();
+
+  bool Open(const std::string &path);
+  void Close();
+
+  const std::vector<SessionChunkInfo> &Chunks() const noexcept { return m_chunks; }
+  const std::vector<std::string> &Types() const noexcept { return m_types; }
+  uint64_t Records() const noexcept;
+  /** True if the file had no footer and was recovered by scanning. */
+  bool Recovered() const noexcept { return m_recovered; }
+
+  /** Decodes chunk `index`. Returns false if it's out of range or corrupt. */
+  bool ReadChunk(size_t index, SessionChunk &out);
+
+  /**
+   * Indexes of the chunks that may hold records of one of `typeIds` (any type if
+   * empty) with a time in [from, to].
+   */
+  std::vector<size_t> FindChunks(const std::vector<uint32_t> &typeIds, int64_t from, int64_t to) const;
+
+ private:
+  bool ReadFooter();
+  bool ScanChunks();
+  bool ReadBlock(const SessionChunkInfo &chunk, std::string &raw);
+
+  std::FILE *m_file = nullptr;
+  uint64_t m_size = 0;
+  bool m_recovered = false;
+  std::vector<std::string> m_types;
+  std::vector<SessionChunkInfo> m_chunks;
+  std::string m_block; // Reused read buffer
+};
+
+} // namespace reactotron
@@ -0,0 +1,162 @@
+//
+//  SessionCodec.cpp
+//  Reactotron
+//
+
+#include "SessionCodec.h"
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#include "../IRBodyStore/BodyDecoding.h"
+#else
+#include <algorithm>
+#include <climits>
+#include <zlib.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+/** A block's first byte: how the rest of it is stored. */
+enum BlockMethod : uint8_t {
+  kStored = 0,
+  kDeflate = 1, // Raw DEFLATE with the dictionary as its preset dictionary
+};
+
+#if !defined(_WIN32)
+constexpr int kLevel = 6;
+constexpr size_t kMaxZlibChunk = UINT_MAX; // z_stream counts are 32-bit
+
+/** `dictionary` as zlib takes it: its last 32 KB, the most the window reaches. */
+std::string_view Window(std::string_view dictionary) noexcept {
+  constexpr size_t kWindow = size_t(1) << 15;
+  return dictionary.size() > kWindow ? dictionary.substr(dictionary.size() - kWindow) : dictionary;
+}
+
+bool Deflate(std::string_view data, std::string_view dictionary, std::string &block) {
+  z_stream stream{};
+  if (deflateInit2(&stream, kLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+  dictionary = Window(dictionary);
+  bool ok = dictionary.empty() ||
+            deflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary.data()),
+                                 static_cast<uInt>(dictionary.size())) == Z_OK;
+  // Given no more room than storing it would take
+  size_t start = block.size();
+  block.resize(start + data.size());
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.next_out = reinterpret_cast<Bytef *>(block.data() + start);
+  size_t inLeft = data.size(), outLeft = data.size();
+  int result = Z_OK;
+  while (ok && result == Z_OK) {
+    if (stream.avail_in == 0 && inLeft > 0) {
+      stream.avail_in = static_cast<uInt>(std::min(inLeft, kMaxZlibChunk));
+      inLeft -= stream.avail_in;
+    }
+    if (stream.avail_out == 0) {
+      if (outLeft == 0) break; // No smaller than stored
+      stream.avail_out = static_cast<uInt>(std::min(outLeft, kMaxZlibChunk));
+      outLeft -= stream.avail_out;
+    }
+    result = deflate(&stream, inLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+  }
+  ok = ok && result == Z_STREAM_END;
+  block.resize(start + (ok ? stream.total_out : 0));
+  deflateEnd(&stream);
+  return ok;
+}
+
+bool Inflate(std::string_view data, std::string_view dictionary, size_t rawSize, std::string &out) {
+  z_stream stream{};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+  dictionary = Window(dictionary);
+  bool ok = dictionary.empty() ||
+            inflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary.data()),
+                                 static_cast<uInt>(dictionary.size())) == Z_OK;
+  // One byte of room past rawSize, so a block that decodes to more is caught
+  out.resize(rawSize + 1);
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.next_out = reinterpret_cast<Bytef *>(out.data());
+  size_t inLeft = data.size(), outLeft = out.size();
+  int result = Z_OK;
+  while (ok && result == Z_OK) {
+    if (stream.avail_in == 0 && inLeft > 0) {
+      stream.avail_in = static_cast<uInt>(std::min(inLeft, kMaxZlibChunk));
+      inLeft -= stream.avail_in;
+    }
+    if (stream.avail_out == 0 && outLeft > 0) {
+      stream.avail_out = static_cast<uInt>(std::min(outLeft, kMaxZlibChunk));
+      outLeft -= stream.avail_out;
+    }
+    result = inflate(&stream, Z_NO_FLUSH);
+  }
+  ok = ok && result == Z_STREAM_END && stream.total_out == rawSize && stream.avail_in == 0 && inLeft == 0;
+  inflateEnd(&stream);
+  out.resize(ok ? rawSize : 0);
+  return ok;
+}
+#endif
+
+} // namespace
+
+std::string CompressBlock(std::string_view data, std::string_view dictionary) {
+  std::string block(1, static_cast<char>(kDeflate));
+#if defined(_WIN32)
+  (void)dictionary;
+#else
+  if (Deflate(data, dictionary, block)) return block;
+#endif
+  block.assign(1, static_cast<char>(kStored));
+  block.append(data);
+  return block;
+}
+
+bool DecompressBlock(std::string_view block, std::string_view dictionary, size_t rawSize, std::string &out) {
+  if (block.empty()) return false;
+  auto method = static_cast<uint8_t>(block[0]);
+  block.remove_prefix(1);
+  if (method == kStored) {
+    if (block.size() != rawSize) return false;
+    out.assign(block);
+    return true;
+  }
+  if (method != kDeflate) return false;
+#if defined(_WIN32)
+  return InflateBuiltIn(block, DeflateWrapper::Raw, out, rawSize, dictionary) && out.size() == rawSize;
+#else
+  return Inflate(block, dictionary, rawSize, out);
+#endif
+}
+
+std::string_view SessionDictionary() noexcept {
+  // Least common first: the end of the dictionary is closest to the data, so its matches are cheapest
+  static constexpr const char kDictionary[] =
+      "\"image\":{\"uri\":\"data:image/png;base64,\"preview\":\"\"value\":{\"name\":\"Redux\",\"display\","
+      "\"type\":\"display\",\"payload\":{\"name\":\"\"steps\":[{\"title\":\"\",\"time\":0,\"delta\":0},{\"title\":\""
+      "\",\"time\":\",\"delta\":\"type\":\"benchmark.report\",\"payload\":{\"title\":\""
+      "\"type\":\"custom.command.register\",\"payload\":{\"id\":\"command\":\"title\":\"description\":\"args\":["
+      "\"type\":\"state.values.change\",\"payload\":{\"changes\":[{\"path\":\"\",\"value\":"
+      "\"type\":\"state.action.complete\",\"payload\":{\"name\":\"\",\"action\":{\"type\":\"\",\"payload\":"
+      "},\"ms\":\"stack\":[{\"fileName\":\"\",\"functionName\":\"\",\"lineNumber\":\",\"columnNumber\":"
+      "\"level\":\"error\",\"message\":\"\"level\":\"warn\",\"message\":\""
+      "\"type\":\"connectionEstablished\",\"conn\":{\"id\":\"clientId\":\"\",\"address\":\"::ffff:127.0.0.1\","
+      "\"name\":\"\",\"environment\":\"development\",\"reactotronLibraryName\":\"reactotron-react-native\","
+      "\"reactotronLibraryVersion\":\"\",\"platform\":\"ios\",\"platformVersion\":\"\",\"osRelease\":\"\","
+      "\"model\":\"\",\"serverHost\":\"localhost\",\"reactNativeVersion\":\"\",\"screenWidth\":\"screenHeight\":"
+      "\"statusText\":\"OK\",\"status\":404,\"statusText\":\"Not Found\",\"status\":500,\"statusText\":\"Internal "
+      "Server Error\",\"status\":201,\"statusText\":\"Created\",\"status\":204,\"statusText\":\"No Content\","
+      "\"content-length\":\"\",\"cache-control\":\"no-cache\",\"date\":\"\",\"etag\":\"W/\\\"\",\"server\":\""
+      "\"content-type\":\"application/json; charset=utf-8\",\"x-powered-by\":\"Express\","
+      "\"Content-Type\":\"application/json\",\"Authorization\":\"Bearer \",\"Accept\":\"application/json, "
+      "text/plain, */*\"},\"params\":{\"method\":\"POST\",\"data\":{\"method\":\"PUT\",\"method\":\"DELETE\","
+      "\"type\":\"api.response\",\"payload\":{\"duration\":\"request\":{\"url\":\"https://\",\"method\":\"GET\","
+      "\"data\":null,\"headers\":{\"response\":{\"status\":200,\"statusText\":\"OK\",\"headers\":{"
+      "\"type\":\"log\",\"payload\":{\"level\":\"debug\",\"message\":\""
+      "\"important\":false,\"important\":true,\"date\":\"20\",\"deltaTime\":\"clientId\":\""
+      "\",\"connectionId\":\"messageId\":\"type\":\"command\",\"cmd\":{\"type\":\"log\",\"payload\":{"
+      "\"level\":\"debug\",\"message\":\"},\"important\":false,\"date\":\"20";
+  return std::string_view(kDictionary, sizeof(kDictionary) - 1);
+}
+
+} // namespace reactotron
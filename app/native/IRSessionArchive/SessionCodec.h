@@ -0,0 +1,38 @@
+#pragma once
+
+//
+//  SessionCodec.h
+//  Reactotron
+//
+//  Block compressor for session archives: raw DEFLATE from zlib, primed with a
+//  preset dictionary of the JSON Reactotron commands are made of. A block that
+//  wouldn't shrink is stored instead, as is every block on Windows, which has
+//  no system DEFLATE encoder; it reads deflated blocks with InflateBuiltIn().
+//  Every block decodes on its own, given the same dictionary.
+//
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace reactotron {
+
+/**
+ * Compresses `data`. Matches may reach back into the last 32 KB of
+ * `dictionary`, which the decompressor must be given as well.
+ */
+std::string CompressBlock(std::string_view data, std::string_view dictionary);
+
+/**
+ * Decompresses a block made by CompressBlock into `out`. Returns false if the
+ * block is corrupt or doesn't decode to exactly `rawSize` bytes.
+ */
+bool DecompressBlock(std::string_view block, std::string_view dictionary, size_t rawSize, std::string &out);
+
+/**
+ * Built-in dictionary of the JSON shapes Reactotron commands are made of, so the
+ * first records of every block already compress well.
+ */
+std::string_view SessionDictionary() noexcept;
+
+} // namespace reactotron
@@ -0,0 +1,180 @@
+//
+//  IRStateSnapshots.mm
+//  Reactotron-macOS
+//
+//  State snapshot history: splits, hashes and splices snapshots on a serial
+//  background queue, so large states never block the JS thread.
+//
+
+#import "IRStateSnapshots.h"
+#include "StateSnapshots.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include <string>
+#include <vector>
+
+@implementation IRStateSnapshots {
+  dispatch_queue_t _queue;
+  reactotron::SnapshotStore _store; // Only touched on _queue
+  uint32_t _memoryStoreId;
+}
+
+RCT_EXPORT_MODULE()
+
+- (instancetype)init {
+  if (self = [super init]) {
+    _queue = dispatch_queue_create("com.reactotron.stateSnapshots", DISPATCH_QUEUE_SERIAL);
+    // The governor calls from its own thread, so the store is shrunk on _queue and reports when it has
+    __weak IRStateSnapshots *weakSelf = self;
+    _memoryStoreId = reactotron::MemoryGovernor::Shared().Register("stateSnapshots", [weakSelf](uint64_t bytes) -> uint64_t {
+      IRStateSnapshots *strongSelf = weakSelf;
+      if (!strongSelf) return 0;
+      dispatch_async(strongSelf->_queue, ^{
+        strongSelf->_store.Shrink(bytes);
+        [strongSelf reportMemory];
+      });
+      return bytes;
+    });
+  }
+  return self;
+}
+
+- (void)dealloc {
+  reactotron::MemoryGovernor::Shared().Unregister(_memoryStoreId);
+}
+
+/** Call on _queue. */
+- (void)reportMemory {
+  reactotron::SnapshotStoreStats stats = _store.Stats();
+  reactotron::MemoryGovernor::Shared().Report(_memoryStoreId, stats.storedBytes, stats.oldestTime);
+}
+
+static std::string IRStateSnapshotsString(NSString *string) {
+  const char *utf8 = string.UTF8String;
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+static NSString *IRStateSnapshotsNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+static NSString *IRStateSnapshotsKind(reactotron::SnapshotChangeKind kind) {
+  switch (kind) {
+    case reactotron::SnapshotChangeKind::Added:
+      return @"added";
+    case reactotron::SnapshotChangeKind::Removed:
+      return @"removed";
+    case reactotron::SnapshotChangeKind::Changed:
+      return @"changed";
+  }
+  return @"changed";
+}
+
+- (void)add:(NSString *)clientId
+      label:(NSString *)label
+       time:(double)time
+       json:(NSString *)json
+    resolve:(nonnull RCTPromiseResolveBlock)resolve
+     reject:(nonnull RCTPromiseRejectBlock)reject {
+  std::string clientIdString = IRStateSnapshotsString(clientId);
+  std::string labelString = IRStateSnapshotsString(label);
+  std::string jsonString = IRStateSnapshotsString(json);
+  dispatch_async(_queue, ^{
+    uint64_t id = self->_store.Add(clientIdString, labelString, static_cast<int64_t>(time), jsonString);
+    [self reportMemory];
+    if (id) {
+      resolve(@(id));
+    } else {
+      reject(@"invalid_json", @"The state snapshot is not valid JSON", nil);
+    }
+  });
+}
+
+- (void)materialize:(double)id
+            resolve:(nonnull RCTPromiseResolveBlock)resolve
+             reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(_queue, ^{
+    std::string json;
+    if (!self->_store.Materialize(static_cast<uint64_t>(id), json)) {
+      reject(@"no_snapshot", @"State snapshot is missing", nil);
+      return;
+    }
+    resolve(IRStateSnapshotsNSString(json));
+  });
+}
+
+- (void)diff:(double)from
+          to:(double)to
+     resolve:(nonnull RCTPromiseResolveBlock)resolve
+      reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(_queue, ^{
+    std::vector<reactotron::SnapshotChange> changes;
+    if (!self->_store.Diff(static_cast<uint64_t>(from), static_cast<uint64_t>(to), changes)) {
+      reject(@"no_snapshot", @"State snapshot is missing", nil);
+      return;
+    }
+    NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:changes.size()];
+    for (const auto &change : changes) {
+      [result addObject:@{
+        @"path": IRStateSnapshotsNSString(change.path),
+        @"kind": IRStateSnapshotsKind(change.kind),
+        @"value": IRStateSnapshotsNSString(change.value),
+        @"valueSize": @(change.valueSize),
+        @"truncated": @(change.truncated),
+      }];
+    }
+    resolve(result);
+  });
+}
+
+- (void)list:(NSString *)clientId
+     resolve:(nonnull RCTPromiseResolveBlock)resolve
+      reject:(nonnull RCTPromiseRejectBlock)reject {
+  std::string clientIdString = IRStateSnapshotsString(clientId);
+  dispatch_async(_queue, ^{
+    std::vector<reactotron::SnapshotInfo> snapshots = self->_store.Snapshots(clientIdString);
+    NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:snapshots.size()];
+    for (const auto &snapshot : snapshots) {
+      [result addObject:@{
+        @"id": @(snapshot.id),
+        @"clientId": IRStateSnapshotsNSString(snapshot.clientId),
+        @"label": IRStateSnapshotsNSString(snapshot.label),
+        @"time": @(snapshot.time),
+        @"size": @(snapshot.size),
+      }];
+    }
+    resolve(result);
+  });
+}
+
+- (void)remove:(double)id {
+  dispatch_async(_queue, ^{
+    self->_store.Remove(static_cast<uint64_t>(id));
+    [self reportMemory];
+  });
+}
+
+- (void)clear {
+  dispatch_async(_queue, ^{
+    self->_store.Clear();
+    [self reportMemory];
+  });
+}
+
+- (void)getStats:(nonnull RCTPromiseResolveBlock)resolve reject:(nonnull RCTPromiseRejectBlock)reject {
+  dispatch_async(_queue, ^{
+    reactotron::SnapshotStoreStats stats = self->_store.Stats();
+    resolve(@{
+      @"snapshots": @(stats.snapshots),
+      @"nodes": @(stats.nodes),
+      @"pieces": @(stats.pieces),
+      @"logicalBytes": @(stats.logicalBytes),
+      @"storedBytes": @(stats.storedBytes),
+    });
+  });
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRStateSnapshotsSpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,168 @@
+//
+//  IRStateSnapshots.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared SnapshotStore
+//
+
+#include "pch.h"
+#include "IRStateSnapshots.windows.h"
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    static const char *ChangeKindName(::reactotron::SnapshotChangeKind kind) noexcept
+    {
+        switch (kind)
+        {
+        case ::reactotron::SnapshotChangeKind::Added:
+            return "added";
+        case ::reactotron::SnapshotChangeKind::Removed:
+            return "removed";
+        default:
+            return "changed";
+        }
+    }
+
+    IRStateSnapshots::IRStateSnapshots() noexcept
+    {
+        m_memoryStoreId = ::reactotron::MemoryGovernor::Shared().Register("stateSnapshots", [this](uint64_t bytes) -> uint64_t
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint64_t freed = m_store.Shrink(bytes);
+            ReportMemory();
+            return freed;
+        });
+    }
+
+    IRStateSnapshots::~IRStateSnapshots() noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().Unregister(m_memoryStoreId);
+    }
+
+    void IRStateSnapshots::ReportMemory() noexcept
+    {
+        ::reactotron::SnapshotStoreStats stats = m_store.Stats();
+        ::reactotron::MemoryGovernor::Shared().Report(m_memoryStoreId, stats.storedBytes, stats.oldestTime);
+    }
+
+    // REACT_METHOD calls run off the JS thread, so splitting a large state here doesn't stall it
+
+    void IRStateSnapshots::add(std::string clientId, std::string label, double time, std::string json,
+                               Microsoft::ReactNative::ReactPromise<double> const &promise) noexcept
+    {
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            id = m_store.Add(clientId, label, static_cast<int64_t>(time), json);
+            ReportMemory();
+        }
+        if (id)
+        {
+            promise.Resolve(static_cast<double>(id));
+        }
+        else
+        {
+            promise.Reject("The state snapshot is not valid JSON");
+        }
+    }
+
+    void IRStateSnapshots::materialize(double id, Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept
+    {
+        std::string json;
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ok = m_store.Materialize(static_cast<uint64_t>(id), json);
+        }
+        if (ok)
+        {
+            promise.Resolve(json);
+        }
+        else
+        {
+            promise.Reject("State snapshot is missing");
+        }
+    }
+
+    void IRStateSnapshots::diff(double from, double to, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        std::vector<::reactotron::SnapshotChange> changes;
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ok = m_store.Diff(static_cast<uint64_t>(from), static_cast<uint64_t>(to), changes);
+        }
+        if (!ok)
+        {
+            promise.Reject("State snapshot is missing");
+            return;
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (auto &change : changes)
+        {
+            Microsoft::ReactNative::JSValueObject item;
+            item["path"] = std::move(change.path);
+            item["kind"] = ChangeKindName(change.kind);
+            item["value"] = std::move(change.value);
+            item["valueSize"] = static_cast<double>(change.valueSize);
+            item["truncated"] = change.truncated;
+            result.push_back(std::move(item));
+        }
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    void IRStateSnapshots::list(std::string clientId, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        std::vector<::reactotron::SnapshotInfo> snapshots;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            snapshots = m_store.Snapshots(clientId);
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (auto &snapshot : snapshots)
+        {
+            Microsoft::ReactNative::JSValueObject item;
+            item["id"] = static_cast<double>(snapshot.id);
+            item["clientId"] = std::move(snapshot.clientId);
+            item["label"] = std::move(snapshot.label);
+            item["time"] = static_cast<double>(snapshot.time);
+            item["size"] = static_cast<double>(snapshot.size);
+            result.push_back(std::move(item));
+        }
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+
+    void IRStateSnapshots::remove(double id) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_store.Remove(static_cast<uint64_t>(id));
+        ReportMemory();
+    }
+
+    void IRStateSnapshots::clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_store.Clear();
+        ReportMemory();
+    }
+
+    void IRStateSnapshots::getStats(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        ::reactotron::SnapshotStoreStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats = m_store.Stats();
+        }
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["snapshots"] = static_cast<double>(stats.snapshots);
+        result["nodes"] = static_cast<double>(stats.nodes);
+        result["pieces"] = static_cast<double>(stats.pieces);
+        result["logicalBytes"] = static_cast<double>(stats.logicalBytes);
+        result["storedBytes"] = static_cast<double>(stats.storedBytes);
+        promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+    }
+}
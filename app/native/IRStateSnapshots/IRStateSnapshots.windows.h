@@ -0,0 +1,45 @@
+#pragma once
+#include "NativeModules.h"
+#include "StateSnapshots.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include <mutex>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRStateSnapshots)
+    struct IRStateSnapshots
+    {
+        IRStateSnapshots() noexcept;
+        ~IRStateSnapshots() noexcept;
+
+        REACT_METHOD(add)
+        void add(std::string clientId, std::string label, double time, std::string json,
+                 Microsoft::ReactNative::ReactPromise<double> const &promise) noexcept;
+
+        REACT_METHOD(materialize)
+        void materialize(double id, Microsoft::ReactNative::ReactPromise<std::string> const &promise) noexcept;
+
+        REACT_METHOD(diff)
+        void diff(double from, double to, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(list)
+        void list(std::string clientId, Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(remove)
+        void remove(double id) noexcept;
+
+        REACT_METHOD(clear)
+        void clear() noexcept;
+
+        REACT_METHOD(getStats)
+        void getStats(Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+    private:
+        /** Call with m_mutex held. */
+        void ReportMemory() noexcept;
+
+        ::reactotron::SnapshotStore m_store;
+        std::mutex m_mutex;
+        uint32_t m_memoryStoreId = 0;
+    };
+}
@@ -0,0 +1,51 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface StateSnapshotInfo {
+  /** Handle for materialize, diff and remove; increases with every snapshot. */
+  id: number
+  clientId: string
+  /** Usually the action that led to the state. */
+  label: string
+  /** ms since the epoch. */
+  time: number
+  /** Size of the snapshot's JSON. */
+  size: number
+}
+
+export interface StateSnapshotChange {
+  /** Like "todos[3].done"; keys keep their JSON escapes. */
+  path: string
+  /** "added", "removed" or "changed". */
+  kind: string
+  /** The new JSON value; empty if removed or truncated. */
+  value: string
+  valueSize: number
+  truncated: boolean
+}
+
+export interface StateSnapshotStats {
+  snapshots: number
+  nodes: number
+  pieces: number
+  /** Sum of the snapshots' JSON sizes. */
+  logicalBytes: number
+  /** What the store actually holds, after sharing unchanged subtrees. */
+  storedBytes: number
+}
+
+export interface Spec extends TurboModule {
+  /** Stores `json` and resolves its id, or rejects if it isn't valid JSON. */
+  add(clientId: string, label: string, time: number, json: string): Promise<number>
+  /** Resolves the snapshot's JSON, as it was added. */
+  materialize(id: number): Promise<string>
+  /** Changes that turn snapshot `from` into `to`; only subtrees that differ are visited. */
+  diff(from: number, to: number): Promise<StateSnapshotChange[]>
+  /** Snapshots of `clientId` (all clients if empty), oldest first. */
+  list(clientId: string): Promise<StateSnapshotInfo[]>
+  remove(id: number): void
+  clear(): void
+  getStats(): Promise<StateSnapshotStats>
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRStateSnapshots")
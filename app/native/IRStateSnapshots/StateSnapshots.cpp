@@ -0,0 +1,559 @@
+//
+//  StateSnapshots.cpp
+//  Reactotron
+//
+
+#include "StateSnapshots.h"
+#include "../IRLogStats/LogStats.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace reactotron {
+
+namespace {
+
+constexpr uint64_t kHighSeed = 0x243F6A8885A308D3ull;
+constexpr uint64_t kLowSeed = 0x13198A2E03707344ull;
+constexpr size_t kNodeOverhead = 64;  // Node, index entry and allocation headers, roughly
+constexpr size_t kPieceOverhead = 64;
+
+// Content-defined pieces: about 400 bytes on average, never under 128 bytes or over 4 KB
+constexpr size_t kMinPieceSize = 128;
+constexpr size_t kMaxPieceSize = 4 * 1024;
+constexpr uint64_t kPieceBoundaryMask = uint64_t(0xFF) << 40;
+
+const uint64_t *GearTable() {
+  static const auto table = [] {
+    std::array<uint64_t, 256> gear = {};
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto &value : gear) {
+      // splitmix64
+      uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      value = z ^ (z >> 31);
+    }
+    return gear;
+  }();
+  return table.data();
+}
+
+/** Length of the first content-defined piece of `text`. */
+size_t PieceLength(std::string_view text) noexcept {
+  if (text.size() <= kMinPieceSize) return text.size();
+  const uint64_t *gear = GearTable();
+  size_t limit = std::min(text.size(), kMaxPieceSize);
+  uint64_t hash = 0;
+  for (size_t i = kMinPieceSize; i < limit; ++i) {
+    hash = (hash << 1) + gear[static_cast<uint8_t>(text[i])];
+    if (!(hash & kPieceBoundaryMask)) return i + 1;
+  }
+  return limit;
+}
+
+inline bool IsSpace(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+inline bool IsContainer(char c) noexcept { return c == '{' || c == '['; }
+
+size_t SkipSpace(std::string_view text, size_t pos) noexcept {
+  while (pos < text.size() && IsSpace(text[pos])) ++pos;
+  return pos;
+}
+
+/** Position after the string that opens at `pos`, or npos if it doesn't end. */
+size_t SkipString(std::string_view text, size_t pos) noexcept {
+  for (++pos; pos < text.size(); ++pos) {
+    if (text[pos] == '\\') {
+      ++pos;
+    } else if (text[pos] == '"') {
+      return pos + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/**
+ * Position after the value at `pos`, or npos. Containers are skipped by bracket
+ * depth without recursion; the JSON came from JSON.stringify, so it's not
+ * validated beyond what splitting it needs.
+ */
+size_t SkipValue(std::string_view text, size_t pos) noexcept {
+  if (pos >= text.size()) return std::string_view::npos;
+  char c = text[pos];
+  if (c == '"') return SkipString(text, pos);
+  if (!IsContainer(c)) {
+    size_t end = pos;
+    while (end < text.size() && !IsSpace(text[end]) && !std::strchr(",:]}", text[end])) ++end;
+    return end > pos ? end : std::string_view::npos;
+  }
+  size_t depth = 0;
+  while (pos < text.size()) {
+    c = text[pos];
+    if (c == '"') {
+      pos = SkipString(text, pos);
+      if (pos == std::string_view::npos) return pos;
+      continue;
+    }
+    if (IsContainer(c)) {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0) return pos + 1;
+    }
+    ++pos;
+  }
+  return std::string_view::npos;
+}
+
+} // namespace
+
+struct SnapshotStore::Member {
+  std::string_view key;   // Raw, between the quotes; empty for array elements
+  std::string_view value; // Inline JSON; empty when the value is a node
+  NodeId node = kNoNode;
+};
+
+/**
+ * One pass over a snapshot's JSON. Containers that close at least minNodeSize
+ * bytes after they open are interned; their text leaves a hole in the parent.
+ */
+class SnapshotStore::Builder {
+ public:
+  Builder(SnapshotStore &store, std::string_view text) : m_store(store), m_text(text) {}
+
+  ~Builder() {
+    // Nodes not yet owned by a parent, after a parse error
+    for (const auto &child : m_children) m_store.Release(child.node);
+  }
+
+  bool Root(NodeId &root) {
+    size_t begin = 0;
+    size_t end = 0;
+    root = kNoNode;
+    if (!Value(0, true, begin, end, root)) return false;
+    if (SkipSpace(m_text, m_pos) != m_text.size()) {
+      m_store.Release(root);
+      root = kNoNode;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  struct Child {
+    size_t begin;
+    size_t end;
+    NodeId node;
+  };
+
+  bool Value(size_t depth, bool forceNode, size_t &begin, size_t &end, NodeId &node) {
+    m_pos = SkipSpace(m_text, m_pos);
+    if (m_pos >= m_text.size()) return false;
+    begin = m_pos;
+    node = kNoNode;
+    if (IsContainer(m_text[m_pos]) && depth < kMaxDepth) return Container(depth, forceNode, begin, end, node);
+
+    size_t after = SkipValue(m_text, m_pos);
+    if (after == std::string_view::npos) return false;
+    m_pos = end = after;
+    if (forceNode) node = MakeNode(begin, end, m_children.size());
+    return true;
+  }
+
+  bool Container(size_t depth, bool forceNode, size_t begin, size_t &end, NodeId &node) {
+    bool isArray = m_text[m_pos] == '[';
+    char close = isArray ? ']' : '}';
+    size_t firstChild = m_children.size();
+    m_pos = SkipSpace(m_text, m_pos + 1);
+    if (m_pos < m_text.size() && m_text[m_pos] == close) {
+      ++m_pos;
+    } else {
+      for (;;) {
+        if (!isArray) {
+          m_pos = SkipSpace(m_text, m_pos);
+          if (m_pos >= m_text.size() || m_text[m_pos] != '"') return false;
+          m_pos = SkipSpace(m_text, SkipString(m_text, m_pos));
+          if (m_pos >= m_text.size() || m_text[m_pos] != ':') return false;
+          ++m_pos;
+        }
+        size_t childBegin = 0;
+        size_t childEnd = 0;
+        NodeId child = kNoNode;
+        if (!Value(depth + 1, false, childBegin, childEnd, child)) return false;
+        if (child != kNoNode) m_children.push_back({childBegin, childEnd, child});
+
+        m_pos = SkipSpace(m_text, m_pos);
+        if (m_pos >= m_text.size()) return false;
+        char c = m_text[m_pos++];
+        if (c == close) break;
+        if (c != ',') return false;
+      }
+    }
+    end = m_pos;
+
+    // A small container only has smaller children, none of them interned
+    if (!forceNode && end - begin < m_store.m_minNodeSize) return true;
+    node = MakeNode(begin, end, firstChild);
+    return true;
+  }
+
+  NodeId MakeNode(size_t begin, size_t end, size_t firstChild) {
+    std::string fragment;
+    std::vector<Hole> holes;
+    std::string childHashes;
+    size_t cursor = begin;
+    for (size_t i = firstChild; i < m_children.size(); ++i) {
+      const Child &child = m_children[i];
+      fragment.append(m_text, cursor, child.begin - cursor);
+      holes.push_back({static_cast<uint32_t>(fragment.size()), child.node});
+      cursor = child.end;
+
+      const Hash &hash = m_store.m_nodes[child.node].hash;
+      uint32_t offset = holes.back().offset;
+      childHashes.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+      childHashes.append(reinterpret_cast<const char *>(&hash.high), sizeof(hash.high));
+      childHashes.append(reinterpret_cast<const char *>(&hash.low), sizeof(hash.low));
+    }
+    fragment.append(m_text, cursor, end - cursor);
+    m_children.resize(firstChild);
+
+    // Merkle hash: the node's own text, then where its children go and what they are
+    Hash hash;
+    hash.high = HashBytes(childHashes, HashBytes(fragment, kHighSeed));
+    hash.low = HashBytes(childHashes, HashBytes(fragment, kLowSeed));
+    return m_store.Intern(hash, fragment, std::move(holes), end - begin);
+  }
+
+  SnapshotStore &m_store;
+  std::string_view m_text;
+  size_t m_pos = 0;
+  std::vector<Child> m_children; // Interned, waiting for their parent to close
+};
+
+SnapshotStore::SnapshotStore(uint64_t maxBytes, size_t minNodeSize)
+    : m_maxBytes(maxBytes), m_minNodeSize(std::max<size_t>(minNodeSize, 16)) {}
+
+SnapshotStore::NodeId SnapshotStore::Intern(Hash hash, std::string_view fragment, std::vector<Hole> &&holes,
+                                            size_t size) {
+  auto it = m_index.find(hash);
+  if (it != m_index.end()) {
+    // The stored node already holds its children; drop the references taken while building this copy
+    for (const Hole &hole : holes) m_nodes[hole.node].refs--;
+    m_nodes[it->second].refs++;
+    return it->second;
+  }
+
+  std::vector<PieceId> pieces;
+  while (!fragment.empty()) {
+    size_t length = PieceLength(fragment);
+    pieces.push_back(InternPiece(fragment.substr(0, length)));
+    fragment.remove_prefix(length);
+  }
+
+  NodeId id;
+  if (!m_freeNodes.empty()) {
+    id = m_freeNodes.back();
+    m_freeNodes.pop_back();
+  } else {
+    id = static_cast<NodeId>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+  Node &node = m_nodes[id];
+  node.hash = hash;
+  node.pieces = std::move(pieces);
+  node.holes = std::move(holes);
+  node.size = size;
+  node.refs = 1;
+  m_storedBytes += node.pieces.size() * sizeof(PieceId) + node.holes.size() * sizeof(Hole) + kNodeOverhead;
+  m_index.emplace(hash, id);
+  return id;
+}
+
+SnapshotStore::PieceId SnapshotStore::InternPiece(std::string_view text) {
+  Hash hash;
+  hash.high = HashBytes(text, kHighSeed);
+  hash.low = HashBytes(text, kLowSeed);
+  auto it = m_pieceIndex.find(hash);
+  if (it != m_pieceIndex.end()) {
+    m_pieces[it->second].refs++;
+    return it->second;
+  }
+
+  PieceId id;
+  if (!m_freePieces.empty()) {
+    id = m_freePieces.back();
+    m_freePieces.pop_back();
+  } else {
+    id = static_cast<PieceId>(m_pieces.size());
+    m_pieces.emplace_back();
+  }
+  Piece &piece = m_pieces[id];
+  piece.hash = hash;
+  piece.text = text;
+  piece.refs = 1;
+  m_storedBytes += piece.text.size() + kPieceOverhead;
+  m_pieceIndex.emplace(hash, id);
+  return id;
+}
+
+void SnapshotStore::Release(NodeId root) {
+  if (root == kNoNode) return;
+  std::vector<NodeId> pending = {root};
+  while (!pending.empty()) {
+    NodeId id = pending.back();
+    pending.pop_back();
+    Node &node = m_nodes[id];
+    if (--node.refs > 0) continue;
+
+    for (const Hole &hole : node.holes) pending.push_back(hole.node);
+    for (PieceId pieceId : node.pieces) {
+      Piece &piece = m_pieces[pieceId];
+      if (--piece.refs > 0) continue;
+      m_storedBytes -= piece.text.size() + kPieceOverhead;
+      m_pieceIndex.erase(piece.hash);
+      std::string().swap(piece.text);
+      m_freePieces.push_back(pieceId);
+    }
+    m_storedBytes -= node.pieces.size() * sizeof(PieceId) + node.holes.size() * sizeof(Hole) + kNodeOverhead;
+    m_index.erase(node.hash);
+    std::vector<PieceId>().swap(node.pieces);
+    std::vector<Hole>().swap(node.holes);
+    m_freeNodes.push_back(id);
+  }
+}
+
+uint64_t SnapshotStore::Add(std::string_view clientId, std::string_view label, int64_t time, std::string_view json) {
+  NodeId root;
+  {
+    Builder builder(*this, json);
+    if (!builder.Root(root)) return 0;
+  }
+
+  Snapshot snapshot;
+  snapshot.info.id = m_nextId++;
+  snapshot.info.clientId = clientId;
+  snapshot.info.label = label;
+  snapshot.info.time = time;
+  snapshot.info.size = json.size();
+  snapshot.root = root;
+  uint64_t id = snapshot.info.id;
+  m_snapshots.emplace(id, std::move(snapshot));
+  m_logicalBytes += json.size();
+  Evict();
+  return id;
+}
+
+void SnapshotStore::Evict() {
+  if (m_storedBytes > m_maxBytes) Shrink(m_storedBytes - m_maxBytes);
+}
+
+uint64_t SnapshotStore::Shrink(uint64_t bytes) {
+  // Always keep the newest snapshot, however big
+  uint64_t before = m_storedBytes;
+  while (before - m_storedBytes < bytes && m_snapshots.size() > 1) Remove(m_snapshots.begin()->first);
+  return before - m_storedBytes;
+}
+
+bool SnapshotStore::Remove(uint64_t id) {
+  auto it = m_snapshots.find(id);
+  if (it == m_snapshots.end()) return false;
+  Release(it->second.root);
+  m_logicalBytes -= it->second.info.size;
+  m_snapshots.erase(it);
+  return true;
+}
+
+void SnapshotStore::Clear() {
+  m_nodes.clear();
+  m_freeNodes.clear();
+  m_index.clear();
+  m_pieces.clear();
+  m_freePieces.clear();
+  m_pieceIndex.clear();
+  m_snapshots.clear();
+  m_logicalBytes = 0;
+  m_storedBytes = 0;
+}
+
+void SnapshotStore::Fragment(const Node &node, std::string &out) const {
+  for (PieceId piece : node.pieces) out.append(m_pieces[piece].text);
+}
+
+void SnapshotStore::Materialize(NodeId id, std::string &out) const {
+  const Node &node = m_nodes[id];
+  if (node.holes.empty()) {
+    Fragment(node, out);
+    return;
+  }
+  std::string fragment;
+  Fragment(node, fragment);
+  size_t cursor = 0;
+  for (const Hole &hole : node.holes) {
+    out.append(fragment, cursor, hole.offset - cursor);
+    Materialize(hole.node, out);
+    cursor = hole.offset;
+  }
+  out.append(fragment, cursor, std::string::npos);
+}
+
+bool SnapshotStore::Materialize(uint64_t id, std::string &out) const {
+  auto it = m_snapshots.find(id);
+  if (it == m_snapshots.end()) return false;
+  out.clear();
+  out.reserve(m_nodes[it->second.root].size);
+  Materialize(it->second.root, out);
+  return true;
+}
+
+void SnapshotStore::ForEachMember(std::string_view text, const std::vector<Hole> &holes,
+                                  std::vector<Member> &members) {
+  members.clear();
+  size_t pos = SkipSpace(text, 0);
+  if (pos >= text.size() || !IsContainer(text[pos])) return;
+  bool isArray = text[pos] == '[';
+  char close = isArray ? ']' : '}';
+  size_t nextHole = 0;
+
+  pos = SkipSpace(text, pos + 1);
+  while (pos < text.size() && text[pos] != close) {
+    Member member;
+    if (!isArray) {
+      size_t keyEnd = SkipString(text, pos);
+      if (keyEnd == std::string_view::npos) return;
+      member.key = text.substr(pos + 1, keyEnd - pos - 2);
+      pos = SkipSpace(text, keyEnd) + 1; // ':'
+    }
+    pos = SkipSpace(text, pos);
+    if (nextHole < holes.size() && holes[nextHole].offset == pos) {
+      member.node = holes[nextHole++].node;
+    } else {
+      size_t valueEnd = SkipValue(text, pos);
+      if (valueEnd == std::string_view::npos) return;
+      member.value = text.substr(pos, valueEnd - pos);
+      pos = valueEnd;
+    }
+    members.push_back(member);
+    pos = SkipSpace(text, pos);
+    if (pos < text.size() && text[pos] == ',') pos = SkipSpace(text, pos + 1);
+  }
+}
+
+void SnapshotStore::AddChange(const std::string &path, SnapshotChangeKind kind, std::string_view inlineValue,
+                              NodeId node, std::vector<SnapshotChange> &out) const {
+  SnapshotChange change;
+  change.path = path;
+  change.kind = kind;
+  if (kind != SnapshotChangeKind::Removed) {
+    change.valueSize = node != kNoNode ? m_nodes[node].size : inlineValue.size();
+    if (change.valueSize > kMaxChangeValueSize) {
+      change.truncated = true;
+    } else if (node != kNoNode) {
+      Materialize(node, change.value);
+    } else {
+      change.value = inlineValue;
+    }
+  }
+  out.push_back(std::move(change));
+}
+
+void SnapshotStore::DiffNodes(NodeId from, NodeId to, std::string &path, std::vector<SnapshotChange> &out) const {
+  if (from == to) return;
+  std::string fromText;
+  std::string toText;
+  Fragment(m_nodes[from], fromText);
+  Fragment(m_nodes[to], toText);
+  size_t fromStart = SkipSpace(fromText, 0);
+  size_t toStart = SkipSpace(toText, 0);
+  char kind = toStart < toText.size() ? toText[toStart] : 0;
+  if (!IsContainer(kind) || fromStart >= fromText.size() || fromText[fromStart] != kind) {
+    AddChange(path, SnapshotChangeKind::Changed, {}, to, out);
+    return;
+  }
+
+  std::vector<Member> before;
+  std::vector<Member> after;
+  ForEachMember(fromText, m_nodes[from].holes, before);
+  ForEachMember(toText, m_nodes[to].holes, after);
+  size_t base = path.size();
+
+  auto compare = [&](const Member &a, const Member &b) {
+    if (a.node != kNoNode && b.node != kNoNode) {
+      DiffNodes(a.node, b.node, path, out);
+    } else if (a.node != kNoNode || b.node != kNoNode || a.value != b.value) {
+      AddChange(path, SnapshotChangeKind::Changed, b.value, b.node, out);
+    }
+  };
+
+  if (kind == '[') {
+    for (size_t i = 0; i < std::max(before.size(), after.size()); ++i) {
+      path.append("[").append(std::to_string(i)).append("]");
+      if (i >= before.size()) {
+        AddChange(path, SnapshotChangeKind::Added, after[i].value, after[i].node, out);
+      } else if (i >= after.size()) {
+        AddChange(path, SnapshotChangeKind::Removed, {}, kNoNode, out);
+      } else {
+        compare(before[i], after[i]);
+      }
+      path.resize(base);
+    }
+    return;
+  }
+
+  std::unordered_map<std::string_view, size_t> beforeKeys;
+  for (size_t i = 0; i < before.size(); ++i) beforeKeys.emplace(before[i].key, i);
+  std::vector<bool> matched(before.size(), false);
+  auto appendKey = [&](std::string_view key) {
+    if (base > 0) path.push_back('.');
+    path.append(key);
+  };
+
+  for (const Member &member : after) {
+    appendKey(member.key);
+    auto it = beforeKeys.find(member.key);
+    if (it == beforeKeys.end()) {
+      AddChange(path, SnapshotChangeKind::Added, member.value, member.node, out);
+    } else {
+      matched[it->second] = true;
+      compare(before[it->second], member);
+    }
+    path.resize(base);
+  }
+  for (size_t i = 0; i < before.size(); ++i) {
+    if (matched[i]) continue;
+    appendKey(before[i].key);
+    AddChange(path, SnapshotChangeKind::Removed, {}, kNoNode, out);
+    path.resize(base);
+  }
+}
+
+bool SnapshotStore::Diff(uint64_t from, uint64_t to, std::vector<SnapshotChange> &out) const {
+  auto fromIt = m_snapshots.find(from);
+  auto toIt = m_snapshots.find(to);
+  if (fromIt == m_snapshots.end() || toIt == m_snapshots.end()) return false;
+  out.clear();
+  std::string path;
+  DiffNodes(fromIt->second.root, toIt->second.root, path, out);
+  return true;
+}
+
+std::vector<SnapshotInfo> SnapshotStore::Snapshots(std::string_view clientId) const {
+  std::vector<SnapshotInfo> snapshots;
+  for (const auto &[id, snapshot] : m_snapshots) {
+    if (clientId.empty() || snapshot.info.clientId == clientId) snapshots.push_back(snapshot.info);
+  }
+  return snapshots;
+}
+
+SnapshotStoreStats SnapshotStore::Stats() const noexcept {
+  SnapshotStoreStats stats;
+  stats.snapshots = m_snapshots.size();
+  stats.nodes = m_index.size();
+  stats.pieces = m_pieceIndex.size();
+  stats.logicalBytes = m_logicalBytes;
+  stats.storedBytes = m_storedBytes;
+  if (!m_snapshots.empty()) stats.oldestTime = m_snapshots.begin()->second.info.time;
+  return stats;
+}
+
+} // namespace reactotron
@@ -0,0 +1,158 @@
+#pragma once
+
+//
+//  StateSnapshots.h
+//  Reactotron
+//
+//  Content-addressed history of app state, for time travel and restore. Each
+//  snapshot's JSON is split into a Merkle tree: every object or array of at
+//  least `minNodeSize` bytes becomes a node holding its own text with the large
+//  children cut out, addressed by a hash of that text and its children's
+//  hashes. Identical subtrees are stored once, so consecutive snapshots share
+//  everything the action didn't touch. Large fragments (a normalized map of
+//  thousands of small entities) are further cut into content-defined pieces,
+//  so one changed entity doesn't store its siblings again.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct SnapshotInfo {
+  uint64_t id = 0;
+  std::string clientId;
+  std::string label; // Usually the action that led to the state
+  int64_t time = 0;
+  size_t size = 0; // Of the snapshot's JSON
+};
+
+enum class SnapshotChangeKind { Added, Removed, Changed };
+
+struct SnapshotChange {
+  std::string path; // "todos[3].done"; keys keep their JSON escapes
+  SnapshotChangeKind kind = SnapshotChangeKind::Changed;
+  std::string value; // New JSON value, empty if removed or truncated
+  size_t valueSize = 0;
+  bool truncated = false; // Value larger than kMaxChangeValueSize
+};
+
+struct SnapshotStoreStats {
+  size_t snapshots = 0;
+  size_t nodes = 0;
+  size_t pieces = 0;
+  uint64_t logicalBytes = 0; // Sum of the snapshots' JSON sizes
+  uint64_t storedBytes = 0;  // Node text plus bookkeeping
+  int64_t oldestTime = 0;    // Of the oldest snapshot, 0 if there are none
+};
+
+/**
+ * The store. Add() scans the JSON once, hashing each node as it closes; nodes
+ * already in the store are only referenced again. Materialize() splices the
+ * stored fragments back together. Diff() only descends into children whose
+ * hashes differ, so comparing neighbouring snapshots costs O(changed nodes).
+ *
+ * Snapshots are reference counted down to the node; when the stored bytes
+ * exceed `maxBytes` the oldest snapshots are dropped.
+ *
+ * Not thread-safe.
+ */
+class SnapshotStore {
+ public:
+  static constexpr size_t kMaxDepth = 256; // Deeper containers stay inline in their ancestor
+  static constexpr size_t kMaxChangeValueSize = 64 * 1024;
+
+  explicit SnapshotStore(uint64_t maxBytes = 256ull << 20, size_t minNodeSize = 256);
+  SnapshotStore(const SnapshotStore &) = delete;
+  SnapshotStore &operator=(const SnapshotStore &) = delete;
+
+  /** Stores a snapshot and returns its id, or 0 if `json` is malformed. */
+  uint64_t Add(std::string_view clientId, std::string_view label, int64_t time, std::string_view json);
+
+  bool Materialize(uint64_t id, std::string &out) const;
+  /** Changes that turn snapshot `from` into `to`. False if either is unknown. */
+  bool Diff(uint64_t from, uint64_t to, std::vector<SnapshotChange> &out) const;
+
+  /** Snapshots of `clientId` (all clients if empty), oldest first. */
+  std::vector<SnapshotInfo> Snapshots(std::string_view clientId) const;
+  bool Remove(uint64_t id);
+  /** Drops the oldest snapshots, but never the newest, until about `bytes` are freed; returns how many were. */
+  uint64_t Shrink(uint64_t bytes);
+  void Clear();
+
+  SnapshotStoreStats Stats() const noexcept;
+
+ private:
+  using NodeId = uint32_t;
+  static constexpr NodeId kNoNode = UINT32_MAX;
+
+  struct Hash {
+    uint64_t high = 0;
+    uint64_t low = 0;
+    bool operator==(const Hash &other) const noexcept { return high == other.high && low == other.low; }
+  };
+
+  struct HashHasher {
+    size_t operator()(const Hash &hash) const noexcept { return static_cast<size_t>(hash.low); }
+  };
+
+  struct Hole {
+    uint32_t offset = 0; // In the parent's fragment
+    NodeId node = kNoNode;
+  };
+
+  using PieceId = uint32_t;
+
+  struct Piece {
+    Hash hash;
+    std::string text;
+    uint32_t refs = 0;
+  };
+
+  struct Node {
+    Hash hash;
+    std::vector<PieceId> pieces; // Own JSON with the large children cut out
+    std::vector<Hole> holes;
+    size_t size = 0; // Materialized size
+    uint32_t refs = 0;
+  };
+
+  struct Snapshot {
+    SnapshotInfo info;
+    NodeId root = kNoNode;
+  };
+
+  class Builder;
+  struct Member;
+
+  NodeId Intern(Hash hash, std::string_view fragment, std::vector<Hole> &&holes, size_t size);
+  PieceId InternPiece(std::string_view text);
+  void Release(NodeId node);
+  void Fragment(const Node &node, std::string &out) const;
+  void Materialize(NodeId node, std::string &out) const;
+  static void ForEachMember(std::string_view fragment, const std::vector<Hole> &holes, std::vector<Member> &members);
+  void DiffNodes(NodeId from, NodeId to, std::string &path, std::vector<SnapshotChange> &out) const;
+  void AddChange(const std::string &path, SnapshotChangeKind kind, std::string_view inlineValue, NodeId node,
+                 std::vector<SnapshotChange> &out) const;
+  void Evict();
+
+  uint64_t m_maxBytes;
+  size_t m_minNodeSize;
+  std::vector<Node> m_nodes;
+  std::vector<NodeId> m_freeNodes;
+  std::unordered_map<Hash, NodeId, HashHasher> m_index;
+  std::vector<Piece> m_pieces;
+  std::vector<PieceId> m_freePieces;
+  std::unordered_map<Hash, PieceId, HashHasher> m_pieceIndex;
+  std::map<uint64_t, Snapshot> m_snapshots; // By id, so oldest first
+  uint64_t m_nextId = 1;
+  uint64_t m_logicalBytes = 0;
+  uint64_t m_storedBytes = 0;
+};
+
+} // namespace reactotron
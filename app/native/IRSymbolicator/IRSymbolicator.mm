@@ -0,0 +1,165 @@
+//
+//  IRSymbolicator.mm
+//  Reactotron-macOS
+//
+//  Error stack frames mapped back to their sources by the shared
+//  Symbolicator. Maps are downloaded from Metro and their tables cached under
+//  Caches/<bundle id>/SourceMaps; batches run on the TaskExecutor.
+//
+
+#import <Cocoa/Cocoa.h>
+#import "IRSymbolicator.h"
+#include "Symbolicator.h"
+#include <string>
+#include <vector>
+
+@implementation IRSymbolicator
+
+RCT_EXPORT_MODULE()
+
+static NSString *IRSymbolicatorNSString(const std::string &string) {
+  return [[NSString alloc] initWithBytes:string.data() length:string.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+static std::string IRSymbolicatorString(id value) {
+  if (![value isKindOfClass:[NSString class]]) return std::string();
+  const char *utf8 = [(NSString *)value UTF8String];
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+static uint32_t IRSymbolicatorNumber(NSArray *numbers, NSUInteger index) {
+  id number = index < numbers.count ? numbers[index] : nil;
+  if (![number isKindOfClass:[NSNumber class]]) return 0;
+  double value = [(NSNumber *)number doubleValue];
+  return value > 0 && value < UINT32_MAX ? static_cast<uint32_t>(value) : 0;
+}
+
+// Runs on a TaskExecutor worker, which waits for the download
+static bool IRSymbolicatorFetch(const std::string &url, const std::string &path,
+                                reactotron::Symbolicator::MapDownload &download) {
+  NSURL *source = [NSURL URLWithString:IRSymbolicatorNSString(url)];
+  if (!source) {
+    download.error = "Invalid source map URL " + url;
+    return false;
+  }
+  NSURL *destination = [NSURL fileURLWithFileSystemRepresentation:path.c_str() isDirectory:NO relativeToURL:nil];
+  NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:source];
+  // Ask for the map only if it changed, since Fast Refresh was the last time
+  if (!download.etag.empty()) {
+    [request setValue:IRSymbolicatorNSString(download.etag) forHTTPHeaderField:@"If-None-Match"];
+  }
+  request.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+  __block bool fetched = false;
+  __block bool notModified = false;
+  __block std::string etag;
+  __block std::string failure;
+  dispatch_semaphore_t done = dispatch_semaphore_create(0);
+  NSURLSessionDownloadTask *task = [[NSURLSession sharedSession]
+      downloadTaskWithRequest:request
+            completionHandler:^(NSURL *location, NSURLResponse *response, NSError *downloadError) {
+              NSHTTPURLResponse *http =
+                  [response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *)response : nil;
+              NSInteger status = http ? http.statusCode : 200;
+              if (downloadError) {
+                failure = IRSymbolicatorString(downloadError.localizedDescription);
+              } else if (status == 304) {
+                fetched = notModified = true;
+              } else if (!location) {
+                failure = "Couldn't download " + url;
+              } else if (status != 200) {
+                failure = "Metro answered " + std::to_string(status) + " for " + url;
+              } else {
+                // The download is removed once this returns, so it's moved now
+                NSFileManager *files = [NSFileManager defaultManager];
+                [files removeItemAtURL:destination error:nil];
+                NSError *moveError = nil;
+                fetched = [files moveItemAtURL:location toURL:destination error:&moveError];
+                if (!fetched) failure = IRSymbolicatorString(moveError.localizedDescription);
+                NSString *header = [http valueForHTTPHeaderField:@"ETag"];
+                if (header) etag = IRSymbolicatorString(header);
+              }
+              dispatch_semaphore_signal(done);
+            }];
+  [task resume];
+  dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+  if (!fetched) {
+    download.error = failure.empty() ? "Couldn't download " + url : failure;
+    return false;
+  }
+  download.notModified = notModified;
+  if (!notModified) download.etag = etag;
+  return true;
+}
+
+static void IRSymbolicatorSetUp() {
+  static dispatch_once_t once;
+  dispatch_once(&once, ^{
+    auto &symbolicator = reactotron::Symbolicator::Shared();
+    NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+    NSString *bundleId = [NSBundle mainBundle].bundleIdentifier ?: @"com.reactotron";
+    const char *path = [[caches URLByAppendingPathComponent:bundleId] URLByAppendingPathComponent:@"SourceMaps"]
+                           .fileSystemRepresentation;
+    if (caches && path) symbolicator.SetCacheDirectory(path);
+    symbolicator.SetMapFetcher(IRSymbolicatorFetch);
+  });
+}
+
+- (void)symbolicate:(NSArray *)files
+              lines:(NSArray *)lines
+            columns:(NSArray *)columns
+            resolve:(nonnull RCTPromiseResolveBlock)resolve
+             reject:(nonnull RCTPromiseRejectBlock)reject {
+  IRSymbolicatorSetUp();
+  std::vector<reactotron::StackFrameLocation> frames(files.count);
+  for (NSUInteger i = 0; i < files.count; ++i) {
+    frames[i].file = IRSymbolicatorString(files[i]);
+    frames[i].line = IRSymbolicatorNumber(lines, i);
+    frames[i].column = IRSymbolicatorNumber(columns, i);
+  }
+  reactotron::Symbolicator::Shared().SymbolicateAsync(
+      std::move(frames), [resolve](std::vector<reactotron::SymbolicatedFrame> symbolicated) {
+        NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:symbolicated.size()];
+        for (const auto &frame : symbolicated) {
+          [result addObject:@{
+            @"resolved": @(frame.resolved),
+            @"fileName": IRSymbolicatorNSString(frame.file),
+            @"lineNumber": @(frame.line),
+            @"columnNumber": @(frame.column),
+            @"error": IRSymbolicatorNSString(frame.error),
+          }];
+        }
+        resolve(result);
+      });
+}
+
+- (void)registerSourceMap:(NSString *)bundle path:(NSString *)path {
+  IRSymbolicatorSetUp();
+  reactotron::Symbolicator::Shared().RegisterMap(IRSymbolicatorString(bundle), IRSymbolicatorString(path));
+}
+
+- (void)invalidateSourceMaps {
+  reactotron::Symbolicator::Shared().Invalidate();
+}
+
+- (NSDictionary *)getStats {
+  reactotron::SymbolicatorStats stats = reactotron::Symbolicator::Shared().Stats();
+  return @{
+    @"maps": @(stats.maps),
+    @"tableBytes": @(stats.tableBytes),
+    @"cacheHits": @(stats.cacheHits),
+    @"parses": @(stats.parses),
+    @"loadFailures": @(stats.loadFailures),
+    @"batches": @(stats.batches),
+    @"frames": @(stats.frames),
+    @"resolved": @(stats.resolved),
+    @"lastLoadMs": @(stats.lastLoadMs),
+    @"lastParseMs": @(stats.lastParseMs),
+    @"lookupNs": @(stats.lookupNs),
+  };
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRSymbolicatorSpecJSI>(params);
+}
+
+@end
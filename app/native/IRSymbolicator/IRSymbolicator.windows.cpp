@@ -0,0 +1,127 @@
+//
+//  IRSymbolicator.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared Symbolicator. Maps are
+//  downloaded from Metro with URLMon and their tables cached under
+//  %LOCALAPPDATA%\Reactotron\SourceMaps
+//
+
+#include "pch.h"
+#include "IRSymbolicator.windows.h"
+#include "../TextTranscoding/TextTranscoding.h"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <urlmon.h>
+#include <wininet.h>
+
+#if defined(_MSC_VER)
+#pragma comment(lib, "urlmon.lib")
+#pragma comment(lib, "wininet.lib")
+#endif
+
+namespace winrt::reactotron::implementation
+{
+    namespace
+    {
+        std::wstring Wide(std::string const &utf8)
+        {
+            std::u16string utf16 = ::reactotron::Utf8ToUtf16(utf8);
+            return std::wstring(reinterpret_cast<const wchar_t *>(utf16.c_str()), utf16.size());
+        }
+
+        // Runs on a TaskExecutor worker, which waits for the download. URLMon can't send
+        // If-None-Match, so the map is always downloaded and the Symbolicator compares its
+        // content; the cached copy is dropped first so a Fast Refresh isn't answered from it
+        bool Fetch(std::string const &url, std::string const &path, ::reactotron::Symbolicator::MapDownload &download)
+        {
+            std::wstring wideUrl = Wide(url);
+            DeleteUrlCacheEntryW(wideUrl.c_str());
+            HRESULT result = URLDownloadToFileW(nullptr, wideUrl.c_str(), Wide(path).c_str(), 0, nullptr);
+            if (FAILED(result))
+            {
+                char code[16];
+                snprintf(code, sizeof(code), "0x%08lX", static_cast<unsigned long>(result));
+                download.error = "Couldn't download " + url + " (" + code + ")";
+                return false;
+            }
+            download.etag.clear();
+            return true;
+        }
+
+        uint32_t Position(std::vector<double> const &numbers, size_t index)
+        {
+            double value = index < numbers.size() ? numbers[index] : 0;
+            return value > 0 && value < UINT32_MAX ? static_cast<uint32_t>(value) : 0;
+        }
+    }
+
+    IRSymbolicator::IRSymbolicator() noexcept
+    {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            auto &symbolicator = ::reactotron::Symbolicator::Shared();
+            if (const wchar_t *localAppData = _wgetenv(L"LOCALAPPDATA"))
+            {
+                std::wstring path = std::wstring(localAppData) + L"\\Reactotron\\SourceMaps";
+                symbolicator.SetCacheDirectory(::reactotron::Utf16ToUtf8(std::u16string(reinterpret_cast<const char16_t *>(path.c_str()), path.size())));
+            }
+            symbolicator.SetMapFetcher(Fetch);
+        });
+    }
+
+    void IRSymbolicator::symbolicate(std::vector<std::string> files, std::vector<double> lines, std::vector<double> columns,
+                                     Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept
+    {
+        std::vector<::reactotron::StackFrameLocation> frames(files.size());
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            frames[i].file = std::move(files[i]);
+            frames[i].line = Position(lines, i);
+            frames[i].column = Position(columns, i);
+        }
+        ::reactotron::Symbolicator::Shared().SymbolicateAsync(std::move(frames), [promise](std::vector<::reactotron::SymbolicatedFrame> symbolicated) {
+            Microsoft::ReactNative::JSValueArray result;
+            for (auto const &frame : symbolicated)
+            {
+                Microsoft::ReactNative::JSValueObject item;
+                item["resolved"] = frame.resolved;
+                item["fileName"] = frame.file;
+                item["lineNumber"] = static_cast<double>(frame.line);
+                item["columnNumber"] = static_cast<double>(frame.column);
+                item["error"] = frame.error;
+                result.push_back(std::move(item));
+            }
+            promise.Resolve(Microsoft::ReactNative::JSValue(std::move(result)));
+        });
+    }
+
+    void IRSymbolicator::registerSourceMap(std::string bundle, std::string path) noexcept
+    {
+        ::reactotron::Symbolicator::Shared().RegisterMap(bundle, std::move(path));
+    }
+
+    void IRSymbolicator::invalidateSourceMaps() noexcept
+    {
+        ::reactotron::Symbolicator::Shared().Invalidate();
+    }
+
+    Microsoft::ReactNative::JSValue IRSymbolicator::getStats() noexcept
+    {
+        ::reactotron::SymbolicatorStats stats = ::reactotron::Symbolicator::Shared().Stats();
+        Microsoft::ReactNative::JSValueObject result;
+        result["maps"] = static_cast<double>(stats.maps);
+        result["tableBytes"] = static_cast<double>(stats.tableBytes);
+        result["cacheHits"] = static_cast<double>(stats.cacheHits);
+        result["parses"] = static_cast<double>(stats.parses);
+        result["loadFailures"] = static_cast<double>(stats.loadFailures);
+        result["batches"] = static_cast<double>(stats.batches);
+        result["frames"] = static_cast<double>(stats.frames);
+        result["resolved"] = static_cast<double>(stats.resolved);
+        result["lastLoadMs"] = stats.lastLoadMs;
+        result["lastParseMs"] = stats.lastParseMs;
+        result["lookupNs"] = stats.lookupNs;
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
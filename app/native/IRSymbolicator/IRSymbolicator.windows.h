@@ -0,0 +1,27 @@
+#pragma once
+#include "NativeModules.h"
+#include "Symbolicator.h"
+#include <string>
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRSymbolicator)
+    struct IRSymbolicator
+    {
+        IRSymbolicator() noexcept;
+
+        REACT_METHOD(symbolicate)
+        void symbolicate(std::vector<std::string> files, std::vector<double> lines, std::vector<double> columns,
+                         Microsoft::ReactNative::ReactPromise<Microsoft::ReactNative::JSValue> const &promise) noexcept;
+
+        REACT_METHOD(registerSourceMap)
+        void registerSourceMap(std::string bundle, std::string path) noexcept;
+
+        REACT_METHOD(invalidateSourceMaps)
+        void invalidateSourceMaps() noexcept;
+
+        REACT_SYNC_METHOD(getStats)
+        Microsoft::ReactNative::JSValue getStats() noexcept;
+    };
+}
@@ -0,0 +1,50 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface SymbolicatedFrame {
+  /** False if the frame's bundle has no map, or the map has nothing at that position. */
+  resolved: boolean
+  /** The original source, if resolved. */
+  fileName: string
+  lineNumber: number
+  columnNumber: number
+  /** Why the bundle's map couldn't be loaded, or "". */
+  error: string
+}
+
+export interface SymbolicatorStats {
+  /** Maps loaded since the last invalidateSourceMaps(). */
+  maps: number
+  tableBytes: number
+  /** Tables opened from the on-disk cache instead of parsing the map. */
+  cacheHits: number
+  parses: number
+  loadFailures: number
+  batches: number
+  frames: number
+  resolved: number
+  lastLoadMs: number
+  lastParseMs: number
+  /** Per frame, over the last batch. */
+  lookupNs: number
+}
+
+export interface Spec extends TurboModule {
+  /**
+   * Maps frames back to their sources off the JS thread, loading each bundle's source map from
+   * Metro the first time. The arrays are parallel, one entry per frame: bundle URL or path,
+   * 1-based line and 0-based column. Resolves with a frame for each, in order.
+   */
+  symbolicate(
+    files: ReadonlyArray<string>,
+    lines: ReadonlyArray<number>,
+    columns: ReadonlyArray<number>,
+  ): Promise<SymbolicatedFrame[]>
+  /** Uses the map at `path` for `bundle` instead of asking Metro. */
+  registerSourceMap(bundle: string, path: string): void
+  /** Forgets loaded maps, as when the app reloads with a new bundle. */
+  invalidateSourceMaps(): void
+  getStats(): SymbolicatorStats
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRSymbolicator")
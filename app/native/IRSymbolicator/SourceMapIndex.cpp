@@ -0,0 +1,705 @@
+//
+//  SourceMapIndex.cpp
+//  Reactotron
+//
+
+#include "SourceMapIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint32_t kMagic = 0x4D535249; // "IRSM"
+constexpr size_t kHeaderSize = 32;
+constexpr int kMaxJsonDepth = 64;
+
+fs::path PathFromUtf8(const std::string &path) { return fs::path(std::u8string(path.begin(), path.end())); }
+
+uint32_t ReadU32(const uint8_t *data) noexcept {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t ReadU64(const uint8_t *data) noexcept {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void Append(std::vector<uint8_t> &out, const T *values, size_t count) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(values);
+  out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+// XXH64
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t Rotl(uint64_t value, int bits) noexcept { return (value << bits) | (value >> (64 - bits)); }
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input) noexcept {
+  accumulator += input * kPrime2;
+  return Rotl(accumulator, 31) * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t accumulator, uint64_t value) noexcept {
+  accumulator ^= Round(0, value);
+  return accumulator * kPrime1 + kPrime4;
+}
+
+/** Base64 digit values for VLQ; -1 for anything else. */
+struct Base64Table {
+  int8_t values[256];
+
+  constexpr Base64Table() : values() {
+    for (int i = 0; i < 256; ++i) values[i] = -1;
+    const char *digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (int i = 0; i < 64; ++i) values[static_cast<unsigned char>(digits[i])] = static_cast<int8_t>(i);
+  }
+};
+
+constexpr Base64Table kBase64;
+
+/**
+ * Just enough JSON for a source map's top level: strings are decoded where
+ * they're wanted and skipped with memchr where they aren't, which is what
+ * matters for a map whose bulk is "sourcesContent".
+ */
+class JsonReader {
+ public:
+  explicit JsonReader(std::string_view json) : m_at(json.data()), m_end(json.data() + json.size()) {}
+
+  bool Failed() const noexcept { return m_failed; }
+
+  void SkipSpace() noexcept {
+    while (m_at < m_end && (*m_at == ' ' || *m_at == '\n' || *m_at == '\r' || *m_at == '\t')) ++m_at;
+  }
+
+  /** Consumes `c` after any whitespace, if it's next. */
+  bool Take(char c) noexcept {
+    SkipSpace();
+    if (m_at < m_end && *m_at == c) {
+      ++m_at;
+      return true;
+    }
+    return false;
+  }
+
+  bool Peek(char c) noexcept {
+    SkipSpace();
+    return m_at < m_end && *m_at == c;
+  }
+
+  bool TakeLiteral(std::string_view literal) noexcept {
+    SkipSpace();
+    if (static_cast<size_t>(m_end - m_at) < literal.size() || std::string_view(m_at, literal.size()) != literal) {
+      return false;
+    }
+    m_at += literal.size();
+    return true;
+  }
+
+  /**
+   * A string's raw contents, between its quotes and still escaped, and
+   * whether it has escapes at all.
+   */
+  bool RawString(std::string_view &raw, bool &escaped) noexcept {
+    if (!Take('"')) return Fail();
+    const char *start = m_at;
+    escaped = false;
+    for (;;) {
+      const auto *quote = static_cast<const char *>(std::memchr(m_at, '"', static_cast<size_t>(m_end - m_at)));
+      if (!quote) return Fail();
+      // Escaped if an odd number of backslashes run up to it
+      const char *back = quote;
+      while (back > start && back[-1] == '\\') --back;
+      m_at = quote + 1;
+      if ((quote - back) % 2 == 0) {
+        escaped = escaped || std::memchr(start, '\\', static_cast<size_t>(quote - start)) != nullptr;
+        raw = std::string_view(start, static_cast<size_t>(quote - start));
+        return true;
+      }
+      escaped = true;
+    }
+  }
+
+  bool String(std::string &out) {
+    std::string_view raw;
+    bool escaped = false;
+    if (!RawString(raw, escaped)) return false;
+    if (!escaped) {
+      out.assign(raw);
+      return true;
+    }
+    return Unescape(raw, out) || Fail();
+  }
+
+  /** A string, or null as "". */
+  bool StringOrNull(std::string &out) {
+    if (TakeLiteral("null")) {
+      out.clear();
+      return true;
+    }
+    return String(out);
+  }
+
+  bool Number(double &value) noexcept {
+    SkipSpace();
+    const char *start = m_at;
+    while (m_at < m_end && (std::strchr("+-.0123456789eE", *m_at) != nullptr)) ++m_at;
+    if (m_at == start) return Fail();
+    value = std::strtod(std::string(start, m_at).c_str(), nullptr);
+    return true;
+  }
+
+  bool SkipValue(int depth = 0) {
+    if (depth > kMaxJsonDepth) return Fail();
+    SkipSpace();
+    if (m_at >= m_end) return Fail();
+    switch (*m_at) {
+      case '"': {
+        std::string_view raw;
+        bool escaped;
+        return RawString(raw, escaped);
+      }
+      case '{':
+        ++m_at;
+        if (Take('}')) return true;
+        do {
+          std::string_view key;
+          bool escaped;
+          if (!RawString(key, escaped) || !Take(':') || !SkipValue(depth + 1)) return Fail();
+        } while (Take(','));
+        return Take('}') || Fail();
+      case '[':
+        ++m_at;
+        if (Take(']')) return true;
+        do {
+          if (!SkipValue(depth + 1)) return Fail();
+        } while (Take(','));
+        return Take(']') || Fail();
+      case 't': return TakeLiteral("true") || Fail();
+      case 'f': return TakeLiteral("false") || Fail();
+      case 'n': return TakeLiteral("null") || Fail();
+      default: {
+        double ignored;
+        return Number(ignored);
+      }
+    }
+  }
+
+  bool AtEnd() noexcept {
+    SkipSpace();
+    return m_at == m_end;
+  }
+
+ private:
+  bool Fail() noexcept {
+    m_failed = true;
+    return false;
+  }
+
+  static int HexDigit(char c) noexcept {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  static bool Hex4(std::string_view text, size_t at, uint32_t &value) noexcept {
+    if (at + 4 > text.size()) return false;
+    value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      int digit = HexDigit(text[at + i]);
+      if (digit < 0) return false;
+      value = value << 4 | static_cast<uint32_t>(digit);
+    }
+    return true;
+  }
+
+  static void AppendUtf8(std::string &out, uint32_t code) {
+    if (code < 0x80) {
+      out += static_cast<char>(code);
+    } else if (code < 0x800) {
+      out += static_cast<char>(0xC0 | code >> 6);
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out += static_cast<char>(0xE0 | code >> 12);
+      out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | code >> 18);
+      out += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+      out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  static bool Unescape(std::string_view raw, std::string &out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+      char c = raw[i];
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (++i >= raw.size()) return false;
+      switch (raw[i]) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          uint32_t code;
+          if (!Hex4(raw, i + 1, code)) return false;
+          i += 4;
+          uint32_t low;
+          if (code >= 0xD800 && code < 0xDC00 && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u' &&
+              Hex4(raw, i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          } else if (code >= 0xD800 && code < 0xE000) {
+            code = 0xFFFD; // A lone surrogate
+          }
+          AppendUtf8(out, code);
+          break;
+        }
+        default: return false;
+      }
+    }
+    return true;
+  }
+
+  const char *m_at;
+  const char *m_end;
+  bool m_failed = false;
+};
+
+using Entry = SourceMapIndex::Entry;
+static_assert(sizeof(Entry) == 16, "The cache layout has 16-byte entries");
+
+/** Decodes "mappings" into entries and line starts; false on a malformed segment. */
+bool DecodeMappings(std::string_view mappings, uint32_t sourceCount, std::vector<Entry> &entries,
+                    std::vector<uint32_t> &lineStarts, std::string &error) {
+  // A segment is about 5-8 characters in the maps Metro writes
+  entries.reserve(mappings.size() / 6);
+  lineStarts.push_back(0);
+  int64_t column = 0;
+  int64_t source = 0;
+  int64_t originalLine = 0;
+  int64_t originalColumn = 0;
+  int64_t fields[5];
+
+  const char *at = mappings.data();
+  const char *end = at + mappings.size();
+  while (at < end) {
+    char c = *at;
+    if (c == ';') {
+      ++at;
+      column = 0;
+      if (entries.size() > std::numeric_limits<uint32_t>::max()) break;
+      lineStarts.push_back(static_cast<uint32_t>(entries.size()));
+      continue;
+    }
+    if (c == ',') {
+      ++at;
+      continue;
+    }
+
+    int count = 0;
+    while (at < end && *at != ',' && *at != ';') {
+      if (count == 5) {
+        error = "A mapping segment has more than 5 fields";
+        return false;
+      }
+      int64_t value = 0;
+      int shift = 0;
+      for (;;) {
+        if (at == end) {
+          error = "The mappings end partway through a value";
+          return false;
+        }
+        int digit = kBase64.values[static_cast<unsigned char>(*at++)];
+        if (digit < 0 || shift > 30) {
+          error = "The mappings have an invalid VLQ value";
+          return false;
+        }
+        value += static_cast<int64_t>(digit & 31) << shift;
+        shift += 5;
+        if (!(digit & 32)) break;
+      }
+      fields[count++] = value & 1 ? -(value >> 1) : value >> 1;
+    }
+
+    column += fields[0];
+    Entry entry{static_cast<uint32_t>(std::clamp<int64_t>(column, 0, UINT32_MAX)), SourceMapIndex::kNoSource, 0, 0};
+    if (count >= 4) {
+      source += fields[1];
+      originalLine += fields[2];
+      originalColumn += fields[3];
+      // Positions that can't be real are kept as unmapped, so they still end the entry before them
+      if (source >= 0 && source < sourceCount && originalLine >= 0 && originalLine < UINT32_MAX &&
+          originalColumn >= 0 && originalColumn < UINT32_MAX) {
+        entry.source = static_cast<uint32_t>(source);
+        entry.originalLine = static_cast<uint32_t>(originalLine);
+        entry.originalColumn = static_cast<uint32_t>(originalColumn);
+      }
+    } else if (count != 1) {
+      error = "A mapping segment has 2 or 3 fields";
+      return false;
+    }
+    entries.push_back(entry);
+  }
+  lineStarts.push_back(static_cast<uint32_t>(entries.size()));
+  if (entries.size() >= std::numeric_limits<uint32_t>::max()) {
+    error = "The map has too many mappings";
+    return false;
+  }
+
+  // Segments should already be in column order within a line; put right any that aren't
+  for (size_t line = 0; line + 1 < lineStarts.size(); ++line) {
+    auto first = entries.begin() + lineStarts[line];
+    auto last = entries.begin() + lineStarts[line + 1];
+    auto byColumn = [](const Entry &a, const Entry &b) { return a.column < b.column; };
+    if (!std::is_sorted(first, last, byColumn)) std::stable_sort(first, last, byColumn);
+  }
+  return true;
+}
+
+bool IsAbsoluteSource(std::string_view source) noexcept {
+  return !source.empty() && (source[0] == '/' || source.find("://") != std::string_view::npos ||
+                             (source.size() > 2 && source[1] == ':' && (source[2] == '\\' || source[2] == '/')));
+}
+
+} // namespace
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string &path) {
+  std::unique_ptr<MappedFile> file(new MappedFile());
+#if defined(_WIN32)
+  HANDLE handle = CreateFileW(PathFromUtf8(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) return nullptr;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) {
+    CloseHandle(handle);
+    return nullptr;
+  }
+  if (size.QuadPart > 0) {
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+      if (mapping) CloseHandle(mapping);
+      CloseHandle(handle);
+      return nullptr;
+    }
+    file->m_mapping = mapping;
+    file->m_data = static_cast<const uint8_t *>(view);
+    file->m_size = static_cast<size_t>(size.QuadPart);
+  }
+  CloseHandle(handle);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    return nullptr;
+  }
+  if (info.st_size > 0) {
+    void *data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      return nullptr;
+    }
+    file->m_data = static_cast<const uint8_t *>(data);
+    file->m_size = static_cast<size_t>(info.st_size);
+  }
+  ::close(fd);
+#endif
+  return file;
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+  if (m_data) UnmapViewOfFile(m_data);
+  if (m_mapping) CloseHandle(m_mapping);
+#else
+  if (m_data) ::munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+}
+
+uint64_t SourceMapKey(std::string_view bytes) noexcept {
+  const auto *at = reinterpret_cast<const uint8_t *>(bytes.data());
+  const uint8_t *end = at + bytes.size();
+  uint64_t hash;
+  if (bytes.size() >= 32) {
+    uint64_t v1 = kPrime1 + kPrime2;
+    uint64_t v2 = kPrime2;
+    uint64_t v3 = 0;
+    uint64_t v4 = 0 - kPrime1;
+    const uint8_t *limit = end - 32;
+    do {
+      v1 = Round(v1, ReadU64(at));
+      v2 = Round(v2, ReadU64(at + 8));
+      v3 = Round(v3, ReadU64(at + 16));
+      v4 = Round(v4, ReadU64(at + 24));
+      at += 32;
+    } while (at <= limit);
+    hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = kPrime5;
+  }
+  hash += static_cast<uint64_t>(bytes.size());
+  for (; at + 8 <= end; at += 8) hash = Rotl(hash ^ Round(0, ReadU64(at)), 27) * kPrime1 + kPrime4;
+  if (at + 4 <= end) {
+    hash = Rotl(hash ^ (static_cast<uint64_t>(ReadU32(at)) * kPrime1), 23) * kPrime2 + kPrime3;
+    at += 4;
+  }
+  for (; at < end; ++at) hash = Rotl(hash ^ (*at * kPrime5), 11) * kPrime1;
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+std::shared_ptr<SourceMapIndex> SourceMapIndex::Parse(std::string_view json, uint64_t key, std::string &error) {
+  JsonReader reader(json);
+  std::string sourceRoot;
+  std::vector<std::string> sources;
+  std::string_view rawMappings;
+  std::string mappings; // Only if the raw string had escapes
+  bool escapedMappings = false;
+  bool haveMappings = false;
+  double version = 0;
+
+  if (!reader.Take('{')) {
+    error = "The source map isn't a JSON object";
+    return nullptr;
+  }
+  bool closed = reader.Take('}');
+  if (!closed) {
+    do {
+      std::string name;
+      if (!reader.String(name) || !reader.Take(':')) break;
+      if (name == "version") {
+        reader.Number(version);
+      } else if (name == "sourceRoot") {
+        reader.StringOrNull(sourceRoot);
+      } else if (name == "sources") {
+        if (!reader.Take('[')) break;
+        if (!reader.Take(']')) {
+          do {
+            sources.emplace_back();
+            if (!reader.StringOrNull(sources.back())) break;
+          } while (reader.Take(','));
+          if (!reader.Take(']')) break;
+        }
+      } else if (name == "mappings") {
+        haveMappings = reader.RawString(rawMappings, escapedMappings);
+      } else if (name == "sections") {
+        error = "Indexed source maps (with \"sections\") aren't supported";
+        return nullptr;
+      } else {
+        reader.SkipValue();
+      }
+      if (reader.Failed()) break;
+    } while (reader.Take(','));
+    closed = !reader.Failed() && reader.Take('}');
+  }
+  if (!closed || !reader.AtEnd()) {
+    error = "The source map isn't valid JSON";
+    return nullptr;
+  }
+  if (version != 3) {
+    error = "Only version 3 source maps are supported";
+    return nullptr;
+  }
+  if (!haveMappings) {
+    error = "The source map has no mappings";
+    return nullptr;
+  }
+  if (sources.size() >= kNoSource) {
+    error = "The source map has too many sources";
+    return nullptr;
+  }
+  if (escapedMappings) {
+    // Mappings are base64 and separators, so an escape can only be a needless one
+    std::string quoted = std::string("\"").append(rawMappings).append("\"");
+    JsonReader unescape(quoted);
+    if (!unescape.String(mappings)) {
+      error = "The source map's mappings aren't a valid string";
+      return nullptr;
+    }
+    rawMappings = mappings;
+  }
+
+  std::vector<Entry> entries;
+  std::vector<uint32_t> lineStarts;
+  if (!DecodeMappings(rawMappings, static_cast<uint32_t>(sources.size()), entries, lineStarts, error)) return nullptr;
+
+  std::vector<uint32_t> sourceOffsets;
+  std::string strings;
+  sourceOffsets.reserve(sources.size() + 1);
+  for (const std::string &source : sources) {
+    sourceOffsets.push_back(static_cast<uint32_t>(strings.size()));
+    if (!sourceRoot.empty() && !source.empty() && !IsAbsoluteSource(source)) {
+      strings += sourceRoot;
+      if (sourceRoot.back() != '/') strings += '/';
+    }
+    strings += source;
+    if (strings.size() > std::numeric_limits<uint32_t>::max()) {
+      error = "The source map's source names are too long";
+      return nullptr;
+    }
+  }
+  sourceOffsets.push_back(static_cast<uint32_t>(strings.size()));
+
+  uint32_t header[8] = {
+      kMagic,
+      kCacheVersion,
+      static_cast<uint32_t>(key),
+      static_cast<uint32_t>(key >> 32),
+      static_cast<uint32_t>(lineStarts.size() - 1),
+      static_cast<uint32_t>(entries.size()),
+      static_cast<uint32_t>(sources.size()),
+      static_cast<uint32_t>(strings.size()),
+  };
+  std::shared_ptr<SourceMapIndex> index(new SourceMapIndex());
+  std::vector<uint8_t> &image = index->m_image;
+  image.reserve(kHeaderSize + lineStarts.size() * 4 + entries.size() * sizeof(Entry) + sourceOffsets.size() * 4 +
+                strings.size());
+  Append(image, header, 8);
+  Append(image, lineStarts.data(), lineStarts.size());
+  // Free each part as it's copied, so the peak is one table and one part
+  std::vector<uint32_t>().swap(lineStarts);
+  Append(image, entries.data(), entries.size());
+  std::vector<Entry>().swap(entries);
+  Append(image, sourceOffsets.data(), sourceOffsets.size());
+  Append(image, strings.data(), strings.size());
+  if (!index->Attach(image.data(), image.size(), key)) {
+    error = "The source map is too large";
+    return nullptr;
+  }
+  return index;
+}
+
+std::shared_ptr<SourceMapIndex> SourceMapIndex::Open(const std::string &path, uint64_t key) {
+  std::unique_ptr<MappedFile> file = MappedFile::Open(path);
+  if (!file) return nullptr;
+  std::shared_ptr<SourceMapIndex> index(new SourceMapIndex());
+  if (!index->Attach(file->Data(), file->Size(), key)) return nullptr;
+  index->m_file = std::move(file);
+  return index;
+}
+
+bool SourceMapIndex::Attach(const uint8_t *data, size_t size, uint64_t key) {
+  if (size < kHeaderSize || ReadU32(data) != kMagic || ReadU32(data + 4) != kCacheVersion || ReadU64(data + 8) != key) {
+    return false;
+  }
+  uint32_t lines = ReadU32(data + 16);
+  uint32_t mappings = ReadU32(data + 20);
+  uint32_t sources = ReadU32(data + 24);
+  uint32_t stringBytes = ReadU32(data + 28);
+  uint64_t expected = kHeaderSize + (static_cast<uint64_t>(lines) + 1) * 4 + static_cast<uint64_t>(mappings) * 16 +
+                      (static_cast<uint64_t>(sources) + 1) * 4 + stringBytes;
+  if (expected != size) return false;
+
+  const auto *lineStarts = reinterpret_cast<const uint32_t *>(data + kHeaderSize);
+  const auto *entries = reinterpret_cast<const Entry *>(lineStarts + lines + 1);
+  const auto *sourceOffsets = reinterpret_cast<const uint32_t *>(entries + mappings);
+  const auto *strings = reinterpret_cast<const char *>(sourceOffsets + sources + 1);
+
+  // Lookups trust these to be in order, so a damaged file must not get past here
+  if (lineStarts[0] != 0 || lineStarts[lines] != mappings) return false;
+  for (uint32_t i = 0; i < lines; ++i) {
+    if (lineStarts[i] > lineStarts[i + 1]) return false;
+  }
+  if (sourceOffsets[0] != 0 || sourceOffsets[sources] != stringBytes) return false;
+  for (uint32_t i = 0; i < sources; ++i) {
+    if (sourceOffsets[i] > sourceOffsets[i + 1]) return false;
+  }
+
+  m_data = data;
+  m_size = size;
+  m_key = key;
+  m_lines = lines;
+  m_mappings = mappings;
+  m_sources = sources;
+  m_stringBytes = stringBytes;
+  m_lineStarts = lineStarts;
+  m_entries = entries;
+  m_sourceOffsets = sourceOffsets;
+  m_strings = strings;
+  return true;
+}
+
+bool SourceMapIndex::Save(const std::string &path) const {
+  // Written aside and renamed over, so a crash midway can't leave a torn table
+  fs::path target = PathFromUtf8(path);
+  fs::path temporary = target;
+  temporary += ".tmp";
+  std::error_code error;
+  fs::create_directories(target.parent_path(), error);
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(m_data), static_cast<std::streamsize>(m_size))) return false;
+  }
+  fs::rename(temporary, target, error);
+  return !error;
+}
+
+bool SourceMapIndex::Lookup(uint32_t line, uint32_t column, SourcePosition &position) const noexcept {
+  if (line == 0 || line > m_lines) return false;
+  const Entry *first = m_entries + m_lineStarts[line - 1];
+  const Entry *last = m_entries + m_lineStarts[line];
+  const Entry *after =
+      std::upper_bound(first, last, column, [](uint32_t value, const Entry &entry) { return value < entry.column; });
+  if (after == first) return false;
+  const Entry &entry = after[-1];
+  if (entry.source >= m_sources) return false;
+  position.source = Source(entry.source);
+  if (position.source.empty()) return false; // A null source
+  position.line = entry.originalLine + 1;
+  position.column = entry.originalColumn;
+  return true;
+}
+
+std::string_view SourceMapIndex::Source(uint32_t index) const noexcept {
+  if (index >= m_sources) return {};
+  return std::string_view(m_strings + m_sourceOffsets[index], m_sourceOffsets[index + 1] - m_sourceOffsets[index]);
+}
+
+} // namespace reactotron
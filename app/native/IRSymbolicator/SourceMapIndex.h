@@ -0,0 +1,139 @@
+#pragma once
+
+//
+//  SourceMapIndex.h
+//  Reactotron
+//
+//  A source map (v3) decoded once into a table that stack frames can be
+//  looked up in without touching the JSON again. Each "mappings" segment
+//  becomes a 16-byte entry (generated column, source, original line and
+//  column), sorted by column within its generated line, with an index of
+//  where each line's entries start. A lookup is an index into that and a
+//  binary search over one line's entries.
+//
+//  The table saves to a flat file that opens with mmap and is used where it
+//  lies, so a map seen before (same content hash) costs a page-in instead of
+//  a parse. Little-endian, every field a u32 unless noted:
+//
+//    0   magic "IRSM"
+//    4   version
+//    8   u64 key: SourceMapKey() of the map it came from
+//    16  generated line count (L)
+//    20  entry count (M)
+//    24  source count (S)
+//    28  string bytes
+//    32  line starts [L + 1]
+//    ..  entries [M], 4 x u32 each
+//    ..  source name offsets [S + 1]
+//    ..  source names, UTF-8, back to back
+//
+//  Names ("names" in the map) aren't kept: in a dev bundle the frame's own
+//  function name is already the original one, and a mapping's name is the
+//  identifier at that position, not the enclosing function.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+/** A file mapped read-only, or empty if it couldn't be. */
+class MappedFile {
+ public:
+  /** Maps `path` (UTF-8). An empty file maps to no data but still opens. */
+  static std::unique_ptr<MappedFile> Open(const std::string &path);
+
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *Data() const noexcept { return m_data; }
+  size_t Size() const noexcept { return m_size; }
+  std::string_view Text() const noexcept { return {reinterpret_cast<const char *>(m_data), m_size}; }
+
+ private:
+  MappedFile() = default;
+
+  const uint8_t *m_data = nullptr;
+  size_t m_size = 0;
+#if defined(_WIN32)
+  void *m_mapping = nullptr;
+#endif
+};
+
+/** XXH64 of a map's bytes, which keys its cache file. */
+uint64_t SourceMapKey(std::string_view bytes) noexcept;
+
+struct SourcePosition {
+  std::string_view source; // Valid as long as the index is
+  uint32_t line = 0;       // 1-based
+  uint32_t column = 0;     // 0-based
+};
+
+/** One map's table. Immutable once made, so lookups may come from any thread. */
+class SourceMapIndex {
+ public:
+  static constexpr uint32_t kCacheVersion = 1;
+  static constexpr uint32_t kNoSource = 0xFFFFFFFF;
+
+  /** One mapping as the table stores it. */
+  struct Entry {
+    uint32_t column;
+    uint32_t source;       // kNoSource for a segment that maps nowhere
+    uint32_t originalLine; // 0-based, as in the map
+    uint32_t originalColumn;
+  };
+
+  /**
+   * Decodes a map's JSON; null with `error` if it isn't one this can read
+   * (not v3, indexed "sections" maps, malformed mappings).
+   */
+  static std::shared_ptr<SourceMapIndex> Parse(std::string_view json, uint64_t key, std::string &error);
+  /** Opens a table Save() wrote for `key`; null if it's missing, for another key or version, or damaged. */
+  static std::shared_ptr<SourceMapIndex> Open(const std::string &path, uint64_t key);
+
+  /** Writes the table to `path`, through a temporary file renamed over it. */
+  bool Save(const std::string &path) const;
+
+  /**
+   * Where generated `line` (1-based) and `column` (0-based, as Metro and
+   * React Native report them) came from: the last mapping on that line at or
+   * before the column. False if there's none, or it maps to no (or a null) source.
+   */
+  bool Lookup(uint32_t line, uint32_t column, SourcePosition &position) const noexcept;
+
+  uint64_t Key() const noexcept { return m_key; }
+  uint32_t Lines() const noexcept { return m_lines; }
+  uint32_t Mappings() const noexcept { return m_mappings; }
+  uint32_t Sources() const noexcept { return m_sources; }
+  std::string_view Source(uint32_t index) const noexcept;
+  /** The table's size, in memory or mapped. */
+  size_t ByteSize() const noexcept { return m_size; }
+  bool IsMapped() const noexcept { return m_file != nullptr; }
+
+ private:
+  SourceMapIndex() = default;
+  /** Points the views into `data`; false if its header and arrays don't add up. */
+  bool Attach(const uint8_t *data, size_t size, uint64_t key);
+
+  std::vector<uint8_t> m_image;       // When parsed here
+  std::unique_ptr<MappedFile> m_file; // When opened from a cache file
+  const uint8_t *m_data = nullptr;
+  size_t m_size = 0;
+
+  uint64_t m_key = 0;
+  uint32_t m_lines = 0;
+  uint32_t m_mappings = 0;
+  uint32_t m_sources = 0;
+  uint32_t m_stringBytes = 0;
+  const uint32_t *m_lineStarts = nullptr;
+  const Entry *m_entries = nullptr;
+  const uint32_t *m_sourceOffsets = nullptr;
+  const char *m_strings = nullptr;
+};
+
+} // namespace reactotron
@@ -0,0 +1,346 @@
+//
+//  Symbolicator.cpp
+//  Reactotron
+//
+
+#include "Symbolicator.h"
+#include "../TaskExecutor/TaskExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+
+namespace reactotron {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr const char *kCacheExtension = ".irsm";
+
+int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+fs::path PathFromUtf8(const std::string &path) { return fs::path(std::u8string(path.begin(), path.end())); }
+
+bool StartsWith(const std::string &text, std::string_view prefix) noexcept {
+  return text.size() >= prefix.size() && std::string_view(text).substr(0, prefix.size()) == prefix;
+}
+
+bool IsHttpUrl(const std::string &text) noexcept { return StartsWith(text, "http://") || StartsWith(text, "https://"); }
+
+/**
+ * The bundle a frame names, as maps are keyed. Newer React Native versions
+ * report bundle URLs with their query written as "//&"; Metro wants "?".
+ */
+std::string NormalizeBundle(const std::string &file) {
+  std::string bundle = file;
+  size_t query = bundle.find("//&");
+  if (query != std::string::npos && IsHttpUrl(bundle)) bundle.replace(query, 3, "?");
+  return bundle;
+}
+
+/** The last path component, without a query: how a registered map matches a bundle URL it wasn't registered as. */
+std::string BundleName(const std::string &bundle) {
+  std::string path = bundle.substr(0, bundle.find('?'));
+  size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string KeyName(uint64_t key) {
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016" PRIx64, key);
+  return name;
+}
+
+/** Removes all but the kMaxCacheFiles most recently used tables. */
+void TrimCacheDirectory(const fs::path &directory) {
+  std::error_code error;
+  std::vector<std::pair<fs::file_time_type, fs::path>> tables;
+  for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+    if (it->path().extension() != kCacheExtension) continue;
+    std::error_code timeError;
+    fs::file_time_type time = it->last_write_time(timeError);
+    if (!timeError) tables.emplace_back(time, it->path());
+  }
+  if (tables.size() <= Symbolicator::kMaxCacheFiles) return;
+  std::sort(tables.begin(), tables.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+  for (size_t i = Symbolicator::kMaxCacheFiles; i < tables.size(); ++i) fs::remove(tables[i].second, error);
+}
+
+} // namespace
+
+Symbolicator &Symbolicator::Shared() {
+  static Symbolicator *shared = new Symbolicator(); // Never destroyed, so a batch running at exit can still finish
+  return *shared;
+}
+
+void Symbolicator::SetCacheDirectory(std::string directory) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cacheDirectory = std::move(directory);
+}
+
+void Symbolicator::SetMapFetcher(MapFetcher fetcher) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_fetcher = std::move(fetcher);
+}
+
+void Symbolicator::RegisterMap(const std::string &bundle, std::string mapPath) {
+  std::string key = NormalizeBundle(bundle);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_registered[key] = std::move(mapPath);
+  m_maps.erase(key);
+}
+
+void Symbolicator::Invalidate() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_maps.clear();
+  ++m_generation;
+  m_stats.maps = 0;
+  m_stats.tableBytes = 0;
+}
+
+void Symbolicator::SetRetryIntervals(int64_t failureRetryMs, int64_t revalidateMs) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_failureRetryNanos = failureRetryMs * 1000000;
+  m_revalidateNanos = revalidateMs * 1000000;
+}
+
+std::string Symbolicator::MapUrlForBundle(const std::string &bundle) {
+  if (!IsHttpUrl(bundle)) return std::string();
+  size_t queryStart = bundle.find('?');
+  std::string path = bundle.substr(0, queryStart);
+  std::string query = queryStart == std::string::npos ? std::string() : bundle.substr(queryStart);
+  size_t extension = path.rfind(".bundle");
+  if (extension == std::string::npos || extension + 7 != path.size()) return std::string();
+  return path.substr(0, extension) + ".map" + query;
+}
+
+std::vector<SymbolicatedFrame> Symbolicator::Symbolicate(const std::vector<StackFrameLocation> &frames) {
+  // Each bundle's map is looked up once, so a storm of frames from one bundle takes its lock once
+  std::unordered_map<std::string, std::shared_ptr<const LoadedMap>> maps;
+  std::vector<const LoadedMap *> frameMaps(frames.size(), nullptr);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    if (frames[i].file.empty() || frames[i].line == 0) continue;
+    auto &map = maps[frames[i].file];
+    if (!map) map = Map(frames[i].file);
+    frameMaps[i] = map.get();
+  }
+
+  std::vector<SymbolicatedFrame> results(frames.size());
+  uint64_t resolved = 0;
+  uint64_t lookups = 0;
+  int64_t started = NowNanos();
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const LoadedMap *map = frameMaps[i];
+    if (!map) continue;
+    SymbolicatedFrame &result = results[i];
+    if (!map->index) {
+      result.error = map->error;
+      continue;
+    }
+    ++lookups;
+    SourcePosition position;
+    if (!map->index->Lookup(frames[i].line, frames[i].column, position)) continue;
+    result.resolved = true;
+    result.file.assign(position.source);
+    result.line = position.line;
+    result.column = position.column;
+    ++resolved;
+  }
+  int64_t elapsed = NowNanos() - started;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_stats.batches;
+  m_stats.frames += frames.size();
+  m_stats.resolved += resolved;
+  if (lookups > 0) m_stats.lookupNs = static_cast<double>(elapsed) / static_cast<double>(lookups);
+  return results;
+}
+
+void Symbolicator::SymbolicateAsync(std::vector<StackFrameLocation> frames, Completion completion) {
+  TaskExecutor::Shared().Post(TaskPriority::Interactive,
+                              [this, frames = std::move(frames), completion = std::move(completion)] {
+                                std::vector<SymbolicatedFrame> results;
+                                try {
+                                  results = Symbolicate(frames);
+                                } catch (const std::exception &e) {
+                                  results.assign(frames.size(), SymbolicatedFrame());
+                                  for (auto &result : results) result.error = e.what();
+                                }
+                                completion(std::move(results));
+                              });
+}
+
+SymbolicatorStats Symbolicator::Stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+std::shared_ptr<const Symbolicator::LoadedMap> Symbolicator::Map(const std::string &file) {
+  std::string bundle = NormalizeBundle(file);
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_maps.find(bundle);
+    if (found != m_maps.end() && IsCurrent(*found->second, NowNanos())) return found->second;
+    generation = m_generation;
+  }
+
+  std::lock_guard<std::mutex> loading(m_loadMutex);
+  std::shared_ptr<const LoadedMap> previous;
+  {
+    // Another batch may have loaded it while this one waited
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_maps.find(bundle);
+    if (found != m_maps.end()) {
+      if (IsCurrent(*found->second, NowNanos())) return found->second;
+      previous = found->second;
+    }
+  }
+  std::shared_ptr<const LoadedMap> loaded = Load(bundle, previous);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (generation == m_generation) {
+    std::shared_ptr<const LoadedMap> &kept = m_maps[bundle];
+    if (!kept || kept->index != loaded->index) {
+      if (kept && kept->index) {
+        --m_stats.maps;
+        m_stats.tableBytes -= kept->index->ByteSize();
+      }
+      if (loaded->index) {
+        ++m_stats.maps;
+        m_stats.tableBytes += loaded->index->ByteSize();
+      }
+    }
+    kept = loaded;
+  }
+  return loaded;
+}
+
+bool Symbolicator::IsCurrent(const LoadedMap &map, int64_t now) const {
+  // Failures aren't kept for long: Metro may only have been building the bundle
+  if (!map.index) return now - map.loadedAt < m_failureRetryNanos;
+  // Fast Refresh changes what a bundle URL serves without the app reconnecting
+  if (map.downloaded) return now - map.loadedAt < m_revalidateNanos;
+  return true;
+}
+
+std::shared_ptr<const Symbolicator::LoadedMap> Symbolicator::Load(const std::string &bundle,
+                                                                  const std::shared_ptr<const LoadedMap> &previous) {
+  int64_t started = NowNanos();
+  std::string registered;
+  std::string cacheDirectory;
+  MapFetcher fetcher;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_registered.find(bundle);
+    if (found == m_registered.end()) {
+      std::string name = BundleName(bundle);
+      found = std::find_if(m_registered.begin(), m_registered.end(),
+                           [&name](const auto &entry) { return BundleName(entry.first) == name; });
+    }
+    if (found != m_registered.end()) registered = found->second;
+    cacheDirectory = m_cacheDirectory;
+    fetcher = m_fetcher;
+  }
+
+  auto loaded = std::make_shared<LoadedMap>();
+  std::shared_ptr<SourceMapIndex> current = previous ? previous->index : nullptr;
+  if (!registered.empty()) {
+    loaded->index = IndexFor(registered, cacheDirectory, loaded->error);
+  } else if (IsHttpUrl(bundle)) {
+    std::string url = MapUrlForBundle(bundle);
+    if (url.empty()) {
+      loaded->error = "No source map is known for " + bundle;
+    } else if (!fetcher || cacheDirectory.empty()) {
+      loaded->error = "Source maps can't be downloaded here";
+    } else {
+      // Downloaded beside the tables, read, and removed: only the table is kept
+      fs::path download = PathFromUtf8(cacheDirectory) / (KeyName(SourceMapKey(url)) + ".map.download");
+      std::u8string downloadUtf8 = download.u8string();
+      std::string downloadPath(downloadUtf8.begin(), downloadUtf8.end());
+      std::error_code error;
+      fs::create_directories(download.parent_path(), error);
+      MapDownload fetch;
+      if (current) fetch.etag = previous->etag;
+      loaded->downloaded = true;
+      if (!fetcher(url, downloadPath, fetch)) {
+        loaded->error = fetch.error.empty() ? "Couldn't download " + url : fetch.error;
+      } else if (fetch.notModified && current) {
+        loaded->index = current;
+        loaded->etag = previous->etag;
+      } else {
+        // Unchanged content keeps the table it already has, ETag or not
+        loaded->index = IndexFor(downloadPath, cacheDirectory, loaded->error, current);
+        loaded->etag = std::move(fetch.etag);
+      }
+      fs::remove(download, error);
+      // Metro going away for a moment shouldn't lose a map that was working; it's tried again later
+      if (!loaded->index && current) {
+        loaded->index = current;
+        loaded->etag = previous->etag;
+        loaded->error.clear();
+      }
+    }
+  } else {
+    std::string path = StartsWith(bundle, "file://") ? bundle.substr(7) : bundle;
+    loaded->index = IndexFor(path.substr(0, path.find('?')) + ".map", cacheDirectory, loaded->error);
+  }
+
+  loaded->loadedAt = NowNanos();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!loaded->index) ++m_stats.loadFailures;
+  m_stats.lastLoadMs = static_cast<double>(loaded->loadedAt - started) / 1e6;
+  return loaded;
+}
+
+std::shared_ptr<SourceMapIndex> Symbolicator::IndexFor(const std::string &mapPath, const std::string &cacheDirectory,
+                                                       std::string &error,
+                                                       const std::shared_ptr<SourceMapIndex> &current) {
+  std::unique_ptr<MappedFile> map = MappedFile::Open(mapPath);
+  if (!map) {
+    error = "Couldn't read the source map at " + mapPath;
+    return nullptr;
+  }
+  uint64_t key = SourceMapKey(map->Text());
+  if (current && current->Key() == key) return current;
+
+  fs::path cachePath;
+  std::string cachePathUtf8;
+  if (!cacheDirectory.empty()) {
+    cachePath = PathFromUtf8(cacheDirectory) / (KeyName(key) + kCacheExtension);
+    std::u8string utf8 = cachePath.u8string();
+    cachePathUtf8.assign(utf8.begin(), utf8.end());
+    if (auto cached = SourceMapIndex::Open(cachePathUtf8, key)) {
+      // Touched, so trimming keeps the tables in use
+      std::error_code touchError;
+      fs::last_write_time(cachePath, fs::file_time_type::clock::now(), touchError);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      ++m_stats.cacheHits;
+      return cached;
+    }
+  }
+
+  int64_t started = NowNanos();
+  std::shared_ptr<SourceMapIndex> index = SourceMapIndex::Parse(map->Text(), key, error);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.parses;
+    m_stats.lastParseMs = static_cast<double>(NowNanos() - started) / 1e6;
+  }
+  if (!index || cachePathUtf8.empty()) return index;
+
+  // Used from the saved file, so the table is paged from disk rather than held in memory
+  if (index->Save(cachePathUtf8)) {
+    TrimCacheDirectory(cachePath.parent_path());
+    if (auto saved = SourceMapIndex::Open(cachePathUtf8, key)) return saved;
+  }
+  return index;
+}
+
+} // namespace reactotron
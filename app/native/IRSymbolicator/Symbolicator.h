@@ -0,0 +1,152 @@
+#pragma once
+
+//
+//  Symbolicator.h
+//  Reactotron
+//
+//  Turns the bundle-relative frames of an error's stack into the source files
+//  and lines they came from. Each bundle's source map is fetched (from Metro,
+//  next to the bundle) or read once, decoded into a SourceMapIndex and kept
+//  for the session; its table is saved to the cache directory under the
+//  map's content hash, so the next session with the same bundle maps the
+//  table in instead of parsing the map again.
+//
+//  A downloaded map is checked against Metro again once it's kRevalidateMs
+//  old, since Fast Refresh changes the bundle behind the same URL: by ETag
+//  where the server sends one, otherwise by the content hash, so an
+//  unchanged map keeps its table. Failed loads are retried after
+//  kFailureRetryMs, as Metro may still have been building the bundle.
+//
+//  A batch of frames runs on the shared TaskExecutor, grouped by bundle so
+//  an error storm costs one map load and then a binary search per frame.
+//
+
+#include "SourceMapIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+struct StackFrameLocation {
+  std::string file;    // The bundle: an http(s) URL or a path
+  uint32_t line = 0;   // 1-based
+  uint32_t column = 0; // 0-based
+};
+
+struct SymbolicatedFrame {
+  bool resolved = false;
+  std::string file; // If resolved, the original source
+  uint32_t line = 0;
+  uint32_t column = 0;
+  std::string error; // If not: why, when it's the map's fault rather than the frame's
+};
+
+struct SymbolicatorStats {
+  size_t maps = 0;         // Loaded this session
+  uint64_t tableBytes = 0; // Their tables, in memory or mapped
+  uint64_t cacheHits = 0;  // Tables opened from the cache directory
+  uint64_t parses = 0;
+  uint64_t loadFailures = 0;
+  uint64_t batches = 0;
+  uint64_t frames = 0;
+  uint64_t resolved = 0;
+  double lastLoadMs = 0;  // Fetching or reading the last map, and getting its table
+  double lastParseMs = 0; // Of that, decoding it, if it wasn't cached
+  double lookupNs = 0;    // Per frame, over the last batch
+};
+
+/** The symbolicator; Shared() is the one the modules use. Thread-safe. */
+class Symbolicator {
+ public:
+  /** Cache files kept; older ones are removed as new ones are written. */
+  static constexpr size_t kMaxCacheFiles = 8;
+
+  /** How long a failed load is remembered before the map is tried again. */
+  static constexpr int64_t kFailureRetryMs = 5000;
+  /** How long a downloaded map is used before it's checked against the server again. */
+  static constexpr int64_t kRevalidateMs = 2000;
+
+  /** One download of a map. */
+  struct MapDownload {
+    std::string etag;         // In: the loaded map's, if any, to ask only for a changed one. Out: the server's
+    bool notModified = false; // Out: the server said the loaded map is current; nothing was written
+    std::string error;        // Out: why it couldn't be downloaded
+  };
+  /** Downloads `url` to the file at `path`; false, with `download.error`, if it can't. */
+  using MapFetcher = std::function<bool(const std::string &url, const std::string &path, MapDownload &download)>;
+  using Completion = std::function<void(std::vector<SymbolicatedFrame>)>;
+
+  static Symbolicator &Shared();
+
+  Symbolicator() = default;
+  Symbolicator(const Symbolicator &) = delete;
+  Symbolicator &operator=(const Symbolicator &) = delete;
+
+  /** Where tables are cached (UTF-8); empty, the default, keeps them in memory only. */
+  void SetCacheDirectory(std::string directory);
+  /** How maps for http(s) bundles are downloaded; without one only local maps are read. */
+  void SetMapFetcher(MapFetcher fetcher);
+  /** Uses the map at `mapPath` for `bundle` instead of looking for one. */
+  void RegisterMap(const std::string &bundle, std::string mapPath);
+  /** Forgets loaded maps and failures, as when the app reloads with a new bundle. */
+  void Invalidate();
+  /** Overrides kFailureRetryMs and kRevalidateMs. */
+  void SetRetryIntervals(int64_t failureRetryMs, int64_t revalidateMs);
+
+  /** Symbolicates on the calling thread, loading maps as needed. */
+  std::vector<SymbolicatedFrame> Symbolicate(const std::vector<StackFrameLocation> &frames);
+  /** Symbolicates on the shared TaskExecutor and hands the frames, in order, to `completion` there. */
+  void SymbolicateAsync(std::vector<StackFrameLocation> frames, Completion completion);
+
+  SymbolicatorStats Stats() const;
+
+  /**
+   * The map URL Metro serves next to `bundle`: ".bundle" becomes ".map" in
+   * the path, and the query is kept. Empty if it isn't an http(s) bundle URL.
+   */
+  static std::string MapUrlForBundle(const std::string &bundle);
+
+ private:
+  struct LoadedMap {
+    std::shared_ptr<SourceMapIndex> index; // Null if it failed
+    std::string error;
+    int64_t loadedAt = 0;    // Or last revalidated, in steady-clock nanoseconds
+    bool downloaded = false; // Revalidated against the server once it's old enough
+    std::string etag;        // The server's, if it was downloaded with one
+  };
+
+  /** The bundle's map, loading it first if it hasn't been or what was loaded is due to be checked again. */
+  std::shared_ptr<const LoadedMap> Map(const std::string &file);
+  /** Whether `map` can still be used at `now`, rather than loaded again. Under m_mutex. */
+  bool IsCurrent(const LoadedMap &map, int64_t now) const;
+  /** Loads the bundle's map; `previous` is the one loaded before, to keep if it's unchanged. */
+  std::shared_ptr<const LoadedMap> Load(const std::string &bundle, const std::shared_ptr<const LoadedMap> &previous);
+  /**
+   * The table for the map at `mapPath`: `current` if it was made from the same map, otherwise from the
+   * cache directory if it's there, otherwise parsed and saved.
+   */
+  std::shared_ptr<SourceMapIndex> IndexFor(const std::string &mapPath, const std::string &cacheDirectory,
+                                           std::string &error,
+                                           const std::shared_ptr<SourceMapIndex> &current = nullptr);
+
+  mutable std::mutex m_mutex;
+  std::string m_cacheDirectory;
+  MapFetcher m_fetcher;
+  std::unordered_map<std::string, std::string> m_registered; // Bundle -> map path
+  std::unordered_map<std::string, std::shared_ptr<const LoadedMap>> m_maps;
+  uint64_t m_generation = 0; // Bumped by Invalidate(), so a load that started before it isn't kept
+  int64_t m_failureRetryNanos = kFailureRetryMs * 1000000;
+  int64_t m_revalidateNanos = kRevalidateMs * 1000000;
+  SymbolicatorStats m_stats;
+
+  std::mutex m_loadMutex; // One map loads at a time: they're large, and a storm would fetch each many times
+};
+
+} // namespace reactotron
@@ -1,5 +1,9 @@
 #import "IRSystemInfo.h"
 #import <mach/mach.h>
+#include "MetricsHistory.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 // Private properties
 @interface IRSystemInfo ()
@@ -8,7 +12,19 @@
 @end
 
 // The actual implementation of IRSystemInfo.
-@implementation IRSystemInfo RCT_EXPORT_MODULE()
+@implementation IRSystemInfo {
+  std::unique_ptr<reactotron::MetricsHistory> _history;
+  std::mutex _historyMutex;
+  dispatch_source_t _historyTimer;
+}
+
+RCT_EXPORT_MODULE()
+
+// History samples are taken this often, whether or not anyone is listening for events
+static const uint64_t kHistorySamplingMs = 100;
+
+// Column order of the values in the history
+static const char *const kHistoryMetrics[] = {"rss", "vsz", "cpu"};
 
 // Constructor
 - (instancetype)init {
@@ -21,6 +37,7 @@
 
 - (void)dealloc {
   [self stopMonitoring];
+  if (_historyTimer) dispatch_source_cancel(_historyTimer);
 }
 
 - (void)setSamplingInterval:(NSTimeInterval)samplingInterval {
@@ -64,6 +81,49 @@
   NSLog(@"[IRSystemInfo] Stopped monitoring.");
 }
 
+- (void)startHistory {
+  std::lock_guard<std::mutex> lock(_historyMutex);
+  if (_historyTimer) return;
+  _history = std::make_unique<reactotron::MetricsHistory>(3);
+
+  dispatch_queue_t queue = dispatch_queue_create("com.reactotron.systeminfo.history", DISPATCH_QUEUE_SERIAL);
+  _historyTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+  dispatch_source_set_timer(_historyTimer, dispatch_time(DISPATCH_TIME_NOW, 0), kHistorySamplingMs * NSEC_PER_MSEC,
+                            10 * NSEC_PER_MSEC);
+  __weak IRSystemInfo *weakSelf = self;
+  dispatch_source_set_event_handler(_historyTimer, ^{
+    [weakSelf sampleHistory];
+  });
+  dispatch_resume(_historyTimer);
+}
+
+- (void)sampleHistory {
+  NSDictionary *mem = [self getMemoryUsage];
+  double values[] = {[mem[@"rss"] doubleValue], [mem[@"vsz"] doubleValue], [[self getCPUUsage] doubleValue]};
+  int64_t now = static_cast<int64_t>([[NSDate date] timeIntervalSince1970] * 1000);
+
+  std::lock_guard<std::mutex> lock(_historyMutex);
+  _history->Add(now, values);
+}
+
+- (NSArray<NSDictionary *> *)getHistory:(NSString *)metric from:(double)from to:(double)to points:(double)points {
+  size_t column = 0;
+  while (column < 3 && ![metric isEqualToString:@(kHistoryMetrics[column])]) column++;
+
+  std::vector<reactotron::MetricPoint> history;
+  {
+    std::lock_guard<std::mutex> lock(_historyMutex);
+    if (!_history || column == 3 || points < 1) return @[];
+    history = _history->Query(column, static_cast<int64_t>(from), static_cast<int64_t>(to), static_cast<size_t>(points));
+  }
+
+  NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:history.size()];
+  for (const auto &point : history) {
+    [result addObject:@{ @"time": @(point.time), @"value": @(point.value), @"min": @(point.min), @"max": @(point.max) }];
+  }
+  return result;
+}
+
 - (void)monitorAllSystemInfo {
   NSDictionary *mem = [self getMemoryUsage];
   NSNumber *cpu = [self getCPUUsage];
@@ -89,8 +149,6 @@
   double rss_mb = (double)info.resident_size / (1024.0 * 1024.0);
   double vsz_mb = (double)info.virtual_size / (1024.0 * 1024.0);
 
-  NSLog(@"[IRSystemInfo] Memory Usage - RSS: %.2f MB, VSZ: %.2f MB", rss_mb, vsz_mb);
-
   NSDictionary<NSString *, NSNumber *> *result = @{
     @"rss" : @(rss_mb),
     @"vsz" : @(vsz_mb)
@@ -117,8 +175,6 @@
 
     if (thread_info(threads[i], THREAD_BASIC_INFO, (thread_info_t)&info, &infoCount) == KERN_SUCCESS) {
       if (!(info.flags & TH_FLAGS_IDLE)) {
-        // TEST
-        NSLog(@"thread %i, %.2f%%", i, (double)info.cpu_usage / TH_USAGE_SCALE * 100.0);
         totalCPU += (double)info.cpu_usage / TH_USAGE_SCALE * 100.0;
       }
     }
@@ -129,8 +185,6 @@
   }
   vm_deallocate(mach_task_self(), (vm_offset_t)threads, count * sizeof(thread_t));
 
-  NSLog(@"[IRSystemInfo] CPU Usage: %.2f%%", totalCPU);
-
   return [NSNumber numberWithDouble:totalCPU];
 }
 
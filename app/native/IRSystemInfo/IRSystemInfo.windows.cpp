@@ -7,14 +7,42 @@
 
 #include "pch.h"
 #include "IRSystemInfo.windows.h"
+#include <windows.h>
+#include <psapi.h>
+#include <chrono>
+#include <vector>
 
 namespace winrt::reactotron::implementation
 {
+    // History samples are taken this often, whether or not anyone is listening for events
+    static constexpr auto kHistorySampling = std::chrono::milliseconds(100);
+
+    // Column order of the values in the history
+    static const char *const kHistoryMetrics[] = {"rss", "vsz", "cpu"};
+
+    static uint64_t FileTimeTicks(const FILETIME &time) noexcept
+    {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
     IRSystemInfo::IRSystemInfo() noexcept
     {
         // TurboModule initialization
     }
 
+    IRSystemInfo::~IRSystemInfo() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_historyMutex);
+            m_stopping = true;
+        }
+        m_historyStop.notify_all();
+        if (m_historyThread.joinable())
+        {
+            m_historyThread.join();
+        }
+    }
+
     void IRSystemInfo::startMonitoring() noexcept
     {
         // TODO: Start monitoring Windows system info (CPU, memory usage)
@@ -28,4 +56,84 @@ namespace winrt::reactotron::implementation
         // TODO: Stop system monitoring and clean up timers
         m_isMonitoring = false;
     }
-}
\ No newline at end of file
+
+    void IRSystemInfo::startHistory() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        if (m_history)
+        {
+            return;
+        }
+        m_history = std::make_unique<::reactotron::MetricsHistory>(3);
+        m_historyThread = std::thread([this]() { SampleHistory(); });
+    }
+
+    void IRSystemInfo::SampleHistory() noexcept
+    {
+        HANDLE process = GetCurrentProcess();
+        uint64_t lastCpu = 0;
+        auto lastTime = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_historyMutex);
+        while (!m_stopping)
+        {
+            lock.unlock();
+
+            PROCESS_MEMORY_COUNTERS_EX memory = {};
+            GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&memory), sizeof(memory));
+
+            // Process CPU time over wall time since the last sample, summed over cores like macOS reports it
+            FILETIME creation, exit, kernel, user;
+            uint64_t cpu = GetProcessTimes(process, &creation, &exit, &kernel, &user)
+                               ? FileTimeTicks(kernel) + FileTimeTicks(user)
+                               : lastCpu;
+            auto time = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(time - lastTime).count() * 1e7; // In 100 ns ticks
+            double cpuPercent = lastCpu && elapsed > 0 ? (cpu - lastCpu) / elapsed * 100.0 : 0;
+            lastCpu = cpu;
+            lastTime = time;
+
+            double values[] = {memory.WorkingSetSize / (1024.0 * 1024.0), memory.PrivateUsage / (1024.0 * 1024.0),
+                               cpuPercent};
+            int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+
+            lock.lock();
+            m_history->Add(now, values);
+            m_historyStop.wait_for(lock, kHistorySampling, [this]() { return m_stopping; });
+        }
+    }
+
+    Microsoft::ReactNative::JSValue IRSystemInfo::getHistory(std::string metric, double from, double to,
+                                                             double points) noexcept
+    {
+        size_t column = 0;
+        while (column < 3 && metric != kHistoryMetrics[column])
+        {
+            column++;
+        }
+
+        std::vector<::reactotron::MetricPoint> history;
+        {
+            std::lock_guard<std::mutex> lock(m_historyMutex);
+            if (m_history && column < 3 && points >= 1)
+            {
+                history = m_history->Query(column, static_cast<int64_t>(from), static_cast<int64_t>(to),
+                                           static_cast<size_t>(points));
+            }
+        }
+
+        Microsoft::ReactNative::JSValueArray result;
+        for (const auto &point : history)
+        {
+            Microsoft::ReactNative::JSValueObject item;
+            item["time"] = static_cast<double>(point.time);
+            item["value"] = point.value;
+            item["min"] = point.min;
+            item["max"] = point.max;
+            result.push_back(std::move(item));
+        }
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+}
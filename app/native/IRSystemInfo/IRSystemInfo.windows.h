@@ -1,5 +1,10 @@
 #pragma once
 #include "NativeModules.h"
+#include "MetricsHistory.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace winrt::reactotron::implementation
 {
@@ -7,6 +12,7 @@ namespace winrt::reactotron::implementation
     struct IRSystemInfo
     {
         IRSystemInfo() noexcept;
+        ~IRSystemInfo() noexcept;
 
         REACT_METHOD(startMonitoring)
         void startMonitoring() noexcept;
@@ -14,10 +20,24 @@ namespace winrt::reactotron::implementation
         REACT_METHOD(stopMonitoring)
         void stopMonitoring() noexcept;
 
+        REACT_METHOD(startHistory)
+        void startHistory() noexcept;
+
+        REACT_SYNC_METHOD(getHistory)
+        Microsoft::ReactNative::JSValue getHistory(std::string metric, double from, double to, double points) noexcept;
+
         REACT_EVENT(onSystemInfo)
         std::function<void(Microsoft::ReactNative::JSValue)> onSystemInfo;
 
     private:
+        void SampleHistory() noexcept;
+
         bool m_isMonitoring = false;
+
+        std::unique_ptr<::reactotron::MetricsHistory> m_history;
+        std::mutex m_historyMutex;
+        std::condition_variable m_historyStop;
+        bool m_stopping = false;
+        std::thread m_historyThread;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,172 @@
+//
+//  MetricsHistory.cpp
+//  Reactotron
+//
+
+#include "MetricsHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reactotron {
+
+namespace {
+
+int64_t BucketStart(int64_t time, int64_t bucketMs) noexcept {
+  int64_t start = time / bucketMs * bucketMs;
+  return start > time ? start - bucketMs : start; // Floor for times before the epoch
+}
+
+} // namespace
+
+MetricsHistory::MetricsHistory(size_t metrics) : m_metrics(metrics) {
+  for (size_t i = 0; i < kLevels; ++i) {
+    Level &level = m_levels[i];
+    level.bucketMs = kResolutions[i].bucketMs;
+    level.capacity = kResolutions[i].capacity;
+    level.times.resize(level.capacity);
+    level.buckets.resize(level.capacity * metrics);
+    level.open.resize(metrics);
+  }
+}
+
+void MetricsHistory::Close(Level &level) {
+  size_t slot = (level.head + level.size) % level.capacity;
+  if (level.size == level.capacity) {
+    level.head = (level.head + 1) % level.capacity;
+  } else {
+    level.size++;
+  }
+  level.times[slot] = level.openTime;
+  std::copy(level.open.begin(), level.open.end(), level.buckets.begin() + slot * m_metrics);
+}
+
+void MetricsHistory::Add(int64_t time, const double *values) {
+  for (Level &level : m_levels) {
+    int64_t start = BucketStart(time, level.bucketMs);
+    if (start > level.openTime) {
+      if (level.openTime != INT64_MIN) Close(level);
+      level.openTime = start;
+      for (size_t m = 0; m < m_metrics; ++m) level.open[m] = Bucket{values[m], values[m], values[m], 1};
+      continue;
+    }
+    for (size_t m = 0; m < m_metrics; ++m) {
+      Bucket &bucket = level.open[m];
+      bucket.min = std::min(bucket.min, values[m]);
+      bucket.max = std::max(bucket.max, values[m]);
+      bucket.sum += values[m];
+      bucket.count++;
+    }
+  }
+}
+
+size_t MetricsHistory::ChooseLevel(int64_t from, int64_t to, size_t points) const noexcept {
+  size_t maxBuckets = std::max<size_t>(points, 1) * kMaxBucketsPerPoint;
+  for (size_t i = 0; i < kLevels; ++i) {
+    const Level &level = m_levels[i];
+    // A ring that hasn't wrapped still has everything since the first sample
+    bool covers = level.size < level.capacity || level.times[level.head] <= from;
+    int64_t oldest = level.size ? level.times[level.head] : level.openTime;
+    int64_t begin = std::max(from, oldest);
+    uint64_t buckets = to >= begin ? static_cast<uint64_t>((to - begin) / level.bucketMs) + 1 : 0;
+    if (covers && buckets <= maxBuckets) return i;
+  }
+  return kLevels - 1;
+}
+
+std::vector<MetricPoint> MetricsHistory::Query(size_t metric, int64_t from, int64_t to, size_t points) const {
+  std::vector<MetricPoint> series;
+  if (metric >= m_metrics || to < from || points == 0) return series;
+  const Level &level = m_levels[ChooseLevel(from, to, points)];
+
+  // The first closed bucket ending after `from`; the ring is in time order
+  auto timeAt = [&](size_t i) { return level.times[(level.head + i) % level.capacity]; };
+  size_t lo = 0, hi = level.size;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (timeAt(mid) + level.bucketMs <= from) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  auto point = [](int64_t time, const Bucket &bucket) {
+    return MetricPoint{time, bucket.sum / bucket.count, bucket.min, bucket.max};
+  };
+  for (size_t i = lo; i < level.size && timeAt(i) <= to; ++i) {
+    size_t slot = (level.head + i) % level.capacity;
+    series.push_back(point(level.times[slot], level.buckets[slot * m_metrics + metric]));
+  }
+  if (level.openTime != INT64_MIN && level.openTime <= to && level.openTime + level.bucketMs > from) {
+    series.push_back(point(level.openTime, level.open[metric]));
+  }
+  return DownsampleLttb(series, points);
+}
+
+size_t MetricsHistory::ByteSize() const noexcept {
+  size_t bytes = sizeof(*this);
+  for (const Level &level : m_levels) {
+    bytes += level.times.capacity() * sizeof(int64_t) + (level.buckets.capacity() + level.open.capacity()) * sizeof(Bucket);
+  }
+  return bytes;
+}
+
+std::vector<MetricPoint> DownsampleLttb(const std::vector<MetricPoint> &series, size_t points) {
+  size_t n = series.size();
+  if (n <= points || points == 0) return series;
+  if (points < 3) {
+    std::vector<MetricPoint> out(series.end() - static_cast<std::ptrdiff_t>(points), series.end());
+    return out;
+  }
+
+  std::vector<MetricPoint> out;
+  out.reserve(points);
+  out.push_back(series.front());
+
+  // Buckets split the points between the first and last, evenly
+  double every = static_cast<double>(n - 2) / static_cast<double>(points - 2);
+  size_t a = 0;
+  for (size_t i = 0; i < points - 2; ++i) {
+    size_t begin = static_cast<size_t>(std::floor(i * every)) + 1;
+    size_t end = std::min(static_cast<size_t>(std::floor((i + 1) * every)) + 1, n - 1);
+
+    // The next bucket's average, the third corner (the last point, for the last bucket)
+    // Times are taken relative to `a`, so epoch milliseconds don't cost precision
+    int64_t aTime = series[a].time;
+    double aValue = series[a].value;
+    size_t nextBegin = end;
+    size_t nextEnd = std::min(static_cast<size_t>(std::floor((i + 2) * every)) + 1, n);
+    double avgTime = 0, avgValue = 0;
+    for (size_t j = nextBegin; j < nextEnd; ++j) {
+      avgTime += static_cast<double>(series[j].time - aTime);
+      avgValue += series[j].value;
+    }
+    size_t nextCount = nextEnd - nextBegin;
+    avgTime /= static_cast<double>(nextCount);
+    avgValue /= static_cast<double>(nextCount);
+
+    double bestArea = -1;
+    size_t best = begin;
+    MetricPoint selected = series[begin];
+    for (size_t j = begin; j < end; ++j) {
+      double area = std::fabs(avgTime * (series[j].value - aValue) -
+                              static_cast<double>(series[j].time - aTime) * (avgValue - aValue));
+      if (area > bestArea) {
+        bestArea = area;
+        best = j;
+      }
+      selected.min = std::min(selected.min, series[j].min);
+      selected.max = std::max(selected.max, series[j].max);
+    }
+    selected.time = series[best].time;
+    selected.value = series[best].value;
+    out.push_back(selected);
+    a = best;
+  }
+
+  out.push_back(series.back());
+  return out;
+}
+
+} // namespace reactotron
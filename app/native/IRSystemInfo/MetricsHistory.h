@@ -0,0 +1,90 @@
+#pragma once
+
+//
+//  MetricsHistory.h
+//  Reactotron
+//
+//  A session's worth of process metrics (memory, CPU) in fixed memory.
+//  Samples roll up into rings of buckets at 100 ms, 1 s, 10 s and 1 min,
+//  each keeping the min, max and average of every metric. A query reads the
+//  finest ring that covers the range in a bounded number of buckets and
+//  downsamples it with Largest-Triangle-Three-Buckets to the points a chart
+//  draws, so its cost doesn't grow with the session.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace reactotron {
+
+struct MetricPoint {
+  int64_t time = 0; // Bucket start, ms since the epoch
+  double value = 0; // Average
+  double min = 0;   // Over everything the point stands for
+  double max = 0;
+};
+
+/**
+ * The history of `metrics` values sampled together. Samples older than the
+ * open buckets are folded into them.
+ *
+ * Not thread-safe.
+ */
+class MetricsHistory {
+ public:
+  struct Resolution {
+    int64_t bucketMs;
+    size_t capacity;
+  };
+
+  // 10 minutes at 100 ms, an hour at 1 s, 6 hours at 10 s and a day at 1 min
+  static constexpr Resolution kResolutions[] = {{100, 6000}, {1000, 3600}, {10000, 2160}, {60000, 1440}};
+  static constexpr size_t kLevels = sizeof(kResolutions) / sizeof(kResolutions[0]);
+  // A query reads at most this many buckets per point it returns, or the whole ring if that's less
+  static constexpr size_t kMaxBucketsPerPoint = 8;
+
+  explicit MetricsHistory(size_t metrics);
+
+  void Add(int64_t time, const double *values);
+
+  /** Up to `points` points of `metric` between `from` and `to`, oldest first. */
+  std::vector<MetricPoint> Query(size_t metric, int64_t from, int64_t to, size_t points) const;
+
+  size_t Metrics() const noexcept { return m_metrics; }
+  size_t ByteSize() const noexcept;
+
+ private:
+  struct Bucket {
+    double min;
+    double max;
+    double sum;
+    uint32_t count;
+  };
+
+  struct Level {
+    int64_t bucketMs = 0;
+    size_t capacity = 0;
+    std::vector<int64_t> times; // Ring of closed buckets' start times
+    std::vector<Bucket> buckets; // The same ring, `m_metrics` buckets per slot
+    size_t head = 0; // Oldest slot
+    size_t size = 0;
+    int64_t openTime = INT64_MIN; // The bucket still filling
+    std::vector<Bucket> open;
+  };
+
+  void Close(Level &level);
+  size_t ChooseLevel(int64_t from, int64_t to, size_t points) const noexcept;
+
+  size_t m_metrics;
+  Level m_levels[kLevels];
+};
+
+/**
+ * Largest-Triangle-Three-Buckets: keeps the first and last points and, from
+ * each of `points` - 2 buckets in between, the one forming the largest
+ * triangle with its neighbours, widening its min and max to the bucket's.
+ */
+std::vector<MetricPoint> DownsampleLttb(const std::vector<MetricPoint> &series, size_t points);
+
+} // namespace reactotron
@@ -8,9 +8,24 @@ export interface SystemInfo {
   cpu: number // CPU Usage: The percentage of CPU usage by the process in % (0-100)
 }
 
+/** A point of a metric's history, standing for one or more samples. */
+export interface MetricPoint {
+  time: number // Start of the span the point stands for, in ms since the epoch
+  value: number // Average over the span
+  min: number
+  max: number
+}
+
 export interface Spec extends TurboModule {
   startMonitoring(): void
   stopMonitoring(): void
+  /** Starts sampling into the history every 100 ms, for the rest of the session. */
+  startHistory(): void
+  /**
+   * Up to `points` points of "rss", "vsz" or "cpu" between `from` and `to` (ms since the
+   * epoch), downsampled from the finest resolution that covers them.
+   */
+  getHistory(metric: string, from: number, to: number, points: number): MetricPoint[]
   readonly onSystemInfo: EventEmitter<SystemInfo>
 }
 
@@ -0,0 +1,138 @@
+//
+//  IRTimelineQuery.mm
+//  Reactotron-macOS
+//
+//  Structured timeline filters compiled and evaluated over native columns.
+//
+
+#import "IRTimelineQuery.h"
+#include "TimelineQuery.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+@implementation IRTimelineQuery {
+  reactotron::TimelineColumns _columns;
+  std::unordered_map<uint32_t, std::unique_ptr<reactotron::TimelineQuery>> _queries;
+  uint32_t _nextQueryId;
+  std::mutex _queryMutex;
+  uint32_t _memoryStoreId;
+}
+
+RCT_EXPORT_MODULE()
+
+static const uint32_t kMemoryReportRows = 1024;
+
+- (instancetype)init {
+  if (self = [super init]) {
+    // The oldest rows go first. Their items may still be on the timeline; a structured search
+    // just won't find them any more
+    __weak IRTimelineQuery *weakSelf = self;
+    _memoryStoreId = reactotron::MemoryGovernor::Shared().Register("searchIndex", [weakSelf](uint64_t bytes) -> uint64_t {
+      IRTimelineQuery *strongSelf = weakSelf;
+      return strongSelf ? [strongSelf _shrink:bytes] : 0;
+    });
+  }
+  return self;
+}
+
+- (void)dealloc {
+  reactotron::MemoryGovernor::Shared().Unregister(_memoryStoreId);
+}
+
+- (uint64_t)_shrink:(uint64_t)bytes {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  uint64_t freed = _columns.Shrink(bytes);
+  [self _reportMemory];
+  return freed;
+}
+
+// Under _queryMutex
+- (void)_reportMemory {
+  reactotron::MemoryGovernor::Shared().Report(_memoryStoreId, _columns.ByteSize(), _columns.OldestTime());
+}
+
+static std::string IRTimelineQueryString(id value) {
+  if (![value isKindOfClass:[NSString class]]) return std::string();
+  const char *utf8 = [(NSString *)value UTF8String];
+  return utf8 ? std::string(utf8) : std::string();
+}
+
+- (NSNumber *)append:(NSArray *)strings numbers:(NSArray *)numbers {
+  std::string values[reactotron::kTimelineStringFields];
+  reactotron::TimelineRow row;
+  for (size_t i = 0; i < reactotron::kTimelineStringFields; ++i) {
+    if (i < strings.count) values[i] = IRTimelineQueryString(strings[i]);
+    row.strings[i] = values[i];
+  }
+  for (size_t i = 0; i < reactotron::kTimelineNumberFields; ++i) {
+    id number = i < numbers.count ? numbers[i] : nil;
+    row.numbers[i] = [number isKindOfClass:[NSNumber class]] ? [(NSNumber *)number doubleValue] : NAN;
+  }
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  uint32_t index = _columns.Append(row);
+  if (index % kMemoryReportRows == 0) [self _reportMemory];
+  return @(index);
+}
+
+- (NSDictionary *)compile:(NSString *)query {
+  std::string error;
+  auto compiled = reactotron::TimelineQuery::Compile(IRTimelineQueryString(query), error);
+  if (!compiled) {
+    return @{ @"queryId": @0, @"error": [NSString stringWithUTF8String:error.c_str()] ?: @"", @"text": @[] };
+  }
+  NSMutableArray *text = [NSMutableArray arrayWithCapacity:compiled->Text().size()];
+  for (const std::string &word : compiled->Text()) {
+    [text addObject:[NSString stringWithUTF8String:word.c_str()] ?: @""];
+  }
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  uint32_t queryId = ++_nextQueryId;
+  _queries[queryId] = std::move(compiled);
+  return @{ @"queryId": @(queryId), @"error": @"", @"text": text };
+}
+
+- (NSDictionary *)evaluate:(double)queryId {
+  std::vector<uint32_t> rows;
+  bool restarted = false;
+  uint32_t firstRow;
+  {
+    std::lock_guard<std::mutex> lock(_queryMutex);
+    auto it = _queries.find(static_cast<uint32_t>(queryId));
+    if (it != _queries.end()) restarted = !it->second->Evaluate(_columns, rows);
+    firstRow = _columns.FirstRow();
+  }
+  NSMutableArray *matches = [NSMutableArray arrayWithCapacity:rows.size()];
+  for (uint32_t row : rows) [matches addObject:@(row)];
+  return @{ @"restarted": @(restarted), @"rows": matches, @"firstRow": @(firstRow) };
+}
+
+- (NSNumber *)dispose:(double)queryId {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  return @(_queries.erase(static_cast<uint32_t>(queryId)));
+}
+
+- (NSNumber *)clear {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  size_t rows = _columns.Rows();
+  _columns.Clear();
+  [self _reportMemory];
+  return @(rows);
+}
+
+- (NSNumber *)dropBefore:(double)row {
+  if (!(row > 0)) return @0;
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  size_t dropped = _columns.DropBefore(row < UINT32_MAX ? static_cast<uint32_t>(row) : UINT32_MAX);
+  if (dropped) [self _reportMemory];
+  return @(dropped);
+}
+
+- (std::shared_ptr<facebook::react::TurboModule>)getTurboModule:(const facebook::react::ObjCTurboModule::InitParams &)params {
+  return std::make_shared<facebook::react::NativeIRTimelineQuerySpecJSI>(params);
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  IRTimelineQuery.cpp
+//  Reactotron-Windows
+//
+//  Windows TurboModule wrapper around the shared TimelineQuery
+//
+
+#include "pch.h"
+#include "IRTimelineQuery.windows.h"
+
+#include <cmath>
+
+namespace winrt::reactotron::implementation
+{
+    static const uint32_t kMemoryReportRows = 1024;
+
+    IRTimelineQuery::IRTimelineQuery() noexcept
+    {
+        // The oldest rows go first. Their items may still be on the timeline; a structured search
+        // just won't find them any more
+        m_memoryStoreId = ::reactotron::MemoryGovernor::Shared().Register("searchIndex", [this](uint64_t bytes) -> uint64_t
+        {
+            std::lock_guard<std::mutex> lock(m_queryMutex);
+            uint64_t freed = m_columns.Shrink(bytes);
+            ReportMemory();
+            return freed;
+        });
+    }
+
+    IRTimelineQuery::~IRTimelineQuery() noexcept
+    {
+        ::reactotron::MemoryGovernor::Shared().Unregister(m_memoryStoreId);
+    }
+
+    double IRTimelineQuery::append(std::vector<std::string> strings, std::vector<double> numbers) noexcept
+    {
+        ::reactotron::TimelineRow row;
+        for (size_t i = 0; i < ::reactotron::kTimelineStringFields; ++i)
+        {
+            row.strings[i] = i < strings.size() ? std::string_view(strings[i]) : std::string_view();
+        }
+        for (size_t i = 0; i < ::reactotron::kTimelineNumberFields; ++i)
+        {
+            row.numbers[i] = i < numbers.size() ? numbers[i] : NAN;
+        }
+        std::lock_guard<std::mutex> lock(m_queryMutex);
+        uint32_t index = m_columns.Append(row);
+        if (index % kMemoryReportRows == 0)
+        {
+            ReportMemory();
+        }
+        return static_cast<double>(index);
+    }
+
+    Microsoft::ReactNative::JSValue IRTimelineQuery::compile(std::string query) noexcept
+    {
+        std::string error;
+        auto compiled = ::reactotron::TimelineQuery::Compile(query, error);
+
+        Microsoft::ReactNative::JSValueObject result;
+        Microsoft::ReactNative::JSValueArray text;
+        if (compiled)
+        {
+            for (const std::string &word : compiled->Text()) text.push_back(word);
+            std::lock_guard<std::mutex> lock(m_queryMutex);
+            uint32_t queryId = ++m_nextQueryId;
+            m_queries[queryId] = std::move(compiled);
+            result["queryId"] = static_cast<double>(queryId);
+        }
+        else
+        {
+            result["queryId"] = 0.0;
+        }
+        result["error"] = error;
+        result["text"] = std::move(text);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    Microsoft::ReactNative::JSValue IRTimelineQuery::evaluate(double queryId) noexcept
+    {
+        std::vector<uint32_t> rows;
+        bool restarted = false;
+        uint32_t firstRow;
+        {
+            std::lock_guard<std::mutex> lock(m_queryMutex);
+            auto it = m_queries.find(static_cast<uint32_t>(queryId));
+            if (it != m_queries.end()) restarted = !it->second->Evaluate(m_columns, rows);
+            firstRow = m_columns.FirstRow();
+        }
+
+        Microsoft::ReactNative::JSValueArray matches;
+        matches.reserve(rows.size());
+        for (uint32_t row : rows) matches.push_back(static_cast<double>(row));
+
+        Microsoft::ReactNative::JSValueObject result;
+        result["restarted"] = restarted;
+        result["rows"] = std::move(matches);
+        result["firstRow"] = static_cast<double>(firstRow);
+        return Microsoft::ReactNative::JSValue(std::move(result));
+    }
+
+    double IRTimelineQuery::dispose(double queryId) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_queryMutex);
+        return static_cast<double>(m_queries.erase(static_cast<uint32_t>(queryId)));
+    }
+
+    double IRTimelineQuery::clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_queryMutex);
+        size_t rows = m_columns.Rows();
+        m_columns.Clear();
+        ReportMemory();
+        return static_cast<double>(rows);
+    }
+
+    double IRTimelineQuery::dropBefore(double row) noexcept
+    {
+        if (!(row > 0)) return 0;
+        std::lock_guard<std::mutex> lock(m_queryMutex);
+        size_t dropped = m_columns.DropBefore(row < UINT32_MAX ? static_cast<uint32_t>(row) : UINT32_MAX);
+        if (dropped) ReportMemory();
+        return static_cast<double>(dropped);
+    }
+
+    void IRTimelineQuery::ReportMemory()
+    {
+        ::reactotron::MemoryGovernor::Shared().Report(m_memoryStoreId, m_columns.ByteSize(), m_columns.OldestTime());
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "NativeModules.h"
+#include "TimelineQuery.h"
+#include "../IRMemoryGovernor/MemoryGovernor.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace winrt::reactotron::implementation
+{
+    REACT_MODULE(IRTimelineQuery)
+    struct IRTimelineQuery
+    {
+        IRTimelineQuery() noexcept;
+        ~IRTimelineQuery() noexcept;
+
+        REACT_SYNC_METHOD(append)
+        double append(std::vector<std::string> strings, std::vector<double> numbers) noexcept;
+
+        REACT_SYNC_METHOD(compile)
+        Microsoft::ReactNative::JSValue compile(std::string query) noexcept;
+
+        REACT_SYNC_METHOD(evaluate)
+        Microsoft::ReactNative::JSValue evaluate(double queryId) noexcept;
+
+        REACT_SYNC_METHOD(dispose)
+        double dispose(double queryId) noexcept;
+
+        REACT_SYNC_METHOD(clear)
+        double clear() noexcept;
+
+        REACT_SYNC_METHOD(dropBefore)
+        double dropBefore(double row) noexcept;
+
+    private:
+        // Under m_queryMutex
+        void ReportMemory();
+
+        ::reactotron::TimelineColumns m_columns;
+        std::unordered_map<uint32_t, std::unique_ptr<::reactotron::TimelineQuery>> m_queries;
+        uint32_t m_nextQueryId = 0;
+        std::mutex m_queryMutex;
+        uint32_t m_memoryStoreId = 0;
+    };
+}
@@ -0,0 +1,39 @@
+import type { TurboModule } from "react-native"
+import { TurboModuleRegistry } from "react-native"
+
+export interface CompiledTimelineQuery {
+  /** 0 if the query didn't compile. */
+  queryId: number
+  error: string
+  /** Free-text words to match against the payloads, lower case; those to exclude start with "-". */
+  text: string[]
+}
+
+export interface TimelineQueryMatches {
+  /** The columns were cleared since the last call, so earlier matches are stale. */
+  restarted: boolean
+  /** Rows added since the last call that match, in order. */
+  rows: number[]
+  /** The oldest row still held; those before it were dropped and no longer match. */
+  firstRow: number
+}
+
+export interface Spec extends TurboModule {
+  /**
+   * Adds an item's filter fields and returns its row. `strings` are type, level, url, method,
+   * name and client ("" if missing); `numbers` are status, duration and time (NaN if missing).
+   */
+  append(strings: ReadonlyArray<string>, numbers: ReadonlyArray<number>): number
+  compile(query: string): CompiledTimelineQuery
+  evaluate(queryId: number): TimelineQueryMatches
+  /**
+   * These return a value so they run synchronously, in order with append(). dispose()
+   * returns 1 if the query existed; clear() and dropBefore() return how many rows were dropped.
+   */
+  dispose(queryId: number): number
+  clear(): number
+  /** Drops the rows before `row`, whose items have left the timeline. Later rows keep their numbers. */
+  dropBefore(row: number): number
+}
+
+export default TurboModuleRegistry.getEnforcing<Spec>("IRTimelineQuery")
@@ -0,0 +1,596 @@
+//
+//  TextPattern.cpp
+//  Reactotron
+//
+
+#include "TextPattern.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace reactotron {
+
+namespace {
+
+constexpr size_t kUnbounded = std::numeric_limits<size_t>::max();
+
+inline uint8_t LowerByte(uint8_t c) noexcept { return c >= 'A' && c <= 'Z' ? static_cast<uint8_t>(c + 32) : c; }
+
+inline bool IsWordByte(uint8_t c) noexcept {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline int HexDigit(char c) noexcept {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void AppendUtf8(uint32_t code, std::string &out) {
+  if (code < 0x80) {
+    out += static_cast<char>(code);
+  } else if (code < 0x800) {
+    out += static_cast<char>(0xC0 | (code >> 6));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else {
+    out += static_cast<char>(0xE0 | (code >> 12));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  }
+}
+
+/** \d \w \s, or their negations for the upper case letters. */
+std::bitset<256> EscapeClass(char escape) {
+  std::bitset<256> set;
+  switch (escape | 0x20) {
+    case 'd':
+      for (int c = '0'; c <= '9'; ++c) set.set(c);
+      break;
+    case 'w':
+      for (int c = 0; c < 256; ++c) {
+        if (IsWordByte(static_cast<uint8_t>(c))) set.set(c);
+      }
+      break;
+    case 's':
+      for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) set.set(static_cast<uint8_t>(c));
+      break;
+  }
+  if (escape >= 'A' && escape <= 'Z') set.flip();
+  return set;
+}
+
+} // namespace
+
+// Parsing
+
+class TextPattern::Parser {
+ public:
+  Parser(TextPattern &pattern, std::string_view source) : m_pattern(pattern), m_source(source) {}
+
+  bool Parse(std::string &error) {
+    uint32_t root;
+    if (!Alternation(0, root, error)) return false;
+    if (m_pos < m_source.size()) return Fail(error, "Unmatched )");
+    if (!Emit(root)) return Fail(error, "Pattern is too long");
+    Push({Op::Match});
+    return true;
+  }
+
+ private:
+  enum class Kind : uint8_t { Empty, Byte, Any, Class, Assert, Concat, Alternate, Repeat };
+
+  struct Node {
+    explicit Node(Kind kind, uint8_t byte = 0) : kind(kind), byte(byte) {}
+
+    Kind kind;
+    uint8_t byte;
+    Op assertion = Op::Match;
+    uint32_t index = 0;
+    size_t min = 0;
+    size_t max = 0;
+    std::vector<uint32_t> children;
+  };
+
+  /** What an escape stands for: some bytes in a row, one of a set of bytes, or a position. */
+  struct Escaped {
+    enum { Bytes, Set, Assertion } kind = Bytes;
+    std::string bytes;
+    std::bitset<256> set;
+    Op assertion = Op::Match;
+  };
+
+  static bool Fail(std::string &error, std::string message) {
+    error = std::move(message);
+    return false;
+  }
+
+  bool AtEnd() const { return m_pos >= m_source.size(); }
+  char Peek() const { return m_source[m_pos]; }
+
+  uint32_t Add(Node node) {
+    m_nodes.push_back(std::move(node));
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+  }
+
+  uint32_t AddBytes(std::string_view bytes) {
+    if (bytes.size() == 1) return Add(Node(Kind::Byte, static_cast<uint8_t>(bytes[0])));
+    Node concat(Kind::Concat);
+    for (char c : bytes) concat.children.push_back(Add(Node(Kind::Byte, static_cast<uint8_t>(c))));
+    return Add(std::move(concat));
+  }
+
+  uint32_t AddClass(std::bitset<256> set, bool negate) {
+    // Case is folded here, so matching a class needn't
+    for (int c = 'a'; c <= 'z'; ++c) {
+      if (set.test(c) || set.test(c - 32)) {
+        set.set(c);
+        set.set(c - 32);
+      }
+    }
+    if (negate) set.flip();
+    m_pattern.m_classes.push_back(set);
+    Node node(Kind::Class);
+    node.index = static_cast<uint32_t>(m_pattern.m_classes.size() - 1);
+    return Add(std::move(node));
+  }
+
+  bool Alternation(size_t depth, uint32_t &out, std::string &error) {
+    if (depth > kMaxNesting) return Fail(error, "Pattern is nested too deeply");
+    Node alternate(Kind::Alternate);
+    for (;;) {
+      uint32_t branch;
+      if (!Sequence(depth, branch, error)) return false;
+      alternate.children.push_back(branch);
+      if (AtEnd() || Peek() != '|') break;
+      ++m_pos;
+    }
+    out = alternate.children.size() == 1 ? alternate.children[0] : Add(std::move(alternate));
+    return true;
+  }
+
+  bool Sequence(size_t depth, uint32_t &out, std::string &error) {
+    Node concat(Kind::Concat);
+    while (!AtEnd() && Peek() != '|' && Peek() != ')') {
+      uint32_t atom;
+      if (!Atom(depth, atom, error) || !Quantifier(atom, error)) return false;
+      concat.children.push_back(atom);
+    }
+    if (concat.children.empty()) {
+      out = Add(Node(Kind::Empty));
+    } else {
+      out = concat.children.size() == 1 ? concat.children[0] : Add(std::move(concat));
+    }
+    return true;
+  }
+
+  bool Atom(size_t depth, uint32_t &out, std::string &error) {
+    char c = m_source[m_pos++];
+    switch (c) {
+      case '(': {
+        if (m_source.substr(m_pos, 2) == "?:") {
+          m_pos += 2;
+        } else if (m_source.substr(m_pos, 2) == "?<" && m_pos + 2 < m_source.size() && m_source[m_pos + 2] != '=' &&
+                   m_source[m_pos + 2] != '!') {
+          // A named group; the name doesn't matter to a search
+          size_t close = m_source.find('>', m_pos);
+          if (close == std::string_view::npos) return Fail(error, "Unterminated group name");
+          m_pos = close + 1;
+        } else if (!AtEnd() && Peek() == '?') {
+          return Fail(error, "Lookaround isn't supported");
+        }
+        if (!Alternation(depth + 1, out, error)) return false;
+        if (AtEnd()) return Fail(error, "Missing )");
+        ++m_pos;
+        return true;
+      }
+      case '[':
+        return Class(out, error);
+      case '.': {
+        out = Add(Node(Kind::Any));
+        return true;
+      }
+      case '^':
+      case '$': {
+        Node node(Kind::Assert);
+        node.assertion = c == '^' ? Op::LineStart : Op::LineEnd;
+        out = Add(std::move(node));
+        return true;
+      }
+      case '\\': {
+        Escaped escaped;
+        if (!Escape(false, escaped, error)) return false;
+        if (escaped.kind == Escaped::Set) {
+          out = AddClass(escaped.set, false);
+        } else if (escaped.kind == Escaped::Assertion) {
+          Node node(Kind::Assert);
+          node.assertion = escaped.assertion;
+          out = Add(std::move(node));
+        } else {
+          out = AddBytes(escaped.bytes);
+        }
+        return true;
+      }
+      case '*':
+      case '+':
+      case '?':
+        return Fail(error, "Nothing to repeat");
+      case '{': {
+        size_t min, max, end;
+        if (Braces(m_pos - 1, min, max, end)) return Fail(error, "Nothing to repeat");
+        break;
+      }
+      default:
+        break;
+    }
+    // A literal; a whole UTF-8 character, so a quantifier after it repeats all of it
+    size_t begin = m_pos - 1;
+    if (static_cast<uint8_t>(c) >= 0xC0) {
+      while (!AtEnd() && (static_cast<uint8_t>(Peek()) & 0xC0) == 0x80) ++m_pos;
+    }
+    out = AddBytes(m_source.substr(begin, m_pos - begin));
+    return true;
+  }
+
+  /** `{n}`, `{n,}` or `{n,m}` at `begin`; anything else there is a literal brace. */
+  bool Braces(size_t begin, size_t &min, size_t &max, size_t &end) const {
+    auto number = [&](size_t &pos, size_t &value) {
+      size_t start = pos;
+      value = 0;
+      while (pos < m_source.size() && m_source[pos] >= '0' && m_source[pos] <= '9') {
+        value = std::min(value * 10 + static_cast<size_t>(m_source[pos] - '0'), kMaxRepeat + 1);
+        ++pos;
+      }
+      return pos > start;
+    };
+    size_t pos = begin + 1;
+    if (!number(pos, min)) return false;
+    max = min;
+    if (pos < m_source.size() && m_source[pos] == ',') {
+      ++pos;
+      if (!number(pos, max)) max = kUnbounded;
+    }
+    if (pos >= m_source.size() || m_source[pos] != '}') return false;
+    end = pos + 1;
+    return true;
+  }
+
+  bool Quantifier(uint32_t &atom, std::string &error) {
+    if (AtEnd()) return true;
+    size_t min, max;
+    switch (Peek()) {
+      case '*':
+        min = 0, max = kUnbounded, ++m_pos;
+        break;
+      case '+':
+        min = 1, max = kUnbounded, ++m_pos;
+        break;
+      case '?':
+        min = 0, max = 1, ++m_pos;
+        break;
+      case '{': {
+        size_t end;
+        if (!Braces(m_pos, min, max, end)) return true;
+        m_pos = end;
+        break;
+      }
+      default:
+        return true;
+    }
+    if (m_nodes[atom].kind == Kind::Assert) return Fail(error, "Nothing to repeat");
+    if (min > kMaxRepeat || (max != kUnbounded && max > kMaxRepeat)) return Fail(error, "Repeat count is too large");
+    if (max < min) return Fail(error, "Repeat range is out of order");
+    // Lazy and greedy repeats match the same texts
+    if (!AtEnd() && Peek() == '?') ++m_pos;
+    Node repeat(Kind::Repeat);
+    repeat.min = min;
+    repeat.max = max;
+    repeat.children.push_back(atom);
+    atom = Add(std::move(repeat));
+    return true;
+  }
+
+  bool Class(uint32_t &out, std::string &error) {
+    bool negate = !AtEnd() && Peek() == '^';
+    if (negate) ++m_pos;
+    std::bitset<256> set;
+    for (;;) {
+      if (AtEnd()) return Fail(error, "Missing ]");
+      if (Peek() == ']') {
+        ++m_pos;
+        break;
+      }
+      Escaped low;
+      if (!ClassAtom(low, error)) return false;
+      bool range = m_pos + 1 < m_source.size() && Peek() == '-' && m_source[m_pos + 1] != ']';
+      if (!range) {
+        if (low.kind == Escaped::Set) {
+          set |= low.set;
+        } else {
+          for (char c : low.bytes) set.set(static_cast<uint8_t>(c));
+        }
+        continue;
+      }
+      ++m_pos;
+      Escaped high;
+      if (!ClassAtom(high, error)) return false;
+      if (low.kind != Escaped::Bytes || high.kind != Escaped::Bytes || low.bytes.size() != 1 ||
+          high.bytes.size() != 1) {
+        return Fail(error, "Invalid class range");
+      }
+      uint8_t from = static_cast<uint8_t>(low.bytes[0]);
+      uint8_t to = static_cast<uint8_t>(high.bytes[0]);
+      if (from > to) return Fail(error, "Class range is out of order");
+      for (unsigned c = from; c <= to; ++c) set.set(c);
+    }
+    out = AddClass(set, negate);
+    return true;
+  }
+
+  bool ClassAtom(Escaped &out, std::string &error) {
+    char c = m_source[m_pos++];
+    if (c == '\\') {
+      if (!Escape(true, out, error)) return false;
+      // Escaped UTF-8 characters are one of their bytes, as unescaped ones are
+      if (out.kind == Escaped::Bytes && out.bytes.size() > 1) {
+        out.kind = Escaped::Set;
+        for (char byte : out.bytes) out.set.set(static_cast<uint8_t>(byte));
+      }
+      return true;
+    }
+    out.bytes.assign(1, c);
+    return true;
+  }
+
+  bool Escape(bool inClass, Escaped &out, std::string &error) {
+    if (AtEnd()) return Fail(error, "Pattern ends with \\");
+    char c = m_source[m_pos++];
+    out.kind = Escaped::Bytes;
+    switch (c) {
+      case 'd':
+      case 'D':
+      case 'w':
+      case 'W':
+      case 's':
+      case 'S':
+        out.kind = Escaped::Set;
+        out.set = EscapeClass(c);
+        return true;
+      case 'b':
+      case 'B':
+        if (inClass) {
+          if (c == 'B') return Fail(error, "Invalid escape \\B in class");
+          out.bytes = "\b";
+          return true;
+        }
+        out.kind = Escaped::Assertion;
+        out.assertion = c == 'b' ? Op::WordBoundary : Op::NotWordBoundary;
+        return true;
+      case '0':
+        out.bytes.assign(1, '\0');
+        return true;
+      case 'n':
+        out.bytes = "\n";
+        return true;
+      case 'r':
+        out.bytes = "\r";
+        return true;
+      case 't':
+        out.bytes = "\t";
+        return true;
+      case 'f':
+        out.bytes = "\f";
+        return true;
+      case 'v':
+        out.bytes = "\v";
+        return true;
+      case 'x':
+      case 'u': {
+        size_t digits = c == 'x' ? 2 : 4;
+        uint32_t code = 0;
+        bool valid = m_pos + digits <= m_source.size();
+        for (size_t i = 0; valid && i < digits; ++i) {
+          int digit = HexDigit(m_source[m_pos + i]);
+          valid = digit >= 0;
+          code = code * 16 + static_cast<uint32_t>(digit);
+        }
+        if (!valid) {
+          out.bytes.assign(1, c);
+          return true;
+        }
+        m_pos += digits;
+        if (c == 'x') {
+          out.bytes.assign(1, static_cast<char>(code));
+        } else {
+          AppendUtf8(code, out.bytes);
+        }
+        return true;
+      }
+      case 'c':
+        if (!AtEnd() && ((Peek() >= 'a' && Peek() <= 'z') || (Peek() >= 'A' && Peek() <= 'Z'))) {
+          out.bytes.assign(1, static_cast<char>(m_source[m_pos++] % 32));
+        } else {
+          out.bytes = "\\c";
+        }
+        return true;
+      case 'k':
+        if (!AtEnd() && Peek() == '<') return Fail(error, "Back-references aren't supported");
+        out.bytes = "k";
+        return true;
+      default:
+        if (c >= '1' && c <= '9') return Fail(error, "Back-references aren't supported");
+        out.bytes.assign(1, c);
+        return true;
+    }
+  }
+
+  // Code generation
+
+  bool Push(Instruction instruction) {
+    if (m_pattern.m_program.size() >= kMaxInstructions) return false;
+    m_pattern.m_program.push_back(instruction);
+    return true;
+  }
+
+  uint32_t Here() const { return static_cast<uint32_t>(m_pattern.m_program.size()); }
+
+  bool Emit(uint32_t index) {
+    const Node &node = m_nodes[index];
+    auto &program = m_pattern.m_program;
+    switch (node.kind) {
+      case Kind::Empty:
+        return true;
+      case Kind::Byte:
+        return Push({Op::Byte, LowerByte(node.byte)});
+      case Kind::Any:
+        return Push({Op::Any});
+      case Kind::Class:
+        return Push({Op::Class, 0, node.index});
+      case Kind::Assert:
+        return Push({node.assertion});
+      case Kind::Concat:
+        for (uint32_t child : node.children) {
+          if (!Emit(child)) return false;
+        }
+        return true;
+      case Kind::Alternate: {
+        std::vector<uint32_t> jumps;
+        for (size_t i = 0; i < node.children.size(); ++i) {
+          uint32_t split = Here();
+          bool last = i + 1 == node.children.size();
+          if (!last && !Push({Op::Split, 0, split + 1})) return false;
+          if (!Emit(node.children[i])) return false;
+          if (last) break;
+          jumps.push_back(Here());
+          if (!Push({Op::Jump})) return false;
+          program[split].y = Here();
+        }
+        for (uint32_t jump : jumps) program[jump].x = Here();
+        return true;
+      }
+      case Kind::Repeat: {
+        uint32_t child = node.children[0];
+        // x{n,} is n-1 copies and then x+, so the last required copy is also the loop
+        size_t copies = node.max == kUnbounded && node.min > 0 ? node.min - 1 : node.min;
+        for (size_t i = 0; i < copies; ++i) {
+          if (!Emit(child)) return false;
+        }
+        if (node.max == kUnbounded) {
+          uint32_t start = Here();
+          if (node.min == 0) {
+            if (!Push({Op::Split, 0, start + 1})) return false;
+            if (!Emit(child) || !Push({Op::Jump, 0, start})) return false;
+            program[start].y = Here();
+          } else {
+            if (!Emit(child)) return false;
+            uint32_t split = Here();
+            if (!Push({Op::Split, 0, start, split + 1})) return false;
+          }
+          return true;
+        }
+        // Optional copies; skipping one skips the rest
+        std::vector<uint32_t> splits;
+        for (size_t i = node.min; i < node.max; ++i) {
+          splits.push_back(Here());
+          if (!Push({Op::Split, 0, Here() + 1})) return false;
+          if (!Emit(child)) return false;
+        }
+        for (uint32_t split : splits) program[split].y = Here();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  TextPattern &m_pattern;
+  std::string_view m_source;
+  size_t m_pos = 0;
+  std::vector<Node> m_nodes;
+};
+
+std::unique_ptr<TextPattern> TextPattern::Compile(std::string_view pattern, std::string &error) {
+  std::unique_ptr<TextPattern> compiled(new TextPattern());
+  if (!Parser(*compiled, pattern).Parse(error)) return nullptr;
+  return compiled;
+}
+
+// Matching
+
+bool TextPattern::Search(std::string_view text) const {
+  const size_t size = m_program.size();
+  std::vector<uint32_t> current, next, pending;
+  current.reserve(size);
+  next.reserve(size);
+  // The position each instruction was last added at, so it's added once per position
+  std::vector<size_t> added(size, kUnbounded);
+
+  // Follows jumps, splits and assertions from `pc` to the instructions that consume a byte
+  auto add = [&](std::vector<uint32_t> &list, uint32_t pc, size_t pos) {
+    pending.push_back(pc);
+    while (!pending.empty()) {
+      pc = pending.back();
+      pending.pop_back();
+      if (added[pc] == pos) continue;
+      added[pc] = pos;
+      const Instruction &instruction = m_program[pc];
+      switch (instruction.op) {
+        case Op::Jump:
+          pending.push_back(instruction.x);
+          break;
+        case Op::Split:
+          pending.push_back(instruction.y);
+          pending.push_back(instruction.x);
+          break;
+        case Op::LineStart:
+          if (pos == 0) pending.push_back(pc + 1);
+          break;
+        case Op::LineEnd:
+          if (pos == text.size()) pending.push_back(pc + 1);
+          break;
+        case Op::WordBoundary:
+        case Op::NotWordBoundary: {
+          bool before = pos > 0 && IsWordByte(static_cast<uint8_t>(text[pos - 1]));
+          bool after = pos < text.size() && IsWordByte(static_cast<uint8_t>(text[pos]));
+          if ((before != after) == (instruction.op == Op::WordBoundary)) pending.push_back(pc + 1);
+          break;
+        }
+        case Op::Match:
+          pending.clear();
+          return true;
+        default:
+          list.push_back(pc);
+          break;
+      }
+    }
+    return false;
+  };
+
+  for (size_t pos = 0;; ++pos) {
+    // A match may start at any position
+    if (add(current, 0, pos)) return true;
+    if (pos == text.size()) return false;
+    uint8_t byte = static_cast<uint8_t>(text[pos]);
+    next.clear();
+    for (uint32_t pc : current) {
+      const Instruction &instruction = m_program[pc];
+      bool matched = false;
+      switch (instruction.op) {
+        case Op::Byte:
+          matched = LowerByte(byte) == instruction.byte;
+          break;
+        case Op::Any:
+          matched = byte != '\n' && byte != '\r';
+          break;
+        case Op::Class:
+          matched = m_classes[instruction.x].test(byte);
+          break;
+        default:
+          break;
+      }
+      if (matched && add(next, pc + 1, pos + 1)) return true;
+    }
+    current.swap(next);
+  }
+}
+
+} // namespace reactotron
@@ -0,0 +1,61 @@
+#pragma once
+
+//
+//  TextPattern.h
+//  Reactotron
+//
+//  The regular expressions behind the `~` query operator. Patterns compile to
+//  a small NFA program that's run over the text a byte at a time, tracking
+//  every state it could be in at once, so matching takes time proportional to
+//  the text times the pattern and no stack, however long the text or however
+//  ambiguous the pattern.
+//
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reactotron {
+
+/**
+ * A case-insensitive regular expression in ECMAScript syntax: literals, `.`,
+ * classes, the \d \w \s escapes and their negations, \b and \B, `^` and `$`,
+ * groups, `|` and the `*` `+` `?` `{n,m}` quantifiers (lazy forms match the
+ * same). Back-references and lookaround aren't supported and fail to compile.
+ * Text is matched as bytes, and case is folded for ASCII letters only.
+ */
+class TextPattern {
+ public:
+  static constexpr size_t kMaxRepeat = 1000;
+  static constexpr size_t kMaxNesting = 64;
+  static constexpr size_t kMaxInstructions = 32768;
+
+  /** Compiles `pattern`, or returns null and says why in `error`. */
+  static std::unique_ptr<TextPattern> Compile(std::string_view pattern, std::string &error);
+
+  /** True if the pattern matches anywhere in `text`. Safe to call from several threads. */
+  bool Search(std::string_view text) const;
+
+ private:
+  enum class Op : uint8_t { Byte, Any, Class, Split, Jump, LineStart, LineEnd, WordBoundary, NotWordBoundary, Match };
+
+  struct Instruction {
+    Op op;
+    uint8_t byte = 0; // Byte: lower case
+    uint32_t x = 0;   // Class: index; Split and Jump: target
+    uint32_t y = 0;   // Split: second target
+  };
+
+  class Parser;
+
+  TextPattern() = default;
+
+  std::vector<Instruction> m_program;
+  std::vector<std::bitset<256>> m_classes;
+};
+
+} // namespace reactotron
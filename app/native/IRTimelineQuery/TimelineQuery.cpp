@@ -0,0 +1,662 @@
+//
+//  TimelineQuery.cpp
+//  Reactotron
+//
+
+#include "TimelineQuery.h"
+
+#include "../TaskExecutor/TaskExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace reactotron {
+
+namespace {
+
+inline unsigned LowestBit(uint64_t value) noexcept {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+constexpr size_t kBlockWords = TimelineQuery::kBlockRows / 64;
+constexpr size_t kMaxSegments = 8;
+constexpr size_t kMaxNesting = 64;
+
+struct FieldName {
+  std::string_view name;
+  TimelineField field;
+};
+
+constexpr FieldName kFieldNames[] = {
+    {"type", TimelineField::Type},         {"level", TimelineField::Level},
+    {"url", TimelineField::Url},           {"method", TimelineField::Method},
+    {"name", TimelineField::Name},         {"client", TimelineField::Client},
+    {"status", TimelineField::Status},     {"duration", TimelineField::Duration},
+    {"time", TimelineField::Time},
+};
+
+inline bool IsSpace(char c) noexcept { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool IsAlpha(char c) noexcept { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+inline bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+inline bool IsNumberField(TimelineField field) noexcept { return field >= TimelineField::Status; }
+
+inline size_t NumberIndex(TimelineField field) noexcept {
+  return static_cast<size_t>(field) - static_cast<size_t>(TimelineField::Status);
+}
+
+std::string Lower(std::string_view text) {
+  std::string lower(text);
+  for (char &c : lower) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c + ('a' - 'A'));
+  }
+  return lower;
+}
+
+bool Equals(std::string_view a, std::string_view b) noexcept {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] + 32) : a[i];
+    char y = b[i] >= 'A' && b[i] <= 'Z' ? static_cast<char>(b[i] + 32) : b[i];
+    if (x != y) return false;
+  }
+  return true;
+}
+
+/** Days since 1970-01-01 of a proleptic Gregorian date. */
+int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day) noexcept {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+  unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+/** "YYYY-MM-DD[THH:MM[:SS[.mmm]]][Z]" in ms since the epoch; local time unless it ends in Z. */
+bool ParseDate(std::string_view text, double &ms) {
+  size_t pos = 0;
+  auto digits = [&](size_t count, int &value) {
+    if (pos + count > text.size()) return false;
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (!IsDigit(text[pos + i])) return false;
+      value = value * 10 + (text[pos + i] - '0');
+    }
+    pos += count;
+    return true;
+  };
+  auto expect = [&](char c) { return pos < text.size() && text[pos++] == c; };
+
+  int year, month, day, hour = 0, minute = 0, second = 0, millis = 0;
+  if (!digits(4, year) || !expect('-') || !digits(2, month) || !expect('-') || !digits(2, day)) return false;
+  if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+  if (pos < text.size() && (text[pos] == 'T' || text[pos] == 't' || text[pos] == ' ')) {
+    ++pos;
+    if (!digits(2, hour) || !expect(':') || !digits(2, minute)) return false;
+    if (pos < text.size() && text[pos] == ':') {
+      ++pos;
+      if (!digits(2, second)) return false;
+      if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        if (!digits(3, millis)) return false;
+      }
+    }
+  }
+  bool utc = pos < text.size() && (text[pos] == 'Z' || text[pos] == 'z');
+  if (utc) ++pos;
+  if (pos != text.size()) return false;
+
+  if (utc) {
+    int64_t days = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    ms = static_cast<double>(((days * 24 + hour) * 60 + minute) * 60 + second) * 1000 + millis;
+    return true;
+  }
+  std::tm local = {};
+  local.tm_year = year - 1900;
+  local.tm_mon = month - 1;
+  local.tm_mday = day;
+  local.tm_hour = hour;
+  local.tm_min = minute;
+  local.tm_sec = second;
+  local.tm_isdst = -1;
+  std::time_t seconds = std::mktime(&local);
+  if (seconds == static_cast<std::time_t>(-1)) return false;
+  ms = static_cast<double>(seconds) * 1000 + millis;
+  return true;
+}
+
+/** A number with an optional unit: "ms" or "s" for durations. */
+bool ParseNumber(std::string_view text, TimelineField field, double &value) {
+  if (field == TimelineField::Time && ParseDate(text, value)) return true;
+  std::string number(text);
+  double scale = 1;
+  if (field == TimelineField::Duration) {
+    if (number.size() > 2 && number.compare(number.size() - 2, 2, "ms") == 0) {
+      number.resize(number.size() - 2);
+    } else if (number.size() > 1 && number.back() == 's') {
+      number.pop_back();
+      scale = 1000;
+    }
+  }
+  if (number.empty()) return false;
+  char *end = nullptr;
+  value = std::strtod(number.c_str(), &end);
+  if (end != number.c_str() + number.size() || !std::isfinite(value)) return false;
+  value *= scale;
+  return true;
+}
+
+} // namespace
+
+// Columns
+
+TimelineColumns::TimelineColumns() { Clear(); }
+
+uint32_t TimelineColumns::Append(const TimelineRow &row) {
+  for (size_t field = 0; field < kTimelineStringFields; ++field) {
+    StringColumn &column = m_strings[field];
+    std::string_view value = row.strings[field];
+    uint32_t id = 0;
+    if (!value.empty()) {
+      auto it = column.index.find(std::string(value));
+      if (it != column.index.end()) {
+        id = it->second;
+      } else {
+        id = static_cast<uint32_t>(column.values.size());
+        column.values.emplace_back(value);
+        column.index.emplace(value, id);
+        m_stringBytes += 2 * value.size();
+      }
+    }
+    column.ids.push_back(id);
+  }
+  for (size_t field = 0; field < kTimelineNumberFields; ++field) m_numbers[field].push_back(row.numbers[field]);
+  return EndRow() - 1;
+}
+
+void TimelineColumns::Clear() {
+  for (StringColumn &column : m_strings) {
+    column = StringColumn();
+    column.values.emplace_back();
+  }
+  for (auto &numbers : m_numbers) std::vector<double>().swap(numbers);
+  m_stringBytes = 0;
+  m_firstRow = 0;
+  m_generation++;
+}
+
+size_t TimelineColumns::DropBefore(uint32_t row) {
+  if (row <= m_firstRow) return 0;
+  size_t dropped = std::min<size_t>(row - m_firstRow, Rows());
+  if (dropped == 0) return 0;
+
+  // Copied into new vectors rather than erased, so the memory is given back
+  for (auto &numbers : m_numbers) {
+    std::vector<double>(numbers.begin() + static_cast<ptrdiff_t>(dropped), numbers.end()).swap(numbers);
+  }
+  m_stringBytes = 0;
+  for (StringColumn &column : m_strings) {
+    // The values still in use, renumbered in order of first use
+    StringColumn kept;
+    kept.values.emplace_back();
+    std::vector<uint32_t> renumbered(column.values.size(), 0);
+    kept.ids.reserve(column.ids.size() - dropped);
+    for (size_t i = dropped; i < column.ids.size(); ++i) {
+      uint32_t id = column.ids[i];
+      if (id != 0 && renumbered[id] == 0) {
+        renumbered[id] = static_cast<uint32_t>(kept.values.size());
+        kept.index.emplace(column.values[id], renumbered[id]);
+        kept.values.push_back(std::move(column.values[id]));
+        m_stringBytes += 2 * kept.values.back().size();
+      }
+      kept.ids.push_back(renumbered[id]);
+    }
+    column = std::move(kept);
+  }
+  m_firstRow += static_cast<uint32_t>(dropped);
+  m_valuesGeneration++;
+  return dropped;
+}
+
+uint64_t TimelineColumns::Shrink(uint64_t bytes) {
+  if (Rows() == 0 || bytes == 0) return 0;
+  size_t before = ByteSize();
+  size_t perRow = std::max<size_t>(1, before / Rows());
+  size_t rows = std::min<size_t>(Rows(), (bytes + perRow - 1) / perRow);
+  DropBefore(m_firstRow + static_cast<uint32_t>(rows));
+  return before - std::min(before, ByteSize());
+}
+
+int64_t TimelineColumns::OldestTime() const noexcept {
+  const auto &times = m_numbers[NumberIndex(TimelineField::Time)];
+  return times.empty() || !std::isfinite(times[0]) ? 0 : static_cast<int64_t>(times[0]);
+}
+
+size_t TimelineColumns::ByteSize() const noexcept {
+  size_t bytes = m_stringBytes;
+  for (const StringColumn &column : m_strings) {
+    bytes += column.ids.capacity() * sizeof(uint32_t) + column.values.capacity() * sizeof(std::string);
+    // A node per entry plus the bucket array
+    bytes += column.index.size() * (sizeof(std::string) + sizeof(uint32_t) + 2 * sizeof(void *));
+    bytes += column.index.bucket_count() * sizeof(void *);
+  }
+  for (const auto &numbers : m_numbers) bytes += numbers.capacity() * sizeof(double);
+  return bytes;
+}
+
+// Parsing
+
+/**
+ * Recursive descent straight to postfix. Precedence, loosest first: OR, then
+ * terms side by side (AND), then NOT / '-'.
+ */
+class TimelineQuery::Parser {
+ public:
+  Parser(TimelineQuery &query, std::string_view source) : m_query(query), m_source(source) {}
+
+  bool Parse(std::string &error) {
+    SkipSpace();
+    if (m_pos == m_source.size()) return true;
+    bool produced = false;
+    if (!Or(0, produced, error)) return false;
+    if (m_pos != m_source.size()) return Fail(error, "Unexpected ')'");
+    if (m_topLevelOr && !m_query.m_text.empty()) {
+      return Fail(error, "Free text can't be combined with OR; use a field, like url:text");
+    }
+    return true;
+  }
+
+ private:
+  bool Fail(std::string &error, std::string message) {
+    error = std::move(message);
+    return false;
+  }
+
+  void SkipSpace() {
+    while (m_pos < m_source.size() && IsSpace(m_source[m_pos])) ++m_pos;
+  }
+
+  /** Consumes `keyword` if it's the next whole word. */
+  bool Keyword(std::string_view keyword) {
+    SkipSpace();
+    if (m_source.substr(m_pos, keyword.size()) != keyword) return false;
+    size_t end = m_pos + keyword.size();
+    if (end < m_source.size() && !IsSpace(m_source[end]) && m_source[end] != '(') return false;
+    m_pos = end;
+    return true;
+  }
+
+  void Emit(Op op, uint32_t test = 0) {
+    m_query.m_program.push_back({op, test});
+    if (op == Op::Test) {
+      m_query.m_stackDepth = std::max(m_query.m_stackDepth, ++m_depth);
+    } else if (op != Op::Not) {
+      --m_depth;
+    }
+  }
+
+  bool Or(size_t nesting, bool &produced, std::string &error) {
+    if (!And(nesting, produced, error)) return false;
+    while (Keyword("OR")) {
+      if (nesting == 0) m_topLevelOr = true;
+      bool right = false;
+      if (!And(nesting, right, error)) return false;
+      if (!produced || !right) return Fail(error, "OR needs a field term on each side");
+      Emit(Op::Or);
+    }
+    return true;
+  }
+
+  bool And(size_t nesting, bool &produced, std::string &error) {
+    produced = false;
+    size_t terms = 0;
+    for (;;) {
+      SkipSpace();
+      if (m_pos == m_source.size() || m_source[m_pos] == ')') break;
+      if (Keyword("OR")) {
+        m_pos -= 2;
+        break;
+      }
+      if (Keyword("AND")) continue;
+      bool term = false;
+      if (!Unary(nesting, false, term, error)) return false;
+      if (term && produced) Emit(Op::And);
+      produced = produced || term;
+      ++terms;
+    }
+    if (!terms) return Fail(error, m_pos == m_source.size() ? "Query ends early" : "Empty parentheses");
+    return true;
+  }
+
+  /** `produced` is false for free text, which is recorded rather than emitted. */
+  bool Unary(size_t nesting, bool negated, bool &produced, std::string &error) {
+    SkipSpace();
+    bool minus = m_pos + 1 < m_source.size() && m_source[m_pos] == '-' && !IsSpace(m_source[m_pos + 1]);
+    if (minus || Keyword("NOT")) {
+      if (minus) ++m_pos;
+      if (!Unary(nesting, true, produced, error)) return false;
+      if (produced) {
+        Emit(Op::Not);
+      } else if (negated) {
+        return Fail(error, "Free text can only be excluded once");
+      } else {
+        m_query.m_text.back().insert(0, "-"); // Text to exclude
+      }
+      return true;
+    }
+
+    if (m_pos < m_source.size() && m_source[m_pos] == '(') {
+      if (nesting + 1 >= kMaxNesting) return Fail(error, "Too many nested parentheses");
+      ++m_pos;
+      if (!Or(nesting + 1, produced, error)) return false;
+      SkipSpace();
+      if (m_pos >= m_source.size() || m_source[m_pos] != ')') return Fail(error, "Missing ')'");
+      ++m_pos;
+      if (!produced) return Fail(error, "Free text can't be inside parentheses; use a field, like url:text");
+      return true;
+    }
+
+    if (m_pos == m_source.size() || m_source[m_pos] == ')') return Fail(error, "Query ends early");
+    if (!Term(produced, error)) return false;
+    if (!produced && nesting > 0) {
+      return Fail(error, "Free text can't be inside parentheses; use a field, like url:text");
+    }
+    return true;
+  }
+
+  /** A field term (emitted as a test) or a free-text word (recorded). */
+  bool Term(bool &produced, std::string &error) {
+    size_t start = m_pos;
+    size_t nameEnd = m_pos;
+    while (nameEnd < m_source.size() && IsAlpha(m_source[nameEnd])) ++nameEnd;
+    std::string_view name = m_source.substr(start, nameEnd - start);
+
+    const FieldName *field = nullptr;
+    for (const FieldName &candidate : kFieldNames) {
+      if (Equals(candidate.name, name)) field = &candidate;
+    }
+    m_pos = nameEnd;
+    Compare compare;
+    if (!field || !Operator(compare)) {
+      // Not a field term; the whole word is text
+      m_pos = start;
+      std::string text;
+      if (!Value(text, error)) return false;
+      if (text.empty()) return Fail(error, "Empty quotes");
+      m_query.m_text.push_back(Lower(text));
+      produced = false;
+      return true;
+    }
+
+    std::string value;
+    if (!Value(value, error)) return false;
+    if (value.empty()) return Fail(error, "Missing value for " + std::string(field->name));
+
+    Test test;
+    test.field = field->field;
+    test.compare = compare;
+    if (IsNumberField(test.field)) {
+      if (compare == Compare::Match) return Fail(error, std::string(field->name) + " is a number; use = < > instead of ~");
+      if (compare == Compare::Contains) test.compare = Compare::Equal;
+      if (!ParseNumber(value, test.field, test.number)) {
+        return Fail(error, "\"" + value + "\" is not a valid " + std::string(field->name));
+      }
+    } else {
+      if (compare != Compare::Contains && compare != Compare::Equal && compare != Compare::NotEqual &&
+          compare != Compare::Match) {
+        return Fail(error, std::string(field->name) + " is text; use : = != or ~");
+      }
+      test.text = Lower(value);
+      if (compare == Compare::Match) {
+        std::string patternError;
+        test.pattern = TextPattern::Compile(value, patternError);
+        if (!test.pattern) return Fail(error, "Invalid regex " + value + ": " + patternError);
+      }
+    }
+
+    m_query.m_tests.push_back(std::move(test));
+    Emit(Op::Test, static_cast<uint32_t>(m_query.m_tests.size() - 1));
+    produced = true;
+    return true;
+  }
+
+  bool Operator(Compare &compare) {
+    std::string_view rest = m_source.substr(m_pos);
+    static constexpr std::pair<std::string_view, Compare> kOperators[] = {
+        {">=", Compare::GreaterEqual}, {"<=", Compare::LessEqual}, {"!=", Compare::NotEqual},
+        {":", Compare::Contains},      {"=", Compare::Equal},      {">", Compare::Greater},
+        {"<", Compare::Less},          {"~", Compare::Match},
+    };
+    for (const auto &[text, op] : kOperators) {
+      if (rest.substr(0, text.size()) == text) {
+        m_pos += text.size();
+        compare = op;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** A "quoted" or bare value. Quotes allow \" and \; other escapes are kept for regexes. */
+  bool Value(std::string &value, std::string &error) {
+    if (m_pos < m_source.size() && m_source[m_pos] == '"') {
+      for (++m_pos; m_pos < m_source.size(); ++m_pos) {
+        char c = m_source[m_pos];
+        if (c == '"') {
+          ++m_pos;
+          return true;
+        }
+        if (c == '\\' && m_pos + 1 < m_source.size() &&
+            (m_source[m_pos + 1] == '"' || m_source[m_pos + 1] == '\\')) {
+          c = m_source[++m_pos];
+        }
+        value.push_back(c);
+      }
+      return Fail(error, "Missing closing quote");
+    }
+    while (m_pos < m_source.size() && !IsSpace(m_source[m_pos]) && m_source[m_pos] != ')') {
+      value.push_back(m_source[m_pos++]);
+    }
+    return true;
+  }
+
+  TimelineQuery &m_query;
+  std::string_view m_source;
+  size_t m_pos = 0;
+  size_t m_depth = 0;
+  bool m_topLevelOr = false;
+};
+
+std::unique_ptr<TimelineQuery> TimelineQuery::Compile(std::string_view source, std::string &error) {
+  std::unique_ptr<TimelineQuery> query(new TimelineQuery());
+  if (!Parser(*query, source).Parse(error)) return nullptr;
+  return query;
+}
+
+// Evaluation
+
+bool TimelineQuery::TestString(const Test &test, const std::string &value) const {
+  switch (test.compare) {
+    case Compare::Contains:
+      return Lower(value).find(test.text) != std::string::npos;
+    case Compare::Equal:
+      return Equals(value, test.text);
+    case Compare::NotEqual:
+      return !Equals(value, test.text);
+    case Compare::Match:
+      return test.pattern->Search(value);
+    default:
+      return false;
+  }
+}
+
+void TimelineQuery::EvaluateBlock(const TimelineColumns &columns, size_t begin, size_t end,
+                                  std::vector<uint32_t> &out) const {
+  const uint32_t firstRow = columns.FirstRow();
+  size_t rows = end - begin;
+  size_t words = (rows + 63) / 64;
+  std::vector<uint64_t> stack(std::max<size_t>(m_stackDepth, 1) * kBlockWords);
+  size_t depth = 0;
+
+  for (const Instruction &instruction : m_program) {
+    // Tests push; NOT works on the top; AND and OR fold the top into the one below
+    size_t operands = instruction.op == Op::Test ? 0 : instruction.op == Op::Not ? 1 : 2;
+    uint64_t *top = stack.data() + (depth - operands) * kBlockWords;
+    switch (instruction.op) {
+      case Op::Test: {
+        const Test &test = m_tests[instruction.test];
+        if (IsNumberField(test.field)) {
+          const double *values = columns.Numbers(NumberIndex(test.field)).data() + begin;
+          double x = test.number;
+          for (size_t w = 0; w < words; ++w) {
+            uint64_t word = 0;
+            size_t count = std::min<size_t>(64, rows - w * 64);
+            for (size_t b = 0; b < count; ++b) {
+              double v = values[w * 64 + b];
+              bool hit;
+              switch (test.compare) {
+                case Compare::Equal: hit = v == x; break;
+                case Compare::NotEqual: hit = v == v && v != x; break;
+                case Compare::Less: hit = v < x; break;
+                case Compare::LessEqual: hit = v <= x; break;
+                case Compare::Greater: hit = v > x; break;
+                default: hit = v >= x; break;
+              }
+              word |= uint64_t(hit) << b;
+            }
+            top[w] = word;
+          }
+        } else {
+          const uint32_t *ids = columns.StringIds(static_cast<size_t>(test.field)).data() + begin;
+          const uint8_t *memo = test.memo.data();
+          for (size_t w = 0; w < words; ++w) {
+            uint64_t word = 0;
+            size_t count = std::min<size_t>(64, rows - w * 64);
+            for (size_t b = 0; b < count; ++b) word |= uint64_t(memo[ids[w * 64 + b]]) << b;
+            top[w] = word;
+          }
+        }
+        ++depth;
+        break;
+      }
+      case Op::Not:
+        for (size_t w = 0; w < words; ++w) top[w] = ~top[w];
+        if (rows % 64) top[words - 1] &= (uint64_t(1) << (rows % 64)) - 1;
+        break;
+      case Op::And: {
+        const uint64_t *right = top + kBlockWords;
+        for (size_t w = 0; w < words; ++w) top[w] &= right[w];
+        --depth;
+        break;
+      }
+      case Op::Or: {
+        const uint64_t *right = top + kBlockWords;
+        for (size_t w = 0; w < words; ++w) top[w] |= right[w];
+        --depth;
+        break;
+      }
+    }
+  }
+
+  const uint64_t *result = stack.data();
+  for (size_t w = 0; w < words; ++w) {
+    for (uint64_t word = result[w]; word; word &= word - 1) {
+      out.push_back(firstRow + static_cast<uint32_t>(begin + w * 64 + LowestBit(word)));
+    }
+  }
+}
+
+bool TimelineQuery::Evaluate(const TimelineColumns &columns, std::vector<uint32_t> &out, size_t threads) {
+  bool continued = m_generation == columns.Generation();
+  if (!continued) {
+    m_generation = columns.Generation();
+    m_rows = 0;
+  }
+  if (!continued || m_valuesGeneration != columns.ValuesGeneration()) {
+    m_valuesGeneration = columns.ValuesGeneration();
+    for (Test &test : m_tests) test.memo.clear();
+  }
+  // Positions in the columns; rows dropped before they were evaluated are skipped
+  size_t firstRow = columns.FirstRow();
+  size_t begin = std::max(m_rows, firstRow) - firstRow;
+  size_t end = columns.Rows();
+  m_rows = columns.EndRow();
+  if (begin >= end) return continued;
+
+  if (m_program.empty()) {
+    for (size_t row = begin; row < end; ++row) out.push_back(static_cast<uint32_t>(firstRow + row));
+    return continued;
+  }
+
+  // String tests run once per new distinct value, before any threads start
+  for (Test &test : m_tests) {
+    if (IsNumberField(test.field)) continue;
+    const auto &values = columns.StringValues(static_cast<size_t>(test.field));
+    for (size_t id = test.memo.size(); id < values.size(); ++id) {
+      test.memo.push_back(id != 0 && TestString(test, values[id]));
+    }
+  }
+
+  size_t blocks = (end - begin + kBlockRows - 1) / kBlockRows;
+  if (!threads) threads = TaskExecutor::Shared().Threads();
+  size_t segments = std::min({threads, kMaxSegments, blocks});
+  if (end - begin < kParallelRows || segments <= 1) {
+    for (size_t block = begin; block < end; block += kBlockRows) {
+      EvaluateBlock(columns, block, std::min(block + kBlockRows, end), out);
+    }
+    return continued;
+  }
+
+  // Contiguous runs of blocks per segment, so the results concatenate in order. The shared
+  // executor's workers and this thread claim segments until none are left, so this never waits
+  // on a segment that hasn't started, even when called from a worker. A task that starts after
+  // they're all claimed returns without touching anything but the shared state.
+  struct Segments {
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t finished = 0;
+  };
+  auto shared = std::make_shared<Segments>();
+  std::vector<std::vector<uint32_t>> results(segments);
+  size_t blocksPerSegment = (blocks + segments - 1) / segments;
+  auto runSegments = [this, &columns, &results, shared, segments, begin, end, blocksPerSegment] {
+    for (size_t s = shared->next++; s < segments; s = shared->next++) {
+      size_t first = std::min(end, begin + s * blocksPerSegment * kBlockRows);
+      size_t last = std::min(end, first + blocksPerSegment * kBlockRows);
+      for (size_t block = first; block < last; block += kBlockRows) {
+        EvaluateBlock(columns, block, std::min(block + kBlockRows, last), results[s]);
+      }
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      if (++shared->finished == segments) shared->done.notify_one();
+    }
+  };
+  // Evaluate runs synchronously for the JS thread, so the UI is waiting on it
+  for (size_t t = 1; t < segments; ++t) {
+    TaskExecutor::Shared().Post(TaskPriority::Critical, runSegments);
+  }
+  runSegments();
+  {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->done.wait(lock, [&] { return shared->finished == segments; });
+  }
+  for (const auto &result : results) out.insert(out.end(), result.begin(), result.end());
+  return continued;
+}
+
+} // namespace reactotron
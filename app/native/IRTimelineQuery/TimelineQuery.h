@@ -0,0 +1,182 @@
+#pragma once
+
+//
+//  TimelineQuery.h
+//  Reactotron
+//
+//  Structured timeline filters, e.g.
+//
+//    type:api.response status>=400 url~"/users/\d+" duration>500
+//    level:error OR (type:benchmark -name:startup)
+//
+//  The fields each item is filtered on are extracted once at ingest into
+//  columns. A query compiles to a small postfix program that runs a column at
+//  a time over blocks of rows, combining 64 rows per word, so evaluating it
+//  never touches the items themselves. Compiled queries remember how far they
+//  got, so new items only cost their own rows, and large backlogs are split
+//  across the shared TaskExecutor's workers.
+//
+
+#include "TextPattern.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace reactotron {
+
+enum class TimelineField : uint8_t {
+  // Strings
+  Type,
+  Level,
+  Url,
+  Method,
+  Name,
+  Client,
+  // Numbers
+  Status,
+  Duration,
+  Time, // ms since the epoch
+};
+
+constexpr size_t kTimelineStringFields = 6;
+constexpr size_t kTimelineNumberFields = 3;
+
+/** One item's fields; empty strings and NaN numbers are missing. */
+struct TimelineRow {
+  std::string_view strings[kTimelineStringFields];
+  double numbers[kTimelineNumberFields];
+};
+
+/**
+ * The extracted fields, one column per field. Strings are dictionary-encoded,
+ * so a string test runs once per distinct value, not once per row.
+ *
+ * Rows are numbered for the session, from 0 after each Clear(). The oldest
+ * can be dropped, as the timeline evicts their items; the rest keep their
+ * numbers, and only rows from FirstRow() on are held.
+ *
+ * Not thread-safe.
+ */
+class TimelineColumns {
+ public:
+  TimelineColumns();
+
+  /** Returns the row's number. */
+  uint32_t Append(const TimelineRow &row);
+  void Clear();
+  /**
+   * Drops the rows numbered below `row` and the string values only they used.
+   * Returns how many rows were dropped.
+   */
+  size_t DropBefore(uint32_t row);
+  /** Drops the oldest rows, about `bytes` worth, for the memory governor. Returns the bytes freed. */
+  uint64_t Shrink(uint64_t bytes);
+
+  /** Rows held. */
+  size_t Rows() const noexcept { return m_numbers[0].size(); }
+  /** The number of the oldest row held, so row `n` is at position `n - FirstRow()` in the columns. */
+  uint32_t FirstRow() const noexcept { return m_firstRow; }
+  /** One past the newest row's number. */
+  uint32_t EndRow() const noexcept { return m_firstRow + static_cast<uint32_t>(Rows()); }
+  /** Estimated memory held, for the memory governor. */
+  size_t ByteSize() const noexcept;
+  /** The oldest row's time, ms since the epoch, or 0 if it has none. */
+  int64_t OldestTime() const noexcept;
+
+  // Column access for TimelineQuery
+  const std::vector<uint32_t> &StringIds(size_t field) const noexcept { return m_strings[field].ids; }
+  const std::vector<std::string> &StringValues(size_t field) const noexcept { return m_strings[field].values; }
+  const std::vector<double> &Numbers(size_t field) const noexcept { return m_numbers[field]; }
+  /** Bumped by Clear(), so compiled queries know to start over. */
+  uint64_t Generation() const noexcept { return m_generation; }
+  /** Bumped when DropBefore() renumbers the string values, so compiled queries test them again. */
+  uint64_t ValuesGeneration() const noexcept { return m_valuesGeneration; }
+
+ private:
+  struct StringColumn {
+    std::vector<uint32_t> ids;
+    std::vector<std::string> values; // values[0] is "", for missing
+    std::unordered_map<std::string, uint32_t> index;
+  };
+
+  StringColumn m_strings[kTimelineStringFields];
+  std::vector<double> m_numbers[kTimelineNumberFields];
+  uint64_t m_generation = 0;
+  uint64_t m_valuesGeneration = 0;
+  uint32_t m_firstRow = 0;
+  size_t m_stringBytes = 0; // Of the distinct values, counting their copy in the index
+};
+
+/**
+ * A compiled query. Terms are `field` `op` `value`, with ops `:` (contains,
+ * or equals for numbers), `=`, `!=`, `>`, `>=`, `<`, `<=` and `~` (regex,
+ * see TextPattern). Terms side by side must all hold; OR, NOT or a leading
+ * `-`, and parentheses combine them. Words that aren't field terms are free
+ * text, which the caller matches against the payload; they may only appear at
+ * the top level.
+ *
+ * Compiling and evaluating are not thread-safe; evaluation hands segments of a
+ * large backlog to the shared TaskExecutor and works on them itself too.
+ */
+class TimelineQuery {
+ public:
+  static constexpr size_t kBlockRows = 4096;
+  static constexpr size_t kParallelRows = 64 * 1024; // Fewer new rows are evaluated on the calling thread
+
+  /** Returns null and sets `error` if `source` doesn't parse. */
+  static std::unique_ptr<TimelineQuery> Compile(std::string_view source, std::string &error);
+
+  /** Free-text words, lower case; those to exclude start with '-'. */
+  const std::vector<std::string> &Text() const noexcept { return m_text; }
+  /** False if the query is only free text, so every row matches. */
+  bool HasTerms() const noexcept { return !m_program.empty(); }
+
+  /**
+   * Evaluates the rows added since the last call (all rows the first time, or
+   * after the columns were cleared) and appends the numbers of the matching
+   * ones to `out`, in order. Returns false if it started over, so earlier
+   * matches are stale. Dropped rows don't make it start over. `threads` caps
+   * the segments a large backlog is split into; 0 uses one per executor worker.
+   */
+  bool Evaluate(const TimelineColumns &columns, std::vector<uint32_t> &out, size_t threads = 0);
+
+ private:
+  enum class Op : uint8_t { Test, And, Or, Not };
+  enum class Compare : uint8_t { Contains, Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Match };
+
+  struct Test {
+    TimelineField field;
+    Compare compare;
+    std::string text; // Lower case
+    double number = 0;
+    std::shared_ptr<TextPattern> pattern;
+    std::vector<uint8_t> memo; // String tests: result per dictionary value
+  };
+
+  struct Instruction {
+    Op op;
+    uint32_t test = 0;
+  };
+
+  class Parser;
+
+  TimelineQuery() = default;
+  bool TestString(const Test &test, const std::string &value) const;
+  /** Evaluates the rows at positions `begin` to `end` in the columns. */
+  void EvaluateBlock(const TimelineColumns &columns, size_t begin, size_t end, std::vector<uint32_t> &out) const;
+
+  std::vector<Test> m_tests;
+  std::vector<Instruction> m_program; // Postfix
+  size_t m_stackDepth = 0;
+  std::vector<std::string> m_text;
+  size_t m_rows = 0; // Rows numbered below this have been evaluated
+  uint64_t m_generation = 0;
+  uint64_t m_valuesGeneration = 0;
+};
+
+} // namespace reactotron
@@ -0,0 +1,170 @@
+//
+//  TaskExecutor.cpp
+//  Reactotron
+//
+
+#include "TaskExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace reactotron {
+
+namespace {
+
+uint64_t NowMicros() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+} // namespace
+
+TaskExecutor &TaskExecutor::Shared() {
+  static TaskExecutor *shared = new TaskExecutor(); // Never destroyed, so work running at exit isn't joined
+  return *shared;
+}
+
+TaskExecutor::TaskExecutor(size_t threads) {
+  if (threads == 0) threads = DefaultThreads();
+  threads = std::clamp<size_t>(threads, 2, kMaxThreads);
+  m_lanes[static_cast<size_t>(TaskPriority::Critical)].limit = threads;
+  m_lanes[static_cast<size_t>(TaskPriority::Interactive)].limit = threads - 1;
+  m_lanes[static_cast<size_t>(TaskPriority::Background)].limit = std::max<size_t>(1, threads / 2);
+  for (size_t i = 0; i < threads; ++i) m_threads.emplace_back(&TaskExecutor::Run, this);
+}
+
+TaskExecutor::~TaskExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+    for (Lane &lane : m_lanes) {
+      for (Task &task : lane.queue) task.token.Cancel();
+    }
+  }
+  m_wake.notify_all();
+  for (std::thread &thread : m_threads) thread.join();
+}
+
+size_t TaskExecutor::DefaultThreads() {
+  size_t cores = std::thread::hardware_concurrency();
+  return std::clamp<size_t>(cores * 2, 2, kMaxThreads);
+}
+
+size_t TaskExecutor::LaneLimit(TaskPriority priority) const noexcept {
+  return m_lanes[static_cast<size_t>(priority)].limit;
+}
+
+void TaskExecutor::Post(TaskPriority priority, std::function<void()> work, CancellationToken token) {
+  Enqueue(priority, std::move(token), [work = std::move(work)](bool cancelled) -> TaskStatus {
+    if (cancelled) return TaskStatus::Cancelled;
+    try {
+      work();
+    } catch (...) {
+      return TaskStatus::Failed;
+    }
+    return TaskStatus::Completed;
+  });
+}
+
+void TaskExecutor::Enqueue(TaskPriority priority, CancellationToken token, TaskRun run) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Lane &lane = m_lanes[static_cast<size_t>(priority)];
+    if (m_stopping) token.Cancel();
+    lane.queue.push_back(Task{std::move(run), std::move(token), NowMicros()});
+    lane.stats.queued = lane.queue.size();
+  }
+  m_wake.notify_one();
+}
+
+int TaskExecutor::NextLane(uint64_t now) const {
+  // A lane's limit covers the lanes below it too, so a lane may start a task only if it and
+  // every lane above it are under their limits. That way Background work can't take the worker
+  // Interactive leaves free for Critical.
+  size_t runningAtOrBelow[kTaskPriorityCount];
+  size_t running = 0;
+  for (size_t i = kTaskPriorityCount; i-- > 0;) {
+    running += m_lanes[i].running;
+    runningAtOrBelow[i] = running;
+  }
+
+  int next = -1;
+  int starved = -1; // The lane whose front has waited longest past the limit
+  uint64_t longestWait = kStarvationLimitMicros;
+  bool full = false; // This lane or one above it is at its limit
+  for (size_t i = 0; i < kTaskPriorityCount; ++i) {
+    const Lane &lane = m_lanes[i];
+    full = full || runningAtOrBelow[i] >= lane.limit;
+    if (lane.queue.empty()) continue;
+    if (lane.queue.front().token.IsCancelled()) return static_cast<int>(i);
+    if (full) continue;
+    if (next < 0) next = static_cast<int>(i);
+    // Longest wait rather than highest lane, so fronts that are all past the limit still take turns
+    uint64_t wait = now - std::min(now, lane.queue.front().queuedAt);
+    if (wait > longestWait) {
+      starved = static_cast<int>(i);
+      longestWait = wait;
+    }
+  }
+  return starved >= 0 ? starved : next;
+}
+
+void TaskExecutor::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    int index = -1;
+    m_wake.wait(lock, [&] {
+      index = NextLane(NowMicros());
+      return index >= 0 || (m_stopping && std::all_of(m_lanes.begin(), m_lanes.end(), [](const Lane &lane) {
+                                            return lane.queue.empty();
+                                          }));
+    });
+    if (index < 0) return;
+
+    Lane &lane = m_lanes[static_cast<size_t>(index)];
+    Task task = std::move(lane.queue.front());
+    lane.queue.pop_front();
+    lane.stats.queued = lane.queue.size();
+    bool cancelled = task.token.IsCancelled();
+    if (!cancelled) {
+      uint64_t wait = NowMicros() - task.queuedAt;
+      lane.stats.totalWaitMicros += wait;
+      lane.stats.maxWaitMicros = std::max(lane.stats.maxWaitMicros, wait);
+      ++lane.running;
+    }
+    lock.unlock();
+
+    TaskStatus status = task.run(cancelled);
+    task.run = nullptr; // Release what it captured before taking the lock
+
+    lock.lock();
+    if (!cancelled) --lane.running;
+    switch (status) {
+      case TaskStatus::Completed:
+        ++lane.stats.completed;
+        break;
+      case TaskStatus::Cancelled:
+        ++lane.stats.cancelled;
+        break;
+      case TaskStatus::Failed:
+        ++lane.stats.failed;
+        break;
+    }
+    // A worker slot in this lane freed up, which a waiting worker may have been held back by
+    if (!cancelled && !lane.queue.empty()) m_wake.notify_one();
+  }
+}
+
+TaskExecutorStats TaskExecutor::Stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TaskExecutorStats stats;
+  stats.threads = m_threads.size();
+  for (size_t i = 0; i < kTaskPriorityCount; ++i) {
+    stats.lanes[i] = m_lanes[i].stats;
+    stats.lanes[i].running = m_lanes[i].running;
+  }
+  return stats;
+}
+
+} // namespace reactotron
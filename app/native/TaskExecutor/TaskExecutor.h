@@ -0,0 +1,187 @@
+#pragma once
+
+//
+//  TaskExecutor.h
+//  Reactotron
+//
+//  One bounded pool of worker threads that the modules hand their off-thread
+//  work to, instead of each spinning up blocks on global queues or threads of
+//  its own. Work is queued in three lanes by priority. A free worker takes
+//  the oldest task from the highest lane that has one, unless a task at the
+//  front of a lane has waited longer than kStarvationLimitMicros; then the
+//  one that has waited longest goes first, whatever its lane.
+//
+//  Lanes may only occupy so many workers at once: Background at most half of
+//  them, and Interactive and Background together all but one. So a burst of
+//  slow background work (a shell command, an export) can't hold up what the
+//  user is waiting on, and Critical work always finds a worker.
+//
+//  Tasks carry a CancellationToken. A task cancelled before it starts never
+//  runs; its completion is told it was cancelled once a worker reaches it. A
+//  running task can check the token and stop early.
+//
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace reactotron {
+
+enum class TaskPriority : uint8_t {
+  Critical,    // The UI is blocked on it
+  Interactive, // The user asked for it and is waiting
+  Background,  // Nobody is waiting on it
+};
+
+constexpr size_t kTaskPriorityCount = 3;
+
+/**
+ * Shared between whoever may cancel a task and the task itself. Copies refer
+ * to the same state. Thread-safe.
+ */
+class CancellationToken {
+ public:
+  CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void Cancel() noexcept { m_cancelled->store(true, std::memory_order_release); }
+  bool IsCancelled() const noexcept { return m_cancelled->load(std::memory_order_acquire); }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+enum class TaskStatus : uint8_t {
+  Completed,
+  Cancelled, // Before it started
+  Failed,    // It threw
+};
+
+template <typename Result>
+struct TaskOutcome {
+  TaskStatus status = TaskStatus::Completed;
+  Result value{};    // If Completed
+  std::string error; // If Failed: what it threw
+};
+
+struct TaskLaneStats {
+  size_t queued = 0;
+  size_t running = 0;
+  uint64_t completed = 0;
+  uint64_t cancelled = 0;
+  uint64_t failed = 0;
+  uint64_t totalWaitMicros = 0; // From Submit() to starting, over every task started
+  uint64_t maxWaitMicros = 0;
+};
+
+struct TaskExecutorStats {
+  size_t threads = 0;
+  std::array<TaskLaneStats, kTaskPriorityCount> lanes;
+};
+
+/**
+ * The executor; Shared() is the one the modules submit to. Thread-safe.
+ * Completions run on the worker that ran the task, so they should only hand
+ * the result on (resolve a promise, emit an event).
+ */
+class TaskExecutor {
+ public:
+  static constexpr size_t kMaxThreads = 8;
+  /** How long a task may wait behind higher lanes before it goes first. */
+  static constexpr uint64_t kStarvationLimitMicros = 250 * 1000;
+
+  static TaskExecutor &Shared();
+
+  /** 0 threads picks from the number of cores. At least 2, so Critical work always has one. */
+  explicit TaskExecutor(size_t threads = 0);
+  /** Cancels whatever hasn't started and waits for what has. */
+  ~TaskExecutor();
+  TaskExecutor(const TaskExecutor &) = delete;
+  TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+  /**
+   * Runs `work(token)` and passes what it returns, or why it didn't, to
+   * `complete`. Exceptions `work` throws become a Failed outcome.
+   */
+  template <typename Work, typename Complete>
+  void Submit(TaskPriority priority, CancellationToken token, Work work, Complete complete) {
+    using Result = std::invoke_result_t<Work &, const CancellationToken &>;
+    static_assert(!std::is_void_v<Result>, "Use Post() for work that returns nothing");
+    Enqueue(priority, token,
+            [token, work = std::move(work), complete = std::move(complete)](bool cancelled) mutable -> TaskStatus {
+              TaskOutcome<Result> outcome;
+              if (cancelled) {
+                outcome.status = TaskStatus::Cancelled;
+              } else {
+                try {
+                  outcome.value = work(token);
+                } catch (const std::exception &e) {
+                  outcome.status = TaskStatus::Failed;
+                  outcome.error = e.what();
+                } catch (...) {
+                  outcome.status = TaskStatus::Failed;
+                  outcome.error = "Unknown error";
+                }
+              }
+              TaskStatus status = outcome.status;
+              complete(std::move(outcome));
+              return status;
+            });
+  }
+
+  /** Runs `work` unless `token` is cancelled first. What it throws is counted and dropped. */
+  void Post(TaskPriority priority, std::function<void()> work, CancellationToken token = CancellationToken());
+
+  size_t Threads() const noexcept { return m_threads.size(); }
+  /** How many workers `priority` and the lanes below it may occupy at once. */
+  size_t LaneLimit(TaskPriority priority) const noexcept;
+  TaskExecutorStats Stats() const;
+
+  /** Twice the cores, capped at kMaxThreads: the modules' work often waits on processes or files. */
+  static size_t DefaultThreads();
+
+ private:
+  /** Runs the task, or tells it it was cancelled, and returns how it went. */
+  using TaskRun = std::function<TaskStatus(bool cancelled)>;
+
+  struct Task {
+    TaskRun run;
+    CancellationToken token;
+    uint64_t queuedAt = 0; // Microseconds on the steady clock
+  };
+
+  struct Lane {
+    std::deque<Task> queue;
+    size_t running = 0;
+    size_t limit = 0;
+    TaskLaneStats stats;
+  };
+
+  void Enqueue(TaskPriority priority, CancellationToken token, TaskRun run);
+  void Run();
+  /**
+   * The lane to take a task from next, or -1. A cancelled task at the front
+   * of a lane is taken whatever the lane's limit, as it won't run. Call with
+   * m_mutex held.
+   */
+  int NextLane(uint64_t now) const;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::array<Lane, kTaskPriorityCount> m_lanes;
+  bool m_stopping = false;
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace reactotron
@@ -0,0 +1,466 @@
+//
+//  TextTranscoding.cpp
+//  Reactotron
+//
+
+#include "TextTranscoding.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IR_TRANSCODE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define IR_TRANSCODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit AVX2 inside functions that opt in; MSVC allows the intrinsics anywhere.
+#if defined(IR_TRANSCODE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define IR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define IR_TARGET_AVX2
+#endif
+
+namespace reactotron {
+
+namespace {
+
+constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+inline bool IsContinuation(uint8_t b) noexcept { return (b & 0xC0) == 0x80; }
+
+/**
+ * Decodes one code point from `p`. Always consumes at least one byte; an invalid or
+ * truncated sequence consumes exactly one byte and yields U+FFFD.
+ */
+inline size_t DecodeUtf8(const uint8_t *p, size_t avail, uint32_t &cp, bool &valid) noexcept {
+  uint8_t b0 = p[0];
+  valid = true;
+  if (b0 < 0x80) {
+    cp = b0;
+    return 1;
+  }
+  if (b0 >= 0xC2 && b0 < 0xE0) {
+    if (avail >= 2 && IsContinuation(p[1])) {
+      cp = (uint32_t(b0 & 0x1F) << 6) | (p[1] & 0x3F);
+      return 2;
+    }
+  } else if (b0 >= 0xE0 && b0 < 0xF0) {
+    if (avail >= 3) {
+      uint8_t lo = b0 == 0xE0 ? 0xA0 : 0x80;
+      uint8_t hi = b0 == 0xED ? 0x9F : 0xBF;
+      if (p[1] >= lo && p[1] <= hi && IsContinuation(p[2])) {
+        cp = (uint32_t(b0 & 0x0F) << 12) | (uint32_t(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        return 3;
+      }
+    }
+  } else if (b0 >= 0xF0 && b0 < 0xF5) {
+    if (avail >= 4) {
+      uint8_t lo = b0 == 0xF0 ? 0x90 : 0x80;
+      uint8_t hi = b0 == 0xF4 ? 0x8F : 0xBF;
+      if (p[1] >= lo && p[1] <= hi && IsContinuation(p[2]) && IsContinuation(p[3])) {
+        cp = (uint32_t(b0 & 0x07) << 18) | (uint32_t(p[1] & 0x3F) << 12) | (uint32_t(p[2] & 0x3F) << 6) |
+             (p[3] & 0x3F);
+        return 4;
+      }
+    }
+  }
+  valid = false;
+  cp = kReplacementCharacter;
+  return 1;
+}
+
+/**
+ * Decodes one code point from UTF-16. Lone surrogates yield U+FFFD.
+ */
+inline size_t DecodeUtf16(const char16_t *p, size_t avail, uint32_t &cp) noexcept {
+  uint32_t u = p[0];
+  if (u < 0xD800 || u > 0xDFFF) {
+    cp = u;
+    return 1;
+  }
+  if (u <= 0xDBFF && avail >= 2 && p[1] >= 0xDC00 && p[1] <= 0xDFFF) {
+    cp = 0x10000 + ((u - 0xD800) << 10) + (uint32_t(p[1]) - 0xDC00);
+    return 2;
+  }
+  cp = kReplacementCharacter;
+  return 1;
+}
+
+inline size_t EncodeUtf8(uint32_t cp, char *out) noexcept {
+  if (cp < 0x80) {
+    out[0] = static_cast<char>(cp);
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (cp >> 6));
+    out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (cp >> 12));
+    out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (cp >> 18));
+  out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+inline size_t EncodeUtf16(uint32_t cp, char16_t *out) noexcept {
+  if (cp < 0x10000) {
+    out[0] = static_cast<char16_t>(cp);
+    return 1;
+  }
+  cp -= 0x10000;
+  out[0] = static_cast<char16_t>(0xD800 + (cp >> 10));
+  out[1] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+  return 2;
+}
+
+// ASCII kernels. Each converts/skips the longest ASCII prefix it can in whole vector
+// blocks and returns how many units it handled; the caller finishes the remainder.
+
+size_t AsciiPrefixScalar(const uint8_t *in, size_t length) noexcept {
+  size_t i = 0;
+  while (i < length && in[i] < 0x80) i++;
+  return i;
+}
+
+size_t AsciiPrefix16Scalar(const char16_t *in, size_t length) noexcept {
+  size_t i = 0;
+  while (i < length && in[i] < 0x80) i++;
+  return i;
+}
+
+#if !defined(IR_TRANSCODE_X86) && !defined(IR_TRANSCODE_NEON)
+// No vector unit: the scalar decoder handles everything.
+size_t WidenAsciiScalar(const uint8_t *, size_t, char16_t *) noexcept { return 0; }
+size_t NarrowAsciiScalar(const char16_t *, size_t, uint8_t *) noexcept { return 0; }
+#endif
+
+#if defined(IR_TRANSCODE_X86)
+
+size_t AsciiPrefixSse2(const uint8_t *in, size_t length) noexcept {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    if (_mm_movemask_epi8(v) != 0) break;
+  }
+  return i + AsciiPrefixScalar(in + i, length - i);
+}
+
+size_t WidenAsciiSse2(const uint8_t *in, size_t length, char16_t *out) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    if (_mm_movemask_epi8(v) != 0) break;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8), _mm_unpackhi_epi8(v, zero));
+  }
+  return i;
+}
+
+size_t NarrowAsciiSse2(const char16_t *in, size_t length, uint8_t *out) noexcept {
+  const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8));
+    // packus saturates as signed, so check the high bits explicitly before packing.
+    __m128i high = _mm_and_si128(_mm_or_si128(a, b), nonAsciiBits);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(a, b));
+  }
+  return i;
+}
+
+size_t AsciiPrefix16Sse2(const char16_t *in, size_t length) noexcept {
+  const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8));
+    __m128i high = _mm_and_si128(_mm_or_si128(a, b), nonAsciiBits);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+  }
+  return i + AsciiPrefix16Scalar(in + i, length - i);
+}
+
+IR_TARGET_AVX2 size_t AsciiPrefixAvx2(const uint8_t *in, size_t length) noexcept {
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    if (_mm256_movemask_epi8(v) != 0) break;
+  }
+  return i + AsciiPrefixSse2(in + i, length - i);
+}
+
+IR_TARGET_AVX2 size_t WidenAsciiAvx2(const uint8_t *in, size_t length, char16_t *out) noexcept {
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    if (_mm256_movemask_epi8(v) != 0) break;
+    __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v));
+    __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + 16), hi);
+  }
+  return i + WidenAsciiSse2(in + i, length - i, out + i);
+}
+
+IR_TARGET_AVX2 size_t NarrowAsciiAvx2(const char16_t *in, size_t length, uint8_t *out) noexcept {
+  const __m256i nonAsciiBits = _mm256_set1_epi16(static_cast<short>(0xFF80));
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16));
+    __m256i high = _mm256_and_si256(_mm256_or_si256(a, b), nonAsciiBits);
+    if (!_mm256_testz_si256(high, high)) break;
+    // packus works per 128-bit lane; the permute restores the original order.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), packed);
+  }
+  return i + NarrowAsciiSse2(in + i, length - i, out + i);
+}
+
+IR_TARGET_AVX2 size_t AsciiPrefix16Avx2(const char16_t *in, size_t length) noexcept {
+  const __m256i nonAsciiBits = _mm256_set1_epi16(static_cast<short>(0xFF80));
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16));
+    __m256i high = _mm256_and_si256(_mm256_or_si256(a, b), nonAsciiBits);
+    if (!_mm256_testz_si256(high, high)) break;
+  }
+  return i + AsciiPrefix16Sse2(in + i, length - i);
+}
+
+bool CpuHasAvx2() noexcept {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // IR_TRANSCODE_X86
+
+#if defined(IR_TRANSCODE_NEON)
+
+size_t AsciiPrefixNeon(const uint8_t *in, size_t length) noexcept {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(in + i)) >= 0x80) break;
+  }
+  return i + AsciiPrefixScalar(in + i, length - i);
+}
+
+size_t AsciiPrefix16Neon(const char16_t *in, size_t length) noexcept {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t *>(in + i));
+    uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t *>(in + i + 8));
+    if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+  }
+  return i + AsciiPrefix16Scalar(in + i, length - i);
+}
+
+size_t WidenAsciiNeon(const uint8_t *in, size_t length, char16_t *out) noexcept {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t v = vld1q_u8(in + i);
+    if (vmaxvq_u8(v) >= 0x80) break;
+    vst1q_u16(reinterpret_cast<uint16_t *>(out + i), vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(reinterpret_cast<uint16_t *>(out + i + 8), vmovl_u8(vget_high_u8(v)));
+  }
+  return i;
+}
+
+size_t NarrowAsciiNeon(const char16_t *in, size_t length, uint8_t *out) noexcept {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t *>(in + i));
+    uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t *>(in + i + 8));
+    if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+    vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+  }
+  return i;
+}
+
+#endif // IR_TRANSCODE_NEON
+
+struct TranscodingKernels {
+  size_t (*asciiPrefix)(const uint8_t *, size_t) noexcept;
+  size_t (*asciiPrefix16)(const char16_t *, size_t) noexcept;
+  size_t (*widenAscii)(const uint8_t *, size_t, char16_t *) noexcept;
+  size_t (*narrowAscii)(const char16_t *, size_t, uint8_t *) noexcept;
+  const char *name;
+};
+
+const TranscodingKernels &Kernels() noexcept {
+  static const TranscodingKernels kernels = []() -> TranscodingKernels {
+#if defined(IR_TRANSCODE_X86)
+    if (CpuHasAvx2()) return {AsciiPrefixAvx2, AsciiPrefix16Avx2, WidenAsciiAvx2, NarrowAsciiAvx2, "avx2"};
+    return {AsciiPrefixSse2, AsciiPrefix16Sse2, WidenAsciiSse2, NarrowAsciiSse2, "sse2"};
+#elif defined(IR_TRANSCODE_NEON)
+    return {AsciiPrefixNeon, AsciiPrefix16Neon, WidenAsciiNeon, NarrowAsciiNeon, "neon"};
+#else
+    return {AsciiPrefixScalar, AsciiPrefix16Scalar, WidenAsciiScalar, NarrowAsciiScalar, "scalar"};
+#endif
+  }();
+  return kernels;
+}
+
+} // namespace
+
+bool IsValidUtf8(const char *data, size_t length) noexcept {
+  const auto &kernels = Kernels();
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(data);
+  size_t i = 0;
+  while (i < length) {
+    i += kernels.asciiPrefix(in + i, length - i);
+    // Decode the non-ASCII run one code point at a time, then go back to the fast path.
+    while (i < length && in[i] >= 0x80) {
+      uint32_t cp;
+      bool valid;
+      i += DecodeUtf8(in + i, length - i, cp, valid);
+      if (!valid) return false;
+    }
+  }
+  return true;
+}
+
+size_t Utf8IncompleteTailLength(const char *data, size_t length) noexcept {
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(data);
+  size_t continuation = 0;
+  while (continuation < 3 && continuation < length && IsContinuation(in[length - 1 - continuation])) {
+    continuation++;
+  }
+  if (continuation == length) return 0;
+
+  size_t leadIndex = length - 1 - continuation;
+  uint8_t lead = in[leadIndex];
+  size_t expected = lead >= 0xF0 && lead < 0xF5 ? 4 : lead >= 0xE0 && lead < 0xF0 ? 3 : lead >= 0xC2 && lead < 0xE0 ? 2 : 0;
+  size_t present = continuation + 1;
+  if (expected == 0 || present >= expected) return 0;
+
+  // Only hold bytes back if they could still become a valid sequence.
+  if (present >= 2) {
+    uint8_t b1 = in[leadIndex + 1];
+    if ((lead == 0xE0 && b1 < 0xA0) || (lead == 0xED && b1 > 0x9F) || (lead == 0xF0 && b1 < 0x90) ||
+        (lead == 0xF4 && b1 > 0x8F)) {
+      return 0;
+    }
+  }
+  return present;
+}
+
+size_t Utf16LengthForUtf8(const char *data, size_t length) noexcept {
+  const auto &kernels = Kernels();
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(data);
+  size_t i = 0;
+  size_t units = 0;
+  while (i < length) {
+    size_t ascii = kernels.asciiPrefix(in + i, length - i);
+    i += ascii;
+    units += ascii;
+    while (i < length && in[i] >= 0x80) {
+      uint32_t cp;
+      bool valid;
+      i += DecodeUtf8(in + i, length - i, cp, valid);
+      units += cp >= 0x10000 ? 2 : 1;
+    }
+  }
+  return units;
+}
+
+size_t Utf8LengthForUtf16(const char16_t *data, size_t length) noexcept {
+  const auto &kernels = Kernels();
+  size_t i = 0;
+  size_t bytes = 0;
+  while (i < length) {
+    size_t ascii = kernels.asciiPrefix16(data + i, length - i);
+    i += ascii;
+    bytes += ascii;
+    while (i < length && data[i] >= 0x80) {
+      uint32_t cp;
+      i += DecodeUtf16(data + i, length - i, cp);
+      bytes += cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    }
+  }
+  return bytes;
+}
+
+size_t ConvertUtf8ToUtf16(const char *data, size_t length, char16_t *out) noexcept {
+  const auto &kernels = Kernels();
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(data);
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    size_t widened = kernels.widenAscii(in + i, length - i, out + o);
+    i += widened;
+    o += widened;
+    // Tail of an ASCII run shorter than a vector, or a non-ASCII code point.
+    size_t stop = i + 16 < length ? i + 16 : length;
+    while (i < stop) {
+      uint32_t cp;
+      bool valid;
+      i += DecodeUtf8(in + i, length - i, cp, valid);
+      o += EncodeUtf16(cp, out + o);
+    }
+  }
+  return o;
+}
+
+size_t ConvertUtf16ToUtf8(const char16_t *in, size_t length, char *out) noexcept {
+  const auto &kernels = Kernels();
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(out);
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    size_t narrowed = kernels.narrowAscii(in + i, length - i, bytes + o);
+    i += narrowed;
+    o += narrowed;
+    size_t stop = i + 16 < length ? i + 16 : length;
+    while (i < stop) {
+      uint32_t cp;
+      i += DecodeUtf16(in + i, length - i, cp);
+      o += EncodeUtf8(cp, out + o);
+    }
+  }
+  return o;
+}
+
+std::u16string Utf8ToUtf16(std::string_view text) {
+  // UTF-16 never needs more code units than UTF-8 has bytes.
+  std::u16string out(text.size(), u'\0');
+  out.resize(ConvertUtf8ToUtf16(text.data(), text.size(), out.data()));
+  return out;
+}
+
+std::string Utf16ToUtf8(std::u16string_view text) {
+  std::string out(Utf8LengthForUtf16(text.data(), text.size()), '\0');
+  ConvertUtf16ToUtf8(text.data(), text.size(), out.data());
+  return out;
+}
+
+const char *ActiveTranscodingKernel() noexcept { return Kernels().name; }
+
+} // namespace reactotron
@@ -0,0 +1,68 @@
+#pragma once
+
+//
+//  TextTranscoding.h
+//  Reactotron
+//
+//  UTF-8 validation and UTF-8 <-> UTF-16 conversion for native string boundaries
+//  (the Windows clipboard, shell output, anything handed to Win32 wide APIs).
+//
+//  Runs of ASCII are converted 16-32 bytes at a time with SSE2/AVX2 on x86 and
+//  NEON on ARM, picked once at runtime; everything else goes through a scalar
+//  decoder. Invalid input is never rejected by the converters: each byte that
+//  can't start a valid sequence, and each lone surrogate, becomes U+FFFD.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace reactotron {
+
+/**
+ * Returns true if `data` is well-formed UTF-8 (no overlongs, surrogates or code
+ * points above U+10FFFF).
+ */
+bool IsValidUtf8(const char *data, size_t length) noexcept;
+
+/**
+ * Returns the number of bytes (0-3) at the end of `data` that form the start of a
+ * multi-byte sequence cut off by the end of the buffer. Streams that arrive in
+ * chunks should hold these back until the next chunk.
+ */
+size_t Utf8IncompleteTailLength(const char *data, size_t length) noexcept;
+
+/**
+ * Exact number of UTF-16 code units ConvertUtf8ToUtf16 writes for this input.
+ * Never more than `length`.
+ */
+size_t Utf16LengthForUtf8(const char *data, size_t length) noexcept;
+
+/**
+ * Exact number of bytes ConvertUtf16ToUtf8 writes for this input.
+ * Never more than 3 * `length`.
+ */
+size_t Utf8LengthForUtf16(const char16_t *data, size_t length) noexcept;
+
+/**
+ * Converts into a caller-provided buffer of at least Utf16LengthForUtf8() units.
+ * Returns the number of code units written.
+ */
+size_t ConvertUtf8ToUtf16(const char *in, size_t length, char16_t *out) noexcept;
+
+/**
+ * Converts into a caller-provided buffer of at least Utf8LengthForUtf16() bytes.
+ * Returns the number of bytes written.
+ */
+size_t ConvertUtf16ToUtf8(const char16_t *in, size_t length, char *out) noexcept;
+
+std::u16string Utf8ToUtf16(std::string_view text);
+std::string Utf16ToUtf8(std::u16string_view text);
+
+/**
+ * Name of the vector kernel picked for this CPU: "avx2", "sse2", "neon" or "scalar".
+ */
+const char *ActiveTranscodingKernel() noexcept;
+
+} // namespace reactotron
@@ -2,12 +2,13 @@ import { Text, ViewStyle, ScrollView, TextStyle, Pressable, View, TextInput } fr
 import { themed } from "../theme/theme"
 import { sendToCore } from "../state/connectToServer"
 import { useGlobal } from "../state/useGlobal"
-import { TreeViewWithProvider } from "../components/TreeView"
+import { DataViewer } from "../components/BodyViewer"
 import { useState } from "react"
 import { Divider } from "../components/Divider"
-import { useKeyboardEvents } from "../utils/system"
+import { useShortcut } from "../utils/system"
 import type { StateSubscription } from "app/types"
 import { Icon } from "../components/Icon"
+import { StateSnapshotsPanel } from "../components/StateSnapshotsPanel"
 
 export function StateScreen() {
   const [showAddSubscription, setShowAddSubscription] = useState(false)
@@ -81,7 +82,7 @@ export function StateScreen() {
                 </Text>
                 <View style={$treeViewContainer()}>
                   <View style={$treeViewInnerContainer()}>
-                    <TreeViewWithProvider data={subscription.value} />
+                    <DataViewer data={subscription.value} />
                   </View>
                   <Pressable onPress={() => removeSubscription(subscription.path)}>
                     <Icon icon="trash" size={20} />
@@ -97,6 +98,7 @@ export function StateScreen() {
           <Text>State is empty</Text>
         )}
       </View>
+      {!!activeTab && <StateSnapshotsPanel clientId={activeTab} />}
     </ScrollView>
   )
 }
@@ -110,21 +112,12 @@ function AddSubscription({
 }) {
   const [path, setPath] = useState("")
 
-  useKeyboardEvents(
-    (event) => {
-      // TODO: check these key events in windows
-      if (event.type === "keydown" && event.key === "\u001b") {
-        setShowAddSubscription(false)
-      }
-      // TODO: Make this event work, it currently always sends ""
-      if (event.type === "keydown" && event.key === "\r") {
-        saveSubscription(path)
-        setPath("")
-        setShowAddSubscription(false)
-      }
-    },
-    [path],
-  )
+  useShortcut("escape", () => setShowAddSubscription(false))
+  useShortcut("enter", () => {
+    saveSubscription(path)
+    setPath("")
+    setShowAddSubscription(false)
+  })
 
   return (
     <View style={$addSubscriptionOuterContainer()}>
@@ -6,14 +6,18 @@ import { TimelineNetworkItem } from "../components/TimelineNetworkItem"
 import { TimelineDisplayItem } from "../components/TimelineDisplayItem"
 import { TimelineBenchmmarkItem } from "../components/TimelineBenchmarkItem"
 import { DetailPanel } from "../components/DetailPanel"
+import { NetworkStatsPanel } from "../components/NetworkStatsPanel"
+import { LogSourcesPanel } from "../components/LogSourcesPanel"
+import { RelayHealthPanel } from "../components/RelayHealthPanel"
 import { ResizableDivider } from "../components/ResizableDivider"
 import { LegendList } from "@legendapp/list"
-import { TextInput, View, ViewStyle, TextStyle } from "react-native"
+import { Text, TextInput, View, ViewStyle, TextStyle } from "react-native"
 import { useSelectedTimelineItems } from "../utils/useSelectedTimelineItems"
 import { Separator } from "../components/Separator"
 import { themed, useThemeName } from "../theme/theme"
 import { $flex, $row } from "../theme/basics"
 import { useTimeline } from "../utils/useTimeline"
+import { timelineQueryError } from "../utils/timelineQuery"
 import { MenuItemId } from "app/components/Sidebar/SidebarMenu"
 import { useEffect } from "react"
 import { FilterType } from "../components/TimelineToolbar"
@@ -96,6 +100,7 @@ export function TimelineScreen() {
   const [timelineWidth, setTimelineWidth] = useGlobal<number>("timelineWidth", 300, {
     persist: true,
   })
+  const searchError = timelineQueryError(search)
   const { selectedItem, setSelectedItemId } = useSelectedTimelineItems()
   useEffect(() => {
     setSelectedItemId(null)
@@ -121,6 +126,7 @@ export function TimelineScreen() {
           </View>
           <ClearLogsButton />
         </View>
+        {!!searchError && <Text style={$searchError()}>{searchError}</Text>}
         <LegendList<TimelineItem>
           data={timelineItems}
           extraData={selectedItem?.id}
@@ -141,7 +147,15 @@ export function TimelineScreen() {
       </View>
       <ResizableDivider onResize={setTimelineWidth} minWidth={300} maxWidth={800} />
       <View style={$flex}>
-        <DetailPanel selectedItem={selectedItem} onClose={() => setSelectedItemId(null)} />
+        {activeItem === "network" && !selectedItem ? (
+          <NetworkStatsPanel />
+        ) : activeItem === "logs" && !selectedItem ? (
+          <LogSourcesPanel />
+        ) : activeItem === "performance" && !selectedItem ? (
+          <RelayHealthPanel />
+        ) : (
+          <DetailPanel selectedItem={selectedItem} onClose={() => setSelectedItemId(null)} />
+        )}
       </View>
     </View>
   )
@@ -171,3 +185,10 @@ const $searchInput = themed<TextStyle>(({ colors, typography, spacing }) => ({
 const $searchContainer = themed<ViewStyle>(({ spacing }) => ({
   marginRight: spacing.md,
 }))
+const $searchError = themed<TextStyle>(({ colors, typography, spacing }) => ({
+  fontSize: typography.caption,
+  color: colors.danger,
+  paddingHorizontal: spacing.sm,
+  paddingBottom: spacing.xs,
+  backgroundColor: colors.cardBackground,
+}))
@@ -3,12 +3,45 @@ import { deleteGlobal, withGlobal } from "./useGlobal"
 import { CommandType } from "reactotron-core-contract"
 import type { StateSubscription, TimelineItem, CustomCommand } from "../types"
 import { isSafeKey, sanitizeValue } from "../utils/sanitize"
+import { recordApiResponse } from "../utils/networkStats"
+import { recordBenchmark } from "../utils/benchmarkStats"
+import { collapseRepeatedLog, endLogRun, moveLogRun, resetLogRuns } from "../utils/logStats"
+import {
+  clearPayloads,
+  compactTimelineItem,
+  releasePayloadHandles,
+  releasePayloads,
+} from "../utils/payloadArena"
+import { flushSessionMessages, recordSessionMessage } from "../utils/sessionArchive"
+import { clearQueryRows, recordQueryRow } from "../utils/timelineQuery"
+import { clearItemHandles } from "../utils/itemHandles"
+import {
+  ingestMessages,
+  openRelayConnection,
+  type IngestedMessages,
+  type RelayConnection,
+} from "../utils/relayConnection"
+import { clearRelayStats, recordRelayStats } from "../utils/relayStats"
+import { invalidateSourceMaps, prefetchSymbolication } from "../utils/symbolication"
+import {
+  captureAfterAction,
+  recordStateBackup,
+  resetStateSnapshotRequests,
+} from "../utils/stateSnapshots"
 
 type UnsubscribeFn = () => void
 type SendToClientFn = (message: string | object, payload?: object, clientId?: string) => void
-type WebSocketState = { socket: WebSocket | null }
+type WebSocketState = { socket: RelayConnection | null }
+/** What native ingest found out about a message. Its payload handle is taken by its timeline item. */
+type IngestedMessage = { logKey: string; payloadHandle: number; itemId: number }
 
 let _sendToClient: SendToClientFn
+let _handleBatch: ((batch: IngestedMessages) => void) | undefined
+// While a batch of messages is handled, new timeline items collect here and land in one update,
+// along with replacements (by id) for items already in the timeline
+let _timelineBatch: TimelineItem[] | null = null
+let _replacedItems: Map<number, TimelineItem> | null = null
+let _replaying = false
 const ws: WebSocketState = { socket: null }
 
 export const getReactotronAppId = () => {
@@ -24,6 +57,7 @@ export const getReactotronAppId = () => {
  * - error: Error | null
  * - clientIds: string[]
  * - timelineItems: TimelineItem[]
+ * - relayHealth: RelayHealth | null, from the relay's "reactotron.relayStats" messages
  *
  * @param props.port - The port to connect to. Defaults to 9292.
  */
@@ -41,31 +75,60 @@ export function connectToServer(props: { port: number } = { port: 9292 }): Unsub
     persist: true,
   })
 
-  ws.socket = new WebSocket(`ws://localhost:${props.port}`)
-  if (!ws.socket) throw new Error("Failed to connect to Reactotron server")
-
-  // Tell the server we are a Reactotron app, not a React client.
-  ws.socket.onopen = () => {
-    ws.socket?.send(
-      JSON.stringify({
-        type: "reactotron.subscribe",
-        payload: {
-          id: reactotronAppId,
-        },
-      }),
-    )
-  }
-
-  // Handle errors
-  ws.socket.onerror = (event) => setError(new Error(`WebSocket error: ${event.message}`))
+  // The socket is read natively; messages arrive a frame's worth at a time
+  ws.socket = openRelayConnection(`ws://localhost:${props.port}`, {
+    // Tell the server we are a Reactotron app, not a React client.
+    onOpen: () => {
+      ws.socket?.send(
+        JSON.stringify({
+          type: "reactotron.subscribe",
+          payload: {
+            id: reactotronAppId,
+          },
+        }),
+      )
+    },
+    onMessages: (batch) => handleInOneUpdate(() => handleBatch(batch)),
+    onError: (message) => setError(new Error(`WebSocket error: ${message}`)),
+    onClose: () => handleClose(),
+  })
 
   // Handle messages coming from the server, intended to be sent to the client or Reactotron app.
-  ws.socket.onmessage = (event) => {
-    const data = JSON.parse(event.data)
+  const handleBatch = ({ messages, logKeys, payloadHandles, itemIds }: IngestedMessages) => {
+    const unused: number[] = []
+    messages.forEach((text, index) => {
+      const ingested = {
+        logKey: logKeys[index] ?? "",
+        payloadHandle: payloadHandles[index] ?? 0,
+        itemId: itemIds[index] ?? 0,
+      }
+      try {
+        const data = JSON.parse(text)
+        recordSessionMessage(data, text)
+        handleMessage(data, ingested)
+      } catch (error) {
+        // One bad message shouldn't lose the rest of the batch
+        console.error(error)
+      }
+      // Folded repeats and messages that aren't timeline items
+      if (ingested.payloadHandle) unused.push(ingested.payloadHandle)
+    })
+    flushSessionMessages()
+    releasePayloadHandles(unused)
+  }
 
+  const handleMessage = (data: any, ingested: IngestedMessage) => {
     if (data.type === "reactotron.connected") setIsConnected(true)
 
+    // The relay's own counters, sent every second or so
+    if (data.type === "reactotron.relayStats") {
+      recordRelayStats(data.stats, ws.socket?.clientStats() ?? [])
+      return
+    }
+
     if (data.type === "connectionEstablished") {
+      // A client connecting may be an app that reloaded with a new bundle
+      invalidateSourceMaps()
       const clientId = data?.conn?.clientId
       if (!clientIds.includes(clientId)) {
         setClientIds((prev) => [...prev, clientId])
@@ -97,7 +160,25 @@ export function connectToServer(props: { port: number } = { port: 9292 }): Unsub
     }
 
     if (data.type === "command" && data.cmd) {
-      if (data.cmd.type === CommandType.Clear) setTimelineItems([])
+      if (data.cmd.type === CommandType.Clear) {
+        // Only the timeline's payloads: those of messages still on their way are stored already
+        setTimelineItems((prev) => {
+          releasePayloads(prev)
+          return []
+        })
+        if (_timelineBatch) {
+          releasePayloads(_timelineBatch)
+          _timelineBatch.length = 0
+        }
+        _replacedItems?.clear()
+        resetLogRuns()
+        clearQueryRows()
+        // Item handles were cleared natively, at this point in the stream
+      }
+      if (data.cmd.type === CommandType.StateBackupResponse) {
+        recordStateBackup(data.cmd)
+        return
+      }
       if (
         data.cmd.type === CommandType.Log ||
         data.cmd.type === CommandType.ApiResponse ||
@@ -105,15 +186,50 @@ export function connectToServer(props: { port: number } = { port: 9292 }): Unsub
         data.cmd.type === CommandType.StateActionComplete ||
         data.cmd.type === CommandType.Benchmark
       ) {
-        // Add a unique ID to the timeline item
-        data.cmd.id = `${data.cmd.clientId}-${data.cmd.messageId}`
+        // The timeline item's unique ID, numbered natively as it was ingested
+        data.cmd.id = ingested.itemId
+
+        // Repeats of the previous log only bump its count, so storms don't grow the timeline
+        if (data.cmd.type === CommandType.Log) {
+          const repeat = collapseRepeatedLog(data.cmd, ingested.logKey)
+          if (repeat) {
+            replaceTimelineItem(repeat.previous, repeat.folded)
+            return
+          }
+          if (data.cmd.payload?.level === "error") prefetchSymbolication(data.cmd.payload.stack)
+        } else {
+          endLogRun(data.cmd.clientId)
+        }
+
+        if (data.cmd.type === CommandType.ApiResponse) recordApiResponse(data.cmd.payload)
+        if (data.cmd.type === CommandType.Benchmark) {
+          data.cmd.verdict = recordBenchmark(data.cmd.payload)
+        }
+        // Replayed actions only rebuild the timeline; the client's state has moved on
+        if (
+          data.cmd.type === CommandType.StateActionComplete &&
+          !_replaying &&
+          captureAfterAction(data.cmd)
+        ) {
+          _sendToClient("state.backup.request", {}, data.cmd.clientId)
+        }
+
+        // From here on the payload lives natively and is parsed again only when it's read
+        const item = compactTimelineItem(data.cmd, ingested.payloadHandle)
+        ingested.payloadHandle = 0
+        recordQueryRow(data.cmd, item)
+        if (item.type === CommandType.Log) moveLogRun(item)
 
         // Add to timeline IDs
+        if (_timelineBatch) {
+          _timelineBatch.push(item)
+          return
+        }
         setTimelineItems((prev) => {
           // TODO: This does rerender if we're using a flatlist, but not if we're using a legend list.
           // prev.unshift(data.cmd) // mutating is faster
           // return prev // don't worry, it'll still rerender
-          return [...prev, data.cmd]
+          return [...prev, item]
         })
       } else {
         console.tron.log("unknown command", data.cmd)
@@ -192,9 +308,10 @@ export function connectToServer(props: { port: number } = { port: 9292 }): Unsub
 
     console.log(data)
   }
+  _handleBatch = handleBatch
 
   // Clean up after disconnect
-  ws.socket.onclose = () => {
+  const handleClose = () => {
     console.tron.log("Reactotron server disconnected")
     // Clear individual client data
     clientIds.forEach((clientId) => {
@@ -206,8 +323,14 @@ export function connectToServer(props: { port: number } = { port: 9292 }): Unsub
     setIsConnected(false)
     setActiveClientId("")
     setTimelineItems([])
+    resetLogRuns()
+    clearPayloads()
+    clearQueryRows()
+    clearItemHandles()
+    resetStateSnapshotRequests()
     setStateSubscriptionsByClientId({})
     setCustomCommands([])
+    clearRelayStats()
   }
 
   // Send a message to the server (which will be forwarded to the client)
@@ -227,6 +350,73 @@ export function sendToClient(message: string | object, payload?: object, clientI
   _sendToClient(message, payload, clientId)
 }
 
+/**
+ * Handles messages as if the server had sent them, e.g. from an imported session. They go
+ * through the same native checks as the relay's, and their timeline items are added in one
+ * update. Returns how many were handled; malformed ones are dropped.
+ */
+export function replayMessages(texts: string[]): number {
+  if (!_handleBatch) {
+    throw new Error("replayMessages not initialized. Call connectToServer() first.")
+  }
+  const handleBatch = _handleBatch
+  const batch = ingestMessages(texts)
+  _replaying = true
+  try {
+    handleInOneUpdate(() => handleBatch(batch))
+  } finally {
+    _replaying = false
+  }
+  return batch.messages.length
+}
+
+/**
+ * Swaps `next` in for `previous`, an item in the timeline or in the batch being handled. Items
+ * are never changed in place, so whatever shows them re-renders.
+ */
+function replaceTimelineItem(previous: TimelineItem, next: TimelineItem) {
+  const index = _timelineBatch ? _timelineBatch.lastIndexOf(previous) : -1
+  if (_timelineBatch && index !== -1) {
+    _timelineBatch[index] = next
+  } else if (_replacedItems) {
+    _replacedItems.set(next.id, next)
+  } else {
+    const [, setTimelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
+    setTimelineItems((prev) => withReplacements(prev, new Map([[next.id, next]])))
+  }
+}
+
+/** `items` with the ones in `replaced` swapped in, by id. Replaced items are usually recent. */
+function withReplacements(items: TimelineItem[], replaced: Map<number, TimelineItem>) {
+  if (replaced.size === 0) return items
+  const next = items.slice()
+  let remaining = replaced.size
+  for (let i = next.length - 1; i >= 0 && remaining > 0; i--) {
+    const replacement = replaced.get(next[i].id)
+    if (!replacement) continue
+    next[i] = replacement
+    remaining--
+  }
+  return next
+}
+
+/** Runs `handle`, adding the timeline items of the messages it handles in one update. */
+function handleInOneUpdate(handle: () => void) {
+  const batch: TimelineItem[] = []
+  const replaced = new Map<number, TimelineItem>()
+  _timelineBatch = batch
+  _replacedItems = replaced
+  try {
+    handle()
+  } finally {
+    _timelineBatch = null
+    _replacedItems = null
+  }
+  if (batch.length === 0 && replaced.size === 0) return
+  const [, setTimelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
+  setTimelineItems((prev) => [...withReplacements(prev, replaced), ...batch])
+}
+
 export function sendToCore(message: string | object, payload?: object) {
   if (!_sendToClient) throw new Error("sendToClient not initialized. Call connectToServer() first.")
   _sendToClient("reactotron.sendToCore", { type: message, ...payload })
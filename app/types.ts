@@ -1,5 +1,6 @@
 // Import types from the official Reactotron contract package
 import { CommandType, CommandMap } from "reactotron-core-contract"
+import type { BenchmarkVerdict } from "./native/IRBenchmarkStats/NativeIRBenchmarkStats"
 import type {
   ErrorStackFrame,
   ErrorLogPayload,
@@ -89,6 +90,7 @@ export interface DisplayPayload {
 export interface NetworkRequest {
   url: string
   method: string
+  // A BodyRef (utils/bodyStore) if the relay set a large body aside
   data?: any
   headers?: Record<string, string>
 }
@@ -97,6 +99,7 @@ export interface NetworkResponse {
   status: number
   statusText: string
   headers?: Record<string, string>
+  // A BodyRef (utils/bodyStore) if the relay set a large body aside
   data?: any
   duration: number
 }
@@ -116,7 +119,8 @@ export interface NetworkPayload {
 
 // Unified timeline item type
 export type TimelineItemBase = {
-  id: string
+  /** Handle for (clientId, messageId), numbered natively at ingest; see RelaySocketBatch.itemIds. */
+  id: number
   important: boolean
   connectionId: number
   messageId: number
@@ -128,11 +132,16 @@ export type TimelineItemBase = {
 export type TimelineItemLog = TimelineItemBase & {
   type: typeof CommandType.Log
   payload: LogPayload
+  /** Set when identical logs that followed were folded into this one. */
+  repeatCount?: number
+  lastDate?: string
 }
 
 export type TimelineItemBenchmark = TimelineItemBase & {
   type: typeof CommandType.Benchmark
   payload: CommandMap[typeof CommandType.Benchmark]
+  /** How this run compares with earlier runs of the same title, set on ingest. */
+  verdict?: BenchmarkVerdict
 }
 
 export type TimelineItemNetwork = TimelineItemBase & {
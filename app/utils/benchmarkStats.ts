@@ -0,0 +1,73 @@
+import IRBenchmarkStats, {
+  BenchmarkBaseline,
+  BenchmarkStepSummary,
+  BenchmarkVerdict,
+} from "../native/IRBenchmarkStats/NativeIRBenchmarkStats"
+import { withGlobal } from "../state/useGlobal"
+import type { TimelineItemBenchmark } from "../types"
+
+type BaselinesByTitle = Record<string, BenchmarkBaseline[]>
+
+function withBaselines() {
+  return withGlobal<BaselinesByTitle>("benchmarkBaselines", {}, { persist: true })
+}
+
+let _baselinesLoaded = false
+function loadBaselines() {
+  if (_baselinesLoaded) return
+  _baselinesLoaded = true
+  const [baselines] = withBaselines()
+  for (const title in baselines) {
+    for (const { step, count, mean, standardDeviation } of baselines[title]) {
+      IRBenchmarkStats.setBaseline(title, step, count, mean, standardDeviation)
+    }
+  }
+}
+
+/**
+ * Feeds one benchmark.report into the native cross-run aggregates and returns how it
+ * compares with the title's baseline, or with its earlier runs if it has none.
+ */
+export function recordBenchmark(payload: TimelineItemBenchmark["payload"]): BenchmarkVerdict {
+  loadBaselines()
+  return IRBenchmarkStats.record(
+    payload.title,
+    payload.steps.map((step) => step.title),
+    payload.steps.map((step) => step.delta),
+  )
+}
+
+export function getBenchmarkSummary(title: string): ReadonlyArray<BenchmarkStepSummary> {
+  loadBaselines()
+  return IRBenchmarkStats.getSummary(title)
+}
+
+/** Makes this session's runs of `title` its baseline, persisted across launches. */
+export function captureBenchmarkBaseline(title: string) {
+  loadBaselines()
+  const steps = IRBenchmarkStats.captureBaseline(title)
+  const [, setBaselines] = withBaselines()
+  setBaselines((prev) => ({ ...prev, [title]: [...steps] }))
+}
+
+export function clearBenchmarkBaseline(title: string) {
+  loadBaselines()
+  IRBenchmarkStats.clearBaseline(title)
+  const [, setBaselines] = withBaselines()
+  setBaselines((prev) => {
+    const { [title]: _removed, ...rest } = prev
+    return rest
+  })
+}
+
+/**
+ * The step that changed the most in the direction of the run's verdict, for previews.
+ */
+export function mostChangedStep(verdict: BenchmarkVerdict) {
+  let most: BenchmarkVerdict["steps"][number] | undefined
+  for (const step of verdict.steps) {
+    if (step.change !== verdict.change) continue
+    if (!most || Math.abs(step.ratio - 1) > Math.abs(most.ratio - 1)) most = step
+  }
+  return most
+}
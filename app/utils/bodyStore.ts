@@ -0,0 +1,55 @@
+import IRBodyStore, { DecodedBody } from "../native/IRBodyStore/NativeIRBodyStore"
+
+/**
+ * What the relay leaves in an api.response command in place of a large request or response
+ * body; the body itself stays in the native IRBodyStore until it's viewed.
+ */
+export interface BodyRef {
+  $body: number
+  /** Size of the body's JSON value as it arrived. */
+  size: number
+  format: "json" | "text" | "base64"
+}
+
+export function isBodyRef(value: unknown): value is BodyRef {
+  return (
+    typeof value === "object" &&
+    value !== null &&
+    typeof (value as BodyRef).$body === "number" &&
+    typeof (value as BodyRef).size === "number"
+  )
+}
+
+/** The body ids an api.response payload refers to. */
+export function payloadBodyIds(payload: any): number[] {
+  const ids: number[] = []
+  if (isBodyRef(payload?.request?.data)) ids.push(payload.request.data.$body)
+  if (isBodyRef(payload?.response?.data)) ids.push(payload.response.data.$body)
+  return ids
+}
+
+/** Decodes the body off the JS thread; null if it has been released. */
+export function decodeBody(ref: BodyRef): Promise<DecodedBody | null> {
+  return IRBodyStore.decode(ref.$body)
+}
+
+export function releaseBodies(ids: readonly number[]) {
+  if (ids.length > 0) IRBodyStore.releaseBodies(ids)
+}
+
+export function clearBodies() {
+  IRBodyStore.clear()
+}
+
+// Written by the native ingest workers, so the keys are always in this order and unspaced
+const BODY_REF = /\{"\$body":(\d+),"size":\d+,"format":"\w+"\}/g
+
+/**
+ * `json` with every body reference replaced by the body it stands for, for writing out. A
+ * reference can't appear inside a JSON string, where its quotes would be escaped. Released
+ * bodies become null.
+ */
+export function inlineBodies(json: string): string {
+  if (!json.includes('"$body":')) return json
+  return json.replace(BODY_REF, (_, id: string) => IRBodyStore.rawJson(Number(id)) || "null")
+}
@@ -0,0 +1,301 @@
+import IRBulkChannel from "../native/IRBulkChannel/NativeIRBulkChannel"
+
+declare global {
+  // Installed by IRBulkChannel; see BulkChannelJSI.h
+  // eslint-disable-next-line no-var
+  var __irBulkTake: ((channel: string) => ArrayBuffer | null) | undefined
+}
+
+export type RecordFieldType =
+  | "bool"
+  | "u8"
+  | "i8"
+  | "u16"
+  | "i16"
+  | "u32"
+  | "i32"
+  | "f32"
+  | "f64"
+  | "string"
+
+export interface RecordField {
+  name: string
+  type: RecordFieldType
+  offset: number
+}
+
+/** A schema laid out exactly as RecordLayout does natively (RecordBatch.h). */
+export interface RecordLayout {
+  fields: RecordField[]
+  recordSize: number
+  hash: number
+  /** Normalized: "name: type, name: type". */
+  schema: string
+}
+
+const FIELD_SIZES: Record<RecordFieldType, number> = {
+  bool: 1,
+  u8: 1,
+  i8: 1,
+  u16: 2,
+  i16: 2,
+  u32: 4,
+  i32: 4,
+  f32: 4,
+  f64: 8,
+  string: 8,
+}
+
+const IDENTIFIER = /^[A-Za-z_][A-Za-z0-9_]*$/
+const MAGIC = 0x42525249 // "IRRB"
+const VERSION = 1
+const HEADER_SIZE = 32
+
+function alignUp(value: number, alignment: number): number {
+  return Math.ceil(value / alignment) * alignment
+}
+
+function fnv1a(text: string): number {
+  let hash = 2166136261
+  for (let i = 0; i < text.length; i++) {
+    hash ^= text.charCodeAt(i)
+    hash = Math.imul(hash, 16777619) >>> 0
+  }
+  return hash
+}
+
+/** Lays out a schema such as "id: u32, time: f64, message: string"; throws if it's malformed. */
+export function parseRecordLayout(schema: string): RecordLayout {
+  const fields: RecordField[] = []
+  let offset = 0
+  let alignment = 1
+  for (const part of schema.split(/[,;\n]/)) {
+    const entry = part.trim()
+    if (!entry) continue
+    const colon = entry.indexOf(":")
+    if (colon < 0) throw new Error(`Expected "name: type", got "${entry}"`)
+    const name = entry.slice(0, colon).trim()
+    const type = entry.slice(colon + 1).trim() as RecordFieldType
+    if (!IDENTIFIER.test(name)) throw new Error(`Bad field name "${name}"`)
+    if (!Object.prototype.hasOwnProperty.call(FIELD_SIZES, type)) {
+      throw new Error(`Unknown type "${type}" for field ${name}`)
+    }
+    if (fields.some((field) => field.name === name)) {
+      throw new Error(`Field ${name} is listed twice`)
+    }
+
+    const fieldAlignment = type === "string" ? 4 : FIELD_SIZES[type]
+    const fieldOffset = alignUp(offset, fieldAlignment)
+    fields.push({ name, type, offset: fieldOffset })
+    offset = fieldOffset + FIELD_SIZES[type]
+    alignment = Math.max(alignment, fieldAlignment)
+  }
+  if (fields.length === 0) throw new Error("The schema has no fields")
+  const normalized = fields.map((field) => `${field.name}: ${field.type}`).join(", ")
+  return {
+    fields,
+    recordSize: alignUp(offset, alignment),
+    hash: fnv1a(normalized),
+    schema: normalized,
+  }
+}
+
+/**
+ * UTF-8 to a string. Hermes has no TextDecoder, so where there isn't one this decodes by hand,
+ * a chunk of characters at a time. Malformed bytes become U+FFFD, as TextDecoder has them.
+ */
+export function decodeUtf8(bytes: Uint8Array, start: number, end: number): string {
+  if (typeof TextDecoder !== "undefined") return utf8Decoder().decode(bytes.subarray(start, end))
+  let text = ""
+  const codes: number[] = []
+  let i = start
+  while (i < end) {
+    const byte = bytes[i]
+    if (byte < 0x80) {
+      codes.push(byte)
+      i++
+    } else {
+      const need = byte >= 0xf0 ? (byte <= 0xf4 ? 3 : 0) : byte >= 0xe0 ? 2 : byte >= 0xc2 ? 1 : 0
+      let code = byte & (0x3f >> need)
+      // The second byte's range also rules out overlong forms, surrogates and > U+10FFFF
+      let lower = byte === 0xe0 ? 0xa0 : byte === 0xf0 ? 0x90 : 0x80
+      let upper = byte === 0xed ? 0x9f : byte === 0xf4 ? 0x8f : 0xbf
+      let taken = 1
+      while (taken <= need && i + taken < end) {
+        const next = bytes[i + taken]
+        if (next < lower || next > upper) break
+        code = (code << 6) | (next & 0x3f)
+        lower = 0x80
+        upper = 0xbf
+        taken++
+      }
+      if (need === 0 || taken <= need) {
+        codes.push(0xfffd)
+      } else if (code > 0xffff) {
+        code -= 0x10000
+        codes.push(0xd800 | (code >> 10), 0xdc00 | (code & 0x3ff))
+      } else {
+        codes.push(code)
+      }
+      i += taken
+    }
+    if (codes.length >= 4096) {
+      text += String.fromCharCode.apply(null, codes)
+      codes.length = 0
+    }
+  }
+  return codes.length > 0 ? text + String.fromCharCode.apply(null, codes) : text
+}
+
+let decoder: TextDecoder | null = null
+function utf8Decoder(): TextDecoder {
+  if (!decoder) decoder = new TextDecoder("utf-8")
+  return decoder
+}
+
+/**
+ * One batch, read in place: fields are read out of the buffer when asked for, so records that
+ * are only counted, filtered on a number or skipped cost nothing to convert.
+ */
+export class RecordBatchView<T> {
+  readonly count: number
+  readonly layout: RecordLayout
+  private readonly readers: Record<string, (index: number) => unknown> = {}
+
+  /** Throws if `buffer` isn't a batch or was written with another schema. */
+  constructor(buffer: ArrayBuffer, layout: RecordLayout) {
+    const view = new DataView(buffer)
+    if (buffer.byteLength < HEADER_SIZE || view.getUint32(0, true) !== MAGIC) {
+      throw new Error("Not a record batch")
+    }
+    if (view.getUint16(4, true) !== VERSION) throw new Error("Unsupported record batch version")
+    if (view.getUint32(8, true) !== layout.hash || view.getUint32(12, true) !== layout.recordSize) {
+      throw new Error(`Record batch wasn't written with the schema "${layout.schema}"`)
+    }
+    this.count = view.getUint32(16, true)
+    const recordsOffset = view.getUint32(20, true)
+    const stringsOffset = view.getUint32(24, true)
+    if (
+      recordsOffset + this.count * layout.recordSize > stringsOffset ||
+      stringsOffset + view.getUint32(28, true) > buffer.byteLength
+    ) {
+      throw new Error("Record batch is truncated")
+    }
+    this.layout = layout
+    const bytes = new Uint8Array(buffer)
+    for (const field of layout.fields) {
+      const size = layout.recordSize
+      this.readers[field.name] = fieldReader(view, bytes, field, recordsOffset, stringsOffset, size)
+    }
+  }
+
+  /** A reader for one field, for loops over many records. */
+  field<K extends keyof T & string>(name: K): (index: number) => T[K] {
+    const read = this.readers[name]
+    if (!read) throw new Error(`No field ${name}`)
+    return read as (index: number) => T[K]
+  }
+
+  /** Record `index` as an object, every field converted. */
+  get(index: number): T {
+    const record: Record<string, unknown> = {}
+    for (const field of this.layout.fields) record[field.name] = this.readers[field.name](index)
+    return record as T
+  }
+
+  toArray(): T[] {
+    const records = new Array<T>(this.count)
+    for (let i = 0; i < this.count; i++) records[i] = this.get(i)
+    return records
+  }
+}
+
+function fieldReader(
+  view: DataView,
+  bytes: Uint8Array,
+  field: RecordField,
+  recordsOffset: number,
+  stringsOffset: number,
+  size: number,
+): (index: number) => unknown {
+  const base = recordsOffset + field.offset
+  switch (field.type) {
+    case "bool":
+      return (i) => view.getUint8(base + i * size) !== 0
+    case "u8":
+      return (i) => view.getUint8(base + i * size)
+    case "i8":
+      return (i) => view.getInt8(base + i * size)
+    case "u16":
+      return (i) => view.getUint16(base + i * size, true)
+    case "i16":
+      return (i) => view.getInt16(base + i * size, true)
+    case "u32":
+      return (i) => view.getUint32(base + i * size, true)
+    case "i32":
+      return (i) => view.getInt32(base + i * size, true)
+    case "f32":
+      return (i) => view.getFloat32(base + i * size, true)
+    case "f64":
+      return (i) => view.getFloat64(base + i * size, true)
+    case "string":
+      return (i) => {
+        const start = stringsOffset + view.getUint32(base + i * size, true)
+        return decodeUtf8(bytes, start, start + view.getUint32(base + i * size + 4, true))
+      }
+  }
+}
+
+export interface BulkChannel<T> {
+  readonly name: string
+  readonly layout: RecordLayout
+  /** The channel's oldest batch, or null if none is waiting. */
+  take(): RecordBatchView<T> | null
+  /**
+   * Calls `onBatch` with each batch as the channel gets them, at most once per animation frame
+   * for however many arrived. Returns a function that stops it.
+   */
+  subscribe(onBatch: (batch: RecordBatchView<T>) => void): () => void
+}
+
+/**
+ * A channel that native code pushes RecordBatches to under `name`, laid out by `schema`. The
+ * schema has to match the native one; batches written with another are refused.
+ */
+export function defineBulkChannel<T>(name: string, schema: string): BulkChannel<T> {
+  const layout = parseRecordLayout(schema)
+
+  const take = (): RecordBatchView<T> | null => {
+    const takeBuffer = globalThis.__irBulkTake
+    if (!takeBuffer) throw new Error("IRBulkChannel didn't install __irBulkTake")
+    const buffer = takeBuffer(name)
+    return buffer ? new RecordBatchView<T>(buffer, layout) : null
+  }
+
+  const subscribe = (onBatch: (batch: RecordBatchView<T>) => void) => {
+    let frame: number | null = null
+    let stopped = false
+
+    const flush = () => {
+      frame = null
+      if (stopped) return
+      for (let batch = take(); batch; batch = take()) onBatch(batch)
+    }
+
+    const subscription = IRBulkChannel.onBulkChannelPending((event) => {
+      if (event.channel === name && frame === null && !stopped) {
+        frame = requestAnimationFrame(flush)
+      }
+    })
+    // Batches that were waiting before anyone subscribed
+    frame = requestAnimationFrame(flush)
+
+    return () => {
+      stopped = true
+      if (frame !== null) cancelAnimationFrame(frame)
+      subscription.remove()
+    }
+  }
+
+  return { name, layout, take, subscribe }
+}
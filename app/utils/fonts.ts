@@ -0,0 +1,24 @@
+import IRFontList, { FontFamily } from "../native/IRFontList/NativeIRFontList"
+
+export type { FontFamily }
+
+/**
+ * Starts loading the installed fonts in the background, so they're ready by the time
+ * anything asks. Later launches read them from a cache unless fonts were added or removed.
+ */
+export function startFontCatalog() {
+  IRFontList.startCatalog()
+}
+
+/** Every installed family, sorted by name; waits for the catalog to load. */
+export function getFontFamilies(): Promise<FontFamily[]> {
+  return IRFontList.getFontFamilies()
+}
+
+/** Families matching `query` by prefix or fuzzily, best first. Empty until the catalog loads. */
+export function searchFonts(
+  query: string,
+  { limit = 20, monospaceOnly = false } = {},
+): FontFamily[] {
+  return IRFontList.searchFonts(query, limit, monospaceOnly)
+}
@@ -0,0 +1,9 @@
+import IRIds from "../native/IRIds/NativeIRIds"
+
+/**
+ * Call when the whole timeline is cleared outside the relay stream, as on disconnecting; a
+ * "clear" command clears them natively. Handles aren't reused afterwards.
+ */
+export function clearItemHandles() {
+  IRIds.clearItems()
+}
@@ -0,0 +1,72 @@
+import { useEffect, useState } from "react"
+import IRLogStats, { LogHeavyHitters } from "../native/IRLogStats/NativeIRLogStats"
+import type { TimelineItemLog } from "../types"
+import { updateTimelineItem } from "./payloadArena"
+
+/**
+ * Each client's newest timeline item, while it's a log that repeats can still fold into.
+ * Anything else the client sends ends the run.
+ */
+const _runs = new Map<string, { item: TimelineItemLog; logKey: string }>()
+
+/**
+ * Folds a log into the client's previous timeline item if that is the same log. `logKey` is
+ * the fingerprint the relay's ingest workers gave it, equal for the same level, message and
+ * stack top; they've already counted it in the session's heavy hitters. Returns the previous
+ * item's replacement, with the repeat counted, for the caller to swap into the timeline; the
+ * log itself must then not be added. Returns null if the log starts a new run.
+ */
+export function collapseRepeatedLog(
+  item: TimelineItemLog,
+  logKey: string,
+): { previous: TimelineItemLog; folded: TimelineItemLog } | null {
+  const run = _runs.get(item.clientId)
+  if (logKey && run && run.logKey === logKey) {
+    const previous = run.item
+    run.item = updateTimelineItem(previous, {
+      repeatCount: (previous.repeatCount ?? 1) + 1,
+      lastDate: item.date,
+      important: previous.important || item.important,
+    })
+    return { previous, folded: run.item }
+  }
+  _runs.set(item.clientId, { item, logKey })
+  return null
+}
+
+/** Points the client's run at `item`, the copy of its log that went into the timeline. */
+export function moveLogRun(item: TimelineItemLog) {
+  const run = _runs.get(item.clientId)
+  if (run) run.item = item
+}
+
+/** Call when a client's newest timeline item is not a log, or was removed. */
+export function endLogRun(clientId: string) {
+  _runs.delete(clientId)
+}
+
+export function resetLogRuns() {
+  _runs.clear()
+}
+
+export function clearLogHeavyHitters() {
+  IRLogStats.clear()
+}
+
+/**
+ * Polls the session's noisiest log sources.
+ */
+export function useLogHeavyHitters(intervalMs: number = 1000): LogHeavyHitters {
+  const [heavyHitters, setHeavyHitters] = useState<LogHeavyHitters>(() =>
+    IRLogStats.getHeavyHitters(),
+  )
+
+  useEffect(() => {
+    const refresh = () => setHeavyHitters(IRLogStats.getHeavyHitters())
+    refresh()
+    const interval = setInterval(refresh, intervalMs)
+    return () => clearInterval(interval)
+  }, [intervalMs])
+
+  return heavyHitters
+}
@@ -0,0 +1,126 @@
+import IRMemoryGovernor, { MemoryUsage } from "../native/IRMemoryGovernor/NativeIRMemoryGovernor"
+import IRPayloadArena from "../native/IRPayloadArena/NativeIRPayloadArena"
+import { withGlobal } from "../state/useGlobal"
+import type { TimelineItem } from "../types"
+import { releasePayloads } from "./payloadArena"
+import { refreshStateSnapshots } from "./stateSnapshots"
+import { stringifySafe } from "./stringifySafe"
+import { dropQueryRowsBefore } from "./timelineQuery"
+
+// How often usage is reported and budgets enforced
+const ENFORCE_INTERVAL = 5_000
+// Rough JS heap cost of a timeline item beyond its payload, which lives in the arena
+const TIMELINE_ITEM_BYTES = 320
+// Eviction never empties the timeline completely
+const MIN_TIMELINE_ITEMS = 100
+
+const MB = 1024 * 1024
+export const DEFAULT_MEMORY_BUDGETS: Record<string, number> = {
+  global: 1024 * MB,
+  timeline: 512 * MB,
+  stateSnapshots: 256 * MB,
+  taskScrollback: 64 * MB,
+}
+
+function budgets(): Record<string, number> {
+  const [saved] = withGlobal("memoryBudgets", DEFAULT_MEMORY_BUDGETS, { persist: true })
+  return { ...DEFAULT_MEMORY_BUDGETS, ...saved }
+}
+
+/** Changes a budget ("global" for the total); 0 removes it. Saved across launches. */
+export function setMemoryBudget(store: string, bytes: number) {
+  const [, setSaved] = withGlobal("memoryBudgets", DEFAULT_MEMORY_BUDGETS, { persist: true })
+  setSaved((saved) => ({ ...saved, [store]: bytes }))
+  applyBudget(store, bytes)
+}
+
+function applyBudget(store: string, bytes: number) {
+  if (store === "global") IRMemoryGovernor.setGlobalBudget(bytes)
+  else IRMemoryGovernor.setBudget(store, bytes)
+}
+
+function timelineBytes(items: readonly TimelineItem[]): number {
+  return IRPayloadArena.getStats().allocatedBytes + items.length * TIMELINE_ITEM_BYTES
+}
+
+function reportTimeline() {
+  const [items] = withGlobal<TimelineItem[]>("timelineItems", [])
+  const oldest = items.length > 0 ? Date.parse(items[0].date) : 0
+  IRMemoryGovernor.report("timeline", timelineBytes(items), Number.isFinite(oldest) ? oldest : 0, true)
+}
+
+// Sizes of the objects already measured. Globals are replaced rather than changed in place, so
+// an unchanged one is only serialized once.
+const _measured = new WeakMap<object, number>()
+
+/** About what `value` takes in the JS heap: its JSON, at two bytes a character. */
+function measure(value: unknown): number {
+  if (typeof value !== "object" || value === null) return 0
+  let bytes = _measured.get(value)
+  if (bytes === undefined) {
+    bytes = (stringifySafe(value)?.length ?? 0) * 2
+    _measured.set(value, bytes)
+  }
+  return bytes
+}
+
+/**
+ * Reports the per-client globals: the state subscriptions' values and each client's
+ * connection data. Neither can be evicted while its client is connected, so they're only
+ * counted, against the global budget and in the breakdown.
+ */
+function reportClientStores() {
+  const [subscriptions] = withGlobal<Record<string, unknown[]>>("stateSubscriptionsByClientId", {})
+  let subscriptionBytes = 0
+  for (const clientSubscriptions of Object.values(subscriptions)) {
+    subscriptionBytes += measure(clientSubscriptions)
+  }
+  IRMemoryGovernor.report("stateSubscriptions", subscriptionBytes, 0, false)
+
+  const [clientIds] = withGlobal<string[]>("clientIds", [])
+  let clientBytes = 0
+  for (const clientId of clientIds) clientBytes += measure(withGlobal(`client-${clientId}`, {})[0])
+  IRMemoryGovernor.report("clientData", clientBytes, 0, false)
+}
+
+/** Drops the oldest timeline items, about `bytes` worth, and frees their payloads. */
+function evictTimeline(bytes: number) {
+  const [, setTimelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
+  setTimelineItems((prev) => {
+    if (prev.length <= MIN_TIMELINE_ITEMS) return prev
+    const perItem = timelineBytes(prev) / prev.length
+    const count = Math.min(Math.ceil(bytes / perItem), prev.length - MIN_TIMELINE_ITEMS)
+    if (count <= 0) return prev
+    releasePayloads(prev.slice(0, count))
+    const kept = prev.slice(count)
+    dropQueryRowsBefore(kept)
+    return kept
+  })
+}
+
+/** Reports the stores kept in JS, enforces the budgets and publishes the breakdown. */
+export function enforceMemoryBudgets() {
+  reportTimeline()
+  reportClientStores()
+  const evictions = IRMemoryGovernor.enforce()
+  for (const eviction of evictions) {
+    if (eviction.store === "timeline") evictTimeline(eviction.bytes)
+    // Native stores have freed theirs; views of them need to catch up
+    else if (eviction.store === "stateSnapshots") refreshStateSnapshots()
+  }
+  if (evictions.some((eviction) => eviction.store === "timeline")) reportTimeline()
+
+  const [, setUsage] = withGlobal<MemoryUsage | null>("memoryUsage", null)
+  setUsage(IRMemoryGovernor.getUsage())
+}
+
+/**
+ * Applies the saved budgets and keeps every store within them from now on. Returns a function
+ * that stops enforcing.
+ */
+export function startMemoryGovernor(): () => void {
+  Object.entries(budgets()).forEach(([store, bytes]) => applyBudget(store, bytes))
+  enforceMemoryBudgets()
+  const interval = setInterval(enforceMemoryBudgets, ENFORCE_INTERVAL)
+  return () => clearInterval(interval)
+}
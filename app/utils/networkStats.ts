@@ -0,0 +1,66 @@
+import { useEffect, useState } from "react"
+import IRNetworkStats, { EndpointStats } from "../native/IRNetworkStats/NativeIRNetworkStats"
+import type { NetworkPayload } from "../types"
+import { isBodyRef } from "./bodyStore"
+
+export type NetworkStatsWindow = "1m" | "5m" | "session"
+
+function headerValue(headers: Record<string, string> | undefined, name: string) {
+  if (!headers) return undefined
+  for (const key in headers) {
+    if (key.toLowerCase() === name) return headers[key]
+  }
+  return undefined
+}
+
+/**
+ * Best-effort payload size: the content-length header if present, else the length of a
+ * string body or of a body the relay set aside. Bodies the client already parsed are not
+ * re-serialized just to be measured.
+ */
+function payloadBytes(headers: Record<string, string> | undefined, data: unknown): number {
+  const contentLength = Number(headerValue(headers, "content-length"))
+  if (Number.isFinite(contentLength) && contentLength >= 0) return contentLength
+  if (typeof data === "string") return data.length
+  if (isBodyRef(data)) return data.size
+  return 0
+}
+
+/**
+ * Feeds one api.response command into the native per-endpoint aggregates.
+ */
+export function recordApiResponse(payload: NetworkPayload) {
+  const { request, response, error } = payload
+  if (!request?.url) return
+  IRNetworkStats.record(
+    request.method ?? "GET",
+    request.url,
+    error || !response ? 0 : response.status ?? 0,
+    response?.duration ?? 0,
+    payloadBytes(request.headers, request.data),
+    payloadBytes(response?.headers, response?.data),
+  )
+}
+
+export function clearNetworkStats() {
+  IRNetworkStats.clear()
+}
+
+/**
+ * Polls the per-endpoint aggregates for `window`. Snapshots are computed natively and only
+ * cover endpoints with traffic in the window, so polling stays cheap however busy the app is.
+ */
+export function useNetworkStats(window: NetworkStatsWindow, intervalMs: number = 1000) {
+  const [stats, setStats] = useState<ReadonlyArray<EndpointStats>>(() =>
+    IRNetworkStats.getSnapshot(window),
+  )
+
+  useEffect(() => {
+    const refresh = () => setStats(IRNetworkStats.getSnapshot(window))
+    refresh()
+    const interval = setInterval(refresh, intervalMs)
+    return () => clearInterval(interval)
+  }, [window, intervalMs])
+
+  return stats
+}
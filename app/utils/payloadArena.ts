@@ -0,0 +1,142 @@
+import IRPayloadArena from "../native/IRPayloadArena/NativeIRPayloadArena"
+import type { TimelineItem } from "../types"
+import { clearBodies, payloadBodyIds, releaseBodies } from "./bodyStore"
+
+// Materialized payloads, least recently used first; visible rows re-read theirs every render
+const CACHE_SIZE = 500
+const _cache = new Map<number, unknown>()
+
+function cachePayload(handle: number, payload: unknown) {
+  _cache.delete(handle)
+  _cache.set(handle, payload)
+  if (_cache.size > CACHE_SIZE) _cache.delete(_cache.keys().next().value as number)
+}
+
+function loadPayload(handle: number): any {
+  if (_cache.has(handle)) {
+    const payload = _cache.get(handle)
+    cachePayload(handle, payload)
+    return payload
+  }
+  const json = IRPayloadArena.materialize(handle)
+  const payload = json ? JSON.parse(json) : {}
+  cachePayload(handle, payload)
+  return payload
+}
+
+/**
+ * Prototype of timeline items whose payload lives in the native arena. `payload` is a getter
+ * here and `payloadHandle` a non-enumerable own property, so neither is searched, spread or
+ * stringified with the item; see itemWithPayload().
+ */
+const CompactItemPrototype = Object.create(Object.prototype, {
+  payload: {
+    get(this: { payloadHandle: number }) {
+      return loadPayload(this.payloadHandle)
+    },
+  },
+})
+
+function payloadHandle(item: object): number {
+  return (item as { payloadHandle?: number }).payloadHandle ?? 0
+}
+
+function bodyIds(item: object): readonly number[] {
+  return (item as { bodyIds?: number[] }).bodyIds ?? []
+}
+
+/**
+ * Hands a new timeline item's payload over to the native arena, where keys and object shapes
+ * are stored once per session. `handle` is where the relay's ingest workers already stored it,
+ * from the message itself, or 0 if they didn't; the item takes ownership of it. Returns the
+ * item to keep in the timeline, or the same item if there's no handle. Either way the item
+ * notes the IRBodyStore bodies its payload refers to, so they're released with it.
+ */
+export function compactTimelineItem<T extends TimelineItem>(item: T, handle: number): T {
+  const ids = payloadBodyIds(item.payload)
+  if (!handle) {
+    if (ids.length > 0) Object.defineProperty(item, "bodyIds", { value: ids })
+    return item
+  }
+
+  const compact = Object.create(CompactItemPrototype)
+  for (const key in item) {
+    if (key !== "payload") compact[key] = item[key]
+  }
+  Object.defineProperty(compact, "payloadHandle", { value: handle })
+  if (ids.length > 0) Object.defineProperty(compact, "bodyIds", { value: ids })
+  // It was just parsed and is about to be rendered, so start it off in the cache
+  cachePayload(handle, item.payload)
+  return compact
+}
+
+/**
+ * A copy of the item with `changes` applied. A compact item's copy shares its arena payload
+ * (and bodies) instead of materializing it, so it's a replacement, not a second owner.
+ */
+export function updateTimelineItem<T extends TimelineItem>(item: T, changes: Partial<T>): T {
+  const copy = Object.create(Object.getPrototypeOf(item), Object.getOwnPropertyDescriptors(item))
+  return Object.assign(copy, changes)
+}
+
+/** The item with its payload as a plain own property, for serializing. */
+export function itemWithPayload<T extends TimelineItem>(item: T): T {
+  return payloadHandle(item) ? { ...item, payload: item.payload } : item
+}
+
+/**
+ * Whether a value in the item's arena payload contains `query` (already normalized), or
+ * undefined if the payload isn't in the arena. Queries the arena can't match exactly, such
+ * as non-ASCII text or characters JSON escapes, fall back to `matches` on the payload.
+ */
+export function compactPayloadContains(
+  item: object,
+  query: string,
+  matches: (payload: unknown) => boolean,
+): boolean | undefined {
+  const handle = payloadHandle(item)
+  if (!handle) return undefined
+  if (/^[\x20-\x7e]*$/.test(query) && !/["\\]/.test(query)) {
+    return IRPayloadArena.contains(handle, query)
+  }
+  return matches((item as TimelineItem).payload)
+}
+
+/**
+ * The item's payload as JSON, straight from the arena, or undefined if it isn't there. Saves
+ * stringifying a large payload that was only parsed to be shown as text.
+ */
+export function payloadJson(item: object): string | undefined {
+  const handle = payloadHandle(item)
+  return handle ? IRPayloadArena.materialize(handle) || undefined : undefined
+}
+
+/** Call with timeline items that were removed, so their payloads and bodies are freed. */
+export function releasePayloads(items: readonly TimelineItem[]) {
+  const handles: number[] = []
+  const ids: number[] = []
+  items.forEach((item) => {
+    ids.push(...bodyIds(item))
+    const handle = payloadHandle(item)
+    if (!handle) return
+    handles.push(handle)
+    _cache.delete(handle)
+  })
+  if (handles.length > 0) IRPayloadArena.releasePayloads(handles)
+  releaseBodies(ids)
+}
+
+/** Call with the handles of stored payloads whose messages didn't become timeline items. */
+export function releasePayloadHandles(handles: readonly number[]) {
+  if (handles.length > 0) IRPayloadArena.releasePayloads(handles)
+}
+
+/**
+ * Call when the connection is gone and the whole timeline with it. While it's open, release the
+ * cleared items instead: the payloads of messages still on their way are already stored.
+ */
+export function clearPayloads() {
+  _cache.clear()
+  IRPayloadArena.clear()
+  clearBodies()
+}
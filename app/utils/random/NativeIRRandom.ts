@@ -1,6 +0,0 @@
-import type { TurboModule } from "react-native"
-import { TurboModuleRegistry } from "react-native"
-export interface Spec extends TurboModule {
-  getUUID(): string
-}
-export default TurboModuleRegistry.getEnforcing<Spec>("IRRandom")
@@ -1,13 +1,12 @@
-/* @turbomodule IRRandom.getUUID(): string
-#import <Foundation/Foundation.h>
+import IRIds from "../../native/IRIds/NativeIRIds"
 
-- (NSString *)getUUID {
-  return [[NSUUID UUID] UUIDString];
-}
-*/
+// UUIDs are made natively this many at a time, then handed out one by one
+const UUID_BATCH = 64
 
-import IRRandom from "./NativeIRRandom"
+let _uuids: string[] = []
 
+/** A time-ordered (version 7) UUID. */
 export function getUUID(): string {
-  return IRRandom.getUUID()
+  if (_uuids.length === 0) _uuids = IRIds.getUUIDs(UUID_BATCH).reverse()
+  return _uuids.pop()!
 }
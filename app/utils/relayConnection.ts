@@ -0,0 +1,84 @@
+import IRRelaySocket, {
+  type IngestedMessages,
+  type RelayClientStats,
+} from "../native/IRRelaySocket/NativeIRRelaySocket"
+
+export type { IngestedMessages }
+
+export interface RelayHandlers {
+  onOpen: () => void
+  /** Every message that arrived since the last call, in order, with what ingest found out. */
+  onMessages: (batch: IngestedMessages) => void
+  onError: (message: string) => void
+  onClose: () => void
+}
+
+export interface RelayConnection {
+  send: (text: string) => void
+  /** Delivers whatever is waiting now, rather than on the next frame. */
+  flush: () => void
+  /** What has arrived from each client so far. */
+  clientStats: () => RelayClientStats[]
+  close: () => void
+}
+
+/**
+ * Opens the WebSocket to the relay natively. The socket is read and unframed on its own
+ * thread, and what arrives is handed over at most once per animation frame, so a burst of
+ * messages costs the JS thread one call instead of one callback each. Messages are validated
+ * and stripped of "__proto__" keys on native workers first, one client's in parallel with
+ * another's, and still arrive in the order the relay sent them. Logs arrive fingerprinted.
+ */
+export function openRelayConnection(url: string, handlers: RelayHandlers): RelayConnection {
+  const socketId = IRRelaySocket.connect(url)
+
+  let frame: number | null = null
+  let closed = false
+
+  const flush = () => {
+    if (frame !== null) cancelAnimationFrame(frame)
+    frame = null
+    if (closed) return
+    const batch = IRRelaySocket.takeBatch(socketId)
+    if (batch.opened) handlers.onOpen()
+    if (batch.messages.length > 0) handlers.onMessages(batch)
+    if (batch.error) handlers.onError(batch.error)
+    if (batch.closed) {
+      closed = true
+      subscription.remove()
+      handlers.onClose()
+    }
+  }
+
+  const subscription = IRRelaySocket.onRelaySocketPending((event) => {
+    if (event.socketId === socketId && frame === null && !closed) {
+      frame = requestAnimationFrame(flush)
+    }
+  })
+  // A URL that couldn't be used was reported before there was anyone to tell
+  frame = requestAnimationFrame(flush)
+
+  return {
+    send: (text) => {
+      if (!IRRelaySocket.send(socketId, text)) console.tron.log("Relay socket is not open")
+    },
+    flush,
+    clientStats: () => IRRelaySocket.clientStats(socketId),
+    close: () => {
+      if (closed) return
+      closed = true
+      if (frame !== null) cancelAnimationFrame(frame)
+      subscription.remove()
+      IRRelaySocket.close(socketId)
+      handlers.onClose()
+    },
+  }
+}
+
+/**
+ * Runs messages that didn't come from the relay, such as an imported session's, through the
+ * same native checks, so they're handled exactly like a batch from the socket.
+ */
+export function ingestMessages(texts: string[]): IngestedMessages {
+  return IRRelaySocket.ingest(texts)
+}
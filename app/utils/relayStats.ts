@@ -0,0 +1,81 @@
+import { useGlobal, withGlobal } from "../state/useGlobal"
+import type { RelayClientStats } from "../native/IRRelaySocket/NativeIRRelaySocket"
+
+/** Forward latencies over one stats interval, in ms; percentiles are bucket upper bounds. */
+export interface RelayLatency {
+  count: number
+  p50: number
+  p90: number
+  p99: number
+  max: number
+}
+
+/**
+ * One socket on the relay, counted from the relay's side: "in" is what the relay received from
+ * it, "out" what it sent to it. Rates, queue high-water marks and latencies cover the last
+ * interval; the rest are totals since the socket connected.
+ */
+export interface RelayPeerStats {
+  kind: "client" | "subscriber"
+  /** The clientId, or the Reactotron app's id. */
+  id: string
+  name: string
+  connectedAt: number
+  messagesIn: number
+  bytesIn: number
+  messagesOut: number
+  bytesOut: number
+  /** Sends that failed or found the socket closed. */
+  drops: number
+  /** Messages from a client while no Reactotron app was connected. */
+  unrouted: number
+  messagesInPerSec: number
+  bytesInPerSec: number
+  messagesOutPerSec: number
+  bytesOutPerSec: number
+  /** Bytes waiting in the socket to be written, now and at most during the interval. */
+  queueDepth: number
+  maxQueueDepth: number
+  /** From a client's message arriving at the relay to its write to each app. */
+  latency: RelayLatency
+}
+
+/** The payload of a "reactotron.relayStats" message; see relay-stats.js. */
+export interface RelayStats {
+  time: number
+  uptime: number
+  intervalMs: number
+  totals: {
+    messagesIn: number
+    bytesIn: number
+    messagesOut: number
+    bytesOut: number
+    drops: number
+  }
+  clients: RelayPeerStats[]
+  subscribers: RelayPeerStats[]
+}
+
+export interface RelayHealth {
+  relay: RelayStats
+  /** What this app has received from each client, counted natively as it arrived. */
+  received: RelayClientStats[]
+  receivedAt: number
+}
+
+/** Publishes the relay's latest counters alongside this app's own. */
+export function recordRelayStats(relay: RelayStats, received: RelayClientStats[]) {
+  const [, setHealth] = withGlobal<RelayHealth | null>("relayHealth", null)
+  setHealth({ relay, received, receivedAt: Date.now() })
+}
+
+export function clearRelayStats() {
+  const [, setHealth] = withGlobal<RelayHealth | null>("relayHealth", null)
+  setHealth(null)
+}
+
+/** The latest relay counters, or null until the relay has sent any. */
+export function useRelayHealth(): RelayHealth | null {
+  const [health] = useGlobal<RelayHealth | null>("relayHealth", null)
+  return health
+}
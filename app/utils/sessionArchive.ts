@@ -0,0 +1,124 @@
+import IRSessionArchive, {
+  SessionExportResult,
+} from "../native/IRSessionArchive/NativeIRSessionArchive"
+import { withGlobal } from "../state/useGlobal"
+import { inlineBodies } from "./bodyStore"
+import { itemWithPayload } from "./payloadArena"
+import type { StateSubscription, TimelineItem } from "../types"
+import { stringifySafe } from "./stringifySafe"
+
+// Server messages worth replaying; the rest describe the live connection, not the session
+const RECORDED_MESSAGE_TYPES = ["connectionEstablished", "command"]
+
+let _recording = false
+// Messages waiting for flushSessionMessages(), as parallel arrays
+let _times: number[] = []
+let _types: string[] = []
+let _texts: string[] = []
+
+function messageType(data: any): string {
+  return data.type === "command" ? data.cmd?.type ?? "command" : data.type
+}
+
+function appendMessage(time: number, data: any, text?: string) {
+  const json = text ?? stringifySafe(data)
+  if (!json) return
+  _times.push(time)
+  _types.push(messageType(data))
+  // The archive has to stand on its own, so bodies the relay set aside are written in full
+  _texts.push(inlineBodies(json))
+}
+
+/**
+ * Tees one raw server message into the export in progress, if any. `text` is the message as
+ * received, so nothing is serialized twice. It's sent on by flushSessionMessages().
+ */
+export function recordSessionMessage(data: any, text: string) {
+  if (!_recording || !RECORDED_MESSAGE_TYPES.includes(data?.type)) return
+  appendMessage(Date.now(), data, text)
+}
+
+/** Hands the messages recorded since the last flush to the archive in one call. */
+export function flushSessionMessages() {
+  if (_texts.length === 0) return
+  IRSessionArchive.appendBatch(_times, _types, _texts)
+  _times = []
+  _types = []
+  _texts = []
+}
+
+/**
+ * Starts exporting the session to an archive the user picks: the current clients, timeline
+ * and state subscriptions are written first, then every message until finishSessionExport().
+ * Resolves false if the user cancelled.
+ */
+export async function startSessionExport(): Promise<boolean> {
+  const defaultName = `Reactotron ${new Date().toISOString().replace(/[:.]/g, "-")}.rtsession`
+  const path = await IRSessionArchive.pickExportPath(defaultName)
+  if (!path) return false
+  if (!IRSessionArchive.startExport(path)) throw new Error(`Could not write ${path}`)
+
+  // Snapshot, as the messages that would rebuild it
+  const [clientIds] = withGlobal<string[]>("clientIds", [])
+  clientIds.forEach((clientId) => {
+    const [conn] = withGlobal(`client-${clientId}`, {})
+    appendMessage(Date.now(), { type: "connectionEstablished", conn })
+  })
+  const [timelineItems] = withGlobal<TimelineItem[]>("timelineItems", [])
+  timelineItems.forEach((cmd) => {
+    const time = Date.parse(cmd.date)
+    appendMessage(Number.isFinite(time) ? time : Date.now(), {
+      type: "command",
+      cmd: itemWithPayload(cmd),
+    })
+  })
+  const [subscriptions] = withGlobal<{ [clientId: string]: StateSubscription[] }>(
+    "stateSubscriptionsByClientId",
+    {},
+  )
+  Object.entries(subscriptions).forEach(([clientId, changes]) => {
+    const cmd = { type: "state.values.change", clientId, payload: { changes } }
+    appendMessage(Date.now(), { type: "command", cmd })
+  })
+  flushSessionMessages()
+
+  _recording = true
+  const [, setExportPath] = withGlobal("sessionExportPath", "")
+  setExportPath(path)
+  return true
+}
+
+export async function finishSessionExport(): Promise<SessionExportResult> {
+  flushSessionMessages()
+  _recording = false
+  const [, setExportPath] = withGlobal("sessionExportPath", "")
+  setExportPath("")
+  const result = await IRSessionArchive.finishExport()
+  if (result.dropped > 0) {
+    console.warn(`Session export dropped ${result.dropped} messages it couldn't write fast enough`)
+  }
+  return result
+}
+
+/**
+ * Replays an archive the user picks, a chunk at a time, so neither the file nor its decoded
+ * messages are ever held in memory at once. `replay` applies one chunk's messages as if the
+ * server had sent them, skipping damaged ones, and returns how many it applied. Resolves the
+ * number of messages replayed.
+ */
+export async function importSession(replay: (texts: string[]) => number): Promise<number> {
+  const path = await IRSessionArchive.pickImportPath()
+  if (!path) return 0
+
+  const session = await IRSessionArchive.openSession(path)
+  let replayed = 0
+  try {
+    for (let index = 0; index < session.chunks; index++) {
+      const chunk = await IRSessionArchive.readChunk(session.sessionId, index)
+      replayed += replay(chunk.texts)
+    }
+  } finally {
+    IRSessionArchive.closeSession(session.sessionId)
+  }
+  return replayed
+}
@@ -0,0 +1,91 @@
+import { useEffect, useState } from "react"
+import IRStateSnapshots, {
+  StateSnapshotChange,
+  StateSnapshotInfo,
+} from "../native/IRStateSnapshots/NativeIRStateSnapshots"
+import { useGlobal, withGlobal } from "../state/useGlobal"
+
+// Each client's outstanding state.backup.request, at most one; given up on after a while
+const _pendingRequests = new Map<string, { label: string; sentAt: number }>()
+const PENDING_REQUEST_TIMEOUT = 10_000
+
+/** Makes views of the snapshot history reload it, e.g. after the oldest were evicted. */
+export function refreshStateSnapshots() {
+  const [, setRevision] = withGlobal("stateSnapshotsRevision", 0)
+  setRevision((revision) => revision + 1)
+}
+
+/**
+ * Notes that a state.backup.request is about to go to `clientId`, so its response gets
+ * `label`. Returns false if one is already outstanding and no request should be sent.
+ */
+export function expectStateSnapshot(clientId: string, label: string): boolean {
+  const pending = _pendingRequests.get(clientId)
+  if (pending && Date.now() - pending.sentAt < PENDING_REQUEST_TIMEOUT) return false
+  _pendingRequests.set(clientId, { label, sentAt: Date.now() })
+  return true
+}
+
+/**
+ * Called for each state.action.complete. Returns true if the client's state should be
+ * captured now, with the action's name as the snapshot's label.
+ */
+export function captureAfterAction(cmd: any): boolean {
+  const [capture] = withGlobal("stateSnapshotCapture", false, { persist: true })
+  if (!capture) return false
+  return expectStateSnapshot(cmd.clientId, cmd.payload?.name ?? "action")
+}
+
+/** Stores a state.backup.response in the snapshot history. */
+export function recordStateBackup(cmd: any) {
+  const label = _pendingRequests.get(cmd.clientId)?.label ?? "Backup"
+  _pendingRequests.delete(cmd.clientId)
+  const json = JSON.stringify(cmd.payload?.state ?? null)
+  const time = Date.parse(cmd.date)
+  IRStateSnapshots.add(cmd.clientId, label, Number.isFinite(time) ? time : Date.now(), json)
+    .then(refreshStateSnapshots)
+    .catch((error) => console.warn("Could not store state snapshot:", error))
+}
+
+/** The snapshot's state, as the client sent it. */
+export async function loadStateSnapshot(id: number): Promise<any> {
+  return JSON.parse(await IRStateSnapshots.materialize(id))
+}
+
+export function diffStateSnapshots(from: number, to: number): Promise<StateSnapshotChange[]> {
+  return IRStateSnapshots.diff(from, to)
+}
+
+export function removeStateSnapshot(id: number) {
+  IRStateSnapshots.remove(id)
+  refreshStateSnapshots()
+}
+
+export function clearStateSnapshots() {
+  IRStateSnapshots.clear()
+  _pendingRequests.clear()
+  refreshStateSnapshots()
+}
+
+/** Forgets outstanding requests, e.g. after a disconnect; the snapshots stay. */
+export function resetStateSnapshotRequests() {
+  _pendingRequests.clear()
+}
+
+/** The client's snapshots, oldest first, refreshed whenever one is added or removed. */
+export function useStateSnapshots(clientId: string): StateSnapshotInfo[] {
+  const [revision] = useGlobal("stateSnapshotsRevision", 0)
+  const [snapshots, setSnapshots] = useState<StateSnapshotInfo[]>([])
+
+  useEffect(() => {
+    let cancelled = false
+    IRStateSnapshots.list(clientId).then((list) => {
+      if (!cancelled) setSnapshots(list)
+    })
+    return () => {
+      cancelled = true
+    }
+  }, [clientId, revision])
+
+  return snapshots
+}
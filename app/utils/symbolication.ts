@@ -0,0 +1,134 @@
+import { useEffect, useState } from "react"
+import IRSymbolicator, {
+  type SymbolicatedFrame,
+} from "../native/IRSymbolicator/NativeIRSymbolicator"
+import type { ErrorStackFrame } from "../types"
+
+// Frames already mapped, by bundle and position, so reopening an error costs nothing. Kept only
+// as long as the native side keeps a downloaded map before checking it again, since Fast Refresh
+// changes what a bundle URL maps to; failures expire the same way, so they're retried.
+const MAX_CACHED_FRAMES = 5000
+const CACHED_FRAME_MS = 2000
+const cache = new Map<string, { frame: SymbolicatedFrame; at: number }>()
+
+type Waiter = (frame: SymbolicatedFrame) => void
+// Frames asked for since the last flush; they go to the native side in one call
+let queued = new Map<string, { frame: ErrorStackFrame; waiters: Waiter[] }>()
+let flushFrame = 0
+// Bumped by invalidateSourceMaps(), so a batch that started before it isn't cached
+let generation = 0
+
+const UNRESOLVED: SymbolicatedFrame = {
+  resolved: false,
+  fileName: "",
+  lineNumber: 0,
+  columnNumber: 0,
+  error: "",
+}
+
+// Metro bundles: URLs, or paths to a .bundle or .jsbundle. Anything else is already a source.
+const BUNDLE_FILE = /^https?:\/\/|\.(js)?bundle($|\?|\/\/&)/
+
+function isBundleFrame(frame: any): frame is ErrorStackFrame {
+  return (
+    typeof frame === "object" &&
+    frame !== null &&
+    typeof frame.fileName === "string" &&
+    typeof frame.lineNumber === "number" &&
+    frame.lineNumber > 0 &&
+    BUNDLE_FILE.test(frame.fileName)
+  )
+}
+
+function frameKey(frame: ErrorStackFrame) {
+  return `${frame.fileName}:${frame.lineNumber}:${frame.columnNumber ?? 0}`
+}
+
+function remember(key: string, frame: SymbolicatedFrame) {
+  cache.delete(key)
+  cache.set(key, { frame, at: Date.now() })
+  if (cache.size > MAX_CACHED_FRAMES) cache.delete(cache.keys().next().value as string)
+}
+
+function flush() {
+  flushFrame = 0
+  const batch = [...queued]
+  queued = new Map()
+  const batchGeneration = generation
+  const settle = (results: SymbolicatedFrame[]) => {
+    batch.forEach(([key, { waiters }], index) => {
+      const result = results[index] ?? UNRESOLVED
+      if (batchGeneration === generation) remember(key, result)
+      waiters.forEach((waiter) => waiter(result))
+    })
+  }
+  IRSymbolicator.symbolicate(
+    batch.map(([, { frame }]) => frame.fileName),
+    batch.map(([, { frame }]) => frame.lineNumber),
+    batch.map(([, { frame }]) => frame.columnNumber ?? 0),
+  ).then(settle, () => settle([]))
+}
+
+function symbolicateFrame(frame: ErrorStackFrame): Promise<SymbolicatedFrame> {
+  const key = frameKey(frame)
+  const cached = cache.get(key)
+  if (cached && Date.now() - cached.at < CACHED_FRAME_MS) return Promise.resolve(cached.frame)
+  return new Promise((resolve) => {
+    const entry = queued.get(key)
+    if (entry) entry.waiters.push(resolve)
+    else queued.set(key, { frame, waiters: [resolve] })
+    if (!flushFrame) flushFrame = requestAnimationFrame(flush)
+  })
+}
+
+/**
+ * `stack` with its bundle frames mapped back to their sources, natively and off the JS thread.
+ * An error storm's frames are sent in one batch a frame, and each bundle's source map is loaded
+ * once. Frames that can't be mapped, and anything that isn't a frame, are left as they are;
+ * function names are kept, as a dev bundle's are already the original ones.
+ */
+export async function symbolicateStack(stack: readonly unknown[]): Promise<unknown[]> {
+  return Promise.all(
+    stack.map(async (frame) => {
+      if (!isBundleFrame(frame)) return frame
+      const result = await symbolicateFrame(frame)
+      if (!result.resolved) return frame
+      return {
+        ...frame,
+        fileName: result.fileName,
+        lineNumber: result.lineNumber,
+        columnNumber: result.columnNumber,
+      }
+    }),
+  )
+}
+
+/** Starts mapping an error log's stack as it arrives, so it's ready when the log is opened. */
+export function prefetchSymbolication(stack: unknown) {
+  if (Array.isArray(stack) && stack.some(isBundleFrame)) symbolicateStack(stack)
+}
+
+/** Forgets mapped frames and loaded maps, as when an app reloads with a new bundle. */
+export function invalidateSourceMaps() {
+  generation++
+  cache.clear()
+  IRSymbolicator.invalidateSourceMaps()
+}
+
+/** `stack`, symbolicated once that's done; until then, or if it isn't a list of frames, as is. */
+export function useSymbolicatedStack<T>(stack: T): T | unknown[] {
+  const [symbolicated, setSymbolicated] = useState<{ stack: T; frames: unknown[] } | null>(null)
+
+  useEffect(() => {
+    if (!Array.isArray(stack) || !stack.some(isBundleFrame)) return
+    let cancelled = false
+    symbolicateStack(stack).then((frames) => {
+      if (!cancelled) setSymbolicated({ stack, frames })
+    })
+    return () => {
+      cancelled = true
+    }
+  }, [stack])
+
+  return symbolicated?.stack === stack ? symbolicated.frames : stack
+}
@@ -2,7 +2,7 @@ import { useEffect, useRef } from "react"
 import IRRunShellCommand from "../native/IRRunShellCommand/NativeIRRunShellCommand"
 import IRSystemInfo, { SystemInfo } from "../native/IRSystemInfo/NativeIRSystemInfo"
 import IRKeyboard, { KeyboardEvent } from "../native/IRKeyboard/NativeIRKeyboard"
-import { Platform, type EventSubscription } from "react-native"
+import { type EventSubscription } from "react-native"
 
 /**
  * Get the current memory usage of the app in MB via a shell command.
@@ -37,25 +37,82 @@ export function useSystemInfo(onInfo: (info: SystemInfo) => void) {
 }
 
 /**
- * Subscribe to keyboard events.
+ * Start recording memory and CPU history natively for the rest of the session. Charts read it
+ * back with IRSystemInfo.getHistory, downsampled to the points they draw.
+ */
+export function startSystemHistory() {
+  IRSystemInfo.startHistory()
+}
+
+let _keyboardListeners: number = 0
+function retainKeyboard() {
+  _keyboardListeners++
+  if (_keyboardListeners === 1) IRKeyboard.startListening()
+}
+function releaseKeyboard() {
+  _keyboardListeners--
+  if (_keyboardListeners === 0) IRKeyboard.stopListening()
+}
+
+let _keyboardSubscribers: number = 0
+/**
+ * Subscribe to raw keyboard events.
+ *
+ * Every keystroke crosses the bridge while this is mounted, so prefer useShortcut
+ * when you only care about specific key combinations.
  *
  * @param onKeyboardEvent - Callback to receive keyboard events.
  * @returns A function to unsubscribe from keyboard events.
  */
-let _keyboardSubscribers: number = 0
 export function useKeyboardEvents(onKeyboardEvent: (event: KeyboardEvent) => void, deps?: any[]) {
   const keyboardSubscription = useRef<EventSubscription | null>(null)
 
   useEffect(() => {
-    if (Platform.OS === "windows") return
+    retainKeyboard()
     _keyboardSubscribers++
-    if (_keyboardSubscribers === 1) IRKeyboard.startListening()
+    if (_keyboardSubscribers === 1) IRKeyboard.setRawEventsEnabled(true)
     keyboardSubscription.current = IRKeyboard.onKeyboardEvent(onKeyboardEvent)
 
     return () => {
       _keyboardSubscribers--
       keyboardSubscription.current?.remove()
-      if (_keyboardSubscribers === 0) IRKeyboard.stopListening()
+      if (_keyboardSubscribers === 0) IRKeyboard.setRawEventsEnabled(false)
+      releaseKeyboard()
     }
   }, deps ?? [])
 }
+
+let _shortcutCount: number = 0
+/**
+ * Subscribe to a keyboard shortcut. Matching happens natively, so only matches reach JS.
+ *
+ * Uses the same grammar as menu item shortcuts: "cmd+shift+k", "escape", or a
+ * space-separated sequence like "g g". Shifted punctuation can be written either way:
+ * "shift+/" and "?" are the same shortcut.
+ *
+ * @param shortcut - The shortcut to listen for.
+ * @param onShortcut - Called each time the shortcut is pressed.
+ */
+export function useShortcut(shortcut: string, onShortcut: () => void) {
+  // Keep the latest callback without re-registering the shortcut on every render.
+  const onShortcutRef = useRef(onShortcut)
+  onShortcutRef.current = onShortcut
+
+  useEffect(() => {
+    const shortcutId = `shortcut-${++_shortcutCount}`
+    if (!IRKeyboard.registerShortcut(shortcutId, shortcut)) {
+      console.warn(`Invalid shortcut: ${shortcut}`)
+      return
+    }
+    retainKeyboard()
+    const subscription = IRKeyboard.onShortcut((event) => {
+      if (event.id === shortcutId) onShortcutRef.current()
+    })
+
+    return () => {
+      subscription.remove()
+      IRKeyboard.unregisterShortcut(shortcutId)
+      releaseKeyboard()
+    }
+  }, [shortcut])
+}
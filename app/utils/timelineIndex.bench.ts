@@ -0,0 +1,99 @@
+/**
+ * What the timeline index costs at the sizes the timeline reaches: a full build, each sort mode,
+ * and the appends that normally keep it in sync, against sorting the array on every render as
+ * useTimeline did before. Runs under jest so the index is imported as the app imports it.
+ *
+ *   npm run bench:timeline
+ */
+import { CommandType } from "reactotron-core-contract"
+import type { TimelineItem } from "../types"
+import { getTimelineIndex } from "./timelineIndex"
+
+const ITEMS = 500000
+const APPENDS = 1000
+const RUNS = 5
+
+const TYPES = [CommandType.Log, CommandType.ApiResponse, CommandType.Display, CommandType.Benchmark]
+const LEVELS = ["debug", "info", "warn", "error"]
+const START = Date.UTC(2026, 0, 1)
+
+let _nextId = 1
+
+function makeItems(count: number, from = 0): TimelineItem[] {
+  const items: TimelineItem[] = []
+  for (let i = from; i < from + count; i++) {
+    // Mostly in order, with an occasional late arrival as over a real socket
+    const time = START + i * 10 - (i % 50 === 0 ? 500 : 0)
+    items.push({
+      id: _nextId++,
+      type: TYPES[i % TYPES.length],
+      date: new Date(time).toISOString(),
+      clientId: "bench",
+      payload: { level: LEVELS[i % LEVELS.length], response: { status: 200 } },
+    } as unknown as TimelineItem)
+  }
+  return items
+}
+
+/** Best milliseconds of RUNS calls to `run`, after `setup` for each. */
+function best<T>(setup: () => T, run: (input: T) => void): number {
+  let ms = Infinity
+  for (let i = 0; i < RUNS; i++) {
+    const input = setup()
+    const start = performance.now()
+    run(input)
+    ms = Math.min(ms, performance.now() - start)
+  }
+  return ms
+}
+
+const all = () => true
+
+test("timeline index", () => {
+  const items = makeItems(ITEMS)
+  const lines = [`${ITEMS} items, best of ${RUNS}`]
+  const report = (name: string, ms: number) => lines.push(`${name}: ${ms.toFixed(2)} ms`)
+
+  report(
+    "sort on every render (before)",
+    best(
+      () => items.slice(),
+      (copy) => copy.sort((a, b) => Date.parse(b.date) - Date.parse(a.date)),
+    ),
+  )
+  // Fresh items each run, so the index can't take them for the ones it has and has to rebuild
+  report(
+    "build",
+    best(
+      () => makeItems(ITEMS),
+      (fresh) => getTimelineIndex(fresh),
+    ),
+  )
+
+  const index = getTimelineIndex(items)
+  for (const sortBy of ["time-newest", "time-oldest", "type", "level"] as const) {
+    report(`select ${sortBy}`, best(() => undefined, () => index.select(sortBy, all)))
+  }
+
+  // Appends, the way messages arrive: the new array shares its prefix with the indexed one
+  let timeline = items
+  const incoming = makeItems(APPENDS * (RUNS + 1), ITEMS)
+  let taken = 0
+  report(
+    "append 1 item",
+    best(
+      () => (timeline = [...timeline, incoming[taken++]]),
+      (next) => getTimelineIndex(next),
+    ),
+  )
+  report(
+    `append ${APPENDS} items`,
+    best(
+      () => (timeline = [...timeline, ...incoming.slice(taken, (taken += APPENDS))]),
+      (next) => getTimelineIndex(next),
+    ),
+  )
+
+  console.log(lines.join("\n"))
+  expect(getTimelineIndex(timeline).select("time-oldest", all)).toHaveLength(timeline.length)
+})
@@ -0,0 +1,198 @@
+import { CommandType } from "reactotron-core-contract"
+import type { SortBy } from "../components/TimelineToolbar"
+import type { TimelineItem } from "../types"
+import { safeTime } from "./safeTime"
+
+// "type" sort order: logs first, then the other types alphabetically
+const TYPE_RANKS: Record<string, number> = {
+  [CommandType.Log]: 0,
+  [CommandType.ApiResponse]: 1,
+  [CommandType.Benchmark]: 2,
+  [CommandType.Display]: 3,
+  [CommandType.StateActionComplete]: 4,
+}
+const TYPE_RANK_COUNT = 6 // The known types plus one for anything else
+
+// "level" sort order: errors, 4xx/5xx and benchmark regressions first
+const LEVEL_RANK_COUNT = 4
+
+// Appending more than this many items at once re-sorts instead of merge-inserting each one
+const BULK_APPEND = 256
+
+// Level ranks by item, so a rebuilt index doesn't read (and materialize) every payload again
+const _levelRanks = new WeakMap<TimelineItem, number>()
+
+function levelRank(item: TimelineItem): number {
+  let rank = _levelRanks.get(item)
+  if (rank === undefined) {
+    rank = computeLevelRank(item)
+    _levelRanks.set(item, rank)
+  }
+  return rank
+}
+
+function computeLevelRank(item: TimelineItem): number {
+  if (item.type === CommandType.Log) {
+    switch (item.payload.level) {
+      case "error":
+        return 0
+      case "warn":
+        return 1
+      case "debug":
+        return 2
+      default:
+        return 3
+    }
+  }
+  if (item.type === CommandType.ApiResponse) {
+    const status = item.payload.response?.status
+    if (status && status >= 400) return 0
+    if (status && status >= 300) return 1
+    return 2
+  }
+  if (item.type === CommandType.Benchmark && item.verdict?.change === "regressed") return 0
+  return 3
+}
+
+/** Stable counting sort of `indices` by `ranks[index]`. */
+function bucketByRank(indices: number[], ranks: number[], rankCount: number): number[] {
+  const starts = new Array<number>(rankCount + 1).fill(0)
+  for (const i of indices) starts[ranks[i] + 1]++
+  for (let r = 0; r < rankCount; r++) starts[r + 1] += starts[r]
+  const sorted = new Array<number>(indices.length)
+  for (const i of indices) sorted[starts[ranks[i]]++] = i
+  return sorted
+}
+
+/**
+ * Sort keys for every timeline item, computed once when the item is first seen, plus the
+ * items' chronological order, kept current by merge-inserting new arrivals (almost always
+ * a plain append). A sorted view is then a filtered walk of that order, bucketed by type or
+ * level if needed, instead of a comparator sort that re-parses every date.
+ *
+ * Items are addressed by their position in the global timelineItems array, which only
+ * ever grows by appending; any other change (clearing, filtering) rebuilds the index.
+ */
+class TimelineIndex {
+  private items: readonly TimelineItem[] = []
+  // The ids of the first and last items indexed, which an append leaves where they were.
+  // Ids rather than the items, as a folded log is replaced by a copy with the same sort keys.
+  private headId: number | undefined
+  private tailId: number | undefined
+  private times: number[] = []
+  private typeRanks: number[] = []
+  private levelRanks: number[] = []
+  /** Item positions ordered by time, then arrival. */
+  private chronological: number[] = []
+
+  sync(items: readonly TimelineItem[]) {
+    // Compared by the length and the tail that were indexed, not the array seen last time,
+    // which may have been grown or edited in place since
+    const count = this.times.length
+    const appended =
+      items.length >= count &&
+      (count === 0 || (items[0].id === this.headId && items[count - 1].id === this.tailId))
+    this.items = items
+    if (appended && items.length === count) return
+    if (!appended) {
+      this.times = []
+      this.typeRanks = []
+      this.levelRanks = []
+      this.chronological = []
+    }
+    this.headId = items[0]?.id
+    this.tailId = items[items.length - 1]?.id
+
+    const start = this.times.length
+    if (items.length - start > BULK_APPEND) {
+      for (let i = start; i < items.length; i++) {
+        this.addKeys(items[i])
+        this.chronological.push(i)
+      }
+      this.sortChronological()
+    } else {
+      for (let i = start; i < items.length; i++) {
+        this.addKeys(items[i])
+        this.insertChronological(i)
+      }
+    }
+  }
+
+  /**
+   * Returns the items that pass `include`, in `sortBy` order. `include` is also given the
+   * item's position, for the keys below.
+   */
+  select(
+    sortBy: SortBy,
+    include: (item: TimelineItem, position: number) => boolean,
+  ): TimelineItem[] {
+    const { items, chronological } = this
+    let picked: number[] = []
+    if (sortBy === "time-oldest") {
+      for (const i of chronological) if (include(items[i], i)) picked.push(i)
+    } else {
+      for (let k = chronological.length - 1; k >= 0; k--) {
+        const i = chronological[k]
+        if (include(items[i], i)) picked.push(i)
+      }
+    }
+
+    // Grouped sorts keep newest first within each group
+    if (sortBy === "type") picked = bucketByRank(picked, this.typeRanks, TYPE_RANK_COUNT)
+    if (sortBy === "level") picked = bucketByRank(picked, this.levelRanks, LEVEL_RANK_COUNT)
+
+    return picked.map((i) => items[i])
+  }
+
+  /**
+   * The "level" sort rank of the item at `position`, as it was when indexed. For logs: 0 error,
+   * 1 warn, 2 debug, 3 anything else.
+   */
+  levelRank(position: number): number {
+    return this.levelRanks[position]
+  }
+
+  private addKeys(item: TimelineItem) {
+    this.times.push(safeTime(item.date))
+    this.typeRanks.push(TYPE_RANKS[item.type] ?? TYPE_RANK_COUNT - 1)
+    this.levelRanks.push(levelRank(item))
+  }
+
+  private insertChronological(index: number) {
+    const { times, chronological } = this
+    const time = times[index]
+    if (chronological.length === 0 || times[chronological[chronological.length - 1]] <= time) {
+      chronological.push(index)
+      return
+    }
+    // Upper bound, so items with equal times stay in arrival order
+    let lo = 0
+    let hi = chronological.length
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1
+      if (times[chronological[mid]] <= time) lo = mid + 1
+      else hi = mid
+    }
+    chronological.splice(lo, 0, index)
+  }
+
+  private sortChronological() {
+    const { times, chronological } = this
+    for (let k = 1; k < chronological.length; k++) {
+      if (times[chronological[k - 1]] > times[chronological[k]]) {
+        chronological.sort((a, b) => times[a] - times[b] || a - b)
+        return
+      }
+    }
+  }
+}
+
+const timelineIndex = new TimelineIndex()
+
+/**
+ * Brings the shared index up to date with the global timelineItems array and returns it.
+ */
+export function getTimelineIndex(items: readonly TimelineItem[]): TimelineIndex {
+  timelineIndex.sync(items)
+  return timelineIndex
+}
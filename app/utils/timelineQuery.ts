@@ -0,0 +1,133 @@
+import IRTimelineQuery from "../native/IRTimelineQuery/NativeIRTimelineQuery"
+import { CommandType } from "reactotron-core-contract"
+import type { TimelineItem } from "../types"
+
+// A search is structured once it has a field term, like `status>=400`; otherwise it's plain text
+const FIELD_TERM = /(^|[\s(-])(type|level|url|method|name|client|status|duration|time)(:|=|!=|<|>|~)/i
+
+function queryRow(item: object): number | undefined {
+  return (item as { queryRow?: number }).queryRow
+}
+
+/**
+ * Adds a new timeline item's fields to the native query columns. Pass the command as it
+ * arrived, before compactTimelineItem() moved its payload, and the item that will be kept.
+ */
+export function recordQueryRow(cmd: TimelineItem, item: TimelineItem) {
+  const payload = cmd.payload as any
+  let level = ""
+  let url = ""
+  let method = ""
+  let name = ""
+  let status = NaN
+  let duration = NaN
+  if (cmd.type === CommandType.Log) {
+    level = payload?.level ?? ""
+  } else if (cmd.type === CommandType.ApiResponse) {
+    url = payload?.request?.url ?? ""
+    method = payload?.request?.method ?? ""
+    status = payload?.response?.status ?? NaN
+    duration = payload?.response?.duration ?? NaN
+  } else if (cmd.type === CommandType.Benchmark) {
+    name = payload?.title ?? ""
+    duration = payload?.steps?.[payload.steps.length - 1]?.time ?? NaN
+  } else if (cmd.type === CommandType.StateActionComplete) {
+    name = payload?.name ?? ""
+    duration = payload?.ms ?? NaN
+  } else if (cmd.type === CommandType.Display) {
+    name = payload?.name ?? ""
+  }
+
+  const row = IRTimelineQuery.append(
+    [cmd.type, String(level), String(url), String(method), String(name), cmd.clientId ?? ""],
+    [Number(status), Number(duration), Date.parse(cmd.date)],
+  )
+  // Non-enumerable, so it isn't searched, spread or stringified with the item
+  Object.defineProperty(item, "queryRow", { value: row, configurable: true })
+}
+
+interface CachedQuery {
+  search: string
+  queryId: number
+  error: string
+  text: string[]
+  /** One byte per row from `firstRow` on: 1 if it matches. */
+  matched: Uint8Array
+  firstRow: number
+}
+
+let _query: CachedQuery | null = null
+
+function compiledQuery(search: string): CachedQuery | null {
+  if (!FIELD_TERM.test(search)) return null
+  if (_query?.search === search) return _query
+
+  if (_query?.queryId) IRTimelineQuery.dispose(_query.queryId)
+  const { queryId, error, text } = IRTimelineQuery.compile(search)
+  _query = { search, queryId, error, text, matched: new Uint8Array(1024), firstRow: 0 }
+  return _query
+}
+
+/** Why a structured search didn't compile, or "" if it did (or isn't structured). */
+export function timelineQueryError(search: string): string {
+  return compiledQuery(search)?.error ?? ""
+}
+
+export interface TimelineQueryFilter {
+  /** Free-text words, lower case, still to be matched against each item; "-" excludes. */
+  text: string[]
+  /** Whether the item passes the query's field terms. */
+  matches: (item: TimelineItem) => boolean
+}
+
+/**
+ * The compiled filter for a structured search, with its matches brought up to date with the
+ * items recorded so far, or null for plain text searches and queries that didn't compile.
+ * Only rows added since the previous call are evaluated.
+ */
+export function timelineQueryFilter(search: string): TimelineQueryFilter | null {
+  const query = compiledQuery(search)
+  if (!query?.queryId) return null
+
+  const { restarted, rows, firstRow } = IRTimelineQuery.evaluate(query.queryId)
+  if (restarted) {
+    query.matched.fill(0)
+    query.firstRow = 0
+  }
+  // Rows were dropped, with the oldest items or to save memory: so are their matches
+  if (firstRow > query.firstRow) {
+    query.matched.copyWithin(0, Math.min(firstRow - query.firstRow, query.matched.length))
+    query.matched.fill(0, Math.max(0, query.matched.length - (firstRow - query.firstRow)))
+    query.firstRow = firstRow
+  }
+  if (rows.length > 0) {
+    const last = rows[rows.length - 1] - query.firstRow
+    if (last >= query.matched.length) {
+      const grown = new Uint8Array(Math.max(last + 1, query.matched.length * 2))
+      grown.set(query.matched)
+      query.matched = grown
+    }
+    for (const row of rows) query.matched[row - query.firstRow] = 1
+  }
+
+  const { matched, firstRow: base } = query
+  return {
+    text: query.text,
+    matches: (item) => {
+      const row = queryRow(item)
+      return row !== undefined && row >= base && matched[row - base] === 1
+    },
+  }
+}
+
+/** Call when the whole timeline is cleared. */
+export function clearQueryRows() {
+  IRTimelineQuery.clear()
+}
+
+/** Call when the timeline drops its oldest items, with the items it keeps. */
+export function dropQueryRowsBefore(kept: readonly TimelineItem[]) {
+  // Rows go up with arrival; an item replaced since, like a folded log, may not have one
+  const first = kept.find((item) => queryRow(item) !== undefined)
+  if (first) IRTimelineQuery.dropBefore(queryRow(first)!)
+}
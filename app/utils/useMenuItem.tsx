@@ -100,8 +100,10 @@ export function useMenuItem(config?: MenuItemConfig) {
 
   const discoverMenus = useCallback(async () => {
     try {
-      const menus = NativeIRMenuItemManager.getAvailableMenus()
-      const structure = NativeIRMenuItemManager.getMenuStructure()
+      const [menus, structure] = await Promise.all([
+        NativeIRMenuItemManager.getAvailableMenusAsync(),
+        NativeIRMenuItemManager.getMenuStructureAsync(),
+      ])
       setAvailableMenus(menus)
       setMenuStructure(structure)
       return menus
@@ -195,7 +197,7 @@ export function useMenuItem(config?: MenuItemConfig) {
 
   const getAllMenuPaths = useCallback(async (): Promise<string[]> => {
     try {
-      const structure = NativeIRMenuItemManager.getMenuStructure()
+      const structure = await NativeIRMenuItemManager.getMenuStructureAsync()
       const out: string[] = []
       const walk = (nodes?: any[]) => {
         if (!nodes) return
@@ -312,7 +314,7 @@ export function useMenuItem(config?: MenuItemConfig) {
           const parentPath = parsePathKey(parentKey)
           if (parentPath.length === 1) {
             const top = parentPath[0]
-            const structure = NativeIRMenuItemManager.getMenuStructure()
+            const structure = await NativeIRMenuItemManager.getMenuStructureAsync()
             const entry = structure.find(
               (e) => e.title.localeCompare(top, undefined, { sensitivity: "accent" }) === 0,
             )
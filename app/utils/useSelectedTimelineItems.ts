@@ -14,7 +14,7 @@ import { TimelineItem } from "../types"
  * Eventually this will be used to hold open tabs for different timeline items.
  */
 export const useSelectedTimelineItems = () => {
-  const [selectedItemId, setSelectedItemId] = useGlobal<string | null>("selectedTimelineItem", null)
+  const [selectedItemId, setSelectedItemId] = useGlobal<number | null>("selectedTimelineItem", null)
   const [timelineItems] = useGlobal<TimelineItem[]>("timelineItems", [])
 
   const selectedItem = selectedItemId
@@ -1,110 +1,95 @@
 import { TimelineItem } from "../types"
-import { TimelineFilters } from "../components/TimelineToolbar"
+import { LogLevel, TimelineFilters } from "../components/TimelineToolbar"
+import { CommandType } from "reactotron-core-contract"
 import { useGlobal } from "../state/useGlobal"
 import { useMemo } from "react"
 import { normalize } from "./normalize"
-import { safeTime } from "./safeTime"
+import { getTimelineIndex } from "./timelineIndex"
+import { compactPayloadContains } from "./payloadArena"
+import { timelineQueryFilter } from "./timelineQuery"
 
-export function useTimeline(filters: TimelineFilters): TimelineItem[] {
-  const [items] = useGlobal<TimelineItem[]>("timelineItems", [])
-  const [search] = useGlobal("search", "")
-
-  return useMemo(() => {
-    const clientScopedItems = items.filter((item) => item.clientId === filters.clientId)
-    // 1) Types filter: if none selected, show everything
-    const byType =
-      (filters.types?.length ?? 0) === 0
-        ? clientScopedItems.slice() // clone so we can sort safely later
-        : clientScopedItems.filter((item) => filters.types.includes(item.type))
-
-    // 2) Search (normalize once)
-    const q = normalize(search)
-    const visited = new WeakSet<object>()
-    const matches = (val: unknown): boolean => {
-      if (val === null || val === undefined) return false
-
-      if (typeof val === "string" || typeof val === "number" || typeof val === "boolean") {
-        return normalize(val).includes(q)
-      }
-      if (val instanceof Date) {
-        return normalize(val.toISOString()).includes(q)
-      }
-      if (Array.isArray(val)) {
-        for (const v of val) if (matches(v)) return true
-        return false
-      }
-      if (typeof val === "object") {
-        const obj = val as Record<string, unknown>
-        if (visited.has(obj)) return false
-        visited.add(obj)
-        for (const k in obj) {
-          if (matches(obj[k])) return true
-        }
-        return false
-      }
+/** Whether any value in an item contains `q` (already normalized). */
+function createMatcher(q: string) {
+  const visited = new WeakSet<object>()
+  const matches = (val: unknown): boolean => {
+    if (val === null || val === undefined) return false
 
+    if (typeof val === "string" || typeof val === "number" || typeof val === "boolean") {
+      return normalize(val).includes(q)
+    }
+    if (val instanceof Date) {
+      return normalize(val.toISOString()).includes(q)
+    }
+    if (Array.isArray(val)) {
+      for (const v of val) if (matches(v)) return true
       return false
     }
+    if (typeof val === "object") {
+      const obj = val as Record<string, unknown>
+      if (visited.has(obj)) return false
+      visited.add(obj)
+      for (const k in obj) {
+        if (matches(obj[k])) return true
+      }
+      // A payload kept natively is searched there, without materializing it
+      return compactPayloadContains(obj, q, matches) ?? false
+    }
 
-    const bySearch = q ? byType.filter((item) => matches(item)) : byType
-
-    // 3) Sort newest first, safely handling bad dates
-    bySearch.sort((a, b) => safeTime(b.date) - safeTime(a.date))
-
-    return bySearch
-  }, [items, JSON.stringify(filters.types ?? []), search, filters.clientId])
+    return false
+  }
+  return matches
+}
 
-  // TODO: User controlled sorting and level filtering
+// Log severities, most severe first, as the timeline index ranks them; anything else ranks
+// with debug
+const LOG_LEVEL_RANKS: Record<string, number> = { error: 0, warn: 1, debug: 2 }
 
-  //   switch (filters.sortBy) {
-  //     case "time-newest":
-  //       return new Date(b.date).getTime() - new Date(a.date).getTime()
+/**
+ * Whether a log item is at least as severe as `level`. Other items always pass. `rank` is the
+ * item's level rank from the timeline index, so the payload isn't read.
+ */
+function passesLogLevel(item: TimelineItem, rank: number, level: LogLevel): boolean {
+  if (level === "all" || item.type !== CommandType.Log) return true
+  return Math.min(rank, LOG_LEVEL_RANKS.debug) <= LOG_LEVEL_RANKS[level]
+}
 
-  //     case "time-oldest":
-  //       return new Date(a.date).getTime() - new Date(b.date).getTime()
+export function useTimeline(filters: TimelineFilters): TimelineItem[] {
+  const [items] = useGlobal<TimelineItem[]>("timelineItems", [])
+  const [search] = useGlobal("search", "")
 
-  //     case "type":
-  //       if (a.type !== b.type) {
-  //         if (a.type === "log") return -1
-  //         if (b.type === "log") return 1
-  //         return a.type.localeCompare(b.type)
-  //       }
-  //       return new Date(b.date).getTime() - new Date(a.date).getTime()
+  return useMemo(() => {
+    // 1) Types filter: if none selected, show everything
+    const types = filters.types ?? []
 
-  //     case "level":
-  //       const getLevelPriority = (item: TimelineItem): number => {
-  //         if (item.type === "log") {
-  //           const logItem = item as TimelineItemLog
-  //           switch (logItem.payload.level) {
-  //             case "error":
-  //               return 3
-  //             case "warn":
-  //               return 2
-  //             case "debug":
-  //               return 1
-  //             default:
-  //               return 0
-  //           }
-  //         }
-  //         if (item.type.startsWith("api.")) {
-  //           const networkItem = item as TimelineItemNetwork
-  //           const status = networkItem.payload.response?.status
-  //           if (status && status >= 400) return 3
-  //           if (status && status >= 300) return 2
-  //           return 1
-  //         }
-  //         return 0
-  //       }
+    // 2) Search. A structured query (`status>=400 url:users`) is evaluated natively over
+    // fields extracted at ingest; any free text left in it, or a plain search, is matched here
+    const query = timelineQueryFilter(search)
+    const textTests = (query ? query.text : [search])
+      .map(normalize)
+      .filter(Boolean)
+      .map((q) => {
+        if (!query || !q.startsWith("-") || q.length === 1) return createMatcher(q)
+        const matches = createMatcher(q.slice(1))
+        return (item: TimelineItem) => !matches(item)
+      })
 
-  //       const aPriority = getLevelPriority(a)
-  //       const bPriority = getLevelPriority(b)
-  //       if (aPriority !== bPriority) {
-  //         return bPriority - aPriority
-  //       }
-  //       return new Date(b.date).getTime() - new Date(a.date).getTime()
+    const index = getTimelineIndex(items)
+    const logLevel = filters.logLevel ?? "all"
+    const include = (item: TimelineItem, position: number) =>
+      item.clientId === filters.clientId &&
+      (types.length === 0 || types.includes(item.type)) &&
+      passesLogLevel(item, index.levelRank(position), logLevel) &&
+      (!query || query.matches(item)) &&
+      textTests.every((test) => test(item))
 
-  //     default:
-  //       return new Date(b.date).getTime() - new Date(a.date).getTime()
-  //   }
-  // })
+    // 3) Sort using keys precomputed when each item arrived, rather than re-parsing dates
+    return index.select(filters.sortBy ?? "time-newest", include)
+  }, [
+    items,
+    JSON.stringify(filters.types ?? []),
+    search,
+    filters.clientId,
+    filters.sortBy,
+    filters.logLevel,
+  ])
 }
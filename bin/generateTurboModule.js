@@ -77,6 +77,123 @@ function extractNativeCode(filePath) {
   return nativeCode.join("\n")
 }
 
+// Bulk channel field types, and what they read as in TypeScript.
+// Keep in sync with app/native/IRBulkChannel/RecordBatch.h and app/utils/bulkChannel.ts.
+const bulkFieldTypes = {
+  bool: "boolean",
+  u8: "number",
+  i8: "number",
+  u16: "number",
+  i16: "number",
+  u32: "number",
+  i32: "number",
+  f32: "number",
+  f64: "number",
+  string: "string",
+}
+
+const identifier = /^[A-Za-z_][A-Za-z0-9_]*$/
+const capitalize = (name) => name.charAt(0).toUpperCase() + name.slice(1)
+
+// Parse `@bulk channelName { field: type, ... }` lines; throws if one is malformed
+function parseBulkChannels(nativeLines, moduleName) {
+  const channels = []
+
+  for (const line of nativeLines) {
+    if (!line.trim().startsWith("@bulk")) continue
+
+    const match = line.trim().match(/^@bulk\s+(\S+)\s*\{(.*)\}$/)
+    if (!match) throw new Error(`Expected "@bulk name { field: type, ... }", got "${line.trim()}"`)
+
+    const name = match[1]
+    if (!identifier.test(name)) throw new Error(`Bad bulk channel name "${name}"`)
+    if (channels.some((channel) => channel.name === name)) {
+      throw new Error(`Bulk channel ${name} is declared twice`)
+    }
+
+    const fields = []
+    for (const entry of match[2].split(",").map((part) => part.trim())) {
+      if (!entry) continue
+      const [fieldName, type, ...rest] = entry.split(":").map((part) => part.trim())
+      if (!identifier.test(fieldName || "")) {
+        throw new Error(`Bad field name "${fieldName}" in ${name}`)
+      }
+      if (rest.length > 0 || !Object.prototype.hasOwnProperty.call(bulkFieldTypes, type)) {
+        throw new Error(`Unknown type "${type}" for ${name}.${fieldName}`)
+      }
+      if (fields.some((field) => field.name === fieldName)) {
+        throw new Error(`Field ${name}.${fieldName} is listed twice`)
+      }
+      fields.push({ name: fieldName, type })
+    }
+    if (fields.length === 0) throw new Error(`Bulk channel ${name} has no fields`)
+
+    channels.push({
+      name,
+      channel: `${moduleName}.${name}`,
+      schema: fields.map((field) => `${field.name}: ${field.type}`).join(", "),
+      fields,
+    })
+  }
+
+  return channels
+}
+
+// C++ for each bulk channel: its name, field indexes and record layout
+function bulkChannelNativeCode(moduleName, channels) {
+  if (channels.length === 0) return ""
+
+  const structs = channels.map(
+    (channel) => `// Read in JS through ${channel.name}Channel in Native${moduleName}.ts
+struct ${moduleName}${capitalize(channel.name)} {
+  static constexpr const char *kChannel = "${channel.channel}";
+  enum Field : size_t { ${channel.fields.map((field) => `k${capitalize(field.name)}`).join(", ")} };
+
+  static const reactotron::RecordLayout &Layout() {
+    static const reactotron::RecordLayout layout = reactotron::RecordLayout::Make("${channel.schema}");
+    return layout;
+  }
+
+  /** Hands what \`writer\` holds to JS and empties it. */
+  static void Push(reactotron::RecordBatchWriter &writer) {
+    reactotron::BulkChannels::Shared().Push(kChannel, writer.Finish());
+  }
+};`,
+  )
+
+  return `
+#include "BulkChannel.h"
+
+${structs.join("\n\n")}
+`
+}
+
+// TypeScript for each bulk channel: its record type and a reader
+function bulkChannelTypeScript(channels) {
+  return channels
+    .map(
+      (channel) => `
+export interface ${capitalize(channel.name)}Record {
+${channel.fields.map((field) => `  ${field.name}: ${bulkFieldTypes[field.type]}`).join("\n")}
+}
+export const ${channel.name}Channel = defineBulkChannel<${capitalize(channel.name)}Record>(
+  "${channel.channel}",
+  "${channel.schema}",
+)
+`,
+    )
+    .join("")
+}
+
+// app/utils/bulkChannel relative to the generated TypeScript file
+function bulkChannelImportPath(filePath) {
+  const relative = path
+    .relative(path.dirname(filePath), path.join("app", "utils", "bulkChannel"))
+    .split(path.sep)
+    .join("/")
+  return relative.startsWith(".") ? relative : `./${relative}`
+}
+
 // Generate native files from turbomodule comment
 function generateNativeFiles(filePath, destinationPath, moduleInfo) {
   const { moduleName, fullSignature } = moduleInfo
@@ -88,16 +205,19 @@ function generateNativeFiles(filePath, destinationPath, moduleInfo) {
   const nativeLines = nativeCode.split("\n")
   const headers = nativeLines.filter((line) => line.trim().startsWith("#import")).join("\n")
 
-  // Replace the method section with our extracted native code, minus the headers
+  // Bulk channels declared with @bulk lines
+  const channels = parseBulkChannels(nativeLines, moduleName)
+
+  // Replace the method section with our extracted native code, minus the headers and @bulk lines
   const filteredNativeCode = nativeLines
-    .filter((line) => !line.trim().startsWith("#import"))
+    .filter((line) => !line.trim().startsWith("#import") && !line.trim().startsWith("@bulk"))
     .join("\n")
 
   // Generate .mm file using template
   const mmFile = path.join(destinationPath, `${moduleName}.mm`)
   const mmContent = `#import "${moduleName}.h"
 ${headers}
-
+${bulkChannelNativeCode(moduleName, channels)}
 @implementation ${moduleName} RCT_EXPORT_MODULE()
 
 ${filteredNativeCode}
@@ -112,13 +232,16 @@ ${filteredNativeCode}
 
   // Generate Native TypeScript file using template
   const nativeTsFile = path.join(path.dirname(filePath), `Native${moduleName}.ts`)
+  const bulkImport = channels.length
+    ? `import { defineBulkChannel } from "${bulkChannelImportPath(filePath)}"\n`
+    : ""
   const tsTemplate = `import type { TurboModule } from "react-native"
 import { TurboModuleRegistry } from "react-native"
-export interface Spec extends TurboModule {
+${bulkImport}export interface Spec extends TurboModule {
   ${fullSignature}
 }
 export default TurboModuleRegistry.getEnforcing<Spec>("${moduleName}")
-`
+${bulkChannelTypeScript(channels)}`
 
   fs.writeFileSync(nativeTsFile, tsTemplate)
   printSuccess(`Generated ${nativeTsFile}`)
@@ -185,7 +308,13 @@ function generateTurboModules() {
     }
 
     // Generate native files
-    generateNativeFiles(filePath, destinationPath, moduleInfo)
+    try {
+      generateNativeFiles(filePath, destinationPath, moduleInfo)
+    } catch (error) {
+      printError(`${filePath}: ${error.message}`)
+      errors++
+      continue
+    }
     processed++
   }
 
@@ -200,7 +329,8 @@ function generateTurboModules() {
 function main() {
   const command = process.argv[2]
 
-  if (command === "generate") {
+  // ./bin/turbomodule apply calls this with "apply"
+  if (command === "generate" || command === "apply") {
     generateTurboModules()
   } else {
     printError(`Unknown command: ${command}`)
@@ -1,4 +1,18 @@
 #import "MyTemplate.h"
+#include "BulkChannel.h"
+
+// Bulk channel example: records handed to JS together in one ArrayBuffer,
+// instead of as a dictionary each. JS reads them through samplesChannel in
+// NativeMyTemplate.ts, whose schema has to match this one.
+struct MyTemplateSamples {
+  static constexpr const char *kChannel = "MyTemplate.samples";
+  enum Field : size_t { kTime, kIndex, kMessage };
+
+  static const reactotron::RecordLayout &Layout() {
+    static const reactotron::RecordLayout layout = reactotron::RecordLayout::Make("time: f64, index: u32, message: string");
+    return layout;
+  }
+};
 
 @interface MyTemplate ()
 // Add any private properties here. Not accessible from JS directly.
@@ -50,6 +64,23 @@
   }];
 }
 
+// Bulk method example -- subscribe in JS, then call it:
+//   samplesChannel.subscribe((batch) => console.log(batch.count, batch.field("index")(0)))
+//   MyTemplate.sendSamples(10000)
+- (NSNumber *)sendSamples:(double)count {
+  reactotron::RecordBatchWriter writer(MyTemplateSamples::Layout(), static_cast<size_t>(count));
+  double now = NSDate.date.timeIntervalSince1970 * 1000;
+  for (int i = 0; i < count; i++) {
+    auto record = writer.Append();
+    record.Set(MyTemplateSamples::kTime, now);
+    record.Set(MyTemplateSamples::kIndex, i);
+    record.Set(MyTemplateSamples::kMessage, "Sample");
+  }
+  // Any thread may push; JS is told once that the channel has batches waiting
+  reactotron::BulkChannels::Shared().Push(MyTemplateSamples::kChannel, writer.Finish());
+  return @(count);
+}
+
 // End of your methods ************************************************************
 
 // Required by TurboModules.
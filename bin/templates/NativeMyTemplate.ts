@@ -2,6 +2,7 @@
 import type { EventEmitter } from "react-native/Libraries/Types/CodegenTypes"
 import type { TurboModule } from "react-native"
 import { TurboModuleRegistry } from "react-native"
+import { defineBulkChannel } from "../../utils/bulkChannel"
 
 export interface MyTemplateEvent {
   message: string
@@ -15,7 +16,19 @@ export interface Spec extends TurboModule {
   getADictionaryAsync(
     someString: string,
   ): Promise<{ someString: string; someNumber: number; someBool: boolean }>
+  sendSamples(count: number): number
   readonly onMyTemplateEvent: EventEmitter<MyTemplateEvent>
 }
 
 export default TurboModuleRegistry.getEnforcing<Spec>("MyTemplate")
+
+// Records MyTemplate.sendSamples pushes; the schema matches MyTemplateSamples in MyTemplate.mm
+export interface SampleRecord {
+  time: number
+  index: number
+  message: string
+}
+export const samplesChannel = defineBulkChannel<SampleRecord>(
+  "MyTemplate.samples",
+  "time: f64, index: u32, message: string",
+)
@@ -0,0 +1,137 @@
+/**
+ * JS-thread time for the relay's messages, handled one at a time as the old JS WebSocket's
+ * onmessage did, against a frame's worth at a time as openRelayConnection delivers them. Messages
+ * come from relay-stand-in.js over a real socket; the handling mirrors connectToServer's (parse,
+ * number the item, add it to the timeline immutably), without React's renders.
+ *
+ *   npm run bench:relay [-- messages rate]
+ */
+
+const crypto = require("crypto")
+const net = require("net")
+const { performance } = require("perf_hooks")
+const {
+  startStandInRelay,
+  encodeFrame,
+  FrameReader,
+  OP_TEXT,
+  OP_CLOSE,
+} = require("./relay-stand-in")
+
+const MESSAGES = Number(process.argv[2]) || 10000
+const RATE = Number(process.argv[3]) || 0
+const FRAME_MS = 1000 / 60
+
+/** Connects to the relay at `port` as a Reactotron app, calling `onText` per message. */
+function connect(port, onText) {
+  return new Promise((resolve, reject) => {
+    const socket = net.connect(port, "127.0.0.1")
+    const reader = new FrameReader((opcode, payload) => {
+      if (opcode === OP_TEXT) onText(payload.toString())
+    })
+    let head = ""
+    socket.on("connect", () => {
+      socket.write(
+        "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n" +
+          `Sec-WebSocket-Key: ${crypto.randomBytes(16).toString("base64")}\r\n` +
+          "Sec-WebSocket-Version: 13\r\n\r\n",
+      )
+    })
+    socket.on("data", (chunk) => {
+      if (head === null) return reader.push(chunk)
+      head += chunk.toString("latin1")
+      const end = head.indexOf("\r\n\r\n")
+      if (end === -1) return
+      const rest = Buffer.from(head.slice(end + 4), "latin1")
+      head = null
+      socket.write(encodeFrame(OP_TEXT, JSON.stringify({ type: "reactotron.subscribe" }), true))
+      if (rest.length) reader.push(rest)
+      resolve(socket)
+    })
+    socket.on("error", reject)
+  })
+}
+
+/** What connectToServer does with a message that becomes a timeline item. */
+function toItem(text, state) {
+  const data = JSON.parse(text)
+  if (data.type !== "command" || !data.cmd) return null
+  data.cmd.id = state.nextId++
+  return data.cmd
+}
+
+/**
+ * Streams MESSAGES messages from a fresh stand-in relay into a timeline of `existing` items and
+ * resolves with the milliseconds spent handling them, and the number of updates.
+ */
+async function run(perFrame, existing) {
+  const state = { nextId: 1, timeline: [], received: 0, handleMs: 0, updates: 0 }
+  for (let i = 0; i < existing; i++) state.timeline.push({ id: state.nextId++, type: "log" })
+  const expected = MESSAGES + 2 // with "reactotron.connected" and "connectionEstablished"
+
+  let pending = []
+  let done
+  const finished = new Promise((resolve) => (done = resolve))
+
+  const handleOne = (text) => {
+    const start = performance.now()
+    const item = toItem(text, state)
+    if (item) {
+      state.timeline = [...state.timeline, item]
+      state.updates++
+    }
+    state.handleMs += performance.now() - start
+  }
+  const handleBatch = () => {
+    if (pending.length === 0) return
+    const texts = pending
+    pending = []
+    const start = performance.now()
+    const batch = []
+    for (const text of texts) {
+      const item = toItem(text, state)
+      if (item) batch.push(item)
+    }
+    if (batch.length) {
+      state.timeline = [...state.timeline, ...batch]
+      state.updates++
+    }
+    state.handleMs += performance.now() - start
+  }
+
+  const relay = await startStandInRelay({ port: 0, messages: MESSAGES, rate: RATE })
+  const frames = perFrame ? setInterval(handleBatch, FRAME_MS) : null
+  const socket = await connect(relay.address().port, (text) => {
+    if (perFrame) pending.push(text)
+    else handleOne(text)
+    if (++state.received === expected) done()
+  })
+  await finished
+  if (frames) {
+    clearInterval(frames)
+    handleBatch()
+  }
+  socket.end(encodeFrame(OP_CLOSE, Buffer.alloc(0), true))
+  relay.close()
+  if (state.timeline.length !== existing + MESSAGES) throw new Error("messages went missing")
+  return state
+}
+
+async function main() {
+  const pace = RATE ? `at ${RATE}/s` : "at full speed"
+  console.log(`${MESSAGES} messages ${pace}, JS-thread handling time`)
+  for (const existing of [0, 20000]) {
+    for (const perFrame of [false, true]) {
+      const { handleMs, updates } = await run(perFrame, existing)
+      const mode = perFrame ? "per frame" : "per message"
+      console.log(
+        `${existing} existing items, ${mode}: ${handleMs.toFixed(1)} ms in ${updates} updates`,
+      )
+    }
+  }
+}
+
+main().catch((error) => {
+  console.error(error)
+  process.exit(1)
+})
@@ -0,0 +1,200 @@
+/**
+ * A stand-in for the Reactotron relay, for benchmarking the app's side of the connection without
+ * a React Native client. It speaks just enough WebSocket (RFC 6455) over plain `net`, with no
+ * dependencies: once a Reactotron app subscribes, it sends "reactotron.connected", a client's
+ * "connectionEstablished", then `messages` log commands, as fast as the socket takes them or at
+ * `rate` messages a second.
+ *
+ *   node relay-stand-in.js [port] [messages] [rate]
+ */
+
+const crypto = require("crypto")
+const net = require("net")
+
+const GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+const OP_TEXT = 0x1
+const OP_CLOSE = 0x8
+const OP_PING = 0x9
+const OP_PONG = 0xa
+
+/** One unfragmented frame; clients must mask theirs, servers must not. */
+function encodeFrame(opcode, payload, mask = false) {
+  const data = Buffer.isBuffer(payload) ? payload : Buffer.from(payload)
+  let header
+  if (data.length < 126) {
+    header = Buffer.from([0x80 | opcode, data.length])
+  } else if (data.length < 65536) {
+    header = Buffer.alloc(4)
+    header[1] = 126
+    header.writeUInt16BE(data.length, 2)
+  } else {
+    header = Buffer.alloc(10)
+    header[1] = 127
+    header.writeBigUInt64BE(BigInt(data.length), 2)
+  }
+  header[0] = 0x80 | opcode
+  if (!mask) return Buffer.concat([header, data])
+
+  header[1] |= 0x80
+  const key = crypto.randomBytes(4)
+  const masked = Buffer.alloc(data.length)
+  for (let i = 0; i < data.length; i++) masked[i] = data[i] ^ key[i & 3]
+  return Buffer.concat([header, key, masked])
+}
+
+/**
+ * Unframes a byte stream, calling `onFrame(opcode, payload)` per complete message. Continuation
+ * frames are joined onto the message they continue.
+ */
+class FrameReader {
+  constructor(onFrame) {
+    this.onFrame = onFrame
+    this.buffer = Buffer.alloc(0)
+    this.fragments = []
+    this.fragmentOpcode = 0
+  }
+
+  push(chunk) {
+    this.buffer = this.buffer.length ? Buffer.concat([this.buffer, chunk]) : chunk
+    for (;;) {
+      const { buffer } = this
+      if (buffer.length < 2) return
+      const fin = (buffer[0] & 0x80) !== 0
+      const opcode = buffer[0] & 0x0f
+      const masked = (buffer[1] & 0x80) !== 0
+      let length = buffer[1] & 0x7f
+      let offset = 2
+      if (length === 126) {
+        if (buffer.length < 4) return
+        length = buffer.readUInt16BE(2)
+        offset = 4
+      } else if (length === 127) {
+        if (buffer.length < 10) return
+        length = Number(buffer.readBigUInt64BE(2))
+        offset = 10
+      }
+      const key = masked ? buffer.subarray(offset, offset + 4) : null
+      if (masked) offset += 4
+      if (buffer.length < offset + length) return
+
+      let payload = buffer.subarray(offset, offset + length)
+      if (key) {
+        payload = Buffer.from(payload)
+        for (let i = 0; i < payload.length; i++) payload[i] ^= key[i & 3]
+      }
+      this.buffer = buffer.subarray(offset + length)
+
+      if (opcode === 0) {
+        this.fragments.push(payload)
+        if (fin) this.onFrame(this.fragmentOpcode, Buffer.concat(this.fragments.splice(0)))
+      } else if (!fin) {
+        this.fragmentOpcode = opcode
+        this.fragments = [payload]
+      } else {
+        this.onFrame(opcode, payload)
+      }
+    }
+  }
+}
+
+function logCommand(index) {
+  return JSON.stringify({
+    type: "command",
+    cmd: {
+      type: "log",
+      clientId: "stand-in",
+      date: new Date().toISOString(),
+      deltaTime: 0,
+      important: false,
+      payload: { level: index % 10 === 0 ? "warn" : "debug", message: `message ${index}` },
+    },
+  })
+}
+
+/**
+ * Starts the stand-in relay and resolves with its `net.Server` once it's listening. `onDone` is
+ * called with the socket after the last message has been written to it.
+ */
+function startStandInRelay({ port = 9292, messages = 10000, rate = 0, onDone } = {}) {
+  const server = net.createServer((socket) => {
+    socket.setNoDelay(true)
+    let upgraded = false
+    let head = ""
+    const send = (text) => socket.write(encodeFrame(OP_TEXT, text))
+
+    const stream = () => {
+      send(JSON.stringify({ type: "reactotron.connected" }))
+      send(
+        JSON.stringify({
+          type: "connectionEstablished",
+          conn: { clientId: "stand-in", name: "Stand-in", platform: "node" },
+        }),
+      )
+      let sent = 0
+      const finish = () => onDone && onDone(socket)
+      if (rate > 0) {
+        // In ticks of 10 ms, so low rates still spread out
+        const perTick = Math.max(1, Math.round(rate / 100))
+        const timer = setInterval(() => {
+          for (let i = 0; i < perTick && sent < messages; i++) send(logCommand(sent++))
+          if (sent === messages) {
+            clearInterval(timer)
+            finish()
+          }
+        }, 10)
+        socket.on("close", () => clearInterval(timer))
+        return
+      }
+      // As fast as the socket drains
+      const pump = () => {
+        while (sent < messages) {
+          if (!send(logCommand(sent++))) return socket.once("drain", pump)
+        }
+        finish()
+      }
+      pump()
+    }
+
+    const reader = new FrameReader((opcode, payload) => {
+      if (opcode === OP_PING) socket.write(encodeFrame(OP_PONG, payload))
+      if (opcode === OP_CLOSE) socket.end(encodeFrame(OP_CLOSE, payload.subarray(0, 2)))
+      if (opcode !== OP_TEXT) return
+      const message = JSON.parse(payload.toString())
+      if (message.type === "reactotron.subscribe") stream()
+    })
+
+    socket.on("data", (chunk) => {
+      if (upgraded) return reader.push(chunk)
+      head += chunk.toString("latin1")
+      const end = head.indexOf("\r\n\r\n")
+      if (end === -1) return
+      const key = /^sec-websocket-key:\s*(.+)$/im.exec(head.slice(0, end))
+      if (!key) return socket.destroy()
+      const accept = crypto
+        .createHash("sha1")
+        .update(key[1].trim() + GUID)
+        .digest("base64")
+      socket.write(
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n" +
+          `Sec-WebSocket-Accept: ${accept}\r\n\r\n`,
+      )
+      upgraded = true
+      const rest = Buffer.from(head.slice(end + 4), "latin1")
+      if (rest.length) reader.push(rest)
+    })
+    socket.on("error", () => {})
+  })
+
+  return new Promise((resolve) => server.listen(port, "127.0.0.1", () => resolve(server)))
+}
+
+module.exports = { startStandInRelay, encodeFrame, FrameReader, OP_TEXT, OP_CLOSE }
+
+if (require.main === module) {
+  const port = Number(process.argv[2]) || 9292
+  const messages = Number(process.argv[3]) || 10000
+  const rate = Number(process.argv[4]) || 0
+  startStandInRelay({ port, messages, rate }).then(() =>
+    console.log(`Stand-in relay on ws://localhost:${port}: ${messages} messages per app`),
+  )
+}
@@ -0,0 +1,101 @@
+/**
+ * What relay-stats.js costs on the relay's forwarding hot path: a client message counted in,
+ * then sent on to each Reactotron app, against the same sends with no counters. Sockets are
+ * stand-ins whose send() completes at once, so only the relay's own work is timed.
+ *
+ *   npm run bench:relay-stats [-- messages apps]
+ */
+
+const { performance } = require("perf_hooks")
+const { RelayStats, LatencyHistogram } = require("./relay-stats")
+
+const MESSAGES = Number(process.argv[2]) || 1000000
+const APPS = Number(process.argv[3]) || 1
+const RUNS = 5
+
+function standInSocket() {
+  return {
+    readyState: 1,
+    bufferedAmount: 0,
+    sent: 0,
+    send(text, callback) {
+      this.sent++
+      if (callback) callback()
+    },
+  }
+}
+
+const text = JSON.stringify({
+  type: "command",
+  cmd: {
+    type: "log",
+    clientId: "bench",
+    payload: { level: "debug", message: "fetched 42 items" },
+    date: new Date().toISOString(),
+  },
+})
+
+/** Forwards MESSAGES messages with `forward` and returns the best microseconds per message. */
+function measure(forward) {
+  let best = Infinity
+  for (let run = 0; run < RUNS; run++) {
+    const start = performance.now()
+    for (let i = 0; i < MESSAGES; i++) forward()
+    best = Math.min(best, ((performance.now() - start) * 1000) / MESSAGES)
+  }
+  return best
+}
+
+function bench(name, forward, baseline) {
+  const us = measure(forward)
+  const overhead = baseline === undefined ? "" : `, counters ${(us - baseline).toFixed(3)} us`
+  console.log(`${name}: ${us.toFixed(3)} us/message${overhead}`)
+  return us
+}
+
+console.log(`${MESSAGES} messages to ${APPS} app(s), best of ${RUNS}`)
+const sockets = Array.from({ length: APPS }, standInSocket)
+
+const baseline = bench("no counters", () => {
+  for (const socket of sockets) socket.send(text, () => {})
+})
+
+{
+  const stats = new RelayStats()
+  const client = stats.client("bench", "Bench")
+  const apps = sockets.map((socket) => {
+    const peer = stats.peer(socket)
+    stats.subscribed(peer, "app")
+    return peer
+  })
+  const bytes = Buffer.byteLength(text)
+  bench(
+    "counted, bytes measured once",
+    () => {
+      stats.received(client, bytes)
+      for (const app of apps) stats.send(app, text, client, bytes)
+    },
+    baseline,
+  )
+  bench(
+    "counted, bytes measured per app",
+    () => {
+      stats.received(client, bytes)
+      for (const app of apps) stats.send(app, text, client)
+    },
+    baseline,
+  )
+  const start = performance.now()
+  stats.snapshot()
+  console.log(`snapshot: ${((performance.now() - start) * 1000).toFixed(1)} us`)
+}
+
+{
+  const histogram = new LatencyHistogram()
+  let us = 1
+  const perRecord = measure(() => {
+    histogram.record(us)
+    us = us > 1e6 ? 1 : us * 1.01
+  })
+  console.log(`histogram record: ${perRecord.toFixed(3)} us`)
+}
@@ -0,0 +1,264 @@
+/**
+ * Counters for the standalone relay: what each client and each Reactotron app (subscriber)
+ * sent and received, how much is queued on its socket, and how long forwarding takes.
+ *
+ * Node runs the relay on one thread, so the counters are plain numbers bumped in place, with
+ * no locks and nothing allocated per message beyond the send callback. Rates, queue depths
+ * and latency percentiles are worked out only when a snapshot is taken.
+ */
+
+const { performance } = require("perf_hooks")
+
+// Latency buckets: four per power of two of microseconds, so percentiles are within 25%
+const SUB_BUCKETS = 4
+const LATENCY_BUCKETS = 32 * SUB_BUCKETS
+
+function latencyBucket(us) {
+  const value = us < 1 ? 1 : us >= 0xffffffff ? 0xffffffff : Math.ceil(us)
+  if (value < SUB_BUCKETS) return value
+  const exponent = 31 - Math.clz32(value)
+  return exponent * SUB_BUCKETS + ((value >>> (exponent - 2)) & (SUB_BUCKETS - 1))
+}
+
+/** The largest latency, in microseconds, counted in `bucket`. */
+function bucketLimit(bucket) {
+  if (bucket < SUB_BUCKETS) return bucket
+  const exponent = Math.floor(bucket / SUB_BUCKETS)
+  return ((SUB_BUCKETS + (bucket % SUB_BUCKETS) + 1) * 2 ** (exponent - 2)) - 1
+}
+
+/** Forward latencies since the last reset, bucketed logarithmically. */
+class LatencyHistogram {
+  constructor() {
+    this.buckets = new Uint32Array(LATENCY_BUCKETS)
+    this.count = 0
+    this.maxUs = 0
+  }
+
+  record(us) {
+    this.buckets[latencyBucket(us)]++
+    this.count++
+    if (us > this.maxUs) this.maxUs = us
+  }
+
+  /** Upper bound of the `fraction` quantile, in milliseconds. */
+  percentile(fraction) {
+    if (this.count === 0) return 0
+    const rank = Math.ceil(this.count * fraction)
+    let seen = 0
+    for (let bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+      seen += this.buckets[bucket]
+      if (seen >= rank) return Math.min(bucketLimit(bucket), this.maxUs) / 1000
+    }
+    return this.maxUs / 1000
+  }
+
+  summary() {
+    return {
+      count: this.count,
+      p50: this.percentile(0.5),
+      p90: this.percentile(0.9),
+      p99: this.percentile(0.99),
+      max: this.maxUs / 1000,
+    }
+  }
+
+  reset() {
+    this.buckets.fill(0)
+    this.count = 0
+    this.maxUs = 0
+  }
+}
+
+/** One socket's counters. `kind` is "unknown" until it introduces itself. */
+class PeerStats {
+  constructor(socket) {
+    this.socket = socket
+    this.kind = "unknown"
+    this.id = ""
+    this.name = ""
+    this.connectedAt = Date.now()
+    this.messagesIn = 0
+    this.bytesIn = 0
+    this.messagesOut = 0
+    this.bytesOut = 0
+    // Sends that failed or found the socket closed
+    this.drops = 0
+    // Messages from a client while no Reactotron app was connected to take them
+    this.unrouted = 0
+    this.maxQueueDepth = 0
+    this.lastReceivedAt = 0
+    this.latency = new LatencyHistogram()
+    // Totals at the last snapshot, to work out rates from
+    this.previous = { messagesIn: 0, bytesIn: 0, messagesOut: 0, bytesOut: 0 }
+  }
+
+  snapshot(seconds) {
+    const { previous } = this
+    const rate = (now, before) => (seconds > 0 ? (now - before) / seconds : 0)
+    const queueDepth = this.socket ? this.socket.bufferedAmount || 0 : 0
+    const snapshot = {
+      kind: this.kind,
+      id: this.id,
+      name: this.name,
+      connectedAt: this.connectedAt,
+      messagesIn: this.messagesIn,
+      bytesIn: this.bytesIn,
+      messagesOut: this.messagesOut,
+      bytesOut: this.bytesOut,
+      drops: this.drops,
+      unrouted: this.unrouted,
+      messagesInPerSec: rate(this.messagesIn, previous.messagesIn),
+      bytesInPerSec: rate(this.bytesIn, previous.bytesIn),
+      messagesOutPerSec: rate(this.messagesOut, previous.messagesOut),
+      bytesOutPerSec: rate(this.bytesOut, previous.bytesOut),
+      queueDepth,
+      maxQueueDepth: Math.max(this.maxQueueDepth, queueDepth),
+      latency: this.latency.summary(),
+    }
+    previous.messagesIn = this.messagesIn
+    previous.bytesIn = this.bytesIn
+    previous.messagesOut = this.messagesOut
+    previous.bytesOut = this.bytesOut
+    this.maxQueueDepth = 0
+    this.latency.reset()
+    return snapshot
+  }
+}
+
+/**
+ * The relay's counters. Sockets are added as they connect and dropped when they close; the
+ * relay-wide totals keep counting across them.
+ */
+class RelayStats {
+  constructor() {
+    this.peers = new Map() // socket -> PeerStats
+    // The peer whose message is being handled
+    this.receiving = null
+    this.clients = new Map() // clientId -> PeerStats
+    this.startedAt = Date.now()
+    this.lastSnapshotAt = performance.now()
+    this.totals = { messagesIn: 0, bytesIn: 0, messagesOut: 0, bytesOut: 0, drops: 0 }
+  }
+
+  /** The counters of `socket`, tracked from its first use until disconnect(). */
+  peer(socket) {
+    let peer = this.peers.get(socket)
+    if (!peer) {
+      peer = new PeerStats(socket)
+      this.peers.set(socket, peer)
+    }
+    return peer
+  }
+
+  disconnect(socket) {
+    const peer = this.peers.get(socket)
+    if (!peer) return
+    this.peers.delete(socket)
+    if (this.receiving === peer) this.receiving = null
+    if (peer.id && this.clients.get(peer.id) === peer) this.clients.delete(peer.id)
+  }
+
+  /** A message arrived on `peer`'s socket; call before anything handles it. */
+  received(peer, bytes) {
+    peer.messagesIn++
+    peer.bytesIn += bytes
+    peer.lastReceivedAt = performance.now()
+    this.receiving = peer
+    this.totals.messagesIn++
+    this.totals.bytesIn += bytes
+  }
+
+  subscribed(peer, id) {
+    peer.kind = "subscriber"
+    peer.id = id || ""
+  }
+
+  /**
+   * The counters of the client sending `clientId`'s commands. A client is matched to its
+   * socket by the message being handled when its first command arrives, since commands are
+   * emitted while their message is dispatched.
+   */
+  client(clientId, name) {
+    let peer = this.clients.get(clientId)
+    if (peer) return peer
+    const { receiving } = this
+    peer = receiving && receiving.kind === "unknown" ? receiving : new PeerStats(null)
+    peer.kind = "client"
+    peer.id = clientId
+    peer.name = name || ""
+    this.clients.set(clientId, peer)
+    return peer
+  }
+
+  /**
+   * Sends `text` to `peer`'s socket, counting it. `from` is the client whose message this
+   * forwards, if any; the time from its arrival to the write is the forward latency of both.
+   * Pass `bytes` when sending the same text to several peers, to measure it once.
+   */
+  send(peer, text, from = null, bytes = Buffer.byteLength(text)) {
+    const { socket } = peer
+    // 1 = OPEN; anything else would be dropped by ws anyway
+    if (!socket || socket.readyState !== 1) {
+      peer.drops++
+      this.totals.drops++
+      return
+    }
+    peer.messagesOut++
+    peer.bytesOut += bytes
+    this.totals.messagesOut++
+    this.totals.bytesOut += bytes
+    const receivedAt = from ? from.lastReceivedAt : 0
+    socket.send(text, (error) => {
+      if (error) {
+        peer.drops++
+        this.totals.drops++
+        return
+      }
+      if (!receivedAt) return
+      const us = (performance.now() - receivedAt) * 1000
+      peer.latency.record(us)
+      from.latency.record(us)
+    })
+    const queued = socket.bufferedAmount
+    if (queued > peer.maxQueueDepth) peer.maxQueueDepth = queued
+  }
+
+  /** Forgets a client that disconnected; its socket's counters go when the socket closes. */
+  clientGone(clientId) {
+    const peer = this.clients.get(clientId)
+    if (peer && !peer.socket) this.clients.delete(clientId)
+  }
+
+  /** A client's message arrived with no Reactotron app connected to take it. */
+  unrouted(peer) {
+    peer.unrouted++
+  }
+
+  /** Everything since the last snapshot; rates and latencies cover just that interval. */
+  snapshot() {
+    const now = performance.now()
+    const seconds = (now - this.lastSnapshotAt) / 1000
+    this.lastSnapshotAt = now
+    const clients = []
+    const subscribers = []
+    for (const peer of this.peers.values()) {
+      if (peer.kind === "subscriber") subscribers.push(peer.snapshot(seconds))
+      else if (peer.kind === "client") clients.push(peer.snapshot(seconds))
+    }
+    // Clients known only by their commands, if their socket was never matched
+    for (const peer of this.clients.values()) {
+      if (!peer.socket) clients.push(peer.snapshot(seconds))
+    }
+    return {
+      time: Date.now(),
+      uptime: Date.now() - this.startedAt,
+      intervalMs: seconds * 1000,
+      totals: { ...this.totals },
+      clients,
+      subscribers,
+    }
+  }
+}
+
+module.exports = { RelayStats, LatencyHistogram }
@@ -1,27 +1,46 @@
 /**
  * This is a standalone Reactotron relay server.
  *
+ * Every second (opts.statsInterval, 0 to turn off) it sends connected Reactotron apps a
+ * "reactotron.relayStats" message with its per-client and per-app counters; see relay-stats.js.
+ *
  * TODO:
  * * Store full info about a client in here so we can pass it along to connected Reactotron apps.
  *
  */
 
+const { RelayStats } = require("./relay-stats")
+
 const connectedReactotrons = []
 const connectedClients = []
+const relayStats = new RelayStats()
+
+// Sends `text` to every connected Reactotron app. `from` is the client it came from, if any.
+function sendToReactotrons(text, from = null) {
+  const bytes = Buffer.byteLength(text)
+  connectedReactotrons.forEach((reactotronApp) => {
+    relayStats.send(relayStats.peer(reactotronApp), text, from, bytes)
+  })
+}
 
-function addReactotronApp(socket) {
+function addReactotronApp(socket, message) {
   // Add the Reactotron app to the list of connected Reactotron apps
-  connectedReactotrons.push(socket)
+  if (!connectedReactotrons.includes(socket)) connectedReactotrons.push(socket)
+  relayStats.subscribed(relayStats.peer(socket), message.payload?.id)
 
   // Send a message back to the Reactotron app to let it know it's connected
-  socket.send(JSON.stringify({ type: "reactotron.connected" }))
+  relayStats.send(relayStats.peer(socket), JSON.stringify({ type: "reactotron.connected" }))
   console.log("Reactotron app connected: ", socket.id)
 
   // Send the updated list of connected clients to all connected Reactotron apps
   const clients = connectedClients.map((c) => ({ clientId: c.clientId, name: c.name }))
-  connectedReactotrons.forEach((reactotronApp) => {
-    reactotronApp.send(JSON.stringify({ type: "connectedClients", clients }))
-  })
+  sendToReactotrons(JSON.stringify({ type: "connectedClients", clients }))
+}
+
+function removeSocket(socket) {
+  const index = connectedReactotrons.indexOf(socket)
+  if (index !== -1) connectedReactotrons.splice(index, 1)
+  relayStats.disconnect(socket)
 }
 
 function forwardMessage(message, server) {
@@ -36,7 +55,8 @@ function interceptMessage(incoming, socket, server) {
     const { type, ...actualPayload } = payload
     server.wss.clients.forEach((wssClient) => {
       if (wssClient.clientId === payload.clientId) {
-        wssClient.send(
+        relayStats.send(
+          relayStats.peer(wssClient),
           JSON.stringify({
             type,
             payload: actualPayload,
@@ -47,23 +67,43 @@ function interceptMessage(incoming, socket, server) {
     return
   }
   if (connectedReactotrons.includes(socket)) forwardMessage(message, server)
-  if (message.type === "reactotron.subscribe") addReactotronApp(socket)
+  if (message.type === "reactotron.subscribe") addReactotronApp(socket, message)
+}
+
+// Pushes the relay's counters to the Reactotron apps every `interval` ms while any are connected
+function startRelayStats(server, interval) {
+  if (!(interval > 0)) return
+  const timer = setInterval(() => {
+    if (connectedReactotrons.length === 0) return
+    // Sent straight to the sockets, so the stats don't count themselves
+    const text = JSON.stringify({ type: "reactotron.relayStats", stats: relayStats.snapshot() })
+    connectedReactotrons.forEach((reactotronApp) => {
+      if (reactotronApp.readyState === 1) reactotronApp.send(text)
+    })
+  }, interval)
+  timer.unref()
+  server.on("stop", () => clearInterval(timer))
 }
 
 function startReactotronServer(opts = {}) {
   const { createServer } = require("reactotron-core-server")
+  const { statsInterval = 1000, ...serverOpts } = opts
 
   // configure a server
   const server = createServer({
-    port: opts.port || 9292, // default
-    ...opts,
+    port: serverOpts.port || 9292, // default
+    ...serverOpts,
   })
 
   server.start()
 
   server.wss.on("connection", (socket, _request) => {
+    // Counted ahead of the core server's own listener, so forward latency starts at arrival
+    const peer = relayStats.peer(socket)
+    socket.prependListener("message", (m) => relayStats.received(peer, m.length))
     // Intercept messages sent to this socket to check for Reactotron apps
     socket.on("message", (m) => interceptMessage(m, socket, server))
+    socket.on("close", () => removeSocket(socket))
   })
 
   // The server has started.
@@ -76,23 +116,22 @@ function startReactotronServer(opts = {}) {
   server.on("connectionEstablished", (conn) => {
     // Add the client to the list of connected clients if it's not already in the list
     if (!connectedClients.find((c) => c.clientId === conn.clientId)) connectedClients.push(conn)
+    // The intro is the message being handled, which ties the client to its socket
+    relayStats.client(conn.clientId, conn.name)
 
     const clients = connectedClients
-    connectedReactotrons.forEach((reactotronApp) => {
-      // conn here is a ReactotronConnection object
-      // We will forward this to all connected Reactotron apps.
-      // https://github.com/infinitered/reactotron/blob/bba01082f882307773a01e4f90ccf25ccff76949/apps/reactotron-app/src/renderer/contexts/Standalone/useStandalone.ts#L18
-      reactotronApp.send(JSON.stringify({ type: "connectedClients", clients }))
-    })
+    // conn here is a ReactotronConnection object
+    // We will forward this to all connected Reactotron apps.
+    // https://github.com/infinitered/reactotron/blob/bba01082f882307773a01e4f90ccf25ccff76949/apps/reactotron-app/src/renderer/contexts/Standalone/useStandalone.ts#L18
+    sendToReactotrons(JSON.stringify({ type: "connectedClients", clients }))
   })
 
   // A command has arrived from the client. (Maybe?)
   server.on("command", (cmd) => {
-    // send the command to all connected Reactotron apps
-    connectedReactotrons.forEach((reactotronApp) => {
-      console.log("Sending command to Reactotron app: ", cmd.type, reactotronApp.id)
-      reactotronApp.send(JSON.stringify({ type: "command", cmd }))
-    })
+    const client = cmd.clientId ? relayStats.client(cmd.clientId) : null
+    if (client && connectedReactotrons.length === 0) relayStats.unrouted(client)
+    // send the command to all connected Reactotron apps, stringified once for all of them
+    sendToReactotrons(JSON.stringify({ type: "command", cmd }), client)
   })
 
   // A client has disconnected.
@@ -100,12 +139,11 @@ function startReactotronServer(opts = {}) {
     console.log("Disconnected", conn)
 
     // Forward the disconnect to all connected Reactotron apps
-    connectedReactotrons.forEach((reactotronApp) => {
-      // conn here is a ReactotronConnection object
-      // We will forward this to all connected Reactotron apps.
-      // https://github.com/infinitered/reactotron/blob/bba01082f882307773a01e4f90ccf25ccff76949/apps/reactotron-app/src/renderer/contexts/Standalone/useStandalone.ts#L18
-      reactotronApp.send(JSON.stringify({ type: "disconnect", conn }))
-    })
+    // conn here is a ReactotronConnection object
+    // We will forward this to all connected Reactotron apps.
+    // https://github.com/infinitered/reactotron/blob/bba01082f882307773a01e4f90ccf25ccff76949/apps/reactotron-app/src/renderer/contexts/Standalone/useStandalone.ts#L18
+    sendToReactotrons(JSON.stringify({ type: "disconnect", conn }))
+    relayStats.clientGone(conn.clientId)
 
     // Remove the client from the list of connected clients
     const delIndex = connectedClients.findIndex((c) => c.clientId === conn.clientId)
@@ -124,6 +162,8 @@ function startReactotronServer(opts = {}) {
     return
   }
 
+  startRelayStats(server, statsInterval)
+
   // stop the server on SIGINT (metro shutdown)
   process.on("SIGINT", () => {
     server.stop()
@@ -2,21 +2,34 @@
 // Generated by bin/generate_windows_native_files.js
 // DO NOT EDIT - This file is auto-generated
 //
-// TurboModules (9) will be auto-registered by AddAttributedModules()
+// TurboModules (22) will be auto-registered by AddAttributedModules()
 // Fabric Components (2) require manual registration calls
 
 
 #include "../../app/native/IRActionMenuManager/IRActionMenuManager.windows.h"
+#include "../../app/native/IRBenchmarkStats/IRBenchmarkStats.windows.h"
+#include "../../app/native/IRBodyStore/IRBodyStore.windows.h"
+#include "../../app/native/IRBodyViewer/IRBodyViewer.windows.h"
+#include "../../app/native/IRBulkChannel/IRBulkChannel.windows.h"
 #include "../../app/native/IRClipboard/IRClipboard.windows.h"
 #include "../../app/native/IRFontList/IRFontList.windows.h"
+#include "../../app/native/IRIds/IRIds.windows.h"
 #include "../../app/native/IRKeyboard/IRKeyboard.windows.h"
+#include "../../app/native/IRLogStats/IRLogStats.windows.h"
+#include "../../app/native/IRMemoryGovernor/IRMemoryGovernor.windows.h"
 #include "../../app/native/IRMenuItemManager/IRMenuItemManager.windows.h"
+#include "../../app/native/IRNetworkStats/IRNetworkStats.windows.h"
 #include "../../app/native/IRPassthroughView/IRPassthroughView.windows.h"
+#include "../../app/native/IRPayloadArena/IRPayloadArena.windows.h"
+#include "../../app/native/IRRelaySocket/IRRelaySocket.windows.h"
 #include "../../app/native/IRRunShellCommand/IRRunShellCommand.windows.h"
+#include "../../app/native/IRSessionArchive/IRSessionArchive.windows.h"
+#include "../../app/native/IRStateSnapshots/IRStateSnapshots.windows.h"
+#include "../../app/native/IRSymbolicator/IRSymbolicator.windows.h"
 #include "../../app/native/IRSystemInfo/IRSystemInfo.windows.h"
 #include "../../app/native/IRTabComponentView/IRTabComponentView.windows.h"
+#include "../../app/native/IRTimelineQuery/IRTimelineQuery.windows.h"
 #include "../../app/utils/experimental/IRExperimental.windows.h"
-#include "../../app/utils/random/IRRandom.windows.h"
 
 namespace winrt::reactotron::implementation {
     // Fabric component registration functions
@@ -8,6 +8,7 @@
 
 #include "NativeModules.h"
 #include "IRNativeModules.g.h"
+#include "native/IRRunShellCommand/ShutdownCommands.h"
 
 #include <winrt/Windows.UI.h>
 #include <winrt/Microsoft.UI.Windowing.h>
@@ -105,4 +106,13 @@ _Use_decl_annotations_ int CALLBACK WinMain(HINSTANCE instance, HINSTANCE, PSTR
 
   // Start the app
   reactNativeWin32App.Start();
+
+  // The window has closed; run the commands registered with runCommandOnShutdown, all at once
+  // and for no longer than the deadline
+  using ::reactotron::ShutdownCommands;
+  for (const auto &result : ShutdownCommands::Shared().Run()) {
+    std::string line = "[IRRunShellCommand] Shutdown command " + ShutdownCommands::Describe(result) + "\n";
+    if (!result.output.empty()) line += result.output + "\n";
+    OutputDebugStringA(line.c_str());
+  }
 }